@@ -15,6 +15,29 @@
 
 using namespace std;
 
+
+// results are staged in the climate writer if present, otherwise saved immediately
+static bool saveClimateSeries(QString *myError, Crit3DClimate* clima, const QString &table, const std::string &id, const std::vector<float> &allResults)
+{
+    if (clima->dbWriter() != nullptr)
+        return clima->dbWriter()->addSeries(table, QString::fromStdString(id), allResults, clima->climateElab(), myError);
+
+    Crit3DClimateDbWriter dbWriter(clima->db());
+    return dbWriter.addSeries(table, QString::fromStdString(id), allResults, clima->climateElab(), myError)
+           && dbWriter.flush(myError);
+}
+
+static bool saveClimateValue(QString *myError, Crit3DClimate* clima, const QString &table, const std::string &id, float result)
+{
+    if (clima->dbWriter() != nullptr)
+        return clima->dbWriter()->addValue(table, QString::fromStdString(id), result, clima->climateElab(), myError);
+
+    Crit3DClimateDbWriter dbWriter(clima->db());
+    return dbWriter.addValue(table, QString::fromStdString(id), result, clima->climateElab(), myError)
+           && dbWriter.flush(myError);
+}
+
+
 bool elaborationOnPoint(QString *myError, Crit3DMeteoPointsDbHandler* meteoPointsDbHandler, Crit3DMeteoGridDbHandler* meteoGridDbHandler,
     Crit3DMeteoPoint* meteoPointTemp, Crit3DClimate* clima, bool isMeteoGrid, QDate startDate, QDate endDate, bool isAnomaly, Crit3DMeteoSettings* meteoSettings, bool dataAlreadyLoaded)
 {
@@ -294,6 +317,13 @@ bool climateTemporalCycle(QString *myError, Crit3DClimate* clima, std::vector<fl
     float result;
     float paramValue;
 
+    // the parameter may be a climate staged in the writer
+    if (clima->param1IsClimate() && clima->dbWriter() != nullptr)
+    {
+        if (! clima->dbWriter()->flush(myError))
+            return false;
+    }
+
     switch(clima->periodType())
     {
 
@@ -386,7 +416,7 @@ bool climateTemporalCycle(QString *myError, Crit3DClimate* clima, std::vector<fl
 
         if (okAtLeastOne)
         {
-            return saveDailyElab(db, myError, QString::fromStdString(meteoPoint->id), allResults, clima->climateElab());
+            return saveClimateSeries(myError, clima, "climate_daily", meteoPoint->id, allResults);
         }
         else
         {
@@ -436,7 +466,7 @@ bool climateTemporalCycle(QString *myError, Crit3DClimate* clima, std::vector<fl
         }
         if (okAtLeastOne)
         {
-            return saveDecadalElab(db, myError, QString::fromStdString(meteoPoint->id), allResults, clima->climateElab());
+            return saveClimateSeries(myError, clima, "climate_decadal", meteoPoint->id, allResults);
         }
         else
         {
@@ -485,7 +515,7 @@ bool climateTemporalCycle(QString *myError, Crit3DClimate* clima, std::vector<fl
         }
         if (okAtLeastOne)
         {
-            return saveMonthlyElab(db, myError, QString::fromStdString(meteoPoint->id), allResults, clima->climateElab());
+            return saveClimateSeries(myError, clima, "climate_monthly", meteoPoint->id, allResults);
         }
         else
         {
@@ -550,7 +580,7 @@ bool climateTemporalCycle(QString *myError, Crit3DClimate* clima, std::vector<fl
         }
         if (okAtLeastOne)
         {
-            return saveSeasonalElab(db, myError, QString::fromStdString(meteoPoint->id), allResults, clima->climateElab());
+            return saveClimateSeries(myError, clima, "climate_seasonal", meteoPoint->id, allResults);
         }
         else
         {
@@ -586,7 +616,7 @@ bool climateTemporalCycle(QString *myError, Crit3DClimate* clima, std::vector<fl
 
         if (result != NODATA)
         {
-            return saveAnnualElab(db, myError, QString::fromStdString(meteoPoint->id), result, clima->climateElab());
+            return saveClimateValue(myError, clima, "climate_annual", meteoPoint->id, result);
         }
         else
         {
@@ -619,7 +649,7 @@ bool climateTemporalCycle(QString *myError, Crit3DClimate* clima, std::vector<fl
 
         if (result != NODATA)
         {
-            return saveGenericElab(db, myError, QString::fromStdString(meteoPoint->id), result, clima->climateElab());
+            return saveClimateValue(myError, clima, "climate_generic", meteoPoint->id, result);
         }
         else
         {
@@ -758,7 +788,7 @@ bool dailyCumulatedClimate(QString *myError, std::vector<float> &inputValues, Cr
 
     if (okAtLeastOne)
     {
-        return saveDailyElab(db, myError, QString::fromStdString(meteoPoint->id), allResults, clima->climateElab());
+        return saveClimateSeries(myError, clima, "climate_daily", meteoPoint->id, allResults);
     }
     else
     {
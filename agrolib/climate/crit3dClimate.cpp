@@ -6,6 +6,7 @@
 
 Crit3DClimate::Crit3DClimate()
 {
+    _dbWriter = nullptr;
     _climateElab = "";
     _yearStart = NODATA;
     _yearEnd = NODATA;
@@ -360,4 +361,14 @@ void Crit3DClimate::setDb(const QSqlDatabase &db)
     _db = db;
 }
 
+Crit3DClimateDbWriter* Crit3DClimate::dbWriter() const
+{
+    return _dbWriter;
+}
+
+void Crit3DClimate::setDbWriter(Crit3DClimateDbWriter* dbWriter)
+{
+    _dbWriter = dbWriter;
+}
+
 
@@ -16,6 +16,7 @@
     #endif
 
     class QDate;
+    class Crit3DClimateDbWriter;
 
     class Crit3DClimate
     {
@@ -33,6 +34,9 @@
         const QSqlDatabase &db() const;
         void setDb(const QSqlDatabase &db);
 
+        Crit3DClimateDbWriter* dbWriter() const;
+        void setDbWriter(Crit3DClimateDbWriter* dbWriter);
+
         QString climateElab() const;
         void setClimateElab(const QString &climateElab);
 
@@ -111,6 +115,7 @@
 
     private:
         QSqlDatabase _db;
+        Crit3DClimateDbWriter* _dbWriter;           // not owned: results are staged here if not null
         QString _climateElab;
         int _yearStart;
         int _yearEnd;
@@ -3,55 +3,245 @@
 #include "commonConstants.h"
 
 #include <QtSql>
+#include <algorithm>
+#include <iterator>
 
 
-// LC saveDailyElab is a bit more efficient respect saveDailyElabSingleValue, making prepare just once.
-// Anyway all the process for each id_point is only 2seconds.
-bool saveDailyElab(QSqlDatabase db, QString *myError, QString id, std::vector<float> allResults, QString elab)
+// climate_annual and climate_generic have no TimeIndex
+static bool isClimateSeriesTable(const QString &table)
 {
-    QSqlQuery qry(db);
-    if (db.driverName() == "QSQLITE")
+    return (table != "climate_annual" && table != "climate_generic");
+}
+
+
+Crit3DClimateDbWriter::Crit3DClimateDbWriter(const QSqlDatabase &db)
+{
+    _db = db;
+    _nrStagedValues = 0;
+    _maxStagedValues = CLIMATE_WRITER_MAX_VALUES;
+}
+
+
+void Crit3DClimateDbWriter::setMaxStagedValues(int maxStagedValues)
+{
+    _maxStagedValues = std::max(maxStagedValues, 1);
+}
+
+
+void Crit3DClimateDbWriter::clear()
+{
+    _records.clear();
+    _nrStagedValues = 0;
+}
+
+
+/*!
+ * \brief addSeries
+ * stages allResults with TimeIndex = 1, 2, ...
+ * the values are written when the staged values exceed the maximum, or by flush
+ */
+bool Crit3DClimateDbWriter::addSeries(const QString &table, const QString &id, const std::vector<float> &allResults,
+                                      const QString &elab, QString *myError)
+{
+    std::vector<TClimateRecord> &records = _records[table];
+    for (unsigned int i = 0; i < allResults.size(); i++)
     {
-        qry.prepare("CREATE TABLE IF NOT EXISTS `climate_daily` (TimeIndex INTEGER, id_point TEXT, elab TEXT, value REAL, PRIMARY KEY(TimeIndex,id_point,elab));");
-        if( !qry.exec() )
+        records.push_back({int(i+1), id, elab, allResults[i]});
+    }
+    _nrStagedValues += int(allResults.size());
+
+    if (_nrStagedValues >= _maxStagedValues)
+        return flush(myError);
+
+    return true;
+}
+
+
+bool Crit3DClimateDbWriter::addValue(const QString &table, const QString &id, float result, const QString &elab, QString *myError)
+{
+    _records[table].push_back({NODATA, id, elab, result});
+    _nrStagedValues++;
+
+    if (_nrStagedValues >= _maxStagedValues)
+        return flush(myError);
+
+    return true;
+}
+
+
+/*!
+ * \brief append
+ * moves the values staged in source (e.g. by a worker thread) to this writer
+ */
+bool Crit3DClimateDbWriter::append(Crit3DClimateDbWriter &source, QString *myError)
+{
+    if (source._nrStagedValues == 0)
+        return true;
+
+    QMap<QString, std::vector<TClimateRecord>>::iterator it;
+    for (it = source._records.begin(); it != source._records.end(); ++it)
+    {
+        std::vector<TClimateRecord> &records = _records[it.key()];
+        if (records.empty())
         {
-            *myError = qry.lastError().text();
-            return false;
+            records.swap(it.value());
+        }
+        else
+        {
+            records.insert(records.end(), std::make_move_iterator(it.value().begin()),
+                           std::make_move_iterator(it.value().end()));
         }
+    }
+    _nrStagedValues += source._nrStagedValues;
+    source.clear();
+
+    if (_nrStagedValues >= _maxStagedValues)
+        return flush(myError);
+
+    return true;
+}
+
 
+bool Crit3DClimateDbWriter::createTable(const QString &table, QString *myError)
+{
+    QString statement;
+    if (_db.driverName() == "QSQLITE")
+    {
+        if (isClimateSeriesTable(table))
+            statement = QString("CREATE TABLE IF NOT EXISTS `%1` (TimeIndex INTEGER, id_point TEXT, elab TEXT, value REAL, PRIMARY KEY(TimeIndex,id_point,elab));").arg(table);
+        else
+            statement = QString("CREATE TABLE IF NOT EXISTS `%1` (id_point TEXT, elab TEXT, value REAL, PRIMARY KEY(id_point,elab));").arg(table);
     }
-    else if (db.driverName() == "QMYSQL")
+    else if (_db.driverName() == "QMYSQL")
     {
-        qry.prepare("CREATE TABLE IF NOT EXISTS `climate_daily` (TimeIndex smallint(5), id_point varchar(10), elab varchar(80), value float(6,1), PRIMARY KEY(TimeIndex,id_point,elab) );");
-        if( !qry.exec() )
+        if (isClimateSeriesTable(table))
+            statement = QString("CREATE TABLE IF NOT EXISTS `%1` (TimeIndex smallint(5), id_point varchar(10), elab varchar(80), value float(6,1), PRIMARY KEY(TimeIndex,id_point,elab) );").arg(table);
+        else
+            statement = QString("CREATE TABLE IF NOT EXISTS `%1` (id_point varchar(10), elab varchar(80), value float(6,1), PRIMARY KEY(id_point,elab) );").arg(table);
+    }
+    else
+    {
+        return true;
+    }
+
+    QSqlQuery qry(_db);
+    if (! qry.exec(statement))
+    {
+        *myError = qry.lastError().text();
+        return false;
+    }
+
+    return true;
+}
+
+
+bool Crit3DClimateDbWriter::writeRecords(const QString &table, const std::vector<TClimateRecord> &records, QString *myError)
+{
+    bool isSeries = isClimateSeriesTable(table);
+    QString fields = isSeries ? "(TimeIndex, id_point, elab, value)" : "(id_point, elab, value)";
+    QString rowValues = isSeries ? "(?, ?, ?, ?)" : "(?, ?, ?)";
+
+    QSqlQuery qry(_db);
+    int nrPreparedRows = 0;
+    size_t first = 0;
+
+    while (first < records.size())
+    {
+        int nrRows = int(std::min(records.size() - first, size_t(CLIMATE_WRITER_ROWS)));
+
+        // the statement is prepared again only for the last block
+        if (nrRows != nrPreparedRows)
+        {
+            QString statement = QString("REPLACE INTO `%1` %2 VALUES %3").arg(table, fields, rowValues);
+            for (int i = 1; i < nrRows; i++)
+            {
+                statement += ", " + rowValues;
+            }
+
+            if (! qry.prepare(statement))
+            {
+                *myError = qry.lastError().text();
+                return false;
+            }
+            nrPreparedRows = nrRows;
+        }
+
+        for (size_t i = first; i < first + size_t(nrRows); i++)
+        {
+            if (isSeries)
+                qry.addBindValue(records[i].timeIndex);
+            qry.addBindValue(records[i].id);
+            qry.addBindValue(records[i].elab);
+            qry.addBindValue(records[i].value);
+        }
+
+        if (! qry.exec())
         {
             *myError = qry.lastError().text();
             return false;
         }
+
+        first += size_t(nrRows);
     }
-    qry.prepare( "REPLACE INTO `climate_daily` (TimeIndex, id_point, elab, value)"
-                                      " VALUES (?, ?, ?, ?)" );
+
+    return true;
+}
 
 
+/*!
+ * \brief flush
+ * writes all the staged values in a single transaction
+ * (tables are created before, since in MySQL CREATE TABLE commits the transaction)
+ */
+bool Crit3DClimateDbWriter::flush(QString *myError)
+{
+    if (_nrStagedValues == 0)
+        return true;
 
-    for (unsigned int i = 0; i < allResults.size(); i++)
+    QMap<QString, std::vector<TClimateRecord>>::const_iterator it;
+    for (it = _records.constBegin(); it != _records.constEnd(); ++it)
     {
-        qry.addBindValue(i+1);
-        qry.addBindValue(id);
-        qry.addBindValue(elab);
-        qry.addBindValue(allResults[i]);
+        if (! _createdTables.contains(it.key()))
+        {
+            if (! createTable(it.key(), myError))
+                return false;
+            _createdTables.insert(it.key());
+        }
+    }
 
-        if( !qry.exec() )
+    if (! _db.transaction())
+    {
+        *myError = _db.lastError().text();
+        return false;
+    }
+
+    for (it = _records.constBegin(); it != _records.constEnd(); ++it)
+    {
+        if (! writeRecords(it.key(), it.value(), myError))
         {
-            *myError = qry.lastError().text();
+            _db.rollback();
             return false;
         }
     }
 
+    if (! _db.commit())
+    {
+        *myError = _db.lastError().text();
+        _db.rollback();
+        return false;
+    }
 
+    clear();
     return true;
 }
 
+
+bool saveDailyElab(QSqlDatabase db, QString *myError, QString id, std::vector<float> allResults, QString elab)
+{
+    Crit3DClimateDbWriter dbWriter(db);
+    return dbWriter.addSeries("climate_daily", id, allResults, elab, myError) && dbWriter.flush(myError);
+}
+
 bool deleteElab(QSqlDatabase db, QString *myError, QString table, QString elab)
 {
     QSqlQuery qry(db);
@@ -168,204 +358,32 @@ QList<QString> getIdListFromElab(QSqlDatabase db, QString table, QString *myErro
 
 bool saveDecadalElab(QSqlDatabase db, QString *myError, QString id, std::vector<float> allResults, QString elab)
 {
-    QSqlQuery qry(db);
-    if (db.driverName() == "QSQLITE")
-    {
-        qry.prepare("CREATE TABLE IF NOT EXISTS `climate_decadal` (TimeIndex INTEGER, id_point TEXT, elab TEXT, value REAL, PRIMARY KEY(TimeIndex,id_point,elab));");
-        if( !qry.exec() )
-        {
-            *myError = qry.lastError().text();
-            return false;
-        }
-
-    }
-    else if (db.driverName() == "QMYSQL")
-    {
-        qry.prepare("CREATE TABLE IF NOT EXISTS `climate_decadal` (TimeIndex smallint(5), id_point varchar(10), elab  varchar(80), value float(6,1), PRIMARY KEY(TimeIndex,id_point,elab) );");
-        if( !qry.exec() )
-        {
-            *myError = qry.lastError().text();
-            return false;
-        }
-    }
-    qry.prepare( "REPLACE INTO `climate_decadal` (TimeIndex, id_point, elab, value)"
-                                      " VALUES (?, ?, ?, ?)" );
-
-    for (unsigned int i = 0; i < allResults.size(); i++)
-    {
-        qry.addBindValue(i+1);
-        qry.addBindValue(id);
-        qry.addBindValue(elab);
-        qry.addBindValue(allResults[i]);
-
-        if( !qry.exec() )
-        {
-            *myError = qry.lastError().text();
-            return false;
-        }
-    }
-
-    return true;
+    Crit3DClimateDbWriter dbWriter(db);
+    return dbWriter.addSeries("climate_decadal", id, allResults, elab, myError) && dbWriter.flush(myError);
 }
 
 bool saveMonthlyElab(QSqlDatabase db, QString *myError, QString id, std::vector<float> allResults, QString elab)
 {
-    QSqlQuery qry(db);
-    if (db.driverName() == "QSQLITE")
-    {
-        qry.prepare("CREATE TABLE IF NOT EXISTS `climate_monthly` (TimeIndex INTEGER, id_point TEXT, elab TEXT, value REAL, PRIMARY KEY(TimeIndex,id_point,elab));");
-        if( !qry.exec() )
-        {
-            *myError = qry.lastError().text();
-            return false;
-        }
-
-    }
-    else if (db.driverName() == "QMYSQL")
-    {
-        qry.prepare("CREATE TABLE IF NOT EXISTS `climate_monthly` (TimeIndex smallint(5), id_point varchar(10), elab  varchar(80), value float(6,1), PRIMARY KEY(TimeIndex,id_point,elab) );");
-        if( !qry.exec() )
-        {
-            *myError = qry.lastError().text();
-            return false;
-        }
-    }
-    qry.prepare( "REPLACE INTO `climate_monthly` (TimeIndex, id_point, elab, value)"
-                                      " VALUES (?, ?, ?, ?)" );
-
-    for (unsigned int i = 0; i < allResults.size(); i++)
-    {
-        qry.addBindValue(i+1);
-        qry.addBindValue(id);
-        qry.addBindValue(elab);
-        qry.addBindValue(allResults[i]);
-
-        if( !qry.exec() )
-        {
-            *myError = qry.lastError().text();
-            return false;
-        }
-    }
-
-    return true;
+    Crit3DClimateDbWriter dbWriter(db);
+    return dbWriter.addSeries("climate_monthly", id, allResults, elab, myError) && dbWriter.flush(myError);
 }
 
 bool saveSeasonalElab(QSqlDatabase db, QString *myError, QString id, std::vector<float> allResults, QString elab)
 {
-    QSqlQuery qry(db);
-    if (db.driverName() == "QSQLITE")
-    {
-        qry.prepare("CREATE TABLE IF NOT EXISTS `climate_seasonal` (TimeIndex INTEGER, id_point TEXT, elab TEXT, value REAL, PRIMARY KEY(TimeIndex,id_point,elab));");
-        if( !qry.exec() )
-        {
-            *myError = qry.lastError().text();
-            return false;
-        }
-
-    }
-    else if (db.driverName() == "QMYSQL")
-    {
-        qry.prepare("CREATE TABLE IF NOT EXISTS `climate_seasonal` (TimeIndex smallint(5), id_point varchar(10), elab  varchar(80), value float(6,1), PRIMARY KEY(TimeIndex,id_point,elab) );");
-        if( !qry.exec() )
-        {
-            *myError = qry.lastError().text();
-            return false;
-        }
-    }
-    qry.prepare( "REPLACE INTO `climate_seasonal` (TimeIndex, id_point, elab, value)"
-                                      " VALUES (?, ?, ?,?)" );
-
-    for (unsigned int i = 0; i < allResults.size(); i++)
-    {
-        qry.addBindValue(i+1);
-        qry.addBindValue(id);
-        qry.addBindValue(elab);
-        qry.addBindValue(allResults[i]);
-
-        if( !qry.exec() )
-        {
-            *myError = qry.lastError().text();
-            return false;
-        }
-    }
-
-    return true;
+    Crit3DClimateDbWriter dbWriter(db);
+    return dbWriter.addSeries("climate_seasonal", id, allResults, elab, myError) && dbWriter.flush(myError);
 }
 
 bool saveAnnualElab(QSqlDatabase db, QString *myError, QString id, float result, QString elab)
 {
-    QSqlQuery qry(db);
-    if (db.driverName() == "QSQLITE")
-    {
-        qry.prepare("CREATE TABLE IF NOT EXISTS `climate_annual` (id_point TEXT, elab TEXT, value REAL, PRIMARY KEY(id_point,elab));");
-        if( !qry.exec() )
-        {
-            *myError = qry.lastError().text();
-            return false;
-        }
-
-    }
-    else if (db.driverName() == "QMYSQL")
-    {
-        qry.prepare("CREATE TABLE IF NOT EXISTS `climate_annual` (id_point varchar(10), elab  varchar(80), value float(6,1), PRIMARY KEY(id_point,elab) );");
-        if( !qry.exec() )
-        {
-            *myError = qry.lastError().text();
-            return false;
-        }
-    }
-    qry.prepare( "REPLACE INTO `climate_annual` (id_point, elab, value)"
-                                      " VALUES (:id_point, :elab, :value)" );
-
-    qry.bindValue(":id_point", id);
-    qry.bindValue(":elab", elab);
-    qry.bindValue(":value", result);
-
-    if( !qry.exec() )
-    {
-        *myError = qry.lastError().text();
-        return false;
-    }
-
-    return true;
+    Crit3DClimateDbWriter dbWriter(db);
+    return dbWriter.addValue("climate_annual", id, result, elab, myError) && dbWriter.flush(myError);
 }
 
 bool saveGenericElab(QSqlDatabase db, QString *myError, QString id, float result, QString elab)
 {
-    QSqlQuery qry(db);
-    if (db.driverName() == "QSQLITE")
-    {
-        qry.prepare("CREATE TABLE IF NOT EXISTS `climate_generic` (id_point TEXT, elab TEXT, value REAL, PRIMARY KEY(id_point,elab));");
-        if( !qry.exec() )
-        {
-            *myError = qry.lastError().text();
-            return false;
-        }
-
-    }
-    else if (db.driverName() == "QMYSQL")
-    {
-        qry.prepare("CREATE TABLE IF NOT EXISTS `climate_generic` (id_point varchar(10), elab  varchar(80), value float(6,1), PRIMARY KEY(id_point,elab) );");
-        if( !qry.exec() )
-        {
-            *myError = qry.lastError().text();
-            return false;
-        }
-    }
-    qry.prepare( "REPLACE INTO `climate_generic` (id_point, elab, value)"
-                                      " VALUES (:id_point, :elab, :value)" );
-
-    qry.bindValue(":id_point", id);
-    qry.bindValue(":elab", elab);
-    qry.bindValue(":value", result);
-
-    if( !qry.exec() )
-    {
-        *myError = qry.lastError().text();
-        return false;
-    }
-
-    return true;
+    Crit3DClimateDbWriter dbWriter(db);
+    return dbWriter.addValue("climate_generic", id, result, elab, myError) && dbWriter.flush(myError);
 }
 
 bool selectVarElab(QSqlDatabase db, QString *myError, QString table, QString variable, QList<QString>* listElab)
@@ -8,6 +8,57 @@
     #ifndef _VECTOR_
         #include <vector>
     #endif
+    #ifndef QMAP_H
+        #include <QMap>
+    #endif
+    #ifndef QSET_H
+        #include <QSet>
+    #endif
+
+    // values staged by Crit3DClimateDbWriter before an automatic flush
+    #define CLIMATE_WRITER_MAX_VALUES 100000
+    // rows of a single REPLACE INTO statement
+    #define CLIMATE_WRITER_ROWS 200
+
+    struct TClimateRecord
+    {
+        int timeIndex;
+        QString id;
+        QString elab;
+        float value;
+    };
+
+    /*!
+     * \brief The Crit3DClimateDbWriter class
+     * stages the climate results in memory and writes them with multi-row REPLACE INTO statements,
+     * in a single transaction for each flush (QSQLITE and QMYSQL).
+     * Tables are created at the first flush of the writer
+     */
+    class Crit3DClimateDbWriter
+    {
+    public:
+        Crit3DClimateDbWriter(const QSqlDatabase &db);
+
+        int getNrStagedValues() const { return _nrStagedValues; }
+        void setMaxStagedValues(int maxStagedValues);
+
+        bool addSeries(const QString &table, const QString &id, const std::vector<float> &allResults, const QString &elab, QString *myError);
+        bool addValue(const QString &table, const QString &id, float result, const QString &elab, QString *myError);
+        bool append(Crit3DClimateDbWriter &source, QString *myError);
+
+        bool flush(QString *myError);
+        void clear();
+
+    private:
+        QSqlDatabase _db;
+        QSet<QString> _createdTables;
+        QMap<QString, std::vector<TClimateRecord>> _records;
+        int _nrStagedValues;
+        int _maxStagedValues;
+
+        bool createTable(const QString &table, QString *myError);
+        bool writeRecords(const QString &table, const std::vector<TClimateRecord> &records, QString *myError);
+    };
 
     bool saveDailyElab(QSqlDatabase db, QString *myError, QString id, std::vector<float> allResults, QString elab);
     bool saveDecadalElab(QSqlDatabase db, QString *myError, QString id, std::vector<float> allResults, QString elab);
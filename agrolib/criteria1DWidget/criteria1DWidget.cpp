@@ -584,16 +584,16 @@ void Criteria1DWidget::on_actionOpenProject()
     this->firstYearListComboBox.blockSignals(true);
     this->lastYearListComboBox.blockSignals(true);
 
-    openCropDB(myProject.dbCropName);
-    openSoilDB(myProject.dbSoilName);
-    openMeteoDB(myProject.dbMeteoName, false);
+    openCropDB(myProject.settings.dbCropName);
+    openSoilDB(myProject.settings.dbSoilName);
+    openMeteoDB(myProject.settings.dbMeteoName, false);
 
     this->cropListComboBox.blockSignals(false);
     this->soilListComboBox.blockSignals(false);
     this->firstYearListComboBox.blockSignals(false);
     this->lastYearListComboBox.blockSignals(false);
 
-    openComputationUnitsDB(myProject.dbComputationUnitsName);
+    openComputationUnitsDB(myProject.settings.dbComputationUnitsName);
     viewMenu->setEnabled(true);
     if (soilListComboBox.count() == 0)
     {
@@ -866,9 +866,9 @@ void Criteria1DWidget::on_actionOpenMeteoDB()
     if (! dbMeteoName.isEmpty())
     {
         if (dbMeteoName.right(3) == "xml")
-            myProject.isXmlMeteoGrid = true;
+            myProject.settings.isXmlMeteoGrid = true;
         else
-            myProject.isXmlMeteoGrid = false;
+            myProject.settings.isXmlMeteoGrid = false;
 
         openMeteoDB(dbMeteoName, true);
     }
@@ -879,7 +879,7 @@ void Criteria1DWidget::openMeteoDB(QString dbMeteoName, bool isMenu)
 {
     QString errorStr;
     QList<QString> idMeteoList;
-    if (myProject.isXmlMeteoGrid)
+    if (myProject.settings.isXmlMeteoGrid)
     {
         if (isMenu)
         {
@@ -1033,7 +1033,7 @@ void Criteria1DWidget::on_actionExecuteCase()
     }
     else
     {
-        QMessageBox::warning(nullptr, "Case executed: "+ myProject.myCase.unit.idCase, "Output:\n" + QDir().cleanPath(myProject.dbOutputName));
+        QMessageBox::warning(nullptr, "Case executed: "+ myProject.myCase.unit.idCase, "Output:\n" + QDir().cleanPath(myProject.settings.dbOutputName));
     }
 }
 
@@ -1245,7 +1245,7 @@ void Criteria1DWidget::on_actionChooseMeteo(QString idMeteo)
     myProject.myCase.meteoPoint.setId(idMeteo.toStdString());
     QString errorStr;
 
-    if (myProject.isXmlMeteoGrid)
+    if (myProject.settings.isXmlMeteoGrid)
     {
         if (! myProject.observedMeteoGrid->loadIdMeteoProperties(&errorStr, idMeteo))
         {
@@ -1290,7 +1290,7 @@ void Criteria1DWidget::on_actionChooseMeteo(QString idMeteo)
                     }
             }
             // store last Date
-            getLastDateGrid(myProject.dbMeteo, meteoTableName, myProject.observedMeteoGrid->tableDaily().fieldTime, yearList[yearList.size()-1], &(myProject.lastSimulationDate), &errorStr);
+            getLastDateGrid(myProject.dbMeteo, meteoTableName, myProject.observedMeteoGrid->tableDaily().fieldTime, yearList[yearList.size()-1], &(myProject.settings.lastSimulationDate), &errorStr);
         }
         else
         {
@@ -1320,7 +1320,7 @@ void Criteria1DWidget::on_actionChooseMeteo(QString idMeteo)
              }
 
             // store last Date
-            getLastDateGrid(myProject.dbMeteo, meteoTableName, myProject.observedMeteoGrid->tableDaily().fieldTime, yearList[yearList.size()-1], &myProject.lastSimulationDate, &errorStr);
+            getLastDateGrid(myProject.dbMeteo, meteoTableName, myProject.observedMeteoGrid->tableDaily().fieldTime, yearList[yearList.size()-1], &myProject.settings.lastSimulationDate, &errorStr);
         }
     }
     else
@@ -1355,7 +1355,7 @@ void Criteria1DWidget::on_actionChooseMeteo(QString idMeteo)
             }
         }
         // store last Date
-        getLastDate(&(myProject.dbMeteo), meteoTableName, yearList[yearList.size()-1], &myProject.lastSimulationDate, &errorStr);
+        getLastDate(&(myProject.dbMeteo), meteoTableName, yearList[yearList.size()-1], &myProject.settings.lastSimulationDate, &errorStr);
     }
 
     if (yearList.size() == 1)
@@ -1443,7 +1443,7 @@ bool Criteria1DWidget::updateMeteoPointValues()
 
     myProject.myCase.meteoPoint.initializeObsDataD(numberDays, getCrit3DDate(firstDate));
 
-    if (myProject.isXmlMeteoGrid)
+    if (myProject.settings.isXmlMeteoGrid)
     {
         unsigned row, col;
         if (! myProject.observedMeteoGrid->meteoGrid()->findMeteoPointFromId(&row, &col, myProject.myCase.meteoPoint.id))
@@ -1848,7 +1848,7 @@ void Criteria1DWidget::updateTabLAI()
         tabLAI->computeLAI(&(myProject.myCase.crop), &(myProject.myCase.meteoPoint),
                            firstYearListComboBox.currentText().toInt(),
                            lastYearListComboBox.currentText().toInt(),
-                           myProject.lastSimulationDate, myProject.myCase.soilLayers);
+                           myProject.settings.lastSimulationDate, myProject.myCase.soilLayers);
     }
 }
 
@@ -1859,7 +1859,7 @@ void Criteria1DWidget::updateTabRootDepth()
         tabRootDepth->computeRootDepth(&(myProject.myCase.crop), &(myProject.myCase.meteoPoint),
                                        firstYearListComboBox.currentText().toInt(),
                                        lastYearListComboBox.currentText().toInt(),
-                                       myProject.lastSimulationDate, myProject.myCase.soilLayers);
+                                       myProject.settings.lastSimulationDate, myProject.myCase.soilLayers);
     }
 }
 
@@ -1880,7 +1880,7 @@ void Criteria1DWidget::updateTabIrrigation()
         tabIrrigation->computeIrrigation(myProject.myCase,
                                          firstYearListComboBox.currentText().toInt(),
                                          lastYearListComboBox.currentText().toInt(),
-                                         myProject.lastSimulationDate);
+                                         myProject.settings.lastSimulationDate);
     }
 }
 
@@ -1891,7 +1891,7 @@ void Criteria1DWidget::updateTabWaterContent()
         tabWaterContent->computeWaterContent(myProject.myCase,
                                              firstYearListComboBox.currentText().toInt(),
                                              lastYearListComboBox.currentText().toInt(),
-                                             myProject.lastSimulationDate, volWaterContent->isChecked());
+                                             myProject.settings.lastSimulationDate, volWaterContent->isChecked());
     }
 }
 
@@ -2177,7 +2177,7 @@ bool Criteria1DWidget::setMeteoSqlite(QString& errorStr)
 
 void Criteria1DWidget::on_actionViewWeather()
 {
-    if (! myProject.isXmlMeteoGrid)
+    if (! myProject.settings.isXmlMeteoGrid)
     {
         if (! setMeteoSqlite(myProject.projectError))
         {
@@ -2186,7 +2186,7 @@ void Criteria1DWidget::on_actionViewWeather()
         }
     }
 
-    Crit3DMeteoWidget* meteoWidgetPoint = new Crit3DMeteoWidget(myProject.isXmlMeteoGrid, myProject.path, &meteoSettings);
+    Crit3DMeteoWidget* meteoWidgetPoint = new Crit3DMeteoWidget(myProject.settings.isXmlMeteoGrid, myProject.settings.path, &meteoSettings);
 
     QDate lastDate = getQDate(myProject.myCase.meteoPoint.getLastDailyData());
     meteoWidgetPoint->setCurrentDate(lastDate);
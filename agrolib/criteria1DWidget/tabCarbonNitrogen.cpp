@@ -110,13 +110,13 @@ void TabCarbonNitrogen::computeCarbonNitrogen(Crit1DProject &myProject, carbonNi
 
     Crit3DDate firstDate = Crit3DDate(1, 1, prevYear);
     Crit3DDate lastDate;
-    if (lastYear != myProject.lastSimulationDate.year())
+    if (lastYear != myProject.settings.lastSimulationDate.year())
     {
         lastDate = Crit3DDate(31, 12, lastYear);
     }
     else
     {
-        lastDate = Crit3DDate(myProject.lastSimulationDate.day(), myProject.lastSimulationDate.month(), lastYear);
+        lastDate = Crit3DDate(myProject.settings.lastSimulationDate.day(), myProject.settings.lastSimulationDate.month(), lastYear);
     }
 
     myProject.myCase.crop.initialize(myProject.myCase.meteoPoint.latitude, nrLayers, totalSoilDepth, currentDoy);
@@ -81,7 +81,7 @@ void TabRootDensity::computeRootDensity(const Crit1DProject &myProject, int firs
     myCrop = myProject.myCase.crop;
     layers = myProject.myCase.soilLayers;
     nrLayers = unsigned(layers.size());
-    lastMeteoDate = myProject.lastSimulationDate;
+    lastMeteoDate = myProject.settings.lastSimulationDate;
 
     yearComboBox.blockSignals(true);
     yearComboBox.clear();
@@ -92,10 +92,10 @@ void TabRootDensity::computeRootDensity(const Crit1DProject &myProject, int firs
     year = yearComboBox.currentText().toInt();
     yearComboBox.blockSignals(false);
 
-    if (year == myProject.lastSimulationDate.year())
+    if (year == myProject.settings.lastSimulationDate.year())
     {
-        slider->setMaximum(myProject.lastSimulationDate.dayOfYear());
-        currentDate->setDate(myProject.lastSimulationDate);
+        slider->setMaximum(myProject.settings.lastSimulationDate.dayOfYear());
+        currentDate->setDate(myProject.settings.lastSimulationDate);
     }
     else
     {
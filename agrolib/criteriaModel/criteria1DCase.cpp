@@ -78,6 +78,7 @@ Crit1DCase::Crit1DCase()
     prevWaterContent.clear();
 
     computeFactorOfSafety = false;
+    hydraulicTableError = 0;
 }
 
 
@@ -86,6 +87,14 @@ bool Crit1DCase::initializeSoil(std::string &error)
     soilLayers.clear();
     carbonNitrogenLayers.clear();
 
+    for (unsigned int i = 0; i < mySoil.nrHorizons; i++)
+    {
+        if (hydraulicTableError > 0)
+            soil::setHydraulicTables(mySoil.horizon[i], hydraulicTableError);
+        else
+            soil::clearHydraulicTables(mySoil.horizon[i]);
+    }
+
     double factor = 1.0;
     if (unit.isGeometricLayers) factor = geometricFactor;
 
@@ -154,12 +163,14 @@ bool Crit1DCase::initializeNumericalFluxes(std::string &error)
     float horizontalConductivityRatio = 10.0;
     soilFluxes3D::setHydraulicProperties(fittingOptions.waterRetentionCurve, MEAN_LOGARITHMIC, horizontalConductivityRatio);
     soilFluxes3D::setNumericalParameters(60, 3600, 100, 10, 12, 3);
+    if (hydraulicTableError > 0)
+        soilFluxes3D::setHydraulicTables(true, hydraulicTableError);
 
     // set soil properties (units of measurement: MKS)
     int soilIndex = 0;
     for (unsigned int horizonIndex = 0; horizonIndex < mySoil.nrHorizons; horizonIndex++)
     {
-        soil::Crit3DHorizon horizon = mySoil.horizon[horizonIndex];
+        const soil::Crit3DHorizon &horizon = mySoil.horizon[horizonIndex];
         double soilFraction = (1.0 - horizon.coarseFragments);
         result = soilFluxes3D::setSoilProperties(soilIndex, int(horizonIndex),
                             horizon.vanGenuchten.alpha * GRAVITY,
@@ -56,6 +56,7 @@
     public:
         Crit1DCompUnit unit;
         bool computeFactorOfSafety;
+        double hydraulicTableError;     /*!< [-] error bound of the hydraulic lookup tables (0: formulas) */
 
         // SOIL
         soil::Crit3DSoil mySoil;
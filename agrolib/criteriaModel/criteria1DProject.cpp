@@ -8,6 +8,14 @@
 #include "cropDbQuery.h"
 #include "criteria1DMeteo.h"
 #include "utilities.h"
+#include "parallel.h"
+#include "soilFluxes3D.h"
+
+#include <sstream>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
 
 #include <QSqlError>
 #include <QDate>
@@ -15,22 +23,19 @@
 #include <QDir>
 #include <QSettings>
 
+#define UNITS_PER_TRANSACTION 64
 
-Crit1DProject::Crit1DProject()
+
+Crit1DProjectSettings::Crit1DProjectSettings()
 {
     this->initialize();
 }
 
 
-void Crit1DProject::initialize()
+void Crit1DProjectSettings::initialize()
 {
-    isProjectLoaded = false;
-
     path = "";
     projectName = "";
-    logFileName = "";
-    outputCsvFileName = "";
-    addDateTimeLogFile = false;
 
     dbCropName = "";
     dbSoilName = "";
@@ -38,14 +43,17 @@ void Crit1DProject::initialize()
     dbForecastName = "";
     dbOutputName = "";
     dbComputationUnitsName = "";
+    isXmlMeteoGrid = false;
 
-    projectError = "";
-
-    compUnitList.clear();
+    firstSimulationDate = QDate(1800,1,1);
+    lastSimulationDate = QDate(1800,1,1);
 
-    isXmlMeteoGrid = false;
     isSaveState = false;
     isRestart = false;
+    addDateTimeLogFile = false;
+
+    nrThreads = 1;
+    hydraulicTableError = 0;
 
     isYearlyStatistics = false;
     isMonthlyStatistics = false;
@@ -55,14 +63,8 @@ void Crit1DProject::initialize()
 
     firstMonth = NODATA;
     daysOfForecast = NODATA;
-    nrYears = NODATA;
-    irriSeries.clear();
-    precSeries.clear();
 
-    firstSimulationDate = QDate(1800,1,1);
-    lastSimulationDate = QDate(1800,1,1);
-
-    outputString = "";
+    outputCsvFileName = "";
 
     // specific outputs
     isClimateOutput = false;
@@ -74,6 +76,37 @@ void Crit1DProject::initialize()
     fractionAvailableWaterDepth.clear();
     factorOfSafetyDepth.clear();
     awcDepth.clear();
+}
+
+
+Crit1DProject::Crit1DProject()
+{
+    this->initialize();
+}
+
+
+void Crit1DProject::initialize()
+{
+    isProjectLoaded = false;
+
+    settings.initialize();
+    logFileName = "";
+
+    projectError = "";
+
+    compUnitList.clear();
+
+    connectionSuffix = "";
+    unitOutput = nullptr;
+    observedMeteoGrid = nullptr;
+    forecastMeteoGrid = nullptr;
+    dbStateName = "";
+
+    nrYears = NODATA;
+    irriSeries.clear();
+    precSeries.clear();
+
+    outputString = "";
 
     texturalClassList.resize(13);
     geotechnicsClassList.resize(19);
@@ -100,115 +133,121 @@ bool Crit1DProject::readSettings()
     // PROJECT
     projectSettings->beginGroup("project");
 
-    path += projectSettings->value("path","").toString();
-    projectName = projectSettings->value("name", "CRITERIA1D").toString();
+    settings.path += projectSettings->value("path","").toString();
+    settings.projectName = projectSettings->value("name", "CRITERIA1D").toString();
 
-    dbCropName = projectSettings->value("db_crop","").toString();
-    if (dbCropName.left(1) == ".")
-        dbCropName = path + dbCropName;
+    settings.dbCropName = projectSettings->value("db_crop","").toString();
+    if (settings.dbCropName.left(1) == ".")
+        settings.dbCropName = settings.path + settings.dbCropName;
 
-    dbSoilName = projectSettings->value("db_soil","").toString();
-    if (dbSoilName.left(1) == ".")
-        dbSoilName = path + dbSoilName;
+    settings.dbSoilName = projectSettings->value("db_soil","").toString();
+    if (settings.dbSoilName.left(1) == ".")
+        settings.dbSoilName = settings.path + settings.dbSoilName;
 
-    dbMeteoName = projectSettings->value("db_meteo","").toString();
-    if (dbMeteoName.left(1) == ".")
+    settings.dbMeteoName = projectSettings->value("db_meteo","").toString();
+    if (settings.dbMeteoName.left(1) == ".")
     {
-        dbMeteoName = QDir::cleanPath(path + dbMeteoName);
+        settings.dbMeteoName = QDir::cleanPath(settings.path + settings.dbMeteoName);
     }
-    if (dbMeteoName.right(3).toUpper() == "XML")
+    if (settings.dbMeteoName.right(3).toUpper() == "XML")
     {
-        isXmlMeteoGrid = true;
+        settings.isXmlMeteoGrid = true;
     }
 
-    dbForecastName = projectSettings->value("db_forecast","").toString();
-    if (dbForecastName.left(1) == ".")
-        dbForecastName = path + dbForecastName;
+    settings.dbForecastName = projectSettings->value("db_forecast","").toString();
+    if (settings.dbForecastName.left(1) == ".")
+        settings.dbForecastName = settings.path + settings.dbForecastName;
 
     // computational units db
-    dbComputationUnitsName = projectSettings->value("db_comp_units","").toString();
-    if (dbComputationUnitsName == "")
+    settings.dbComputationUnitsName = projectSettings->value("db_comp_units","").toString();
+    if (settings.dbComputationUnitsName == "")
     {
         // check old name
-        dbComputationUnitsName = projectSettings->value("db_units","").toString();
+        settings.dbComputationUnitsName = projectSettings->value("db_units","").toString();
     }
-    if (dbComputationUnitsName == "")
+    if (settings.dbComputationUnitsName == "")
     {
         projectError = "Missing information on computational units";
         return false;
     }
-    if (dbComputationUnitsName.left(1) == ".")
-        dbComputationUnitsName = path + dbComputationUnitsName;
+    if (settings.dbComputationUnitsName.left(1) == ".")
+        settings.dbComputationUnitsName = settings.path + settings.dbComputationUnitsName;
 
    // output db
-    dbOutputName = projectSettings->value("db_output","").toString();
-    if (dbOutputName.left(1) == ".")
-        dbOutputName = path + dbOutputName;
+    settings.dbOutputName = projectSettings->value("db_output","").toString();
+    if (settings.dbOutputName.left(1) == ".")
+        settings.dbOutputName = settings.path + settings.dbOutputName;
 
     // date
-    if (firstSimulationDate == QDate(1800,1,1))
+    if (settings.firstSimulationDate == QDate(1800,1,1))
     {
-        firstSimulationDate = projectSettings->value("firstDate",0).toDate();
-        if (! firstSimulationDate.isValid())
+        settings.firstSimulationDate = projectSettings->value("firstDate",0).toDate();
+        if (! settings.firstSimulationDate.isValid())
         {
-            firstSimulationDate = projectSettings->value("first_date",0).toDate();
+            settings.firstSimulationDate = projectSettings->value("first_date",0).toDate();
         }
-        if (! firstSimulationDate.isValid())
+        if (! settings.firstSimulationDate.isValid())
         {
-            firstSimulationDate = QDate(1800,1,1);
+            settings.firstSimulationDate = QDate(1800,1,1);
         }
     }
 
-    if (lastSimulationDate == QDate(1800,1,1))
+    if (settings.lastSimulationDate == QDate(1800,1,1))
     {
-        lastSimulationDate = projectSettings->value("lastDate",0).toDate();
-        if (! lastSimulationDate.isValid())
+        settings.lastSimulationDate = projectSettings->value("lastDate",0).toDate();
+        if (! settings.lastSimulationDate.isValid())
         {
-             lastSimulationDate = projectSettings->value("last_date",0).toDate();
+             settings.lastSimulationDate = projectSettings->value("last_date",0).toDate();
         }
-        if (! lastSimulationDate.isValid())
+        if (! settings.lastSimulationDate.isValid())
         {
-            lastSimulationDate = QDate(1800,1,1);
+            settings.lastSimulationDate = QDate(1800,1,1);
         }
     }
 
-    addDateTimeLogFile = projectSettings->value("add_date_to_log","").toBool();
-    isSaveState = projectSettings->value("save_state","").toBool();
-    isRestart = projectSettings->value("restart","").toBool();
+    settings.addDateTimeLogFile = projectSettings->value("add_date_to_log","").toBool();
+    settings.isSaveState = projectSettings->value("save_state","").toBool();
+    settings.isRestart = projectSettings->value("restart","").toBool();
+
+    // number of threads for the computational units (0 = all cores)
+    settings.nrThreads = projectSettings->value("threads_number", 1).toInt();
+
+    // error bound of the lookup tables of the soil hydraulic functions (0 = formulas)
+    settings.hydraulicTableError = projectSettings->value("hydraulic_table_error", 0).toDouble();
 
     projectSettings->endGroup();
 
     // FORECAST
     projectSettings->beginGroup("forecast");
-        isYearlyStatistics = projectSettings->value("isYearlyStatistics", 0).toBool();
-        isMonthlyStatistics = projectSettings->value("isMonthlyStatistics", 0).toBool();
-        isSeasonalForecast = projectSettings->value("isSeasonalForecast", 0).toBool();
-        isShortTermForecast = projectSettings->value("isShortTermForecast", 0).toBool();
+        settings.isYearlyStatistics = projectSettings->value("isYearlyStatistics", 0).toBool();
+        settings.isMonthlyStatistics = projectSettings->value("isMonthlyStatistics", 0).toBool();
+        settings.isSeasonalForecast = projectSettings->value("isSeasonalForecast", 0).toBool();
+        settings.isShortTermForecast = projectSettings->value("isShortTermForecast", 0).toBool();
 
         // ensemble forecast (typically they are monthly)
-        isEnsembleForecast = projectSettings->value("isEnsembleForecast", 0).toBool();
-        if (! isEnsembleForecast)
+        settings.isEnsembleForecast = projectSettings->value("isEnsembleForecast", 0).toBool();
+        if (! settings.isEnsembleForecast)
             // check also monthly
-            isEnsembleForecast = projectSettings->value("isMonthlyForecast", 0).toBool();
+            settings.isEnsembleForecast = projectSettings->value("isMonthlyForecast", 0).toBool();
 
-        if (isShortTermForecast || isEnsembleForecast)
+        if (settings.isShortTermForecast || settings.isEnsembleForecast)
         {
-            daysOfForecast = projectSettings->value("daysOfForecast", 0).toInt();
-            if (daysOfForecast == 0)
+            settings.daysOfForecast = projectSettings->value("daysOfForecast", 0).toInt();
+            if (settings.daysOfForecast == 0)
             {
                 projectError = "Missing daysOfForecast";
                 return false;
             }
         }
 
-        if (isYearlyStatistics)
+        if (settings.isYearlyStatistics)
         {
-            firstMonth = 1;
+            settings.firstMonth = 1;
         }
-        else if (isMonthlyStatistics || isSeasonalForecast)
+        else if (settings.isMonthlyStatistics || settings.isSeasonalForecast)
         {
-            firstMonth = projectSettings->value("firstMonth", 0).toInt();
-            if (firstMonth == 0)
+            settings.firstMonth = projectSettings->value("firstMonth", 0).toInt();
+            if (settings.firstMonth == 0)
             {
                 projectError = "Missing firstMonth.";
                 return false;
@@ -216,11 +255,11 @@ bool Crit1DProject::readSettings()
         }
 
         int nrOfComputationType = 0;
-        if (isShortTermForecast) nrOfComputationType++;
-        if (isEnsembleForecast) nrOfComputationType++;
-        if (isSeasonalForecast) nrOfComputationType++;
-        if (isMonthlyStatistics) nrOfComputationType++;
-        if (isYearlyStatistics) nrOfComputationType++;
+        if (settings.isShortTermForecast) nrOfComputationType++;
+        if (settings.isEnsembleForecast) nrOfComputationType++;
+        if (settings.isSeasonalForecast) nrOfComputationType++;
+        if (settings.isMonthlyStatistics) nrOfComputationType++;
+        if (settings.isYearlyStatistics) nrOfComputationType++;
 
         if (nrOfComputationType > 1)
         {
@@ -231,33 +270,33 @@ bool Crit1DProject::readSettings()
     projectSettings->endGroup();
 
     projectSettings->beginGroup("csv");
-        outputCsvFileName = projectSettings->value("csv_output","").toString();
-        if (outputCsvFileName != "")
+        settings.outputCsvFileName = projectSettings->value("csv_output","").toString();
+        if (settings.outputCsvFileName != "")
         {
-            if (outputCsvFileName.right(4) == ".csv")
+            if (settings.outputCsvFileName.right(4) == ".csv")
             {
-                outputCsvFileName = outputCsvFileName.left(outputCsvFileName.length()-4);
+                settings.outputCsvFileName = settings.outputCsvFileName.left(settings.outputCsvFileName.length()-4);
             }
 
             bool addDate = projectSettings->value("add_date_to_filename","").toBool();
             if (addDate)
             {
                 QString dateStr;
-                if (lastSimulationDate == QDate(1800,1,1))
+                if (settings.lastSimulationDate == QDate(1800,1,1))
                 {
                     dateStr = QDate::currentDate().toString("yyyy-MM-dd");
                 }
                 else
                 {
-                    dateStr = lastSimulationDate.addDays(1).toString("yyyy-MM-dd");
+                    dateStr = settings.lastSimulationDate.addDays(1).toString("yyyy-MM-dd");
                 }
-                outputCsvFileName += "_" + dateStr;
+                settings.outputCsvFileName += "_" + dateStr;
             }
-            outputCsvFileName += ".csv";
+            settings.outputCsvFileName += ".csv";
 
-            if (outputCsvFileName.at(0) == '.')
+            if (settings.outputCsvFileName.at(0) == '.')
             {
-                outputCsvFileName = path + QDir::cleanPath(outputCsvFileName);
+                settings.outputCsvFileName = settings.path + QDir::cleanPath(settings.outputCsvFileName);
             }
         }
 
@@ -267,38 +306,38 @@ bool Crit1DProject::readSettings()
     QList<QString> depthList;
     projectSettings->beginGroup("output");
 
-        isClimateOutput = projectSettings->value("isClimateOutput", false).toBool();
+        settings.isClimateOutput = projectSettings->value("isClimateOutput", false).toBool();
 
         depthList = projectSettings->value("waterContent").toStringList();
-        if (! setVariableDepth(depthList, waterContentDepth))
+        if (! setVariableDepth(depthList, settings.waterContentDepth))
         {
             projectError = "Wrong water content depth in " + configFileName;
             return false;
         }
 
         depthList = projectSettings->value("degreeOfSaturation").toStringList();
-        if (! setVariableDepth(depthList, degreeOfSaturationDepth))
+        if (! setVariableDepth(depthList, settings.degreeOfSaturationDepth))
         {
             projectError = "Wrong degree of saturation depth in " + configFileName;
             return false;
         }
 
         depthList = projectSettings->value("waterPotential").toStringList();
-        if (! setVariableDepth(depthList, waterPotentialDepth))
+        if (! setVariableDepth(depthList, settings.waterPotentialDepth))
         {
             projectError = "Wrong water potential depth in " + configFileName;
             return false;
         }
 
         depthList = projectSettings->value("waterDeficit").toStringList();
-        if (! setVariableDepth(depthList, waterDeficitDepth))
+        if (! setVariableDepth(depthList, settings.waterDeficitDepth))
         {
             projectError = "Wrong water deficit depth in " + configFileName;
             return false;
         }
 
         depthList = projectSettings->value("awc").toStringList();
-        if (! setVariableDepth(depthList, awcDepth))
+        if (! setVariableDepth(depthList, settings.awcDepth))
         {
             projectError = "Wrong available water capacity depth in " + configFileName;
             return false;
@@ -310,7 +349,7 @@ bool Crit1DProject::readSettings()
             // alternative field name
             depthList = projectSettings->value("aw").toStringList();
         }
-        if (! setVariableDepth(depthList, availableWaterDepth))
+        if (! setVariableDepth(depthList, settings.availableWaterDepth))
         {
             projectError = "Wrong available water depth in " + configFileName;
             return false;
@@ -322,7 +361,7 @@ bool Crit1DProject::readSettings()
             // alternative field name
             depthList = projectSettings->value("faw").toStringList();
         }
-        if (! setVariableDepth(depthList, fractionAvailableWaterDepth))
+        if (! setVariableDepth(depthList, settings.fractionAvailableWaterDepth))
         {
             projectError = "Wrong fraction available water depth in " + configFileName;
             return false;
@@ -334,7 +373,7 @@ bool Crit1DProject::readSettings()
             // alternative field name
             depthList = projectSettings->value("fos").toStringList();
         }
-        if (! setVariableDepth(depthList, factorOfSafetyDepth))
+        if (! setVariableDepth(depthList, settings.factorOfSafetyDepth))
         {
             projectError = "Wrong slope stability depth in " + configFileName;
             return false;
@@ -362,7 +401,7 @@ int Crit1DProject::initializeProject(QString settingsFileName)
         configFileName = QDir().cleanPath(configFileName);
 
         QFileInfo fileInfo(configFileName);
-        path = fileInfo.path() + "/";
+        settings.path = fileInfo.path() + "/";
     }
     else
     {
@@ -373,7 +412,7 @@ int Crit1DProject::initializeProject(QString settingsFileName)
     if (! readSettings())
         return ERROR_SETTINGS_MISSINGDATA;
 
-    logger.setLog(path, projectName, addDateTimeLogFile);
+    logger.setLog(settings.path, settings.projectName, settings.addDateTimeLogFile);
 
     checkSimulationDates();
 
@@ -392,7 +431,7 @@ int Crit1DProject::initializeProject(QString settingsFileName)
     projectError = "";
 
     // Computational unit list
-    if (! readComputationUnitList(dbComputationUnitsName, compUnitList, projectError))
+    if (! readComputationUnitList(settings.dbComputationUnitsName, compUnitList, projectError))
     {
         logger.writeError(projectError);
         return ERROR_READ_UNITS;
@@ -408,49 +447,49 @@ int Crit1DProject::initializeProject(QString settingsFileName)
 void Crit1DProject::checkSimulationDates()
 {
     // first date
-    QString dateStr = firstSimulationDate.toString("yyyy-MM-dd");
+    QString dateStr = settings.firstSimulationDate.toString("yyyy-MM-dd");
     if (dateStr == "1800-01-01")
     {
-        isRestart = false;
+        settings.isRestart = false;
         dateStr = "UNDEFINED";
     }
     logger.writeInfo("First simulation date: " + dateStr);
-    QString boolStr = isRestart ? "TRUE" : "FALSE";
+    QString boolStr = settings.isRestart ? "TRUE" : "FALSE";
     logger.writeInfo("Restart: " + boolStr);
 
     // last date
-    dateStr = lastSimulationDate.toString("yyyy-MM-dd");
+    dateStr = settings.lastSimulationDate.toString("yyyy-MM-dd");
     if (dateStr == "1800-01-01")
     {
-        if (isXmlMeteoGrid)
+        if (settings.isXmlMeteoGrid)
         {
-            lastSimulationDate = QDate::currentDate().addDays(-1);
-            dateStr = lastSimulationDate.toString("yyyy-MM-dd");
+            settings.lastSimulationDate = QDate::currentDate().addDays(-1);
+            dateStr = settings.lastSimulationDate.toString("yyyy-MM-dd");
         }
         else
         {
-            isSaveState = false;
+            settings.isSaveState = false;
             dateStr = "UNDEFINED";
         }
     }
 
     logger.writeInfo("Last simulation date: " + dateStr);
-    boolStr = isSaveState? "TRUE" : "FALSE";
+    boolStr = settings.isSaveState? "TRUE" : "FALSE";
     logger.writeInfo("Save state: " + boolStr);
 
-    if (isSeasonalForecast)
+    if (settings.isSeasonalForecast)
     {
-        logger.writeInfo("First forecast month: " + QString::number(firstMonth));
+        logger.writeInfo("First forecast month: " + QString::number(settings.firstMonth));
     }
 
-    if (isMonthlyStatistics)
+    if (settings.isMonthlyStatistics)
     {
-        logger.writeInfo("Computation month: " + QString::number(firstMonth));
+        logger.writeInfo("Computation month: " + QString::number(settings.firstMonth));
     }
 
-    if (isShortTermForecast || isEnsembleForecast)
+    if (settings.isShortTermForecast || settings.isEnsembleForecast)
     {
-        logger.writeInfo("Nr of forecast days: " + QString::number(daysOfForecast));
+        logger.writeInfo("Nr of forecast days: " + QString::number(settings.daysOfForecast));
     }
 }
 
@@ -482,17 +521,17 @@ bool Crit1DProject::setMeteoXmlGrid(QString idMeteo, QString idForecast, unsigne
 {
     // check date
     QDate NODATE = QDate(1800, 1, 1);
-    if (! firstSimulationDate.isValid() || firstSimulationDate == NODATE )
+    if (! settings.firstSimulationDate.isValid() || settings.firstSimulationDate == NODATE )
     {
         projectError = "Missing first simulation date.";
         return false;
     }
-    if (! lastSimulationDate.isValid() || lastSimulationDate == NODATE )
+    if (! settings.lastSimulationDate.isValid() || settings.lastSimulationDate == NODATE )
     {
         projectError = "Missing last simulation date.";
         return false;
     }
-    unsigned nrDays = unsigned(firstSimulationDate.daysTo(lastSimulationDate)) + 1;
+    unsigned nrDays = unsigned(settings.firstSimulationDate.daysTo(settings.lastSimulationDate)) + 1;
 
     unsigned row, col;
     if (! observedMeteoGrid->meteoGrid()->findMeteoPointFromId(&row, &col, idMeteo.toStdString()) )
@@ -503,7 +542,7 @@ bool Crit1DProject::setMeteoXmlGrid(QString idMeteo, QString idForecast, unsigne
 
     if (! observedMeteoGrid->gridStructure().isFixedFields())
     {
-        if (! observedMeteoGrid->loadGridDailyData(projectError, idMeteo, firstSimulationDate, lastSimulationDate))
+        if (! observedMeteoGrid->loadGridDailyData(projectError, idMeteo, settings.firstSimulationDate, settings.lastSimulationDate))
         {
             projectError = "Missing observed data: " + idMeteo;
             return false;
@@ -511,7 +550,7 @@ bool Crit1DProject::setMeteoXmlGrid(QString idMeteo, QString idForecast, unsigne
     }
     else
     {
-        if (! observedMeteoGrid->loadGridDailyDataFixedFields(projectError, idMeteo, firstSimulationDate, lastSimulationDate))
+        if (! observedMeteoGrid->loadGridDailyDataFixedFields(projectError, idMeteo, settings.firstSimulationDate, settings.lastSimulationDate))
         {
             if (projectError == "Missing MeteoPoint id")
             {
@@ -525,12 +564,12 @@ bool Crit1DProject::setMeteoXmlGrid(QString idMeteo, QString idForecast, unsigne
         }
     }
 
-    if (isShortTermForecast)
+    if (settings.isShortTermForecast)
     {
         if (! forecastMeteoGrid->gridStructure().isFixedFields())
         {
-            if (! forecastMeteoGrid->loadGridDailyData(projectError, idForecast, lastSimulationDate.addDays(1),
-                                                            lastSimulationDate.addDays(daysOfForecast)))
+            if (! forecastMeteoGrid->loadGridDailyData(projectError, idForecast, settings.lastSimulationDate.addDays(1),
+                                                            settings.lastSimulationDate.addDays(settings.daysOfForecast)))
             {
                 if (projectError == "Missing MeteoPoint id")
                 {
@@ -546,7 +585,7 @@ bool Crit1DProject::setMeteoXmlGrid(QString idMeteo, QString idForecast, unsigne
         else
         {
             if (! forecastMeteoGrid->loadGridDailyDataFixedFields(projectError, idForecast,
-                                              lastSimulationDate.addDays(1), lastSimulationDate.addDays(daysOfForecast)))
+                                              settings.lastSimulationDate.addDays(1), settings.lastSimulationDate.addDays(settings.daysOfForecast)))
             {
                 if (projectError == "Missing MeteoPoint id")
                 {
@@ -559,10 +598,10 @@ bool Crit1DProject::setMeteoXmlGrid(QString idMeteo, QString idForecast, unsigne
                 return false;
             }
         }
-        nrDays += unsigned(daysOfForecast);
+        nrDays += unsigned(settings.daysOfForecast);
     }
 
-    if (isEnsembleForecast)
+    if (settings.isEnsembleForecast)
     {
         if (forecastMeteoGrid->gridStructure().isFixedFields())
         {
@@ -572,7 +611,7 @@ bool Crit1DProject::setMeteoXmlGrid(QString idMeteo, QString idForecast, unsigne
         else
         {
             if (! forecastMeteoGrid->loadGridDailyDataEnsemble(projectError, idForecast, int(memberNr),
-                                            lastSimulationDate.addDays(1), lastSimulationDate.addDays(daysOfForecast)))
+                                            settings.lastSimulationDate.addDays(1), settings.lastSimulationDate.addDays(settings.daysOfForecast)))
             {
                 if (projectError == "Missing MeteoPoint id")
                 {
@@ -585,18 +624,18 @@ bool Crit1DProject::setMeteoXmlGrid(QString idMeteo, QString idForecast, unsigne
                 return false;
             }
         }
-        nrDays += unsigned(daysOfForecast);
+        nrDays += unsigned(settings.daysOfForecast);
     }
 
     myCase.meteoPoint.latitude = observedMeteoGrid->meteoGrid()->meteoPointPointer(row, col)->latitude;
     myCase.meteoPoint.longitude = observedMeteoGrid->meteoGrid()->meteoPointPointer(row, col)->longitude;
-    myCase.meteoPoint.initializeObsDataD(nrDays, getCrit3DDate(firstSimulationDate));
+    myCase.meteoPoint.initializeObsDataD(nrDays, getCrit3DDate(settings.firstSimulationDate));
 
     float tmin, tmax, tavg, prec;
-    long lastIndex = long(firstSimulationDate.daysTo(lastSimulationDate)) + 1;
+    long lastIndex = long(settings.firstSimulationDate.daysTo(settings.lastSimulationDate)) + 1;
     for (int i = 0; i < lastIndex; i++)
     {
-        Crit3DDate myDate = getCrit3DDate(firstSimulationDate.addDays(i));
+        Crit3DDate myDate = getCrit3DDate(settings.firstSimulationDate.addDays(i));
         tmin = observedMeteoGrid->meteoGrid()->meteoPointPointer(row, col)->getMeteoPointValueD(myDate, dailyAirTemperatureMin);
         myCase.meteoPoint.setMeteoPointValueD(myDate, dailyAirTemperatureMin, tmin);
 
@@ -614,10 +653,10 @@ bool Crit1DProject::setMeteoXmlGrid(QString idMeteo, QString idForecast, unsigne
         myCase.meteoPoint.setMeteoPointValueD(myDate, dailyPrecipitation, prec);
     }
 
-    if (isShortTermForecast || isEnsembleForecast)
+    if (settings.isShortTermForecast || settings.isEnsembleForecast)
     {
-        QDate start = lastSimulationDate.addDays(1);
-        QDate end = lastSimulationDate.addDays(daysOfForecast);
+        QDate start = settings.lastSimulationDate.addDays(1);
+        QDate end = settings.lastSimulationDate.addDays(settings.daysOfForecast);
         for (int i = 0; i< start.daysTo(end)+1; i++)
         {
             Crit3DDate myDate = getCrit3DDate(start.addDays(i));
@@ -707,29 +746,29 @@ bool Crit1DProject::setMeteoSqlite(QString idMeteo, QString idForecast)
     bool subQuery = false;
 
     // check dates
-    if (firstSimulationDate.toString("yyyy-MM-dd") != "1800-01-01")
+    if (settings.firstSimulationDate.toString("yyyy-MM-dd") != "1800-01-01")
     {
-        if (firstSimulationDate < firstDate)
+        if (settings.firstSimulationDate < firstDate)
         {
-            projectError = "Missing meteo data: required first date " + firstSimulationDate.toString("yyyy-MM-dd");
+            projectError = "Missing meteo data: required first date " + settings.firstSimulationDate.toString("yyyy-MM-dd");
             return false;
         }
         else
         {
-            firstDate = firstSimulationDate;
+            firstDate = settings.firstSimulationDate;
             subQuery = true;
         }
     }
-    if (lastSimulationDate.toString("yyyy-MM-dd") != "1800-01-01")
+    if (settings.lastSimulationDate.toString("yyyy-MM-dd") != "1800-01-01")
     {
-        if (lastSimulationDate > lastDate)
+        if (settings.lastSimulationDate > lastDate)
         {
-            projectError = "Missing meteo data: required last date " + lastSimulationDate.toString("yyyy-MM-dd");
+            projectError = "Missing meteo data: required last date " + settings.lastSimulationDate.toString("yyyy-MM-dd");
             return false;
         }
         else
         {
-            lastDate = lastSimulationDate;
+            lastDate = settings.lastSimulationDate;
             subQuery = true;
         }
     }
@@ -745,8 +784,8 @@ bool Crit1DProject::setMeteoSqlite(QString idMeteo, QString idForecast)
     }
 
     // Forecast: increase nr of days
-    if (isShortTermForecast)
-        nrDays += unsigned(daysOfForecast);
+    if (settings.isShortTermForecast)
+        nrDays += unsigned(settings.daysOfForecast);
 
     // Initialize data
     myCase.meteoPoint.initializeObsDataD(nrDays, getCrit3DDate(firstDate));
@@ -759,7 +798,7 @@ bool Crit1DProject::setMeteoSqlite(QString idMeteo, QString idForecast)
     // write missing data on log
     if (projectError != "")
     {
-        this->logger.writeInfo(projectError);
+        logInfo(projectError);
         projectError = "";
     }
 
@@ -826,13 +865,13 @@ bool Crit1DProject::setMeteoSqlite(QString idMeteo, QString idForecast)
         }
 
         // Read forecast data
-        maxNrDays = daysOfForecast;
+        maxNrDays = settings.daysOfForecast;
         if (! readDailyDataCriteria1D(query, myCase.meteoPoint, maxNrDays, projectError))
                 return false;
 
         if (projectError != "")
         {
-            this->logger.writeInfo(projectError);
+            logInfo(projectError);
         }
 
         // fill temperature (only forecast)
@@ -895,7 +934,8 @@ bool Crit1DProject::computeCase(unsigned int memberNr)
 {
     myCase.fittingOptions.useWaterRetentionData = myCase.unit.useWaterRetentionData;
     // user wants to compute factor of safety
-    myCase.computeFactorOfSafety = (factorOfSafetyDepth.size() > 0);
+    myCase.computeFactorOfSafety = (settings.factorOfSafetyDepth.size() > 0);
+    myCase.hydraulicTableError = settings.hydraulicTableError;
 
     if (! loadCropParameters(dbCrop, myCase.unit.idCrop, myCase.crop, projectError))
         return false;
@@ -903,7 +943,7 @@ bool Crit1DProject::computeCase(unsigned int memberNr)
     if (! setSoil(myCase.unit.idSoil, projectError))
         return false;
 
-    if (isXmlMeteoGrid)
+    if (settings.isXmlMeteoGrid)
     {
         if (! setMeteoXmlGrid(myCase.unit.idMeteo, myCase.unit.idForecast, memberNr))
             return false;
@@ -921,13 +961,13 @@ bool Crit1DProject::computeCase(unsigned int memberNr)
         return false;
     }
 
-    if ( !isMonthlyStatistics && !isSeasonalForecast && !isEnsembleForecast )
+    if ( !settings.isMonthlyStatistics && !settings.isSeasonalForecast && !settings.isEnsembleForecast )
     {
         if (! createOutputTable(projectError))
             return false;
     }
     // get irri ratio
-    if (isYearlyStatistics || isMonthlyStatistics || isSeasonalForecast)
+    if (settings.isYearlyStatistics || settings.isMonthlyStatistics || settings.isSeasonalForecast)
     {
         float irriRatio = getIrriRatioFromCropClass(dbCrop, "crop_class", "id_class",
                                                 myCase.unit.idCropClass, projectError);
@@ -944,7 +984,7 @@ bool Crit1DProject::computeCase(unsigned int memberNr)
     firstDate = myCase.meteoPoint.obsDataD[0].date;
     lastDate = myCase.meteoPoint.obsDataD[lastIndex].date;
 
-    if (isYearlyStatistics || isMonthlyStatistics || isSeasonalForecast)
+    if (settings.isYearlyStatistics || settings.isMonthlyStatistics || settings.isSeasonalForecast)
     {
         initializeIrrigationStatistics(firstDate, lastDate);
     }
@@ -962,10 +1002,10 @@ bool Crit1DProject::computeCase(unsigned int memberNr)
     // restart
     bool isFirstDay = true;
     std::string errorString;
-    if (isRestart)
+    if (settings.isRestart)
     {
-        QString outputDbPath = getFilePath(dbOutput.databaseName());
-        QString stateDbName = outputDbPath + "state_" + firstSimulationDate.toString("yyyy_MM_dd")+".db";
+        QString outputDbPath = getFilePath(settings.dbOutputName);
+        QString stateDbName = outputDbPath + "state_" + settings.firstSimulationDate.toString("yyyy_MM_dd")+".db";
         if (! restoreState(stateDbName, projectError))
         {
             return false;
@@ -989,36 +1029,103 @@ bool Crit1DProject::computeCase(unsigned int memberNr)
         }
 
         // output
-        if (isYearlyStatistics || isMonthlyStatistics || isSeasonalForecast)
+        if (settings.isYearlyStatistics || settings.isMonthlyStatistics || settings.isSeasonalForecast)
         {
             updateIrrigationStatistics(myDate, indexIrrigationSeries);
         }
-        if (isEnsembleForecast)
+        if (settings.isEnsembleForecast)
         {
             updateMediumTermForecastOutput(myDate, memberNr);
         }
-        if ( !isEnsembleForecast && !isSeasonalForecast && !isMonthlyStatistics)
+        if ( !settings.isEnsembleForecast && !settings.isSeasonalForecast && !settings.isMonthlyStatistics)
         {
             updateOutput(myDate, isFirstDay);
             isFirstDay = false;
         }
     }
 
-    if (isSaveState)
+    if (settings.isSaveState)
     {
         if (! saveState(projectError))
             return false;
-        logger.writeInfo("Save state:" + dbState.databaseName());
+        logInfo("Save state:" + dbStateName);
     }
 
     // SeasonalForecast, EnsembleForecast and MonthlyStatistics do not produce db output (too much useless data)
-    if (isSeasonalForecast || isEnsembleForecast || isMonthlyStatistics)
+    if (settings.isSeasonalForecast || settings.isEnsembleForecast || settings.isMonthlyStatistics)
         return true;
     else
         return saveOutput(projectError);
 }
 
 
+/*!
+ * \brief computeUnitInList
+ * computes the unit compUnitList[index], reading crop and soil from the db
+ * \return a crit1DUnitStatus
+ */
+int Crit1DProject::computeUnitInList(unsigned int index)
+{
+    // is numerical
+    if (compUnitList[index].isNumericalInfiltration)
+    {
+        logInfo(compUnitList[index].idCase + " - numerical computation...");
+    }
+
+    // CROP
+    compUnitList[index].idCrop = getIdCropFromClass(dbCrop, "crop_class", "id_class",
+                                                    compUnitList[index].idCropClass, projectError);
+    if (compUnitList[index].idCrop == "")
+    {
+        logInfo("Unit " + compUnitList[index].idCase + " " + compUnitList[index].idCropClass + " ***** missing CROP *****");
+        return unitErrorCrop;
+    }
+
+    // IRRI_RATIO
+    float irriRatio = getIrriRatioFromCropClass(dbCrop, "crop_class", "id_class",
+                                                compUnitList[index].idCropClass, projectError);
+
+    if ((settings.isYearlyStatistics || settings.isMonthlyStatistics || settings.isSeasonalForecast || settings.isEnsembleForecast || settings.isShortTermForecast)
+        && (int(irriRatio) == int(NODATA)))
+    {
+        logInfo("Unit " + compUnitList[index].idCase + " " + compUnitList[index].idCropClass + " ***** missing IRRIGATION RATIO *****");
+        return unitSkipped;
+    }
+
+    // SOIL
+    if (compUnitList[index].idSoilNumber != NODATA)
+        compUnitList[index].idSoil = getIdSoilString(dbSoil, compUnitList[index].idSoilNumber, projectError);
+
+    if (compUnitList[index].idSoil == "")
+    {
+        logInfo("Unit " + compUnitList[index].idCase + " Soil nr." + QString::number(compUnitList[index].idSoilNumber) + " ***** missing SOIL *****");
+        return unitErrorSoil;
+    }
+
+    if (settings.isYearlyStatistics || settings.isMonthlyStatistics || settings.isSeasonalForecast)
+    {
+        if (! computeIrrigationStatistics(index, irriRatio))
+            return unitErrorModel;
+    }
+    else if (settings.isEnsembleForecast)
+    {
+        if (! computeMonthlyForecast(index, irriRatio))
+            return unitErrorModel;
+    }
+    else
+    {
+        if (! computeUnit(index, 0))
+        {
+            projectError = "Computational Unit: " + compUnitList[index].idCase + "\n" + projectError;
+            logError(projectError);
+            return unitErrorModel;
+        }
+    }
+
+    return unitComputed;
+}
+
+
 int Crit1DProject::computeAllUnits()
 {
     bool isErrorModel = false;
@@ -1026,14 +1133,14 @@ int Crit1DProject::computeAllUnits()
     bool isErrorCrop = false;
     unsigned int nrUnitsComputed = 0;
 
-    if (isYearlyStatistics || isMonthlyStatistics || isSeasonalForecast || isEnsembleForecast)
+    if (settings.isYearlyStatistics || settings.isMonthlyStatistics || settings.isSeasonalForecast || settings.isEnsembleForecast)
     {
         if (!setPercentileOutputCsv())
             return ERROR_DBOUTPUT;
     }
     else
     {
-        if (dbOutputName == "")
+        if (settings.dbOutputName == "")
         {
             logger.writeError("Missing output db");
             return ERROR_DBOUTPUT;
@@ -1042,7 +1149,7 @@ int Crit1DProject::computeAllUnits()
     }
 
     // create db state
-    if (isSaveState)
+    if (settings.isSaveState)
     {
         if (! createDbState(projectError))
         {
@@ -1054,87 +1161,42 @@ int Crit1DProject::computeAllUnits()
     int infoStep = std::max(1, int(compUnitList.size() / 20));
     logger.writeInfo("COMPUTE...");
 
-    try
+    // status of the units and progress, in the order of the list
+    auto countUnit = [&](unsigned int i, int status)
     {
-        for (unsigned int i = 0; i < compUnitList.size(); i++)
-        {
-            // is numerical
-            if (compUnitList[i].isNumericalInfiltration)
-            {
-                logger.writeInfo(compUnitList[i].idCase + " - numerical computation...");
-            }
-
-            // CROP
-            compUnitList[i].idCrop = getIdCropFromClass(dbCrop, "crop_class", "id_class",
-                                                         compUnitList[i].idCropClass, projectError);
-            if (compUnitList[i].idCrop == "")
-            {
-                logger.writeInfo("Unit " + compUnitList[i].idCase + " " + compUnitList[i].idCropClass + " ***** missing CROP *****");
-                isErrorCrop = true;
-                continue;
-            }
-
-            // IRRI_RATIO
-            float irriRatio = getIrriRatioFromCropClass(dbCrop, "crop_class", "id_class",
-                                                    compUnitList[i].idCropClass, projectError);
-
-            if ((isYearlyStatistics || isMonthlyStatistics || isSeasonalForecast || isEnsembleForecast || isShortTermForecast)
-                && (int(irriRatio) == int(NODATA)))
-            {
-                logger.writeInfo("Unit " + compUnitList[i].idCase + " " + compUnitList[i].idCropClass + " ***** missing IRRIGATION RATIO *****");
-                continue;
-            }
-
-            // SOIL
-            if (compUnitList[i].idSoilNumber != NODATA)
-                compUnitList[i].idSoil = getIdSoilString(dbSoil, compUnitList[i].idSoilNumber, projectError);
+        if (status == unitComputed)
+            nrUnitsComputed++;
+        else if (status == unitErrorModel)
+            isErrorModel = true;
+        else if (status == unitErrorSoil)
+            isErrorSoil = true;
+        else if (status == unitErrorCrop)
+            isErrorCrop = true;
 
-            if (compUnitList[i].idSoil == "")
-            {
-                logger.writeInfo("Unit " + compUnitList[i].idCase + " Soil nr." + QString::number(compUnitList[i].idSoilNumber) + " ***** missing SOIL *****");
-                isErrorSoil = true;
-                continue;
-            }
+        if ((i+1) % infoStep == 0 && nrUnitsComputed > 0)
+        {
+            double percentage = (i+1) * 100.0 / compUnitList.size();
+            logger.writeInfo("..." + QString::number(round(percentage)) + "%");
+        }
+    };
 
-            if (isYearlyStatistics || isMonthlyStatistics || isSeasonalForecast)
-            {
-                if (computeIrrigationStatistics(i, irriRatio))
-                    nrUnitsComputed++;
-                else
-                    isErrorModel = true;
-            }
-            else
-            {
-                if (isEnsembleForecast)
-                {
-                    if (computeMonthlyForecast(i, irriRatio))
-                        nrUnitsComputed++;
-                    else
-                        isErrorModel = true;
-                }
-                else
-                {
-                    if (computeUnit(i, 0))
-                    {
-                        nrUnitsComputed++;
-                    }
-                    else
-                    {
-                        projectError = "Computational Unit: " + compUnitList[i].idCase + "\n" + projectError;
-                        logger.writeError(projectError);
-                        isErrorModel = true;
-                    }
-                }
-            }
+    int nrWorkers = std::min(parallel::getNrThreads(settings.nrThreads), int(compUnitList.size()));
 
-            if ((i+1) % infoStep == 0 && nrUnitsComputed > 0)
+    try
+    {
+        if (nrWorkers > 1)
+        {
+            computeAllUnitsParallel(nrWorkers, countUnit);
+        }
+        else
+        {
+            for (unsigned int i = 0; i < compUnitList.size(); i++)
             {
-                double percentage = (i+1) * 100.0 / compUnitList.size();
-                logger.writeInfo("..." + QString::number(round(percentage)) + "%");
+                countUnit(i, computeUnitInList(i));
             }
         }
 
-        if (isYearlyStatistics || isMonthlyStatistics || isSeasonalForecast || isEnsembleForecast)
+        if (settings.isYearlyStatistics || settings.isMonthlyStatistics || settings.isSeasonalForecast || settings.isEnsembleForecast)
         {
             outputCsvFile.close();
         }
@@ -1175,17 +1237,189 @@ int Crit1DProject::computeAllUnits()
 }
 
 
+/*!
+ * \brief computeAllUnitsParallel
+ * the units are dealt in list order to nrWorkers threads, each one with its own case,
+ * meteo data, db connections and soilFluxes3D context.
+ * The calling thread is the only writer: it writes the outputs in the order of the list
+ * (log, db and csv are the same of the serial computation), UNITS_PER_TRANSACTION units
+ * for each transaction. Workers wait when they are too far ahead of the writer.
+ */
+void Crit1DProject::computeAllUnitsParallel(int nrWorkers, const std::function<void(unsigned int, int)> &countUnit)
+{
+    unsigned int nrUnits = unsigned(compUnitList.size());
+    unsigned int maxPendingUnits = unsigned(nrWorkers) * 4;
+
+    std::vector<Crit1DUnitOutput> outputList(nrUnits);
+    std::vector<bool> isReady(nrUnits, false);
+    std::atomic<unsigned int> nextUnit(0);
+    unsigned int nrUnitsWritten = 0;
+
+    std::mutex outputMutex;
+    std::condition_variable outputReady;
+    std::condition_variable outputWritten;
+
+    auto worker = [&](int workerIndex)
+    {
+        TCrit3DContext* context = soilFluxes3D::createContext();
+        soilFluxes3D::setContext(context);
+
+        Crit1DProject* workerProject = new Crit1DProject();
+        QString workerError;
+        bool isWorkerOk = workerProject->initializeWorker(*this, workerIndex, workerError);
+
+        unsigned int index;
+        while ((index = nextUnit++) < nrUnits)
+        {
+            {
+                std::unique_lock<std::mutex> lock(outputMutex);
+                outputWritten.wait(lock, [&]{ return index < nrUnitsWritten + maxPendingUnits; });
+            }
+
+            Crit1DUnitOutput output;
+            output.status = unitErrorModel;
+            if (isWorkerOk)
+            {
+                workerProject->unitOutput = &output;
+                try
+                {
+                    output.status = workerProject->computeUnitInList(index);
+                }
+                catch (std::exception &e)
+                {
+                    workerProject->logError("Computational Unit: " + compUnitList[index].idCase
+                                            + "\nError " + QString(e.what()));
+                    output.status = unitErrorModel;
+                }
+                workerProject->unitOutput = nullptr;
+
+                output.idCrop = workerProject->compUnitList[index].idCrop;
+                output.idSoil = workerProject->compUnitList[index].idSoil;
+            }
+            else
+            {
+                output.logLines.push_back("Computational Unit: " + compUnitList[index].idCase + "\n" + workerError);
+                output.isErrorLine.push_back(true);
+                output.idCrop = compUnitList[index].idCrop;
+                output.idSoil = compUnitList[index].idSoil;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(outputMutex);
+                outputList[index] = std::move(output);
+                isReady[index] = true;
+            }
+            outputReady.notify_one();
+        }
+
+        workerProject->closeWorkerDatabase();
+        delete workerProject;
+        soilFluxes3D::deleteContext(context);
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < nrWorkers; i++)
+        threads.emplace_back(worker, i);
+
+    bool isOutputDb = dbOutput.isOpen();
+    bool isStateDb = settings.isSaveState && dbState.isOpen();
+
+    for (unsigned int i = 0; i < nrUnits; i++)
+    {
+        Crit1DUnitOutput output;
+        {
+            std::unique_lock<std::mutex> lock(outputMutex);
+            outputReady.wait(lock, [&]{ return bool(isReady[i]); });
+            output = std::move(outputList[i]);
+        }
+
+        if (i % UNITS_PER_TRANSACTION == 0)
+        {
+            if (isOutputDb) dbOutput.transaction();
+            if (isStateDb) dbState.transaction();
+        }
+
+        compUnitList[i].idCrop = output.idCrop;
+        compUnitList[i].idSoil = output.idSoil;
+
+        QString errorStr;
+        if (! writeUnitOutput(output, errorStr))
+        {
+            projectError = "Computational Unit: " + compUnitList[i].idCase + "\n" + errorStr;
+            logger.writeError(projectError);
+            output.status = unitErrorModel;
+        }
+
+        if ((i+1) % UNITS_PER_TRANSACTION == 0 || i+1 == nrUnits)
+        {
+            if (isOutputDb) dbOutput.commit();
+            if (isStateDb) dbState.commit();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(outputMutex);
+            nrUnitsWritten = i+1;
+        }
+        outputWritten.notify_all();
+
+        countUnit(i, output.status);
+    }
+
+    for (unsigned int i = 0; i < threads.size(); i++)
+        threads[i].join();
+}
+
+
+// writes the output of a unit computed by a worker: log lines, db output and state, csv rows
+bool Crit1DProject::writeUnitOutput(Crit1DUnitOutput &output, QString &errorStr)
+{
+    for (unsigned int i = 0; i < output.logLines.size(); i++)
+    {
+        if (output.isErrorLine[i])
+            logger.writeError(output.logLines[i]);
+        else
+            logger.writeInfo(output.logLines[i]);
+    }
+
+    for (unsigned int i = 0; i < output.outputQueries.size(); i++)
+    {
+        if (! executeOutputQuery(output.outputQueries[i], errorStr))
+        {
+            errorStr = "Error in writing output:\n" + errorStr;
+            return false;
+        }
+    }
+
+    for (unsigned int i = 0; i < output.stateQueries.size(); i++)
+    {
+        if (! executeStateQuery(output.stateQueries[i], errorStr))
+        {
+            errorStr = "Error in saving state:\n" + errorStr;
+            return false;
+        }
+    }
+
+    if (! output.csvRows.empty())
+    {
+        outputCsvFile << output.csvRows;
+        outputCsvFile.flush();
+    }
+
+    return true;
+}
+
+
 // update values of medium term forecast
 void Crit1DProject::updateMediumTermForecastOutput(Crit3DDate myDate, unsigned int memberNr)
 {
     QDate myQdate = getQDate(myDate);
 
-    if (myQdate == lastSimulationDate)
+    if (myQdate == settings.lastSimulationDate)
     {
         irriSeries[memberNr] = 0;
         precSeries[memberNr] = 0;
     }
-    else if (myQdate > lastSimulationDate)
+    else if (myQdate > settings.lastSimulationDate)
     {
         irriSeries[memberNr] += float(myCase.output.dailyIrrigation);
         precSeries[memberNr] += float(myCase.output.dailyPrec);
@@ -1196,34 +1430,34 @@ void Crit1DProject::updateMediumTermForecastOutput(Crit3DDate myDate, unsigned i
 // update values of annual irrigation
 void Crit1DProject::updateIrrigationStatistics(Crit3DDate myDate, int &currentIndex)
 {
-    if ( !isYearlyStatistics && !isMonthlyStatistics && !isSeasonalForecast )
+    if ( !settings.isYearlyStatistics && !settings.isMonthlyStatistics && !settings.isSeasonalForecast )
         return;
 
     bool isInsideSeason = false;
 
-    if (isYearlyStatistics)
+    if (settings.isYearlyStatistics)
     {
         isInsideSeason = true;
     }
 
-    if (isMonthlyStatistics)
+    if (settings.isMonthlyStatistics)
     {
-        isInsideSeason = (myDate.month == firstMonth);
+        isInsideSeason = (myDate.month == settings.firstMonth);
     }
 
-    if (isSeasonalForecast)
+    if (settings.isSeasonalForecast)
     {
         // interannual seasons
-        if (firstMonth < 11)
+        if (settings.firstMonth < 11)
         {
-            if (myDate.month >= firstMonth && myDate.month <= firstMonth+2)
+            if (myDate.month >= settings.firstMonth && myDate.month <= settings.firstMonth+2)
                 isInsideSeason = true;
         }
         // NDJ or DJF
         else
         {
-            int lastMonth = (firstMonth + 2) % 12;
-            if (myDate.month >= firstMonth || myDate.month <= lastMonth)
+            int lastMonth = (settings.firstMonth + 2) % 12;
+            if (myDate.month >= settings.firstMonth || myDate.month <= lastMonth)
                 isInsideSeason = true;
         }
     }
@@ -1231,7 +1465,7 @@ void Crit1DProject::updateIrrigationStatistics(Crit3DDate myDate, int &currentIn
     if (isInsideSeason)
     {
         // first date of season
-        if (myDate.day == 1 && myDate.month == firstMonth)
+        if (myDate.day == 1 && myDate.month == settings.firstMonth)
         {
             if (currentIndex == NODATA)
                 currentIndex = 0;
@@ -1253,12 +1487,12 @@ void Crit1DProject::updateIrrigationStatistics(Crit3DDate myDate, int &currentIn
 
 bool Crit1DProject::computeMonthlyForecast(unsigned int unitIndex, float irriRatio)
 {
-    logger.writeInfo(compUnitList[unitIndex].idCase);
+    logInfo(compUnitList[unitIndex].idCase);
 
     if (!forecastMeteoGrid->gridStructure().isEnsemble())
     {
         projectError = "Forecast grid is not Ensemble.";
-        logger.writeError(projectError);
+        logError(projectError);
         return false;
     }
 
@@ -1266,7 +1500,7 @@ bool Crit1DProject::computeMonthlyForecast(unsigned int unitIndex, float irriRat
     if (nrYears < 1)
     {
         projectError = "Missing ensemble members.";
-        logger.writeError(projectError);
+        logError(projectError);
         return false;
     }
 
@@ -1276,40 +1510,41 @@ bool Crit1DProject::computeMonthlyForecast(unsigned int unitIndex, float irriRat
     {
         if (! computeUnit(unitIndex, memberNr))
         {
-            logger.writeError(projectError);
+            logError(projectError);
             return false;
         }
     }
 
     // write output
-    outputCsvFile << compUnitList[unitIndex].idCase.toStdString();
-    outputCsvFile << "," << compUnitList[unitIndex].idCropClass.toStdString();
+    std::ostringstream csvRow;
+    csvRow << compUnitList[unitIndex].idCase.toStdString();
+    csvRow << "," << compUnitList[unitIndex].idCropClass.toStdString();
 
     // percentiles irrigation
     float percentile = sorting::percentile(irriSeries, nrYears, 5, true);
-    outputCsvFile << "," << QString::number(double(percentile * irriRatio), 'f', 1).toStdString();
+    csvRow << "," << QString::number(double(percentile * irriRatio), 'f', 1).toStdString();
     percentile = sorting::percentile(irriSeries, nrYears, 25, false);
-    outputCsvFile << "," << QString::number(double(percentile * irriRatio), 'f', 1).toStdString();
+    csvRow << "," << QString::number(double(percentile * irriRatio), 'f', 1).toStdString();
     percentile = sorting::percentile(irriSeries, nrYears, 50, false);
-    outputCsvFile << "," << QString::number(double(percentile * irriRatio), 'f', 1).toStdString();
+    csvRow << "," << QString::number(double(percentile * irriRatio), 'f', 1).toStdString();
     percentile = sorting::percentile(irriSeries, nrYears, 75, false);
-    outputCsvFile << "," << QString::number(double(percentile * irriRatio), 'f', 1).toStdString();
+    csvRow << "," << QString::number(double(percentile * irriRatio), 'f', 1).toStdString();
     percentile = sorting::percentile(irriSeries, nrYears, 95, false);
-    outputCsvFile << "," << QString::number(double(percentile * irriRatio), 'f', 1).toStdString();
+    csvRow << "," << QString::number(double(percentile * irriRatio), 'f', 1).toStdString();
 
     // percentiles prec
     percentile = sorting::percentile(precSeries, nrYears, 5, true);
-    outputCsvFile << "," << QString::number(double(percentile), 'f', 1).toStdString();
+    csvRow << "," << QString::number(double(percentile), 'f', 1).toStdString();
     percentile = sorting::percentile(precSeries, nrYears, 25, false);
-    outputCsvFile << "," << QString::number(double(percentile), 'f', 1).toStdString();
+    csvRow << "," << QString::number(double(percentile), 'f', 1).toStdString();
     percentile = sorting::percentile(precSeries, nrYears, 50, false);
-    outputCsvFile << "," << QString::number(double(percentile), 'f', 1).toStdString();
+    csvRow << "," << QString::number(double(percentile), 'f', 1).toStdString();
     percentile = sorting::percentile(precSeries, nrYears, 75, false);
-    outputCsvFile << "," << QString::number(double(percentile), 'f', 1).toStdString();
+    csvRow << "," << QString::number(double(percentile), 'f', 1).toStdString();
     percentile = sorting::percentile(precSeries, nrYears, 95, false);
-    outputCsvFile << "," << QString::number(double(percentile), 'f', 1).toStdString() << "\n";
+    csvRow << "," << QString::number(double(percentile), 'f', 1).toStdString() << "\n";
 
-    outputCsvFile.flush();
+    writeCsvRow(csvRow.str());
 
     return true;
 }
@@ -1320,47 +1555,48 @@ bool Crit1DProject::computeIrrigationStatistics(unsigned int index, float irriRa
     if (! computeUnit(index, 0))
     {
         projectError = "Computational Unit: " + compUnitList[index].idCase + " - " + projectError;
-        logger.writeError(projectError);
+        logError(projectError);
         return false;
     }
 
-    outputCsvFile << compUnitList[index].idCase.toStdString() << "," << compUnitList[index].idCrop.toStdString() << ",";
-    outputCsvFile << compUnitList[index].idSoil.toStdString() << "," << compUnitList[index].idMeteo.toStdString();
+    std::ostringstream csvRow;
+    csvRow << compUnitList[index].idCase.toStdString() << "," << compUnitList[index].idCrop.toStdString() << ",";
+    csvRow << compUnitList[index].idSoil.toStdString() << "," << compUnitList[index].idMeteo.toStdString();
 
     if (irriRatio < 0.001f)
     {
         // No irrigation
-        outputCsvFile << ",0,0,0,0,0\n";
+        csvRow << ",0,0,0,0,0\n";
     }
     else
     {
         // irrigation percentiles
         float percentile = sorting::percentile(irriSeries, nrYears, 5, true);
-        outputCsvFile << "," << percentile * irriRatio;
+        csvRow << "," << percentile * irriRatio;
         percentile = sorting::percentile(irriSeries, nrYears, 25, false);
-        outputCsvFile << "," << percentile * irriRatio;
+        csvRow << "," << percentile * irriRatio;
         percentile = sorting::percentile(irriSeries, nrYears, 50, false);
-        outputCsvFile << "," << percentile * irriRatio;
+        csvRow << "," << percentile * irriRatio;
         percentile = sorting::percentile(irriSeries, nrYears, 75, false);
-        outputCsvFile << "," << percentile * irriRatio;
+        csvRow << "," << percentile * irriRatio;
         percentile = sorting::percentile(irriSeries, nrYears, 95, false);
-        outputCsvFile << "," << percentile * irriRatio << "\n";
+        csvRow << "," << percentile * irriRatio << "\n";
     }
 
-    outputCsvFile.flush();
+    writeCsvRow(csvRow.str());
     return true;
 }
 
 
 bool Crit1DProject::setPercentileOutputCsv()
 {
-    QString outputCsvPath = getFilePath(outputCsvFileName);
+    QString outputCsvPath = getFilePath(settings.outputCsvFileName);
     if (! QDir(outputCsvPath).exists())
     {
         QDir().mkdir(outputCsvPath);
     }
 
-    outputCsvFile.open(outputCsvFileName.toStdString().c_str(), std::ios::out | std::ios::trunc);
+    outputCsvFile.open(settings.outputCsvFileName.toStdString().c_str(), std::ios::out | std::ios::trunc);
     if ( outputCsvFile.fail())
     {
         logger.writeError("open failure: " + QString(strerror(errno)) + '\n');
@@ -1368,14 +1604,14 @@ bool Crit1DProject::setPercentileOutputCsv()
     }
     else
     {
-        logger.writeInfo("Statistics output file (csv): " + outputCsvFileName + "\n");
+        logger.writeInfo("Statistics output file (csv): " + settings.outputCsvFileName + "\n");
     }
 
-    if (isYearlyStatistics || isMonthlyStatistics || isSeasonalForecast)
+    if (settings.isYearlyStatistics || settings.isMonthlyStatistics || settings.isSeasonalForecast)
     {
         outputCsvFile << "ID_CASE,CROP,SOIL,METEO,irri_05,irri_25,irri_50,irri_75,irri_95\n";
     }
-    if (isEnsembleForecast)
+    if (settings.isEnsembleForecast)
     {
         outputCsvFile << "ID_CASE,CROP,irri_05,irri_25,irri_50,irri_75,irri_95,prec_05,prec_25,prec_50,prec_75,prec_95\n";
     }
@@ -1402,9 +1638,9 @@ void Crit1DProject::initializeIrrigationStatistics(const Crit3DDate& firstDate,
 bool Crit1DProject::createDbState(QString &myError)
 {
     // create db state
-    QString dateStr = lastSimulationDate.addDays(1).toString("yyyy_MM_dd");
+    QString dateStr = settings.lastSimulationDate.addDays(1).toString("yyyy_MM_dd");
     QString outputDbPath = getFilePath(dbOutput.databaseName());
-    QString dbStateName = outputDbPath + "state_" + dateStr + ".db";
+    dbStateName = outputDbPath + "state_" + dateStr + ".db";
     if (QFile::exists(dbStateName))
     {
         QFile::remove(dbStateName);
@@ -1452,11 +1688,12 @@ bool Crit1DProject::restoreState(QString dbStateToRestoreName, QString &myError)
     }
 
     QSqlDatabase dbStateToRestore;
-    if (QSqlDatabase::contains("stateToRestore"))
-        dbStateToRestore = QSqlDatabase::database("stateToRestore");
+    QString connectionName = "stateToRestore" + connectionSuffix;
+    if (QSqlDatabase::contains(connectionName))
+        dbStateToRestore = QSqlDatabase::database(connectionName);
     else
     {
-        dbStateToRestore = QSqlDatabase::addDatabase("QSQLITE", "stateToRestore");
+        dbStateToRestore = QSqlDatabase::addDatabase("QSQLITE", connectionName);
         dbStateToRestore.setDatabaseName(dbStateToRestoreName);
     }
 
@@ -1553,19 +1790,17 @@ bool Crit1DProject::restoreState(QString dbStateToRestoreName, QString &myError)
 
 bool Crit1DProject::saveState(QString &myError)
 {
-    QString queryString;
-    QSqlQuery qry(dbState);
+    QString queryString, queryError;
 
     queryString = "INSERT INTO variables ( ID_CASE, DEGREE_DAYS, DAYS_SINCE_IRR ) VALUES ";
     queryString += "('" + myCase.unit.idCase + "'"
                 + "," + QString::number(myCase.crop.degreeDays)
                 + "," + QString::number(myCase.crop.daysSinceIrrigation) + ")";
-    if( !qry.exec(queryString) )
+    if (! executeStateQuery(queryString, queryError))
     {
-        myError = "Error in saving variables state:\n" + qry.lastError().text();
+        myError = "Error in saving variables state:\n" + queryError;
         return false;
     }
-    qry.clear();
 
     queryString = "INSERT INTO waterContent ( ID_CASE, NR_LAYER, WC ) VALUES ";
     for (unsigned int i = 0; i<myCase.soilLayers.size(); i++)
@@ -1576,23 +1811,23 @@ bool Crit1DProject::saveState(QString &myError)
             queryString += ",";
     }
 
-    if( !qry.exec(queryString))
+    if (! executeStateQuery(queryString, queryError))
     {
-        myError = "Error in saving waterContent state:\n" + qry.lastError().text();
+        myError = "Error in saving waterContent state:\n" + queryError;
         return false;
     }
 
-    qry.clear();
     return true;
 }
 
 
 bool Crit1DProject::createOutputTable(QString &myError)
 {
-    QString queryString = "DROP TABLE '" + myCase.unit.idCase + "'";
-    QSqlQuery myQuery = this->dbOutput.exec(queryString);
+    QString queryString = "DROP TABLE IF EXISTS '" + myCase.unit.idCase + "'";
+    QString queryError;
+    executeOutputQuery(queryString, queryError);
 
-    if (isClimateOutput)
+    if (settings.isClimateOutput)
     {
         queryString = "CREATE TABLE '" + myCase.unit.idCase + "'"
                       + " ( DATE TEXT, AVAILABLE_WATER REAL,"
@@ -1609,54 +1844,53 @@ bool Crit1DProject::createOutputTable(QString &myError)
     }
 
     // specific depth variables
-    for (unsigned int i = 0; i < waterContentDepth.size(); i++)
+    for (unsigned int i = 0; i < settings.waterContentDepth.size(); i++)
     {
-        QString fieldName = "VWC_" + QString::number(waterContentDepth[i]);
+        QString fieldName = "VWC_" + QString::number(settings.waterContentDepth[i]);
         queryString += ", " + fieldName + " REAL";
     }
-    for (unsigned int i = 0; i < degreeOfSaturationDepth.size(); i++)
+    for (unsigned int i = 0; i < settings.degreeOfSaturationDepth.size(); i++)
     {
-        QString fieldName = "DEGSAT_" + QString::number(degreeOfSaturationDepth[i]);
+        QString fieldName = "DEGSAT_" + QString::number(settings.degreeOfSaturationDepth[i]);
         queryString += ", " + fieldName + " REAL";
     }
-    for (unsigned int i = 0; i < waterPotentialDepth.size(); i++)
+    for (unsigned int i = 0; i < settings.waterPotentialDepth.size(); i++)
     {
-        QString fieldName = "WP_" + QString::number(waterPotentialDepth[i]);
+        QString fieldName = "WP_" + QString::number(settings.waterPotentialDepth[i]);
         queryString += ", " + fieldName + " REAL";
     }
-    for (unsigned int i = 0; i < waterDeficitDepth.size(); i++)
+    for (unsigned int i = 0; i < settings.waterDeficitDepth.size(); i++)
     {
-        QString fieldName = "DEFICIT_" + QString::number(waterDeficitDepth[i]);
+        QString fieldName = "DEFICIT_" + QString::number(settings.waterDeficitDepth[i]);
         queryString += ", " + fieldName + " REAL";
     }
-    for (unsigned int i = 0; i < awcDepth.size(); i++)
+    for (unsigned int i = 0; i < settings.awcDepth.size(); i++)
     {
-        QString fieldName = "AWC_" + QString::number(awcDepth[i]);
+        QString fieldName = "AWC_" + QString::number(settings.awcDepth[i]);
         queryString += ", " + fieldName + " REAL";
     }
-    for (unsigned int i = 0; i < availableWaterDepth.size(); i++)
+    for (unsigned int i = 0; i < settings.availableWaterDepth.size(); i++)
     {
-        QString fieldName = "AW_" + QString::number(availableWaterDepth[i]);
+        QString fieldName = "AW_" + QString::number(settings.availableWaterDepth[i]);
         queryString += ", " + fieldName + " REAL";
     }
-    for (unsigned int i = 0; i < fractionAvailableWaterDepth.size(); i++)
+    for (unsigned int i = 0; i < settings.fractionAvailableWaterDepth.size(); i++)
     {
-        QString fieldName = "FAW_" + QString::number(fractionAvailableWaterDepth[i]);
+        QString fieldName = "FAW_" + QString::number(settings.fractionAvailableWaterDepth[i]);
         queryString += ", " + fieldName + " REAL";
     }
-    for (unsigned int i = 0; i < factorOfSafetyDepth.size(); i++)
+    for (unsigned int i = 0; i < settings.factorOfSafetyDepth.size(); i++)
     {
-        QString fieldName = "FoS_" + QString::number(factorOfSafetyDepth[i]);
+        QString fieldName = "FoS_" + QString::number(settings.factorOfSafetyDepth[i]);
         queryString += ", " + fieldName + " REAL";
     }
 
     // close query
     queryString += ")";
-    myQuery = this->dbOutput.exec(queryString);
 
-    if (myQuery.lastError().isValid())
+    if (! executeOutputQuery(queryString, queryError))
     {
-        myError = "Error in creating table: " + myCase.unit.idCase + "\n" + myQuery.lastError().text();
+        myError = "Error in creating table: " + myCase.unit.idCase + "\n" + queryError;
         return false;
     }
 
@@ -1668,7 +1902,7 @@ void Crit1DProject::updateOutput(Crit3DDate myDate, bool isFirst)
 {
     if (isFirst)
     {
-        if (isClimateOutput)
+        if (settings.isClimateOutput)
         {
             outputString = "INSERT INTO '" + myCase.unit.idCase + "'"
                            + " (DATE, AVAILABLE_WATER,"
@@ -1684,44 +1918,44 @@ void Crit1DProject::updateOutput(Crit3DDate myDate, bool isFirst)
         }
 
         // specific depth variables
-        for (unsigned int i = 0; i < waterContentDepth.size(); i++)
+        for (unsigned int i = 0; i < settings.waterContentDepth.size(); i++)
         {
-            QString fieldName = "VWC_" + QString::number(waterContentDepth[i]);
+            QString fieldName = "VWC_" + QString::number(settings.waterContentDepth[i]);
             outputString += ", " + fieldName;
         }
-        for (unsigned int i = 0; i < degreeOfSaturationDepth.size(); i++)
+        for (unsigned int i = 0; i < settings.degreeOfSaturationDepth.size(); i++)
         {
-            QString fieldName = "DEGSAT_" + QString::number(degreeOfSaturationDepth[i]);
+            QString fieldName = "DEGSAT_" + QString::number(settings.degreeOfSaturationDepth[i]);
             outputString += ", " + fieldName;
         }
-        for (unsigned int i = 0; i < waterPotentialDepth.size(); i++)
+        for (unsigned int i = 0; i < settings.waterPotentialDepth.size(); i++)
         {
-            QString fieldName = "WP_" + QString::number(waterPotentialDepth[i]);
+            QString fieldName = "WP_" + QString::number(settings.waterPotentialDepth[i]);
             outputString += ", " + fieldName;
         }
-        for (unsigned int i = 0; i < waterDeficitDepth.size(); i++)
+        for (unsigned int i = 0; i < settings.waterDeficitDepth.size(); i++)
         {
-            QString fieldName = "DEFICIT_" + QString::number(waterDeficitDepth[i]);
+            QString fieldName = "DEFICIT_" + QString::number(settings.waterDeficitDepth[i]);
             outputString += ", " + fieldName;
         }
-        for (unsigned int i = 0; i < awcDepth.size(); i++)
+        for (unsigned int i = 0; i < settings.awcDepth.size(); i++)
         {
-            QString fieldName = "AWC_" + QString::number(awcDepth[i]);
+            QString fieldName = "AWC_" + QString::number(settings.awcDepth[i]);
             outputString += ", " + fieldName;
         }
-        for (unsigned int i = 0; i < availableWaterDepth.size(); i++)
+        for (unsigned int i = 0; i < settings.availableWaterDepth.size(); i++)
         {
-            QString fieldName = "AW_" + QString::number(availableWaterDepth[i]);
+            QString fieldName = "AW_" + QString::number(settings.availableWaterDepth[i]);
             outputString += ", " + fieldName;
         }
-        for (unsigned int i = 0; i < fractionAvailableWaterDepth.size(); i++)
+        for (unsigned int i = 0; i < settings.fractionAvailableWaterDepth.size(); i++)
         {
-            QString fieldName = "FAW_" + QString::number(fractionAvailableWaterDepth[i]);
+            QString fieldName = "FAW_" + QString::number(settings.fractionAvailableWaterDepth[i]);
             outputString += ", " + fieldName;
         }
-        for (unsigned int i = 0; i < factorOfSafetyDepth.size(); i++)
+        for (unsigned int i = 0; i < settings.factorOfSafetyDepth.size(); i++)
         {
-            QString fieldName = "FoS_" + QString::number(factorOfSafetyDepth[i]);
+            QString fieldName = "FoS_" + QString::number(settings.factorOfSafetyDepth[i]);
             outputString += ", " + fieldName;
         }
 
@@ -1732,7 +1966,7 @@ void Crit1DProject::updateOutput(Crit3DDate myDate, bool isFirst)
         outputString += ",";
     }
 
-    if (isClimateOutput)
+    if (settings.isClimateOutput)
     {
         outputString += "('" + QString::fromStdString(myDate.toStdString()) + "'"
                         + "," + QString::number(myCase.output.dailyAvailableWater, 'g', 4)
@@ -1764,37 +1998,37 @@ void Crit1DProject::updateOutput(Crit3DDate myDate, bool isFirst)
     }
 
     // specific depth variables
-    for (unsigned int i = 0; i < waterContentDepth.size(); i++)
+    for (unsigned int i = 0; i < settings.waterContentDepth.size(); i++)
     {
-        outputString += "," + QString::number(myCase.getVolumetricWaterContent(waterContentDepth[i]), 'g', 4);
+        outputString += "," + QString::number(myCase.getVolumetricWaterContent(settings.waterContentDepth[i]), 'g', 4);
     }
-    for (unsigned int i = 0; i < degreeOfSaturationDepth.size(); i++)
+    for (unsigned int i = 0; i < settings.degreeOfSaturationDepth.size(); i++)
     {
-        outputString += "," + QString::number(myCase.getDegreeOfSaturation(degreeOfSaturationDepth[i]), 'g', 4);
+        outputString += "," + QString::number(myCase.getDegreeOfSaturation(settings.degreeOfSaturationDepth[i]), 'g', 4);
     }
-    for (unsigned int i = 0; i < waterPotentialDepth.size(); i++)
+    for (unsigned int i = 0; i < settings.waterPotentialDepth.size(); i++)
     {
-        outputString += "," + QString::number(myCase.getWaterPotential(waterPotentialDepth[i]), 'g', 4);
+        outputString += "," + QString::number(myCase.getWaterPotential(settings.waterPotentialDepth[i]), 'g', 4);
     }
-    for (unsigned int i = 0; i < waterDeficitDepth.size(); i++)
+    for (unsigned int i = 0; i < settings.waterDeficitDepth.size(); i++)
     {
-        outputString += "," + QString::number(myCase.getWaterDeficitSum(waterDeficitDepth[i]), 'g', 4);
+        outputString += "," + QString::number(myCase.getWaterDeficitSum(settings.waterDeficitDepth[i]), 'g', 4);
     }
-    for (unsigned int i = 0; i < awcDepth.size(); i++)
+    for (unsigned int i = 0; i < settings.awcDepth.size(); i++)
     {
-        outputString += "," + QString::number(myCase.getWaterCapacitySum(awcDepth[i]), 'g', 4);
+        outputString += "," + QString::number(myCase.getWaterCapacitySum(settings.awcDepth[i]), 'g', 4);
     }
-    for (unsigned int i = 0; i < availableWaterDepth.size(); i++)
+    for (unsigned int i = 0; i < settings.availableWaterDepth.size(); i++)
     {
-        outputString += "," + QString::number(myCase.getAvailableWaterSum(availableWaterDepth[i]), 'g', 4);
+        outputString += "," + QString::number(myCase.getAvailableWaterSum(settings.availableWaterDepth[i]), 'g', 4);
     }
-    for (unsigned int i = 0; i < fractionAvailableWaterDepth.size(); i++)
+    for (unsigned int i = 0; i < settings.fractionAvailableWaterDepth.size(); i++)
     {
-        outputString += "," + QString::number(myCase.getFractionAW(fractionAvailableWaterDepth[i]), 'g', 3);
+        outputString += "," + QString::number(myCase.getFractionAW(settings.fractionAvailableWaterDepth[i]), 'g', 3);
     }
-    for (unsigned int i = 0; i < factorOfSafetyDepth.size(); i++)
+    for (unsigned int i = 0; i < settings.factorOfSafetyDepth.size(); i++)
     {
-        outputString += "," + QString::number(myCase.getSlopeStability(factorOfSafetyDepth[i]), 'g', 4);
+        outputString += "," + QString::number(myCase.getSlopeStability(settings.factorOfSafetyDepth[i]), 'g', 4);
     }
 
     outputString += ")";
@@ -1803,12 +2037,13 @@ void Crit1DProject::updateOutput(Crit3DDate myDate, bool isFirst)
 
 bool Crit1DProject::saveOutput(QString &errorStr)
 {
-    QSqlQuery myQuery = dbOutput.exec(outputString);
+    QString queryError;
+    bool isOk = executeOutputQuery(outputString, queryError);
     outputString.clear();
 
-    if (myQuery.lastError().type() != QSqlError::NoError)
+    if (! isOk)
     {
-        errorStr = "Error in saveOutput:\n" + myQuery.lastError().text();
+        errorStr = "Error in saveOutput:\n" + queryError;
         return false;
     }
 
@@ -1816,6 +2051,86 @@ bool Crit1DProject::saveOutput(QString &errorStr)
 }
 
 
+// the output of a worker (unitOutput != nullptr) is kept and written later by computeAllUnits
+void Crit1DProject::logInfo(const QString &infoStr)
+{
+    if (unitOutput == nullptr)
+    {
+        logger.writeInfo(infoStr);
+    }
+    else
+    {
+        unitOutput->logLines.push_back(infoStr);
+        unitOutput->isErrorLine.push_back(false);
+    }
+}
+
+
+void Crit1DProject::logError(const QString &errorStr)
+{
+    if (unitOutput == nullptr)
+    {
+        logger.writeError(errorStr);
+    }
+    else
+    {
+        unitOutput->logLines.push_back(errorStr);
+        unitOutput->isErrorLine.push_back(true);
+    }
+}
+
+
+bool Crit1DProject::executeOutputQuery(const QString &queryString, QString &errorStr)
+{
+    if (unitOutput != nullptr)
+    {
+        unitOutput->outputQueries.push_back(queryString);
+        return true;
+    }
+
+    QSqlQuery myQuery = dbOutput.exec(queryString);
+    if (myQuery.lastError().isValid())
+    {
+        errorStr = myQuery.lastError().text();
+        return false;
+    }
+
+    return true;
+}
+
+
+bool Crit1DProject::executeStateQuery(const QString &queryString, QString &errorStr)
+{
+    if (unitOutput != nullptr)
+    {
+        unitOutput->stateQueries.push_back(queryString);
+        return true;
+    }
+
+    QSqlQuery myQuery = dbState.exec(queryString);
+    if (myQuery.lastError().isValid())
+    {
+        errorStr = myQuery.lastError().text();
+        return false;
+    }
+
+    return true;
+}
+
+
+void Crit1DProject::writeCsvRow(const std::string &csvRow)
+{
+    if (unitOutput != nullptr)
+    {
+        unitOutput->csvRows += csvRow;
+        return;
+    }
+
+    outputCsvFile << csvRow;
+    outputCsvFile.flush();
+}
+
+
 void Crit1DProject::closeAllDatabase()
 {
     dbCrop.close();
@@ -1830,8 +2145,8 @@ int Crit1DProject::openAllDatabase()
 {
     closeAllDatabase();
 
-    logger.writeInfo ("Crop DB: " + dbCropName);
-    if (! QFile(dbCropName).exists())
+    logger.writeInfo ("Crop DB: " + settings.dbCropName);
+    if (! QFile(settings.dbCropName).exists())
     {
         projectError = "DB Crop file doesn't exist";
         closeAllDatabase();
@@ -1839,7 +2154,7 @@ int Crit1DProject::openAllDatabase()
     }
 
     dbCrop = QSqlDatabase::addDatabase("QSQLITE");
-    dbCrop.setDatabaseName(dbCropName);
+    dbCrop.setDatabaseName(settings.dbCropName);
     if (! dbCrop.open())
     {
         projectError = "Open Crop DB failed: " + dbCrop.lastError().text();
@@ -1847,8 +2162,8 @@ int Crit1DProject::openAllDatabase()
         return ERROR_DBPARAMETERS;
     }
 
-    logger.writeInfo ("Soil DB: " + dbSoilName);
-    if (! QFile(dbSoilName).exists())
+    logger.writeInfo ("Soil DB: " + settings.dbSoilName);
+    if (! QFile(settings.dbSoilName).exists())
     {
         projectError = "Soil DB file doesn't exist";
         closeAllDatabase();
@@ -1856,7 +2171,7 @@ int Crit1DProject::openAllDatabase()
     }
 
     dbSoil = QSqlDatabase::addDatabase("QSQLITE", "soil");
-    dbSoil.setDatabaseName(dbSoilName);
+    dbSoil.setDatabaseName(settings.dbSoilName);
     if (! dbSoil.open())
     {
         projectError = "Open soil DB failed: " + dbSoil.lastError().text();
@@ -1864,18 +2179,18 @@ int Crit1DProject::openAllDatabase()
         return ERROR_DBSOIL;
     }
 
-    logger.writeInfo ("Meteo DB: " + dbMeteoName);
-    if (! QFile(dbMeteoName).exists())
+    logger.writeInfo ("Meteo DB: " + settings.dbMeteoName);
+    if (! QFile(settings.dbMeteoName).exists())
     {
         projectError = "Meteo points DB file doesn't exist";
         closeAllDatabase();
         return ERROR_DBMETEO_OBSERVED;
     }
 
-    if (isXmlMeteoGrid)
+    if (settings.isXmlMeteoGrid)
     {
         observedMeteoGrid = new Crit3DMeteoGridDbHandler();
-        if (! observedMeteoGrid->parseXMLGrid(dbMeteoName, &projectError))
+        if (! observedMeteoGrid->parseXMLGrid(settings.dbMeteoName, &projectError))
         {
             return ERROR_XMLGRIDMETEO_OBSERVED;
         }
@@ -1891,7 +2206,7 @@ int Crit1DProject::openAllDatabase()
     else
     {
         dbMeteo = QSqlDatabase::addDatabase("QSQLITE", "meteo");
-        dbMeteo.setDatabaseName(dbMeteoName);
+        dbMeteo.setDatabaseName(settings.dbMeteoName);
         if (! dbMeteo.open())
         {
             projectError = "Open meteo DB failed: " + dbMeteo.lastError().text();
@@ -1901,20 +2216,20 @@ int Crit1DProject::openAllDatabase()
     }
 
     // meteo forecast
-    if (isShortTermForecast || isEnsembleForecast)
+    if (settings.isShortTermForecast || settings.isEnsembleForecast)
     {
-        logger.writeInfo ("Forecast DB: " + dbForecastName);
-        if (! QFile(dbForecastName).exists())
+        logger.writeInfo ("Forecast DB: " + settings.dbForecastName);
+        if (! QFile(settings.dbForecastName).exists())
         {
             projectError = "DBforecast file doesn't exist";
             closeAllDatabase();
             return ERROR_DBMETEO_FORECAST;
         }
 
-        if (isXmlMeteoGrid)
+        if (settings.isXmlMeteoGrid)
         {
             forecastMeteoGrid = new Crit3DMeteoGridDbHandler();
-            if (! forecastMeteoGrid->parseXMLGrid(dbForecastName, &projectError))
+            if (! forecastMeteoGrid->parseXMLGrid(settings.dbForecastName, &projectError))
             {
                 return ERROR_XMLGRIDMETEO_FORECAST;
             }
@@ -1930,7 +2245,7 @@ int Crit1DProject::openAllDatabase()
         else
         {
             dbForecast = QSqlDatabase::addDatabase("QSQLITE", "forecast");
-            dbForecast.setDatabaseName(dbForecastName);
+            dbForecast.setDatabaseName(settings.dbForecastName);
             if (! dbForecast.open())
             {
                 projectError = "Open forecast DB failed: " + dbForecast.lastError().text();
@@ -1941,19 +2256,19 @@ int Crit1DProject::openAllDatabase()
     }
 
     // output DB (not used in seasonal/monthly forecast)
-    if ( !isMonthlyStatistics && !isSeasonalForecast && !isEnsembleForecast)
+    if ( !settings.isMonthlyStatistics && !settings.isSeasonalForecast && !settings.isEnsembleForecast)
     {
-        if (dbOutputName == "")
+        if (settings.dbOutputName == "")
         {
             logger.writeError("Missing output DB");
                 return ERROR_DBOUTPUT;
         }
-        QFile::remove(dbOutputName);
-        logger.writeInfo ("Output DB: " + dbOutputName);
+        QFile::remove(settings.dbOutputName);
+        logger.writeInfo ("Output DB: " + settings.dbOutputName);
         dbOutput = QSqlDatabase::addDatabase("QSQLITE", "output");
-        dbOutput.setDatabaseName(dbOutputName);
+        dbOutput.setDatabaseName(settings.dbOutputName);
 
-        QString outputDbPath = getFilePath(dbOutputName);
+        QString outputDbPath = getFilePath(settings.dbOutputName);
         if (!QDir(outputDbPath).exists())
              QDir().mkdir(outputDbPath);
 
@@ -1965,13 +2280,132 @@ int Crit1DProject::openAllDatabase()
         }
     }
 
-    logger.writeInfo ("Computational units DB: " + dbComputationUnitsName);
+    logger.writeInfo ("Computational units DB: " + settings.dbComputationUnitsName);
 
     return CRIT1D_OK;
 }
 
 
 
+/*!
+ * \brief initializeWorker
+ * copies the settings of mainProject and opens private connections to the input databases
+ * (a Qt sql connection can be used only in the thread that created it)
+ * must be called in the thread of the worker
+ */
+bool Crit1DProject::initializeWorker(const Crit1DProject &mainProject, int workerIndex, QString &errorStr)
+{
+    settings = mainProject.settings;
+    connectionSuffix = "_worker" + QString::number(workerIndex);
+
+    // computed by the main project before the computation of the units
+    dbStateName = mainProject.dbStateName;
+    nrYears = mainProject.nrYears;
+
+    texturalClassList = mainProject.texturalClassList;
+    geotechnicsClassList = mainProject.geotechnicsClassList;
+    compUnitList = mainProject.compUnitList;
+
+    if (! openWorkerDatabase(errorStr))
+        return false;
+
+    isProjectLoaded = true;
+    return true;
+}
+
+
+bool Crit1DProject::openWorkerDatabase(QString &errorStr)
+{
+    dbCrop = QSqlDatabase::addDatabase("QSQLITE", "crop" + connectionSuffix);
+    dbCrop.setDatabaseName(settings.dbCropName);
+    if (! dbCrop.open())
+    {
+        errorStr = "Open Crop DB failed: " + dbCrop.lastError().text();
+        return false;
+    }
+
+    dbSoil = QSqlDatabase::addDatabase("QSQLITE", "soil" + connectionSuffix);
+    dbSoil.setDatabaseName(settings.dbSoilName);
+    if (! dbSoil.open())
+    {
+        errorStr = "Open soil DB failed: " + dbSoil.lastError().text();
+        return false;
+    }
+
+    if (settings.isXmlMeteoGrid)
+    {
+        observedMeteoGrid = new Crit3DMeteoGridDbHandler();
+        if (! observedMeteoGrid->parseXMLGrid(settings.dbMeteoName, &errorStr)
+            || ! observedMeteoGrid->openDatabase(&errorStr, "observed" + connectionSuffix)
+            || ! observedMeteoGrid->loadCellProperties(&errorStr))
+        {
+            return false;
+        }
+    }
+    else
+    {
+        dbMeteo = QSqlDatabase::addDatabase("QSQLITE", "meteo" + connectionSuffix);
+        dbMeteo.setDatabaseName(settings.dbMeteoName);
+        if (! dbMeteo.open())
+        {
+            errorStr = "Open meteo DB failed: " + dbMeteo.lastError().text();
+            return false;
+        }
+    }
+
+    if (settings.isShortTermForecast || settings.isEnsembleForecast)
+    {
+        if (settings.isXmlMeteoGrid)
+        {
+            forecastMeteoGrid = new Crit3DMeteoGridDbHandler();
+            if (! forecastMeteoGrid->parseXMLGrid(settings.dbForecastName, &errorStr)
+                || ! forecastMeteoGrid->openDatabase(&errorStr, "forecast" + connectionSuffix)
+                || ! forecastMeteoGrid->loadCellProperties(&errorStr))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            dbForecast = QSqlDatabase::addDatabase("QSQLITE", "forecast" + connectionSuffix);
+            dbForecast.setDatabaseName(settings.dbForecastName);
+            if (! dbForecast.open())
+            {
+                errorStr = "Open forecast DB failed: " + dbForecast.lastError().text();
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+
+void Crit1DProject::closeWorkerDatabase()
+{
+    closeAllDatabase();
+
+    dbCrop = QSqlDatabase();
+    dbSoil = QSqlDatabase();
+    dbMeteo = QSqlDatabase();
+    dbForecast = QSqlDatabase();
+
+    QStringList connectionList = {"crop", "soil", "meteo", "forecast", "stateToRestore"};
+    for (int i = 0; i < connectionList.size(); i++)
+    {
+        QString connectionName = connectionList[i] + connectionSuffix;
+        if (QSqlDatabase::contains(connectionName))
+            QSqlDatabase::removeDatabase(connectionName);
+    }
+
+    delete observedMeteoGrid;
+    observedMeteoGrid = nullptr;
+    delete forecastMeteoGrid;
+    forecastMeteoGrid = nullptr;
+}
+
+
+
 QString getOutputStringNullZero(double value)
 {
     if (int(value) != int(NODATA))
@@ -15,16 +15,35 @@
     #endif
 
     #include <fstream>
+    #include <functional>
 
-    class Crit1DProject
+    enum crit1DUnitStatus {unitComputed, unitSkipped, unitErrorCrop, unitErrorSoil, unitErrorModel};
+
+    /*!
+     * \brief output of a computational unit computed by a worker thread:
+     * it is written by computeAllUnits in the order of the units list
+     */
+    struct Crit1DUnitOutput
     {
+        int status;
+        QString idCrop;
+        QString idSoil;
+        std::vector<QString> outputQueries;
+        std::vector<QString> stateQueries;
+        std::string csvRows;
+        std::vector<QString> logLines;
+        std::vector<bool> isErrorLine;
+    };
 
+    /*!
+     * \brief settings of a CRITERIA1D project, read from the project settings file:
+     * the worker threads copy them from the main project
+     */
+    class Crit1DProjectSettings
+    {
     public:
-        bool isProjectLoaded;
-        QString projectError;
-        Logger logger;
-
         QString path;
+        QString projectName;
 
         // database
         QString dbCropName;
@@ -33,17 +52,67 @@
         QString dbMeteoName;
         QString dbForecastName;
         QString dbComputationUnitsName;
-
-        QSqlDatabase dbCrop;
-        QSqlDatabase dbSoil;
-        QSqlDatabase dbMeteo;
-        Crit3DMeteoGridDbHandler* observedMeteoGrid;
+        bool isXmlMeteoGrid;
 
         // dates
         QDate firstSimulationDate;
         QDate lastSimulationDate;
 
-        bool isXmlMeteoGrid;
+        // save/restart
+        bool isSaveState;
+        bool isRestart;
+
+        bool addDateTimeLogFile;
+
+        // parallel computation of units (0 = all cores)
+        int nrThreads;
+
+        // error bound of the lookup tables of the soil hydraulic functions (0 = formulas)
+        double hydraulicTableError;
+
+        // forecast/climate type
+        bool isYearlyStatistics;
+        bool isMonthlyStatistics;
+        bool isSeasonalForecast;
+        bool isEnsembleForecast;
+        bool isShortTermForecast;
+
+        int firstMonth;
+        int daysOfForecast;
+
+        QString outputCsvFileName;
+
+        // specific output
+        bool isClimateOutput;
+        std::vector<int> waterContentDepth;
+        std::vector<int> degreeOfSaturationDepth;
+        std::vector<int> waterPotentialDepth;
+        std::vector<int> waterDeficitDepth;
+        std::vector<int> awcDepth;
+        std::vector<int> availableWaterDepth;
+        std::vector<int> fractionAvailableWaterDepth;
+        std::vector<int> factorOfSafetyDepth;
+
+        Crit1DProjectSettings();
+
+        void initialize();
+    };
+
+
+    class Crit1DProject
+    {
+
+    public:
+        bool isProjectLoaded;
+        QString projectError;
+        Logger logger;
+
+        Crit1DProjectSettings settings;
+
+        QSqlDatabase dbCrop;
+        QSqlDatabase dbSoil;
+        QSqlDatabase dbMeteo;
+        Crit3DMeteoGridDbHandler* observedMeteoGrid;
 
         Crit1DCase myCase;
         Crit1DCarbonNitrogenProfile myCarbonNitrogenProfile;
@@ -62,48 +131,25 @@
         bool computeUnit(const Crit1DCompUnit& myUnit);
 
     private:
-        QString projectName;
         QString configFileName;
 
-        // save/restart
-        bool isSaveState;
-        bool isRestart;
-
-        // forecast/climate type
-        bool isYearlyStatistics;
-        bool isMonthlyStatistics;
-        bool isSeasonalForecast;
-        bool isEnsembleForecast;
-        bool isShortTermForecast;
+        // parallel computation of units
+        QString connectionSuffix;
+        Crit1DUnitOutput* unitOutput;
 
-        int firstMonth;
-        int daysOfForecast;
         int nrYears;
         std::vector<float> irriSeries;
         std::vector<float> precSeries;
 
         QString outputString;
         QString logFileName;
-        QString outputCsvFileName;
         std::ofstream outputCsvFile;
 
-        bool addDateTimeLogFile;
-
-        // specific output
-        bool isClimateOutput;
-        std::vector<int> waterContentDepth;
-        std::vector<int> degreeOfSaturationDepth;
-        std::vector<int> waterPotentialDepth;
-        std::vector<int> waterDeficitDepth;
-        std::vector<int> awcDepth;
-        std::vector<int> availableWaterDepth;
-        std::vector<int> fractionAvailableWaterDepth;
-        std::vector<int> factorOfSafetyDepth;
-
         // DATABASE
         QSqlDatabase dbForecast;
         QSqlDatabase dbOutput;
         QSqlDatabase dbState;
+        QString dbStateName;
 
         Crit3DMeteoGridDbHandler* forecastMeteoGrid;
 
@@ -113,6 +159,19 @@
         int openAllDatabase();
         void checkSimulationDates();
 
+        bool initializeWorker(const Crit1DProject &mainProject, int workerIndex, QString &errorStr);
+        bool openWorkerDatabase(QString &errorStr);
+        void closeWorkerDatabase();
+        int computeUnitInList(unsigned int index);
+        void computeAllUnitsParallel(int nrWorkers, const std::function<void(unsigned int, int)> &countUnit);
+        bool writeUnitOutput(Crit1DUnitOutput &output, QString &errorStr);
+
+        void logInfo(const QString &infoStr);
+        void logError(const QString &errorStr);
+        bool executeOutputQuery(const QString &queryString, QString &errorStr);
+        bool executeStateQuery(const QString &queryString, QString &errorStr);
+        void writeCsvRow(const std::string &csvRow);
+
         bool setSoil(QString soilCode, QString &errorStr);
 
         bool setMeteoSqlite(QString idMeteo, QString idForecast);
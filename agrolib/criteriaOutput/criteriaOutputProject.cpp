@@ -813,6 +813,8 @@ int CriteriaOutputProject::createAggregationFile()
     }
 
     Crit3DShapeHandler shapeVal, shapeRef;
+    shapeVal.setLoadAllShapes(true);
+    shapeRef.setLoadAllShapes(true);
 
     if (!shapeVal.open(outputShapeFileName.toStdString()))
     {
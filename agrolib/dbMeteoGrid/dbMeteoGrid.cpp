@@ -8,7 +8,17 @@
 #include "commonConstants.h"
 
 #include <iostream>
+#include <algorithm>
 #include <QtSql>
+#include <QFileInfo>
+#include <QDir>
+
+
+// time step of the monthly binary storage
+static qint64 getMonthlyStep(const QDate &date)
+{
+    return qint64(date.year()) * 12 + date.month() - 1;
+}
 
 
 Crit3DMeteoGridDbHandler::Crit3DMeteoGridDbHandler()
@@ -19,6 +29,7 @@ Crit3DMeteoGridDbHandler::Crit3DMeteoGridDbHandler()
 Crit3DMeteoGridDbHandler::~Crit3DMeteoGridDbHandler()
 {
     closeDatabase();
+    closeBinaryFiles();
     delete _meteoGrid;
 }
 
@@ -74,6 +85,10 @@ bool Crit3DMeteoGridDbHandler::parseXMLGrid(QString xmlFileName, QString *myErro
     _tableHourly.exists = false;
     _tableMonthly.exists = false;
 
+    closeBinaryFiles();
+    _storage.format = "sql";
+    _storage.path = "";
+
     while(! ancestor.isNull())
     {
         if (ancestor.toElement().tagName().toUpper() == "CONNECTION")
@@ -294,6 +309,31 @@ bool Crit3DMeteoGridDbHandler::parseXMLGrid(QString xmlFileName, QString *myErro
 
         }
 
+        else if (ancestor.toElement().tagName().toUpper() == "STORAGE")
+        {
+            child = ancestor.firstChild();
+            while( !child.isNull())
+            {
+                myTag = child.toElement().tagName().toUpper();
+                if (myTag == "FORMAT")
+                {
+                    QString myFormat = child.toElement().text().simplified().toLower();
+                    if (! myFormat.isEmpty())
+                        _storage.format = myFormat;
+                }
+                if (myTag == "PATH")
+                {
+                    // relative to the xml path
+                    _storage.path = child.toElement().text().simplified();
+                    if (QFileInfo(_storage.path).isRelative())
+                    {
+                        _storage.path = QFileInfo(xmlFileName).absolutePath() + "/" + _storage.path;
+                    }
+                }
+                child = child.nextSibling();
+            }
+        }
+
         else if (ancestor.toElement().tagName().toUpper() == "TABLEDAILY")
         {
             _tableDaily.exists = true;
@@ -535,6 +575,12 @@ bool Crit3DMeteoGridDbHandler::parseXMLGrid(QString xmlFileName, QString *myErro
 
     _meteoGrid->initMeteoPoints(nRow, nCol);
 
+    // index of the DEM cells of each grid cell, saved next to the xml
+    _fileName = xmlFileName;
+    QFileInfo xmlFileInfo(xmlFileName);
+    QString indexFileName = xmlFileInfo.absolutePath() + "/" + xmlFileInfo.completeBaseName() + "_aggregation.idx";
+    _meteoGrid->setAggregationIndexFileName(indexFileName.toStdString());
+
     return true;
 }
 
@@ -706,6 +752,26 @@ bool Crit3DMeteoGridDbHandler::checkXML(QString *myError)
         }
     }
 
+    /* storage */
+    if (_storage.format != "sql" && _storage.format != "binary")
+    {
+        *myError = "Wrong storage format: " + _storage.format;
+        return false;
+    }
+    if (isBinaryStorage())
+    {
+        if (_storage.path.isEmpty())
+        {
+            *myError = "Missing storage path";
+            return false;
+        }
+        if (_gridStructure.isFixedFields() || _gridStructure.isEnsemble())
+        {
+            *myError = "Binary storage is not available for fixed fields or ensemble grids";
+            return false;
+        }
+    }
+
     /* table monthly */
     if (_tableMonthly.exists)
     {
@@ -1423,11 +1489,14 @@ bool Crit3DMeteoGridDbHandler::loadIdMeteoProperties(QString *myError, QString i
 
 bool Crit3DMeteoGridDbHandler::updateMeteoGridDate(QString &myError)
 {
-    QList<QString> tableList = _db.tables(QSql::Tables);
-    if (tableList.size() <= 1)
+    if (! isBinaryStorage())
     {
-        myError = "No data.";
-        return false;
+        QList<QString> tableList = _db.tables(QSql::Tables);
+        if (tableList.size() <= 1)
+        {
+            myError = "No data.";
+            return false;
+        }
     }
 
     int row = 0;
@@ -1456,7 +1525,17 @@ bool Crit3DMeteoGridDbHandler::updateMeteoGridDate(QString &myError)
 
     QSqlQuery qry(_db);
 
-    if (_tableDaily.exists)
+    // daily and monthly data in the binary storage, hourly data in the db
+    if (isBinaryStorage())
+    {
+        if (_tableDaily.exists && ! getBinaryDateRange(daily, _firstDailyDate, _lastDailyDate, myError))
+            return false;
+
+        if (_tableMonthly.exists && ! getBinaryDateRange(monthly, _firstMonthlyDate, _lastMonthlyDate, myError))
+            return false;
+    }
+
+    if (_tableDaily.exists && ! isBinaryStorage())
     {
         QString statement = QString("SELECT MIN(%1) as minDate, MAX(%1) as maxDate FROM `%2`").arg(_tableDaily.fieldTime, tableD);
         if(! qry.exec(statement) )
@@ -1575,7 +1654,7 @@ bool Crit3DMeteoGridDbHandler::updateMeteoGridDate(QString &myError)
         }
     }
 
-    if (_tableMonthly.exists)
+    if (_tableMonthly.exists && ! isBinaryStorage())
     {
         QString table = "MonthlyData";
         QString statement = QString("CREATE TABLE IF NOT EXISTS `%1`"
@@ -1704,6 +1783,78 @@ bool Crit3DMeteoGridDbHandler::updateMeteoGridDate(QString &myError)
 
 
 bool Crit3DMeteoGridDbHandler::loadGridDailyData(QString &myError, const QString &meteoPointId, const QDate &firstDate, const QDate &lastDate)
+{
+    if (isBinaryStorage())
+        return loadGridDailyDataBinary(myError, meteoPointId, firstDate, lastDate);
+    else
+        return loadGridDailyDataSql(myError, meteoPointId, firstDate, lastDate);
+}
+
+
+bool Crit3DMeteoGridDbHandler::loadGridDailyDataBinary(QString &myError, const QString &meteoPointId, const QDate &firstDate, const QDate &lastDate)
+{
+    myError = "";
+
+    unsigned row, col;
+    if ( !_meteoGrid->findMeteoPointFromId(&row, &col, meteoPointId.toStdString()) )
+    {
+        myError = "Missing meteoPoint id: " + meteoPointId;
+        return false;
+    }
+
+    int numberOfDays = firstDate.daysTo(lastDate) + 1;
+    Crit3DMeteoPoint* meteoPoint = _meteoGrid->meteoPointPointer(row, col);
+    meteoPoint->initializeObsDataD(numberOfDays, getCrit3DDate(firstDate));
+
+    if (_firstDailyDate.isValid() && _lastDailyDate.isValid())
+    {
+        if (_firstDailyDate.year() != 1800 && _lastDailyDate.year() != 1800)
+        {
+            if (firstDate > _lastDailyDate || lastDate < _firstDailyDate)
+            {
+                myError = "Missing data in this time interval.";
+                return false;
+            }
+        }
+    }
+
+    if (numberOfDays <= 0)
+        return true;
+
+    int cellIndex = int(row) * _gridStructure.header().nrCols + int(col);
+    std::vector<float> values;
+    values.resize(unsigned(numberOfDays));
+
+    QMap<meteoVariable, int>::const_iterator it;
+    for (it = _gridDailyVar.constBegin(); it != _gridDailyVar.constEnd(); ++it)
+    {
+        Crit3DMeteoGridBinaryFile* binaryFile = getBinaryFile(daily, it.value(), myError);
+        if (binaryFile == nullptr)
+            return false;
+
+        if (binaryFile->isEmpty())
+            continue;
+
+        binaryFile->read(cellIndex, firstDate.toJulianDay(), numberOfDays, values.data());
+
+        for (int i = 0; i < numberOfDays; i++)
+        {
+            if (values[unsigned(i)] != NODATA)
+            {
+                if (! meteoPoint->setMeteoPointValueD(long(i), it.key(), values[unsigned(i)]))
+                {
+                    myError = "Error in setMeteoPointValueD";
+                    return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+
+bool Crit3DMeteoGridDbHandler::loadGridDailyDataSql(QString &myError, const QString &meteoPointId, const QDate &firstDate, const QDate &lastDate)
 {
     myError = "";
     QString tableD = _tableDaily.prefix + meteoPointId + _tableDaily.postFix;
@@ -2127,6 +2278,11 @@ bool Crit3DMeteoGridDbHandler::loadGridMonthlySingleDate(QString &myError, const
         return false;
     }
 
+    if (isBinaryStorage())
+    {
+        return readBinaryMonthlyValues(myError, row, col, QDate(year, month, 1), 1);
+    }
+
     QSqlQuery qry(_db);
     QString statement = QString("SELECT * FROM MonthlyData WHERE `PointCode` = '%1' AND `PragaYear`= %2 AND `PragaMonth`= %3")
                             .arg(meteoPoint).arg(year).arg(month);
@@ -2158,6 +2314,42 @@ bool Crit3DMeteoGridDbHandler::loadGridMonthlySingleDate(QString &myError, const
 
 
 bool Crit3DMeteoGridDbHandler::loadGridMonthlyData(QString &myError, QString meteoPoint, QDate firstDate, QDate lastDate)
+{
+    if (isBinaryStorage())
+        return loadGridMonthlyDataBinary(myError, meteoPoint, firstDate, lastDate);
+    else
+        return loadGridMonthlyDataSql(myError, meteoPoint, firstDate, lastDate);
+}
+
+
+bool Crit3DMeteoGridDbHandler::loadGridMonthlyDataBinary(QString &myError, QString meteoPoint, QDate firstDate, QDate lastDate)
+{
+    myError = "";
+
+    // set day to 1 to better comparison
+    firstDate.setDate(firstDate.year(), firstDate.month(), 1);
+    lastDate.setDate(lastDate.year(), lastDate.month(), 1);
+
+    unsigned row, col;
+    if (!_meteoGrid->findMeteoPointFromId(&row, &col, meteoPoint.toStdString()) )
+    {
+        myError = "Missing MeteoPoint id";
+        return false;
+    }
+
+    int numberOfMonths = (lastDate.year()-firstDate.year())*12 + lastDate.month() - (firstDate.month()-1);
+    _meteoGrid->meteoPointPointer(row,col)->initializeObsDataM(numberOfMonths, firstDate.month(), firstDate.year());
+
+    if (firstDate > _lastMonthlyDate || lastDate < _firstMonthlyDate)
+    {
+        return false;
+    }
+
+    return readBinaryMonthlyValues(myError, row, col, firstDate, numberOfMonths);
+}
+
+
+bool Crit3DMeteoGridDbHandler::loadGridMonthlyDataSql(QString &myError, QString meteoPoint, QDate firstDate, QDate lastDate)
 {
     myError = "";
     QString table = "MonthlyData";
@@ -2259,6 +2451,23 @@ bool Crit3DMeteoGridDbHandler::loadGridAllMonthlyData(QString &myError, QDate fi
         }
     }
 
+    if (isBinaryStorage())
+    {
+        std::string id;
+        for (int row = 0; row < gridStructure().header().nrRows; row++)
+        {
+            for (int col = 0; col < gridStructure().header().nrCols; col++)
+            {
+                if (_meteoGrid->getMeteoPointActiveId(row, col, &id))
+                {
+                    if (! readBinaryMonthlyValues(myError, unsigned(row), unsigned(col), firstDate, numberOfMonths))
+                        return false;
+                }
+            }
+        }
+        return true;
+    }
+
     QSqlQuery qry(_db);
     QDate monthDate;
     unsigned row, col;
@@ -2363,6 +2572,37 @@ std::vector<float> Crit3DMeteoGridDbHandler::loadGridDailyVar(QString *myError,
         return dailyVarList;
     }
 
+    if (isBinaryStorage())
+    {
+        Crit3DMeteoGridBinaryFile* binaryFile = getBinaryFile(daily, varCode, *myError);
+        int nrValues = int(first.daysTo(last)) + 1;
+        if (binaryFile == nullptr || binaryFile->isEmpty() || nrValues <= 0)
+            return dailyVarList;
+
+        int cellIndex = int(row) * _gridStructure.header().nrCols + int(col);
+        dailyVarList.resize(unsigned(nrValues));
+        binaryFile->read(cellIndex, first.toJulianDay(), nrValues, dailyVarList.data());
+
+        // as the db query: from the first to the last existing value
+        int firstIndex = 0;
+        while (firstIndex < nrValues && dailyVarList[unsigned(firstIndex)] == NODATA)
+            firstIndex++;
+        int lastIndex = nrValues - 1;
+        while (lastIndex > firstIndex && dailyVarList[unsigned(lastIndex)] == NODATA)
+            lastIndex--;
+
+        if (firstIndex == nrValues)
+        {
+            dailyVarList.clear();
+            return dailyVarList;
+        }
+
+        *firstDateDB = first.addDays(firstIndex);
+        dailyVarList.erase(dailyVarList.begin() + lastIndex + 1, dailyVarList.end());
+        dailyVarList.erase(dailyVarList.begin(), dailyVarList.begin() + firstIndex);
+        return dailyVarList;
+    }
+
     QString statement = QString("SELECT `%3`,`Value` FROM `%1` WHERE VariableCode = '%2' AND `%3` >= '%4' AND `%3`<= '%5' ORDER BY `%3`").arg(tableD).arg(varCode).arg(_tableDaily.fieldTime).arg(first.toString("yyyy-MM-dd")).arg(last.toString("yyyy-MM-dd"));
 
     if(! qry.exec(statement) )
@@ -2789,6 +3029,53 @@ std::vector<float> Crit3DMeteoGridDbHandler::loadGridHourlyVarFixedFields(QStrin
 
 bool Crit3DMeteoGridDbHandler::saveCellGridDailyData(QString *myError, QString meteoPointID, int row, int col, QDate firstDate, QDate lastDate,
                                                      QList<meteoVariable> meteoVariableList, Crit3DMeteoSettings* meteoSettings)
+{
+    if (isBinaryStorage())
+        return saveCellGridDailyDataBinary(myError, row, col, firstDate, lastDate, meteoVariableList, meteoSettings);
+    else
+        return saveCellGridDailyDataSql(myError, meteoPointID, row, col, firstDate, lastDate, meteoVariableList, meteoSettings);
+}
+
+
+bool Crit3DMeteoGridDbHandler::saveCellGridDailyDataBinary(QString *myError, int row, int col, QDate firstDate, QDate lastDate,
+                                                           QList<meteoVariable> meteoVariableList, Crit3DMeteoSettings* meteoSettings)
+{
+    int nrDays = int(firstDate.daysTo(lastDate)) + 1;
+    if (nrDays <= 0)
+        return true;
+
+    Crit3DMeteoPoint* meteoPoint = _meteoGrid->meteoPointPointer(unsigned(row), unsigned(col));
+    int cellIndex = row * _gridStructure.header().nrCols + col;
+    std::vector<float> values;
+    values.resize(unsigned(nrDays));
+
+    foreach (meteoVariable meteoVar, meteoVariableList)
+        if (getVarFrequency(meteoVar) == daily)
+        {
+            int varCode = getDailyVarCode(meteoVar);
+            if (varCode == NODATA)
+                continue;
+
+            Crit3DMeteoGridBinaryFile* binaryFile = getBinaryFile(daily, varCode, *myError);
+            if (binaryFile == nullptr)
+                return false;
+
+            Crit3DDate myDate = getCrit3DDate(firstDate);
+            for (int i = 0; i < nrDays; i++, ++myDate)
+            {
+                values[unsigned(i)] = meteoPoint->getMeteoPointValueD(myDate, meteoVar, meteoSettings);
+            }
+
+            if (! binaryFile->write(cellIndex, firstDate.toJulianDay(), nrDays, values.data(), *myError))
+                return false;
+        }
+
+    return true;
+}
+
+
+bool Crit3DMeteoGridDbHandler::saveCellGridDailyDataSql(QString *myError, QString meteoPointID, int row, int col, QDate firstDate, QDate lastDate,
+                                                        QList<meteoVariable> meteoVariableList, Crit3DMeteoSettings* meteoSettings)
 {
     QSqlQuery qry(_db);
     QString tableD = _tableDaily.prefix + meteoPointID + _tableDaily.postFix;
@@ -3291,6 +3578,56 @@ bool Crit3DMeteoGridDbHandler::saveCellCurrentGridDailyFF(QString& errorStr, QSt
 
 bool Crit3DMeteoGridDbHandler::saveCellGridMonthlyData(QString *myError, QString meteoPointID, int row, int col, QDate firstDate, QDate lastDate,
                                                      QList<meteoVariable> meteoVariableList)
+{
+    if (isBinaryStorage())
+        return saveCellGridMonthlyDataBinary(myError, row, col, firstDate, lastDate, meteoVariableList);
+    else
+        return saveCellGridMonthlyDataSql(myError, meteoPointID, row, col, firstDate, lastDate, meteoVariableList);
+}
+
+
+bool Crit3DMeteoGridDbHandler::saveCellGridMonthlyDataBinary(QString *myError, int row, int col, QDate firstDate, QDate lastDate,
+                                                             QList<meteoVariable> meteoVariableList)
+{
+    // set day=1 to better comparison
+    firstDate.setDate(firstDate.year(), firstDate.month(), 1);
+    lastDate.setDate(lastDate.year(), lastDate.month(), 1);
+
+    int nrMonths = (lastDate.year()-firstDate.year())*12 + lastDate.month() - (firstDate.month()-1);
+    if (nrMonths <= 0)
+        return true;
+
+    Crit3DMeteoPoint* meteoPoint = _meteoGrid->meteoPointPointer(unsigned(row), unsigned(col));
+    int cellIndex = row * _gridStructure.header().nrCols + col;
+    std::vector<float> values;
+    values.resize(unsigned(nrMonths));
+
+    foreach (meteoVariable meteoVar, meteoVariableList)
+        if (getVarFrequency(meteoVar) == monthly)
+        {
+            int varCode = getMonthlyVarCode(meteoVar);
+            if (varCode == NODATA)
+                continue;
+
+            Crit3DMeteoGridBinaryFile* binaryFile = getBinaryFile(monthly, varCode, *myError);
+            if (binaryFile == nullptr)
+                return false;
+
+            for (int i = 0; i < nrMonths; i++)
+            {
+                values[unsigned(i)] = meteoPoint->getMeteoPointValueM(getCrit3DDate(firstDate.addMonths(i)), meteoVar);
+            }
+
+            if (! binaryFile->write(cellIndex, getMonthlyStep(firstDate), nrMonths, values.data(), *myError))
+                return false;
+        }
+
+    return true;
+}
+
+
+bool Crit3DMeteoGridDbHandler::saveCellGridMonthlyDataSql(QString *myError, QString meteoPointID, int row, int col, QDate firstDate, QDate lastDate,
+                                                          QList<meteoVariable> meteoVariableList)
 {
     QSqlQuery qry(_db);
     QString table = "MonthlyData";
@@ -3659,6 +3996,344 @@ bool Crit3DMeteoGridDbHandler::saveCellCurrentGridHourlyFF(QString& errorStr, QS
 }
 
 
+/*!
+ * \brief getBinaryFile
+ * binary file of a daily or monthly variable (daily_<varCode>.bin, monthly_<varCode>.bin),
+ * opened at the first request and kept mapped until closeBinaryFiles
+ */
+Crit3DMeteoGridBinaryFile* Crit3DMeteoGridDbHandler::getBinaryFile(frequencyType frequency, int varCode, QString &myError)
+{
+    QMap<int, Crit3DMeteoGridBinaryFile*> &binaryFiles = (frequency == daily) ? _binaryDailyFiles : _binaryMonthlyFiles;
+    if (binaryFiles.contains(varCode))
+        return binaryFiles[varCode];
+
+    if (! QDir().mkpath(_storage.path))
+    {
+        myError = "Error in creating the storage path: " + _storage.path;
+        return nullptr;
+    }
+
+    QString fileName;
+    int blockLength;
+    if (frequency == daily)
+    {
+        fileName = _storage.path + "/daily_" + QString::number(varCode) + ".bin";
+        blockLength = METEOGRID_BINARY_DAILY_BLOCK;
+    }
+    else
+    {
+        fileName = _storage.path + "/monthly_" + QString::number(varCode) + ".bin";
+        blockLength = METEOGRID_BINARY_MONTHLY_BLOCK;
+    }
+
+    int nrCells = _gridStructure.header().nrRows * _gridStructure.header().nrCols;
+
+    Crit3DMeteoGridBinaryFile* binaryFile = new Crit3DMeteoGridBinaryFile();
+    if (! binaryFile->open(fileName, nrCells, blockLength, myError))
+    {
+        delete binaryFile;
+        return nullptr;
+    }
+
+    binaryFiles.insert(varCode, binaryFile);
+    return binaryFile;
+}
+
+
+void Crit3DMeteoGridDbHandler::closeBinaryFiles()
+{
+    qDeleteAll(_binaryDailyFiles);
+    _binaryDailyFiles.clear();
+    qDeleteAll(_binaryMonthlyFiles);
+    _binaryMonthlyFiles.clear();
+}
+
+
+/*!
+ * \brief getBinaryDateRange
+ * first and last date of the daily (or monthly) binary files, unchanged if there are no data
+ */
+bool Crit3DMeteoGridDbHandler::getBinaryDateRange(frequencyType frequency, QDate &firstDate, QDate &lastDate, QString &myError)
+{
+    const QMap<meteoVariable, int> &varCodes = (frequency == daily) ? _gridDailyVar : _gridMonthlyVar;
+
+    bool isFound = false;
+    qint64 minStep = 0;
+    qint64 maxStep = 0;
+
+    QMap<meteoVariable, int>::const_iterator it;
+    for (it = varCodes.constBegin(); it != varCodes.constEnd(); ++it)
+    {
+        Crit3DMeteoGridBinaryFile* binaryFile = getBinaryFile(frequency, it.value(), myError);
+        if (binaryFile == nullptr)
+            return false;
+
+        if (binaryFile->isEmpty())
+            continue;
+
+        if (! isFound)
+        {
+            minStep = binaryFile->minStep();
+            maxStep = binaryFile->maxStep();
+            isFound = true;
+        }
+        else
+        {
+            minStep = std::min(minStep, binaryFile->minStep());
+            maxStep = std::max(maxStep, binaryFile->maxStep());
+        }
+    }
+
+    if (! isFound)
+        return true;
+
+    if (frequency == daily)
+    {
+        firstDate = QDate::fromJulianDay(minStep);
+        lastDate = QDate::fromJulianDay(maxStep);
+    }
+    else
+    {
+        firstDate.setDate(int(minStep / 12), int(minStep % 12) + 1, 1);
+        int lastYear = int(maxStep / 12);
+        int lastMonth = int(maxStep % 12) + 1;
+        lastDate.setDate(lastYear, lastMonth, getDaysInMonth(lastMonth, lastYear));
+    }
+
+    return true;
+}
+
+
+/*!
+ * \brief getSqlDateRange
+ * first and last date of the daily and monthly data in the db tables, also when the grid
+ * has a binary storage (its date range is read from the binary files).
+ * The daily range is read from the table of the first active cell that has one
+ * \return false if the tables contain no data
+ */
+bool Crit3DMeteoGridDbHandler::getSqlDateRange(QDate &firstDate, QDate &lastDate, QString &myError)
+{
+    firstDate = QDate();
+    lastDate = QDate();
+
+    QSqlQuery qry(_db);
+    QDate minDate, maxDate;
+
+    if (_tableDaily.exists)
+    {
+        std::string id;
+        bool isTableFound = false;
+        for (int row = 0; row < _gridStructure.header().nrRows && ! isTableFound; row++)
+        {
+            for (int col = 0; col < _gridStructure.header().nrCols && ! isTableFound; col++)
+            {
+                if (! _meteoGrid->getMeteoPointActiveId(row, col, &id))
+                    continue;
+
+                QString table = _tableDaily.prefix + QString::fromStdString(id) + _tableDaily.postFix;
+                QString statement = QString("SELECT MIN(%1) as minDate, MAX(%1) as maxDate FROM `%2`").arg(_tableDaily.fieldTime, table);
+                if (! qry.exec(statement))
+                    continue;
+
+                isTableFound = true;
+                if (qry.next() && getValue(qry.value("minDate"), &minDate) && getValue(qry.value("maxDate"), &maxDate))
+                {
+                    firstDate = minDate;
+                    lastDate = maxDate;
+                }
+            }
+        }
+    }
+
+    if (_tableMonthly.exists)
+    {
+        QString statement = QString("SELECT MIN(PragaYear*12 + PragaMonth - 1) as minStep, "
+                                    "MAX(PragaYear*12 + PragaMonth - 1) as maxStep FROM `MonthlyData`");
+        int minStep, maxStep;
+        if (qry.exec(statement) && qry.next()
+            && getValue(qry.value("minStep"), &minStep) && getValue(qry.value("maxStep"), &maxStep))
+        {
+            minDate.setDate(minStep / 12, minStep % 12 + 1, 1);
+            int lastYear = maxStep / 12;
+            int lastMonth = maxStep % 12 + 1;
+            maxDate.setDate(lastYear, lastMonth, getDaysInMonth(lastMonth, lastYear));
+
+            if (! firstDate.isValid() || minDate < firstDate)
+                firstDate = minDate;
+            if (! lastDate.isValid() || maxDate > lastDate)
+                lastDate = maxDate;
+        }
+    }
+
+    if (! firstDate.isValid() || ! lastDate.isValid())
+    {
+        myError = "No data in the db tables.";
+        return false;
+    }
+
+    return true;
+}
+
+
+bool Crit3DMeteoGridDbHandler::readBinaryMonthlyValues(QString &myError, unsigned row, unsigned col, const QDate &firstDate, int nrMonths)
+{
+    if (nrMonths <= 0)
+        return true;
+
+    Crit3DMeteoPoint* meteoPoint = _meteoGrid->meteoPointPointer(row, col);
+    int cellIndex = int(row) * _gridStructure.header().nrCols + int(col);
+    std::vector<float> values;
+    values.resize(unsigned(nrMonths));
+
+    QMap<meteoVariable, int>::const_iterator it;
+    for (it = _gridMonthlyVar.constBegin(); it != _gridMonthlyVar.constEnd(); ++it)
+    {
+        Crit3DMeteoGridBinaryFile* binaryFile = getBinaryFile(monthly, it.value(), myError);
+        if (binaryFile == nullptr)
+            return false;
+
+        if (binaryFile->isEmpty())
+            continue;
+
+        binaryFile->read(cellIndex, getMonthlyStep(firstDate), nrMonths, values.data());
+
+        for (int i = 0; i < nrMonths; i++)
+        {
+            if (values[unsigned(i)] != NODATA)
+            {
+                if (! meteoPoint->setMeteoPointValueM(getCrit3DDate(firstDate.addMonths(i)), it.key(), values[unsigned(i)]))
+                {
+                    myError = "Error in setMeteoPointValueM()";
+                    return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+
+/*!
+ * \brief importSqlDataToBinary
+ * copies the daily and monthly data of the active cells from the db tables to the binary storage
+ */
+bool Crit3DMeteoGridDbHandler::importSqlDataToBinary(QString &myError, QDate firstDate, QDate lastDate, Crit3DMeteoSettings* meteoSettings)
+{
+    if (! isBinaryStorage())
+    {
+        myError = "Binary storage is not defined in the grid xml.";
+        return false;
+    }
+
+    // the db loaders check the period with the data range: use the requested one
+    _firstDailyDate = firstDate;
+    _lastDailyDate = lastDate;
+    _firstMonthlyDate = firstDate;
+    _lastMonthlyDate = lastDate;
+
+    QList<meteoVariable> dailyVarList = _gridDailyVar.keys();
+    QList<meteoVariable> monthlyVarList = _gridMonthlyVar.keys();
+    QString errorStr;
+    std::string id;
+    int nrCells = 0;
+
+    for (int row = 0; row < gridStructure().header().nrRows; row++)
+    {
+        for (int col = 0; col < gridStructure().header().nrCols; col++)
+        {
+            if (! _meteoGrid->getMeteoPointActiveId(row, col, &id))
+                continue;
+
+            QString meteoPointId = QString::fromStdString(id);
+            bool isLoaded = false;
+
+            if (_tableDaily.exists && loadGridDailyDataSql(errorStr, meteoPointId, firstDate, lastDate))
+            {
+                if (! saveCellGridDailyDataBinary(&myError, row, col, firstDate, lastDate, dailyVarList, meteoSettings))
+                    return false;
+                isLoaded = true;
+            }
+
+            if (_tableMonthly.exists && loadGridMonthlyDataSql(errorStr, meteoPointId, firstDate, lastDate))
+            {
+                if (! saveCellGridMonthlyDataBinary(&myError, row, col, firstDate, lastDate, monthlyVarList))
+                    return false;
+                isLoaded = true;
+            }
+
+            if (isLoaded)
+                nrCells++;
+        }
+    }
+
+    if (nrCells == 0)
+    {
+        myError = "No data to import. " + errorStr;
+        return false;
+    }
+
+    return updateMeteoGridDate(myError);
+}
+
+
+/*!
+ * \brief exportBinaryDataToSql
+ * copies the daily and monthly data of the active cells from the binary storage to the db tables
+ */
+bool Crit3DMeteoGridDbHandler::exportBinaryDataToSql(QString &myError, QDate firstDate, QDate lastDate, Crit3DMeteoSettings* meteoSettings)
+{
+    if (! isBinaryStorage())
+    {
+        myError = "Binary storage is not defined in the grid xml.";
+        return false;
+    }
+
+    QList<meteoVariable> dailyVarList = _gridDailyVar.keys();
+    QList<meteoVariable> monthlyVarList = _gridMonthlyVar.keys();
+    QString errorStr;
+    std::string id;
+    int nrCells = 0;
+
+    for (int row = 0; row < gridStructure().header().nrRows; row++)
+    {
+        for (int col = 0; col < gridStructure().header().nrCols; col++)
+        {
+            if (! _meteoGrid->getMeteoPointActiveId(row, col, &id))
+                continue;
+
+            QString meteoPointId = QString::fromStdString(id);
+            bool isLoaded = false;
+
+            if (_tableDaily.exists && loadGridDailyDataBinary(errorStr, meteoPointId, firstDate, lastDate))
+            {
+                if (! saveCellGridDailyDataSql(&myError, meteoPointId, row, col, firstDate, lastDate, dailyVarList, meteoSettings))
+                    return false;
+                isLoaded = true;
+            }
+
+            if (_tableMonthly.exists && loadGridMonthlyDataBinary(errorStr, meteoPointId, firstDate, lastDate))
+            {
+                if (! saveCellGridMonthlyDataSql(&myError, meteoPointId, row, col, firstDate, lastDate, monthlyVarList))
+                    return false;
+                isLoaded = true;
+            }
+
+            if (isLoaded)
+                nrCells++;
+        }
+    }
+
+    if (nrCells == 0)
+    {
+        myError = "No data to export. " + errorStr;
+        return false;
+    }
+
+    return true;
+}
+
+
 bool Crit3DMeteoGridDbHandler::isDaily()
 {
     if ( ! _firstDailyDate.isValid() || _firstDailyDate.year() == 1800
@@ -4090,3 +4765,13 @@ QString Crit3DMeteoGridDbHandler::tableHourlyModel() const
 {
     return _tableHourlyModel;
 }
+
+TXMLStorage Crit3DMeteoGridDbHandler::storage() const
+{
+    return _storage;
+}
+
+bool Crit3DMeteoGridDbHandler::isBinaryStorage() const
+{
+    return _storage.format == "binary";
+}
@@ -7,6 +7,9 @@
     #ifndef METEOGRID_H
         #include "meteoGrid.h"
     #endif
+    #ifndef METEOGRIDBINARYFILE_H
+        #include "meteoGridBinaryFile.h"
+    #endif
 
     #ifndef QSQLDATABASE_H
         #include <QSqlDatabase>
@@ -50,6 +53,12 @@
          std::vector<TXMLvar> varcode;
     };
 
+    struct TXMLStorage
+    {
+        QString format;         // "sql" (default) or "binary"
+        QString path;
+    };
+
 
     class Crit3DMeteoGridDbHandler
     {
@@ -81,6 +90,8 @@
         TXMLTable tableMonthly() const;
         QString tableDailyModel() const;
         QString tableHourlyModel() const;
+        TXMLStorage storage() const;
+        bool isBinaryStorage() const;
 
         void setMeteoGrid(Crit3DMeteoGrid *meteoGrid);
         void setDb(const QSqlDatabase &db);
@@ -177,6 +188,10 @@
 
         bool saveLogProcedures(QString *myError, QString nameProc, QDate date);
 
+        bool getSqlDateRange(QDate &firstDate, QDate &lastDate, QString &myError);
+        bool importSqlDataToBinary(QString &myError, QDate firstDate, QDate lastDate, Crit3DMeteoSettings *meteoSettings);
+        bool exportBinaryDataToSql(QString &myError, QDate firstDate, QDate lastDate, Crit3DMeteoSettings *meteoSettings);
+
     private:
 
         QString _fileName;
@@ -213,6 +228,29 @@
         QMap<meteoVariable, QString> _mapDailyMySqlVarType;
         QMap<meteoVariable, QString> _mapHourlyMySqlVarType;
 
+        TXMLStorage _storage;
+        QMap<int, Crit3DMeteoGridBinaryFile*> _binaryDailyFiles;
+        QMap<int, Crit3DMeteoGridBinaryFile*> _binaryMonthlyFiles;
+
+        Crit3DMeteoGridBinaryFile* getBinaryFile(frequencyType frequency, int varCode, QString &myError);
+        void closeBinaryFiles();
+        bool getBinaryDateRange(frequencyType frequency, QDate &firstDate, QDate &lastDate, QString &myError);
+        bool readBinaryMonthlyValues(QString &myError, unsigned row, unsigned col, const QDate &firstDate, int nrMonths);
+
+        bool loadGridDailyDataSql(QString &myError, const QString &meteoPointId, const QDate &firstDate, const QDate &lastDate);
+        bool loadGridDailyDataBinary(QString &myError, const QString &meteoPointId, const QDate &firstDate, const QDate &lastDate);
+        bool loadGridMonthlyDataSql(QString &myError, QString meteoPoint, QDate firstDate, QDate lastDate);
+        bool loadGridMonthlyDataBinary(QString &myError, QString meteoPoint, QDate firstDate, QDate lastDate);
+
+        bool saveCellGridDailyDataSql(QString *myError, QString meteoPointID, int row, int col, QDate firstDate, QDate lastDate,
+                                      QList<meteoVariable> meteoVariableList, Crit3DMeteoSettings *meteoSettings);
+        bool saveCellGridDailyDataBinary(QString *myError, int row, int col, QDate firstDate, QDate lastDate,
+                                         QList<meteoVariable> meteoVariableList, Crit3DMeteoSettings *meteoSettings);
+        bool saveCellGridMonthlyDataSql(QString *myError, QString meteoPointID, int row, int col, QDate firstDate, QDate lastDate,
+                                        QList<meteoVariable> meteoVariableList);
+        bool saveCellGridMonthlyDataBinary(QString *myError, int row, int col, QDate firstDate, QDate lastDate,
+                                           QList<meteoVariable> meteoVariableList);
+
     };
 
 
@@ -33,7 +33,9 @@ INCLUDEPATH += ../mathFunctions ../crit3dDate ../gis ../meteo ../utilities
 
 SOURCES += \
         dbMeteoGrid.cpp \
+        meteoGridBinaryFile.cpp
 
 HEADERS += \
-        dbMeteoGrid.h
+        dbMeteoGrid.h \
+        meteoGridBinaryFile.h
 
@@ -0,0 +1,317 @@
+#include "commonConstants.h"
+#include "meteoGridBinaryFile.h"
+
+#include <algorithm>
+#include <cstring>
+
+
+namespace
+{
+    const char BINARY_MAGIC[8] = {'C', '3', 'D', 'G', 'R', 'I', 'D', 'B'};
+
+    // header fields offsets
+    const int OFFSET_VERSION = 8;
+    const int OFFSET_NRCELLS = 12;
+    const int OFFSET_BLOCKLENGTH = 16;
+    const int OFFSET_MAXBLOCKS = 20;
+    const int OFFSET_FIRSTBLOCK = 24;
+    const int OFFSET_MINSTEP = 32;
+    const int OFFSET_MAXSTEP = 40;
+
+    const qint64 INDEX_SIZE = qint64(METEOGRID_BINARY_MAX_BLOCKS) * qint64(sizeof(qint64));
+
+    template <class T> inline T readField(const uchar* p, int offset)
+    {
+        T value;
+        memcpy(&value, p + offset, sizeof(T));
+        return value;
+    }
+
+    template <class T> inline void writeField(uchar* p, int offset, T value)
+    {
+        memcpy(p + offset, &value, sizeof(T));
+    }
+
+    inline qint64 floorDivision(qint64 a, qint64 b)
+    {
+        return (a >= 0) ? a / b : -((-a + b - 1) / b);
+    }
+}
+
+
+Crit3DMeteoGridBinaryFile::Crit3DMeteoGridBinaryFile()
+{
+    _map = nullptr;
+    _mapSize = 0;
+    _nrCells = 0;
+    _blockLength = 0;
+    _firstBlock = 0;
+    _minStep = 1;
+    _maxStep = 0;
+}
+
+
+Crit3DMeteoGridBinaryFile::~Crit3DMeteoGridBinaryFile()
+{
+    close();
+}
+
+
+void Crit3DMeteoGridBinaryFile::close()
+{
+    if (_map != nullptr)
+    {
+        _file.unmap(_map);
+        _map = nullptr;
+    }
+    if (_file.isOpen())
+        _file.close();
+
+    _mapSize = 0;
+    _firstBlock = 0;
+    _minStep = 1;
+    _maxStep = 0;
+    _blockOffsets.clear();
+}
+
+
+/*!
+ * \brief open
+ * maps an existing file; a missing file is created at the first write
+ */
+bool Crit3DMeteoGridBinaryFile::open(const QString &fileName, int nrCells, int blockLength, QString &errorStr)
+{
+    close();
+
+    _file.setFileName(fileName);
+    _nrCells = nrCells;
+    _blockLength = blockLength;
+
+    if (! _file.exists())
+        return true;
+
+    if (! _file.open(QIODevice::ReadWrite) && ! _file.open(QIODevice::ReadOnly))
+    {
+        errorStr = "Error in opening " + fileName + ": " + _file.errorString();
+        return false;
+    }
+
+    qint64 fileSize = _file.size();
+    if (fileSize >= METEOGRID_BINARY_HEADER_SIZE + INDEX_SIZE)
+    {
+        _map = _file.map(0, fileSize);
+    }
+
+    if (_map == nullptr || memcmp(_map, BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0
+        || readField<qint32>(_map, OFFSET_VERSION) != METEOGRID_BINARY_VERSION
+        || readField<qint32>(_map, OFFSET_NRCELLS) != nrCells
+        || readField<qint32>(_map, OFFSET_BLOCKLENGTH) != blockLength
+        || readField<qint32>(_map, OFFSET_MAXBLOCKS) != METEOGRID_BINARY_MAX_BLOCKS)
+    {
+        errorStr = "Wrong meteo grid binary file: " + fileName;
+        close();
+        return false;
+    }
+
+    _mapSize = fileSize;
+    _firstBlock = readField<qint64>(_map, OFFSET_FIRSTBLOCK);
+    _minStep = readField<qint64>(_map, OFFSET_MINSTEP);
+    _maxStep = readField<qint64>(_map, OFFSET_MAXSTEP);
+
+    _blockOffsets.resize(METEOGRID_BINARY_MAX_BLOCKS);
+    memcpy(_blockOffsets.data(), _map + METEOGRID_BINARY_HEADER_SIZE, size_t(INDEX_SIZE));
+
+    return true;
+}
+
+
+bool Crit3DMeteoGridBinaryFile::createFile(qint64 firstBlock, QString &errorStr)
+{
+    if (! _file.open(QIODevice::ReadWrite))
+    {
+        errorStr = "Error in creating " + _file.fileName() + ": " + _file.errorString();
+        return false;
+    }
+
+    if (! remap(METEOGRID_BINARY_HEADER_SIZE + INDEX_SIZE, errorStr))
+        return false;
+
+    memset(_map, 0, size_t(_mapSize));
+    memcpy(_map, BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    writeField<qint32>(_map, OFFSET_VERSION, METEOGRID_BINARY_VERSION);
+    writeField<qint32>(_map, OFFSET_NRCELLS, _nrCells);
+    writeField<qint32>(_map, OFFSET_BLOCKLENGTH, _blockLength);
+    writeField<qint32>(_map, OFFSET_MAXBLOCKS, METEOGRID_BINARY_MAX_BLOCKS);
+    writeField<qint64>(_map, OFFSET_FIRSTBLOCK, firstBlock);
+
+    _firstBlock = firstBlock;
+    _minStep = 1;
+    _maxStep = 0;
+    writeHeader();
+
+    _blockOffsets.assign(METEOGRID_BINARY_MAX_BLOCKS, 0);
+
+    return true;
+}
+
+
+bool Crit3DMeteoGridBinaryFile::remap(qint64 newSize, QString &errorStr)
+{
+    if (_map != nullptr)
+    {
+        _file.unmap(_map);
+        _map = nullptr;
+    }
+
+    if (! _file.resize(newSize))
+    {
+        errorStr = "Error in resizing " + _file.fileName() + ": " + _file.errorString();
+        return false;
+    }
+
+    _map = _file.map(0, newSize);
+    if (_map == nullptr)
+    {
+        errorStr = "Error in mapping " + _file.fileName() + ": " + _file.errorString();
+        return false;
+    }
+
+    _mapSize = newSize;
+    return true;
+}
+
+
+// appends a block of NODATA at the end of the file
+bool Crit3DMeteoGridBinaryFile::addBlock(int blockIndex, QString &errorStr)
+{
+    qint64 blockOffset = _mapSize;
+    qint64 blockSize = qint64(_nrCells) * qint64(_blockLength);
+
+    if (! remap(_mapSize + blockSize * qint64(sizeof(float)), errorStr))
+        return false;
+
+    float* values = reinterpret_cast<float*>(_map + blockOffset);
+    std::fill(values, values + blockSize, float(NODATA));
+
+    _blockOffsets[unsigned(blockIndex)] = blockOffset;
+    writeField<qint64>(_map, METEOGRID_BINARY_HEADER_SIZE + blockIndex * int(sizeof(qint64)), blockOffset);
+
+    return true;
+}
+
+
+void Crit3DMeteoGridBinaryFile::writeHeader()
+{
+    writeField<qint64>(_map, OFFSET_MINSTEP, _minStep);
+    writeField<qint64>(_map, OFFSET_MAXSTEP, _maxStep);
+}
+
+
+/*!
+ * \brief read
+ * values of a cell from firstStep to firstStep + nrSteps - 1; missing blocks are NODATA
+ */
+void Crit3DMeteoGridBinaryFile::read(int cellIndex, qint64 firstStep, int nrSteps, float* values) const
+{
+    int i = 0;
+    while (i < nrSteps)
+    {
+        qint64 step = firstStep + i;
+        qint64 block = floorDivision(step, _blockLength);
+        qint64 blockStart = block * _blockLength;
+        int nrBlockSteps = int(std::min(qint64(nrSteps - i), blockStart + _blockLength - step));
+
+        qint64 blockIndex = block - _firstBlock;
+        qint64 blockOffset = 0;
+        if (_map != nullptr && blockIndex >= 0 && blockIndex < METEOGRID_BINARY_MAX_BLOCKS
+            && cellIndex >= 0 && cellIndex < _nrCells)
+        {
+            blockOffset = _blockOffsets[unsigned(blockIndex)];
+        }
+
+        if (blockOffset == 0)
+        {
+            std::fill(values + i, values + i + nrBlockSteps, float(NODATA));
+        }
+        else
+        {
+            qint64 valueIndex = qint64(cellIndex) * _blockLength + (step - blockStart);
+            memcpy(values + i, _map + blockOffset + valueIndex * qint64(sizeof(float)), size_t(nrBlockSteps) * sizeof(float));
+        }
+
+        i += nrBlockSteps;
+    }
+}
+
+
+/*!
+ * \brief write
+ * values of a cell from firstStep to firstStep + nrSteps - 1
+ */
+bool Crit3DMeteoGridBinaryFile::write(int cellIndex, qint64 firstStep, int nrSteps, const float* values, QString &errorStr)
+{
+    if (nrSteps <= 0)
+        return true;
+
+    if (cellIndex < 0 || cellIndex >= _nrCells)
+    {
+        errorStr = "Wrong cell index.";
+        return false;
+    }
+
+    if (_map == nullptr)
+    {
+        // index centered on the first written block
+        qint64 firstBlock = floorDivision(firstStep, _blockLength) - METEOGRID_BINARY_MAX_BLOCKS / 2;
+        if (! createFile(firstBlock, errorStr))
+            return false;
+    }
+
+    if (! _file.isWritable())
+    {
+        errorStr = "Read only file: " + _file.fileName();
+        return false;
+    }
+
+    int i = 0;
+    while (i < nrSteps)
+    {
+        qint64 step = firstStep + i;
+        qint64 block = floorDivision(step, _blockLength);
+        qint64 blockStart = block * _blockLength;
+        int nrBlockSteps = int(std::min(qint64(nrSteps - i), blockStart + _blockLength - step));
+
+        qint64 blockIndex = block - _firstBlock;
+        if (blockIndex < 0 || blockIndex >= METEOGRID_BINARY_MAX_BLOCKS)
+        {
+            errorStr = "Date out of the range of " + _file.fileName();
+            return false;
+        }
+
+        if (_blockOffsets[unsigned(blockIndex)] == 0)
+        {
+            if (! addBlock(int(blockIndex), errorStr))
+                return false;
+        }
+
+        qint64 valueIndex = qint64(cellIndex) * _blockLength + (step - blockStart);
+        memcpy(_map + _blockOffsets[unsigned(blockIndex)] + valueIndex * qint64(sizeof(float)),
+               values + i, size_t(nrBlockSteps) * sizeof(float));
+
+        i += nrBlockSteps;
+    }
+
+    if (isEmpty())
+    {
+        _minStep = firstStep;
+        _maxStep = firstStep + nrSteps - 1;
+    }
+    else
+    {
+        _minStep = std::min(_minStep, firstStep);
+        _maxStep = std::max(_maxStep, firstStep + nrSteps - 1);
+    }
+    writeHeader();
+
+    return true;
+}
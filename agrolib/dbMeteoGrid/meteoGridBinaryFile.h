@@ -0,0 +1,61 @@
+#ifndef METEOGRIDBINARYFILE_H
+#define METEOGRIDBINARYFILE_H
+
+    #ifndef QFILE_H
+        #include <QFile>
+    #endif
+
+    #include <vector>
+
+    #define METEOGRID_BINARY_VERSION 1
+    #define METEOGRID_BINARY_HEADER_SIZE 64
+    #define METEOGRID_BINARY_MAX_BLOCKS 1024
+
+    // time steps of a block
+    #define METEOGRID_BINARY_DAILY_BLOCK 366
+    #define METEOGRID_BINARY_MONTHLY_BLOCK 120
+
+    /*!
+     * \brief The Crit3DMeteoGridBinaryFile class
+     * values of one variable for all the cells of a meteo grid, memory mapped.
+     * Time steps are absolute integers (julian day for daily data, year*12 + month-1 for monthly data),
+     * stored in blocks of blockLength steps for all the cells: a block is nrCells x blockLength floats,
+     * cell-major, so that the series of a cell is contiguous inside each block.
+     * File: header (64 bytes), index of the block offsets (0 = missing block), blocks.
+     * Missing values are NODATA. Byte order is the native one
+     */
+    class Crit3DMeteoGridBinaryFile
+    {
+    public:
+        Crit3DMeteoGridBinaryFile();
+        ~Crit3DMeteoGridBinaryFile();
+
+        bool open(const QString &fileName, int nrCells, int blockLength, QString &errorStr);
+        void close();
+
+        bool isEmpty() const { return _minStep > _maxStep; }
+        qint64 minStep() const { return _minStep; }
+        qint64 maxStep() const { return _maxStep; }
+
+        void read(int cellIndex, qint64 firstStep, int nrSteps, float* values) const;
+        bool write(int cellIndex, qint64 firstStep, int nrSteps, const float* values, QString &errorStr);
+
+    private:
+        QFile _file;
+        uchar* _map;
+        qint64 _mapSize;
+
+        int _nrCells;
+        int _blockLength;
+        qint64 _firstBlock;
+        qint64 _minStep, _maxStep;
+        std::vector<qint64> _blockOffsets;
+
+        bool createFile(qint64 firstBlock, QString &errorStr);
+        bool remap(qint64 newSize, QString &errorStr);
+        bool addBlock(int blockIndex, QString &errorStr);
+        void writeHeader();
+    };
+
+
+#endif // METEOGRIDBINARYFILE_H
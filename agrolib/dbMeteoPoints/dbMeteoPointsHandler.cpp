@@ -508,6 +508,10 @@ bool Crit3DMeteoPointsDbHandler::deleteAllPointsFromDataset(QList<QString> datas
 }
 
 
+/*!
+ * \brief loadDailyData
+ * the day index is computed by SQLite (julianday), the values are written directly in obsDataD
+ */
 bool Crit3DMeteoPointsDbHandler::loadDailyData(const Crit3DDate &firstDate, const Crit3DDate &lastDate, Crit3DMeteoPoint *meteoPoint)
 {
     // check dates
@@ -524,41 +528,49 @@ bool Crit3DMeteoPointsDbHandler::loadDailyData(const Crit3DDate &firstDate, cons
     QString lastDateStr = QString::fromStdString(lastDate.toStdString());
     QString tableName = QString::fromStdString(meteoPoint->id) + "_D";
 
-    QString statement;
-    if (numberOfDays == 1)
-    {
-        statement = QString( "SELECT * FROM `%1` WHERE date_time = DATE('%2')").arg(tableName, firstDateStr);
-    }
-    else
+    QString statement = QString("SELECT CAST(ROUND(julianday(date_time) - julianday(?)) AS INTEGER), `%1`, value "
+                                "FROM `%2` WHERE date_time >= DATE(?) AND date_time < DATE(?, '+1 day')")
+                                .arg(FIELD_METEO_VARIABLE, tableName);
+
+    QSqlQuery myQuery(_db);
+    myQuery.setForwardOnly(true);
+    myQuery.prepare(statement);
+    myQuery.addBindValue(firstDateStr);
+    myQuery.addBindValue(firstDateStr);
+    myQuery.addBindValue(lastDateStr);
+
+    if (! myQuery.exec())
     {
-        statement = QString( "SELECT * FROM `%1` WHERE date_time >= DATE('%2') AND date_time < DATE('%3', '+1 day')")
-                                .arg(tableName, firstDateStr, lastDateStr);
+        errorStr = myQuery.lastError().text();
+        return false;
     }
 
-    QSqlQuery myQuery(_db);
-    if( myQuery.exec(statement) )
+    int previousIdVar = NODATA;
+    meteoVariable variable = noMeteoVar;
+    while (myQuery.next())
     {
-        while (myQuery.next())
+        int idVar = myQuery.value(1).toInt();
+        if (idVar != previousIdVar)
         {
-            QString dateStr = myQuery.value(0).toString();
-            QDate d = QDate::fromString(dateStr, "yyyy-MM-dd");
-
-            int idVar = myQuery.value(1).toInt();
-            meteoVariable variable = _mapIdMeteoVar.at(idVar);
-
-            float value = myQuery.value(2).toFloat();
+            std::map<int, meteoVariable>::const_iterator it = _mapIdMeteoVar.find(idVar);
+            variable = (it != _mapIdMeteoVar.end()) ? it->second : noMeteoVar;
+            previousIdVar = idVar;
+        }
 
-            meteoPoint->setMeteoPointValueD(Crit3DDate(d.day(), d.month(), d.year()), variable, value);
+        if (variable != noMeteoVar)
+        {
+            meteoPoint->setMeteoPointValueD(myQuery.value(0).toInt(), variable, myQuery.value(2).toFloat());
         }
-        return true;
-    }
-    else
-    {
-        return false;
     }
+
+    return true;
 }
 
 
+/*!
+ * \brief loadHourlyData
+ * the time offset (minutes from the first date) is computed by SQLite (julianday)
+ */
 bool Crit3DMeteoPointsDbHandler::loadHourlyData(const Crit3DDate &firstDate, const Crit3DDate &lastDate, Crit3DMeteoPoint *meteoPoint)
 {
     // check dates
@@ -577,43 +589,59 @@ bool Crit3DMeteoPointsDbHandler::loadHourlyData(const Crit3DDate &firstDate, con
     QString endDateStr = QString::fromStdString(lastDate.toStdString());
     QString tableName = QString::fromStdString(meteoPoint->id) + "_H";
 
-    QString statement = QString( "SELECT * FROM `%1` WHERE date_time >= DATETIME('%2 01:00:00') AND date_time <= DATETIME('%3 00:00:00', '+1 day')")
-                                 .arg(tableName, startDateStr, endDateStr);
+    QString statement = QString("SELECT CAST(ROUND((julianday(date_time) - julianday(?)) * %1) AS INTEGER), `%2`, value "
+                                "FROM `%3` WHERE date_time >= DATETIME(? || ' 01:00:00') "
+                                "AND date_time <= DATETIME(? || ' 00:00:00', '+1 day')")
+                                .arg(DAY_MINUTES).arg(FIELD_METEO_VARIABLE, tableName);
+
     QSqlQuery qry(_db);
-    if(! qry.exec(statement) )
+    qry.setForwardOnly(true);
+    qry.prepare(statement);
+    qry.addBindValue(startDateStr);
+    qry.addBindValue(startDateStr);
+    qry.addBindValue(endDateStr);
+
+    if(! qry.exec())
     {
         errorStr = qry.lastError().text();
         return false;
     }
-    else
+
+    int previousIdVar = NODATA;
+    int previousDay = NODATA;
+    meteoVariable variable = noMeteoVar;
+    Crit3DDate myDate;
+
+    while (qry.next())
     {
-        meteoVariable variable;
-        while (qry.next())
+        int idVar = qry.value(1).toInt();
+        if (idVar != previousIdVar)
         {
-            QDateTime d = qry.value(0).toDateTime();
-            Crit3DDate myDate = Crit3DDate(d.date().day(), d.date().month(), d.date().year());
+            std::map<int, meteoVariable>::const_iterator it = _mapIdMeteoVar.find(idVar);
+            variable = (it != _mapIdMeteoVar.end()) ? it->second : noMeteoVar;
+            previousIdVar = idVar;
+        }
 
-            int idVar = qry.value(1).toInt();
-            try
-            {
-                variable = _mapIdMeteoVar.at(idVar);
-            }
-            catch (const std::out_of_range& )
+        if (variable != noMeteoVar)
+        {
+            int minutes = qry.value(0).toInt();
+            int day = minutes / DAY_MINUTES;
+            if (day != previousDay)
             {
-                variable = noMeteoVar;
+                myDate = firstDate.addDays(day);
+                previousDay = day;
             }
+            int hour = (minutes % DAY_MINUTES) / 60;
+            int minute = minutes % 60;
 
-            if (variable != noMeteoVar)
-            {
-                float value = qry.value(2).toFloat();
-                meteoPoint->setMeteoPointValueH(myDate, d.time().hour(), d.time().minute(), variable, value);
+            float value = qry.value(2).toFloat();
+            meteoPoint->setMeteoPointValueH(myDate, hour, minute, variable, value);
 
-                // copy scalar intensity to vector intensity (instantaneous values are equivalent, following WMO)
-                // should be removed when hourly averages are available
-                if (variable == windScalarIntensity)
-                {
-                    meteoPoint->setMeteoPointValueH(myDate, d.time().hour(), d.time().minute(), windVectorIntensity, value);
-                }
+            // copy scalar intensity to vector intensity (instantaneous values are equivalent, following WMO)
+            // should be removed when hourly averages are available
+            if (variable == windScalarIntensity)
+            {
+                meteoPoint->setMeteoPointValueH(myDate, hour, minute, windVectorIntensity, value);
             }
         }
     }
@@ -1552,6 +1580,56 @@ bool Crit3DMeteoPointsDbHandler::writeHourlyDataList(const QString &pointCode, c
 }
 
 
+/*!
+ * \brief writeDataBatch
+ * writes the records (dateTimeList[i], idVarList[i], valueList[i]) with a single prepared statement.
+ * Values are written with the same precision of writeDailyDataList / writeHourlyDataList.
+ * The caller may open a transaction on the db to write several points at once
+ */
+bool Crit3DMeteoPointsDbHandler::writeDataBatch(const QString &pointCode, frequencyType myFreq, const QList<QString> &dateTimeList,
+                                                const QList<int> &idVarList, const std::vector<float> &valueList, QString& log)
+{
+    if (! existIdPoint(pointCode))
+    {
+        log += "\nID " + pointCode + " is not present in the point properties table.";
+        return false;
+    }
+
+    QString tableName = pointCode + (myFreq == daily ? "_D" : "_H");
+    bool deletePreviousData = false;
+    if (! createTable(tableName, deletePreviousData))
+    {
+        log += "\nError in create table: " + tableName + _db.lastError().text();
+        return false;
+    }
+
+    QVariantList dateTimeValues, idVarValues, dataValues;
+    dateTimeValues.reserve(dateTimeList.size());
+    idVarValues.reserve(idVarList.size());
+    dataValues.reserve(int(valueList.size()));
+    for (int i = 0; i < dateTimeList.size(); i++)
+    {
+        dateTimeValues << dateTimeList[i];
+        idVarValues << idVarList[i];
+        dataValues << QString::number(double(valueList[unsigned(i)]));
+    }
+
+    QSqlQuery qry(_db);
+    qry.prepare(QString("INSERT OR REPLACE INTO `%1` VALUES (?,?,?)").arg(tableName));
+    qry.addBindValue(dateTimeValues);
+    qry.addBindValue(idVarValues);
+    qry.addBindValue(dataValues);
+
+    if (! qry.execBatch())
+    {
+        log += "\nError in execute query: " + qry.lastError().text();
+        return false;
+    }
+
+    return true;
+}
+
+
 bool Crit3DMeteoPointsDbHandler::setAllPointsActive()
 {
     QSqlQuery qry(_db);
@@ -91,6 +91,8 @@
 
         bool writeDailyDataList(const QString &pointCode, const QList<QString> &listEntries, QString& log);
         bool writeHourlyDataList(const QString &pointCode, const QList<QString> &listEntries, QString& log);
+        bool writeDataBatch(const QString &pointCode, frequencyType myFreq, const QList<QString> &dateTimeList,
+                            const QList<int> &idVarList, const std::vector<float> &valueList, QString& log);
 
         bool setAllPointsActive();
         bool setAllPointsNotActive();
@@ -29,8 +29,10 @@ win32:{
 INCLUDEPATH += ../crit3dDate ../mathFunctions ../gis ../meteo ../interpolation ../dbMeteoPoints
 
 SOURCES +=   \
-    drought.cpp
+    drought.cpp \
+    droughtGrid.cpp
 
 HEADERS +=  \
-    drought.h
+    drought.h \
+    droughtGrid.h
 
@@ -0,0 +1,386 @@
+#include "droughtGrid.h"
+#include "commonConstants.h"
+#include "basicMath.h"
+#include "gammaFunction.h"
+#include "parallel.h"
+
+#include <algorithm>
+
+
+bool DroughtGrid::TdroughtKey::operator < (const TdroughtKey &other) const
+{
+    if (index != other.index) return index < other.index;
+    if (timeScale != other.timeScale) return timeScale < other.timeScale;
+    if (firstYear != other.firstYear) return firstYear < other.firstYear;
+    if (lastYear != other.lastYear) return lastYear < other.lastYear;
+    return minPercentage < other.minPercentage;
+}
+
+
+DroughtGrid::DroughtGrid()
+{
+    nrThreads = 0;
+    clear();
+}
+
+
+void DroughtGrid::clear()
+{
+    nrCells = 0;
+    nrMonths = 0;
+    firstMonth = 1;
+    firstYear = NODATA;
+    prec.clear();
+    et0.clear();
+    isActive.clear();
+    parametersCache.clear();
+}
+
+
+// same calendar of Crit3DMeteoPoint::initializeObsDataM
+int DroughtGrid::getYear(int monthIndex) const
+{
+    return firstYear + (firstMonth - 1 + monthIndex) / 12;
+}
+
+
+/*!
+ * \brief setMonthlySeries
+ * values of the cell i, month j (from firstMonth/firstYear) are in position i * nrMonths + j.
+ * Inactive cells are not computed (their index is NODATA).
+ * The vectors are swapped with the internal ones.
+ * The cached parameters are kept if the new series are equal to the previous ones on the common months
+ */
+void DroughtGrid::setMonthlySeries(int nrCells, int nrMonths, int firstMonth, int firstYear,
+                                   std::vector<float> &precValues, std::vector<float> &et0Values,
+                                   std::vector<bool> &activeCells)
+{
+    bool isSameData = (nrCells == this->nrCells && firstMonth == this->firstMonth && firstYear == this->firstYear
+                       && activeCells == isActive);
+
+    int nrCommonMonths = std::min(nrMonths, this->nrMonths);
+    for (int cell = 0; cell < nrCells && isSameData; cell++)
+    {
+        const float* newPrec = precValues.data() + long(cell) * nrMonths;
+        const float* newEt0 = et0Values.data() + long(cell) * nrMonths;
+        const float* oldPrec = prec.data() + long(cell) * this->nrMonths;
+        const float* oldEt0 = et0.data() + long(cell) * this->nrMonths;
+
+        isSameData = std::equal(newPrec, newPrec + nrCommonMonths, oldPrec)
+                     && std::equal(newEt0, newEt0 + nrCommonMonths, oldEt0);
+    }
+
+    if (! isSameData)
+        parametersCache.clear();
+
+    this->nrCells = nrCells;
+    this->nrMonths = nrMonths;
+    this->firstMonth = firstMonth;
+    this->firstYear = firstYear;
+    prec.swap(precValues);
+    et0.swap(et0Values);
+    isActive.swap(activeCells);
+}
+
+
+/*!
+ * \brief getFittingPeriod
+ * months of the series used to fit the parameters of the reference period:
+ * the cumulated values from indexStart to indexStart + nrSums - 1
+ * \return false if the reference period is out of the series
+ */
+bool DroughtGrid::getFittingPeriod(const TdroughtKey &key, int &indexStart, int &nrSums) const
+{
+    int timeScale = key.timeScale - 1;      // index start from 0
+
+    if (nrMonths == 0 || firstYear > key.lastYear || getYear(nrMonths-1) < key.firstYear)
+        return false;
+
+    indexStart = (key.firstYear - firstYear) * 12;
+    if (indexStart < timeScale)
+    {
+        indexStart = timeScale;
+    }
+    if (indexStart >= nrMonths || getYear(indexStart) > key.lastYear)
+        return false;
+
+    int lastYearStation = std::min(getYear(nrMonths-1), key.lastYear);
+
+    nrSums = 0;
+    while (indexStart + nrSums < nrMonths && getYear(indexStart + nrSums) <= lastYearStation)
+        nrSums++;
+
+    return true;
+}
+
+
+const DroughtGrid::TdroughtParameters* DroughtGrid::getParameters(const TdroughtKey &key)
+{
+    int indexStart, nrSums;
+    if (! getFittingPeriod(key, indexStart, nrSums))
+    {
+        parametersCache.erase(key);
+        return nullptr;
+    }
+
+    // the series may be longer or shorter than the ones used in the previous fitting
+    std::map<TdroughtKey, TdroughtParameters>::iterator it = parametersCache.find(key);
+    if (it != parametersCache.end() && it->second.indexStart == indexStart && it->second.nrSums == nrSums)
+        return &(it->second);
+
+    TdroughtParameters parameters;
+    if (! fitParameters(key, parameters))
+    {
+        parametersCache.erase(key);
+        return nullptr;
+    }
+
+    parametersCache[key] = parameters;
+    return &(parametersCache[key]);
+}
+
+
+/*!
+ * \brief fitParameters
+ * gamma (SPI) or log-logistic (SPEI) parameters of each cell and month,
+ * as Drought::computeSpiParameters and Drought::computeSpeiParameters. Cells are fitted in parallel
+ */
+bool DroughtGrid::fitParameters(const TdroughtKey &key, TdroughtParameters &parameters)
+{
+    int timeScale = key.timeScale - 1;      // index start from 0
+
+    int indexStart, nrSums;
+    if (! getFittingPeriod(key, indexStart, nrSums))
+        return false;
+
+    parameters.indexStart = indexStart;
+    parameters.nrSums = nrSums;
+
+    int startMonth = (firstMonth - 1 + indexStart) % 12 + 1;
+    float minPerc = key.minPercentage;
+
+    gammaParam noGamma;
+    noGamma.beta = NODATA;
+    noGamma.gamma = NODATA;
+    noGamma.pzero = NODATA;
+    logLogisticParam noLogLogistic;
+    noLogLogistic.alpha = NODATA;
+    noLogLogistic.beta = NODATA;
+    noLogLogistic.gamma = NODATA;
+
+    if (key.index == INDEX_SPI)
+        parameters.gamma.assign(unsigned(nrCells) * 12, noGamma);
+    else
+        parameters.logLogistic.assign(unsigned(nrCells) * 12, noLogLogistic);
+
+    int nrWorkers = parallel::getNrThreads(nrThreads);
+    std::vector<std::vector<float>> threadSums;
+    std::vector<std::vector<float>> threadSeries;
+    threadSums.resize(unsigned(nrWorkers));
+    threadSeries.resize(unsigned(nrWorkers));
+
+    parallel::forEachBlock(nrCells, DROUGHT_CELLS_BLOCK, nrWorkers, [&](long first, long last, int threadIndex)
+    {
+        std::vector<float> &mySums = threadSums[unsigned(threadIndex)];
+        std::vector<float> &monthSeries = threadSeries[unsigned(threadIndex)];
+        std::vector<float> pwm(3);
+
+        for (long cell = first; cell < last; cell++)
+        {
+            if (! isActive[unsigned(cell)])
+                continue;
+
+            const float* cellPrec = prec.data() + cell * nrMonths;
+            const float* cellEt0 = et0.data() + cell * nrMonths;
+
+            mySums.resize(unsigned(nrSums));
+            for (int n = 0; n < nrSums; n++)
+            {
+                int j = indexStart + n;
+                float count = 0;
+                int nTot = 0;
+                mySums[unsigned(n)] = 0;
+                for (int i = 0; i <= timeScale; i++)
+                {
+                    nTot = nTot + 1;
+                    bool isValid = (key.index == INDEX_SPI) ? (cellPrec[j-i] != NODATA)
+                                                            : (cellPrec[j-i] != NODATA && cellEt0[j-i] != NODATA);
+                    if (isValid)
+                    {
+                        if (key.index == INDEX_SPI)
+                            mySums[unsigned(n)] = mySums[unsigned(n)] + cellPrec[j-i];
+                        else
+                            mySums[unsigned(n)] = mySums[unsigned(n)] + cellPrec[j-i] - cellEt0[j-i];
+                        count = count + 1;
+                    }
+                    else
+                    {
+                        mySums[unsigned(n)] = NODATA;
+                        count = 0;
+                        break;
+                    }
+                }
+                if (count / nTot < (minPerc / 100))
+                {
+                    mySums[unsigned(n)] = NODATA;
+                }
+            }
+
+            for (int i = 0; i < 12; i++)
+            {
+                int myMonth = ((startMonth + i - 1) % 12) + 1;     // start from 1
+                unsigned long paramIndex = unsigned(cell) * 12 + unsigned(myMonth - 1);
+                int n = 0;
+
+                monthSeries.clear();
+                for (unsigned j = unsigned(i); j < mySums.size(); j = j + 12)
+                {
+                    if (mySums[j] != NODATA)
+                    {
+                        monthSeries.push_back(mySums[j]);
+                        n = n + 1;
+                    }
+                }
+
+                if (float(n) / (mySums.size() / 12) >= minPerc / 100)
+                {
+                    if (key.index == INDEX_SPI)
+                    {
+                        gammaParam &myGamma = parameters.gamma[paramIndex];
+                        generalizedGammaFitting(monthSeries, n, &(myGamma.beta), &(myGamma.gamma), &(myGamma.pzero));
+                    }
+                    else
+                    {
+                        logLogisticParam &myLogLogistic = parameters.logLogistic[paramIndex];
+                        if (! monthSeries.empty())
+                        {
+                            sorting::quicksortAscendingFloat(monthSeries, 0, unsigned(monthSeries.size()-1));
+                        }
+                        probabilityWeightedMoments(monthSeries, n, pwm, 0, 0, false);
+                        logLogisticFitting(pwm, &(myLogLogistic.alpha), &(myLogLogistic.beta), &(myLogLogistic.gamma));
+                    }
+                }
+            }
+        }
+
+        return true;
+    });
+
+    return true;
+}
+
+
+// cumulated value (prec or prec - et0) of the timeScale+1 months ending at last, as Drought::computeDroughtIndex
+float DroughtGrid::getSum(droughtIndex index, int cell, int last, int timeScale) const
+{
+    const float* cellPrec = prec.data() + long(cell) * nrMonths;
+    const float* cellEt0 = et0.data() + long(cell) * nrMonths;
+
+    float mySum = 0;
+    for (int i = 0; i <= timeScale; i++)
+    {
+        if ((last-i) >= 0 && last < nrMonths)
+        {
+            if (index == INDEX_SPI)
+            {
+                if (cellPrec[last-i] != NODATA)
+                {
+                    mySum = mySum + cellPrec[last-i];
+                }
+                else
+                {
+                    return NODATA;
+                }
+            }
+            else if (index == INDEX_SPEI)
+            {
+                if (cellPrec[last-i] != NODATA && cellEt0[last-i] != NODATA)
+                {
+                    mySum = mySum + cellPrec[last-i] - cellEt0[last-i];
+                }
+                else
+                {
+                    return NODATA;
+                }
+            }
+        }
+        else
+        {
+            return NODATA;
+        }
+    }
+
+    return mySum;
+}
+
+
+/*!
+ * \brief computeDroughtIndex
+ * SPI or SPEI of all the cells for the month (year, month).
+ * The parameters are fitted only the first time a reference period is used
+ * (and again if the months of the series used in the fitting are changed)
+ * \return false if the reference period or the date are out of the series
+ */
+bool DroughtGrid::computeDroughtIndex(droughtIndex index, int timeScale, int refFirstYear, int refLastYear,
+                                      float minPercentage, int year, int month, std::vector<float> &results)
+{
+    results.assign(unsigned(nrCells), NODATA);
+
+    if (index != INDEX_SPI && index != INDEX_SPEI)
+        return false;
+
+    TdroughtKey key;
+    key.index = index;
+    key.timeScale = timeScale;
+    key.firstYear = refFirstYear;
+    key.lastYear = refLastYear;
+    key.minPercentage = minPercentage;
+
+    const TdroughtParameters* parameters = getParameters(key);
+    if (parameters == nullptr)
+        return false;
+
+    int last = (year - firstYear) * 12 + month - firstMonth;        // starts from 0
+    if (last < 0 || last >= nrMonths)
+        return false;
+
+    // as in Drought: the parameters index is the position in the series
+    unsigned monthIndex = unsigned(last % 12);
+
+    int nrWorkers = parallel::getNrThreads(nrThreads);
+    parallel::forEachBlock(nrCells, DROUGHT_CELLS_BLOCK * 16, nrWorkers, [&](long first, long lastCell, int)
+    {
+        for (long cell = first; cell < lastCell; cell++)
+        {
+            if (! isActive[unsigned(cell)])
+                continue;
+
+            float mySum = getSum(index, int(cell), last, timeScale - 1);
+            if (mySum == NODATA)
+                continue;
+
+            unsigned long paramIndex = unsigned(cell) * 12 + monthIndex;
+            if (index == INDEX_SPI)
+            {
+                const gammaParam &myGamma = parameters->gamma[paramIndex];
+                float gammaCDFRes = generalizedGammaCDF(mySum, myGamma.beta, myGamma.gamma, myGamma.pzero);
+                if (gammaCDFRes > 0 && gammaCDFRes < 1)
+                {
+                    results[unsigned(cell)] = float(standardGaussianInvCDF(gammaCDFRes));
+                }
+            }
+            else
+            {
+                const logLogisticParam &myLogLogistic = parameters->logLogistic[paramIndex];
+                float logLogisticRes = logLogisticCDF(mySum, myLogLogistic.alpha, myLogLogistic.beta, myLogLogistic.gamma);
+                if (logLogisticRes > 0 && logLogisticRes < 1)
+                {
+                    results[unsigned(cell)] = float(standardGaussianInvCDF(logLogisticRes));
+                }
+            }
+        }
+        return true;
+    });
+
+    return true;
+}
@@ -0,0 +1,73 @@
+#ifndef DROUGHTGRID_H
+#define DROUGHTGRID_H
+
+#ifndef DROUGHT_H
+    #include "drought.h"
+#endif
+
+#include <vector>
+#include <map>
+
+#define DROUGHT_CELLS_BLOCK 64
+
+// SPI/SPEI of many monthly series sharing the same calendar (the cells of the meteo grid).
+// The series are stored as structure of arrays (one array for each variable, cell after cell);
+// the fitted parameters are cached for each reference period, so that computing the index
+// of another month does not refit them. Same results of Drought::computeDroughtIndex
+class DroughtGrid
+{
+public:
+    DroughtGrid();
+
+    void clear();
+    void setNrThreads(int value) { nrThreads = value; }
+
+    void setMonthlySeries(int nrCells, int nrMonths, int firstMonth, int firstYear,
+                          std::vector<float> &precValues, std::vector<float> &et0Values,
+                          std::vector<bool> &activeCells);
+
+    bool computeDroughtIndex(droughtIndex index, int timeScale, int refFirstYear, int refLastYear,
+                             float minPercentage, int year, int month, std::vector<float> &results);
+
+    int getNrCells() const { return nrCells; }
+    int getNrMonths() const { return nrMonths; }
+
+private:
+    struct TdroughtKey
+    {
+        droughtIndex index;
+        int timeScale;
+        int firstYear;
+        int lastYear;
+        float minPercentage;
+
+        bool operator < (const TdroughtKey &other) const;
+    };
+
+    struct TdroughtParameters
+    {
+        int indexStart;                             // months of the series used in the fitting
+        int nrSums;
+        std::vector<gammaParam> gamma;              // 12 months for each cell
+        std::vector<logLogisticParam> logLogistic;
+    };
+
+    int nrThreads;
+    int nrCells;
+    int nrMonths;
+    int firstMonth;
+    int firstYear;
+    std::vector<float> prec;
+    std::vector<float> et0;
+    std::vector<bool> isActive;
+    std::map<TdroughtKey, TdroughtParameters> parametersCache;
+
+    int getYear(int monthIndex) const;
+    bool getFittingPeriod(const TdroughtKey &key, int &indexStart, int &nrSums) const;
+    const TdroughtParameters* getParameters(const TdroughtKey &key);
+    bool fitParameters(const TdroughtKey &key, TdroughtParameters &parameters);
+    float getSum(droughtIndex index, int cell, int last, int timeScale) const;
+};
+
+
+#endif // DROUGHTGRID_H
@@ -26,12 +26,16 @@
 */
 
 #include <math.h>
+#include <float.h>
 #include <algorithm>
+#include <vector>
+#include <new>
 
 #include "commonConstants.h"
 #include "basicMath.h"
 #include "statistics.h"
 #include "gis.h"
+#include "rasterKernels.h"
 
 namespace gis
 {
@@ -201,39 +205,73 @@ namespace gis
         minimum = NODATA;
         maximum = NODATA;
         value = nullptr;
+        dataBuffer = nullptr;
     }
 
 
     void Crit3DRasterGrid::setConstantValue(float initValue)
     {
-        for (int row = 0; row < this->header->nrRows; row++)
-            for (int col = 0; col < header->nrCols; col++)
-                value[row][col] = initValue;
+        std::fill(dataBuffer, dataBuffer + dataSize(), initValue);
 
         this->minimum = initValue;
         this->maximum = initValue;
     }
 
 
+    /*!
+     * \brief allocate the grid values in a single aligned buffer
+     * value[row] are views on the rows of the buffer
+     */
     bool Crit3DRasterGrid::initializeGrid()
     {
-        this->value = new float*[unsigned(this->header->nrRows)];
+        freeGrid();
+
+        if (this->header->nrRows <= 0 || this->header->nrCols <= 0)
+            return true;
 
+        size_t nrValues = size_t(this->header->nrRows) * size_t(this->header->nrCols);
+        this->dataBuffer = static_cast<float*>(::operator new[](nrValues * sizeof(float),
+                                                std::align_val_t(RASTER_ALIGNMENT), std::nothrow));
+        if (this->dataBuffer == nullptr)
+        {
+            // Memory error: file too big
+            this->clear();
+            return false;
+        }
+
+        this->value = new float*[unsigned(this->header->nrRows)];
         for (int row = 0; row < this->header->nrRows; row++)
         {
-            this->value[row] = new float[unsigned(this->header->nrCols)];
-            if (this->value[row] == nullptr)
-            {
-                // Memory error: file too big
-                this->clear();
-                return false;
-            }
+            this->value[row] = this->dataBuffer + size_t(row) * size_t(this->header->nrCols);
         }
 
         return true;
     }
 
 
+    void Crit3DRasterGrid::freeGrid()
+    {
+        if (value != nullptr)
+        {
+            delete [] value;
+            value = nullptr;
+        }
+
+        if (dataBuffer != nullptr)
+        {
+            ::operator delete[](dataBuffer, std::align_val_t(RASTER_ALIGNMENT));
+            dataBuffer = nullptr;
+        }
+    }
+
+
+    long Crit3DRasterGrid::dataSize() const
+    {
+        if (dataBuffer == nullptr) return 0;
+        return long(header->nrRows) * long(header->nrCols);
+    }
+
+
     bool Crit3DRasterGrid::initializeGrid(float initValue)
     {
         if (! initializeGrid()) return false;
@@ -293,11 +331,9 @@ namespace gis
         *(header) = *(initGrid.header);
         *(colorScale) = *(initGrid.colorScale);
 
-        initializeGrid();
+        if (! initializeGrid()) return false;
 
-        for (int row = 0; row < header->nrRows; row++)
-            for (int col = 0; col < header->nrCols; col++)
-                    value[row][col] = initGrid.value[row][col];
+        std::copy(initGrid.data(), initGrid.data() + dataSize(), dataBuffer);
 
         gis::updateMinMaxRasterGrid(this);
         isLoaded = true;
@@ -347,15 +383,7 @@ namespace gis
 
     void Crit3DRasterGrid::clear()
     {
-        if (value != nullptr && header->nrRows > 0)
-        {
-            for (int row = 0; row < header->nrRows; row++)
-                if (value[row] != nullptr)
-                    delete [] value[row];
-
-            delete [] value;
-            value = nullptr;
-        }
+        freeGrid();
 
         mapTime.setNullTime();
         minimum = NODATA;
@@ -374,9 +402,7 @@ namespace gis
     // clean the grid (all NO DATA)
     void Crit3DRasterGrid::emptyGrid()
     {
-        for (int row = 0; row < header->nrRows; row++)
-            for (int col = 0; col < header->nrCols; col++)
-                value[row][col] = header->flag;
+        std::fill(dataBuffer, dataBuffer + dataSize(), header->flag);
     }
 
 
@@ -464,16 +490,7 @@ namespace gis
         if (myGrid.header->flag == NODATA)
             return;
 
-        for (int row = 0; row < myGrid.header->nrRows; row++)
-        {
-            for (int col = 0; col < myGrid.header->nrCols; col++)
-            {
-                if (isEqual(myGrid.value[row][col], myGrid.header->flag))
-                {
-                    myGrid.value[row][col] = NODATA;
-                }
-            }
-        }
+        replaceValue(myGrid.data(), myGrid.dataSize(), myGrid.header->flag, NODATA);
 
         myGrid.header->flag = NODATA;
     }
@@ -481,33 +498,12 @@ namespace gis
 
     bool updateMinMaxRasterGrid(Crit3DRasterGrid* myGrid)
     {
-        float myValue;
-        bool isFirstValue = true;
         float minimum = NODATA;
         float maximum = NODATA;
 
-        for (int row = 0; row < myGrid->header->nrRows; row++)
-            for (int col = 0; col < myGrid->header->nrCols; col++)
-            {
-                myValue = myGrid->value[row][col];
-                if (! isEqual(myValue, myGrid->header->flag)  && ! isEqual(myValue, NODATA))
-                {
-                    if (isFirstValue)
-                    {
-                        minimum = myValue;
-                        maximum = myValue;
-                        isFirstValue = false;
-                    }
-                    else
-                    {
-                        if (myValue < minimum) minimum = myValue;
-                        else if (myValue > maximum) maximum = myValue;
-                    }
-                }
-            }
-
         /*!  no values */
-        if (isFirstValue) return false;
+        if (! computeMinMax(myGrid->data(), myGrid->dataSize(), myGrid->header->flag, minimum, maximum))
+            return false;
 
         myGrid->maximum = maximum;
         myGrid->minimum = minimum;
@@ -1061,37 +1057,8 @@ namespace gis
         if (! (*(map1->header) == *(map2->header))) return false;
         if (! (*(outputMap->header) == *(map1->header))) return false;
 
-        for (int row=0; row<outputMap->header->nrRows; row++)
-            for (int col=0; col<outputMap->header->nrCols; col++)
-            {
-                if (!isEqual(map1->value[row][col], map1->header->flag)
-                    && !isEqual(map2->value[row][col], map2->header->flag))
-                {
-                    if (myOperation == operationMin)
-                    {
-                        outputMap->value[row][col] = MINVALUE(map1->value[row][col], map2->value[row][col]);
-                    }
-                    else if (myOperation == operationMax)
-                    {
-                        outputMap->value[row][col] = MAXVALUE(map1->value[row][col], map2->value[row][col]);
-                    }
-                    else if (myOperation == operationSum)
-                        outputMap->value[row][col] = (map1->value[row][col] + map2->value[row][col]);
-                    else if (myOperation == operationSubtract)
-                        outputMap->value[row][col] = (map1->value[row][col] - map2->value[row][col]);
-                    else if (myOperation == operationProduct)
-                        outputMap->value[row][col] = (map1->value[row][col] * map2->value[row][col]);
-                    else if (myOperation == operationDivide)
-                    {
-                        if (map2->value[row][col] != 0.f)
-                            outputMap->value[row][col] = (map1->value[row][col] / map2->value[row][col]);
-                        else
-                            return false;
-                    }
-                }
-            }
-
-        return true;
+        return maskedOperation(map1->data(), map1->header->flag, map2->data(), map2->header->flag,
+                               outputMap->data(), outputMap->dataSize(), myOperation);
     }
 
     bool mapAlgebra(gis::Crit3DRasterGrid* map1, float myValue,
@@ -1100,32 +1067,8 @@ namespace gis
         if (outputMap == nullptr || map1 == nullptr) return false;
         if (! (*(map1->header) == *(outputMap->header))) return false;
 
-        for (int row=0; row<outputMap->header->nrRows; row++)
-            for (int col=0; col<outputMap->header->nrCols; col++)
-            {
-                if (! isEqual(map1->value[row][col], map1->header->flag))
-                {
-                    if (myOperation == operationMin)
-                        outputMap->value[row][col] = MINVALUE(map1->value[row][col], myValue);
-                    else if (myOperation == operationMax)
-                        outputMap->value[row][col] = MAXVALUE(map1->value[row][col], myValue);
-                    else if (myOperation == operationSum)
-                        outputMap->value[row][col] = (map1->value[row][col] + myValue);
-                    else if (myOperation == operationSubtract)
-                        outputMap->value[row][col] = (map1->value[row][col] - myValue);
-                    else if (myOperation == operationProduct)
-                        outputMap->value[row][col] = (map1->value[row][col] * myValue);
-                    else if (myOperation == operationDivide)
-                    {
-                        if (myValue != 0.f)
-                            outputMap->value[row][col] = (map1->value[row][col] / myValue);
-                        else
-                            return false;
-                    }
-                }
-            }
-
-        return true;
+        return maskedOperation(map1->data(), map1->header->flag, myValue,
+                               outputMap->data(), outputMap->dataSize(), myOperation);
     }
 
     /*!
@@ -1305,32 +1248,65 @@ namespace gis
         double x, y;
         int inputRow, inputCol;
         int dim = 3;
+        int nrSteps = 2*dim+1;
 
         std::vector <float> valuesList;
         double step = outputMap->header->cellSize / (2*dim+1);
 
+        /*! sample positions are separable: input columns depend only on x, input rows only on y */
+        std::vector <int> inputCols(unsigned(outputMap->header->nrCols * nrSteps), NODATA);
+        std::vector <int> inputRows(unsigned(outputMap->header->nrRows * nrSteps), NODATA);
+
+        for (int col = 0; col < outputMap->header->nrCols; col++)
+        {
+            outputMap->getXY(0, col, x, y);
+            for (i = -dim; i <= dim; i++)
+                if (! gis::isOutOfGridXY(x+(i*step), inputMap.header->llCorner.y, inputMap.header))
+                {
+                    inputMap.getRowCol(x+(i*step), inputMap.header->llCorner.y, inputRow, inputCol);
+                    inputCols[unsigned(col * nrSteps + i + dim)] = inputCol;
+                }
+        }
+
+        for (int row = 0; row < outputMap->header->nrRows; row++)
+        {
+            outputMap->getXY(row, 0, x, y);
+            for (j = -dim; j <= dim; j++)
+                if (! gis::isOutOfGridXY(inputMap.header->llCorner.x, y+(j*step), inputMap.header))
+                {
+                    inputMap.getRowCol(inputMap.header->llCorner.x, y+(j*step), inputRow, inputCol);
+                    inputRows[unsigned(row * nrSteps + j + dim)] = inputRow;
+                }
+        }
+
         for (int row = 0; row < outputMap->header->nrRows ; row++)
+        {
+            const int* rowList = &(inputRows[unsigned(row * nrSteps)]);
+
             for (int col = 0; col < outputMap->header->nrCols; col++)
             {
-                /*! center */
-                outputMap->getXY(row, col, x, y);
+                const int* colList = &(inputCols[unsigned(col * nrSteps)]);
                 valuesList.resize(0);
 
-                for (i = -dim; i <= dim; i++)
-                    for (j = -dim; j <= dim; j++)
-                        if (! gis::isOutOfGridXY(x+(i*step), y+(j*step), inputMap.header))
+                for (i = 0; i < nrSteps; i++)
+                {
+                    if (colList[i] == NODATA) continue;
+
+                    for (j = 0; j < nrSteps; j++)
+                        if (rowList[j] != NODATA)
                         {
-                            inputMap.getRowCol(x+(i*step), y+(j*step), inputRow, inputCol);
-                            value = inputMap.value[inputRow][inputCol];
+                            value = inputMap.value[rowList[j]][colList[i]];
                             if (! isEqual(value, inputMap.header->flag))
                                 valuesList.push_back(value);
                         }
+                }
 
                 if (valuesList.size() == 0)
                     outputMap->value[row][col] = outputMap->header->flag;
                 else
                     outputMap->value[row][col] = prevailingValue(valuesList);
             }
+        }
 
         return true;
     }
@@ -1391,29 +1367,153 @@ namespace gis
     }
 
 
+    // interpolation of two values of the propagation, -FLT_MAX is missing
+    static inline float interpolateMaxValue(float value0, float value1, float weight)
+    {
+        if (value0 == -FLT_MAX || value1 == -FLT_MAX)
+            return MAXVALUE(value0, value1);
+
+        return value0 + (value1 - value0) * weight;
+    }
+
+
+    /*!
+     * \brief topographicDistanceMap
+     * for each cell, the maximum elevation gain along the line to myPoint (as topographicDistance).
+     * The maximum DEM value along the line is propagated outward from the cell of myPoint
+     * in a single pass, ring by ring: the line from a cell to myPoint crosses the previous ring
+     * between two cells, whose values are interpolated (as in the XDraw viewshed algorithm).
+     * If myPoint is outside the DEM, the lines are sampled cell by cell with topographicDistance
+     */
     bool topographicDistanceMap(Crit3DPoint myPoint, const gis::Crit3DRasterGrid& dem, Crit3DRasterGrid* myMap)
     {
-        int row, col;
-        float distance;
-        double gridX, gridY;
-        float demValue;
+        if (! myMap->initializeGrid(dem))
+            return false;
 
-        myMap->initializeGrid(dem);
+        int nrRows = dem.header->nrRows;
+        int nrCols = dem.header->nrCols;
+        float flag = dem.header->flag;
+        float stepMeter = float(dem.header->cellSize);
+        double x, y;
 
-        for (row = 0; row < dem.header->nrRows; row++)
-            for (col = 0; col < dem.header->nrCols; col++)
+        int pointRow, pointCol;
+        getRowColFromXY(*(dem.header), myPoint.utm.x, myPoint.utm.y, &pointRow, &pointCol);
+
+        if (isOutOfGridRowCol(pointRow, pointCol, dem))
+        {
+            for (int row = 0; row < nrRows; row++)
             {
-                demValue = dem.value[row][col];
-                if (! isEqual(demValue, dem.header->flag))
+                for (int col = 0; col < nrCols; col++)
                 {
-                    dem.getXY(row, col, gridX, gridY);
-                    distance = computeDistance(float(gridX), float(gridY), float(myPoint.utm.x), float(myPoint.utm.y));
-                    myMap->value[row][col] = topographicDistance(float(gridX), float(gridY), demValue,
-                                            float(myPoint.utm.x), float(myPoint.utm.y), float(myPoint.z), distance, dem);
+                    float demValue = dem.value[row][col];
+                    if (! isEqual(demValue, flag))
+                    {
+                        dem.getXY(row, col, x, y);
+                        float distance = computeDistance(float(x), float(y), float(myPoint.utm.x), float(myPoint.utm.y));
+                        myMap->value[row][col] = topographicDistance(float(x), float(y), demValue,
+                                                float(myPoint.utm.x), float(myPoint.utm.y), float(myPoint.z), distance, dem);
+                    }
+                }
+            }
+            return true;
+        }
+
+        // maximum DEM value along the line from each cell to myPoint (-FLT_MAX: no values)
+        std::vector<float> maxValues;
+        maxValues.resize(size_t(nrRows) * size_t(nrCols), -FLT_MAX);
+
+        auto getMaxValue = [&](int row, int col) -> float
+        {
+            if (row < 0 || row >= nrRows || col < 0 || col >= nrCols)
+                return -FLT_MAX;
+            return maxValues[size_t(row) * size_t(nrCols) + size_t(col)];
+        };
+
+        auto propagate = [&](int row, int col, int ring)
+        {
+            int dRow = row - pointRow;
+            int dCol = col - pointCol;
+            float previousValue;
+
+            if (ring == 0)
+            {
+                previousValue = -FLT_MAX;
+            }
+            else if (abs(dRow) >= abs(dCol))
+            {
+                // crossing of the previous row
+                float previousCol = float(pointCol) + float(dCol) * float(ring - 1) / float(ring);
+                int col0 = int(floor(previousCol));
+                int previousRow = row - (dRow > 0 ? 1 : -1);
+                previousValue = interpolateMaxValue(getMaxValue(previousRow, col0), getMaxValue(previousRow, col0 + 1),
+                                                    previousCol - float(col0));
+            }
+            else
+            {
+                // crossing of the previous column
+                float previousRow = float(pointRow) + float(dRow) * float(ring - 1) / float(ring);
+                int row0 = int(floor(previousRow));
+                int previousCol = col - (dCol > 0 ? 1 : -1);
+                previousValue = interpolateMaxValue(getMaxValue(row0, previousCol), getMaxValue(row0 + 1, previousCol),
+                                                    previousRow - float(row0));
+            }
+
+            float demValue = dem.value[row][col];
+            if (! isEqual(demValue, flag))
+                previousValue = MAXVALUE(previousValue, demValue);
+
+            maxValues[size_t(row) * size_t(nrCols) + size_t(col)] = previousValue;
+        };
+
+        // the point cell is the ring 0
+        int maxRing = MAXVALUE(MAXVALUE(pointRow, nrRows - 1 - pointRow), MAXVALUE(pointCol, nrCols - 1 - pointCol));
+
+        for (int ring = 0; ring <= maxRing; ring++)
+        {
+            int firstRow = MAXVALUE(pointRow - ring, 0);
+            int lastRow = MINVALUE(pointRow + ring, nrRows - 1);
+            int firstCol = MAXVALUE(pointCol - ring, 0);
+            int lastCol = MINVALUE(pointCol + ring, nrCols - 1);
+
+            for (int row = firstRow; row <= lastRow; row++)
+            {
+                if (abs(row - pointRow) == ring)
+                {
+                    for (int col = firstCol; col <= lastCol; col++)
+                        propagate(row, col, ring);
+                }
+                else
+                {
+                    if (pointCol - ring >= 0)
+                        propagate(row, pointCol - ring, ring);
+                    if (pointCol + ring < nrCols)
+                        propagate(row, pointCol + ring, ring);
+                }
+            }
+        }
+
+        for (int row = 0; row < nrRows; row++)
+        {
+            for (int col = 0; col < nrCols; col++)
+            {
+                float demValue = dem.value[row][col];
+                if (isEqual(demValue, flag))
+                    continue;
+
+                dem.getXY(row, col, x, y);
+                float distance = computeDistance(float(x), float(y), float(myPoint.utm.x), float(myPoint.utm.y));
+                if (distance < stepMeter)
+                {
+                    myMap->value[row][col] = 0;
                 }
                 else
-                    myMap->value[row][col] = myMap->header->flag;
+                {
+                    float lowerZ = MINVALUE(demValue, float(myPoint.z));
+                    float maxValue = maxValues[size_t(row) * size_t(nrCols) + size_t(col)];
+                    myMap->value[row][col] = MAXVALUE(maxValue - lowerZ, 0.f);
+                }
             }
+        }
 
         return true;
     }
@@ -17,6 +17,9 @@
         #include "statistics.h"
     #endif
 
+    // alignment (bytes) of the raster values buffer
+    #define RASTER_ALIGNMENT 64
+
     enum operationType {operationMin, operationMax, operationSum, operationSubtract, operationProduct, operationDivide};
 
     namespace gis
@@ -182,6 +185,19 @@
 
             Crit3DTime getMapTime() const;
             void setMapTime(const Crit3DTime &value);
+
+            /*!
+             * \brief contiguous storage of the grid values (row major order, nrRows * nrCols)
+             * value[row] points to the first cell of each row
+             */
+            float* data() { return dataBuffer; }
+            const float* data() const { return dataBuffer; }
+            long dataSize() const;
+
+        private:
+            float* dataBuffer;
+
+            void freeGrid();
         };
 
 
@@ -29,11 +29,13 @@ win32:{
 INCLUDEPATH += ../mathFunctions ../crit3dDate
 
 SOURCES += gis.cpp \
+    rasterKernels.cpp \
     gisIO.cpp \
     color.cpp \
     geoMap.cpp
 
 HEADERS += gis.h \
+    rasterKernels.h \
     color.h \
     gisIO.h \
     geoMap.h
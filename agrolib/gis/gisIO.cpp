@@ -335,10 +335,7 @@ namespace gis
         if (rasterGrid->header->nrBytes == 4)
         {
             // float
-            for (int row = 0; row < rasterGrid->header->nrRows; row++)
-            {
-                fread (rasterGrid->value[row], sizeof(float), unsigned(rasterGrid->header->nrCols), filePointer);
-            }
+            fread (rasterGrid->data(), sizeof(float), size_t(rasterGrid->dataSize()), filePointer);
         }
         else if (rasterGrid->header->nrBytes == 1)
         {
@@ -442,8 +439,7 @@ namespace gis
             return false;
         }
 
-        for (int myRow = 0; myRow < myGrid->header->nrRows; myRow++)
-            fwrite(myGrid->value[myRow], sizeof(float), unsigned(myGrid->header->nrCols), filePointer);
+        fwrite(myGrid->data(), sizeof(float), size_t(myGrid->dataSize()), filePointer);
 
         fclose (filePointer);
         return true;
@@ -555,8 +551,7 @@ namespace gis
         }
 
         // write grid
-        for (int row = 0; row < rasterGrid->header->nrRows; row++)
-            fwrite(rasterGrid->value[row], sizeof(float), unsigned(rasterGrid->header->nrCols), filePointer);
+        fwrite(rasterGrid->data(), sizeof(float), size_t(rasterGrid->dataSize()), filePointer);
 
         fclose (filePointer);
 
@@ -0,0 +1,338 @@
+/*!
+    \copyright 2023
+    Fausto Tomei, Gabriele Antolini, Antonio Volta
+
+    This file is part of AGROLIB distribution.
+    AGROLIB has been developed under contract issued by A.R.P.A. Emilia-Romagna
+
+    AGROLIB is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    AGROLIB is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with AGROLIB.  If not, see <http://www.gnu.org/licenses/>.
+
+    Contacts:
+    ftomei@arpae.it
+    gantolini@arpae.it
+    avolta@arpae.it
+*/
+
+#include <math.h>
+#include <float.h>
+
+#include "commonConstants.h"
+#include "basicMath.h"
+#include "rasterKernels.h"
+
+#if defined(__AVX__)
+    #include <immintrin.h>
+    #define SIMD_WIDTH 8
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define SIMD_WIDTH 4
+#else
+    #define SIMD_WIDTH 1
+#endif
+
+// isEqual(float, float) compares the float difference with EPSILON in double precision:
+// EPSILON_FLOAT is the float rounding of EPSILON, no float lies between the two
+#define EPSILON_FLOAT float(EPSILON)
+
+
+namespace
+{
+    inline bool scalarOperation(float value1, float value2, operationType operation, float &result)
+    {
+        switch (operation)
+        {
+            case operationMin:
+                result = MINVALUE(value1, value2);
+                break;
+            case operationMax:
+                result = MAXVALUE(value1, value2);
+                break;
+            case operationSum:
+                result = value1 + value2;
+                break;
+            case operationSubtract:
+                result = value1 - value2;
+                break;
+            case operationProduct:
+                result = value1 * value2;
+                break;
+            case operationDivide:
+                if (value2 == 0.f)
+                    return false;
+                result = value1 / value2;
+                break;
+        }
+
+        return true;
+    }
+
+
+#if SIMD_WIDTH == 8
+
+    typedef __m256 simdFloat;
+
+    inline simdFloat simdLoad(const float* p) { return _mm256_loadu_ps(p); }
+    inline void simdStore(float* p, simdFloat a) { _mm256_storeu_ps(p, a); }
+    inline simdFloat simdSet(float value) { return _mm256_set1_ps(value); }
+    inline simdFloat simdMin(simdFloat a, simdFloat b) { return _mm256_min_ps(a, b); }
+    inline simdFloat simdMax(simdFloat a, simdFloat b) { return _mm256_max_ps(a, b); }
+    inline simdFloat simdAdd(simdFloat a, simdFloat b) { return _mm256_add_ps(a, b); }
+    inline simdFloat simdSub(simdFloat a, simdFloat b) { return _mm256_sub_ps(a, b); }
+    inline simdFloat simdMul(simdFloat a, simdFloat b) { return _mm256_mul_ps(a, b); }
+    inline simdFloat simdDiv(simdFloat a, simdFloat b) { return _mm256_div_ps(a, b); }
+    inline simdFloat simdAnd(simdFloat a, simdFloat b) { return _mm256_and_ps(a, b); }
+    inline simdFloat simdOr(simdFloat a, simdFloat b) { return _mm256_or_ps(a, b); }
+    inline simdFloat simdAndNot(simdFloat a, simdFloat b) { return _mm256_andnot_ps(a, b); }
+    inline simdFloat simdLess(simdFloat a, simdFloat b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    inline simdFloat simdEqual(simdFloat a, simdFloat b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+    inline int simdMask(simdFloat a) { return _mm256_movemask_ps(a); }
+
+#elif SIMD_WIDTH == 4
+
+    typedef __m128 simdFloat;
+
+    inline simdFloat simdLoad(const float* p) { return _mm_loadu_ps(p); }
+    inline void simdStore(float* p, simdFloat a) { _mm_storeu_ps(p, a); }
+    inline simdFloat simdSet(float value) { return _mm_set1_ps(value); }
+    inline simdFloat simdMin(simdFloat a, simdFloat b) { return _mm_min_ps(a, b); }
+    inline simdFloat simdMax(simdFloat a, simdFloat b) { return _mm_max_ps(a, b); }
+    inline simdFloat simdAdd(simdFloat a, simdFloat b) { return _mm_add_ps(a, b); }
+    inline simdFloat simdSub(simdFloat a, simdFloat b) { return _mm_sub_ps(a, b); }
+    inline simdFloat simdMul(simdFloat a, simdFloat b) { return _mm_mul_ps(a, b); }
+    inline simdFloat simdDiv(simdFloat a, simdFloat b) { return _mm_div_ps(a, b); }
+    inline simdFloat simdAnd(simdFloat a, simdFloat b) { return _mm_and_ps(a, b); }
+    inline simdFloat simdOr(simdFloat a, simdFloat b) { return _mm_or_ps(a, b); }
+    inline simdFloat simdAndNot(simdFloat a, simdFloat b) { return _mm_andnot_ps(a, b); }
+    inline simdFloat simdLess(simdFloat a, simdFloat b) { return _mm_cmplt_ps(a, b); }
+    inline simdFloat simdEqual(simdFloat a, simdFloat b) { return _mm_cmpeq_ps(a, b); }
+    inline int simdMask(simdFloat a) { return _mm_movemask_ps(a); }
+
+#endif
+
+#if SIMD_WIDTH > 1
+
+    // select b where mask is set, a otherwise
+    inline simdFloat simdSelect(simdFloat a, simdFloat b, simdFloat mask)
+    {
+        return simdOr(simdAnd(mask, b), simdAndNot(mask, a));
+    }
+
+    // vector version of isEqual(value, flag)
+    inline simdFloat simdIsEqual(simdFloat value, simdFloat flag)
+    {
+        simdFloat absDifference = simdAndNot(simdSet(-0.f), simdSub(value, flag));
+        return simdLess(absDifference, simdSet(EPSILON_FLOAT));
+    }
+
+    inline simdFloat simdOperation(simdFloat a, simdFloat b, operationType operation)
+    {
+        switch (operation)
+        {
+            case operationMin:
+                return simdMin(a, b);
+            case operationMax:
+                return simdMax(a, b);
+            case operationSum:
+                return simdAdd(a, b);
+            case operationSubtract:
+                return simdSub(a, b);
+            case operationProduct:
+                return simdMul(a, b);
+            case operationDivide:
+                return simdDiv(a, b);
+        }
+
+        return a;
+    }
+
+#endif
+}
+
+
+namespace gis
+{
+    /*!
+     * \brief computeMinMax
+     * \return false if all values are equal to flag or NODATA
+     */
+    bool computeMinMax(const float* values, long nrValues, float flag, float &minimum, float &maximum)
+    {
+        float myMin = FLT_MAX;
+        float myMax = -FLT_MAX;
+        bool isFound = false;
+        long i = 0;
+
+    #if SIMD_WIDTH > 1
+        simdFloat vFlag = simdSet(flag);
+        simdFloat vNoData = simdSet(float(NODATA));
+        simdFloat vMin = simdSet(FLT_MAX);
+        simdFloat vMax = simdSet(-FLT_MAX);
+        simdFloat vFound = simdSet(0.f);
+
+        for (; i + SIMD_WIDTH <= nrValues; i += SIMD_WIDTH)
+        {
+            simdFloat v = simdLoad(values + i);
+            simdFloat isMissing = simdOr(simdIsEqual(v, vFlag), simdIsEqual(v, vNoData));
+            // min/max return the second operand when the first is NaN
+            vMin = simdMin(simdSelect(v, vMin, isMissing), vMin);
+            vMax = simdMax(simdSelect(v, vMax, isMissing), vMax);
+            vFound = simdOr(vFound, simdAndNot(isMissing, simdEqual(v, v)));
+        }
+
+        if (simdMask(vFound) != 0)
+        {
+            float lanes[SIMD_WIDTH];
+            isFound = true;
+            simdStore(lanes, vMin);
+            for (int k = 0; k < SIMD_WIDTH; k++)
+                myMin = MINVALUE(myMin, lanes[k]);
+            simdStore(lanes, vMax);
+            for (int k = 0; k < SIMD_WIDTH; k++)
+                myMax = MAXVALUE(myMax, lanes[k]);
+        }
+    #endif
+
+        for (; i < nrValues; i++)
+        {
+            if (! isEqual(values[i], flag) && ! isEqual(values[i], NODATA) && values[i] == values[i])
+            {
+                myMin = MINVALUE(values[i], myMin);
+                myMax = MAXVALUE(values[i], myMax);
+                isFound = true;
+            }
+        }
+
+        if (! isFound) return false;
+
+        minimum = myMin;
+        maximum = myMax;
+        return true;
+    }
+
+
+    void replaceValue(float* values, long nrValues, float oldValue, float newValue)
+    {
+        long i = 0;
+
+    #if SIMD_WIDTH > 1
+        simdFloat vOld = simdSet(oldValue);
+        simdFloat vNew = simdSet(newValue);
+
+        for (; i + SIMD_WIDTH <= nrValues; i += SIMD_WIDTH)
+        {
+            simdFloat v = simdLoad(values + i);
+            simdStore(values + i, simdSelect(v, vNew, simdIsEqual(v, vOld)));
+        }
+    #endif
+
+        for (; i < nrValues; i++)
+        {
+            if (isEqual(values[i], oldValue))
+                values[i] = newValue;
+        }
+    }
+
+
+    /*!
+     * \brief maskedOperation
+     * output = values1 (operation) values2, only where both values are valid
+     * (other cells of output are unchanged). output may be equal to values1 or values2
+     * \return false on division by zero (output is computed up to that cell)
+     */
+    bool maskedOperation(const float* values1, float flag1, const float* values2, float flag2,
+                         float* output, long nrValues, operationType operation)
+    {
+        long i = 0;
+
+    #if SIMD_WIDTH > 1
+        simdFloat vFlag1 = simdSet(flag1);
+        simdFloat vFlag2 = simdSet(flag2);
+        simdFloat vZero = simdSet(0.f);
+
+        for (; i + SIMD_WIDTH <= nrValues; i += SIMD_WIDTH)
+        {
+            simdFloat v1 = simdLoad(values1 + i);
+            simdFloat v2 = simdLoad(values2 + i);
+            simdFloat isMissing = simdOr(simdIsEqual(v1, vFlag1), simdIsEqual(v2, vFlag2));
+
+            if (operation == operationDivide && simdMask(simdAndNot(isMissing, simdEqual(v2, vZero))) != 0)
+            {
+                // division by zero: the scalar code stops at the right cell
+                break;
+            }
+
+            simdFloat result = simdOperation(v1, v2, operation);
+            simdStore(output + i, simdSelect(result, simdLoad(output + i), isMissing));
+        }
+    #endif
+
+        float result = NODATA;
+        for (; i < nrValues; i++)
+        {
+            if (! isEqual(values1[i], flag1) && ! isEqual(values2[i], flag2))
+            {
+                if (! scalarOperation(values1[i], values2[i], operation, result))
+                    return false;
+                output[i] = result;
+            }
+        }
+
+        return true;
+    }
+
+
+    /*!
+     * \brief maskedOperation
+     * output = values (operation) operand, only where values are valid
+     * \return false on division by zero
+     */
+    bool maskedOperation(const float* values, float flag, float operand,
+                         float* output, long nrValues, operationType operation)
+    {
+        long i = 0;
+
+        if (operation == operationDivide && operand == 0.f)
+        {
+            for (i = 0; i < nrValues; i++)
+                if (! isEqual(values[i], flag))
+                    return false;
+
+            return true;
+        }
+
+    #if SIMD_WIDTH > 1
+        simdFloat vFlag = simdSet(flag);
+        simdFloat vOperand = simdSet(operand);
+
+        for (; i + SIMD_WIDTH <= nrValues; i += SIMD_WIDTH)
+        {
+            simdFloat v = simdLoad(values + i);
+            simdFloat result = simdOperation(v, vOperand, operation);
+            simdStore(output + i, simdSelect(result, simdLoad(output + i), simdIsEqual(v, vFlag)));
+        }
+    #endif
+
+        float result = NODATA;
+        for (; i < nrValues; i++)
+        {
+            if (! isEqual(values[i], flag))
+            {
+                scalarOperation(values[i], operand, operation, result);
+                output[i] = result;
+            }
+        }
+
+        return true;
+    }
+}
@@ -0,0 +1,27 @@
+#ifndef RASTERKERNELS_H
+#define RASTERKERNELS_H
+
+    #ifndef GIS_H
+        #include "gis.h"
+    #endif
+
+    /*!
+     * kernels on contiguous arrays of raster values (see Crit3DRasterGrid::data)
+     * vectorized with AVX or SSE2 when available, scalar code otherwise.
+     * A value is missing when isEqual(value, flag), as in the rest of the library
+     */
+    namespace gis
+    {
+        bool computeMinMax(const float* values, long nrValues, float flag, float &minimum, float &maximum);
+
+        void replaceValue(float* values, long nrValues, float oldValue, float newValue);
+
+        bool maskedOperation(const float* values1, float flag1, const float* values2, float flag2,
+                             float* output, long nrValues, operationType operation);
+
+        bool maskedOperation(const float* values, float flag, float operand,
+                             float* output, long nrValues, operationType operation);
+    }
+
+
+#endif // RASTERKERNELS_H
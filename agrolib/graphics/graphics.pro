@@ -39,6 +39,7 @@ SOURCES += \
     mapGraphicsRasterObject.cpp \
     mapGraphicsRasterUtm.cpp \
     mapGraphicsShapeObject.cpp \
+    rasterTileCache.cpp \
     rubberBand.cpp \
     squareMarker.cpp \
     stationMarker.cpp
@@ -49,6 +50,7 @@ HEADERS += \
     mapGraphicsRasterObject.h \
     mapGraphicsRasterUtm.h \
     mapGraphicsShapeObject.h \
+    rasterTileCache.h \
     rubberBand.h \
     squareMarker.h \
     stationMarker.h
@@ -44,7 +44,11 @@ RasterObject::RasterObject(MapGraphicsView* _view, MapGraphicsObject *parent) :
 
     view = _view;
     geoMap = new gis::Crit3DGeoMap();
+    isTileRendering = true;
     this->clear();
+
+    // a redraw is requested when the values of the raster are changed
+    connect(this, &MapGraphicsObject::redrawRequested, [=](){ tileCache.invalidate(); });
 }
 
 
@@ -63,6 +67,7 @@ void RasterObject::clear()
 
     isGrid = false;
     isLatLon = false;
+    tileCache.clear();
 
     utmZone = NODATA;
     refCenterPixel = QPointF(NODATA, NODATA);
@@ -97,6 +102,17 @@ void RasterObject::setColorLegend(ColorLegend* colorLegendPtr)
     colorLegendPointer = colorLegendPtr;
 }
 
+/*!
+ * \brief setTileRendering
+ * if true (default) the rasters are drawn with cached tiles,
+ * otherwise cell by cell. Grids are always drawn cell by cell
+ */
+void RasterObject::setTileRendering(bool value)
+{
+    isTileRendering = value;
+    tileCache.clear();
+}
+
 
 /*!
 \brief convert a point in geo (lat,lon) coordinates
@@ -218,6 +234,7 @@ bool RasterObject::initializeUTM(gis::Crit3DRasterGrid* myRaster, const gis::Cri
     rasterPointer = myRaster;
 
     freeIndexesMatrix();
+    tileCache.clear();
     gis::getGeoExtentsFromUTMHeader(gisSettings, myRaster->header, &latLonHeader);
     initializeIndexesMatrix();
 
@@ -258,6 +275,7 @@ bool RasterObject::initializeLatLon(gis::Crit3DRasterGrid* myRaster, const gis::
     rasterPointer = myRaster;
 
     freeIndexesMatrix();
+    tileCache.clear();
 
     latLonHeader = latLonHeader_;
 
@@ -397,6 +415,12 @@ bool RasterObject::drawRaster(gis::Crit3DRasterGrid *myRaster, QPainter* myPaint
 
     int step = getCurrentStep(window);
 
+    if (isTileRendering && ! isGrid && longitudeShift == 0)
+    {
+        drawRasterTiles(myRaster, myPainter, window, step);
+        return true;
+    }
+
     QPointF lowerLeft;
     lowerLeft.setX(latLonHeader.llCorner.longitude + window.v[0].col * latLonHeader.dx);
     lowerLeft.setY(latLonHeader.llCorner.latitude + (latLonHeader.nrRows-1 - window.v[1].row) * latLonHeader.dy);
@@ -475,6 +499,70 @@ bool RasterObject::drawRaster(gis::Crit3DRasterGrid *myRaster, QPainter* myPaint
 }
 
 
+/*!
+ * \brief drawRasterTiles
+ * draws the tiles of the pyramid level of the current step that intersect the window
+ */
+void RasterObject::drawRasterTiles(gis::Crit3DRasterGrid *myRaster, QPainter* myPainter,
+                                   const gis::Crit3DRasterWindow& window, int step)
+{
+    tileCache.update(myRaster, latLonHeader.nrRows, latLonHeader.nrCols);
+
+    std::function<float(int, int)> getCellValue;
+    if (isLatLon)
+    {
+        getCellValue = [myRaster](int row, int col) { return myRaster->value[row][col]; };
+    }
+    else
+    {
+        getCellValue = [this, myRaster](int row, int col)
+        {
+            int r = matrix[row][col].row;
+            if (r == int(NODATA))
+                return myRaster->header->flag;
+
+            int c = matrix[row][col].col;
+            if (gis::isOutOfGridRowCol(r, c, *myRaster))
+                return myRaster->header->flag;
+
+            return myRaster->value[r][c];
+        };
+    }
+
+    int level = RasterTileCache::getLevel(step);
+    int tileCells = RASTER_TILE_SIZE << level;
+
+    int firstTileRow = std::min(window.v[0].row, window.v[1].row) / tileCells;
+    int lastTileRow = std::max(window.v[0].row, window.v[1].row) / tileCells;
+    int firstTileCol = std::min(window.v[0].col, window.v[1].col) / tileCells;
+    int lastTileCol = std::max(window.v[0].col, window.v[1].col) / tileCells;
+
+    int firstRow, firstCol, endRow, endCol;
+    QPolygonF pixelCorners(4);
+
+    for (int tileRow = firstTileRow; tileRow <= lastTileRow; tileRow++)
+    {
+        for (int tileCol = firstTileCol; tileCol <= lastTileCol; tileCol++)
+        {
+            tileCache.getTileCells(level, tileRow, tileCol, firstRow, firstCol, endRow, endCol);
+
+            double west = latLonHeader.llCorner.longitude + firstCol * latLonHeader.dx;
+            double east = latLonHeader.llCorner.longitude + endCol * latLonHeader.dx;
+            double north = latLonHeader.llCorner.latitude + (latLonHeader.nrRows - firstRow) * latLonHeader.dy;
+            double south = latLonHeader.llCorner.latitude + (latLonHeader.nrRows - endRow) * latLonHeader.dy;
+
+            pixelCorners[0] = getPixel(QPointF(west, north));
+            pixelCorners[1] = getPixel(QPointF(east, north));
+            pixelCorners[2] = getPixel(QPointF(east, south));
+            pixelCorners[3] = getPixel(QPointF(west, south));
+
+            const QImage& tile = tileCache.getTile(level, tileRow, tileCol, getCellValue);
+            tileCache.drawTile(myPainter, tile, pixelCorners);
+        }
+    }
+}
+
+
 void RasterObject::updateCenter()
 {
     if (! isDrawing) return;
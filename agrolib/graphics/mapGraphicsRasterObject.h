@@ -44,6 +44,10 @@
         #include "geoMap.h"
     #endif
 
+    #ifndef RASTERTILECACHE_H
+        #include "rasterTileCache.h"
+    #endif
+
     struct RowCol
     {
         int row;
@@ -71,6 +75,7 @@
         void setDrawing(bool value);
         void setDrawBorders(bool value);
         void setColorLegend(ColorLegend* colorLegendPtr);
+        void setTileRendering(bool value);
 
         QPointF getPixel(const QPointF &geoPoint);
 
@@ -122,14 +127,19 @@
         bool isLatLon;
         bool isDrawing;
         bool isGrid;
+        bool isTileRendering;
         int utmZone;
 
+        RasterTileCache tileCache;
+
         void freeIndexesMatrix();
         void initializeIndexesMatrix();
         void setMapExtents();
         bool getCurrentWindow(gis::Crit3DRasterWindow* window);
         int getCurrentStep(const gis::Crit3DRasterWindow& window);
         bool drawRaster(gis::Crit3DRasterGrid *myRaster, QPainter* myPainter);
+        void drawRasterTiles(gis::Crit3DRasterGrid *myRaster, QPainter* myPainter,
+                             const gis::Crit3DRasterWindow& window, int step);
 
     };
 
@@ -43,7 +43,11 @@ RasterUtmObject::RasterUtmObject(MapGraphicsView* view, MapGraphicsObject *paren
 
     _view = view;
     _geoMap = new gis::Crit3DGeoMap();
+    _isTileRendering = true;
     this->clear();
+
+    // a redraw is requested when the values of the raster are changed
+    connect(this, &MapGraphicsObject::redrawRequested, [=](){ _tileCache.invalidate(); });
 }
 
 
@@ -53,6 +57,7 @@ void RasterUtmObject::clear()
 
     _rasterPointer = nullptr;
     _colorLegendPointer = nullptr;
+    _tileCache.clear();
     isLoaded = false;
 
     _utmZone = NODATA;
@@ -84,6 +89,7 @@ bool RasterUtmObject::initialize(gis::Crit3DRasterGrid* rasterPtr, const gis::Cr
 
     _utmZone = gisSettings.utmZone;
     _rasterPointer = rasterPtr;
+    _tileCache.clear();
 
     gis::getGeoExtentsFromUTMHeader(gisSettings, _rasterPointer->header, &_latLonHeader);
     gis::Crit3DRasterHeader utmHeader = *_rasterPointer->header;
@@ -334,6 +340,12 @@ bool RasterUtmObject::drawRaster(QPainter* painter)
 
     int step = getCurrentStep(rasterWindow);
 
+    if (_isTileRendering)
+    {
+        drawRasterTiles(painter, rasterWindow, step);
+        return true;
+    }
+
     // draw
     painter->setPen(Qt::NoPen);
     QPointF geoPoint[4];
@@ -396,4 +408,46 @@ bool RasterUtmObject::drawRaster(QPainter* painter)
 }
 
 
+/*!
+ * \brief drawRasterTiles
+ * draws the tiles of the pyramid level of the current step that intersect the window.
+ * Each tile is mapped on the quadrilateral of its corners (lat lon of the UTM cells)
+ */
+void RasterUtmObject::drawRasterTiles(QPainter* painter, const gis::Crit3DRasterWindow& rasterWindow, int step)
+{
+    gis::Crit3DRasterGrid* raster = _rasterPointer;
+    _tileCache.update(raster, raster->header->nrRows, raster->header->nrCols);
+
+    std::function<float(int, int)> getCellValue = [raster](int row, int col)
+    {
+        return raster->value[row][col];
+    };
+
+    int level = RasterTileCache::getLevel(step);
+    int tileCells = RASTER_TILE_SIZE << level;
 
+    int firstTileRow = std::min(rasterWindow.v[0].row, rasterWindow.v[1].row) / tileCells;
+    int lastTileRow = std::max(rasterWindow.v[0].row, rasterWindow.v[1].row) / tileCells;
+    int firstTileCol = std::min(rasterWindow.v[0].col, rasterWindow.v[1].col) / tileCells;
+    int lastTileCol = std::max(rasterWindow.v[0].col, rasterWindow.v[1].col) / tileCells;
+
+    int firstRow, firstCol, endRow, endCol;
+    QPolygonF pixelCorners(4);
+
+    for (int tileRow = firstTileRow; tileRow <= lastTileRow; tileRow++)
+    {
+        for (int tileCol = firstTileCol; tileCol <= lastTileCol; tileCol++)
+        {
+            _tileCache.getTileCells(level, tileRow, tileCol, firstRow, firstCol, endRow, endCol);
+
+            // lat lon rasters contain the top left corner of each cell (and one extra row and column)
+            pixelCorners[0] = getPixel(QPointF(_lonRaster.value[firstRow][firstCol], _latRaster.value[firstRow][firstCol]));
+            pixelCorners[1] = getPixel(QPointF(_lonRaster.value[firstRow][endCol], _latRaster.value[firstRow][endCol]));
+            pixelCorners[2] = getPixel(QPointF(_lonRaster.value[endRow][endCol], _latRaster.value[endRow][endCol]));
+            pixelCorners[3] = getPixel(QPointF(_lonRaster.value[endRow][firstCol], _latRaster.value[endRow][firstCol]));
+
+            const QImage& tile = _tileCache.getTile(level, tileRow, tileCol, getCellValue);
+            _tileCache.drawTile(painter, tile, pixelCorners);
+        }
+    }
+}
@@ -44,6 +44,10 @@
         #include "geoMap.h"
     #endif
 
+    #ifndef RASTERTILECACHE_H
+        #include "rasterTileCache.h"
+    #endif
+
     #include <vector>
 
 
@@ -69,6 +73,7 @@
         void setDrawing(bool value) {_isDrawing = value;}
         void setColorLegend(ColorLegend* colorLegendPtr) {_colorLegendPointer = colorLegendPtr;}
         void setRaster(gis::Crit3DRasterGrid* rasterPtr) {_rasterPointer = rasterPtr;}
+        void setTileRendering(bool value) {_isTileRendering = value; _tileCache.clear();}
 
         gis::Crit3DRasterGrid* getRaster() {return _rasterPointer;}
 
@@ -110,12 +115,16 @@
         QPointF _refCenterPixel;
 
         bool _isDrawing;
+        bool _isTileRendering;
         int _utmZone;
 
+        RasterTileCache _tileCache;
+
         void setMapExtents();
         bool getCurrentWindow(gis::Crit3DRasterWindow* rasterWindow);
         int getCurrentStep(const gis::Crit3DRasterWindow& rasterWindow);
         bool drawRaster(QPainter* painter);
+        void drawRasterTiles(QPainter* painter, const gis::Crit3DRasterWindow& rasterWindow, int step);
 
     };
 
@@ -0,0 +1,255 @@
+/*!
+    \file rasterTileCache.cpp
+
+    \abstract colour-mapped tiles of a raster for the MapGraphics objects
+
+    This file is part of CRITERIA-3D distribution.
+
+    CRITERIA-3D has been developed by A.R.P.A.E. Emilia-Romagna.
+
+    \copyright
+    CRITERIA-3D is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    CRITERIA-3D is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+    You should have received a copy of the GNU Lesser General Public License
+    along with CRITERIA-3D.  If not, see <http://www.gnu.org/licenses/>.
+
+    \authors
+    Fausto Tomei ftomei@arpae.it
+    Gabriele Antolini gantolini@arpae.it
+*/
+
+
+#include "commonConstants.h"
+#include "basicMath.h"
+#include "color.h"
+#include "rasterTileCache.h"
+
+#include <algorithm>
+#include <QTransform>
+
+
+RasterTileCache::RasterTileCache()
+{
+    _raster = nullptr;
+    _nrRows = 0;
+    _nrCols = 0;
+    _colorVersion = 0;
+    _minimum = NODATA;
+    _maximum = NODATA;
+    _flag = NODATA;
+    _nrColors = 0;
+}
+
+
+void RasterTileCache::clear()
+{
+    _tiles.clear();
+    _raster = nullptr;
+    _nrRows = 0;
+    _nrCols = 0;
+}
+
+
+/*!
+ * \brief invalidate
+ * to be called when the values of the raster are changed: the tiles are discarded
+ */
+void RasterTileCache::invalidate()
+{
+    _tiles.clear();
+}
+
+
+/*!
+ * \brief update
+ * to be called before drawing: the tiles are discarded if the raster or the size
+ * of the drawn grid (nrRows x nrCols cells) are changed.
+ * A change of the colour scale only marks the images of the tiles to be recoloured
+ */
+void RasterTileCache::update(gis::Crit3DRasterGrid* raster, int nrRows, int nrCols)
+{
+    if (raster != _raster || nrRows != _nrRows || nrCols != _nrCols)
+    {
+        _tiles.clear();
+        _raster = raster;
+        _nrRows = nrRows;
+        _nrCols = nrCols;
+    }
+
+    if (isColorScaleChanged())
+    {
+        Crit3DColorScale* colorScale = _raster->colorScale;
+        _minimum = colorScale->minimum();
+        _maximum = colorScale->maximum();
+        _nrColors = colorScale->nrColors();
+        _keyColors = colorScale->keyColor;
+        _flag = _raster->header->flag;
+        _colorVersion++;
+    }
+}
+
+
+bool RasterTileCache::isColorScaleChanged() const
+{
+    Crit3DColorScale* colorScale = _raster->colorScale;
+
+    if (colorScale->minimum() != _minimum || colorScale->maximum() != _maximum
+        || colorScale->nrColors() != _nrColors || _raster->header->flag != _flag
+        || colorScale->keyColor.size() != _keyColors.size())
+        return true;
+
+    for (unsigned int i = 0; i < _keyColors.size(); i++)
+    {
+        const Crit3DColor &keyColor = colorScale->keyColor[i];
+        if (keyColor.red != _keyColors[i].red || keyColor.green != _keyColors[i].green
+            || keyColor.blue != _keyColors[i].blue)
+            return true;
+    }
+
+    return false;
+}
+
+
+/*!
+ * \brief getLevel
+ * \return the pyramid level of a drawing step: the largest power of two not greater than step
+ */
+int RasterTileCache::getLevel(int step)
+{
+    int level = 0;
+    while ((2 << level) <= step)
+        level++;
+
+    return level;
+}
+
+
+/*!
+ * \brief getTileCells
+ * cells [firstRow, endRow) x [firstCol, endCol) of the drawn grid covered by a tile
+ */
+void RasterTileCache::getTileCells(int level, int tileRow, int tileCol, int &firstRow, int &firstCol, int &endRow, int &endCol) const
+{
+    int tileCells = RASTER_TILE_SIZE << level;
+
+    firstRow = tileRow * tileCells;
+    firstCol = tileCol * tileCells;
+    endRow = std::min(firstRow + tileCells, _nrRows);
+    endCol = std::min(firstCol + tileCells, _nrCols);
+}
+
+
+/*!
+ * \brief getTile
+ * \param getValue: value of a cell of the drawn grid (flag or NODATA are transparent)
+ * \return the image of the tile: the values are sampled at the first request,
+ * the image is recoloured when the colour scale is changed
+ */
+const QImage& RasterTileCache::getTile(int level, int tileRow, int tileCol,
+                                       const std::function<float(int row, int col)> &getValue)
+{
+    uint64_t key = (uint64_t(level) << 56) | (uint64_t(unsigned(tileRow)) << 28) | uint64_t(unsigned(tileCol));
+
+    std::map<uint64_t, RasterTile>::iterator it = _tiles.find(key);
+    if (it == _tiles.end())
+    {
+        if (_tiles.size() >= RASTER_TILE_MAX_NUMBER)
+            _tiles.clear();
+
+        int firstRow, firstCol, endRow, endCol;
+        getTileCells(level, tileRow, tileCol, firstRow, firstCol, endRow, endCol);
+
+        int blockSize = 1 << level;
+        int width = (endCol - firstCol + blockSize - 1) / blockSize;
+        int height = (endRow - firstRow + blockSize - 1) / blockSize;
+
+        RasterTile &tile = _tiles[key];
+        tile.image = QImage(width, height, QImage::Format_ARGB32);
+        tile.values.resize(size_t(width) * size_t(height));
+
+        for (int i = 0; i < height; i++)
+        {
+            int row = std::min(firstRow + i * blockSize + blockSize / 2, _nrRows - 1);
+            float* line = tile.values.data() + size_t(i) * size_t(width);
+
+            for (int j = 0; j < width; j++)
+            {
+                int col = std::min(firstCol + j * blockSize + blockSize / 2, _nrCols - 1);
+                line[j] = getValue(row, col);
+            }
+        }
+
+        setColors(tile);
+        return tile.image;
+    }
+
+    RasterTile &tile = it->second;
+    if (tile.colorVersion != _colorVersion)
+        setColors(tile);
+
+    return tile.image;
+}
+
+
+/*!
+ * \brief setColors
+ * colour-maps the values of the tile with the current colour scale
+ */
+void RasterTileCache::setColors(RasterTile &tile)
+{
+    int width = tile.image.width();
+    int height = tile.image.height();
+    Crit3DColorScale* colorScale = _raster->colorScale;
+
+    for (int i = 0; i < height; i++)
+    {
+        QRgb* line = reinterpret_cast<QRgb*>(tile.image.scanLine(i));
+        const float* values = tile.values.data() + size_t(i) * size_t(width);
+
+        for (int j = 0; j < width; j++)
+        {
+            float value = values[j];
+
+            if (isEqual(value, _flag) || isEqual(value, NODATA))
+            {
+                line[j] = qRgba(0, 0, 0, 0);
+            }
+            else
+            {
+                Crit3DColor* myColor = colorScale->getColor(value);
+                line[j] = qRgb(myColor->red, myColor->green, myColor->blue);
+            }
+        }
+    }
+
+    tile.colorVersion = _colorVersion;
+}
+
+
+/*!
+ * \brief drawTile
+ * \param pixelCorners: pixel position of the top left, top right, bottom right
+ * and bottom left corners of the tile
+ */
+void RasterTileCache::drawTile(QPainter* painter, const QImage& tile, const QPolygonF &pixelCorners)
+{
+    QPolygonF imageCorners;
+    imageCorners << QPointF(0, 0) << QPointF(tile.width(), 0)
+                 << QPointF(tile.width(), tile.height()) << QPointF(0, tile.height());
+
+    QTransform transform;
+    if (! QTransform::quadToQuad(imageCorners, pixelCorners, transform))
+        return;
+
+    painter->save();
+    painter->setRenderHint(QPainter::SmoothPixmapTransform, false);
+    painter->setTransform(transform, true);
+    painter->drawImage(QPointF(0, 0), tile);
+    painter->restore();
+}
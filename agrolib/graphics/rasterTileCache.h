@@ -0,0 +1,103 @@
+/*!
+    \file rasterTileCache.h
+
+    \abstract colour-mapped tiles of a raster for the MapGraphics objects
+
+    This file is part of CRITERIA-3D distribution.
+
+    CRITERIA-3D has been developed by A.R.P.A.E. Emilia-Romagna.
+
+    \copyright
+    CRITERIA-3D is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    CRITERIA-3D is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+    You should have received a copy of the GNU Lesser General Public License
+    along with CRITERIA-3D.  If not, see <http://www.gnu.org/licenses/>.
+
+    \authors
+    Fausto Tomei ftomei@arpae.it
+    Gabriele Antolini gantolini@arpae.it
+*/
+
+#ifndef RASTERTILECACHE_H
+#define RASTERTILECACHE_H
+
+    #include <QImage>
+    #include <QPainter>
+    #include <QPolygonF>
+
+    #ifndef GIS_H
+        #include "gis.h"
+    #endif
+
+    #include <map>
+    #include <vector>
+    #include <functional>
+    #include <stdint.h>
+
+    #define RASTER_TILE_SIZE 256
+    #define RASTER_TILE_MAX_NUMBER 1024
+
+    /*!
+     * \brief The RasterTile struct
+     * values of the sampled cells and their colour-mapped image
+     */
+    struct RasterTile
+    {
+        std::vector<float> values;
+        QImage image;
+        unsigned int colorVersion;
+    };
+
+    /*!
+     * \brief The RasterTileCache class
+     * multi-resolution pyramid of tiles of a raster.
+     * At level k a tile pixel is the value of the central cell of a block of 2^k x 2^k cells,
+     * the same cell chosen by the stepped drawing with step 2^k.
+     * Tiles keep the sampled values: they are built when they are first drawn and are kept
+     * until the raster is changed or invalidate is called (values changed).
+     * The colour scale is applied when drawing, so a dynamic colour range (changed at
+     * each pan/zoom) recolours the visible tiles without sampling the raster again
+     */
+    class RasterTileCache
+    {
+    public:
+        RasterTileCache();
+
+        void clear();
+        void invalidate();
+
+        void update(gis::Crit3DRasterGrid* raster, int nrRows, int nrCols);
+
+        static int getLevel(int step);
+
+        void getTileCells(int level, int tileRow, int tileCol, int &firstRow, int &firstCol, int &endRow, int &endCol) const;
+
+        const QImage& getTile(int level, int tileRow, int tileCol,
+                              const std::function<float(int row, int col)> &getValue);
+
+        void drawTile(QPainter* painter, const QImage& tile, const QPolygonF &pixelCorners);
+
+    private:
+        gis::Crit3DRasterGrid* _raster;
+        int _nrRows, _nrCols;
+
+        std::map<uint64_t, RasterTile> _tiles;
+
+        // colour scale of the current version
+        unsigned int _colorVersion;
+        float _minimum, _maximum, _flag;
+        unsigned int _nrColors;
+        std::vector<Crit3DColor> _keyColors;
+
+        bool isColorScaleChanged() const;
+        void setColors(RasterTile &tile);
+    };
+
+
+#endif // RASTERTILECACHE_H
@@ -0,0 +1,115 @@
+/*!
+    \copyright 2016 Fausto Tomei, Gabriele Antolini,
+    Alberto Pistocchi, Marco Bittelli, Antonio Volta, Laura Costantini
+
+    This file is part of CRITERIA3D.
+    CRITERIA3D has been developed under contract issued by A.R.P.A. Emilia-Romagna
+
+    CRITERIA3D is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CRITERIA3D is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with CRITERIA3D.  If not, see <http://www.gnu.org/licenses/>.
+
+    contacts:
+    fausto.tomei@gmail.com
+    ftomei@arpae.it
+*/
+
+#include "detrendingCache.h"
+
+#define DETRENDING_CACHE_SIZE 512
+
+
+Crit3DDetrendingCache::Crit3DDetrendingCache()
+{
+    clear();
+}
+
+
+void Crit3DDetrendingCache::clear()
+{
+    stateMap.clear();
+    keyList.clear();
+    nrHits = 0;
+}
+
+
+// the key must be computed before preInterpolation, which modifies the points
+Crit3DDetrendingCache::keyType Crit3DDetrendingCache::getKey(const std::vector<Crit3DInterpolationDataPoint> &points,
+                                                             Crit3DInterpolationSettings *settings) const
+{
+    keyType key;
+
+    key.first.resize(points.size());
+    for (unsigned i = 0; i < points.size(); i++)
+        key.first[i] = points[i].index;
+
+    // weights are used only by the multiple detrending fitting
+    if (settings->getUseMultipleDetrending())
+    {
+        key.second.resize(points.size());
+        for (unsigned i = 0; i < points.size(); i++)
+            key.second[i] = points[i].regressionWeight;
+    }
+
+    return key;
+}
+
+
+bool Crit3DDetrendingCache::load(const keyType &key, std::vector<Crit3DInterpolationDataPoint> &points,
+                                 Crit3DInterpolationSettings *settings) const
+{
+    std::map<keyType, detrendingState>::const_iterator it = stateMap.find(key);
+    if (it == stateMap.end())
+        return false;
+
+    const detrendingState &state = it->second;
+
+    points = state.points;
+    settings->setCurrentProxy(state.proxy);
+    settings->setCurrentCombination(state.currentCombination);
+    settings->setOptimalCombination(state.optimalCombination);
+    settings->setFittingParameters(state.fittingParameters);
+    settings->setFittingFunction(state.fittingFunction);
+    settings->setPrecipitationAllZero(state.precipitationAllZero);
+    settings->setTopoDist_Kh(state.topoDist_Kh);
+
+    nrHits++;
+    return true;
+}
+
+
+void Crit3DDetrendingCache::store(const keyType &key, const std::vector<Crit3DInterpolationDataPoint> &points,
+                                  Crit3DInterpolationSettings *settings)
+{
+    if (stateMap.find(key) != stateMap.end())
+        return;
+
+    // remove the oldest
+    if (keyList.size() >= DETRENDING_CACHE_SIZE)
+    {
+        stateMap.erase(keyList.front());
+        keyList.pop_front();
+    }
+
+    detrendingState &state = stateMap[key];
+
+    state.points = points;
+    state.proxy = settings->getCurrentProxy();
+    state.currentCombination = settings->getCurrentCombination();
+    state.optimalCombination = settings->getOptimalCombination();
+    state.fittingParameters = settings->getFittingParameters();
+    state.fittingFunction = settings->getFittingFunction();
+    state.precipitationAllZero = settings->getPrecipitationAllZero();
+    state.topoDist_Kh = settings->getTopoDist_Kh();
+
+    keyList.push_back(key);
+}
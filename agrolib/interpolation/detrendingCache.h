@@ -0,0 +1,55 @@
+#ifndef DETRENDINGCACHE_H
+#define DETRENDINGCACHE_H
+
+    #ifndef INTERPOLATIONSETTINGS_H
+        #include "interpolationSettings.h"
+    #endif
+    #ifndef INTERPOLATIONPOINT_H
+        #include "interpolationPoint.h"
+    #endif
+
+    #include <map>
+    #include <deque>
+
+    /*!
+     * \brief cache of local detrending results (see localSelection and preInterpolation)
+     * adjacent cells usually select the same points: the detrended points and the
+     * regression parameters are stored once for each selection and reused.
+     * The key is the list of meteo point indexes, plus the regression weights
+     * when they are used by the fitting (multiple detrending)
+     */
+    class Crit3DDetrendingCache
+    {
+    public:
+        typedef std::pair<std::vector<int>, std::vector<float>> keyType;
+
+        Crit3DDetrendingCache();
+
+        void clear();
+
+        keyType getKey(const std::vector<Crit3DInterpolationDataPoint> &points, Crit3DInterpolationSettings *settings) const;
+        bool load(const keyType &key, std::vector<Crit3DInterpolationDataPoint> &points, Crit3DInterpolationSettings *settings) const;
+        void store(const keyType &key, const std::vector<Crit3DInterpolationDataPoint> &points, Crit3DInterpolationSettings *settings);
+
+        unsigned long getNrHits() const { return nrHits; }
+
+    private:
+        struct detrendingState
+        {
+            std::vector<Crit3DInterpolationDataPoint> points;
+            std::vector<Crit3DProxy> proxy;
+            Crit3DProxyCombination currentCombination;
+            Crit3DProxyCombination optimalCombination;
+            std::vector<std::vector<double>> fittingParameters;
+            std::vector<std::function<double(double, std::vector<double>&)>> fittingFunction;
+            bool precipitationAllZero;
+            int topoDist_Kh;
+        };
+
+        std::map<keyType, detrendingState> stateMap;
+        std::deque<keyType> keyList;
+        mutable unsigned long nrHits;
+    };
+
+
+#endif // DETRENDINGCACHE_H
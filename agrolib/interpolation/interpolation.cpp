@@ -39,6 +39,7 @@
 #include "interpolationPoint.h"
 #include "interpolation.h"
 #include "interpolationSettings.h"
+#include "spatialIndex.h"
 
 #include <functional>
 
@@ -114,76 +115,89 @@ float getProxyMinValue(std::vector<Crit3DInterpolationDataPoint> &myPoints, unsi
     return minValue;
 }
 
+// sort the candidates (indexes of myPoints) by distance and keep the first maxIndex
+// equal distances are kept in index order
+static unsigned sortIndexByDistance(unsigned maxIndex, const std::vector<Crit3DInterpolationDataPoint> &myPoints,
+                                    std::vector<unsigned> &candidates)
+{
+    unsigned nrSorted = MINVALUE(maxIndex, unsigned(candidates.size()));
+
+    std::partial_sort(candidates.begin(), candidates.begin() + nrSorted, candidates.end(),
+                      [&myPoints](unsigned a, unsigned b)
+                      {
+                          if (myPoints[a].distance != myPoints[b].distance)
+                              return myPoints[a].distance < myPoints[b].distance;
+                          return a < b;
+                      });
+
+    candidates.resize(nrSorted);
+    return nrSorted;
+}
+
+
 unsigned sortPointsByDistance(unsigned maxIndex, std::vector<Crit3DInterpolationDataPoint> &myPoints, std::vector<Crit3DInterpolationDataPoint> &myValidPoints)
 {
     if (myPoints.size() == 0) return 0;
 
-    unsigned i, first, index, outIndex;
-    float min_value = NODATA;
-    std::vector<unsigned> indici_ordinati;
-    std::vector<unsigned> indice_minimo;
+    std::vector<unsigned> candidates;
+    for (unsigned i = 0; i < myPoints.size(); i++)
+        if (myPoints[i].isActive && myPoints[i].distance > 0)
+            candidates.push_back(i);
+
+    unsigned outIndex = sortIndexByDistance(maxIndex, myPoints, candidates);
 
-    indici_ordinati.resize(maxIndex);
-    indice_minimo.resize(myPoints.size());
+    myValidPoints.clear();
+    for (unsigned i = 0; i < outIndex; i++)
+        myValidPoints.push_back(myPoints[candidates[i]]);
 
-    first = 0;
-    index = 0;
+    return outIndex;
+}
 
-    bool exit = false;
 
-    while (index < maxIndex && !exit)
+// as sortPointsByDistance, searching the neighbours of (x, y) with the spatial index
+// (isIndexValid: the index was built on myPoints, see Crit3DSpatialIndex::isValid)
+// distance of points (also topographic) is never lower than the euclidean one,
+// so all points outside the search radius are farther than the ones found
+static unsigned sortNearestPoints(unsigned maxIndex, std::vector<Crit3DInterpolationDataPoint> &myPoints,
+                                  Crit3DInterpolationSettings* mySettings, bool isIndexValid, float x, float y,
+                                  float firstRadius, std::vector<Crit3DInterpolationDataPoint> &myValidPoints)
+{
+    if (maxIndex == 0 || ! isIndexValid)
+        return sortPointsByDistance(maxIndex, myPoints, myValidPoints);
+
+    Crit3DSpatialIndex* pointsIndex = mySettings->getPointsIndex();
+
+    float maxDistance = pointsIndex->getMaxDistance(x, y);
+    float radius = MAXVALUE(firstRadius, float(EPSILON));
+    std::vector<unsigned> candidates;
+    unsigned outIndex;
+
+    while (true)
     {
-        if (first == 0)
-        {
-            i = 0;
-            while ((! myPoints[i].isActive || (isEqual(myPoints[i].distance, 0))) && (i < myPoints.size()-1))
-                i++;
+        pointsIndex->getPointsInRadius(x, y, radius, candidates);
 
-            if (i == (myPoints.size()-1) && ! myPoints[i].isActive)
-                exit=true;
-            else
-            {
-                first = 1;
-                indice_minimo[first-1] = i;
-                min_value = myPoints[i].distance;
-            }
-        }
-        else
-            min_value = myPoints[unsigned(indice_minimo[first-1])].distance;
+        unsigned nrCandidates = 0;
+        for (unsigned i = 0; i < candidates.size(); i++)
+            if (myPoints[candidates[i]].isActive && myPoints[candidates[i]].distance > 0)
+                candidates[nrCandidates++] = candidates[i];
+        candidates.resize(nrCandidates);
 
-        if (!exit)
-        {
-            for (i = unsigned(indice_minimo[first-1]) + 1; i < myPoints.size(); i++)
-                if (isEqual(min_value, NODATA) || myPoints[i].distance < min_value)
-                    if (myPoints[i].isActive)
-                        if (myPoints[i].distance > 0)
-                        {
-                            first++;
-                            min_value = myPoints[i].distance;
-                            indice_minimo[first-1] = i;
-                        }
+        outIndex = sortIndexByDistance(maxIndex, myPoints, candidates);
 
-            indici_ordinati[index] = indice_minimo[first-1];
-            myPoints[indice_minimo[first-1]].isActive = false;
-            index++;
-            first--;
-        }
+        if (radius >= maxDistance || (outIndex == maxIndex && myPoints[candidates[outIndex-1]].distance <= radius))
+            break;
+
+        radius *= 2;
     }
 
-    outIndex = MINVALUE(index, maxIndex);
     myValidPoints.clear();
+    for (unsigned i = 0; i < outIndex; i++)
+        myValidPoints.push_back(myPoints[candidates[i]]);
 
-    for (i=0; i < outIndex; i++)
-    {
-        myPoints[indici_ordinati[i]].isActive = true;
-        myValidPoints.push_back(myPoints[indici_ordinati[i]]);
-    }
-
-    indici_ordinati.clear();
-    indice_minimo.clear();
     return outIndex;
 }
 
+
 void computeDistances(meteoVariable myVar, vector <Crit3DInterpolationDataPoint> &myPoints,  Crit3DInterpolationSettings* mySettings,
                       float x, float y, float z, bool excludeSupplemental)
 {
@@ -773,7 +787,7 @@ float computeShepardInitialRadius(float area, unsigned int allPointsNr, unsigned
 }
 
 float shepardSearchNeighbour(vector <Crit3DInterpolationDataPoint> &inputPoints,
-                             Crit3DInterpolationSettings* settings,
+                             Crit3DInterpolationSettings* settings, bool isIndexValid, float x, float y,
                              vector <Crit3DInterpolationDataPoint> &outputPoints)
 {
     std::vector <Crit3DInterpolationDataPoint> shepardNeighbourPoints;
@@ -783,8 +797,23 @@ float shepardSearchNeighbour(vector <Crit3DInterpolationDataPoint> &inputPoints,
     unsigned int nrValid = 0;
     float shepardInitialRadius = computeShepardInitialRadius(settings->getPointsBoundingBoxArea(), unsigned(inputPoints.size()), SHEPARD_AVG_NRPOINTS);
 
+    // candidates inside initial radius (all points if the spatial index is not valid)
+    std::vector <unsigned> candidates;
+    if (isIndexValid)
+    {
+        settings->getPointsIndex()->getPointsInRadius(x, y, shepardInitialRadius, candidates);
+    }
+    else
+    {
+        candidates.resize(inputPoints.size());
+        for (i=0; i < inputPoints.size(); i++)
+            candidates[i] = i;
+    }
+
     // define a first neighborhood inside initial radius
-    for (i=0; i < inputPoints.size(); i++)
+    for (unsigned j=0; j < candidates.size(); j++)
+    {
+        i = candidates[j];
         if (inputPoints[i].distance <= shepardInitialRadius &&
             inputPoints[i].distance > 0 &&
             inputPoints[i].index != settings->getIndexPointCV())
@@ -792,10 +821,12 @@ float shepardSearchNeighbour(vector <Crit3DInterpolationDataPoint> &inputPoints,
             shepardNeighbourPoints.push_back(inputPoints[i]);
             nrValid++;
         }
+    }
 
     if (shepardNeighbourPoints.size() <= SHEPARD_MIN_NRPOINTS)
     {
-        nrValid = sortPointsByDistance(SHEPARD_MIN_NRPOINTS + 1, inputPoints, outputPoints);
+        nrValid = sortNearestPoints(SHEPARD_MIN_NRPOINTS + 1, inputPoints, settings, isIndexValid,
+                                    x, y, shepardInitialRadius * 2, outputPoints);
         if (nrValid > SHEPARD_MIN_NRPOINTS)
         {
             radius = outputPoints[SHEPARD_MIN_NRPOINTS].distance;
@@ -819,11 +850,12 @@ float shepardSearchNeighbour(vector <Crit3DInterpolationDataPoint> &inputPoints,
     return radius;
 }
 
-float shepardIdw(vector <Crit3DInterpolationDataPoint> &myPoints, Crit3DInterpolationSettings* settings, float X, float Y)
+float shepardIdw(vector <Crit3DInterpolationDataPoint> &myPoints, Crit3DInterpolationSettings* settings,
+                 bool isIndexValid, float X, float Y)
 {
     std::vector <Crit3DInterpolationDataPoint> shepardValidPoints;
 
-    float radius = shepardSearchNeighbour(myPoints, settings, shepardValidPoints);
+    float radius = shepardSearchNeighbour(myPoints, settings, isIndexValid, X, Y, shepardValidPoints);
 
     unsigned int i, j;
     float weightSum, radius_27_4, radius_3, tmp, cosine, result;
@@ -891,7 +923,7 @@ float shepardIdw(vector <Crit3DInterpolationDataPoint> &myPoints, Crit3DInterpol
 
 
 float modifiedShepardIdw(vector <Crit3DInterpolationDataPoint> &myPoints,
-                         Crit3DInterpolationSettings* settings, float radius, float X, float Y)
+                         Crit3DInterpolationSettings* settings, bool isIndexValid, float radius, float X, float Y)
 {
     unsigned int i;
 
@@ -901,7 +933,7 @@ float modifiedShepardIdw(vector <Crit3DInterpolationDataPoint> &myPoints,
     std::vector <Crit3DInterpolationDataPoint> validPoints;
 
     if (radius == NODATA)
-        radius = shepardSearchNeighbour(myPoints, settings, validPoints);
+        radius = shepardSearchNeighbour(myPoints, settings, isIndexValid, X, Y, validPoints);
     else
         validPoints = myPoints;
 
@@ -1012,40 +1044,84 @@ float gaussWeighted(vector <Crit3DInterpolationDataPoint> &myPointList)
 */
 
 // TODO elevation std dev?
+// points are selected in rings of stepRadius until minPoints are found
+// isIndexValid: the spatial index was built on inputPoints (checked by the caller once for all the cells)
 void localSelection(vector <Crit3DInterpolationDataPoint> &inputPoints, vector <Crit3DInterpolationDataPoint> &selectedPoints,
-                    float x, float y, Crit3DInterpolationSettings& mySettings)
+                    float x, float y, Crit3DInterpolationSettings& mySettings, bool isIndexValid)
 {
     // search more stations to assure min points with all valid proxies
     float ratioMinPoints = float(1.2);
     unsigned minPoints = unsigned(mySettings.getMinPointsLocalDetrending() * ratioMinPoints);
-    if (inputPoints.size() <= minPoints)
+    float stepRadius = 5000;           // [m]
+    unsigned i, j;
+
+    // candidate points: the search radius is a multiple of stepRadius,
+    // so it contains all the rings needed (all points if the spatial index is not valid)
+    std::vector <unsigned> candidates;
+    if (isIndexValid)
     {
-        selectedPoints = inputPoints;
-        mySettings.setLocalRadius(computeShepardInitialRadius(mySettings.getPointsBoundingBoxArea(),
-                                                              unsigned(inputPoints.size()), minPoints));
-    }
+        Crit3DSpatialIndex* pointsIndex = mySettings.getPointsIndex();
+        float maxDistance = pointsIndex->getMaxDistance(x, y);
+        float searchRadius = stepRadius;
+        unsigned nrValid;
+        while (true)
+        {
+            pointsIndex->getPointsInRadius(x, y, searchRadius, candidates);
 
-    for (unsigned long i = 0; i < inputPoints.size() ; i++)
-        inputPoints[i].distance = gis::computeDistance(x, y, float((inputPoints[i]).point->utm.x), float((inputPoints[i]).point->utm.y));
+            nrValid = 0;
+            for (j=0; j < candidates.size(); j++)
+                if (pointsIndex->getPointDistance(candidates[j], x, y) > 0)
+                    nrValid++;
 
-    unsigned int nrValid = 0;
-    float stepRadius = 5000;           // [m]
-    float r0 = 0;                       // [m]
-    float r1 = stepRadius;              // [m]
-    unsigned int i;
+            if (nrValid >= minPoints || searchRadius >= maxDistance)
+                break;
 
-    while (nrValid < minPoints)
+            searchRadius *= 2;
+        }
+    }
+    else
     {
+        candidates.resize(inputPoints.size());
         for (i=0; i < inputPoints.size(); i++)
-            if (inputPoints[i].distance != NODATA && inputPoints[i].distance > r0 && inputPoints[i].distance <= r1)
-            {
-                selectedPoints.push_back(inputPoints[i]);
-                nrValid++;
-            }
-        r0 = r1;
-        r1 += stepRadius;
+            candidates[i] = i;
     }
 
+    // valid points as (ring number, point index)
+    // ring number: (ring-1) * stepRadius < distance <= ring * stepRadius
+    std::vector <std::pair<unsigned, unsigned>> validPoints;
+    validPoints.reserve(candidates.size());
+    for (j=0; j < candidates.size(); j++)
+    {
+        i = candidates[j];
+        inputPoints[i].distance = gis::computeDistance(x, y, float((inputPoints[i]).point->utm.x), float((inputPoints[i]).point->utm.y));
+
+        if (inputPoints[i].distance > 0)
+        {
+            unsigned k = unsigned(ceil(inputPoints[i].distance / stepRadius));
+            while (float(k) * stepRadius < inputPoints[i].distance)
+                k++;
+            while (k > 1 && float(k-1) * stepRadius >= inputPoints[i].distance)
+                k--;
+
+            validPoints.push_back(std::make_pair(k, i));
+        }
+    }
+
+    std::stable_sort(validPoints.begin(), validPoints.end(),
+                     [](const std::pair<unsigned, unsigned> &a, const std::pair<unsigned, unsigned> &b)
+                     { return a.first < b.first; });
+
+    // last ring: the one containing the minPoints-th point (or the farthest point)
+    unsigned lastRing = 0;
+    if (minPoints > 0 && ! validPoints.empty())
+        lastRing = validPoints[MINVALUE(minPoints, unsigned(validPoints.size())) - 1].first;
+
+    selectedPoints.clear();
+    for (j=0; j < validPoints.size() && validPoints[j].first <= lastRing; j++)
+        selectedPoints.push_back(inputPoints[validPoints[j].second]);
+
+    float r1 = float(lastRing + 1) * stepRadius;
+
     for (i=0; i < selectedPoints.size(); i++)
         selectedPoints[i].regressionWeight = (1 - selectedPoints[i].distance / r1);
         //selectedPoints[i].regressionWeight = 1;
@@ -1694,9 +1770,28 @@ bool preInterpolation(std::vector <Crit3DInterpolationDataPoint> &myPoints, Crit
 }
 
 
+// local detrending: the result of preInterpolation is reused for cells with the same selected points
+bool preInterpolation(std::vector <Crit3DInterpolationDataPoint> &myPoints, Crit3DInterpolationSettings* mySettings, Crit3DMeteoSettings* meteoSettings,
+                      Crit3DClimateParameters* myClimate, Crit3DMeteoPoint* myMeteoPoints, int nrMeteoPoints,
+                      meteoVariable myVar, Crit3DTime myTime, std::string &errorStr, Crit3DDetrendingCache &detrendingCache)
+{
+    Crit3DDetrendingCache::keyType key = detrendingCache.getKey(myPoints, mySettings);
+
+    if (detrendingCache.load(key, myPoints, mySettings))
+        return true;
+
+    if (! preInterpolation(myPoints, mySettings, meteoSettings, myClimate, myMeteoPoints, nrMeteoPoints, myVar, myTime, errorStr))
+        return false;
+
+    detrendingCache.store(key, myPoints, mySettings);
+    return true;
+}
+
+
+// isIndexValid: the spatial index was built on myPoints (checked by the caller once for all the cells)
 float interpolate(vector <Crit3DInterpolationDataPoint> &myPoints, Crit3DInterpolationSettings* mySettings, Crit3DMeteoSettings* meteoSettings,
                   meteoVariable myVar, float myX, float myY, float myZ, std::vector <double> myProxyValues,
-                  bool excludeSupplemental)
+                  bool excludeSupplemental, bool isIndexValid)
 
 {
     if ((myVar == precipitation || myVar == dailyPrecipitation) && mySettings->getPrecipitationAllZero())
@@ -1711,12 +1806,12 @@ float interpolate(vector <Crit3DInterpolationDataPoint> &myPoints, Crit3DInterpo
     //else if (mySettings->getInterpolationMethod() == kriging)
     //    myResult = NODATA;  //TODO
     else if (mySettings->getInterpolationMethod() == shepard)
-        myResult = shepardIdw(myPoints, mySettings, myX, myY);
+        myResult = shepardIdw(myPoints, mySettings, isIndexValid, myX, myY);
     else if (mySettings->getInterpolationMethod() == shepard_modified)
     {
         float radius = NODATA;
         if (mySettings->getUseLocalDetrending()) radius = mySettings->getLocalRadius();
-        myResult = modifiedShepardIdw(myPoints, mySettings, radius, myX, myY);
+        myResult = modifiedShepardIdw(myPoints, mySettings, isIndexValid, radius, myX, myY);
     }
 
     if (int(myResult) != int(NODATA))
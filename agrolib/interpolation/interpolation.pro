@@ -30,12 +30,16 @@ SOURCES += interpolation.cpp \
     interpolationSettings.cpp \
     interpolationPoint.cpp \
     kriging.cpp \
-    spatialControl.cpp
+    spatialControl.cpp \
+    spatialIndex.cpp \
+    detrendingCache.cpp
 
 HEADERS += interpolation.h \
     interpolationSettings.h \
     interpolationPoint.h \
     kriging.h \
     interpolationConstants.h \
-    spatialControl.h
+    spatialControl.h \
+    spatialIndex.h \
+    detrendingCache.h
 
@@ -119,6 +119,16 @@ void Crit3DInterpolationSettings::setTopoDist_Kh(int value)
     topoDist_Kh = value;
 }
 
+int Crit3DInterpolationSettings::getTopoDist_mapFactor() const
+{
+    return topoDist_mapFactor;
+}
+
+void Crit3DInterpolationSettings::setTopoDist_mapFactor(int value)
+{
+    topoDist_mapFactor = MAXVALUE(value, 1);
+}
+
 Crit3DProxyCombination Crit3DInterpolationSettings::getOptimalCombination() const
 {
     return optimalCombination;
@@ -276,6 +286,16 @@ void Crit3DInterpolationSettings::setMinPointsLocalDetrending(int newMinPointsLo
     minPointsLocalDetrending = newMinPointsLocalDetrending;
 }
 
+int Crit3DInterpolationSettings::getNrThreads() const
+{
+    return nrThreads;
+}
+
+void Crit3DInterpolationSettings::setNrThreads(int newNrThreads)
+{
+    nrThreads = newNrThreads;
+}
+
 std::vector<std::vector<double> > Crit3DInterpolationSettings::getFittingParameters() const
 {
     return fittingParameters;
@@ -320,6 +340,7 @@ void Crit3DInterpolationSettings::initialize()
     useTD = false;
     useLocalDetrending = false;
     topoDist_maxKh = 128;
+    topoDist_mapFactor = 1;
     useDewPoint = true;
     useInterpolatedTForRH = true;
     useMultipleDetrending = false;
@@ -335,9 +356,11 @@ void Crit3DInterpolationSettings::initialize()
     maxHeightInversion = 1000.;
     indexPointCV = NODATA;
     minPointsLocalDetrending = 20;
+    nrThreads = 1;
 
     Kh_series.clear();
     Kh_error_series.clear();
+    pointsIndex.clear();
 
     initializeProxy();
 }
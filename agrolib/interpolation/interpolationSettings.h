@@ -14,6 +14,9 @@
     #ifndef METEOGRID_H
         #include "meteoGrid.h"
     #endif
+    #ifndef SPATIALINDEX_H
+        #include "spatialIndex.h"
+    #endif
 
     #include <deque>
 
@@ -138,6 +141,7 @@
         bool useDewPoint;
         bool useInterpolatedTForRH;
         int minPointsLocalDetrending;
+        int nrThreads;
         bool meteoGridUpscaleFromDem;
         aggregationMethod meteoGridAggrMethod;
 
@@ -145,9 +149,11 @@
         bool precipitationAllZero;
         float maxHeightInversion;
         float pointsBoundingBoxArea;
+        Crit3DSpatialIndex pointsIndex;
         float localRadius;
         int indexPointCV;
         int topoDist_maxKh, topoDist_Kh;
+        int topoDist_mapFactor;                 // cell size of the maps = DEM cell size * factor
         std::vector <float> Kh_series;
         std::vector <float> Kh_error_series;
 
@@ -212,6 +218,8 @@
         void setTopoDist_maxKh(int value);
         int getTopoDist_Kh() const;
         void setTopoDist_Kh(int value);
+        int getTopoDist_mapFactor() const;
+        void setTopoDist_mapFactor(int value);
         Crit3DProxyCombination getOptimalCombination() const;
         void setOptimalCombination(const Crit3DProxyCombination &value);
         Crit3DProxyCombination getSelectedCombination() const;
@@ -239,10 +247,13 @@
         void setUseMultipleDetrending(bool newUseMultipleDetrending);
         float getPointsBoundingBoxArea() const;
         void setPointsBoundingBoxArea(float newPointsBoundingBoxArea);
+        Crit3DSpatialIndex* getPointsIndex() { return &pointsIndex; }
         float getLocalRadius() const;
         void setLocalRadius(float newLocalRadius);
         int getMinPointsLocalDetrending() const;
         void setMinPointsLocalDetrending(int newMinPointsLocalDetrending);
+        int getNrThreads() const;
+        void setNrThreads(int newNrThreads);
         std::vector<std::vector <double>> getFittingParameters() const;
         void setFittingParameters(const std::vector<std::vector <double>> &newFittingParameters);
         std::vector<std::function<double (double, std::vector<double> &)> > getFittingFunction() const;
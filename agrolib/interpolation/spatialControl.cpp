@@ -89,6 +89,7 @@ bool computeResiduals(meteoVariable myVar, Crit3DMeteoPoint* meteoPoints, int nr
     myValue = NODATA;
     std::vector <double> myProxyValues;
     bool isValid;
+    bool isIndexValid = settings->getPointsIndex()->isValid(interpolationPoints);
 
     for (int i = 0; i < nrMeteoPoints; i++)
     {
@@ -107,7 +108,7 @@ bool computeResiduals(meteoVariable myVar, Crit3DMeteoPoint* meteoPoints, int nr
                                             float(meteoPoints[i].point.utm.x),
                                             float(meteoPoints[i].point.utm.y),
                                             float(meteoPoints[i].point.z),
-                                            myProxyValues, false);
+                                            myProxyValues, false, isIndexValid);
 
             if (  myVar == precipitation
                || myVar == dailyPrecipitation)
@@ -213,6 +214,7 @@ bool spatialQualityControl(meteoVariable myVar, Crit3DMeteoPoint* meteoPoints, i
                 }
 
                 float interpolatedValue;
+                bool isIndexValid = settings->getPointsIndex()->isValid(myInterpolationPoints);
                 for (i=0; i < int(listIndex.size()); i++)
                 {
                     interpolatedValue = interpolate(myInterpolationPoints, settings, meteoSettings, myVar,
@@ -220,7 +222,7 @@ bool spatialQualityControl(meteoVariable myVar, Crit3DMeteoPoint* meteoPoints, i
                                             float(meteoPoints[listIndex[i]].point.utm.y),
                                             float(meteoPoints[listIndex[i]].point.z),
                                             meteoPoints[i].getProxyValues(),
-                                            false);
+                                            false, isIndexValid);
 
                     myValue = meteoPoints[listIndex[i]].currentValue;
 
@@ -380,6 +382,8 @@ bool passDataToInterpolation(Crit3DMeteoPoint* meteoPoints, int nrMeteoPoints,
         }
     }
 
+    mySettings->getPointsIndex()->build(myInterpolationPoints);
+
     if (nrValid > 0)
     {
         mySettings->setPointsBoundingBoxArea((xMax - xMin) * (yMax - yMin));
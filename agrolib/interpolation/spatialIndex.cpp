@@ -0,0 +1,203 @@
+/*!
+    \copyright 2016 Fausto Tomei, Gabriele Antolini,
+    Alberto Pistocchi, Marco Bittelli, Antonio Volta, Laura Costantini
+
+    This file is part of CRITERIA3D.
+    CRITERIA3D has been developed under contract issued by A.R.P.A. Emilia-Romagna
+
+    CRITERIA3D is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CRITERIA3D is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with CRITERIA3D.  If not, see <http://www.gnu.org/licenses/>.
+
+    contacts:
+    fausto.tomei@gmail.com
+    ftomei@arpae.it
+*/
+
+#include <math.h>
+#include <algorithm>
+
+#include "commonConstants.h"
+#include "gis.h"
+#include "interpolationPoint.h"
+#include "spatialIndex.h"
+
+#define INDEX_MIN_CELLSIZE 1000.
+#define INDEX_POINTS_PER_CELL 2.
+
+
+Crit3DSpatialIndex::Crit3DSpatialIndex()
+{
+    clear();
+}
+
+
+void Crit3DSpatialIndex::clear()
+{
+    xMin = 0;
+    yMin = 0;
+    cellSize = INDEX_MIN_CELLSIZE;
+    nrRows = 0;
+    nrCols = 0;
+
+    cellFirst.clear();
+    pointIndex.clear();
+    pointX.clear();
+    pointY.clear();
+    pointId.clear();
+}
+
+
+void Crit3DSpatialIndex::getCell(double x, double y, int &row, int &col) const
+{
+    row = int(floor((y - yMin) / cellSize));
+    col = int(floor((x - xMin) / cellSize));
+}
+
+
+void Crit3DSpatialIndex::build(const std::vector<Crit3DInterpolationDataPoint> &points)
+{
+    clear();
+
+    unsigned nrPoints = unsigned(points.size());
+    if (nrPoints == 0) return;
+
+    // coordinates are stored in single precision, as used by computeDistances
+    pointX.resize(nrPoints);
+    pointY.resize(nrPoints);
+    pointId.resize(nrPoints);
+
+    double xMax, yMax;
+    for (unsigned i = 0; i < nrPoints; i++)
+    {
+        pointX[i] = float(points[i].point->utm.x);
+        pointY[i] = float(points[i].point->utm.y);
+        pointId[i] = points[i].point;
+
+        if (i == 0)
+        {
+            xMin = xMax = pointX[i];
+            yMin = yMax = pointY[i];
+        }
+        else
+        {
+            xMin = std::min(xMin, double(pointX[i]));
+            xMax = std::max(xMax, double(pointX[i]));
+            yMin = std::min(yMin, double(pointY[i]));
+            yMax = std::max(yMax, double(pointY[i]));
+        }
+    }
+
+    // about INDEX_POINTS_PER_CELL points for each cell
+    double area = (xMax - xMin) * (yMax - yMin);
+    cellSize = std::max(INDEX_MIN_CELLSIZE, sqrt(area * INDEX_POINTS_PER_CELL / nrPoints));
+    nrRows = int(floor((yMax - yMin) / cellSize)) + 1;
+    nrCols = int(floor((xMax - xMin) / cellSize)) + 1;
+
+    std::vector<unsigned> pointCell(nrPoints);
+    cellFirst.assign(unsigned(nrRows * nrCols) + 1, 0);
+
+    int row, col;
+    for (unsigned i = 0; i < nrPoints; i++)
+    {
+        getCell(pointX[i], pointY[i], row, col);
+        pointCell[i] = unsigned(row * nrCols + col);
+        cellFirst[pointCell[i] + 1]++;
+    }
+
+    for (unsigned c = 0; c < unsigned(nrRows * nrCols); c++)
+        cellFirst[c + 1] += cellFirst[c];
+
+    // points of each cell in increasing index order
+    pointIndex.resize(nrPoints);
+    std::vector<unsigned> cellPos(cellFirst.begin(), cellFirst.end() - 1);
+    for (unsigned i = 0; i < nrPoints; i++)
+        pointIndex[cellPos[pointCell[i]]++] = i;
+}
+
+
+/*!
+ * \brief isValid
+ * \return true if the index was built on the same points, in the same order
+ * (copies of the vector share the same gis::Crit3DPoint pointers)
+ * it scans all the points: check it once for each set of points (e.g. before the loop on the cells),
+ * and not for each query
+ */
+bool Crit3DSpatialIndex::isValid(const std::vector<Crit3DInterpolationDataPoint> &points) const
+{
+    if (pointIndex.empty() || points.size() != pointId.size())
+        return false;
+
+    for (unsigned i = 0; i < points.size(); i++)
+        if (points[i].point != pointId[i])
+            return false;
+
+    return true;
+}
+
+
+float Crit3DSpatialIndex::getPointDistance(unsigned index, float x, float y) const
+{
+    return gis::computeDistance(x, y, pointX[index], pointY[index]);
+}
+
+
+/*!
+ * \brief getPointsInRadius
+ * indexList: points with distance from (x, y) <= radius, in increasing index order
+ */
+void Crit3DSpatialIndex::getPointsInRadius(float x, float y, float radius, std::vector<unsigned> &indexList) const
+{
+    indexList.clear();
+    if (pointIndex.empty() || radius < 0) return;
+
+    // margin for single precision distances
+    double searchRadius = double(radius) * 1.001 + 1.;
+
+    int row0, col0, row1, col1;
+    getCell(double(x) - searchRadius, double(y) - searchRadius, row0, col0);
+    getCell(double(x) + searchRadius, double(y) + searchRadius, row1, col1);
+
+    row0 = std::max(row0, 0);
+    col0 = std::max(col0, 0);
+    row1 = std::min(row1, nrRows - 1);
+    col1 = std::min(col1, nrCols - 1);
+
+    for (int row = row0; row <= row1; row++)
+    {
+        for (int col = col0; col <= col1; col++)
+        {
+            unsigned cell = unsigned(row * nrCols + col);
+            for (unsigned j = cellFirst[cell]; j < cellFirst[cell + 1]; j++)
+            {
+                unsigned i = pointIndex[j];
+                if (getPointDistance(i, x, y) <= radius)
+                    indexList.push_back(i);
+            }
+        }
+    }
+
+    std::sort(indexList.begin(), indexList.end());
+}
+
+
+/*!
+ * \brief getMaxDistance
+ * \return an upper bound of the distance from (x, y) of all the indexed points
+ */
+float Crit3DSpatialIndex::getMaxDistance(float x, float y) const
+{
+    double dx = std::max(fabs(x - xMin), fabs(x - (xMin + nrCols * cellSize)));
+    double dy = std::max(fabs(y - yMin), fabs(y - (yMin + nrRows * cellSize)));
+
+    return float(sqrt(dx * dx + dy * dy)) + 1;
+}
@@ -0,0 +1,44 @@
+#ifndef SPATIALINDEX_H
+#define SPATIALINDEX_H
+
+    #ifndef VECTOR_H
+        #include <vector>
+    #endif
+
+    class Crit3DInterpolationDataPoint;
+
+    /*!
+     * \brief uniform grid index over the positions of the interpolation points,
+     * built once for each time step (see passDataToInterpolation)
+     * indexes refer to the positions in the vector used to build it
+     */
+    class Crit3DSpatialIndex
+    {
+    private:
+        double xMin, yMin;
+        double cellSize;
+        int nrRows, nrCols;
+
+        std::vector<unsigned> cellFirst;            // CSR: points of cell i are pointIndex[cellFirst[i] .. cellFirst[i+1])
+        std::vector<unsigned> pointIndex;
+        std::vector<float> pointX, pointY;
+        std::vector<const void*> pointId;
+
+        void getCell(double x, double y, int &row, int &col) const;
+
+    public:
+        Crit3DSpatialIndex();
+
+        void clear();
+        void build(const std::vector<Crit3DInterpolationDataPoint> &points);
+
+        bool isEmpty() const { return pointIndex.empty(); }
+        bool isValid(const std::vector<Crit3DInterpolationDataPoint> &points) const;
+
+        float getPointDistance(unsigned index, float x, float y) const;
+        void getPointsInRadius(float x, float y, float radius, std::vector<unsigned> &indexList) const;
+        float getMaxDistance(float x, float y) const;
+    };
+
+
+#endif // SPATIALINDEX_H
@@ -28,6 +28,9 @@
     #ifndef DAY_SECONDS
         #define DAY_SECONDS 86400.
     #endif
+    #ifndef DAY_MINUTES
+        #define DAY_MINUTES 1440
+    #endif
 
     // --------------- modalities ------------------
     #define MODE_GUI 0
@@ -104,6 +107,7 @@
     #define BOUNDARY_NONE 99
 
     #define RELAXATION 1
+    #define MULTICOLOR_RELAXATION 2
 
     // --------------- heat model -----------------
     #define SAVE_HEATFLUXES_NONE 0
@@ -1448,19 +1448,28 @@ namespace matricial
     // it assume that rowSecond == colFirst
     int matrixProductNoCheck(double **first, double**second,int rowFirst, int colFirst, int colSecond, double ** multiply)
     {
-        int c, d, k;
-        double sum = 0;
+        // the columns of second are processed in blocks that stay in cache, and the rows
+        // of second are read sequentially. Each element is summed in the same order (k = 0, 1, ..)
+        // of the row by column product. multiply must not share memory with first or second
+        const int blockSize = 256;
+        int c, d, k, lastColumn;
 
-        for ( c = 0 ; c < rowFirst ; c++ )
+        for (int firstColumn = 0; firstColumn < colSecond; firstColumn += blockSize)
         {
-            for ( d = 0 ; d < colSecond ; d++ )
+            lastColumn = MINVALUE(firstColumn + blockSize, colSecond);
+            for ( c = 0 ; c < rowFirst ; c++ )
             {
+                double* rowMultiply = multiply[c];
+                for ( d = firstColumn ; d < lastColumn ; d++ )
+                    rowMultiply[d] = 0.;
+
                 for ( k = 0 ; k < colFirst ; k++ )
                 {
-                    sum += first[c][k] * second[k][d];
+                    double factor = first[c][k];
+                    double* rowSecond = second[k];
+                    for ( d = firstColumn ; d < lastColumn ; d++ )
+                        rowMultiply[d] += factor * rowSecond[d];
                 }
-                multiply[c][d] = sum;
-                sum = 0.;
             }
         }
         return CRIT3D_OK;
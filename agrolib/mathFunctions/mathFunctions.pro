@@ -33,12 +33,16 @@ HEADERS += \
     furtherMathFunctions.h \
     statistics.h \
     physics.h \
-    gammaFunction.h
+    gammaFunction.h \
+    monotoneTable.h \
+    parallel.h
 
 SOURCES += \
     basicMath.cpp \
     furtherMathFunctions.cpp \
     statistics.cpp \
     physics.cpp \
-    gammaFunction.cpp
+    gammaFunction.cpp \
+    monotoneTable.cpp \
+    parallel.cpp
 
@@ -0,0 +1,161 @@
+/*!
+    \copyright 2023
+    Fausto Tomei, Gabriele Antolini, Antonio Volta
+
+    This file is part of AGROLIB distribution.
+    AGROLIB has been developed under contract issued by A.R.P.A. Emilia-Romagna
+
+    AGROLIB is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    AGROLIB is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with AGROLIB.  If not, see <http://www.gnu.org/licenses/>.
+
+    Contacts:
+    ftomei@arpae.it
+    gantolini@arpae.it
+    avolta@arpae.it
+*/
+
+#include <cmath>
+#include <algorithm>
+
+#include "monotoneTable.h"
+
+// nodes per decade of the first attempt, doubled until the error bound is satisfied
+#define MONOTONETABLE_FIRST_DECADE_NODES 8
+#define MONOTONETABLE_MAX_INTERVALS 65536
+
+
+Crit3DMonotoneTable::Crit3DMonotoneTable()
+{
+    clear();
+}
+
+
+void Crit3DMonotoneTable::clear()
+{
+    _xMin = 0;
+    _xMax = -1;
+    _logXMin = 0;
+    _invStep = 0;
+    _nrIntervals = 0;
+    _isLogValue = false;
+    _maxError = 0;
+    _coefficients.clear();
+}
+
+
+/*!
+ * \brief initialize
+ * \param f             function to be tabulated, it must be finite on [xMin, xMax] (and positive if isLogValue)
+ * \param maxError      error bound, checked at 1/4, 1/2 and 3/4 of each interval
+ * \return false if the bound is not reached with the maximum number of nodes
+ * or if f is not valid: in this case the table is empty
+ */
+bool Crit3DMonotoneTable::initialize(const std::function<double(double)> &f, double xMin, double xMax,
+                                     double maxError, bool isLogValue)
+{
+    clear();
+
+    if (xMin <= 0 || xMax <= xMin || maxError <= 0)
+        return false;
+
+    double logXMin = log(xMin);
+    double logXMax = log(xMax);
+    double nrDecades = (logXMax - logXMin) / log(10.);
+
+    int nrIntervals = std::max(1, int(ceil(nrDecades * MONOTONETABLE_FIRST_DECADE_NODES)));
+    std::vector<double> values, coefficients;
+
+    while (nrIntervals <= MONOTONETABLE_MAX_INTERVALS)
+    {
+        double step = (logXMax - logXMin) / nrIntervals;
+
+        // node values
+        values.resize(unsigned(nrIntervals + 1));
+        double scale = 0;
+        for (int i = 0; i <= nrIntervals; i++)
+        {
+            double y = f(exp(logXMin + i * step));
+            if (! std::isfinite(y) || (isLogValue && y <= 0))
+                return false;
+
+            scale = std::max(scale, fabs(y));
+            values[unsigned(i)] = isLogValue ? log(y) : y;
+        }
+        if (scale == 0) scale = 1;
+
+        // node slopes (per interval): harmonic mean of the adjacent secants,
+        // zero at local extrema, secant at the ends
+        coefficients.resize(unsigned(nrIntervals) * 4);
+        double previousSlope = values[1] - values[0];
+        for (int i = 0; i < nrIntervals; i++)
+        {
+            double y0 = values[unsigned(i)];
+            double y1 = values[unsigned(i+1)];
+            double delta = y1 - y0;
+
+            double d0 = previousSlope;
+            double d1 = delta;
+            if (i < nrIntervals - 1)
+            {
+                double nextDelta = values[unsigned(i+2)] - y1;
+                if (delta * nextDelta <= 0)
+                    d1 = 0;
+                else
+                    d1 = 2 * delta * nextDelta / (delta + nextDelta);
+            }
+            previousSlope = d1;
+
+            double* c = &(coefficients[unsigned(i) * 4]);
+            c[0] = y0;
+            c[1] = d0;
+            c[2] = 3 * delta - 2 * d0 - d1;
+            c[3] = d0 + d1 - 2 * delta;
+        }
+
+        // error check
+        double error = 0;
+        for (int i = 0; i < nrIntervals && error <= maxError; i++)
+        {
+            const double* c = &(coefficients[unsigned(i) * 4]);
+            for (double t = 0.25; t < 1; t += 0.25)
+            {
+                double y = f(exp(logXMin + (i + t) * step));
+                if (! std::isfinite(y) || (isLogValue && y <= 0))
+                    return false;
+
+                double value = c[0] + t * (c[1] + t * (c[2] + t * c[3]));
+                if (isLogValue)
+                    error = std::max(error, fabs(value - log(y)));
+                else
+                    error = std::max(error, fabs(value - y) / scale);
+            }
+        }
+
+        if (error <= maxError)
+        {
+            _xMin = xMin;
+            _xMax = xMax;
+            _logXMin = logXMin;
+            _invStep = 1. / step;
+            _nrIntervals = nrIntervals;
+            _isLogValue = isLogValue;
+            _maxError = error;
+            _coefficients = coefficients;
+            return true;
+        }
+
+        nrIntervals *= 2;
+    }
+
+    return false;
+}
@@ -0,0 +1,68 @@
+#ifndef MONOTONETABLE_H
+#define MONOTONETABLE_H
+
+    #ifndef _FUNCTIONAL_
+        #include <functional>
+    #endif
+    #ifndef _VECTOR_
+        #include <vector>
+    #endif
+
+    #include <math.h>
+
+    /*!
+     * \brief The Crit3DMonotoneTable class
+     * lookup table of a function y = f(x) on [xMin, xMax] (xMin > 0): nodes are evenly spaced in log(x)
+     * and the intervals are interpolated with monotone cubic Hermite polynomials (Fritsch-Carlson),
+     * so that a monotone function gives a monotone table.
+     * isLogValue: log(y) is tabulated (y > 0), the error bound is relative to y;
+     * otherwise the error bound is relative to the maximum absolute value of f on the nodes
+     */
+    class Crit3DMonotoneTable
+    {
+    public:
+        Crit3DMonotoneTable();
+
+        void clear();
+        bool initialize(const std::function<double(double)> &f, double xMin, double xMax,
+                        double maxError, bool isLogValue);
+
+        inline bool isInitialized() const { return ! _coefficients.empty(); }
+        inline bool isInside(double x) const { return x >= _xMin && x <= _xMax; }
+
+        inline double getXMin() const { return _xMin; }
+        inline double getXMax() const { return _xMax; }
+        inline int getNrNodes() const { return _nrIntervals + 1; }
+        inline double getMaxError() const { return _maxError; }
+
+        /*!
+         * \brief getValue
+         * \param x must be inside [xMin, xMax]
+         */
+        inline double getValue(double x) const
+        {
+            double u = (log(x) - _logXMin) * _invStep;
+            int i = int(u);
+            if (i >= _nrIntervals) i = _nrIntervals - 1;
+            if (i < 0) i = 0;
+            double t = u - i;
+
+            const double* c = &(_coefficients[unsigned(i) * 4]);
+            double value = c[0] + t * (c[1] + t * (c[2] + t * c[3]));
+
+            return _isLogValue ? exp(value) : value;
+        }
+
+    private:
+        double _xMin, _xMax;
+        double _logXMin, _invStep;
+        int _nrIntervals;
+        bool _isLogValue;
+        double _maxError;
+
+        // cubic polynomial of each interval in the normalized coordinate t = [0,1]
+        std::vector<double> _coefficients;
+    };
+
+
+#endif // MONOTONETABLE_H
@@ -0,0 +1,160 @@
+/*!
+    \copyright 2023
+    Fausto Tomei, Gabriele Antolini, Antonio Volta
+
+    This file is part of AGROLIB distribution.
+    AGROLIB has been developed under contract issued by A.R.P.A. Emilia-Romagna
+
+    AGROLIB is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    AGROLIB is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with AGROLIB.  If not, see <http://www.gnu.org/licenses/>.
+
+    Contacts:
+    ftomei@arpae.it
+    gantolini@arpae.it
+    avolta@arpae.it
+*/
+
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+
+#include "parallel.h"
+
+
+namespace parallel
+{
+    /*!
+     * \brief getNrThreads
+     * \param nrThreadsRequested: <= 0 means all available cores
+     * \return number of worker threads actually usable (at least 1)
+     */
+    int getNrThreads(int nrThreadsRequested)
+    {
+        int nrCores = int(std::thread::hardware_concurrency());
+        if (nrCores < 1)
+            nrCores = 1;
+
+        if (nrThreadsRequested <= 0)
+            return nrCores;
+
+        return std::min(nrThreadsRequested, nrCores);
+    }
+
+
+    /*!
+     * \brief forEachBlock
+     * splits [0, nrItems) in blocks of blockSize items and runs blockFunction(first, last, threadIndex)
+     * on each block, with last excluded. Blocks are dealt dynamically to nrThreads workers:
+     * threadIndex (0 .. nrThreads-1) identifies the worker, so the caller can keep one copy of its
+     * scratch data for each thread. With nrThreads <= 1 all blocks are processed in the calling thread.
+     * \return false if any block returns false (the remaining blocks are skipped)
+     */
+    bool forEachBlock(long nrItems, long blockSize, int nrThreads,
+                      const std::function<bool(long first, long last, int threadIndex)> &blockFunction)
+    {
+        if (nrItems <= 0)
+            return true;
+
+        if (blockSize < 1)
+            blockSize = 1;
+
+        long nrBlocks = (nrItems + blockSize - 1) / blockSize;
+
+        if (nrThreads <= 1 || nrBlocks == 1)
+        {
+            for (long first = 0; first < nrItems; first += blockSize)
+            {
+                if (! blockFunction(first, std::min(first + blockSize, nrItems), 0))
+                    return false;
+            }
+            return true;
+        }
+
+        nrThreads = int(std::min(long(nrThreads), nrBlocks));
+
+        std::atomic<long> nextBlock(0);
+        std::atomic<bool> isOk(true);
+
+        auto worker = [&](int threadIndex)
+        {
+            long block;
+            while (isOk && (block = nextBlock++) < nrBlocks)
+            {
+                long first = block * blockSize;
+                if (! blockFunction(first, std::min(first + blockSize, nrItems), threadIndex))
+                    isOk = false;
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(unsigned(nrThreads - 1));
+        for (int i = 1; i < nrThreads; i++)
+            threads.emplace_back(worker, i);
+
+        worker(0);
+
+        for (unsigned i = 0; i < threads.size(); i++)
+            threads[i].join();
+
+        return isOk;
+    }
+
+
+    /*!
+     * \brief runThreads
+     * runs threadFunction(threadIndex) once on each of nrThreads threads (the calling thread is 0)
+     * and waits for all of them. Unlike forEachBlock the threads are started only once,
+     * so they can share a long computation synchronized with a Barrier
+     */
+    void runThreads(int nrThreads, const std::function<void(int threadIndex)> &threadFunction)
+    {
+        std::vector<std::thread> threads;
+        if (nrThreads > 1)
+            threads.reserve(unsigned(nrThreads - 1));
+
+        for (int i = 1; i < nrThreads; i++)
+            threads.emplace_back(threadFunction, i);
+
+        threadFunction(0);
+
+        for (unsigned i = 0; i < threads.size(); i++)
+            threads[i].join();
+    }
+
+
+    Barrier::Barrier(int nrThreads)
+        : _nrThreads(std::max(nrThreads, 1)), _count(0), _generation(0)
+    { }
+
+
+    void Barrier::wait()
+    {
+        if (_nrThreads == 1)
+            return;
+
+        int generation = _generation.load(std::memory_order_acquire);
+
+        if (_count.fetch_add(1, std::memory_order_acq_rel) == _nrThreads - 1)
+        {
+            // last thread: releases the others
+            _count.store(0, std::memory_order_relaxed);
+            _generation.fetch_add(1, std::memory_order_release);
+        }
+        else
+        {
+            while (_generation.load(std::memory_order_acquire) == generation)
+                std::this_thread::yield();
+        }
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+    #ifndef _FUNCTIONAL_
+        #include <functional>
+    #endif
+    #ifndef _ATOMIC_
+        #include <atomic>
+    #endif
+
+    namespace parallel
+    {
+        int getNrThreads(int nrThreadsRequested);
+
+        bool forEachBlock(long nrItems, long blockSize, int nrThreads,
+                          const std::function<bool(long first, long last, int threadIndex)> &blockFunction);
+
+        void runThreads(int nrThreads, const std::function<void(int threadIndex)> &threadFunction);
+
+        /*!
+         * \brief The Barrier class
+         * reusable synchronization point of the nrThreads threads started by runThreads:
+         * wait() returns when all the threads have reached it, and the memory writes
+         * made before the barrier are visible to all the threads after it
+         */
+        class Barrier
+        {
+        public:
+            explicit Barrier(int nrThreads);
+            void wait();
+
+        private:
+            int _nrThreads;
+            std::atomic<int> _count;
+            std::atomic<int> _generation;
+        };
+    }
+
+
+#endif // PARALLEL_H
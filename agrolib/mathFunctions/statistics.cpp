@@ -1246,15 +1246,38 @@ namespace statistics
     {
         // input: myLists matrix
         // output: c matrix
+        // mean and variance of each list are computed once
+        // (same operations of covarianceNoCheck and varianceNoCheck)
 
+        std::vector<double> myMean, myVariance;
+        myMean.resize(unsigned(nrRowCol));
+        myVariance.resize(unsigned(nrRowCol));
+        for(int i = 0;i<nrRowCol;i++)
+        {
+            myMean[unsigned(i)] = meanNoCheck(myLists[i],nrLists);
+            myVariance[unsigned(i)] = varianceNoCheck(myLists[i],nrLists);
+        }
+
+        double myDiff1, myDiff2, prodDiff;
         for(int i = 0;i<nrRowCol;i++)
         {
             c[i][i]=1.;
+            double* myList1 = myLists[i];
+            double myMean1 = myMean[unsigned(i)];
             for(int j = i+1;j<nrRowCol;j++)
             {
-                c[i][j]= covarianceNoCheck(myLists[i],nrLists,myLists[j],nrLists);
+                double* myList2 = myLists[j];
+                double myMean2 = myMean[unsigned(j)];
+                prodDiff = 0;
+                for (int k = 0; k < nrLists; k++)
+                {
+                    myDiff1 = (myList1[k] - myMean1);
+                    myDiff2 = (myList2[k] - myMean2);
+                    prodDiff += myDiff1*myDiff2;
+                }
+                c[i][j]= prodDiff / (nrLists-1);
                 if (c[i][j] != 0)
-                    c[i][j] /= sqrt(varianceNoCheck(myLists[i],nrLists)*varianceNoCheck(myLists[j],nrLists));
+                    c[i][j] /= sqrt(myVariance[unsigned(i)]*myVariance[unsigned(j)]);
                 c[j][i] = c[i][j];
             }
 
@@ -27,12 +27,41 @@
 #include "basicMath.h"
 #include "meteoGrid.h"
 #include "statistics.h"
+#include "parallel.h"
 #include "math.h"
 
+#include <fstream>
+#include <stdint.h>
+
+#define AGGREGATION_INDEX_VERSION 1
+
 Crit3DMeteoGridStructure::Crit3DMeteoGridStructure()
 {    
 }
 
+
+Crit3DMeteoGridAggregationIndex::Crit3DMeteoGridAggregationIndex()
+{
+    clear();
+}
+
+void Crit3DMeteoGridAggregationIndex::clear()
+{
+    nrRasterRows = 0;
+    nrRasterCols = 0;
+    cellSize = NODATA;
+    cellFirst.clear();
+    rasterOffsets.clear();
+}
+
+bool Crit3DMeteoGridAggregationIndex::isSameGeometry(const gis::Crit3DRasterHeader& rasterHeader) const
+{
+    return (nrRasterRows == rasterHeader.nrRows && nrRasterCols == rasterHeader.nrCols
+            && isEqual(cellSize, rasterHeader.cellSize)
+            && fabs(llCorner.x - rasterHeader.llCorner.x) < 0.01
+            && fabs(llCorner.y - rasterHeader.llCorner.y) < 0.01);
+}
+
 std::string Crit3DMeteoGridStructure::name() const
 {
     return _name;
@@ -171,6 +200,7 @@ Crit3DMeteoGridStructure Crit3DMeteoGrid::gridStructure() const
 Crit3DMeteoGrid::Crit3DMeteoGrid()
 {
     _isAggregationDefined = false;
+    _nrThreads = 0;
     _gisSettings.utmZone = 32;
     _isElabValue = false;
     _firstDate = Crit3DDate(1,1,1800);
@@ -821,68 +851,81 @@ void Crit3DMeteoGrid::spatialAggregateMeteoGrid(meteoVariable myVar, frequencyTy
 
     if (!_isAggregationDefined)
     {
-        findGridAggregationPoints(myDEM);
+        std::string errorStr;
+        if (_aggregationIndexFileName.empty() || ! loadAggregationIndex(*myDEM, errorStr))
+        {
+            findGridAggregationPoints(myDEM);
+            buildAggregationIndex(*(myDEM->header));
+
+            if (! _aggregationIndexFileName.empty())
+                saveAggregationIndex(*myDEM, errorStr);
+        }
     }
 
-    for (unsigned col = 0; col < unsigned(_gridStructure.header().nrCols); col++)
+    if (_aggregationIndex.isEmpty() || ! _aggregationIndex.isSameGeometry(*(myRaster->header)))
     {
-        for (unsigned row = 0; row < unsigned(_gridStructure.header().nrRows); row++)
-        {
-            if (_meteoPoints[row][col]->active)
-            {
-                double validValues = 0;
-                for (unsigned int i = 0; i < _meteoPoints[row][col]->aggregationPoints.size(); i++)
-                {
-                    double x = _meteoPoints[row][col]->aggregationPoints[i].utm.x;
-                    double y = _meteoPoints[row][col]->aggregationPoints[i].utm.y;
-                    float interpolatedValue = gis::getValueFromXY(*myRaster, x, y);
-                    if (isEqual(interpolatedValue, myRaster->header->flag) == false)
-                    {
-                        _meteoPoints[row][col]->aggregationPoints[i].z = double(interpolatedValue);
-                        validValues = validValues + 1;
-                    }
-                }
+        buildAggregationIndex(*(myRaster->header));
+    }
 
-                if (!_meteoPoints[row][col]->aggregationPoints.empty())
-                {
+    const float* rasterValues = myRaster->data();
+    float rasterFlag = myRaster->header->flag;
+    long nrGridCols = _gridStructure.header().nrCols;
+    long nrGridCells = _gridStructure.header().nrRows * nrGridCols;
 
-                    if ( (validValues / _meteoPoints[row][col]->aggregationPointsMaxNr) > ( GRID_MIN_COVERAGE / 100 ) )
-                    {
+    int nrWorkers = parallel::getNrThreads(_nrThreads);
+    std::vector<std::vector<float>> validValues;
+    validValues.resize(unsigned(nrWorkers));
 
-                        double myValue = spatialAggregateMeteoGridPoint(*(_meteoPoints[row][col]), elab);
+    // grid cells are independent: each block writes only its own meteo points
+    parallel::forEachBlock(nrGridCells, AGGREGATION_CELLS_BLOCK, nrWorkers, [&](long first, long last, int threadIndex)
+    {
+        std::vector<float> &values = validValues[unsigned(threadIndex)];
 
-                        if (freq == hourly)
-                        {
-                            if (_meteoPoints[row][col]->nrObsDataDaysH == 0)
-                                _meteoPoints[row][col]->initializeObsDataH(1, numberOfDays, date);
+        for (long i = first; i < last; i++)
+        {
+            Crit3DMeteoPoint* myPoint = _meteoPoints[unsigned(i / nrGridCols)][unsigned(i % nrGridCols)];
+            if (! myPoint->active || myPoint->aggregationPointsMaxNr == 0)
+                continue;
 
-                            _meteoPoints[row][col]->setMeteoPointValueH(date, hour, minute, myVar, float(myValue));
-                            _meteoPoints[row][col]->currentValue = float(myValue);
-                        }
-                        else if (freq == daily)
-                        {
-                            if (_meteoPoints[row][col]->nrObsDataDaysD == 0)
-                                _meteoPoints[row][col]->initializeObsDataD(numberOfDays, date);
+            values.clear();
+            for (long j = _aggregationIndex.cellFirst[unsigned(i)]; j < _aggregationIndex.cellFirst[unsigned(i+1)]; j++)
+            {
+                float value = rasterValues[_aggregationIndex.rasterOffsets[unsigned(j)]];
+                if (! isEqual(value, rasterFlag) && value != NODATA)
+                    values.push_back(value);
+            }
 
-                            _meteoPoints[row][col]->setMeteoPointValueD(date, myVar, float(myValue));
-                            _meteoPoints[row][col]->currentValue = float(myValue);
+            double myValue = aggregateValues(values, myPoint->aggregationPointsMaxNr, elab);
+            if (isEqual(myValue, NODATA))
+                continue;
 
-                        }
-                    }
-                }
+            if (freq == hourly)
+            {
+                if (myPoint->nrObsDataDaysH == 0)
+                    myPoint->initializeObsDataH(1, numberOfDays, date);
 
+                myPoint->setMeteoPointValueH(date, hour, minute, myVar, float(myValue));
+                myPoint->currentValue = float(myValue);
+            }
+            else if (freq == daily)
+            {
+                if (myPoint->nrObsDataDaysD == 0)
+                    myPoint->initializeObsDataD(numberOfDays, date);
+
+                myPoint->setMeteoPointValueD(date, myVar, float(myValue));
+                myPoint->currentValue = float(myValue);
             }
         }
-    }
+
+        return true;
+    });
 }
 
 
-double Crit3DMeteoGrid::spatialAggregateMeteoGridPoint(Crit3DMeteoPoint myPoint, aggregationMethod elab)
+double Crit3DMeteoGrid::spatialAggregateMeteoGridPoint(const Crit3DMeteoPoint &myPoint, aggregationMethod elab)
 {
-
     std::vector <float> validValues;
 
-
     for (unsigned int i = 0; i < myPoint.aggregationPoints.size(); i++)
     {
         if (myPoint.aggregationPoints[i].z != NODATA)
@@ -891,12 +934,24 @@ double Crit3DMeteoGrid::spatialAggregateMeteoGridPoint(Crit3DMeteoPoint myPoint,
         }
     }
 
-    if (validValues.empty())
+    return aggregateValues(validValues, myPoint.aggregationPointsMaxNr, elab);
+}
+
+
+/*!
+ * \brief aggregateValues
+ * \param validValues: values of the DEM cells of a grid cell (without nodata), it may be sorted
+ * \param maxNrValues: number of DEM cells of the grid cell, for the coverage check
+ * \return aggregated value or NODATA
+ */
+double Crit3DMeteoGrid::aggregateValues(std::vector<float> &validValues, long maxNrValues, aggregationMethod elab)
+{
+    if (validValues.empty() || maxNrValues == 0)
     {
         return NODATA;
     }
 
-    if ( (static_cast<double>(validValues.size()) / myPoint.aggregationPointsMaxNr) < ( GRID_MIN_COVERAGE / 100.0) )
+    if ( (static_cast<double>(validValues.size()) / maxNrValues) < ( GRID_MIN_COVERAGE / 100.0) )
     {
         return NODATA;
     }
@@ -918,10 +973,241 @@ double Crit3DMeteoGrid::spatialAggregateMeteoGridPoint(Crit3DMeteoPoint myPoint,
     {
         return NODATA;
     }
+}
 
 
+/*!
+ * \brief buildAggregationIndex
+ * converts the aggregation points of the active cells to offsets in a raster with the given geometry.
+ * Points outside the raster are left out: their value is always missing
+ */
+void Crit3DMeteoGrid::buildAggregationIndex(const gis::Crit3DRasterHeader& rasterHeader)
+{
+    _aggregationIndex.clear();
+    _aggregationIndex.nrRasterRows = rasterHeader.nrRows;
+    _aggregationIndex.nrRasterCols = rasterHeader.nrCols;
+    _aggregationIndex.cellSize = rasterHeader.cellSize;
+    _aggregationIndex.llCorner = rasterHeader.llCorner;
+
+    unsigned nrGridRows = unsigned(_gridStructure.header().nrRows);
+    unsigned nrGridCols = unsigned(_gridStructure.header().nrCols);
+    _aggregationIndex.cellFirst.reserve(nrGridRows * nrGridCols + 1);
+
+    int rasterRow, rasterCol;
+    for (unsigned row = 0; row < nrGridRows; row++)
+    {
+        for (unsigned col = 0; col < nrGridCols; col++)
+        {
+            _aggregationIndex.cellFirst.push_back(long(_aggregationIndex.rasterOffsets.size()));
+
+            if (! _meteoPoints[row][col]->active)
+                continue;
+
+            const std::vector<gis::Crit3DPoint> &points = _meteoPoints[row][col]->aggregationPoints;
+            for (unsigned i = 0; i < points.size(); i++)
+            {
+                gis::getRowColFromXY(rasterHeader, points[i].utm.x, points[i].utm.y, &rasterRow, &rasterCol);
+                if (rasterRow >= 0 && rasterRow < rasterHeader.nrRows && rasterCol >= 0 && rasterCol < rasterHeader.nrCols)
+                    _aggregationIndex.rasterOffsets.push_back(long(rasterRow) * rasterHeader.nrCols + rasterCol);
+            }
+        }
+    }
+
+    _aggregationIndex.cellFirst.push_back(long(_aggregationIndex.rasterOffsets.size()));
 }
 
+
+/*!
+ * \brief aggregation index file: header (grid and DEM geometry, active cells)
+ * followed by the number of DEM cells and the CSR index of each grid cell.
+ * The index depends only on the geometry, because DEM nodata are not excluded
+ */
+namespace
+{
+    struct TaggregationIndexHeader
+    {
+        int32_t version;
+        int32_t utmZone;
+        int32_t isUTM;
+        int32_t nrGridRows, nrGridCols;
+        double gridLat, gridLon, gridDx, gridDy;
+        int32_t nrDemRows, nrDemCols;
+        double demCellSize, demX, demY;
+        int64_t nrOffsets;
+
+        bool isEqualTo(const TaggregationIndexHeader& other) const
+        {
+            return (version == other.version && utmZone == other.utmZone && isUTM == other.isUTM
+                    && nrGridRows == other.nrGridRows && nrGridCols == other.nrGridCols
+                    && gridLat == other.gridLat && gridLon == other.gridLon
+                    && gridDx == other.gridDx && gridDy == other.gridDy
+                    && nrDemRows == other.nrDemRows && nrDemCols == other.nrDemCols
+                    && demCellSize == other.demCellSize && demX == other.demX && demY == other.demY);
+        }
+    };
+
+    TaggregationIndexHeader getAggregationIndexHeader(const Crit3DMeteoGridStructure &gridStructure,
+                                                      const gis::Crit3DGisSettings &gisSettings,
+                                                      const gis::Crit3DRasterHeader &demHeader)
+    {
+        TaggregationIndexHeader header;
+        header.version = AGGREGATION_INDEX_VERSION;
+        header.utmZone = gisSettings.utmZone;
+        header.isUTM = gridStructure.isUTM() ? 1 : 0;
+        header.nrGridRows = gridStructure.header().nrRows;
+        header.nrGridCols = gridStructure.header().nrCols;
+        header.gridLat = gridStructure.header().llCorner.latitude;
+        header.gridLon = gridStructure.header().llCorner.longitude;
+        header.gridDx = gridStructure.header().dx;
+        header.gridDy = gridStructure.header().dy;
+        header.nrDemRows = demHeader.nrRows;
+        header.nrDemCols = demHeader.nrCols;
+        header.demCellSize = demHeader.cellSize;
+        header.demX = demHeader.llCorner.x;
+        header.demY = demHeader.llCorner.y;
+        header.nrOffsets = 0;
+        return header;
+    }
+}
+
+
+bool Crit3DMeteoGrid::saveAggregationIndex(const gis::Crit3DRasterGrid& myDEM, std::string &errorStr)
+{
+    if (_aggregationIndex.isEmpty() || ! _aggregationIndex.isSameGeometry(*(myDEM.header)))
+    {
+        errorStr = "Aggregation index is not defined on the DEM.";
+        return false;
+    }
+
+    std::ofstream outFile(_aggregationIndexFileName, std::ios::binary | std::ios::trunc);
+    if (! outFile.is_open())
+    {
+        errorStr = "Open failure: " + _aggregationIndexFileName;
+        return false;
+    }
+
+    TaggregationIndexHeader header = getAggregationIndexHeader(_gridStructure, _gisSettings, *(myDEM.header));
+    header.nrOffsets = int64_t(_aggregationIndex.rasterOffsets.size());
+    outFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    unsigned nrGridCells = unsigned(header.nrGridRows * header.nrGridCols);
+    std::vector<char> isActive(nrGridCells);
+    std::vector<int64_t> maxNr(nrGridCells);
+    for (unsigned i = 0; i < nrGridCells; i++)
+    {
+        Crit3DMeteoPoint* myPoint = _meteoPoints[i / unsigned(header.nrGridCols)][i % unsigned(header.nrGridCols)];
+        isActive[i] = myPoint->active ? 1 : 0;
+        maxNr[i] = myPoint->aggregationPointsMaxNr;
+    }
+
+    std::vector<int64_t> cellFirst(_aggregationIndex.cellFirst.begin(), _aggregationIndex.cellFirst.end());
+    std::vector<int64_t> offsets(_aggregationIndex.rasterOffsets.begin(), _aggregationIndex.rasterOffsets.end());
+
+    outFile.write(isActive.data(), std::streamsize(isActive.size()));
+    outFile.write(reinterpret_cast<const char*>(maxNr.data()), std::streamsize(maxNr.size() * sizeof(int64_t)));
+    outFile.write(reinterpret_cast<const char*>(cellFirst.data()), std::streamsize(cellFirst.size() * sizeof(int64_t)));
+    outFile.write(reinterpret_cast<const char*>(offsets.data()), std::streamsize(offsets.size() * sizeof(int64_t)));
+
+    if (! outFile.good())
+    {
+        errorStr = "Write failure: " + _aggregationIndexFileName;
+        return false;
+    }
+
+    return true;
+}
+
+
+/*!
+ * \brief loadAggregationIndex
+ * reads the index saved for the same grid, DEM geometry and active cells,
+ * and restores aggregationPoints (DEM cell centers) and aggregationPointsMaxNr
+ */
+bool Crit3DMeteoGrid::loadAggregationIndex(const gis::Crit3DRasterGrid& myDEM, std::string &errorStr)
+{
+    std::ifstream inFile(_aggregationIndexFileName, std::ios::binary);
+    if (! inFile.is_open())
+    {
+        errorStr = "Missing file: " + _aggregationIndexFileName;
+        return false;
+    }
+
+    TaggregationIndexHeader expectedHeader = getAggregationIndexHeader(_gridStructure, _gisSettings, *(myDEM.header));
+    TaggregationIndexHeader header;
+    inFile.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (! inFile.good() || ! header.isEqualTo(expectedHeader) || header.nrOffsets < 0)
+    {
+        errorStr = "Aggregation index is not valid for the current grid and DEM.";
+        return false;
+    }
+
+    unsigned nrGridCols = unsigned(header.nrGridCols);
+    unsigned nrGridCells = unsigned(header.nrGridRows) * nrGridCols;
+    std::vector<char> isActive(nrGridCells);
+    std::vector<int64_t> maxNr(nrGridCells);
+    std::vector<int64_t> cellFirst(nrGridCells + 1);
+    std::vector<int64_t> offsets(unsigned(header.nrOffsets));
+
+    inFile.read(isActive.data(), std::streamsize(isActive.size()));
+    inFile.read(reinterpret_cast<char*>(maxNr.data()), std::streamsize(maxNr.size() * sizeof(int64_t)));
+    inFile.read(reinterpret_cast<char*>(cellFirst.data()), std::streamsize(cellFirst.size() * sizeof(int64_t)));
+    inFile.read(reinterpret_cast<char*>(offsets.data()), std::streamsize(offsets.size() * sizeof(int64_t)));
+    if (! inFile.good() || cellFirst[nrGridCells] != header.nrOffsets)
+    {
+        errorStr = "Read failure: " + _aggregationIndexFileName;
+        return false;
+    }
+
+    for (unsigned i = 0; i < nrGridCells; i++)
+    {
+        if (_meteoPoints[i / nrGridCols][i % nrGridCols]->active != (isActive[i] == 1))
+        {
+            errorStr = "Aggregation index is not valid for the current active cells.";
+            return false;
+        }
+    }
+
+    _aggregationIndex.clear();
+    _aggregationIndex.nrRasterRows = myDEM.header->nrRows;
+    _aggregationIndex.nrRasterCols = myDEM.header->nrCols;
+    _aggregationIndex.cellSize = myDEM.header->cellSize;
+    _aggregationIndex.llCorner = myDEM.header->llCorner;
+    _aggregationIndex.cellFirst.assign(cellFirst.begin(), cellFirst.end());
+    _aggregationIndex.rasterOffsets.assign(offsets.begin(), offsets.end());
+
+    gis::Crit3DPoint point;
+    point.z = NODATA;
+    for (unsigned i = 0; i < nrGridCells; i++)
+    {
+        Crit3DMeteoPoint* myPoint = _meteoPoints[i / nrGridCols][i % nrGridCols];
+        myPoint->aggregationPoints.clear();
+        myPoint->aggregationPointsMaxNr = long(maxNr[i]);
+
+        for (long j = _aggregationIndex.cellFirst[i]; j < _aggregationIndex.cellFirst[i+1]; j++)
+        {
+            long offset = _aggregationIndex.rasterOffsets[unsigned(j)];
+            gis::getUtmXYFromRowCol(*(myDEM.header), int(offset / myDEM.header->nrCols), int(offset % myDEM.header->nrCols),
+                                    &(point.utm.x), &(point.utm.y));
+            myPoint->aggregationPoints.push_back(point);
+        }
+    }
+
+    _isAggregationDefined = true;
+    return true;
+}
+
+
+std::string Crit3DMeteoGrid::aggregationIndexFileName() const
+{
+    return _aggregationIndexFileName;
+}
+
+void Crit3DMeteoGrid::setAggregationIndexFileName(const std::string &fileName)
+{
+    _aggregationIndexFileName = fileName;
+}
+
+
 bool Crit3DMeteoGrid::getIsElabValue() const
 {
     return _isElabValue;
@@ -947,6 +1233,8 @@ bool Crit3DMeteoGrid::isAggregationDefined() const
 void Crit3DMeteoGrid::setIsAggregationDefined(bool isAggregationDefined)
 {
     _isAggregationDefined = isAggregationDefined;
+    if (! isAggregationDefined)
+        _aggregationIndex.clear();
 }
 
 Crit3DDate Crit3DMeteoGrid::firstDate() const
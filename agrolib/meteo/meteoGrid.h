@@ -13,6 +13,30 @@
     #endif
 
     #define GRID_MIN_COVERAGE 0
+    #define AGGREGATION_CELLS_BLOCK 64
+
+    /*!
+     * \brief DEM cells of each meteo grid cell in compressed (CSR) layout:
+     * the cells of grid cell i = row * nrGridCols + col are
+     * rasterOffsets[cellFirst[i]] ... rasterOffsets[cellFirst[i+1] - 1]
+     * where rasterOffsets are row * nrCols + col in a raster with the given geometry
+     */
+    class Crit3DMeteoGridAggregationIndex
+    {
+        public:
+            int nrRasterRows, nrRasterCols;
+            double cellSize;
+            gis::Crit3DUtmPoint llCorner;
+
+            std::vector<long> cellFirst;
+            std::vector<long> rasterOffsets;
+
+            Crit3DMeteoGridAggregationIndex();
+
+            void clear();
+            bool isEmpty() const { return cellFirst.empty(); }
+            bool isSameGeometry(const gis::Crit3DRasterHeader& rasterHeader) const;
+    };
 
     class Crit3DMeteoGridStructure
     {
@@ -140,7 +164,16 @@
             void findGridAggregationPoints(gis::Crit3DRasterGrid* myDEM);
             void assignCellAggregationPoints(unsigned row, unsigned col, gis::Crit3DRasterGrid* myDEM, bool excludeNoData);
             void spatialAggregateMeteoGrid(meteoVariable myVar, frequencyType freq, Crit3DDate date, int  hour, int minute, gis::Crit3DRasterGrid* myDEM, gis::Crit3DRasterGrid *myRaster, aggregationMethod elab);
-            double spatialAggregateMeteoGridPoint(Crit3DMeteoPoint myPoint, aggregationMethod elab);
+            double spatialAggregateMeteoGridPoint(const Crit3DMeteoPoint &myPoint, aggregationMethod elab);
+
+            void buildAggregationIndex(const gis::Crit3DRasterHeader& rasterHeader);
+            bool loadAggregationIndex(const gis::Crit3DRasterGrid& myDEM, std::string &errorStr);
+            bool saveAggregationIndex(const gis::Crit3DRasterGrid& myDEM, std::string &errorStr);
+
+            std::string aggregationIndexFileName() const;
+            void setAggregationIndexFileName(const std::string &fileName);
+
+            void setNrThreads(int nrThreads) { _nrThreads = nrThreads; }
 
             bool getIsElabValue() const;
             void setIsElabValue(bool isElabValue);
@@ -157,6 +190,12 @@
             gis::Crit3DGisSettings _gisSettings;
 
             bool _isAggregationDefined;
+            Crit3DMeteoGridAggregationIndex _aggregationIndex;
+            std::string _aggregationIndexFileName;
+            int _nrThreads;
+
+            double aggregateValues(std::vector<float> &validValues, long maxNrValues, aggregationMethod elab);
+
             Crit3DDate _firstDate;
             Crit3DDate _lastDate;
             bool _isElabValue;
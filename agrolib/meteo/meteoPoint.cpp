@@ -27,6 +27,7 @@
 #include <math.h>
 #include <iomanip>
 #include <sstream>
+#include <algorithm>
 
 #include "commonConstants.h"
 #include "basicMath.h"
@@ -705,6 +706,22 @@ void Crit3DMeteoPoint::cleanObsDataM()
     obsDataM.clear();
 }
 
+/*!
+ * \brief swapObsData
+ * exchanges the hourly and daily observed data (and their state) with other,
+ * used to load data on a separate point without copying them
+ */
+void Crit3DMeteoPoint::swapObsData(Crit3DMeteoPoint &other)
+{
+    std::swap(obsDataH, other.obsDataH);
+    std::swap(nrObsDataDaysH, other.nrObsDataDaysH);
+    std::swap(hourlyFraction, other.hourlyFraction);
+    obsDataD.swap(other.obsDataD);
+    std::swap(nrObsDataDaysD, other.nrObsDataDaysD);
+    std::swap(quality, other.quality);
+    std::swap(residual, other.residual);
+}
+
 
 
 bool Crit3DMeteoPoint::setMeteoPointValueH(const Crit3DDate& myDate, int myHour, int myMinutes, meteoVariable myVar, float myValue)
@@ -800,7 +817,14 @@ bool Crit3DMeteoPoint::setMeteoPointValueH(const Crit3DDate& myDate, int myHour,
 
 bool Crit3DMeteoPoint::setMeteoPointValueD(const Crit3DDate& myDate, meteoVariable myVar, float myValue)
 {
-    long index = obsDataD[0].date.daysTo(myDate);
+    if (nrObsDataDaysD == 0) return false;
+
+    return setMeteoPointValueD(obsDataD[0].date.daysTo(myDate), myVar, myValue);
+}
+
+// index: days from the first date of obsDataD
+bool Crit3DMeteoPoint::setMeteoPointValueD(long index, meteoVariable myVar, float myValue)
+{
     if ((index < 0) || (index >= nrObsDataDaysD)) return false;
 
     unsigned i = unsigned(index);
@@ -131,6 +131,7 @@
             void cleanObsDataH();
             void cleanObsDataD();
             void cleanObsDataM();
+            void swapObsData(Crit3DMeteoPoint &other);
 
             bool isDateLoadedH(const Crit3DDate& myDate);
             bool isDateTimeLoadedH(const Crit3DTime& myDateTime);
@@ -155,6 +156,7 @@
             float getMeteoPointValueD(const Crit3DDate& myDate, meteoVariable myVar, Crit3DMeteoSettings* meteoSettings);
             float getMeteoPointValueD(const Crit3DDate& myDate, meteoVariable myVar);
             bool setMeteoPointValueD(const Crit3DDate& myDate, meteoVariable myVar, float myValue);
+            bool setMeteoPointValueD(long index, meteoVariable myVar, float myValue);
             bool getMeteoPointValueDayH(const Crit3DDate& myDate, TObsDataH *&hourlyValues);
             Crit3DDate getMeteoPointHourlyValuesDate(int index);
             float getMeteoPointValue(const Crit3DTime& myTime, meteoVariable myVar, Crit3DMeteoSettings *meteoSettings);
@@ -750,6 +750,12 @@ bool NetCDFHandler::exportDataSeries(int idVar, gis::Crit3DGeoPoint geoPoint, Cr
         *buffer << "Wrong variable!" << endl;
         return false;
     }
+    std::string typeError;
+    if (! checkDataType(var.type, typeError))
+    {
+        *buffer << typeError << endl;
+        return false;
+    }
 
     // check point
     if (! isPointInside(geoPoint))
@@ -782,17 +788,8 @@ bool NetCDFHandler::exportDataSeries(int idVar, gis::Crit3DGeoPoint geoPoint, Cr
     }
 
     // search time indexes
-    int t1 = NODATA;
-    int t2 = NODATA;
-    int i = 0;
-    while ((i < nrTime) && (t1 == NODATA || t2 == NODATA))
-    {
-        if (getTime(i) == seriesFirstTime)
-            t1 = i;
-        if (getTime(i) == seriesLastTime)
-            t2 = i;
-        i++;
-    }
+    int t1 = getTimeIndex(seriesFirstTime);
+    int t2 = getTimeIndex(seriesLastTime);
 
     // check time range
     if  (t1 == NODATA || t2 == NODATA)
@@ -815,32 +812,26 @@ bool NetCDFHandler::exportDataSeries(int idVar, gis::Crit3DGeoPoint geoPoint, Cr
 
     *buffer << endl;
 
-    // write data
-    size_t* index = new size_t[3];
-    index[indexYLonDim] = size_t(row);
-    index[indexXLatDim] = size_t(col);
+    // read the whole series with a single hyperslab
+    size_t start[] = {size_t(t1), size_t(row), size_t(col)};
+    size_t count[] = {size_t(t2 - t1 + 1), 1, 1};
+    std::vector<double> values;
+    std::string errorStr;
+    if (! readVariableBlock(idVar, start, count, values, errorStr))
+    {
+        *buffer << errorStr << endl;
+        return false;
+    }
 
+    // write data
     for (int t = t1; t <= t2; t++)
     {
-        index[indexTimeDim] = unsigned(t);
-        if (var.type == NC_DOUBLE)
-        {
-            double value;
-            nc_get_var1_double(ncId, idVar, index, &value);
-            *buffer << getDateTimeStr(t) << ", " << value << endl;
-        }
-        if (var.type == NC_FLOAT)
-        {
-            float value;
-            nc_get_var1_float(ncId, idVar, index, &value);
-            *buffer << getDateTimeStr(t) << ", " << value << endl;
-        }
+        double value = values[unsigned(t - t1)];
         if (var.type <= NC_INT)
         {
-            int value;
-            nc_get_var1_int(ncId, idVar, index, &value);
-            *buffer << getDateTimeStr(t) << ", " << double(value)/100 << endl;
+            value /= 100;
         }
+        *buffer << getDateTimeStr(t) << ", " << value << "\n";
     }
 
     return true;
@@ -1217,16 +1208,8 @@ bool NetCDFHandler::extractVariableMap(int idVar, const Crit3DTime &myTime, std:
     dataGrid.emptyGrid();
 
     // check dimensions
-    if (indexTimeDim == NODATA || indexXLatDim == NODATA || indexYLonDim == NODATA)
-    {
-        errorStr = "One dimension is missing: required (time, x, y) or (time, lon, lat).";
+    if (! checkDataDimensions(errorStr))
         return false;
-    }
-    if (std::max(indexTimeDim, std::max(indexXLatDim, indexYLonDim)) > 2)
-    {
-        errorStr = "Wrong dimension number: greater than 3.";
-        return false;
-    }
 
     // check variable
     NetCDFVariable currentVar = getVariableFromId(idVar);
@@ -1250,60 +1233,307 @@ bool NetCDFHandler::extractVariableMap(int idVar, const Crit3DTime &myTime, std:
     }
 
     // search time index
-    long timeIndex = NODATA;
-    for (long i = 0; i < nrTime; i++)
-    {
-        if (getTime(i) == myTime)
-        {
-            timeIndex = i;
-            break;
-        }
-    }
+    int timeIndex = getTimeIndex(myTime);
     if  (timeIndex == NODATA)
     {
         errorStr = "No available time index.";
         return false;
     }
 
-    // get data
-    size_t* index = new size_t[3];
-    index[indexTimeDim] = size_t(timeIndex);
+    // read the whole map with a single hyperslab
+    int nrFileRows = int(getDimensionLength(indexYLonDim));
+    int nrFileCols = int(getDimensionLength(indexXLatDim));
+    std::vector<float> values;
+    if (! readDataBlock(idVar, timeIndex, 1, 0, nrFileRows, 0, nrFileCols, values, errorStr))
+        return false;
 
     for (int row = 0; row < dataGrid.header->nrRows; row++)
     {
+        int fileRow = row;
         if (isYincreasing)
-            index[indexYLonDim] = size_t((nrLat-1) - row);
-        else
-            index[indexYLonDim] = size_t(row);
+            fileRow = int(nrLat-1) - row;
+
+        if (fileRow < 0 || fileRow >= nrFileRows)
+            continue;
 
-        for (int col = 0; col < dataGrid.header->nrCols; col++)
+        for (int col = 0; col < std::min(dataGrid.header->nrCols, nrFileCols); col++)
         {
-            index[indexXLatDim] = size_t(col);
-            float value = dataGrid.header->flag;
+            dataGrid.value[row][col] = values[unsigned(fileRow * nrFileCols + col)];
+        }
+    }
 
-            if (currentVar.type == NC_DOUBLE)
-            {
-                double valueDouble;
-                nc_get_var1_double(ncId, idVar, index, &valueDouble);
-                value = float(valueDouble);
-            }
-            if (currentVar.type == NC_FLOAT)
+    return true;
+}
+
+
+int NetCDFHandler::getTimeIndex(const Crit3DTime &myTime)
+{
+    for (int i = 0; i < nrTime; i++)
+    {
+        if (getTime(i) == myTime)
+            return i;
+    }
+
+    return NODATA;
+}
+
+
+bool NetCDFHandler::checkDataDimensions(std::string &errorStr)
+{
+    if (indexTimeDim == NODATA || indexXLatDim == NODATA || indexYLonDim == NODATA)
+    {
+        errorStr = "One dimension is missing: required (time, x, y) or (time, lon, lat).";
+        return false;
+    }
+    if (std::max(indexTimeDim, std::max(indexXLatDim, indexYLonDim)) > 2)
+    {
+        errorStr = "Wrong dimension number: greater than 3.";
+        return false;
+    }
+
+    return true;
+}
+
+
+bool NetCDFHandler::checkDataType(int varType, std::string &errorStr)
+{
+    if (varType == NC_DOUBLE || varType == NC_FLOAT || varType <= NC_INT)
+        return true;
+
+    errorStr = "Wrong variable type.";
+    return false;
+}
+
+
+long NetCDFHandler::getDimensionLength(int dimIndex)
+{
+    size_t length;
+    if (nc_inq_dimlen(ncId, dimIndex, &length) != NC_NOERR)
+        return 0;
+
+    return long(length);
+}
+
+
+// chunk size of the variable along the time dimension (1 if not chunked)
+int NetCDFHandler::getTimeChunkSize(int idVar)
+{
+    int storage;
+    size_t chunkSizes[NC_MAX_VAR_DIMS];
+    if (nc_inq_var_chunking(ncId, idVar, &storage, chunkSizes) != NC_NOERR || storage != NC_CHUNKED)
+        return 1;
+
+    return std::max(1, int(chunkSizes[indexTimeDim]));
+}
+
+
+/*!
+ * \brief readVariableBlock
+ * reads with a single nc_get_vara call the block start[] count[] of a variable,
+ * with start and count in (time, row, col) order (row on the y/lon dimension, col on the x/lat
+ * dimension, as in exportDataSeries). Values are returned in (time, row, col) order
+ * whatever the order of the dimensions in the file
+ */
+bool NetCDFHandler::readVariableBlock(int idVar, const size_t* start, const size_t* count,
+                                      std::vector<double> &values, std::string &errorStr)
+{
+    if (! checkDataDimensions(errorStr))
+        return false;
+
+    // position of time, row, col among the dimensions of the file
+    int position[3] = {indexTimeDim, indexYLonDim, indexXLatDim};
+
+    size_t fileStart[3], fileCount[3];
+    for (int i = 0; i < 3; i++)
+    {
+        fileStart[position[i]] = start[i];
+        fileCount[position[i]] = count[i];
+    }
+
+    size_t nrValues = count[0] * count[1] * count[2];
+    std::vector<double> fileValues(nrValues);
+    if (nrValues == 0)
+    {
+        values.clear();
+        return true;
+    }
+
+    int retVal = nc_get_vara_double(ncId, idVar, fileStart, fileCount, fileValues.data());
+    if (retVal != NC_NOERR)
+    {
+        errorStr = nc_strerror(retVal);
+        return false;
+    }
+
+    if (position[0] == 0 && position[1] == 1 && position[2] == 2)
+    {
+        values.swap(fileValues);
+        return true;
+    }
+
+    // different order of dimensions: transpose
+    size_t fileStride[3];
+    fileStride[2] = 1;
+    fileStride[1] = fileCount[2];
+    fileStride[0] = fileCount[1] * fileCount[2];
+
+    size_t timeStride = fileStride[position[0]];
+    size_t rowStride = fileStride[position[1]];
+    size_t colStride = fileStride[position[2]];
+
+    values.resize(nrValues);
+    size_t i = 0;
+    for (size_t t = 0; t < count[0]; t++)
+        for (size_t r = 0; r < count[1]; r++)
+            for (size_t c = 0; c < count[2]; c++)
+                values[i++] = fileValues[t * timeStride + r * rowStride + c * colStride];
+
+    return true;
+}
+
+
+/*!
+ * \brief readDataBlock
+ * reads the block of nrTimes x nrRows x nrCols values of a variable (file indexes:
+ * row on the y/lon dimension, col on the x/lat dimension) in contiguous (time, row, col) order
+ */
+bool NetCDFHandler::readDataBlock(int idVar, int firstTimeIndex, int nrTimes, int firstRow, int nrRows,
+                                  int firstCol, int nrCols, std::vector<float> &values, std::string &errorStr)
+{
+    NetCDFVariable currentVar = getVariableFromId(idVar);
+    if (currentVar.getVarName() == "")
+    {
+        errorStr = "Wrong variable.";
+        return false;
+    }
+    if (! checkDataType(currentVar.type, errorStr))
+        return false;
+
+    if (firstTimeIndex < 0 || nrTimes < 0 || firstTimeIndex + nrTimes > nrTime
+        || firstRow < 0 || nrRows < 0 || firstCol < 0 || nrCols < 0)
+    {
+        errorStr = "Wrong block indexes.";
+        return false;
+    }
+
+    size_t start[] = {size_t(firstTimeIndex), size_t(firstRow), size_t(firstCol)};
+    size_t count[] = {size_t(nrTimes), size_t(nrRows), size_t(nrCols)};
+
+    std::vector<double> blockValues;
+    if (! readVariableBlock(idVar, start, count, blockValues, errorStr))
+        return false;
+
+    values.resize(blockValues.size());
+    for (size_t i = 0; i < blockValues.size(); i++)
+    {
+        values[i] = float(blockValues[i]);
+    }
+
+    return true;
+}
+
+
+/*!
+ * \brief readPointsSeries
+ * reads the series [firstTimeIndex, firstTimeIndex + nrTimes) of many points (file row and col)
+ * in one pass: values[p * nrTimes + t].
+ * When the bounding box of the points is not much larger than the points, the box is read in
+ * blocks of time steps aligned to the time chunks of the variable, so that each chunk is read
+ * (and decompressed) once; otherwise each point series is read with a single hyperslab
+ */
+bool NetCDFHandler::readPointsSeries(int idVar, const std::vector<int> &rows, const std::vector<int> &cols,
+                                     int firstTimeIndex, int nrTimes, std::vector<float> &values, std::string &errorStr)
+{
+    NetCDFVariable currentVar = getVariableFromId(idVar);
+    if (currentVar.getVarName() == "")
+    {
+        errorStr = "Wrong variable.";
+        return false;
+    }
+    if (! checkDataType(currentVar.type, errorStr))
+        return false;
+
+    if (rows.size() != cols.size() || firstTimeIndex < 0 || nrTimes < 0 || firstTimeIndex + nrTimes > nrTime)
+    {
+        errorStr = "Wrong points or time indexes.";
+        return false;
+    }
+
+    long nrFileRows = getDimensionLength(indexYLonDim);
+    long nrFileCols = getDimensionLength(indexXLatDim);
+
+    unsigned nrPoints = unsigned(rows.size());
+    if (nrPoints == 0)
+    {
+        values.clear();
+        return true;
+    }
+
+    int rowMin = rows[0], rowMax = rows[0];
+    int colMin = cols[0], colMax = cols[0];
+    for (unsigned p = 0; p < nrPoints; p++)
+    {
+        if (rows[p] < 0 || rows[p] >= nrFileRows || cols[p] < 0 || cols[p] >= nrFileCols)
+        {
+            errorStr = "Point out of grid.";
+            return false;
+        }
+        rowMin = std::min(rowMin, rows[p]);
+        rowMax = std::max(rowMax, rows[p]);
+        colMin = std::min(colMin, cols[p]);
+        colMax = std::max(colMax, cols[p]);
+    }
+
+    values.resize(size_t(nrPoints) * size_t(nrTimes));
+
+    size_t nrBoxRows = size_t(rowMax - rowMin + 1);
+    size_t nrBoxCols = size_t(colMax - colMin + 1);
+    size_t boxSize = nrBoxRows * nrBoxCols;
+    std::vector<double> blockValues;
+
+    if (boxSize <= size_t(nrPoints) * 16 && boxSize <= NETCDF_BLOCK_MAX_VALUES)
+    {
+        size_t chunkSize = size_t(getTimeChunkSize(idVar));
+        size_t timeBlock = std::max(size_t(1), size_t(NETCDF_BLOCK_MAX_VALUES) / boxSize);
+        if (timeBlock > chunkSize)
+            timeBlock -= timeBlock % chunkSize;
+
+        for (size_t t0 = 0; t0 < size_t(nrTimes); t0 += timeBlock)
+        {
+            size_t nrBlockTimes = std::min(timeBlock, size_t(nrTimes) - t0);
+            size_t start[] = {size_t(firstTimeIndex) + t0, size_t(rowMin), size_t(colMin)};
+            size_t count[] = {nrBlockTimes, nrBoxRows, nrBoxCols};
+            if (! readVariableBlock(idVar, start, count, blockValues, errorStr))
+                return false;
+
+            for (unsigned p = 0; p < nrPoints; p++)
             {
-                nc_get_var1_float(ncId, idVar, index, &value);
+                size_t boxIndex = size_t(rows[p] - rowMin) * nrBoxCols + size_t(cols[p] - colMin);
+                float* pointValues = values.data() + size_t(p) * size_t(nrTimes) + t0;
+                for (size_t t = 0; t < nrBlockTimes; t++)
+                {
+                    pointValues[t] = float(blockValues[t * boxSize + boxIndex]);
+                }
             }
-            if (currentVar.type <= NC_INT)
+        }
+    }
+    else
+    {
+        for (unsigned p = 0; p < nrPoints; p++)
+        {
+            size_t start[] = {size_t(firstTimeIndex), size_t(rows[p]), size_t(cols[p])};
+            size_t count[] = {size_t(nrTimes), 1, 1};
+            if (! readVariableBlock(idVar, start, count, blockValues, errorStr))
+                return false;
+
+            float* pointValues = values.data() + size_t(p) * size_t(nrTimes);
+            for (size_t t = 0; t < size_t(nrTimes); t++)
             {
-                int valueInt;
-                nc_get_var1_int(ncId, idVar, index, &valueInt);
-                value = float(valueInt);
+                pointValues[t] = float(blockValues[t]);
             }
-
-            dataGrid.value[row][col] = value;
         }
     }
 
-    delete[] index;
-
     return true;
 }
 
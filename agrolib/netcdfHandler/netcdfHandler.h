@@ -6,6 +6,10 @@
     #endif
 
     #include <sstream>
+    #include <vector>
+
+    // maximum number of values of a block read in memory (readPointsSeries)
+    #define NETCDF_BLOCK_MAX_VALUES 16777216
 
     class NetCDFVariable
     {
@@ -45,6 +49,13 @@
 
         gis::Crit3DRasterGrid dataGrid;
 
+        bool checkDataDimensions(std::string &errorStr);
+        bool checkDataType(int varType, std::string &errorStr);
+        long getDimensionLength(int dimIndex);
+        int getTimeChunkSize(int idVar);
+        bool readVariableBlock(int idVar, const size_t* start, const size_t* count,
+                               std::vector<double> &values, std::string &errorStr);
+
     public:
         int ncId;
         bool isUTM;
@@ -91,6 +102,7 @@
         std::string getDateTimeStr(int timeIndex);
 
         Crit3DTime getTime(int timeIndex);
+        int getTimeIndex(const Crit3DTime &myTime);
 
         NetCDFVariable getVariableFromId(int idVar);
         NetCDFVariable getVariableFromIndex(int index);
@@ -99,6 +111,12 @@
 
         bool readProperties(std::string fileName);
         bool exportDataSeries(int idVar, gis::Crit3DGeoPoint geoPoint, Crit3DTime seriesFirstTime, Crit3DTime seriesLastTime, std::stringstream *buffer);
+
+        bool readDataBlock(int idVar, int firstTimeIndex, int nrTimes, int firstRow, int nrRows, int firstCol, int nrCols,
+                           std::vector<float> &values, std::string &errorStr);
+        bool readPointsSeries(int idVar, const std::vector<int> &rows, const std::vector<int> &cols,
+                              int firstTimeIndex, int nrTimes, std::vector<float> &values, std::string &errorStr);
+
         bool extractVariableMap_old(int idVar, const Crit3DTime &myTime, std::string &error);
         bool extractVariableMap(int idVar, const Crit3DTime &myTime, std::string &errorStr);
 
@@ -38,8 +38,10 @@ macx:{
 }
 
 SOURCES += \
-    netcdfHandler.cpp
+    netcdfHandler.cpp \
+    netcdfSeriesWriter.cpp
 
 HEADERS += \
-    netcdfHandler.h
+    netcdfHandler.h \
+    netcdfSeriesWriter.h
 
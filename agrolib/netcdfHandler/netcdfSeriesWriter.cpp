@@ -0,0 +1,375 @@
+/*!
+    \copyright 2020 Fausto Tomei, Gabriele Antolini,
+    Alberto Pistocchi, Marco Bittelli, Antonio Volta, Laura Costantini
+
+    This file is part of AGROLIB.
+    AGROLIB has been developed under contract issued by ARPAE Emilia-Romagna
+
+    AGROLIB is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    AGROLIB is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with AGROLIB.  If not, see <http://www.gnu.org/licenses/>.
+
+    contacts:
+    ftomei@arpae.it
+    gantolini@arpae.it
+*/
+
+
+#include <algorithm>
+#include <netcdf.h>
+
+#include "commonConstants.h"
+#include "basicMath.h"
+#include "netcdfSeriesWriter.h"
+
+
+NetCDFSeriesWriter::NetCDFSeriesWriter()
+{
+    ncId = NODATA;
+    idTime = NODATA;
+    idLat = NODATA;
+    idLon = NODATA;
+    varTime = NODATA;
+    nrRows = 0;
+    nrCols = 0;
+
+    chunkLayout = chunkSeries;
+    chunkDays = NETCDF_SERIES_CHUNK_DAYS;
+    chunkRows = NETCDF_SERIES_CHUNK_CELLS;
+    chunkCols = NETCDF_SERIES_CHUNK_CELLS;
+    deflateLevel = 1;
+    isShuffle = true;
+
+    firstBufferDay = 0;
+    nrBufferDays = 0;
+    nrWrittenDays = 0;
+}
+
+
+NetCDFSeriesWriter::~NetCDFSeriesWriter()
+{
+    std::string errorStr;
+    close(errorStr);
+}
+
+
+/*!
+ * \brief setChunkLayout
+ * to be called before create()
+ */
+void NetCDFSeriesWriter::setChunkLayout(netcdfChunkLayout layout, int nrChunkDays, int nrChunkCells)
+{
+    chunkLayout = layout;
+    chunkDays = std::max(1, nrChunkDays);
+    chunkRows = std::max(1, nrChunkCells);
+    chunkCols = std::max(1, nrChunkCells);
+}
+
+
+/*!
+ * \brief setCompression
+ * deflate level [0-9] (0 = no compression) and byte shuffle filter; to be called before create()
+ */
+void NetCDFSeriesWriter::setCompression(int level, bool shuffle)
+{
+    deflateLevel = std::min(9, std::max(0, level));
+    isShuffle = shuffle;
+}
+
+
+bool NetCDFSeriesWriter::create(const std::string &fileName, const gis::Crit3DLatLonHeader &latLonHeader,
+                                const std::string &title, const Crit3DDate &myFirstDate,
+                                const std::vector<std::string> &variableNames, const std::vector<std::string> &variableUnits,
+                                std::string &errorStr)
+{
+    if (! close(errorStr))
+        return false;
+
+    if (variableNames.empty() || variableNames.size() != variableUnits.size())
+    {
+        errorStr = "Wrong variables.";
+        return false;
+    }
+
+    int status = nc_create(fileName.c_str(), NC_CLOBBER|NC_NETCDF4, &ncId);
+    if (status != NC_NOERR)
+    {
+        ncId = NODATA;
+        errorStr = "Wrong filename: " + fileName;
+        return false;
+    }
+
+    nrRows = latLonHeader.nrRows;
+    nrCols = latLonHeader.nrCols;
+    firstDate = myFirstDate;
+    varNames = variableNames;
+    varIds.resize(varNames.size());
+
+    if (chunkLayout == chunkMaps)
+    {
+        chunkDays = 1;
+        chunkRows = nrRows;
+        chunkCols = nrCols;
+    }
+    else
+    {
+        chunkRows = std::min(chunkRows, nrRows);
+        chunkCols = std::min(chunkCols, nrCols);
+    }
+
+    // global attributes
+    status = nc_put_att_text(ncId, NC_GLOBAL, "title", title.length(), title.c_str());
+    if (status == NC_NOERR)
+        status = nc_put_att_text(ncId, NC_GLOBAL, "history", 11, "Version 1.0");
+    if (status == NC_NOERR)
+        status = nc_put_att_text(ncId, NC_GLOBAL, "Conventions", 6, "CF-1.7");
+
+    // dimensions
+    if (status == NC_NOERR)
+        status = nc_def_dim(ncId, "time", NC_UNLIMITED, &idTime);
+    if (status == NC_NOERR)
+        status = nc_def_dim(ncId, "lat", size_t(nrRows), &idLat);
+    if (status == NC_NOERR)
+        status = nc_def_dim(ncId, "lon", size_t(nrCols), &idLon);
+
+    // time
+    int varLat, varLon;
+    if (status == NC_NOERR)
+        status = nc_def_var(ncId, "time", NC_FLOAT, 1, &idTime, &varTime);
+    if (status == NC_NOERR)
+    {
+        size_t timeChunk = size_t(std::max(chunkDays, NETCDF_SERIES_CHUNK_DAYS));
+        status = nc_def_var_chunking(ncId, varTime, NC_CHUNKED, &timeChunk);
+    }
+    if (status == NC_NOERR)
+        status = nc_put_att_text(ncId, varTime, "standard_name", 4, "time");
+    if (status == NC_NOERR)
+    {
+        std::string timeUnits = "days since " + firstDate.toStdString();
+        status = nc_put_att_text(ncId, varTime, "units", timeUnits.length(), timeUnits.c_str());
+    }
+    if (status == NC_NOERR)
+        status = nc_put_att_text(ncId, varTime, "calendar", 9, "gregorian");
+
+    // lat/lon
+    if (status == NC_NOERR)
+        status = nc_def_var(ncId, "lat", NC_FLOAT, 1, &idLat, &varLat);
+    if (status == NC_NOERR)
+        status = nc_put_att_text(ncId, varLat, "standard_name", 8, "latitude");
+    if (status == NC_NOERR)
+        status = nc_put_att_text(ncId, varLat, "units", 13, "degrees_north");
+    if (status == NC_NOERR)
+        status = nc_def_var(ncId, "lon", NC_FLOAT, 1, &idLon, &varLon);
+    if (status == NC_NOERR)
+        status = nc_put_att_text(ncId, varLon, "standard_name", 9, "longitude");
+    if (status == NC_NOERR)
+        status = nc_put_att_text(ncId, varLon, "units", 12, "degrees_east");
+
+    // variables
+    int varDimId[3] = {idTime, idLat, idLon};
+    size_t chunkSizes[3] = {size_t(chunkDays), size_t(chunkRows), size_t(chunkCols)};
+    float missing = NODATA;
+
+    for (unsigned int i = 0; i < varNames.size() && status == NC_NOERR; i++)
+    {
+        status = nc_def_var(ncId, varNames[i].c_str(), NC_FLOAT, 3, varDimId, &(varIds[i]));
+        if (status == NC_NOERR)
+            status = nc_def_var_chunking(ncId, varIds[i], NC_CHUNKED, chunkSizes);
+        if (status == NC_NOERR && deflateLevel > 0)
+            status = nc_def_var_deflate(ncId, varIds[i], isShuffle ? NC_SHUFFLE : 0, 1, deflateLevel);
+        // days not written are missing
+        if (status == NC_NOERR)
+            status = nc_def_var_fill(ncId, varIds[i], 0, &missing);
+        if (status == NC_NOERR)
+            status = nc_put_att_text(ncId, varIds[i], "long_name", varNames[i].length(), varNames[i].c_str());
+        // units are not required for dimensionless quantities
+        if (status == NC_NOERR && variableUnits[i] != "")
+            status = nc_put_att_text(ncId, varIds[i], "units", variableUnits[i].length(), variableUnits[i].c_str());
+        if (status == NC_NOERR)
+            status = nc_put_att_float(ncId, varIds[i], "missing_value", NC_FLOAT, 1, &missing);
+    }
+
+    // end of metadata
+    if (status == NC_NOERR)
+        status = nc_enddef(ncId);
+
+    // write lat/lon vectors (same as NetCDFHandler::writeMetadata)
+    if (status == NC_NOERR)
+    {
+        std::vector<float> lat, lon;
+        lat.resize(unsigned(nrRows));
+        lon.resize(unsigned(nrCols));
+        for (int row = 0; row < nrRows; row++)
+        {
+            lat[unsigned(row)] = float(latLonHeader.llCorner.latitude + latLonHeader.dy * (nrRows - row - 0.5));
+        }
+        for (int col = 0; col < nrCols; col++)
+        {
+            lon[unsigned(col)] = float(latLonHeader.llCorner.longitude + latLonHeader.dx * (col + 0.5));
+        }
+
+        status = nc_put_var_float(ncId, varLat, lat.data());
+        if (status == NC_NOERR)
+            status = nc_put_var_float(ncId, varLon, lon.data());
+    }
+
+    if (status != NC_NOERR)
+    {
+        errorStr = nc_strerror(status);
+        nc_close(ncId);
+        ncId = NODATA;
+        return false;
+    }
+
+    // one row of chunks for each variable
+    size_t bufferSize = size_t(chunkDays) * size_t(nrRows) * size_t(nrCols);
+    buffers.resize(varNames.size());
+    for (unsigned int i = 0; i < buffers.size(); i++)
+    {
+        buffers[i].assign(bufferSize, NODATA);
+    }
+
+    firstBufferDay = 0;
+    nrBufferDays = 0;
+    nrWrittenDays = 0;
+
+    return true;
+}
+
+
+/*!
+ * \brief writeDay
+ * appends the map of a variable for a day; days must be written in chronological order
+ * (all the variables of a day before the following days, missing days are allowed).
+ * Flagged and not active cells are written as NODATA
+ */
+bool NetCDFSeriesWriter::writeDay(const Crit3DDate &myDate, const std::string &variableName,
+                                  const gis::Crit3DRasterGrid &myDataGrid, std::string &errorStr)
+{
+    if (! isOpen())
+    {
+        errorStr = "NetCDF file is not open.";
+        return false;
+    }
+
+    unsigned int varIndex = 0;
+    while (varIndex < varNames.size() && varNames[varIndex] != variableName)
+        varIndex++;
+
+    if (varIndex == varNames.size())
+    {
+        errorStr = "Missing variable: " + variableName;
+        return false;
+    }
+
+    if (myDataGrid.header->nrRows != nrRows || myDataGrid.header->nrCols != nrCols)
+    {
+        errorStr = "Wrong grid size.";
+        return false;
+    }
+
+    int dayIndex = firstDate.daysTo(myDate);
+    if (dayIndex < firstBufferDay)
+    {
+        errorStr = "Wrong date: " + myDate.toStdString() + " is already written.";
+        return false;
+    }
+
+    if (dayIndex >= firstBufferDay + chunkDays)
+    {
+        if (! flush(errorStr))
+            return false;
+
+        // buffer aligned with the chunks
+        firstBufferDay = dayIndex - dayIndex % chunkDays;
+    }
+
+    nrBufferDays = std::max(nrBufferDays, dayIndex - firstBufferDay + 1);
+
+    float* values = buffers[varIndex].data() + size_t(dayIndex - firstBufferDay) * size_t(nrRows) * size_t(nrCols);
+    for (int row = 0; row < nrRows; row++)
+    {
+        for (int col = 0; col < nrCols; col++)
+        {
+            float value = myDataGrid.value[row][col];
+            // check on not active cells (for meteo grid)
+            if (isEqual(value, myDataGrid.header->flag) || isEqual(value, NO_ACTIVE))
+                value = NODATA;
+
+            values[row * nrCols + col] = value;
+        }
+    }
+
+    return true;
+}
+
+
+// writes the buffered days of all the variables
+bool NetCDFSeriesWriter::flush(std::string &errorStr)
+{
+    if (nrBufferDays == 0)
+        return true;
+
+    size_t start[3] = {size_t(firstBufferDay), 0, 0};
+    size_t count[3] = {size_t(nrBufferDays), size_t(nrRows), size_t(nrCols)};
+
+    std::vector<float> timeValues;
+    timeValues.resize(unsigned(nrBufferDays));
+    for (int i = 0; i < nrBufferDays; i++)
+    {
+        timeValues[unsigned(i)] = float(firstBufferDay + i);
+    }
+
+    int status = nc_put_vara_float(ncId, varTime, start, count, timeValues.data());
+
+    for (unsigned int i = 0; i < varIds.size() && status == NC_NOERR; i++)
+    {
+        status = nc_put_vara_float(ncId, varIds[i], start, count, buffers[i].data());
+        std::fill(buffers[i].begin(), buffers[i].begin() + long(count[0] * count[1] * count[2]), float(NODATA));
+    }
+
+    if (status != NC_NOERR)
+    {
+        errorStr = nc_strerror(status);
+        return false;
+    }
+
+    nrWrittenDays = std::max(nrWrittenDays, firstBufferDay + nrBufferDays);
+    nrBufferDays = 0;
+
+    return true;
+}
+
+
+bool NetCDFSeriesWriter::close(std::string &errorStr)
+{
+    if (! isOpen())
+        return true;
+
+    bool isOk = flush(errorStr);
+
+    int status = nc_close(ncId);
+    if (isOk && status != NC_NOERR)
+    {
+        errorStr = nc_strerror(status);
+        isOk = false;
+    }
+
+    ncId = NODATA;
+    varNames.clear();
+    varIds.clear();
+    buffers.clear();
+    firstBufferDay = 0;
+    nrBufferDays = 0;
+
+    return isOk;
+}
@@ -0,0 +1,76 @@
+#ifndef NETCDFSERIESWRITER_H
+#define NETCDFSERIESWRITER_H
+
+    #ifndef COMMONCONSTANTS_H
+        #include "commonConstants.h"
+    #endif
+    #ifndef GIS_H
+        #include "gis.h"
+    #endif
+
+    #include <string>
+    #include <vector>
+
+    // default chunk shape of the series layout: time steps, rows, cols
+    #define NETCDF_SERIES_CHUNK_DAYS 365
+    #define NETCDF_SERIES_CHUNK_CELLS 16
+
+    enum netcdfChunkLayout {chunkMaps, chunkSeries};
+
+    /*!
+     * \brief The NetCDFSeriesWriter class
+     * streaming writer of daily grids to a NetCDF-4 file with an unlimited time dimension.
+     * chunkMaps: one chunk is a whole map (fast map access)
+     * chunkSeries: one chunk is chunkDays x chunkCells x chunkCells (fast series access);
+     * days are buffered in memory (chunkDays maps for each variable) and written one
+     * chunk row at a time, so that each chunk is compressed once
+     */
+    class NetCDFSeriesWriter
+    {
+    private:
+        int ncId;
+        int idTime, idLat, idLon, varTime;
+        int nrRows, nrCols;
+
+        netcdfChunkLayout chunkLayout;
+        int chunkDays, chunkRows, chunkCols;
+        int deflateLevel;
+        bool isShuffle;
+
+        Crit3DDate firstDate;
+        std::vector<std::string> varNames;
+        std::vector<int> varIds;
+
+        // buffered days: [variable][day * nrRows * nrCols + row * nrCols + col]
+        std::vector<std::vector<float>> buffers;
+        int firstBufferDay;
+        int nrBufferDays;
+        int nrWrittenDays;
+
+        bool flush(std::string &errorStr);
+
+    public:
+        NetCDFSeriesWriter();
+        ~NetCDFSeriesWriter();
+
+        void setChunkLayout(netcdfChunkLayout layout, int nrChunkDays = NETCDF_SERIES_CHUNK_DAYS,
+                            int nrChunkCells = NETCDF_SERIES_CHUNK_CELLS);
+        void setCompression(int level, bool shuffle);
+
+        inline bool isOpen() const { return ncId != NODATA; }
+        inline int getNrWrittenDays() const { return nrWrittenDays; }
+        inline const std::vector<std::string>& getVariableNames() const { return varNames; }
+
+        bool create(const std::string &fileName, const gis::Crit3DLatLonHeader &latLonHeader,
+                    const std::string &title, const Crit3DDate &myFirstDate,
+                    const std::vector<std::string> &variableNames, const std::vector<std::string> &variableUnits,
+                    std::string &errorStr);
+
+        bool writeDay(const Crit3DDate &myDate, const std::string &variableName,
+                      const gis::Crit3DRasterGrid &myDataGrid, std::string &errorStr);
+
+        bool close(std::string &errorStr);
+    };
+
+
+#endif // NETCDFSERIESWRITER_H
@@ -12,11 +12,19 @@
 #include "interpolationCmd.h"
 #include "interpolation.h"
 #include "pragaProject.h"
+#include "parallel.h"
 #include <qdebug.h>
 #include <QFile>
 #include <QDir>
 #include <QtSql>
 
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 PragaProject::PragaProject()
 {
     initializePragaProject();
@@ -57,6 +65,7 @@ void PragaProject::clearPragaProject()
     users.clear();
 
     dataRaster.clear();
+    droughtGrid.clear();
 
     if (clima != nullptr)
     {
@@ -1156,16 +1165,30 @@ bool PragaProject::elaborationPointsCycleGrid(bool isAnomaly, bool showInfo)
         }
     }
 
-    bool dataAlreadyLoaded = false;
+    int nrRows = meteoGridDbHandler->gridStructure().header().nrRows;
+    int nrCols = meteoGridDbHandler->gridStructure().header().nrCols;
+    int nrWorkers = std::min(parallel::getNrThreads(interpolationSettings.getNrThreads()), nrRows);
+    nrWorkers = std::max(nrWorkers, 1);
 
-    for (int row = 0; row < meteoGridDbHandler->gridStructure().header().nrRows; row++)
+    // each worker has its own copy of the elaboration and of the meteo settings
+    std::vector<Crit3DClimate*> workerClima;
+    std::vector<Crit3DMeteoSettings> workerSettings(unsigned(nrWorkers), *meteoSettings);
+    std::vector<QString> workerErrors(unsigned(nrWorkers));
+    std::vector<int> workerValidCells(unsigned(nrWorkers), 0);
+    for (int i = 0; i < nrWorkers; i++)
     {
-        if (showInfo && (row % infoStep) == 0)
-            updateProgressBar(row);
+        workerClima.push_back(new Crit3DClimate());
+        workerClima.back()->copyParam(climaUsed);
+    }
 
-        for (int col = 0; col < meteoGridDbHandler->gridStructure().header().nrCols; col++)
-        {
+    auto computeRow = [&](int row, int workerIndex, Crit3DMeteoGridDbHandler* gridDbHandler)
+    {
+        unsigned int w = unsigned(workerIndex);
+        workerClima[w]->setDb(gridDbHandler->db());
+        std::string id;
 
+        for (int col = 0; col < nrCols; col++)
+        {
             if (meteoGridDbHandler->meteoGrid()->getMeteoPointActiveId(row, col, &id))
             {
                 Crit3DMeteoPoint* meteoPoint = meteoGridDbHandler->meteoGrid()->meteoPointPointer(row,col);
@@ -1181,18 +1204,18 @@ bool PragaProject::elaborationPointsCycleGrid(bool isAnomaly, bool showInfo)
                 meteoPointTemp->nrObsDataDaysH = 0;
                 meteoPointTemp->nrObsDataDaysD = 0;
 
-                if (isAnomaly && climaUsed->getIsClimateAnomalyFromDb())
+                if (isAnomaly && workerClima[w]->getIsClimateAnomalyFromDb())
                 {
-                    if ( passingClimateToAnomalyGrid(&errorString, meteoPointTemp, climaUsed))
+                    if ( passingClimateToAnomalyGrid(&workerErrors[w], meteoPointTemp, workerClima[w]))
                     {
-                        validCell += 1;
+                        workerValidCells[w] += 1;
                     }
                 }
                 else
                 {
-                    if  ( elaborationOnPoint(&errorString, nullptr, meteoGridDbHandler, meteoPointTemp, climaUsed, isMeteoGrid, startDate, endDate, isAnomaly, meteoSettings, dataAlreadyLoaded))
+                    if  ( elaborationOnPoint(&workerErrors[w], nullptr, gridDbHandler, meteoPointTemp, workerClima[w], isMeteoGrid, startDate, endDate, isAnomaly, &workerSettings[w], false))
                     {
-                        validCell += 1;
+                        workerValidCells[w] += 1;
                     }
                 }
 
@@ -1201,17 +1224,39 @@ bool PragaProject::elaborationPointsCycleGrid(bool isAnomaly, bool showInfo)
                 meteoPoint->anomaly = meteoPointTemp->anomaly;
                 meteoPoint->anomalyPercentage = meteoPointTemp->anomalyPercentage;
                 delete meteoPointTemp;
-
             }
+        }
+    };
 
+    bool isOk = true;
+    if (nrWorkers == 1)
+    {
+        for (int row = 0; row < nrRows; row++)
+        {
+            if (showInfo && (row % infoStep) == 0)
+                updateProgressBar(row);
+
+            computeRow(row, 0, meteoGridDbHandler);
         }
     }
+    else
+    {
+        isOk = computeMeteoGridRows(nrWorkers, showInfo, computeRow, [](){ return true; });
+    }
+
+    for (int i = 0; i < nrWorkers; i++)
+    {
+        validCell += workerValidCells[unsigned(i)];
+        if (errorString.isEmpty())
+            errorString = workerErrors[unsigned(i)];
+        delete workerClima[unsigned(i)];
+    }
 
     if (showInfo) closeProgressBar();
 
-    if (validCell == 0)
+    if (! isOk || validCell == 0)
     {
-        if (errorString.isEmpty())
+        if (isOk && errorString.isEmpty())
         {
             errorString = "no valid cells available";
         }
@@ -1227,6 +1272,18 @@ bool PragaProject::elaborationPointsCycleGrid(bool isAnomaly, bool showInfo)
 }
 
 
+// writes the results staged during a climate cycle and detaches the writer
+static bool flushClimateResults(Crit3DClimate* clima, QString &errorStr)
+{
+    Crit3DClimateDbWriter* dbWriter = clima->dbWriter();
+    clima->setDbWriter(nullptr);
+    if (dbWriter == nullptr)
+        return true;
+
+    return dbWriter->flush(&errorStr);
+}
+
+
 bool PragaProject::climatePointsCycle(bool showInfo)
 {
     bool isMeteoGrid = false;
@@ -1257,6 +1314,11 @@ bool PragaProject::climatePointsCycle(bool showInfo)
         errorString = "";
     }
 
+    // results are written in bulk transactions
+    Crit3DClimateDbWriter dbWriter(clima->db());
+    clima->setDbWriter(&dbWriter);
+    QString flushError;
+
     Crit3DMeteoPoint* meteoPointTemp = new Crit3DMeteoPoint;
     for (int i = 0; i < nrMeteoPoints; i++)
     {
@@ -1316,6 +1378,7 @@ bool PragaProject::climatePointsCycle(bool showInfo)
                 }
                 else
                 {
+                    flushClimateResults(clima, flushError);
                     errorString = "parser elaboration error";
                     delete meteoPointTemp;
                     return false;
@@ -1333,6 +1396,14 @@ bool PragaProject::climatePointsCycle(bool showInfo)
     }
     if (showInfo) closeProgressBar();
 
+    if (! flushClimateResults(clima, flushError))
+    {
+        errorString = "Error in saving climate: " + flushError;
+        logError(errorString);
+        delete meteoPointTemp;
+        return false;
+    }
+
     if (validCell == 0)
     {
         if (errorString.isEmpty())
@@ -1352,27 +1423,196 @@ bool PragaProject::climatePointsCycle(bool showInfo)
 }
 
 
-bool PragaProject::climatePointsCycleGrid(bool showInfo)
+// climate elaborations loading the same data: the union of their periods is loaded once
+struct TClimateDataGroup
 {
+    std::vector<int> elabIndexes;
+    QDate firstDate;
+    QDate lastDate;
+    int yearStart;
+    int yearEnd;
+};
 
-    bool isMeteoGrid = true;
-    int infoStep;
-    QString infoStr;
 
-    int validCell = 0;
-    QDate startDate;
-    QDate endDate;
-    std::string id;
-    bool changeDataSet = true;
+// copies the elaboration index of the list to clima
+static void setClimateFromList(Crit3DClimate* clima, Crit3DClimateList* climateList, int index)
+{
+    unsigned int i = unsigned(index);
+
+    clima->setClimateElab(climateList->listClimateElab().at(index));
+    clima->setDailyCumulated(climateList->listDailyCumulated()[i]);
+    clima->setYearStart(climateList->listYearStart()[i]);
+    clima->setYearEnd(climateList->listYearEnd()[i]);
+    clima->setPeriodType(climateList->listPeriodType()[i]);
+    clima->setPeriodStr(climateList->listPeriodStr()[i]);
+    clima->setGenericPeriodDateStart(climateList->listGenericPeriodDateStart()[i]);
+    clima->setGenericPeriodDateEnd(climateList->listGenericPeriodDateEnd()[i]);
+    clima->setNYears(climateList->listNYears()[i]);
+    clima->setVariable(climateList->listVariable()[i]);
+    clima->setElab1(climateList->listElab1()[i]);
+    clima->setElab2(climateList->listElab2()[i]);
+    clima->setParam1(climateList->listParam1()[i]);
+    clima->setParam2(climateList->listParam2()[i]);
+    clima->setParam1IsClimate(climateList->listParam1IsClimate()[i]);
+    clima->setParam1ClimateField(climateList->listParam1ClimateField()[i]);
+}
 
-    errorString.clear();
-    clima->resetCurrentValues();
 
-    if (showInfo)
+// period of the data needed by the elaboration index of the list
+static void getClimateDataPeriod(Crit3DClimateList* climateList, int index, QDate &startDate, QDate &endDate)
+{
+    unsigned int i = unsigned(index);
+    int yearStart = climateList->listYearStart()[i];
+    int yearEnd = climateList->listYearEnd()[i];
+
+    if (climateList->listPeriodType()[i] == genericPeriod)
+    {
+        QDate dateStart = climateList->listGenericPeriodDateStart()[i];
+        QDate dateEnd = climateList->listGenericPeriodDateEnd()[i];
+        startDate.setDate(yearStart, dateStart.month(), dateStart.day());
+        endDate.setDate(yearEnd + climateList->listNYears()[i], dateEnd.month(), dateEnd.day());
+    }
+    else if (climateList->listPeriodType()[i] == seasonalPeriod)
+    {
+        startDate.setDate(yearStart -1, 12, 1);
+        endDate.setDate(yearEnd, 12, 31);
+    }
+    else
     {
-        infoStr = "Climate  - Meteo Grid";
-        infoStep = setProgressBar(infoStr, this->meteoGridDbHandler->gridStructure().header().nrRows);
+        startDate.setDate(yearStart, 1, 1);
+        endDate.setDate(yearEnd, 12, 31);
     }
+}
+
+
+/*!
+ * \brief getClimateDataGroups
+ * groups the elaborations of the list that load the same data: same variable, and same elab1 for
+ * the computations that load other variables (as in climateOnPoint).
+ * If isReorder is false, only consecutive elaborations are grouped and the order of the list is kept
+ */
+static std::vector<TClimateDataGroup> getClimateDataGroups(Crit3DClimateList* climateList, bool isReorder)
+{
+    std::vector<TClimateDataGroup> groups;
+    std::vector<QString> groupKeys;
+
+    std::vector<meteoVariable> variables = climateList->listVariable();
+    std::vector<QString> elab1List = climateList->listElab1();
+    std::vector<int> yearStartList = climateList->listYearStart();
+    std::vector<int> yearEndList = climateList->listYearEnd();
+
+    for (int j = 0; j < climateList->listClimateElab().size(); j++)
+    {
+        unsigned int i = unsigned(j);
+        QString key = QString::number(int(variables[i]));
+        meteoComputation elab1MeteoComp = getMeteoCompFromString(MapMeteoComputation, elab1List[i].toStdString());
+        if (elab1MeteoComp == correctedDegreeDaysSum || elab1MeteoComp == huglin || elab1MeteoComp == winkler
+            || elab1MeteoComp == fregoni || elab1MeteoComp == phenology)
+        {
+            key += "_" + elab1List[i];
+        }
+
+        QDate startDate, endDate;
+        getClimateDataPeriod(climateList, j, startDate, endDate);
+
+        int groupIndex = NODATA;
+        if (isReorder)
+        {
+            for (unsigned int k = 0; k < groupKeys.size(); k++)
+            {
+                if (groupKeys[k] == key)
+                    groupIndex = int(k);
+            }
+        }
+        else if (! groupKeys.empty() && groupKeys.back() == key)
+        {
+            groupIndex = int(groupKeys.size()) - 1;
+        }
+
+        if (groupIndex == NODATA)
+        {
+            TClimateDataGroup group;
+            group.firstDate = startDate;
+            group.lastDate = endDate;
+            group.yearStart = yearStartList[i];
+            group.yearEnd = yearEndList[i];
+            groups.push_back(group);
+            groupKeys.push_back(key);
+            groupIndex = int(groups.size()) - 1;
+        }
+        else
+        {
+            TClimateDataGroup &group = groups[unsigned(groupIndex)];
+            if (! group.firstDate.isValid() || (startDate.isValid() && startDate < group.firstDate))
+                group.firstDate = startDate;
+            if (! group.lastDate.isValid() || (endDate.isValid() && endDate > group.lastDate))
+                group.lastDate = endDate;
+            group.yearStart = std::min(group.yearStart, yearStartList[i]);
+            group.yearEnd = std::max(group.yearEnd, yearEndList[i]);
+        }
+
+        groups[unsigned(groupIndex)].elabIndexes.push_back(j);
+    }
+
+    return groups;
+}
+
+
+/*!
+ * \brief computeClimateOnCell
+ * computes all the climate elaborations of a grid cell: the data of each group are loaded once
+ * \return number of valid elaborations
+ */
+static int computeClimateOnCell(QString &errorStr, Crit3DMeteoGridDbHandler* gridDbHandler, Crit3DClimate* clima,
+                                Crit3DClimateList* climateList, const std::vector<TClimateDataGroup> &groups,
+                                Crit3DMeteoPoint* meteoPointTemp, Crit3DMeteoSettings* meteoSettings)
+{
+    int nrValid = 0;
+    std::vector<float> outputValues;
+
+    for (unsigned int g = 0; g < groups.size(); g++)
+    {
+        bool changeDataSet = true;
+
+        for (unsigned int k = 0; k < groups[g].elabIndexes.size(); k++)
+        {
+            clima->resetParam();
+            setClimateFromList(clima, climateList, groups[g].elabIndexes[k]);
+
+            if (climateOnPoint(&errorStr, nullptr, gridDbHandler, clima, meteoPointTemp, outputValues, true,
+                               groups[g].firstDate, groups[g].lastDate, changeDataSet, meteoSettings))
+            {
+                nrValid++;
+            }
+
+            if (changeDataSet)
+            {
+                // the loaded data cover all the years of the group
+                clima->setCurrentYearStart(groups[g].yearStart);
+                clima->setCurrentYearEnd(groups[g].yearEnd);
+                changeDataSet = false;
+            }
+        }
+    }
+
+    return nrValid;
+}
+
+
+/*!
+ * \brief climatePointsCycleGrid
+ * the cells are computed by a pool of worker threads (interpolation threads number), each one with its
+ * own connection to the grid db, climate and meteo settings; the results are written by the calling
+ * thread with a single Crit3DClimateDbWriter.
+ * If a parameter is read from the climate db, the elaborations are computed serially in the order of the list
+ * (the parameter may be a result of the same run)
+ */
+bool PragaProject::climatePointsCycleGrid(bool showInfo)
+{
+    int validCell = 0;
+
+    errorString.clear();
+    clima->resetCurrentValues();
 
     // parser all the list
     Crit3DClimateList* climateList = clima->getListElab();
@@ -1385,111 +1625,284 @@ bool PragaProject::climatePointsCycleGrid(bool showInfo)
         errorString = "";
     }
 
-    Crit3DMeteoPoint* meteoPointTemp = new Crit3DMeteoPoint;
-    for (int row = 0; row < meteoGridDbHandler->gridStructure().header().nrRows; row++)
-    {
-        if (showInfo && (row % infoStep) == 0)
-            updateProgressBar(row);
-
-        for (int col = 0; col < meteoGridDbHandler->gridStructure().header().nrCols; col++)
-        {
-
-           if (meteoGridDbHandler->meteoGrid()->getMeteoPointActiveId(row, col, &id))
-           {
-
-               Crit3DMeteoPoint* meteoPoint = meteoGridDbHandler->meteoGrid()->meteoPointPointer(row,col);
-
-               meteoPointTemp->id = meteoPoint->id;
-               meteoPointTemp->point.z = meteoPoint->point.z;
-               meteoPointTemp->latitude = meteoPoint->latitude;
-
-               changeDataSet = true;
-               std::vector<float> outputValues;
-
-               for (int j = 0; j < climateList->listClimateElab().size(); j++)
-               {
-
-                   clima->resetParam();
-                   clima->setClimateElab(climateList->listClimateElab().at(j));
-
-
-                   if (climateList->listClimateElab().at(j)!= nullptr)
-                   {
-
-                       // copy current elaboration to clima
-                       clima->setDailyCumulated(climateList->listDailyCumulated()[j]);
-                       clima->setYearStart(climateList->listYearStart().at(j));
-                       clima->setYearEnd(climateList->listYearEnd().at(j));
-                       clima->setPeriodType(climateList->listPeriodType().at(j));
-                       clima->setPeriodStr(climateList->listPeriodStr().at(j));
-                       clima->setGenericPeriodDateStart(climateList->listGenericPeriodDateStart().at(j));
-                       clima->setGenericPeriodDateEnd(climateList->listGenericPeriodDateEnd().at(j));
-                       clima->setNYears(climateList->listNYears().at(j));
-                       clima->setVariable(climateList->listVariable().at(j));
-                       clima->setElab1(climateList->listElab1().at(j));
-                       clima->setElab2(climateList->listElab2().at(j));
-                       clima->setParam1(climateList->listParam1().at(j));
-                       clima->setParam2(climateList->listParam2().at(j));
-                       clima->setParam1IsClimate(climateList->listParam1IsClimate().at(j));
-                       clima->setParam1ClimateField(climateList->listParam1ClimateField().at(j));
-
-                       if (clima->periodType() == genericPeriod)
-                       {
-                           startDate.setDate(clima->yearStart(), clima->genericPeriodDateStart().month(), clima->genericPeriodDateStart().day());
-                           endDate.setDate(clima->yearEnd() + clima->nYears(), clima->genericPeriodDateEnd().month(), clima->genericPeriodDateEnd().day());
-                       }
-                       else if (clima->periodType() == seasonalPeriod)
-                       {
-                           startDate.setDate(clima->yearStart() -1, 12, 1);
-                           endDate.setDate(clima->yearEnd(), 12, 31);
-                       }
-                       else
-                       {
-                           startDate.setDate(clima->yearStart(), 1, 1);
-                           endDate.setDate(clima->yearEnd(), 12, 31);
-                       }
-
-                   }
-                   else
-                   {
-                       errorString = "parser elaboration error";
-                       delete meteoPointTemp;
-                       return false;
-                   }
-
-                   if (climateOnPoint(&errorString, nullptr, meteoGridDbHandler, clima, meteoPointTemp, outputValues, isMeteoGrid, startDate, endDate, changeDataSet, meteoSettings))
-                   {
-                       validCell = validCell + 1;
-                   }
-                   changeDataSet = false;
-
-               }
-
-           }
-       }
-   }
-
-   if (showInfo) closeProgressBar();
-
-   if (validCell == 0)
-   {
-       if (errorString.isEmpty())
-       {
-           errorString = "no valid cells available";
-       }
-       logError(errorString);
-       delete meteoPointTemp;
-       return false;
+    QList<QString> elabList = climateList->listClimateElab();
+    for (int j = 0; j < elabList.size(); j++)
+    {
+        if (elabList.at(j) == nullptr)
+        {
+            errorString = "parser elaboration error";
+            return false;
+        }
     }
-    else
+
+    std::vector<bool> isParam1Climate = climateList->listParam1IsClimate();
+    bool isReadingClimate = (std::find(isParam1Climate.begin(), isParam1Climate.end(), true) != isParam1Climate.end());
+
+    std::vector<TClimateDataGroup> groups = getClimateDataGroups(climateList, ! isReadingClimate);
+
+    int nrRows = meteoGridDbHandler->gridStructure().header().nrRows;
+    int nrCols = meteoGridDbHandler->gridStructure().header().nrCols;
+    int nrWorkers = 1;
+    if (! isReadingClimate)
     {
-       logInfo("climate saved");
+        nrWorkers = std::max(1, std::min(parallel::getNrThreads(interpolationSettings.getNrThreads()), nrRows));
+    }
+
+    int infoStep = 1;
+    if (showInfo)
+    {
+        infoStep = setProgressBar("Climate  - Meteo Grid", nrRows);
+    }
+
+    // results are written in bulk transactions
+    Crit3DClimateDbWriter dbWriter(clima->db());
+    QString flushError;
+    bool isOk = true;
+
+    if (nrWorkers == 1)
+    {
+        clima->setDbWriter(&dbWriter);
+        Crit3DMeteoPoint* meteoPointTemp = new Crit3DMeteoPoint;
+        std::string id;
+
+        for (int row = 0; row < nrRows; row++)
+        {
+            if (showInfo && (row % infoStep) == 0)
+                updateProgressBar(row);
+
+            for (int col = 0; col < nrCols; col++)
+            {
+                if (meteoGridDbHandler->meteoGrid()->getMeteoPointActiveId(row, col, &id))
+                {
+                    Crit3DMeteoPoint* meteoPoint = meteoGridDbHandler->meteoGrid()->meteoPointPointer(row,col);
+
+                    meteoPointTemp->id = meteoPoint->id;
+                    meteoPointTemp->point.z = meteoPoint->point.z;
+                    meteoPointTemp->latitude = meteoPoint->latitude;
+
+                    validCell += computeClimateOnCell(errorString, meteoGridDbHandler, clima, climateList, groups,
+                                                      meteoPointTemp, meteoSettings);
+                }
+            }
+        }
         delete meteoPointTemp;
+
+        if (! flushClimateResults(clima, flushError))
+        {
+            errorString = "Error in saving climate: " + flushError;
+            isOk = false;
+        }
+    }
+    else
+    {
+        // the workers stage their results, moved to the writer by the calling thread
+        std::vector<Crit3DClimate*> workerClima;
+        std::vector<Crit3DClimateDbWriter*> workerResults;
+        std::vector<Crit3DMeteoPoint*> workerPoints;
+        std::vector<Crit3DMeteoSettings> workerSettings(unsigned(nrWorkers), *meteoSettings);
+        std::vector<QString> workerErrors(unsigned(nrWorkers));
+        std::vector<int> workerValidCells(unsigned(nrWorkers), 0);
+
+        for (int i = 0; i < nrWorkers; i++)
+        {
+            workerResults.push_back(new Crit3DClimateDbWriter(clima->db()));
+            workerResults.back()->setMaxStagedValues(INT_MAX);
+            workerClima.push_back(new Crit3DClimate());
+            workerClima.back()->setDbWriter(workerResults.back());
+            workerPoints.push_back(new Crit3DMeteoPoint);
+        }
+
+        std::mutex resultsMutex;
+        Crit3DClimateDbWriter pendingResults(clima->db());
+        pendingResults.setMaxStagedValues(INT_MAX);
+        Crit3DClimateDbWriter receivedResults(clima->db());
+        receivedResults.setMaxStagedValues(INT_MAX);
+
+        auto computeRow = [&](int row, int workerIndex, Crit3DMeteoGridDbHandler* gridDbHandler)
+        {
+            unsigned int w = unsigned(workerIndex);
+            std::string id;
+
+            for (int col = 0; col < nrCols; col++)
+            {
+                if (meteoGridDbHandler->meteoGrid()->getMeteoPointActiveId(row, col, &id))
+                {
+                    Crit3DMeteoPoint* meteoPoint = meteoGridDbHandler->meteoGrid()->meteoPointPointer(row,col);
+
+                    workerPoints[w]->id = meteoPoint->id;
+                    workerPoints[w]->point.z = meteoPoint->point.z;
+                    workerPoints[w]->latitude = meteoPoint->latitude;
+
+                    workerValidCells[w] += computeClimateOnCell(workerErrors[w], gridDbHandler, workerClima[w], climateList,
+                                                                groups, workerPoints[w], &workerSettings[w]);
+                }
+            }
+
+            QString stagingError;
+            std::lock_guard<std::mutex> lock(resultsMutex);
+            pendingResults.append(*workerResults[w], &stagingError);
+        };
+
+        auto collectResults = [&]()
+        {
+            {
+                std::lock_guard<std::mutex> lock(resultsMutex);
+                receivedResults.append(pendingResults, &flushError);
+            }
+
+            if (! dbWriter.append(receivedResults, &flushError))
+            {
+                errorString = "Error in saving climate: " + flushError;
+                return false;
+            }
+            return true;
+        };
+
+        isOk = computeMeteoGridRows(nrWorkers, showInfo, computeRow, collectResults);
+
+        if (isOk && ! dbWriter.flush(&flushError))
+        {
+            errorString = "Error in saving climate: " + flushError;
+            isOk = false;
+        }
+
+        for (int i = 0; i < nrWorkers; i++)
+        {
+            unsigned int w = unsigned(i);
+            validCell += workerValidCells[w];
+            if (errorString.isEmpty())
+                errorString = workerErrors[w];
+
+            delete workerClima[w];
+            delete workerResults[w];
+            delete workerPoints[w];
+        }
+    }
+
+    if (showInfo) closeProgressBar();
+
+    if (! isOk)
+    {
+        logError(errorString);
+        return false;
+    }
+
+    if (validCell == 0)
+    {
+        if (errorString.isEmpty())
+        {
+            errorString = "no valid cells available";
+        }
+        logError(errorString);
+        return false;
+    }
+    else
+    {
+        logInfo("climate saved");
         return true;
     }
+}
+
+
+/*!
+ * \brief computeMeteoGridRows
+ * computes the rows of the meteo grid with nrWorkers threads. Each worker opens its own connection
+ * to the grid db (a Qt sql connection can be used only in the thread that created it) and calls
+ * computeRow(row, workerIndex, gridDbHandler) on the rows dealt to it.
+ * The calling thread updates the progress bar and calls collectResults after the computed rows.
+ * \return false if no worker can open the grid db or if collectResults returns false
+ */
+bool PragaProject::computeMeteoGridRows(int nrWorkers, bool showInfo,
+                                        const std::function<void(int row, int workerIndex, Crit3DMeteoGridDbHandler* gridDbHandler)> &computeRow,
+                                        const std::function<bool()> &collectResults)
+{
+    int nrRows = meteoGridDbHandler->gridStructure().header().nrRows;
+    QString xmlName = meteoGridDbHandler->fileName();
+
+    std::atomic<int> nextRow(0);
+    std::atomic<bool> isStopped(false);
+    std::mutex rowsMutex;
+    std::condition_variable rowComputed;
+    int nrRowsComputed = 0;
+    int nrActiveWorkers = nrWorkers;
+    QString workerError;
+
+    auto worker = [&](int workerIndex)
+    {
+        QString errorStr;
+        Crit3DMeteoGridDbHandler* workerGrid = new Crit3DMeteoGridDbHandler();
+
+        if (workerGrid->parseXMLGrid(xmlName, &errorStr)
+            && workerGrid->openDatabase(&errorStr, "meteoGrid_worker" + QString::number(workerIndex))
+            && workerGrid->loadCellProperties(&errorStr))
+        {
+            int row;
+            while (! isStopped && (row = nextRow++) < nrRows)
+            {
+                computeRow(row, workerIndex, workerGrid);
+                {
+                    std::lock_guard<std::mutex> lock(rowsMutex);
+                    nrRowsComputed++;
+                }
+                rowComputed.notify_one();
+            }
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(rowsMutex);
+            workerError = errorStr;
+        }
+
+        // the connection is removed in the thread that opened it
+        delete workerGrid;
+
+        {
+            std::lock_guard<std::mutex> lock(rowsMutex);
+            nrActiveWorkers--;
+        }
+        rowComputed.notify_one();
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < nrWorkers; i++)
+        threads.emplace_back(worker, i);
+
+    bool isOk = true;
+    bool isFinished = false;
+    int nrRowsCollected = 0;
 
+    while (! isFinished)
+    {
+        {
+            std::unique_lock<std::mutex> lock(rowsMutex);
+            rowComputed.wait(lock, [&]{ return nrRowsComputed > nrRowsCollected || nrActiveWorkers == 0; });
+            nrRowsCollected = nrRowsComputed;
+            isFinished = (nrActiveWorkers == 0);
+        }
+
+        if (isOk && ! collectResults())
+        {
+            isOk = false;
+            isStopped = true;
+        }
+
+        if (showInfo)
+            updateProgressBar(nrRowsCollected);
+    }
+
+    for (unsigned int i = 0; i < threads.size(); i++)
+        threads[i].join();
+
+    if (isOk && nrRowsCollected < nrRows)
+    {
+        errorString = "Error in opening the meteo grid: " + workerError;
+        isOk = false;
+    }
+
+    return isOk;
 }
 
+
 bool PragaProject::downloadDailyDataArkimet(QList<QString> variables, bool prec0024, QDate startDate, QDate endDate, bool showInfo)
 {
     // check meteo point
@@ -2094,6 +2507,105 @@ bool PragaProject::hourlyDerivedVariablesGrid(QDate first, QDate last, bool load
 }
 
 
+namespace
+{
+    struct TdbConnection
+    {
+        QString provider, host, name, user, password;
+        int port;
+
+        explicit TdbConnection(const QSqlDatabase &db)
+            : provider(db.driverName()), host(db.hostName()), name(db.databaseName()),
+              user(db.userName()), password(db.password()), port(db.port())
+        {}
+    };
+
+    // observed data of a period (and of the day before, for transmissivity)
+    struct TmeteoPointsChunk
+    {
+        QDate firstDate, lastDate;
+        std::vector<Crit3DMeteoPoint> points;
+        bool isData;
+        QString errorStr;
+    };
+
+    // interpolated values of the output points: values[point][i] refers to dateTimes[i], varIds[i]
+    struct ToutputPointsChunk
+    {
+        QList<QString> hourlyDateTimes;
+        QList<int> hourlyVarIds;
+        std::vector<std::vector<float>> hourlyValues;
+
+        QList<QString> dailyDates;
+        QList<int> dailyVarIds;
+        std::vector<std::vector<float>> dailyValues;
+
+        QString log;
+    };
+
+    // loader thread: reads the data of the chunk with its own connection
+    void loadMeteoPointsChunk(const TdbConnection &connection, bool loadHourly, bool loadDaily, TmeteoPointsChunk &chunk)
+    {
+        chunk.isData = false;
+        chunk.errorStr = "";
+
+        Crit3DMeteoPointsDbHandler dbHandler(connection.provider, connection.host, connection.name,
+                                             connection.port, connection.user, connection.password);
+        if (! dbHandler.getErrorString().isEmpty() || ! dbHandler.loadVariableProperties())
+        {
+            chunk.errorStr = "Error in loading meteo points data: " + dbHandler.getErrorString();
+            return;
+        }
+
+        Crit3DDate firstLoadingDate = getCrit3DDate(chunk.firstDate.addDays(-1));
+        Crit3DDate lastLoadingDate = getCrit3DDate(chunk.lastDate);
+
+        // all the points are read in a single transaction
+        bool isTransaction = dbHandler.getDb().transaction();
+
+        for (unsigned i = 0; i < chunk.points.size(); i++)
+        {
+            if (loadHourly)
+                if (dbHandler.loadHourlyData(firstLoadingDate, lastLoadingDate, &(chunk.points[i]))) chunk.isData = true;
+
+            if (loadDaily)
+                if (dbHandler.loadDailyData(firstLoadingDate, lastLoadingDate, &(chunk.points[i]))) chunk.isData = true;
+        }
+
+        if (isTransaction) dbHandler.getDb().commit();
+
+        if (! chunk.isData)
+            chunk.errorStr = "No meteo points data from " + chunk.firstDate.addDays(-1).toString("yyyy-MM-dd")
+                             + " to " + chunk.lastDate.toString("yyyy-MM-dd");
+    }
+
+    // writer thread: saves all the output points of the chunk in a single transaction
+    void writeOutputPointsChunk(const TdbConnection &connection, const std::vector<QString> &pointCodes, ToutputPointsChunk &chunk)
+    {
+        Crit3DMeteoPointsDbHandler dbHandler(connection.provider, connection.host, connection.name,
+                                             connection.port, connection.user, connection.password);
+        if (! dbHandler.getErrorString().isEmpty())
+        {
+            chunk.log = "Error in writing output points: " + dbHandler.getErrorString();
+            return;
+        }
+
+        bool isTransaction = dbHandler.getDb().transaction();
+
+        for (unsigned i = 0; i < pointCodes.size(); i++)
+        {
+            if (! chunk.dailyDates.isEmpty())
+                dbHandler.writeDataBatch(pointCodes[i], daily, chunk.dailyDates, chunk.dailyVarIds, chunk.dailyValues[i], chunk.log);
+
+            if (! chunk.hourlyDateTimes.isEmpty())
+                dbHandler.writeDataBatch(pointCodes[i], hourly, chunk.hourlyDateTimes, chunk.hourlyVarIds, chunk.hourlyValues[i], chunk.log);
+        }
+
+        if (isTransaction) dbHandler.getDb().commit();
+    }
+}
+
+
 bool PragaProject::interpolationOutputPointsPeriod(QDate firstDate, QDate lastDate, QList <meteoVariable> variables)
 {
     // check
@@ -2174,164 +2686,194 @@ bool PragaProject::interpolationOutputPointsPeriod(QDate firstDate, QDate lastDa
             return false;
     }
 
-    // initialize data list
-    QVector<QList<QString>> dailyDataList;
-    QVector<QList<QString>> hourlyDataList;
-    if (isDaily)
-    {
-        dailyDataList.resize(int(outputPoints.size()));
-    }
-    if (isHourly)
-    {
-        hourlyDataList.resize(int(outputPoints.size()));
-    }
+    // connections of the loader and writer threads
+    TdbConnection meteoPointsConnection(meteoPointsDbHandler->getDb());
+    TdbConnection outputConnection(outputMeteoPointsDbHandler->getDb());
+
+    std::vector<QString> outputCodes;
+    for (int i = 0; i < outputPoints.size(); i++)
+        outputCodes.push_back(QString::fromStdString(outputPoints[i].id));
+
+    TmeteoPointsChunk loadingChunk;
+    loadingChunk.points.resize(unsigned(nrMeteoPoints));
+    for (int i = 0; i < nrMeteoPoints; i++)
+        loadingChunk.points[unsigned(i)].id = meteoPoints[i].id;
+
+    ToutputPointsChunk writingChunk;
+    std::thread loaderThread, writerThread;
 
     int nrDays = firstDate.daysTo(lastDate) + 1;
     int nrDaysLoading = std::min(nrDays, 30);
-    QDate lastLoadingDate;
-    bool isOk;
 
-    QDate myDate = firstDate;
-    while (myDate <= lastDate)
+    auto startLoading = [&](const QDate &chunkFirstDate)
+    {
+        loadingChunk.firstDate = chunkFirstDate;
+        loadingChunk.lastDate = std::min(chunkFirstDate.addDays(nrDaysLoading - 1), lastDate);
+        loaderThread = std::thread(loadMeteoPointsChunk, std::cref(meteoPointsConnection), isHourly, isDaily, std::ref(loadingChunk));
+    };
+
+    auto waitWriter = [&]()
     {
-        // load data
-        if (myDate == firstDate || myDate > lastLoadingDate)
+        if (writerThread.joinable())
         {
-            lastLoadingDate = myDate.addDays(nrDaysLoading - 1);
-            if (lastLoadingDate > lastDate)
-                lastLoadingDate = lastDate;
+            writerThread.join();
+            if (! writingChunk.log.isEmpty())
+                logInfo(writingChunk.log);
+        }
+    };
 
-            // load one day before (for transmissivity)
-            logInfoGUI("Loading meteo points data from " + myDate.addDays(-1).toString("yyyy-MM-dd") + " to " + lastLoadingDate.toString("yyyy-MM-dd"));
-            if (! loadMeteoPointsData(myDate.addDays(-1), lastLoadingDate, isHourly, isDaily, false))
-                return false;
+    auto closePipeline = [&]()
+    {
+        if (loaderThread.joinable())
+            loaderThread.join();
+        waitWriter();
+
+        for (unsigned i = 0; i < loadingChunk.points.size(); i++)
+        {
+            loadingChunk.points[i].cleanObsDataH();
+            loadingChunk.points[i].cleanObsDataD();
         }
+    };
 
-        if (isHourly)
+    // three stages: the data of the next period are loaded and the output of the previous period
+    // is written while the current period is interpolated
+    bool isOk;
+    startLoading(firstDate);
+
+    QDate chunkFirstDate = firstDate;
+    while (chunkFirstDate <= lastDate)
+    {
+        loaderThread.join();
+        if (! loadingChunk.isData)
         {
-            // initialize
-            hourlyMeteoMaps->initialize();
-            radiationMaps->initialize();
-            pragaHourlyMaps->initialize();
+            errorString = loadingChunk.errorStr;
+            closePipeline();
+            return false;
+        }
 
-            for (int hour = 1; hour <= 24; hour++)
-            {
-                QDateTime myDateTime;
-                myDateTime.setDate(myDate);
-                myDateTime.setTime(QTime(hour, 0, 0, 0));
-                QString dateTimeStr = myDateTime.toString("yyyy-MM-dd hh:mm:ss");
+        QDate chunkLastDate = loadingChunk.lastDate;
+        logInfoGUI("Loaded meteo points data from " + chunkFirstDate.addDays(-1).toString("yyyy-MM-dd") + " to " + chunkLastDate.toString("yyyy-MM-dd"));
 
-                logInfoGUI("Interpolating hourly variables for " + dateTimeStr);
+        for (int i = 0; i < nrMeteoPoints; i++)
+            meteoPoints[i].swapObsData(loadingChunk.points[unsigned(i)]);
 
-                foreach (myVar, variables)
+        if (chunkLastDate < lastDate)
+            startLoading(chunkLastDate.addDays(1));
+
+        ToutputPointsChunk outputChunk;
+        outputChunk.hourlyValues.resize(outputCodes.size());
+        outputChunk.dailyValues.resize(outputCodes.size());
+
+        for (QDate myDate = chunkFirstDate; myDate <= chunkLastDate; myDate = myDate.addDays(1))
+        {
+            if (isHourly)
+            {
+                // initialize
+                hourlyMeteoMaps->initialize();
+                radiationMaps->initialize();
+                pragaHourlyMaps->initialize();
+
+                for (int hour = 1; hour <= 24; hour++)
                 {
-                    if (getVarFrequency(myVar) == hourly)
-                    {
-                        setComputeOnlyPoints(true);
+                    QDateTime myDateTime;
+                    myDateTime.setDate(myDate);
+                    myDateTime.setTime(QTime(hour, 0, 0, 0));
+                    QString dateTimeStr = myDateTime.toString("yyyy-MM-dd hh:mm:ss");
 
-                        // TODO special variables
+                    logInfoGUI("Interpolating hourly variables for " + dateTimeStr);
 
-                        if (myVar == airRelHumidity && interpolationSettings.getUseDewPoint())
+                    foreach (myVar, variables)
+                    {
+                        if (getVarFrequency(myVar) == hourly)
                         {
-                            if (interpolationSettings.getUseInterpolatedTForRH())
+                            setComputeOnlyPoints(true);
+
+                            // TODO special variables
+
+                            if (myVar == airRelHumidity && interpolationSettings.getUseDewPoint())
                             {
-                                passInterpolatedTemperatureToHumidityPoints(getCrit3DTime(myDate, hour), meteoSettings);
-                            }
+                                if (interpolationSettings.getUseInterpolatedTForRH())
+                                {
+                                    passInterpolatedTemperatureToHumidityPoints(getCrit3DTime(myDate, hour), meteoSettings);
+                                }
 
-                            isOk = interpolationDemMain(airDewTemperature, getCrit3DTime(myDate, hour), hourlyMeteoMaps->mapHourlyTdew);
+                                isOk = interpolationDemMain(airDewTemperature, getCrit3DTime(myDate, hour), hourlyMeteoMaps->mapHourlyTdew);
 
-                            if (isOk)
+                                if (isOk)
+                                {
+                                    hourlyMeteoMaps->computeRelativeHumidityMap(hourlyMeteoMaps->mapHourlyRelHum);
+                                }
+                            }
+                            else
                             {
-                                hourlyMeteoMaps->computeRelativeHumidityMap(hourlyMeteoMaps->mapHourlyRelHum);
+                                isOk = interpolationDemMain(myVar, getCrit3DTime(myDate, hour), getPragaMapFromVar(myVar));
                             }
-                        }
-                        else
-                        {
-                            isOk = interpolationDemMain(myVar, getCrit3DTime(myDate, hour), getPragaMapFromVar(myVar));
-                        }
 
-                        setComputeOnlyPoints(false);
+                            setComputeOnlyPoints(false);
 
-                        if (! isOk)
-                            return false;
+                            if (! isOk)
+                            {
+                                closePipeline();
+                                return false;
+                            }
 
-                        int varId = meteoPointsDbHandler->getIdfromMeteoVar(myVar);
-                        for (int i = 0; i < outputPoints.size(); i++)
-                        {
-                            float value = outputPoints[i].currentValue;
-                            hourlyDataList[i].push_back(QString("('%1',%2,%3)").arg(dateTimeStr).arg(varId).arg(value));
+                            outputChunk.hourlyDateTimes.push_back(dateTimeStr);
+                            outputChunk.hourlyVarIds.push_back(meteoPointsDbHandler->getIdfromMeteoVar(myVar));
+                            for (int i = 0; i < outputPoints.size(); i++)
+                            {
+                                outputChunk.hourlyValues[unsigned(i)].push_back(outputPoints[i].currentValue);
+                            }
                         }
                     }
                 }
             }
-        }
 
-        if (isDaily)
-        {
-            // initialize
-            pragaDailyMaps->initialize();
-            QString dateStr = myDate.toString("yyyy-MM-dd");
+            if (isDaily)
+            {
+                // initialize
+                pragaDailyMaps->initialize();
+                QString dateStr = myDate.toString("yyyy-MM-dd");
 
-            logInfoGUI("Interpolating daily variables for " + dateStr);
+                logInfoGUI("Interpolating daily variables for " + dateStr);
 
-            foreach (myVar, variables)
-            {
-                if (getVarFrequency(myVar) == daily)
+                foreach (myVar, variables)
                 {
-                    setComputeOnlyPoints(true);
+                    if (getVarFrequency(myVar) == daily)
+                    {
+                        setComputeOnlyPoints(true);
 
-                    // TODO special variables
+                        // TODO special variables
 
-                    isOk = interpolationDemMain(myVar, getCrit3DTime(myDate, 0), getPragaMapFromVar(myVar));
+                        isOk = interpolationDemMain(myVar, getCrit3DTime(myDate, 0), getPragaMapFromVar(myVar));
 
-                    setComputeOnlyPoints(false);
+                        setComputeOnlyPoints(false);
 
-                    if (! isOk)
-                        return false;
+                        if (! isOk)
+                        {
+                            closePipeline();
+                            return false;
+                        }
 
-                    int varId = meteoPointsDbHandler->getIdfromMeteoVar(myVar);
-                    for (int i = 0; i < outputPoints.size(); i++)
-                    {
-                        float value = outputPoints[i].currentValue;
-                        dailyDataList[i].push_back(QString("('%1',%2,%3)").arg(dateStr).arg(varId).arg(value));
+                        outputChunk.dailyDates.push_back(dateStr);
+                        outputChunk.dailyVarIds.push_back(meteoPointsDbHandler->getIdfromMeteoVar(myVar));
+                        for (int i = 0; i < outputPoints.size(); i++)
+                        {
+                            outputChunk.dailyValues[unsigned(i)].push_back(outputPoints[i].currentValue);
+                        }
                     }
                 }
             }
         }
 
-        if (myDate == lastLoadingDate)
-        {
-            // save and clear datalist
-            for (int i = 0; i < outputPoints.size(); i++)
-            {
-                if (isDaily)
-                {
-                    QString logStr = "";
-                    QString pointCode = QString::fromStdString(outputPoints[i].id);
-                    outputMeteoPointsDbHandler->writeDailyDataList(pointCode, dailyDataList[i], logStr);
-                    if (! logStr.isEmpty())
-                    {
-                        logInfo(logStr);
-                    }
-                    dailyDataList[i].clear();
-                }
-                if (isHourly)
-                {
-                    QString logStr = "";
-                    QString pointCode = QString::fromStdString(outputPoints[i].id);
-                    outputMeteoPointsDbHandler->writeHourlyDataList(pointCode, hourlyDataList[i], logStr);
-                    if (! logStr.isEmpty())
-                    {
-                        logInfo(logStr);
-                    }
-                    hourlyDataList[i].clear();
-                }
-            }
-        }
+        // save in background (one period at a time)
+        waitWriter();
+        writingChunk = std::move(outputChunk);
+        writerThread = std::thread(writeOutputPointsChunk, std::cref(outputConnection), std::cref(outputCodes), std::ref(writingChunk));
 
-        myDate = myDate.addDays(1);
+        chunkFirstDate = chunkLastDate.addDays(1);
     }
 
+    closePipeline();
     closeLogInfo();
     return true;
 }
@@ -2599,6 +3141,15 @@ bool PragaProject::interpolationMeteoGridPeriod(QDate dateIni, QDate dateFin, QL
             logInfoGUI("Saving meteo grid data from " + saveDateIni.toString("dd/MM/yyyy") + " to " + myDate.toString("dd/MM/yyyy"));
             meteoGridDbHandler->saveGridData(&myError, QDateTime(saveDateIni, QTime(1,0,0), Qt::UTC), QDateTime(myDate.addDays(1), QTime(0,0,0), Qt::UTC), varToSave, meteoSettings);
 
+            // append daily grids to the netcdf series
+            #ifdef NETCDF
+                if (netcdfGridSeries.isOpen())
+                {
+                    logInfoGUI("Writing netcdf series from " + saveDateIni.toString("dd/MM/yyyy") + " to " + myDate.toString("dd/MM/yyyy"));
+                    if (! writeMeteoGridNetCDFSeries(saveDateIni, myDate)) return false;
+                }
+            #endif
+
             meteoGridDbHandler->meteoGrid()->emptyGridData(getCrit3DDate(saveDateIni), getCrit3DDate(myDate));
 
             countDaysSaving = 0;
@@ -3075,6 +3626,83 @@ void PragaProject::showPointStatisticsWidgetGrid(std::string id)
         return true;
     }
 
+    /*!
+     * \brief openMeteoGridNetCDFSeries
+     * creates a netcdf with an unlimited time dimension for the daily variables of the meteo grid;
+     * while it is open, interpolationMeteoGridPeriod appends the grids at each saving step
+     */
+    bool PragaProject::openMeteoGridNetCDFSeries(QString fileName, QList<meteoVariable> variables, QDate firstDate, netcdfChunkLayout chunkLayout)
+    {
+        if (! checkMeteoGridForExport()) return false;
+
+        std::vector<std::string> varNames, varUnits;
+        foreach (meteoVariable myVar, variables)
+        {
+            if (getVarFrequency(myVar) != daily) continue;
+
+            std::string varName = getMeteoVarName(myVar);
+            if (std::find(varNames.begin(), varNames.end(), varName) != varNames.end()) continue;
+
+            varNames.push_back(varName);
+            varUnits.push_back(getUnitFromVariable(myVar));
+        }
+
+        if (varNames.empty())
+        {
+            logError("No daily variable for the netcdf series.");
+            return false;
+        }
+
+        std::string errorStr;
+        netcdfGridSeries.setChunkLayout(chunkLayout);
+        if (! netcdfGridSeries.create(fileName.toStdString(), meteoGridDbHandler->gridStructure().header(), "MeteoGrid",
+                                      getCrit3DDate(firstDate), varNames, varUnits, errorStr))
+        {
+            logError("Error in creating netcdf: " + QString::fromStdString(errorStr));
+            return false;
+        }
+
+        return true;
+    }
+
+
+    bool PragaProject::writeMeteoGridNetCDFSeries(QDate firstDate, QDate lastDate)
+    {
+        Crit3DMeteoGrid* meteoGrid = meteoGridDbHandler->meteoGrid();
+        std::string errorStr;
+
+        for (QDate myDate = firstDate; myDate <= lastDate; myDate = myDate.addDays(1))
+        {
+            for (const std::string &varName : netcdfGridSeries.getVariableNames())
+            {
+                meteoGrid->fillCurrentDailyValue(getCrit3DDate(myDate), getMeteoVar(varName), meteoSettings);
+                meteoGrid->fillMeteoRaster();
+
+                if (! netcdfGridSeries.writeDay(getCrit3DDate(myDate), varName, meteoGrid->dataMeteoGrid, errorStr))
+                {
+                    logError("Error in writing netcdf: " + QString::fromStdString(errorStr));
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+
+    bool PragaProject::closeMeteoGridNetCDFSeries()
+    {
+        std::string errorStr;
+        if (! netcdfGridSeries.close(errorStr))
+        {
+            logError("Error in writing netcdf: " + QString::fromStdString(errorStr));
+            return false;
+        }
+
+        return true;
+    }
+
+
     bool PragaProject::exportXMLElabGridToNetcdf(QString xmlName)
     {
         QString xmlPath = QFileInfo(xmlName).absolutePath()+"/";
@@ -3899,6 +4527,72 @@ bool PragaProject::computeDroughtIndexGrid(droughtIndex index, int firstYear, in
     }
 
     isOk = false;
+    Crit3DMeteoGrid* meteoGrid = meteoGridDbHandler->meteoGrid();
+    int nrRows = meteoGrid->gridStructure().header().nrRows;
+    int nrCols = meteoGrid->gridStructure().header().nrCols;
+
+    if (index == INDEX_SPI || index == INDEX_SPEI)
+    {
+        // monthly series of all cells (same calendar) as structure of arrays:
+        // the parameters of the reference period are fitted once and kept in droughtGrid
+        int nrMonths = meteoGrid->meteoPointPointer(0, 0)->nrObsDataDaysM;
+        std::vector<float> precValues, et0Values;
+        std::vector<bool> activeCells;
+        precValues.resize(unsigned(nrRows * nrCols * nrMonths));
+        et0Values.resize(unsigned(nrRows * nrCols * nrMonths));
+        activeCells.resize(unsigned(nrRows * nrCols));
+
+        for (int row = 0; row < nrRows; row++)
+        {
+            for (int col = 0; col < nrCols; col++)
+            {
+                Crit3DMeteoPoint* meteoPoint = meteoGrid->meteoPointPointer(unsigned(row), unsigned(col));
+                activeCells[unsigned(row * nrCols + col)] = meteoPoint->active;
+                unsigned long offset = unsigned(row * nrCols + col) * unsigned(nrMonths);
+                for (int i = 0; i < nrMonths; i++)
+                {
+                    precValues[offset + unsigned(i)] = meteoPoint->obsDataM[unsigned(i)].prec;
+                    et0Values[offset + unsigned(i)] = meteoPoint->obsDataM[unsigned(i)].et0_hs;
+                }
+            }
+        }
+
+        droughtGrid.setMonthlySeries(nrRows * nrCols, nrMonths, firstDate.month(), firstDate.year(),
+                                     precValues, et0Values, activeCells);
+
+        logInfoGUI("Compute drought index...");
+        if (timescale <= 0)
+        {
+            timescale = 3;      // default of Drought
+        }
+
+        std::vector<float> results;
+        droughtGrid.computeDroughtIndex(index, timescale, firstYear, lastYear, meteoSettings->getMinimumPercentage(),
+                                        date.year(), date.month(), results);
+        closeLogInfo();
+
+        for (int row = 0; row < nrRows; row++)
+        {
+            for (int col = 0; col < nrCols; col++)
+            {
+                Crit3DMeteoPoint* meteoPoint = meteoGrid->meteoPointPointer(unsigned(row), unsigned(col));
+                if (meteoPoint->active)
+                {
+                    meteoPoint->elaboration = results[unsigned(row * nrCols + col)];
+                    if (meteoPoint->elaboration != NODATA)
+                    {
+                        isOk = true;
+                    }
+                }
+            }
+        }
+
+        if (! isOk)
+            logError("Missing data.");
+
+        return isOk;
+    }
+
     setProgressBar("Drought Index - Meteo Grid", meteoGridDbHandler->meteoGrid()->gridStructure().header().nrRows);
     for (unsigned row = 0; row < unsigned(meteoGridDbHandler->meteoGrid()->gridStructure().header().nrRows); row++)
     {
@@ -4241,6 +4935,9 @@ bool PragaProject::activeMeteoGridCellsWithDEM()
 
     if (modality == MODE_GUI) closeProgressBar();
 
+    // active cells are changed: the aggregation index has to be rebuilt
+    meteoGridDbHandler->meteoGrid()->setIsAggregationDefined(false);
+
     logInfoGUI("Update meteo grid db");
 
     bool ok = true;
@@ -4450,6 +5147,11 @@ bool PragaProject::computeClimatePointXML(QString xmlName)
     bool changeDataSet = true;
     QDate startDate;
     QDate endDate;
+    // results are written in bulk transactions
+    Crit3DClimateDbWriter dbWriter(clima->db());
+    clima->setDbWriter(&dbWriter);
+    QString flushError;
+
     Crit3DMeteoPoint* meteoPointTemp = new Crit3DMeteoPoint;
 
     for (int i = 0; i < nrMeteoPoints; i++)
@@ -4528,6 +5230,14 @@ bool PragaProject::computeClimatePointXML(QString xmlName)
     delete listXMLDrought;
     delete listXMLPhenology;
 
+    if (! flushClimateResults(clima, flushError))
+    {
+        errorString = "Error in saving climate: " + flushError;
+        logError(errorString);
+        delete meteoPointTemp;
+        return false;
+    }
+
     if (validCell == 0)
     {
         if (errorString.isEmpty())
@@ -19,6 +19,7 @@
 
     #ifdef NETCDF
         #include "netcdfHandler.h"
+        #include "netcdfSeriesWriter.h"
     #endif
 
     #ifndef INOUTDATAXML_H
@@ -29,6 +30,10 @@
         #include "drought.h"
     #endif
 
+    #ifndef DROUGHTGRID_H
+        #include "droughtGrid.h"
+    #endif
+
     #ifndef POINTSTATISTICSWIDGET_H
         #include "pointStatisticsWidget.h"
     #endif
@@ -41,9 +46,16 @@
         #include "synchronicityWidget.h"
     #endif
 
+    #ifndef _FUNCTIONAL_
+        #include <functional>
+    #endif
+
     class PragaProject : public Project
     {
     private:
+        bool computeMeteoGridRows(int nrWorkers, bool showInfo,
+                                  const std::function<void(int row, int workerIndex, Crit3DMeteoGridDbHandler* gridDbHandler)> &computeRow,
+                                  const std::function<bool()> &collectResults);
 
     private slots:
             void deleteSynchWidget();
@@ -81,8 +93,11 @@
         Crit3DMeteoPointsDbHandler* outputMeteoPointsDbHandler;
         bool outputMeteoPointsLoaded;
 
+        DroughtGrid droughtGrid;
+
         #ifdef NETCDF
             NetCDFHandler netCDF;
+            NetCDFSeriesWriter netcdfGridSeries;
         #endif
 
         PragaProject();
@@ -162,6 +177,9 @@
         #ifdef NETCDF
                 bool exportMeteoGridToNetCDF(QString fileName, QString title, QString variableName, std::string variableUnit, Crit3DDate myDate, int nDays, int refYearStart, int refYearEnd);
                 bool exportXMLElabGridToNetcdf(QString xmlName);
+                bool openMeteoGridNetCDFSeries(QString fileName, QList<meteoVariable> variables, QDate firstDate, netcdfChunkLayout chunkLayout);
+                bool writeMeteoGridNetCDFSeries(QDate firstDate, QDate lastDate);
+                bool closeMeteoGridNetCDFSeries();
         #endif
     };
 
@@ -22,6 +22,7 @@ QList<QString> getPragaCommandList()
     cmdList.append("DroughtPoint    | ComputeDroughtIndexPoint");
     cmdList.append("Gridding        | InterpolationGridPeriod");
     cmdList.append("GridAggr        | GridAggregation");
+    cmdList.append("GridBinary      | ConvertMeteoGridBinary");
     cmdList.append("GridDerVar      | GridDerivedVariables");
     cmdList.append("GridMonthlyInt  | GridMonthlyIntegrationVariables");
     cmdList.append("GridExport      | GridRaster");
@@ -81,6 +82,11 @@ int PragaProject::executePragaCommand(QList<QString> argumentList, bool* isComma
         *isCommandFound = true;
         return cmdAggregationGridPeriod(this, argumentList);
     }
+    else if (command == "GRIDBINARY" || command == "CONVERTMETEOGRIDBINARY")
+    {
+        *isCommandFound = true;
+        return cmdConvertMeteoGridBinary(this, argumentList);
+    }
     else if (command == "GRIDDERIVEDVARIABLES" || command == "GRIDDERVAR")
     {
         *isCommandFound = true;
@@ -292,6 +298,8 @@ int cmdInterpolationGridPeriod(PragaProject* myProject, QList<QString> argumentL
     int loadInterval = NODATA;
     bool parseSaveInterval = true;
     bool parseLoadInterval = true;
+    QString netcdfName = "";
+    QString chunkLayout = "series";
 
     for (int i = 1; i < argumentList.size(); i++)
     {
@@ -344,6 +352,10 @@ int cmdInterpolationGridPeriod(PragaProject* myProject, QList<QString> argumentL
             saveInterval = argumentList[i].right(argumentList[i].length()-3).toInt(&parseSaveInterval);
         else if (argumentList.at(i).left(3) == "-l:")
             loadInterval = argumentList[i].right(argumentList[i].length()-3).toInt(&parseLoadInterval);
+        else if (argumentList.at(i).left(4) == "-nc:")
+            netcdfName = myProject->getCompleteFileName(argumentList[i].right(argumentList[i].length()-4), PATH_PROJECT);
+        else if (argumentList.at(i).left(7) == "-chunk:")
+            chunkLayout = argumentList[i].right(argumentList[i].length()-7).toLower();
 
     }
 
@@ -371,7 +383,33 @@ int cmdInterpolationGridPeriod(PragaProject* myProject, QList<QString> argumentL
         return PRAGA_INVALID_COMMAND;
     }
 
-    if (! myProject->interpolationMeteoGridPeriod(dateIni, dateFin, variables, aggrVariables, saveRasters, loadInterval, saveInterval))
+    // daily grids are also appended to a netcdf series
+    if (netcdfName != "")
+    {
+        #ifdef NETCDF
+            if (chunkLayout != "series" && chunkLayout != "maps")
+            {
+                myProject->logError("Wrong chunk layout: series or maps");
+                return PRAGA_INVALID_COMMAND;
+            }
+
+            if (! myProject->openMeteoGridNetCDFSeries(netcdfName, variables + aggrVariables, dateIni,
+                                                       chunkLayout == "maps" ? chunkMaps : chunkSeries))
+                return PRAGA_ERROR;
+        #else
+            myProject->logError("NetCDF is not available");
+            return PRAGA_INVALID_COMMAND;
+        #endif
+    }
+
+    bool isOk = myProject->interpolationMeteoGridPeriod(dateIni, dateFin, variables, aggrVariables, saveRasters, loadInterval, saveInterval);
+
+    #ifdef NETCDF
+        if (netcdfName != "" && ! myProject->closeMeteoGridNetCDFSeries())
+            isOk = false;
+    #endif
+
+    if (! isOk)
         return PRAGA_ERROR;
 
     return PRAGA_OK;
@@ -436,6 +474,84 @@ int cmdAggregationGridPeriod(PragaProject* myProject, QList<QString> argumentLis
     return PRAGA_OK;
 }
 
+
+// copies the meteo grid data from the db tables to the binary storage (-export: the other way)
+// default period (-d1: -d2:) is the date range of the source: the db tables or the binary files
+int cmdConvertMeteoGridBinary(PragaProject* myProject, QList<QString> argumentList)
+{
+    if (! myProject->meteoGridLoaded || myProject->meteoGridDbHandler == nullptr)
+    {
+        myProject->logError(ERROR_STR_MISSING_GRID);
+        return PRAGA_ERROR;
+    }
+
+    QDate dateIni, dateFin;
+    bool isDateIni = false;
+    bool isDateFin = false;
+    bool isExport = false;
+
+    for (int i = 1; i < argumentList.size(); i++)
+    {
+        if (argumentList.at(i).left(4) == "-d1:")
+        {
+            QString dateIniStr = argumentList[i].right(argumentList[i].length()-4);
+            dateIni = QDate::fromString(dateIniStr, "dd/MM/yyyy");
+            isDateIni = true;
+        }
+        else if (argumentList.at(i).left(4) == "-d2:")
+        {
+            QString dateFinStr = argumentList[i].right(argumentList[i].length()-4);
+            dateFin = QDate::fromString(dateFinStr, "dd/MM/yyyy");
+            isDateFin = true;
+        }
+        else if (argumentList.at(i).toLower() == "-export")
+        {
+            isExport = true;
+        }
+    }
+
+    QString errorStr;
+    if (! isDateIni || ! isDateFin)
+    {
+        QDate firstDate, lastDate;
+        if (isExport)
+        {
+            firstDate = myProject->meteoGridDbHandler->getFirstDailyDate();
+            lastDate = myProject->meteoGridDbHandler->getLastDailyDate();
+        }
+        else if (! myProject->meteoGridDbHandler->getSqlDateRange(firstDate, lastDate, errorStr))
+        {
+            myProject->logError(errorStr);
+            return PRAGA_ERROR;
+        }
+
+        if (! isDateIni)
+            dateIni = firstDate;
+        if (! isDateFin)
+            dateFin = lastDate;
+    }
+
+    if (! dateIni.isValid() || ! dateFin.isValid() || dateIni > dateFin)
+    {
+        myProject->logError("Wrong dates");
+        return PRAGA_INVALID_COMMAND;
+    }
+
+    bool isOk;
+    if (isExport)
+        isOk = myProject->meteoGridDbHandler->exportBinaryDataToSql(errorStr, dateIni, dateFin, myProject->meteoSettings);
+    else
+        isOk = myProject->meteoGridDbHandler->importSqlDataToBinary(errorStr, dateIni, dateFin, myProject->meteoSettings);
+
+    if (! isOk)
+    {
+        myProject->logError(errorStr);
+        return PRAGA_ERROR;
+    }
+
+    return PRAGA_OK;
+}
+
 int cmdHourlyDerivedVariablesGrid(PragaProject* myProject, QList<QString> argumentList)
 {
 
@@ -16,6 +16,7 @@
     int cmdDownload(PragaProject* myProject, QList<QString> argumentList);
     int cmdInterpolationGridPeriod(PragaProject* myProject, QList<QString> argumentList);
     int cmdAggregationGridPeriod(PragaProject* myProject, QList<QString> argumentList);
+    int cmdConvertMeteoGridBinary(PragaProject* myProject, QList<QString> argumentList);
     int cmdHourlyDerivedVariablesGrid(PragaProject* myProject, QList<QString> argumentList);
     int cmdGridAggregationOnZones(PragaProject* myProject, QList<QString> argumentList);
     int cmdMonthlyIntegrationVariablesGrid(PragaProject* myProject, QList<QString> argumentList);
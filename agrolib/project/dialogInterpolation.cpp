@@ -34,6 +34,15 @@ DialogInterpolation::DialogInterpolation(Project *myProject)
         algorithmEdit.setCurrentIndex(indexAlgorithm);
 
     layoutAlgorithm->addWidget(&algorithmEdit);
+
+    QLabel *labelThreads = new QLabel(tr("threads number (0 = all cores)"));
+    QIntValidator *intValThreads = new QIntValidator(0, 1024, this);
+    nrThreadsEdit.setFixedWidth(30);
+    nrThreadsEdit.setValidator(intValThreads);
+    nrThreadsEdit.setText(QString::number(_interpolationSettings->getNrThreads()));
+    layoutAlgorithm->addWidget(labelThreads);
+    layoutAlgorithm->addWidget(&nrThreadsEdit);
+
     groupAlgorithm->setLayout(layoutAlgorithm);
     layoutMain->addWidget(groupAlgorithm);
 
@@ -260,6 +269,12 @@ void DialogInterpolation::accept()
         return;
     }
 
+    if (nrThreadsEdit.text().isEmpty())
+    {
+        QMessageBox::information(nullptr, "Missing threads number", "insert threads number");
+        return;
+    }
+
     if (algorithmEdit.currentIndex() == -1)
     {
         QMessageBox::information(nullptr, "No algorithm selected", "Choose algorithm");
@@ -287,6 +302,7 @@ void DialogInterpolation::accept()
     _interpolationSettings->setMinRegressionR2(QLocale().toFloat(minRegressionR2Edit.text()));
     _interpolationSettings->setTopoDist_maxKh(maxTdMultiplierEdit.text().toInt());
     _interpolationSettings->setMinPointsLocalDetrending(minPointsLocalDetrendingEdit.text().toInt());
+    _interpolationSettings->setNrThreads(nrThreadsEdit.text().toInt());
 
     _qualityInterpolationSettings->setMinRegressionR2(QLocale().toFloat(minRegressionR2Edit.text()));
     _qualityInterpolationSettings->setTopoDist_maxKh(maxTdMultiplierEdit.text().toInt());
@@ -22,6 +22,7 @@
             QLineEdit minRegressionR2Edit;
             QLineEdit maxTdMultiplierEdit;
             QLineEdit minPointsLocalDetrendingEdit;
+            QLineEdit nrThreadsEdit;
             QCheckBox* lapseRateCodeEdit;
             QCheckBox* thermalInversionEdit;
             QCheckBox* optimalDetrendingEdit;
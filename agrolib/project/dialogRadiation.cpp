@@ -21,6 +21,7 @@ DialogRadiation::DialogRadiation(Project* myProject)
     QHBoxLayout* layoutAlgorithm = new QHBoxLayout();
     comboAlgorithm = new QComboBox();
     checkShadowing = new QCheckBox("shadowing");
+    checkFastMode = new QCheckBox("fast mode (horizon maps)");
     checkRealSky = new QCheckBox("real sky");
     comboRealSky = new QComboBox();
     comboLinkeMode = new QComboBox();
@@ -60,6 +61,10 @@ DialogRadiation::DialogRadiation(Project* myProject)
     checkShadowing->setChecked(project_->radSettings.getShadowing());
     layoutMainLeft->addWidget(checkShadowing);
 
+    // fast mode
+    checkFastMode->setChecked(project_->radSettings.getFastMode());
+    layoutMainLeft->addWidget(checkFastMode);
+
     // ----------------------------------------------------
     // transmissivity settings
     QGroupBox* groupTransmissivity = new QGroupBox("real sky settings");
@@ -408,6 +413,7 @@ void DialogRadiation::accept()
     project_->radSettings.setTiltMode(tiltMode);
     project_->radSettings.setRealSky(realSky);
     project_->radSettings.setShadowing(checkShadowing->isChecked());
+    project_->radSettings.setFastMode(checkFastMode->isChecked());
     project_->radSettings.setClearSky(QLocale().toFloat(editTransClearSky->text()));
 
     if (linke != NODATA) project_->radSettings.setLinke(linke);
@@ -38,6 +38,7 @@
             QLineEdit* editAspect;
 
             QCheckBox* checkShadowing;
+            QCheckBox* checkFastMode;
 
             void loadLinke();
             void loadAlbedo();
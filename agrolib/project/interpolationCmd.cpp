@@ -2,11 +2,14 @@
 #include <QString>
 
 #include "basicMath.h"
+#include "parallel.h"
 #include "gis.h"
 #include "utilities.h"
 #include "interpolation.h"
 #include "interpolationCmd.h"
 
+#define ROWS_BLOCK 16
+
 
 float crossValidationStatistics::getMeanAbsoluteError() const
 {
@@ -257,25 +260,43 @@ bool interpolationRaster(std::vector <Crit3DInterpolationDataPoint> &myPoints, C
         return false;
     }
 
-    float myX, myY;
-    std::vector <double> proxyValues;
-    proxyValues.resize(unsigned(mySettings->getProxyNr()));
+    // copies of the points share the same positions: the spatial index is checked once
+    bool isIndexValid = mySettings->getPointsIndex()->isValid(myPoints);
+
+    // each thread works on its own copy of points (distances are overwritten) and settings
+    int nrThreads = parallel::getNrThreads(mySettings->getNrThreads());
+    std::vector <std::vector <Crit3DInterpolationDataPoint>> threadPoints(unsigned(nrThreads), myPoints);
+    std::vector <Crit3DInterpolationSettings> threadSettings(unsigned(nrThreads), *mySettings);
 
-    for (long myRow = 0; myRow < outputGrid->header->nrRows ; myRow++)
+    auto interpolateRows = [&](long firstRow, long lastRow, int threadIndex)
     {
-        for (long myCol = 0; myCol < outputGrid->header->nrCols; myCol++)
+        std::vector <Crit3DInterpolationDataPoint> &points = threadPoints[unsigned(threadIndex)];
+        Crit3DInterpolationSettings* settings = &(threadSettings[unsigned(threadIndex)]);
+
+        float myX, myY;
+        std::vector <double> proxyValues;
+        proxyValues.resize(unsigned(settings->getProxyNr()));
+
+        for (long myRow = firstRow; myRow < lastRow; myRow++)
         {
-            gis::getUtmXYFromRowColSinglePrecision(*outputGrid, myRow, myCol, &myX, &myY);
-            float myZ = raster.value[myRow][myCol];
-            if (! isEqual(myZ, outputGrid->header->flag))
+            for (long myCol = 0; myCol < outputGrid->header->nrCols; myCol++)
             {
-                if (getUseDetrendingVar(myVar))
-                    getProxyValuesXY(myX, myY, mySettings, proxyValues);
+                gis::getUtmXYFromRowColSinglePrecision(*outputGrid, myRow, myCol, &myX, &myY);
+                float myZ = raster.value[myRow][myCol];
+                if (! isEqual(myZ, outputGrid->header->flag))
+                {
+                    if (getUseDetrendingVar(myVar))
+                        getProxyValuesXY(myX, myY, settings, proxyValues);
 
-                outputGrid->value[myRow][myCol] = interpolate(myPoints, mySettings, meteoSettings, myVar, myX, myY, myZ, proxyValues, true);
+                    outputGrid->value[myRow][myCol] = interpolate(points, settings, meteoSettings, myVar, myX, myY, myZ, proxyValues, true, isIndexValid);
+                }
             }
         }
-    }
+
+        return true;
+    };
+
+    parallel::forEachBlock(outputGrid->header->nrRows, ROWS_BLOCK, nrThreads, interpolateRows);
 
     if (! gis::updateMinMaxRasterGrid(outputGrid))
         return false;
@@ -283,3 +304,95 @@ bool interpolationRaster(std::vector <Crit3DInterpolationDataPoint> &myPoints, C
     return true;
 }
 
+
+/*!
+ * \brief interpolationRasterLocalDetrending
+ * local detrending: for each cell the nearest points are selected and the detrending
+ * is computed again (or reused from the cache, if the same points were already selected).
+ * Cells are independent, so row blocks are interpolated in parallel,
+ * each thread with its own copy of points and settings (results are the same of the serial computation).
+ * Optimal detrending and topographic distance write residuals on meteoPoints: in that case the
+ * computation is serial.
+ */
+bool interpolationRasterLocalDetrending(std::vector <Crit3DInterpolationDataPoint> &myPoints, Crit3DInterpolationSettings* mySettings,
+                                        Crit3DMeteoSettings* meteoSettings, Crit3DClimateParameters* myClimate,
+                                        Crit3DMeteoPoint* meteoPoints, int nrMeteoPoints, meteoVariable myVar, const Crit3DTime &myTime,
+                                        gis::Crit3DRasterGrid* outputGrid, const gis::Crit3DRasterGrid& raster, std::string &errorStr)
+{
+    if (! outputGrid->initializeGrid(*(raster.header)))
+    {
+        return false;
+    }
+
+    int nrThreads = parallel::getNrThreads(mySettings->getNrThreads());
+    if ((mySettings->getUseBestDetrending() && ! mySettings->getUseMultipleDetrending())
+        || (mySettings->getUseTD() && getUseTdVar(myVar)))
+    {
+        nrThreads = 1;
+    }
+
+    // copies of the points share the same positions: the spatial index is checked once
+    bool isIndexValid = mySettings->getPointsIndex()->isValid(myPoints);
+    std::vector <std::vector <Crit3DInterpolationDataPoint>> threadPoints(unsigned(nrThreads), myPoints);
+    std::vector <Crit3DInterpolationSettings> threadSettings(unsigned(nrThreads), *mySettings);
+    std::vector <Crit3DDetrendingCache> threadCache;
+    threadCache.resize(unsigned(nrThreads));
+    std::vector <std::string> threadErrors;
+    threadErrors.resize(unsigned(nrThreads));
+
+    auto interpolateRows = [&](long firstRow, long lastRow, int threadIndex)
+    {
+        std::vector <Crit3DInterpolationDataPoint> &points = threadPoints[unsigned(threadIndex)];
+        Crit3DInterpolationSettings* settings = &(threadSettings[unsigned(threadIndex)]);
+
+        double x, y;
+        std::vector <double> proxyValues;
+        proxyValues.resize(unsigned(settings->getProxyNr()));
+
+        for (long row = firstRow; row < lastRow; row++)
+        {
+            for (long col = 0; col < raster.header->nrCols; col++)
+            {
+                float z = raster.value[row][col];
+                if (! isEqual(z, raster.header->flag))
+                {
+                    gis::getUtmXYFromRowCol(*(raster.header), row, col, &x, &y);
+
+                    std::vector <Crit3DInterpolationDataPoint> subsetInterpolationPoints;
+                    localSelection(points, subsetInterpolationPoints, float(x), float(y), *settings, isIndexValid);
+                    if (! preInterpolation(subsetInterpolationPoints, settings, meteoSettings, myClimate,
+                                          meteoPoints, nrMeteoPoints, myVar, myTime, threadErrors[unsigned(threadIndex)],
+                                          threadCache[unsigned(threadIndex)]))
+                    {
+                        return false;
+                    }
+
+                    getProxyValuesXY(float(x), float(y), settings, proxyValues);
+                    outputGrid->value[row][col] = interpolate(subsetInterpolationPoints, settings, meteoSettings,
+                                                              myVar, float(x), float(y), z, proxyValues, true, false);
+                }
+            }
+        }
+
+        return true;
+    };
+
+    if (! parallel::forEachBlock(raster.header->nrRows, ROWS_BLOCK, nrThreads, interpolateRows))
+    {
+        for (unsigned i = 0; i < threadErrors.size(); i++)
+        {
+            if (! threadErrors[i].empty())
+            {
+                errorStr = threadErrors[i];
+                break;
+            }
+        }
+        return false;
+    }
+
+    // serial computation: keep the last state of settings (local radius, fitting parameters)
+    if (nrThreads == 1)
+        *mySettings = threadSettings[0];
+
+    return gis::updateMinMaxRasterGrid(outputGrid);
+}
@@ -18,6 +18,7 @@
     #endif
 
     class QDate;
+    class Crit3DMeteoPoint;
 
     class crossValidationStatistics {
     private:
@@ -73,5 +74,10 @@
     bool interpolationRaster(std::vector <Crit3DInterpolationDataPoint> &myPoints, Crit3DInterpolationSettings* mySettings, Crit3DMeteoSettings *meteoSettings,
                             gis::Crit3DRasterGrid* outputGrid, const gis::Crit3DRasterGrid& raster, meteoVariable myVar);
 
+    bool interpolationRasterLocalDetrending(std::vector <Crit3DInterpolationDataPoint> &myPoints, Crit3DInterpolationSettings* mySettings,
+                                            Crit3DMeteoSettings* meteoSettings, Crit3DClimateParameters* myClimate,
+                                            Crit3DMeteoPoint* meteoPoints, int nrMeteoPoints, meteoVariable myVar, const Crit3DTime &myTime,
+                                            gis::Crit3DRasterGrid* outputGrid, const gis::Crit3DRasterGrid& raster, std::string &errorStr);
+
 
 #endif // INTERPOLATIONCMD_H
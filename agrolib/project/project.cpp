@@ -7,6 +7,7 @@
 #include "solarRadiation.h"
 #include "interpolationCmd.h"
 #include "interpolation.h"
+#include "parallel.h"
 #include "transmissivity.h"
 #include "utilities.h"
 #include "aggregation.h"
@@ -22,6 +23,7 @@
 #include <QSqlQuery>
 #include <QMessageBox>
 #include <string>
+#include <atomic>
 
 
 Project::Project()
@@ -507,6 +509,9 @@ bool Project::loadParameters(QString parametersFileName)
             if (parameters->contains("shadowing"))
                 radSettings.setShadowing(parameters->value("shadowing").toBool());
 
+            if (parameters->contains("fast_mode"))
+                radSettings.setFastMode(parameters->value("fast_mode").toBool());
+
             if (parameters->contains("linke"))
                 radSettings.setLinke(parameters->value("linke").toFloat());
 
@@ -620,12 +625,18 @@ bool Project::loadParameters(QString parametersFileName)
             if (parameters->contains("min_points_local_detrending"))
                 interpolationSettings.setMinPointsLocalDetrending(parameters->value("min_points_local_detrending").toInt());
 
+            if (parameters->contains("threads_number"))
+                interpolationSettings.setNrThreads(parameters->value("threads_number").toInt());
+
             if (parameters->contains("topographicDistanceMaxMultiplier"))
             {
                 interpolationSettings.setTopoDist_maxKh(parameters->value("topographicDistanceMaxMultiplier").toInt());
                 qualityInterpolationSettings.setTopoDist_maxKh(parameters->value("topographicDistanceMaxMultiplier").toInt());
             }
 
+            if (parameters->contains("topographicDistanceMapFactor"))
+                interpolationSettings.setTopoDist_mapFactor(parameters->value("topographicDistanceMapFactor").toInt());
+
             if (parameters->contains("useDewPoint"))
                 interpolationSettings.setUseDewPoint(parameters->value("useDewPoint").toBool());
 
@@ -1413,6 +1424,10 @@ bool Project::loadMeteoPointsData(const QDate& firstDate, const QDate& lastDate,
         step = setProgressBar(infoStr, nrMeteoPoints);
     }
 
+    // all the points are read in a single transaction
+    QSqlDatabase db = meteoPointsDbHandler->getDb();
+    bool isTransaction = db.transaction();
+
     for (int i=0; i < nrMeteoPoints; i++)
     {
         if (showInfo)
@@ -1427,6 +1442,7 @@ bool Project::loadMeteoPointsData(const QDate& firstDate, const QDate& lastDate,
             if (meteoPointsDbHandler->loadDailyData(getCrit3DDate(firstDate), getCrit3DDate(lastDate), &(meteoPoints[i]))) isData = true;
     }
 
+    if (isTransaction) db.commit();
     if (showInfo) closeProgressBar();
 
     return isData;
@@ -1451,6 +1467,10 @@ bool Project::loadMeteoPointsData(const QDate &firstDate, const QDate &lastDate,
         step = setProgressBar(infoStr, nrMeteoPoints);
     }
 
+    // all the points are read in a single transaction
+    QSqlDatabase db = meteoPointsDbHandler->getDb();
+    bool isTransaction = db.transaction();
+
     for (int i=0; i < nrMeteoPoints; i++)
     {
         if (showInfo)
@@ -1468,6 +1488,7 @@ bool Project::loadMeteoPointsData(const QDate &firstDate, const QDate &lastDate,
         }
     }
 
+    if (isTransaction) db.commit();
     if (showInfo) closeProgressBar();
     return isData;
 }
@@ -1886,6 +1907,112 @@ bool Project::updateProxy()
     return true;
 }
 
+// it may be called by concurrent threads
+static bool computeTopographicDistanceMap(const Crit3DMeteoPoint &meteoPoint, const gis::Crit3DRasterGrid& demMap,
+                                          int mapFactor, const std::string &fileName, std::string &errorStr)
+{
+    gis::Crit3DRasterGrid myMap;
+    if (! gis::topographicDistanceMap(meteoPoint.point, demMap, &myMap))
+    {
+        errorStr = "Error in computing the topographic distance map of point: " + meteoPoint.id;
+        return false;
+    }
+
+    if (mapFactor <= 1)
+        return gis::writeEsriGrid(fileName, &myMap, errorStr);
+
+    // low resolution map with the same upper left corner
+    gis::Crit3DRasterHeader lowResHeader = *(demMap.header);
+    lowResHeader.cellSize = demMap.header->cellSize * mapFactor;
+    lowResHeader.nrRows = (demMap.header->nrRows + mapFactor - 1) / mapFactor;
+    lowResHeader.nrCols = (demMap.header->nrCols + mapFactor - 1) / mapFactor;
+    lowResHeader.llCorner.y = demMap.header->llCorner.y + demMap.header->nrRows * demMap.header->cellSize
+                              - lowResHeader.nrRows * lowResHeader.cellSize;
+
+    gis::Crit3DRasterGrid lowResMap;
+    gis::resampleGrid(myMap, &lowResMap, &lowResHeader, aggrAverage, 0);
+
+    return gis::writeEsriGrid(fileName, &lowResMap, errorStr);
+}
+
+
+std::string Project::getTopographicDistanceMapFileName(int pointIndex, QString pathTd)
+{
+    std::string fileName = pathTd.toStdString() + "TD_" + QFileInfo(demFileName).baseName().toStdString() + "_" + meteoPoints[pointIndex].id;
+
+    int mapFactor = interpolationSettings.getTopoDist_mapFactor();
+    if (mapFactor > 1)
+        fileName += "_x" + std::to_string(mapFactor);
+
+    return fileName;
+}
+
+
+/*!
+ * \brief computeTopographicDistanceMaps
+ * computes and writes the maps of the points in pointIndexes, in parallel
+ * (each thread uses a DEM-sized map)
+ */
+bool Project::computeTopographicDistanceMaps(const std::vector<int> &pointIndexes, QString pathTd, bool showInfo)
+{
+    int nrMaps = int(pointIndexes.size());
+    if (nrMaps == 0)
+        return true;
+
+    std::vector<std::string> fileNames;
+    for (int i = 0; i < nrMaps; i++)
+    {
+        fileNames.push_back(getTopographicDistanceMapFileName(pointIndexes[unsigned(i)], pathTd));
+    }
+
+    if (showInfo)
+    {
+        setProgressBar("Computing topographic distance maps...", nrMaps);
+    }
+
+    int nrThreads = parallel::getNrThreads(interpolationSettings.getNrThreads());
+    int mapFactor = interpolationSettings.getTopoDist_mapFactor();
+    std::vector<std::string> threadErrors(unsigned(nrThreads));
+    std::atomic<int> nrComputedMaps(0);
+
+    auto computeMaps = [&](long first, long last, int threadIndex) -> bool
+    {
+        for (long i = first; i < last; i++)
+        {
+            const Crit3DMeteoPoint &meteoPoint = meteoPoints[pointIndexes[unsigned(i)]];
+            if (! computeTopographicDistanceMap(meteoPoint, DEM, mapFactor, fileNames[unsigned(i)], threadErrors[unsigned(threadIndex)]))
+                return false;
+            nrComputedMaps++;
+        }
+
+        // the progress bar belongs to the calling thread
+        if (showInfo && threadIndex == 0)
+            updateProgressBar(nrComputedMaps);
+
+        return true;
+    };
+
+    bool isOk = parallel::forEachBlock(nrMaps, 1, nrThreads, computeMaps);
+
+    if (showInfo) closeProgressBar();
+
+    if (! isOk)
+    {
+        for (unsigned i = 0; i < threadErrors.size(); i++)
+        {
+            if (! threadErrors[i].empty())
+            {
+                logError(QString::fromStdString(threadErrors[i]));
+                break;
+            }
+        }
+        return false;
+    }
+
+    return true;
+}
+
+
 bool Project::writeTopographicDistanceMaps(bool onlyWithData, bool showInfo)
 {
     if (nrMeteoPoints == 0)
@@ -1904,25 +2031,11 @@ bool Project::writeTopographicDistanceMaps(bool onlyWithData, bool showInfo)
     if (! QDir(mapsFolder).exists())
         QDir().mkdir(mapsFolder);
 
-    QString infoStr = "Computing topographic distance maps...";
-    int infoStep = 0;
-    if (showInfo)
-    {
-        infoStep = setProgressBar(infoStr, nrMeteoPoints);
-    }
-
-    std::string myError;
-    std::string fileName;
-    gis::Crit3DRasterGrid myMap;
+    std::vector<int> pointIndexes;
     bool isSelected;
 
     for (int i=0; i < nrMeteoPoints; i++)
     {
-        if (showInfo)
-        {
-            if ((i % infoStep) == 0) updateProgressBar(i);
-        }
-
         if (meteoPoints[i].active)
         {
             if (! onlyWithData)
@@ -1932,18 +2045,11 @@ bool Project::writeTopographicDistanceMaps(bool onlyWithData, bool showInfo)
             }
 
             if (isSelected)
-            {
-                if (!writeTopographicDistanceMap(i, DEM, mapsFolder))
-                {
-                    return false;
-                }
-            }
+                pointIndexes.push_back(i);
         }
     }
 
-    if (showInfo) closeProgressBar();
-
-    return true;
+    return computeTopographicDistanceMaps(pointIndexes, mapsFolder, showInfo);
 }
 
 bool Project::writeTopographicDistanceMap(int pointIndex, const gis::Crit3DRasterGrid& demMap, QString pathTd)
@@ -1964,18 +2070,14 @@ bool Project::writeTopographicDistanceMap(int pointIndex, const gis::Crit3DRaste
         QDir().mkdir(pathTd);
 
     std::string myError;
-    std::string fileName;
-    gis::Crit3DRasterGrid myMap;
+    std::string fileName = getTopographicDistanceMapFileName(pointIndex, pathTd);
 
-    if (gis::topographicDistanceMap(meteoPoints[pointIndex].point, demMap, &myMap))
+    if (! computeTopographicDistanceMap(meteoPoints[pointIndex], demMap, interpolationSettings.getTopoDist_mapFactor(), fileName, myError))
     {
-        fileName = pathTd.toStdString() + "TD_" + QFileInfo(demFileName).baseName().toStdString() + "_" + meteoPoints[pointIndex].id;
-        if (! gis::writeEsriGrid(fileName, &myMap, myError))
-        {
-            logError(QString::fromStdString(myError));
-            return false;
-        }
+        logError(QString::fromStdString(myError));
+        return false;
     }
+
     return true;
 }
 
@@ -1993,25 +2095,12 @@ bool Project::loadTopographicDistanceMaps(bool onlyWithData, bool showInfo)
         QDir().mkdir(mapsFolder);
     }
 
-    int infoStep = 0;
-    if (showInfo)
-    {
-        QString infoStr = "Loading topographic distance maps...";
-        infoStep = setProgressBar(infoStr, nrMeteoPoints);
-    }
-
-    std::string myError;
-    std::string fileName;
+    std::vector<int> pointIndexes;
+    std::vector<int> missingIndexes;
     bool isSelected;
 
     for (int i=0; i < nrMeteoPoints; i++)
     {
-        if (showInfo)
-        {
-            if ((i % infoStep) == 0)
-                updateProgressBar(i);
-        }
-
         if (meteoPoints[i].active)
         {
             if (! onlyWithData)
@@ -2022,25 +2111,55 @@ bool Project::loadTopographicDistanceMaps(bool onlyWithData, bool showInfo)
 
             if (isSelected)
             {
-                fileName = mapsFolder.toStdString() + "TD_" + QFileInfo(demFileName).baseName().toStdString() + "_" + meteoPoints[i].id;
-                if (!QFile::exists(QString::fromStdString(fileName + ".flt")))
-                {
-                    if (!writeTopographicDistanceMap(i, DEM, mapsFolder))
-                    {
-                        return false;
-                    }
-                    if (showInfo) logInfo(QString::fromStdString(fileName) + " successfully created!");
-                }
-                meteoPoints[i].topographicDistance = new gis::Crit3DRasterGrid();
-                if (! gis::readEsriGrid(fileName, meteoPoints[i].topographicDistance, myError))
-                {
-                    logError(QString::fromStdString(myError));
-                    return false;
-                }
+                pointIndexes.push_back(i);
+                std::string fileName = getTopographicDistanceMapFileName(i, mapsFolder);
+                if (! QFile::exists(QString::fromStdString(fileName + ".flt")))
+                    missingIndexes.push_back(i);
             }
         }
     }
 
+    if (! missingIndexes.empty())
+    {
+        if (! DEM.isLoaded)
+        {
+            logError("Load a Digital Elevation Map before.");
+            return false;
+        }
+
+        if (! computeTopographicDistanceMaps(missingIndexes, mapsFolder, showInfo))
+            return false;
+
+        if (showInfo) logInfo(QString::number(missingIndexes.size()) + " topographic distance maps successfully created!");
+    }
+
+    int infoStep = 0;
+    if (showInfo)
+    {
+        QString infoStr = "Loading topographic distance maps...";
+        infoStep = setProgressBar(infoStr, int(pointIndexes.size()));
+    }
+
+    std::string myError;
+
+    for (unsigned i = 0; i < pointIndexes.size(); i++)
+    {
+        if (showInfo)
+        {
+            if ((i % unsigned(infoStep)) == 0)
+                updateProgressBar(int(i));
+        }
+
+        int pointIndex = pointIndexes[i];
+        std::string fileName = getTopographicDistanceMapFileName(pointIndex, mapsFolder);
+        meteoPoints[pointIndex].topographicDistance = new gis::Crit3DRasterGrid();
+        if (! gis::readEsriGrid(fileName, meteoPoints[pointIndex].topographicDistance, myError))
+        {
+            logError(QString::fromStdString(myError));
+            return false;
+        }
+    }
+
     if (showInfo) closeProgressBar();
 
     return true;
@@ -2084,6 +2203,7 @@ bool Project::interpolationOutputPoints(std::vector <Crit3DInterpolationDataPoin
 
     std::vector <double> proxyValues;
     proxyValues.resize(unsigned(interpolationSettings.getProxyNr()));
+    bool isIndexValid = interpolationSettings.getPointsIndex()->isValid(interpolationPoints);
 
     for (unsigned int i = 0; i < outputPoints.size(); i++)
     {
@@ -2103,7 +2223,7 @@ bool Project::interpolationOutputPoints(std::vector <Crit3DInterpolationDataPoin
                 }
 
                 outputPoints[i].currentValue = interpolate(interpolationPoints, &interpolationSettings,
-                                                            meteoSettings, myVar, x, y, z, proxyValues, true);
+                                                            meteoSettings, myVar, x, y, z, proxyValues, true, isIndexValid);
 
                 outputGrid->value[row][col] = outputPoints[i].currentValue;
             }
@@ -2282,6 +2402,9 @@ bool Project::interpolationDemLocalDetrending(meteoVariable myVar, const Crit3DT
 
     if (getComputeOnlyPoints())
     {
+        Crit3DDetrendingCache detrendingCache;
+        bool isIndexValid = interpolationSettings.getPointsIndex()->isValid(interpolationPoints);
+
         for (unsigned int i = 0; i < outputPoints.size(); i++)
         {
             if (outputPoints[i].active)
@@ -2293,9 +2416,9 @@ bool Project::interpolationDemLocalDetrending(meteoVariable myVar, const Crit3DT
                 if (! myRaster->isOutOfGrid(row, col))
                 {
                     std::vector <Crit3DInterpolationDataPoint> subsetInterpolationPoints;
-                    localSelection(interpolationPoints, subsetInterpolationPoints, x, y, interpolationSettings);
+                    localSelection(interpolationPoints, subsetInterpolationPoints, x, y, interpolationSettings, isIndexValid);
                     if (! preInterpolation(subsetInterpolationPoints, &interpolationSettings, meteoSettings, &climateParameters,
-                                          meteoPoints, nrMeteoPoints, myVar, myTime, errorStdStr))
+                                          meteoPoints, nrMeteoPoints, myVar, myTime, errorStdStr, detrendingCache))
                     {
                         errorString = "Error in function preInterpolation:\n" + QString::fromStdString(errorStdStr);
                         return false;
@@ -2303,7 +2426,7 @@ bool Project::interpolationDemLocalDetrending(meteoVariable myVar, const Crit3DT
 
                     getProxyValuesXY(x, y, &interpolationSettings, proxyValues);
                     outputPoints[i].currentValue = interpolate(subsetInterpolationPoints, &interpolationSettings, meteoSettings,
-                                                               myVar, x, y, outputPoints[i].z, proxyValues, true);
+                                                               myVar, x, y, outputPoints[i].z, proxyValues, true, false);
 
                     myRaster->value[row][col] = outputPoints[i].currentValue;
                 }
@@ -2312,38 +2435,12 @@ bool Project::interpolationDemLocalDetrending(meteoVariable myVar, const Crit3DT
     }
     else
     {
-        gis::Crit3DRasterHeader myHeader = *(DEM.header);
-        myRaster->initializeGrid(myHeader);
-
-        for (long row = 0; row < myHeader.nrRows ; row++)
+        if (! interpolationRasterLocalDetrending(interpolationPoints, &interpolationSettings, meteoSettings, &climateParameters,
+                                                 meteoPoints, nrMeteoPoints, myVar, myTime, myRaster, DEM, errorStdStr))
         {
-            for (long col = 0; col < myHeader.nrCols; col++)
-            {
-                float z = DEM.value[row][col];
-                if (! isEqual(z, myHeader.flag))
-                {
-                    gis::getUtmXYFromRowCol(myHeader, row, col, &x, &y);
-
-                    std::vector <Crit3DInterpolationDataPoint> subsetInterpolationPoints;
-                    localSelection(interpolationPoints, subsetInterpolationPoints, x, y, interpolationSettings);
-                    if (! preInterpolation(subsetInterpolationPoints, &interpolationSettings, meteoSettings, &climateParameters,
-                                          meteoPoints, nrMeteoPoints, myVar, myTime, errorStdStr))
-                    {
-                        errorString = "Error in function preInterpolation:\n" + QString::fromStdString(errorStdStr);
-                        return false;
-                    }
-
-                    getProxyValuesXY(x, y, &interpolationSettings, proxyValues);
-                    myRaster->value[row][col] = interpolate(subsetInterpolationPoints, &interpolationSettings, meteoSettings,
-                                                            myVar, x, y, z, proxyValues, true);
-
-
-                }
-            }
-        }
-
-        if (! gis::updateMinMaxRasterGrid(myRaster))
+            errorString = "Error in function interpolationRasterLocalDetrending:\n" + QString::fromStdString(errorStdStr);
             return false;
+        }
     }
 
     myRaster->setMapTime(myTime);
@@ -2365,6 +2462,7 @@ bool Project::interpolateDemRadiation(const Crit3DTime& myTime, gis::Crit3DRaste
     std::vector <Crit3DInterpolationDataPoint> interpolationPoints;
 
     radSettings.setGisSettings(&gisSettings);
+    radSettings.setNrThreads(interpolationSettings.getNrThreads());
 
     gis::Crit3DPoint mapCenter = DEM.getCenter();
 
@@ -2582,6 +2680,8 @@ bool Project::interpolationGrid(meteoVariable myVar, const Crit3DTime& myTime)
 
     float interpolatedValue = NODATA;
     unsigned int i, proxyIndex;
+    Crit3DDetrendingCache detrendingCache;
+    bool isIndexValid = interpolationSettings.getPointsIndex()->isValid(interpolationPoints);
 
     for (unsigned col = 0; col < unsigned(meteoGridDbHandler->meteoGrid()->gridStructure().header().nrCols); col++)
     {
@@ -2617,25 +2717,26 @@ bool Project::interpolationGrid(meteoVariable myVar, const Crit3DTime& myTime)
                     if (interpolationSettings.getUseLocalDetrending())
                     {
                         std::vector <Crit3DInterpolationDataPoint> subsetInterpolationPoints;
-                        localSelection(interpolationPoints, subsetInterpolationPoints, myX, myY, interpolationSettings);
+                        localSelection(interpolationPoints, subsetInterpolationPoints, myX, myY, interpolationSettings, isIndexValid);
 
                         if (! preInterpolation(subsetInterpolationPoints, &interpolationSettings, meteoSettings,
-                                              &climateParameters, meteoPoints, nrMeteoPoints, myVar, myTime, errorStdStr))
+                                              &climateParameters, meteoPoints, nrMeteoPoints, myVar, myTime, errorStdStr,
+                                              detrendingCache))
                         {
                             logError("Error in function preInterpolation:\n" + QString::fromStdString(errorStdStr));
                             return false;
                         }
 
-                        interpolatedValue = interpolate(subsetInterpolationPoints, &interpolationSettings, meteoSettings, myVar, myX, myY, myZ, proxyValues, true);
+                        interpolatedValue = interpolate(subsetInterpolationPoints, &interpolationSettings, meteoSettings, myVar, myX, myY, myZ, proxyValues, true, false);
                     }
                     else
                     {
-                        interpolatedValue = interpolate(interpolationPoints, &interpolationSettings, meteoSettings, myVar, myX, myY, myZ, proxyValues, true);
+                        interpolatedValue = interpolate(interpolationPoints, &interpolationSettings, meteoSettings, myVar, myX, myY, myZ, proxyValues, true, isIndexValid);
                     }
                 }
                 else
                 {
-                    interpolatedValue = interpolate(interpolationPoints, &interpolationSettings, meteoSettings, myVar, myX, myY, myZ, proxyValues, true);
+                    interpolatedValue = interpolate(interpolationPoints, &interpolationSettings, meteoSettings, myVar, myX, myY, myZ, proxyValues, true, isIndexValid);
                 }
 
                 if (freq == hourly)
@@ -2885,6 +2986,7 @@ void Project::saveRadiationParameters()
         parameters->setValue("tilt_mode", QString::fromStdString(getKeyStringTiltMode(radSettings.getTiltMode())));
         parameters->setValue("real_sky", radSettings.getRealSky());
         parameters->setValue("shadowing", radSettings.getShadowing());
+        parameters->setValue("fast_mode", radSettings.getFastMode());
         parameters->setValue("linke", QString::number(double(radSettings.getLinke())));
         parameters->setValue("albedo", QString::number(double(radSettings.getAlbedo())));
         parameters->setValue("tilt", QString::number(double(radSettings.getTilt())));
@@ -2907,6 +3009,7 @@ void Project::saveInterpolationParameters()
         parameters->setValue("topographicDistance", interpolationSettings.getUseTD());
         parameters->setValue("localDetrending", interpolationSettings.getUseLocalDetrending());
         parameters->setValue("topographicDistanceMaxMultiplier", QString::number(interpolationSettings.getTopoDist_maxKh()));
+        parameters->setValue("topographicDistanceMapFactor", QString::number(interpolationSettings.getTopoDist_mapFactor()));
         parameters->setValue("optimalDetrending", interpolationSettings.getUseBestDetrending());
         parameters->setValue("multipleDetrending", interpolationSettings.getUseMultipleDetrending());
         parameters->setValue("useDewPoint", interpolationSettings.getUseDewPoint());
@@ -2914,6 +3017,7 @@ void Project::saveInterpolationParameters()
         parameters->setValue("thermalInversion", interpolationSettings.getUseThermalInversion());
         parameters->setValue("minRegressionR2", QString::number(double(interpolationSettings.getMinRegressionR2())));
         parameters->setValue("min_points_local_detrending", QString::number(int(interpolationSettings.getMinPointsLocalDetrending())));
+        parameters->setValue("threads_number", QString::number(interpolationSettings.getNrThreads()));
     parameters->endGroup();
 
     saveProxies();
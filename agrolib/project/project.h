@@ -241,6 +241,8 @@
         bool writeTopographicDistanceMaps(bool onlyWithData, bool showInfo);
         bool writeTopographicDistanceMap(int pointIndex, const gis::Crit3DRasterGrid& demMap, QString pathTd);
         bool loadTopographicDistanceMaps(bool onlyWithData, bool showInfo);
+        bool computeTopographicDistanceMaps(const std::vector<int> &pointIndexes, QString pathTd, bool showInfo);
+        std::string getTopographicDistanceMapFileName(int pointIndex, QString pathTd);
         void passInterpolatedTemperatureToHumidityPoints(Crit3DTime myTime, Crit3DMeteoSettings *meteoSettings);
 
         bool checkInterpolation(meteoVariable myVar);
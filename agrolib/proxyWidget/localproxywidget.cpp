@@ -294,6 +294,7 @@ void Crit3DLocalProxyWidget::plot()
     outInterpolationPoints.clear();
     std::vector <Crit3DInterpolationDataPoint> subsetInterpolationPoints;
     std::string errorStdStr;
+    // single point: the spatial index is not used (checking it costs as the search)
     if (detrended.isChecked())
     {
         outInterpolationPoints.clear();
@@ -302,7 +303,7 @@ void Crit3DLocalProxyWidget::plot()
                                         interpolationSettings, meteoSettings, climateParam,
                                         outInterpolationPoints, checkSpatialQuality, errorStdStr);
 
-        localSelection(outInterpolationPoints, subsetInterpolationPoints, x, y, *interpolationSettings);
+        localSelection(outInterpolationPoints, subsetInterpolationPoints, x, y, *interpolationSettings, false);
         detrending(subsetInterpolationPoints, interpolationSettings->getSelectedCombination(), interpolationSettings, climateParam, myVar, getCurrentTime());
     }
     else
@@ -310,7 +311,7 @@ void Crit3DLocalProxyWidget::plot()
         checkAndPassDataToInterpolation(quality, myVar, meteoPoints, nrMeteoPoints, getCurrentTime(), SQinterpolationSettings,
                                         interpolationSettings, meteoSettings, climateParam,
                                         outInterpolationPoints, checkSpatialQuality, errorStdStr);
-        localSelection(outInterpolationPoints, subsetInterpolationPoints, x, y, *interpolationSettings);
+        localSelection(outInterpolationPoints, subsetInterpolationPoints, x, y, *interpolationSettings, false);
     }
     QList<QPointF> pointListPrimary, pointListSecondary, pointListSupplemental, pointListMarked;
     QMap< QString, QPointF > idPointMap1;
@@ -29,10 +29,11 @@
 #include "commonConstants.h"
 #include <fstream>
 #include <string.h>
+#include <algorithm>
 
 
 Crit3DShapeHandler::Crit3DShapeHandler()
-    : m_handle(nullptr), m_dbf(nullptr), m_count(0), m_type(0)
+    : m_handle(nullptr), m_dbf(nullptr), m_count(0), m_type(0), m_isLoadAllShapes(false)
 { }
 
 
@@ -53,6 +54,7 @@ void Crit3DShapeHandler::close()
     m_fieldsList.clear();
     m_fieldsTypeList.clear();
     holes.clear();
+    clearShapes();
 
     m_handle = nullptr;
     m_dbf = nullptr;
@@ -75,6 +77,14 @@ void Crit3DShapeHandler::closeSHP()
         SHPClose(m_handle);
     }
     m_handle = nullptr;
+    clearShapes();
+}
+
+
+void Crit3DShapeHandler::clearShapes()
+{
+    m_shapes.clear();
+    m_shapesTree.clear();
 }
 
 
@@ -123,9 +133,20 @@ bool Crit3DShapeHandler::open(std::string filename)
 
     std::vector<ShapeObject::Part> shapeParts;
 
+    // load-all mode: shapes are decoded only once, here
+    std::vector<ShapeObject> shapes;
+    if (m_isLoadAllShapes)
+    {
+        shapes.resize(unsigned(m_count));
+    }
+
     for (unsigned int i = 0; i < unsigned(m_count); i++)
     {
         getShape(int(i), myShape);
+        if (m_isLoadAllShapes)
+        {
+            shapes[i] = myShape;
+        }
         shapeParts = myShape.getParts();
 
         unsigned int nrParts = myShape.getPartCount();
@@ -152,12 +173,85 @@ bool Crit3DShapeHandler::open(std::string filename)
         shapeParts.clear();
     }
 
+    if (m_isLoadAllShapes)
+    {
+        std::vector<Box<double>> bounds(shapes.size());
+        for (unsigned int i = 0; i < shapes.size(); i++)
+        {
+            bounds[i] = shapes[i].getBounds();
+        }
+        m_shapes.swap(shapes);
+        m_shapesTree.build(bounds);
+    }
+
+    return true;
+}
+
+
+/*!
+ * \brief loadAllShapes
+ * keeps all the decoded shapes in memory and builds the R-tree of their bounds.
+ * The cache is cleared by close() and by any change of the shapefile geometry
+ */
+bool Crit3DShapeHandler::loadAllShapes()
+{
+    if (isShapesLoaded())
+    {
+        m_isLoadAllShapes = true;
+        return true;
+    }
+
+    if (m_handle == nullptr || m_count <= 0)
+        return false;
+
+    clearShapes();
+    std::vector<ShapeObject> shapes;
+    std::vector<Box<double>> bounds;
+    shapes.resize(unsigned(m_count));
+    bounds.resize(unsigned(m_count));
+    for (unsigned int i = 0; i < unsigned(m_count); i++)
+    {
+        if (! getShape(int(i), shapes[i]))
+            return false;
+        bounds[i] = shapes[i].getBounds();
+    }
+
+    m_shapes.swap(shapes);
+    m_shapesTree.build(bounds);
+    m_isLoadAllShapes = true;
+
     return true;
 }
 
 
+/*!
+ * \brief getShapePointer
+ * \return the cached shape, nullptr if the shapes are not loaded (see loadAllShapes)
+ */
+const ShapeObject* Crit3DShapeHandler::getShapePointer(int index) const
+{
+    if (index < 0 || unsigned(index) >= m_shapes.size())
+        return nullptr;
+
+    return &(m_shapes[unsigned(index)]);
+}
+
+
+/*!
+ * \brief getShapeIndexesInBox
+ * returns in ascending order the indexes of the loaded shapes whose bounds intersect the window
+ */
+void Crit3DShapeHandler::getShapeIndexesInBox(const Box<double> &window, std::vector<int> &indexes) const
+{
+    indexes.clear();
+    m_shapesTree.search(window, indexes);
+    std::sort(indexes.begin(), indexes.end());
+}
+
+
 void Crit3DShapeHandler::newShapeFile(std::string filename, int nShapeType)
 {
+    clearShapes();
     m_handle = SHPCreate(filename.c_str(), nShapeType);
     m_dbf = DBFCreate(filename.c_str());
     m_filepath = filename;
@@ -273,6 +367,12 @@ bool Crit3DShapeHandler::getShape(int index, ShapeObject &shape)
 {
     if ( (m_handle == nullptr) || (m_dbf == nullptr)) return false;
 
+    if (isShapesLoaded() && index >= 0 && index < m_count)
+    {
+        shape = m_shapes[unsigned(index)];
+        return true;
+    }
+
     SHPObject *obj = SHPReadObject(m_handle, index);
     shape.assign(obj);
     SHPDestroyObject(obj);
@@ -401,6 +501,7 @@ bool Crit3DShapeHandler::writeStringAttribute(int shapeNumber, int fieldPos, con
 
 bool Crit3DShapeHandler::deleteRecord(int shapeNumber)
 {
+    clearShapes();
     return DBFMarkRecordDeleted(m_dbf,shapeNumber,true);
 }
 
@@ -448,6 +549,7 @@ bool Crit3DShapeHandler::addRecord(std::vector<std::string> fields)
 // LC MAI testata
 bool Crit3DShapeHandler::addShape(std::string type, std::vector<double> coordinates)
 {
+    // openSHP clears the shapes cache
     openSHP(m_filepath);
     if ( (m_handle == nullptr) || (m_dbf == nullptr)) return false;
     // shpadd shp_file [[x y] [+]]
@@ -644,6 +746,21 @@ int Crit3DShapeHandler::getShapeIndexfromPoint(double utmX, double utmY)
     if (m_handle == nullptr || m_count <= 0)
         return NODATA;
 
+    if (isShapesLoaded())
+    {
+        // test only the candidate shapes, in index order (first hit as in the linear scan)
+        std::vector<int> candidates;
+        m_shapesTree.search(utmX, utmY, candidates);
+        std::sort(candidates.begin(), candidates.end());
+
+        for (unsigned int i = 0; i < candidates.size(); i++)
+        {
+            if (m_shapes[unsigned(candidates[i])].pointInPolygon(utmX, utmY))
+                return candidates[i];
+        }
+        return NODATA;
+    }
+
     ShapeObject myShape;
     for (int index = 0; index < m_count; index++)
     {
@@ -5,6 +5,7 @@
     #include <vector>
     #include <shapelib/shapefil.h>
     #include "shapeObject.h"
+    #include "shapeRTree.h"
 
     class Crit3DShapeHandler
     {
@@ -24,6 +25,13 @@
         int         m_parts;
         int         m_holes;
 
+        // load-all mode: decoded shapes and R-tree of their bounds
+        bool        m_isLoadAllShapes;
+        std::vector<ShapeObject> m_shapes;
+        ShapeRTree  m_shapesTree;
+
+        void clearShapes();
+
     public:
         Crit3DShapeHandler();
         ~Crit3DShapeHandler();
@@ -39,6 +47,13 @@
         void closeSHP();
 
         bool getShape(int index, ShapeObject &shape);
+
+        void setLoadAllShapes(bool isLoadAll) { m_isLoadAllShapes = isLoadAll; }
+        bool getLoadAllShapes() const { return m_isLoadAllShapes; }
+        bool loadAllShapes();
+        bool isShapesLoaded() const { return m_count > 0 && m_shapes.size() == unsigned(m_count); }
+        const ShapeObject* getShapePointer(int index) const;
+        void getShapeIndexesInBox(const Box<double> &window, std::vector<int> &indexes) const;
         int	getDBFFieldIndex(const char *pszFieldName);
         int	isDBFRecordDeleted(int record);
 
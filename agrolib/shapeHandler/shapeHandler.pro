@@ -39,11 +39,13 @@ SOURCES += \
     shapelib/shpopen.c      \
     shapelib/shptree.c      \
     shapeObject.cpp         \
+    shapeRTree.cpp          \
     shapeHandler.cpp
 
 
 HEADERS += \
     shapelib/shapefil.h     \
     shapeHandler.h          \
-    shapeObject.h
+    shapeObject.h           \
+    shapeRTree.h
 
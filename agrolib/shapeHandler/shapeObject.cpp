@@ -199,7 +199,7 @@ const Point<double>* ShapeObject::getVertices() const
     return const_cast<const Point<double>*>(vertices);
 }
 
-Point<double> ShapeObject::getVertex(unsigned int index)
+Point<double> ShapeObject::getVertex(unsigned int index) const
 {
     return vertices[index];
 }
@@ -249,13 +249,13 @@ bool ShapeObject::isClockWise(Part* part)
 }
 
 
-bool ShapeObject::isHole(unsigned int n)
+bool ShapeObject::isHole(unsigned int n) const
 {
     return getPart(n).hole;
 }
 
 
-bool ShapeObject::pointInPart(double x, double y, unsigned int indexPart)
+bool ShapeObject::pointInPart(double x, double y, unsigned int indexPart) const
 {
     Part part = getPart(indexPart);
 
@@ -289,7 +289,7 @@ bool ShapeObject::pointInPart(double x, double y, unsigned int indexPart)
 // WARNING: if the test point is on the border of the polygon,
 // this algorithm will deliver unpredictable results
 // --------------------------------------------------------------
-bool ShapeObject::pointInPolygon(double x, double y)
+bool ShapeObject::pointInPolygon(double x, double y) const
 {
     if (x < bounds.xmin || x > bounds.xmax || y < bounds.ymin || y > bounds.ymax)
     {
@@ -321,7 +321,7 @@ bool ShapeObject::pointInPolygon(double x, double y)
 }
 
 
-int ShapeObject::getIndexPart(double x, double y)
+int ShapeObject::getIndexPart(double x, double y) const
 {
     if (x < bounds.xmin || x > bounds.xmax || y < bounds.ymin || y > bounds.ymax)
     {
@@ -0,0 +1,169 @@
+/*!
+    \file shapeRTree.cpp
+
+    \abstract static R-tree of the shape bounding boxes
+
+    This file is part of CRITERIA-3D distribution.
+
+    CRITERIA-3D has been developed by A.R.P.A.E. Emilia-Romagna.
+
+    \copyright
+    CRITERIA-3D is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    CRITERIA-3D is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+    You should have received a copy of the GNU Lesser General Public License
+    along with CRITERIA-3D.  If not, see <http://www.gnu.org/licenses/>.
+
+    \authors
+    Fausto Tomei ftomei@arpae.it
+*/
+
+#include <algorithm>
+#include <math.h>
+#include "shapeRTree.h"
+
+
+void ShapeRTree::clear()
+{
+    nodes.clear();
+    refs.clear();
+    itemBoxes.clear();
+}
+
+
+/*!
+ * \brief build
+ * Sort-Tile-Recursive bulk loading: at each level the entries are sorted
+ * by x center, cut in vertical slices, sorted by y center inside each slice
+ * and packed in nodes of RTREE_NODE_CAPACITY entries, up to a single root
+ */
+void ShapeRTree::build(const std::vector<Box<double>> &boxes)
+{
+    clear();
+    if (boxes.empty()) return;
+
+    itemBoxes = boxes;
+    std::vector<Box<double>> levelBoxes = boxes;
+    std::vector<int> levelRefs(boxes.size());
+    for (unsigned int i = 0; i < levelRefs.size(); i++)
+        levelRefs[i] = int(i);
+
+    bool isLeaf = true;
+    std::vector<unsigned int> order;
+    std::vector<Box<double>> nextBoxes;
+    std::vector<int> nextRefs;
+
+    while (true)
+    {
+        unsigned int nrEntries = unsigned(levelBoxes.size());
+        unsigned int nrNodes = (nrEntries + RTREE_NODE_CAPACITY - 1) / RTREE_NODE_CAPACITY;
+        unsigned int nrSlices = unsigned(ceil(sqrt(double(nrNodes))));
+        unsigned int sliceSize = nrSlices * RTREE_NODE_CAPACITY;
+
+        order.resize(nrEntries);
+        for (unsigned int i = 0; i < nrEntries; i++)
+            order[i] = i;
+
+        std::sort(order.begin(), order.end(), [&levelBoxes](unsigned int a, unsigned int b)
+                  { return levelBoxes[a].xmin + levelBoxes[a].xmax < levelBoxes[b].xmin + levelBoxes[b].xmax; });
+
+        nextBoxes.clear();
+        nextRefs.clear();
+
+        for (unsigned int sliceStart = 0; sliceStart < nrEntries; sliceStart += sliceSize)
+        {
+            unsigned int sliceEnd = std::min(sliceStart + sliceSize, nrEntries);
+            std::sort(order.begin() + sliceStart, order.begin() + sliceEnd, [&levelBoxes](unsigned int a, unsigned int b)
+                      { return levelBoxes[a].ymin + levelBoxes[a].ymax < levelBoxes[b].ymin + levelBoxes[b].ymax; });
+
+            for (unsigned int nodeStart = sliceStart; nodeStart < sliceEnd; nodeStart += RTREE_NODE_CAPACITY)
+            {
+                unsigned int nodeEnd = std::min(nodeStart + RTREE_NODE_CAPACITY, sliceEnd);
+
+                Node node;
+                node.first = unsigned(refs.size());
+                node.count = nodeEnd - nodeStart;
+                node.isLeaf = isLeaf;
+                node.box = levelBoxes[order[nodeStart]];
+
+                for (unsigned int i = nodeStart; i < nodeEnd; i++)
+                {
+                    const Box<double> &box = levelBoxes[order[i]];
+                    node.box.xmin = std::min(node.box.xmin, box.xmin);
+                    node.box.ymin = std::min(node.box.ymin, box.ymin);
+                    node.box.xmax = std::max(node.box.xmax, box.xmax);
+                    node.box.ymax = std::max(node.box.ymax, box.ymax);
+                    refs.push_back(levelRefs[order[i]]);
+                }
+
+                nextBoxes.push_back(node.box);
+                nextRefs.push_back(int(nodes.size()));
+                nodes.push_back(node);
+            }
+        }
+
+        if (nextBoxes.size() == 1) break;
+
+        levelBoxes.swap(nextBoxes);
+        levelRefs.swap(nextRefs);
+        isLeaf = false;
+    }
+}
+
+
+void ShapeRTree::search(double x, double y, std::vector<int> &result) const
+{
+    Box<double> window;
+    window.xmin = x;
+    window.xmax = x;
+    window.ymin = y;
+    window.ymax = y;
+
+    search(window, result);
+}
+
+
+/*!
+ * \brief search
+ * appends to result the indices of the boxes that intersect the window (borders included)
+ */
+void ShapeRTree::search(const Box<double> &window, std::vector<int> &result) const
+{
+    if (nodes.empty()) return;
+
+    std::vector<unsigned int> stack;
+    stack.push_back(unsigned(nodes.size() - 1));
+
+    while (! stack.empty())
+    {
+        const Node &node = nodes[stack.back()];
+        stack.pop_back();
+
+        if (window.xmin > node.box.xmax || window.xmax < node.box.xmin
+            || window.ymin > node.box.ymax || window.ymax < node.box.ymin)
+            continue;
+
+        if (node.isLeaf)
+        {
+            for (unsigned int i = node.first; i < node.first + node.count; i++)
+            {
+                const Box<double> &box = itemBoxes[unsigned(refs[i])];
+                if (window.xmin <= box.xmax && window.xmax >= box.xmin
+                    && window.ymin <= box.ymax && window.ymax >= box.ymin)
+                {
+                    result.push_back(refs[i]);
+                }
+            }
+        }
+        else
+        {
+            for (unsigned int i = node.first; i < node.first + node.count; i++)
+                stack.push_back(unsigned(refs[i]));
+        }
+    }
+}
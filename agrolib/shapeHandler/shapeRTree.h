@@ -0,0 +1,45 @@
+#ifndef SHAPERTREE_H
+#define SHAPERTREE_H
+
+    #include <vector>
+    #ifndef SHAPEOBJECT_H
+        #include "shapeObject.h"
+    #endif
+
+    #define RTREE_NODE_CAPACITY 16
+
+    /*!
+     * \brief The ShapeRTree class
+     * static R-tree of the shape bounding boxes, bulk loaded with the
+     * Sort-Tile-Recursive algorithm. Queries return the indices of the
+     * boxes that contain the point (or intersect the window), not sorted
+     */
+    class ShapeRTree
+    {
+    private:
+        struct Node
+        {
+            Box<double> box;
+            unsigned int first;         // position of the first child in refs
+            unsigned int count;
+            bool isLeaf;                // children are shape indices (leaf) or node indices
+        };
+
+        std::vector<Node> nodes;        // root is the last node
+        std::vector<int> refs;
+        std::vector<Box<double>> itemBoxes;
+
+    public:
+        ShapeRTree() {}
+
+        void clear();
+        bool isEmpty() const { return nodes.empty(); }
+
+        void build(const std::vector<Box<double>> &boxes);
+
+        void search(double x, double y, std::vector<int> &result) const;
+        void search(const Box<double> &window, std::vector<int> &result) const;
+    };
+
+
+#endif // SHAPERTREE_H
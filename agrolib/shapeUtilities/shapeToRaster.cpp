@@ -1,10 +1,290 @@
 #include <float.h>
 #include <math.h>
+#include <algorithm>
 
 #include "shapeToRaster.h"
 #include "commonConstants.h"
 #include "gis.h"
 #include "basicMath.h"
+#include "parallel.h"
+
+#define RASTERIZE_MIN_ROWS_BLOCK 16
+
+
+namespace
+{
+    struct TrowCrossing
+    {
+        int row;
+        double x;           // the cell centres with x >= this value are after the crossing
+
+        bool operator < (const TrowCrossing &other) const
+        {
+            return row < other.row || (row == other.row && x < other.x);
+        }
+    };
+
+
+    struct TscanlineBuffers
+    {
+        std::vector<double> rowY;
+        std::vector<double> colX;
+        std::vector<unsigned char> rowMask;
+        std::vector<std::vector<TrowCrossing>> partCrossings;
+        std::vector<unsigned int> partCursor;
+    };
+
+
+    /*!
+     * \brief getPartCrossings
+     * crossings of the part edges with the rows of cell centres [firstRow, lastRow].
+     * Same rules of ShapeObject::pointInPart: an edge (j, i) crosses the row at y if
+     * y is in (min(yi, yj), max(yi, yj)], and it counts for the centre x if
+     * x >= min(xi, xj) and x > xi + (y-yi)/(yj-yi)*(xj-xi): the threshold of each crossing
+     * is the smallest x that satisfies both, so that the cell assignment is the same
+     */
+    void getPartCrossings(const ShapeObject &shape, const ShapeObject::Part &part,
+                          const gis::Crit3DRasterHeader &header, const std::vector<double> &rowY,
+                          int firstRow, int lastRow, std::vector<TrowCrossing> &crossings)
+    {
+        crossings.clear();
+        if (part.length == 0) return;
+
+        const Point<double>* vertices = shape.getVertices();
+        unsigned long last = part.offset + part.length - 1;
+        unsigned long j = last;
+
+        for (unsigned long i = part.offset; i <= last; i++)
+        {
+            double yi = vertices[i].y;
+            double yj = vertices[j].y;
+
+            if (yi != yj)
+            {
+                double yMin = MINVALUE(yi, yj);
+                double yMax = MAXVALUE(yi, yj);
+
+                // candidate rows (y decreases with row), then the exact test
+                int row0, row1, col;
+                gis::getRowColFromXY(header, vertices[i].x, yMax, &row0, &col);
+                gis::getRowColFromXY(header, vertices[i].x, yMin, &row1, &col);
+                row0 = MAXVALUE(row0 - 1, firstRow);
+                row1 = MINVALUE(row1 + 1, lastRow);
+
+                double xMin = MINVALUE(vertices[i].x, vertices[j].x);
+
+                for (int row = row0; row <= row1; row++)
+                {
+                    double y = rowY[unsigned(row - firstRow)];
+                    if (y > yMin && y <= yMax)
+                    {
+                        double xCross = vertices[i].x + (y - vertices[i].y) / (vertices[j].y - vertices[i].y)
+                                                        * (vertices[j].x - vertices[i].x);
+                        TrowCrossing crossing;
+                        crossing.row = row;
+                        crossing.x = (xMin > xCross) ? xMin : nextafter(xCross, DBL_MAX);
+                        crossings.push_back(crossing);
+                    }
+                }
+            }
+            j = i;
+        }
+
+        std::sort(crossings.begin(), crossings.end());
+    }
+
+
+    /*!
+     * \brief scanlineShape
+     * edge-table scanline fill of a shape on the rows [firstRow, lastRow] of the raster:
+     * the cells whose centre is inside the shape (inside an outer part and not inside a hole,
+     * as in ShapeObject::pointInPolygon) and still equal to flag are set to value
+     */
+    void scanlineShape(const ShapeObject &shape, gis::Crit3DRasterGrid &raster, float value,
+                       int firstRow, int lastRow, TscanlineBuffers &buffers)
+    {
+        Box<double> bounds = shape.getBounds();
+
+        // same window of the cell by cell test
+        int r0, r1, c0, c1;
+        gis::getRowColFromXY(*(raster.header), bounds.xmin, bounds.ymax, &r0, &c0);
+        gis::getRowColFromXY(*(raster.header), bounds.xmax, bounds.ymin, &r1, &c1);
+        r0 = MAXVALUE(r0-1, MAXVALUE(firstRow, 0));
+        r1 = MINVALUE(r1+1, MINVALUE(lastRow, raster.header->nrRows -1));
+        c0 = MAXVALUE(c0-1, 0);
+        c1 = MINVALUE(c1+1, raster.header->nrCols -1);
+        if (r0 > r1 || c0 > c1) return;
+
+        unsigned int nrRows = unsigned(r1 - r0 + 1);
+        unsigned int nrCols = unsigned(c1 - c0 + 1);
+        double x, y;
+
+        buffers.rowY.resize(nrRows);
+        for (unsigned int i = 0; i < nrRows; i++)
+        {
+            raster.getXY(r0 + int(i), c0, x, y);
+            buffers.rowY[i] = y;
+        }
+
+        buffers.colX.resize(nrCols);
+        for (unsigned int i = 0; i < nrCols; i++)
+        {
+            raster.getXY(r0, c0 + int(i), x, y);
+            buffers.colX[i] = x;
+        }
+
+        std::vector<ShapeObject::Part> parts = shape.getParts();
+        if (buffers.partCrossings.size() < parts.size())
+            buffers.partCrossings.resize(parts.size());
+
+        buffers.partCursor.assign(parts.size(), 0);
+        for (unsigned int p = 0; p < parts.size(); p++)
+        {
+            getPartCrossings(shape, parts[p], *(raster.header), buffers.rowY, r0, r1, buffers.partCrossings[p]);
+        }
+
+        buffers.rowMask.assign(nrCols, 0);
+
+        // column range inside the shape bounds
+        const double* colFirst = buffers.colX.data();
+        const double* colLast = colFirst + nrCols;
+        unsigned int shapeColFirst = unsigned(std::lower_bound(colFirst, colLast, bounds.xmin) - colFirst);
+        unsigned int shapeColEnd = unsigned(std::upper_bound(colFirst, colLast, bounds.xmax) - colFirst);
+
+        for (int row = r0; row <= r1; row++)
+        {
+            y = buffers.rowY[unsigned(row - r0)];
+            if (y < bounds.ymin || y > bounds.ymax)
+                continue;
+
+            // bit 1: inside an outer part, bit 2: inside a hole
+            unsigned int spanFirst = nrCols;
+            unsigned int spanEnd = 0;
+
+            for (unsigned int p = 0; p < parts.size(); p++)
+            {
+                const std::vector<TrowCrossing> &crossings = buffers.partCrossings[p];
+                unsigned int &k = buffers.partCursor[p];
+                while (k < crossings.size() && crossings[k].row < row)
+                    k++;
+
+                const Box<double> &partBounds = parts[p].boundsPart;
+                if (k == crossings.size() || crossings[k].row != row
+                    || y < partBounds.ymin || y > partBounds.ymax)
+                    continue;
+
+                unsigned int rowEnd = k;
+                while (rowEnd < crossings.size() && crossings[rowEnd].row == row)
+                    rowEnd++;
+
+                unsigned int partColFirst = unsigned(std::lower_bound(colFirst, colLast, partBounds.xmin) - colFirst);
+                unsigned int partColEnd = unsigned(std::upper_bound(colFirst, colLast, partBounds.xmax) - colFirst);
+                partColFirst = MAXVALUE(partColFirst, shapeColFirst);
+                partColEnd = MINVALUE(partColEnd, shapeColEnd);
+
+                unsigned char bit = parts[p].hole ? 2 : 1;
+
+                // the centres between two consecutive crossings (odd count) are inside the part
+                for (unsigned int m = k; m < rowEnd; m += 2)
+                {
+                    unsigned int colStart = unsigned(std::lower_bound(colFirst, colLast, crossings[m].x) - colFirst);
+                    unsigned int colEnd = nrCols;
+                    if (m + 1 < rowEnd)
+                        colEnd = unsigned(std::lower_bound(colFirst, colLast, crossings[m+1].x) - colFirst);
+
+                    colStart = MAXVALUE(colStart, partColFirst);
+                    colEnd = MINVALUE(colEnd, partColEnd);
+                    if (colStart >= colEnd) continue;
+
+                    for (unsigned int col = colStart; col < colEnd; col++)
+                        buffers.rowMask[col] |= bit;
+
+                    spanFirst = MINVALUE(spanFirst, colStart);
+                    spanEnd = MAXVALUE(spanEnd, colEnd);
+                }
+            }
+
+            for (unsigned int col = spanFirst; col < spanEnd; col++)
+            {
+                if (buffers.rowMask[col] == 1
+                    && int(raster.value[row][c0 + int(col)]) == int(raster.header->flag))
+                {
+                    raster.value[row][c0 + int(col)] = value;
+                }
+                buffers.rowMask[col] = 0;
+            }
+        }
+    }
+
+
+    /*!
+     * \brief fillRasterWithShapeValues
+     * rasterizes the shapes in index order: the first shape that contains a cell centre
+     * sets its value, shapes with NODATA value are skipped.
+     * When the shapes are loaded in memory (load-all mode) the raster is split in row bands
+     * processed in parallel, each band with the shapes that intersect it (R-tree query):
+     * the bands do not share cells and the order of the shapes inside a band is preserved
+     */
+    void fillRasterWithShapeValues(gis::Crit3DRasterGrid &raster, Crit3DShapeHandler &shapeHandler,
+                                   const std::vector<double> &shapeValues, int nrThreads)
+    {
+        int nrShape = int(shapeValues.size());
+
+        if (! shapeHandler.isShapesLoaded())
+        {
+            ShapeObject object;
+            TscanlineBuffers buffers;
+            for (int shapeIndex = 0; shapeIndex < nrShape; shapeIndex++)
+            {
+                if (isEqual(shapeValues[unsigned(shapeIndex)], NODATA))
+                    continue;
+
+                shapeHandler.getShape(shapeIndex, object);
+                scanlineShape(object, raster, float(shapeValues[unsigned(shapeIndex)]),
+                              0, raster.header->nrRows - 1, buffers);
+            }
+            return;
+        }
+
+        nrThreads = parallel::getNrThreads(nrThreads);
+        long nrRows = raster.header->nrRows;
+        long rowsBlock = MAXVALUE(RASTERIZE_MIN_ROWS_BLOCK, nrRows / (nrThreads * 4) + 1);
+
+        std::vector<TscanlineBuffers> threadBuffers;
+        std::vector<std::vector<int>> threadIndexes;
+        threadBuffers.resize(unsigned(nrThreads));
+        threadIndexes.resize(unsigned(nrThreads));
+
+        parallel::forEachBlock(nrRows, rowsBlock, nrThreads, [&](long first, long last, int threadIndex)
+        {
+            // window of the band, with a margin of one cell (the shape window is enlarged by one cell)
+            double x, yTop, yBottom;
+            raster.getXY(int(first), 0, x, yTop);
+            raster.getXY(int(last - 1), 0, x, yBottom);
+
+            Box<double> window;
+            window.xmin = raster.header->llCorner.x - raster.header->cellSize;
+            window.xmax = raster.header->llCorner.x + raster.header->cellSize * (raster.header->nrCols + 1);
+            window.ymin = yBottom - raster.header->cellSize * 2;
+            window.ymax = yTop + raster.header->cellSize * 2;
+
+            std::vector<int> &indexes = threadIndexes[unsigned(threadIndex)];
+            shapeHandler.getShapeIndexesInBox(window, indexes);
+
+            for (unsigned int i = 0; i < indexes.size(); i++)
+            {
+                double value = shapeValues[unsigned(indexes[i])];
+                if (isEqual(value, NODATA))
+                    continue;
+
+                scanlineShape(*(shapeHandler.getShapePointer(indexes[i])), raster, float(value),
+                              int(first), int(last - 1), threadBuffers[unsigned(threadIndex)]);
+            }
+
+            return true;
+        });
+    }
+}
 
 
 bool initializeRasterFromShape(Crit3DShapeHandler &shape, gis::Crit3DRasterGrid &raster, double cellSize)
@@ -27,8 +307,13 @@ bool initializeRasterFromShape(Crit3DShapeHandler &shape, gis::Crit3DRasterGrid
 
     for (int i = 0; i < nrShape; i++)
     {
-        shape.getShape(i, object);
-        bounds = object.getBounds();
+        const ShapeObject* myShape = shape.getShapePointer(i);
+        if (myShape == nullptr)
+        {
+            shape.getShape(i, object);
+            myShape = &object;
+        }
+        bounds = myShape->getBounds();
         ymin = MINVALUE(ymin, bounds.ymin);
         xmin = MINVALUE(xmin, bounds.xmin);
         ymax = MAXVALUE(ymax, bounds.ymax);
@@ -48,7 +333,7 @@ bool initializeRasterFromShape(Crit3DShapeHandler &shape, gis::Crit3DRasterGrid
 }
 
 
-bool fillRasterWithShapeNumber(gis::Crit3DRasterGrid &raster, Crit3DShapeHandler &shapeHandler)
+bool fillRasterWithShapeNumber(gis::Crit3DRasterGrid &raster, Crit3DShapeHandler &shapeHandler, int nrThreads)
 {
     int nrShape = shapeHandler.getShapeCount();
     if (nrShape <= 0)
@@ -57,49 +342,22 @@ bool fillRasterWithShapeNumber(gis::Crit3DRasterGrid &raster, Crit3DShapeHandler
         return false;
     }
 
-    ShapeObject object;
-    double x, y;
-    Box<double> bounds;
-    int r0, r1, c0, c1;
-
-    raster.emptyGrid();
-
+    std::vector<double> shapeValues;
+    shapeValues.resize(unsigned(nrShape));
     for (int shapeIndex = 0; shapeIndex < nrShape; shapeIndex++)
     {
-        shapeHandler.getShape(shapeIndex, object);
+        shapeValues[unsigned(shapeIndex)] = shapeIndex;
+    }
 
-        // get bounds
-        bounds = object.getBounds();
-        gis::getRowColFromXY(*(raster.header), bounds.xmin, bounds.ymax, &r0, &c0);
-        gis::getRowColFromXY(*(raster.header), bounds.xmax, bounds.ymin, &r1, &c1);
+    raster.emptyGrid();
 
-        // check bounds
-        r0 = MAXVALUE(r0-1, 0);
-        r1 = MINVALUE(r1+1, raster.header->nrRows -1);
-        c0 = MAXVALUE(c0-1, 0);
-        c1 = MINVALUE(c1+1, raster.header->nrCols -1);
-
-        for (int row = r0; row <= r1; row++)
-        {
-            for (int col = c0; col <= c1; col++)
-            {
-                if (int(raster.value[row][col]) == int(raster.header->flag))
-                {
-                    raster.getXY(row, col, x, y);
-                    if (object.pointInPolygon(x, y))
-                    {
-                        raster.value[row][col] = float(shapeIndex);
-                    }
-                }
-            }
-        }
-    }
+    fillRasterWithShapeValues(raster, shapeHandler, shapeValues, nrThreads);
 
     return true;
 }
 
 
-bool fillRasterWithField(gis::Crit3DRasterGrid &raster, Crit3DShapeHandler &shapeHandler, std::string fieldName)
+bool fillRasterWithField(gis::Crit3DRasterGrid &raster, Crit3DShapeHandler &shapeHandler, std::string fieldName, int nrThreads)
 {
     int nrShape = shapeHandler.getShapeCount();
     if (nrShape <= 0)
@@ -108,49 +366,18 @@ bool fillRasterWithField(gis::Crit3DRasterGrid &raster, Crit3DShapeHandler &shap
         return false;
     }
 
-    ShapeObject object;
-    double x, y, fieldValue;
-    Box<double> bounds;
-    int r0, r1, c0, c1;
-
     int fieldIndex = shapeHandler.getDBFFieldIndex(fieldName.c_str());
 
+    // the attributes are read here: the dbf file is not accessed by the worker threads
+    std::vector<double> shapeValues;
+    shapeValues.resize(unsigned(nrShape));
     for (int shapeIndex = 0; shapeIndex < nrShape; shapeIndex++)
     {
-        shapeHandler.getShape(shapeIndex, object);
-
-        fieldValue = shapeHandler.getNumericValue(shapeIndex, fieldIndex);
-
-        if (! isEqual(fieldValue, NODATA))
-        {
-            // get bounds
-            bounds = object.getBounds();
-            gis::getRowColFromXY(*(raster.header), bounds.xmin, bounds.ymax, &r0, &c0);
-            gis::getRowColFromXY(*(raster.header), bounds.xmax, bounds.ymin, &r1, &c1);
-
-            // check bounds
-            r0 = MAXVALUE(r0-1, 0);
-            r1 = MINVALUE(r1+1, raster.header->nrRows -1);
-            c0 = MAXVALUE(c0-1, 0);
-            c1 = MINVALUE(c1+1, raster.header->nrCols -1);
-
-            for (int row = r0; row <= r1; row++)
-            {
-                for (int col = c0; col <= c1; col++)
-                {
-                    if (int(raster.value[row][col]) == int(raster.header->flag))
-                    {
-                        raster.getXY(row, col, x, y);
-                        if (object.pointInPolygon(x, y))
-                        {
-                            raster.value[row][col] = float(fieldValue);
-                        }
-                    }
-                }
-            }
-        }
+        shapeValues[unsigned(shapeIndex)] = shapeHandler.getNumericValue(shapeIndex, fieldIndex);
     }
 
+    fillRasterWithShapeValues(raster, shapeHandler, shapeValues, nrThreads);
+
     return true;
 }
 
@@ -9,8 +9,9 @@
     #endif
 
     bool initializeRasterFromShape(Crit3DShapeHandler &shape, gis::Crit3DRasterGrid &raster, double cellSize);
-    bool fillRasterWithShapeNumber(gis::Crit3DRasterGrid &raster, Crit3DShapeHandler &shape);
-    bool fillRasterWithField(gis::Crit3DRasterGrid &raster, Crit3DShapeHandler &shape, std::string valField);
+    // nrThreads is used when the shapes are loaded in memory (see Crit3DShapeHandler::loadAllShapes): <= 0 means all cores
+    bool fillRasterWithShapeNumber(gis::Crit3DRasterGrid &raster, Crit3DShapeHandler &shape, int nrThreads = 0);
+    bool fillRasterWithField(gis::Crit3DRasterGrid &raster, Crit3DShapeHandler &shape, std::string valField, int nrThreads = 0);
     bool rasterizeShape(Crit3DShapeHandler &shape, gis::Crit3DRasterGrid &newRaster, std::string field, double cellSize);
 
 
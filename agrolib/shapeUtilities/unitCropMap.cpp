@@ -19,6 +19,8 @@ bool computeUcmPrevailing(Crit3DShapeHandler &shapeUCM, Crit3DShapeHandler &shap
     QString refFileName = QString::fromStdString(shapeCrop.getFilepath());
     QString ucmShapeFileName = cloneShapeFile(refFileName, ucmFileName);
 
+    // the reference shape is rasterized and analyzed many times: keep it in memory
+    shapeUCM.setLoadAllShapes(true);
     if (!shapeUCM.open(ucmShapeFileName.toStdString()))
     {
         error = "Load shapefile failed: " + ucmShapeFileName.toStdString();
@@ -39,6 +41,7 @@ bool computeUcmPrevailing(Crit3DShapeHandler &shapeUCM, Crit3DShapeHandler &shap
 
     // meteo grid
     if (showInfo) formInfo.setText("[2/8] Rasterize meteo grid...");
+    shapeMeteo.loadAllShapes();
     fillRasterWithShapeNumber(rasterVal, shapeMeteo);
 
     if (showInfo) formInfo.setText("[3/8] Compute matrix crop/meteo...");
@@ -52,6 +55,7 @@ bool computeUcmPrevailing(Crit3DShapeHandler &shapeUCM, Crit3DShapeHandler &shap
     if (isOk)
     {
         if (showInfo) formInfo.setText("[5/8] Rasterize soil...");
+        shapeSoil.loadAllShapes();
         fillRasterWithShapeNumber(rasterVal, shapeSoil);
 
         if (showInfo) formInfo.setText("[6/8] Compute matrix crop/soil...");
@@ -608,6 +608,9 @@ namespace soil
         double psi = fabs(signPsi);
         if (psi <=  horizon.vanGenuchten.he) return 1.0;
 
+        if (horizon.tableSe.isInitialized() && horizon.tableSe.isInside(psi))
+            return horizon.tableSe.getValue(psi);
+
         double degreeOfSaturation = pow(1.0 + pow(horizon.vanGenuchten.alpha * psi, horizon.vanGenuchten.n),
                         - horizon.vanGenuchten.m) / horizon.vanGenuchten.sc;
 
@@ -660,12 +663,61 @@ namespace soil
      */
     double waterConductivityFromSignPsi(double signPsi, const Crit3DHorizon &horizon)
     {
+        if (signPsi < 0 && horizon.tableK.isInitialized() && horizon.tableK.isInside(-signPsi))
+            return horizon.tableK.getValue(-signPsi);
+
         double theta = soil::thetaFromSignPsi(signPsi, horizon);
         double degreeOfSaturation = SeFromTheta(theta, horizon);
         return waterConductivity(degreeOfSaturation, horizon);
     }
 
 
+    /*!
+     * \brief setHydraulicTables
+     * computes the lookup tables of degree of saturation and water conductivity of the horizon
+     * (monotone cubic interpolation on log-spaced water potential, from the air-entry potential
+     * to 10^6 kPa), used by degreeOfSaturationFromSignPsi and waterConductivityFromSignPsi.
+     * Outside this range and if a table cannot be computed the formulas are used
+     * \param maxError: error bound, absolute for Se and relative for conductivity [-]
+     * \return false if a table is not computed
+     */
+    bool setHydraulicTables(Crit3DHorizon &horizon, double maxError)
+    {
+        clearHydraulicTables(horizon);
+
+        double psiMin = MAXVALUE(horizon.vanGenuchten.he, 0.01);          // [kPa]
+        double psiMax = 1000000;                                            // [kPa]
+
+        double m = horizon.vanGenuchten.m;
+        double sc = horizon.vanGenuchten.sc;
+        double kSat = horizon.waterConductivity.kSat;
+        double l = horizon.waterConductivity.l;
+
+        // Mualem: 1-(1-x)^m is computed as -expm1(m*log1p(-x)), without cancellation in dry soil
+        double kDenominator = -expm1(m * log1p(-pow(sc, 1.0 / m)));
+        auto conductivity = [&horizon, m, sc, kSat, l, kDenominator](double psi)
+        {
+            double Se = degreeOfSaturationFromSignPsi(-psi, horizon);
+            double kRelative = -expm1(m * log1p(-pow(Se * sc, 1.0 / m))) / kDenominator;
+            return kSat * pow(Se, l) * kRelative * kRelative;
+        };
+
+        // the Se table is the last one: the conductivity table uses the formula of Se
+        bool isOk = horizon.tableK.initialize(conductivity, psiMin, psiMax, maxError, true);
+        isOk &= horizon.tableSe.initialize([&horizon](double psi) { return degreeOfSaturationFromSignPsi(-psi, horizon); },
+                                           psiMin, psiMax, maxError, false);
+
+        return isOk;
+    }
+
+
+    void clearHydraulicTables(Crit3DHorizon &horizon)
+    {
+        horizon.tableSe.clear();
+        horizon.tableK.clear();
+    }
+
+
     /*!
      * \brief get water content corresponding to a specific water potential
      * \param psi: water potential  [kPa]
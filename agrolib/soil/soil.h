@@ -7,6 +7,9 @@
     #ifndef _VECTOR_
         #include <vector>
     #endif
+    #ifndef MONOTONETABLE_H
+        #include "monotoneTable.h"
+    #endif
 
     #define MINIMUM_ORGANIC_MATTER 0.005
 
@@ -151,6 +154,10 @@
             Crit3DWaterConductivity waterConductivity;
             Crit3DDriessen Driessen;
 
+            // optional lookup tables, function of water potential [kPa] (see setHydraulicTables)
+            Crit3DMonotoneTable tableSe;        /*!<  [-] degree of saturation */
+            Crit3DMonotoneTable tableK;         /*!<  [cm day^-1] water conductivity */
+
             Crit3DHorizon();
 
             double getSoilFraction()
@@ -250,6 +257,9 @@
 
         double waterConductivity(double Se, const Crit3DHorizon &horizon);
 
+        bool setHydraulicTables(Crit3DHorizon &horizon, double maxError);
+        void clearHydraulicTables(Crit3DHorizon &horizon);
+
         double estimateOrganicMatter(double upperDepth);
         double estimateSpecificDensity(double organicMatter);
         double estimateBulkDensity(const Crit3DHorizon &horizon, double totalPorosity, bool increaseWithDepth);
@@ -38,58 +38,52 @@
 #include "header/water.h"
 
 
-Tbalance balanceCurrentTimeStep, balancePreviousTimeStep, balanceCurrentPeriod, balanceWholePeriod;
-double Courant = 0.0;
-
-static double bestMBRerror;
-static bool isHalfTimeStepForced = false;
-
 
 inline void doubleTimeStep()
 {
-    myParameters.current_delta_t *= 2.0;
-    myParameters.current_delta_t = MINVALUE(myParameters.current_delta_t, myParameters.delta_t_max);
+    myContext->myParameters.current_delta_t *= 2.0;
+    myContext->myParameters.current_delta_t = MINVALUE(myContext->myParameters.current_delta_t, myContext->myParameters.delta_t_max);
 }
 
 
 void halveTimeStep()
 {
-    myParameters.current_delta_t /= 2.0;
-    myParameters.current_delta_t = MAXVALUE(myParameters.current_delta_t, myParameters.delta_t_min);
+    myContext->myParameters.current_delta_t /= 2.0;
+    myContext->myParameters.current_delta_t = MAXVALUE(myContext->myParameters.current_delta_t, myContext->myParameters.delta_t_min);
 }
 
 
 void InitializeBalanceWater()
 {
-     bestMBRerror = 100.;
-
-     balanceWholePeriod.storageWater = computeTotalWaterContent();
-     balanceCurrentTimeStep.storageWater = balanceWholePeriod.storageWater;
-     balancePreviousTimeStep.storageWater = balanceWholePeriod.storageWater;
-     balanceCurrentPeriod.storageWater = balanceWholePeriod.storageWater;
-
-     balanceCurrentTimeStep.sinkSourceWater = 0.;
-     balancePreviousTimeStep.sinkSourceWater = 0.;
-     balanceCurrentTimeStep.waterMBR = 0.;
-     balanceCurrentTimeStep.waterMBE = 0.;
-     balanceCurrentPeriod.sinkSourceWater = 0.;
-     balanceWholePeriod.sinkSourceWater = 0.;
-     balanceWholePeriod.waterMBE = 0.;
-     balanceWholePeriod.waterMBR = 0.;
+     myContext->bestMBRerror = 100.;
+
+     myContext->balanceWholePeriod.storageWater = computeTotalWaterContent();
+     myContext->balanceCurrentTimeStep.storageWater = myContext->balanceWholePeriod.storageWater;
+     myContext->balancePreviousTimeStep.storageWater = myContext->balanceWholePeriod.storageWater;
+     myContext->balanceCurrentPeriod.storageWater = myContext->balanceWholePeriod.storageWater;
+
+     myContext->balanceCurrentTimeStep.sinkSourceWater = 0.;
+     myContext->balancePreviousTimeStep.sinkSourceWater = 0.;
+     myContext->balanceCurrentTimeStep.waterMBR = 0.;
+     myContext->balanceCurrentTimeStep.waterMBE = 0.;
+     myContext->balanceCurrentPeriod.sinkSourceWater = 0.;
+     myContext->balanceWholePeriod.sinkSourceWater = 0.;
+     myContext->balanceWholePeriod.waterMBE = 0.;
+     myContext->balanceWholePeriod.waterMBR = 0.;
 
     /*! initialize link flow */
-    for (long n = 0; n < myStructure.nrNodes; n++)
+    for (long n = 0; n < myContext->myStructure.nrNodes; n++)
         {
-        nodeListPtr[n].up.sumFlow = 0.;
-        nodeListPtr[n].down.sumFlow = 0.;
-        for (short i = 0; i < myStructure.nrLateralLinks; i++)
-             nodeListPtr[n].lateral[i].sumFlow = 0.;
+        myContext->nodeListPtr[n].up.sumFlow = 0.;
+        myContext->nodeListPtr[n].down.sumFlow = 0.;
+        for (short i = 0; i < myContext->myStructure.nrLateralLinks; i++)
+             myContext->nodeListPtr[n].lateral[i].sumFlow = 0.;
         }
 
     /*! initialize boundary flow */
-    for (long n = 0; n < myStructure.nrNodes; n++)
-        if (nodeListPtr[n].boundary != nullptr)
-            nodeListPtr[n].boundary->sumBoundaryWaterFlow = 0.;
+    for (long n = 0; n < myContext->myStructure.nrNodes; n++)
+        if (myContext->nodeListPtr[n].boundary != nullptr)
+            myContext->nodeListPtr[n].boundary->sumBoundaryWaterFlow = 0.;
 }
 
 
@@ -101,15 +95,15 @@ double computeTotalWaterContent()
 {
    double theta, sum = 0.0;
 
-   for (unsigned long i = 0; i < unsigned(myStructure.nrNodes); i++)
-       if  (nodeListPtr[i].isSurface)
+   for (unsigned long i = 0; i < unsigned(myContext->myStructure.nrNodes); i++)
+       if  (myContext->nodeListPtr[i].isSurface)
        {
-           sum += (nodeListPtr[i].H - double(nodeListPtr[i].z)) * nodeListPtr[i].volume_area;
+           sum += (myContext->nodeListPtr[i].H - double(myContext->nodeListPtr[i].z)) * myContext->nodeListPtr[i].volume_area;
        }
        else
        {
            theta = theta_from_Se(i);
-           sum += theta * nodeListPtr[i].volume_area;
+           sum += theta * myContext->nodeListPtr[i].volume_area;
        }
    return(sum);
 }
@@ -123,10 +117,10 @@ double computeTotalWaterContent()
 double sumWaterFlow(double deltaT)
 {
     double sum = 0.0;
-    for (long n = 0; n < myStructure.nrNodes; n++)
+    for (long n = 0; n < myContext->myStructure.nrNodes; n++)
     {
-        if (nodeListPtr[n].Qw != 0.)
-            sum += nodeListPtr[n].Qw * deltaT;
+        if (myContext->nodeListPtr[n].Qw != 0.)
+            sum += myContext->nodeListPtr[n].Qw * deltaT;
     }
     return (sum);
 }
@@ -135,21 +129,21 @@ double sumWaterFlow(double deltaT)
 
 void computeMassBalance(double deltaT)
 {
-     balanceCurrentTimeStep.storageWater = computeTotalWaterContent();
+     myContext->balanceCurrentTimeStep.storageWater = computeTotalWaterContent();
 
-	 double dStorage = balanceCurrentTimeStep.storageWater - balancePreviousTimeStep.storageWater;
+	 double dStorage = myContext->balanceCurrentTimeStep.storageWater - myContext->balancePreviousTimeStep.storageWater;
 
-     balanceCurrentTimeStep.sinkSourceWater = sumWaterFlow(deltaT);
+     myContext->balanceCurrentTimeStep.sinkSourceWater = sumWaterFlow(deltaT);
 
-     balanceCurrentTimeStep.waterMBE = dStorage - balanceCurrentTimeStep.sinkSourceWater;
+     myContext->balanceCurrentTimeStep.waterMBE = dStorage - myContext->balanceCurrentTimeStep.sinkSourceWater;
 
      /*! reference water: sumWaterFlow or 0.1% of storage */
-     double denominator = MAXVALUE(fabs(balanceCurrentTimeStep.sinkSourceWater), balanceCurrentTimeStep.storageWater * 1e-3);
+     double denominator = MAXVALUE(fabs(myContext->balanceCurrentTimeStep.sinkSourceWater), myContext->balanceCurrentTimeStep.storageWater * 1e-3);
 
      /*! no water - minimum 1 liter */
      denominator = MAXVALUE(denominator, 0.001);
 
-	 balanceCurrentTimeStep.waterMBR = balanceCurrentTimeStep.waterMBE / denominator;
+	 myContext->balanceCurrentTimeStep.waterMBR = myContext->balanceCurrentTimeStep.waterMBE / denominator;
 }
 
 
@@ -158,11 +152,11 @@ double getMatrixValue(long i, TlinkedNode *link)
 	if (link != nullptr)
         {
         int j = 1;
-        while ((j < myStructure.maxNrColumns) && (A[i][j].index != NOLINK) && (A[i][j].index != (*link).index)) j++;
+        while ((j < myContext->myStructure.maxNrColumns) && (myContext->A[i][j].index != NOLINK) && (myContext->A[i][j].index != (*link).index)) j++;
 
         /*! Rebuild the A elements (previously normalized) */
-		if (A[i][j].index == (*link).index)
-			return (A[i][j].val * A[i][0].val);
+		if (myContext->A[i][j].index == (*link).index)
+			return (myContext->A[i][j].val * myContext->A[i][0].val);
         }
 	return double(INDEX_ERROR);
 }
@@ -184,8 +178,8 @@ void update_flux(long index, TlinkedNode *link, double delta_t)
 
 void saveBestStep()
 {
-	for (long n = 0; n < myStructure.nrNodes; n++)
-        nodeListPtr[n].bestH = nodeListPtr[n].H;
+	for (long n = 0; n < myContext->myStructure.nrNodes; n++)
+        myContext->nodeListPtr[n].bestH = myContext->nodeListPtr[n].H;
 }
 
 
@@ -193,13 +187,13 @@ void saveBestStep()
 
 void restoreBestStep(double deltaT)
 {
-    for (unsigned long n = 0; n < unsigned(myStructure.nrNodes); n++)
+    for (unsigned long n = 0; n < unsigned(myContext->myStructure.nrNodes); n++)
     {
-        nodeListPtr[n].H = nodeListPtr[n].bestH;
+        myContext->nodeListPtr[n].H = myContext->nodeListPtr[n].bestH;
 
         /*! compute new soil moisture (only sub-surface nodes) */
-        if (!nodeListPtr[n].isSurface)
-                nodeListPtr[n].Se = computeSe(n);
+        if (!myContext->nodeListPtr[n].isSurface)
+                myContext->nodeListPtr[n].Se = computeSe(n);
     }
 
      computeMassBalance(deltaT);
@@ -209,20 +203,20 @@ void restoreBestStep(double deltaT)
 void acceptStep(double deltaT)
 {
     /*! update balanceCurrentPeriod and balanceWholePeriod */
-    balancePreviousTimeStep.storageWater = balanceCurrentTimeStep.storageWater;
-    balancePreviousTimeStep.sinkSourceWater = balanceCurrentTimeStep.sinkSourceWater;
-    balanceCurrentPeriod.sinkSourceWater += balanceCurrentTimeStep.sinkSourceWater;
+    myContext->balancePreviousTimeStep.storageWater = myContext->balanceCurrentTimeStep.storageWater;
+    myContext->balancePreviousTimeStep.sinkSourceWater = myContext->balanceCurrentTimeStep.sinkSourceWater;
+    myContext->balanceCurrentPeriod.sinkSourceWater += myContext->balanceCurrentTimeStep.sinkSourceWater;
 
     /*! update sum of flow */
-    for (long i = 0; i < myStructure.nrNodes; i++)
+    for (long i = 0; i < myContext->myStructure.nrNodes; i++)
         {
-        update_flux(i, &(nodeListPtr[i].up), deltaT);
-        update_flux(i, &(nodeListPtr[i].down), deltaT);
-        for (short j = 0; j < myStructure.nrLateralLinks; j++)
-            update_flux(i, &(nodeListPtr[i].lateral[j]), deltaT);
+        update_flux(i, &(myContext->nodeListPtr[i].up), deltaT);
+        update_flux(i, &(myContext->nodeListPtr[i].down), deltaT);
+        for (short j = 0; j < myContext->myStructure.nrLateralLinks; j++)
+            update_flux(i, &(myContext->nodeListPtr[i].lateral[j]), deltaT);
 
-        if (nodeListPtr[i].boundary != nullptr)
-            nodeListPtr[i].boundary->sumBoundaryWaterFlow += nodeListPtr[i].boundary->waterFlow * deltaT;
+        if (myContext->nodeListPtr[i].boundary != nullptr)
+            myContext->nodeListPtr[i].boundary->sumBoundaryWaterFlow += myContext->nodeListPtr[i].boundary->waterFlow * deltaT;
         }
 
 }
@@ -230,22 +224,22 @@ void acceptStep(double deltaT)
 bool waterBalance(double deltaT, int approxNr)
 {
 	computeMassBalance(deltaT);
-	double MBRerror = fabs(balanceCurrentTimeStep.waterMBR);
+	double MBRerror = fabs(myContext->balanceCurrentTimeStep.waterMBR);
 
-	isHalfTimeStepForced = false;
+	myContext->isHalfTimeStepForced = false;
 
     /*! error better than previuosly */
-	if ((approxNr == 0) || (MBRerror < bestMBRerror))
+	if ((approxNr == 0) || (MBRerror < myContext->bestMBRerror))
 	{
 		saveBestStep();
-		bestMBRerror = MBRerror;
+		myContext->bestMBRerror = MBRerror;
 	}
 
     /*! best case */
-    if (MBRerror < myParameters.MBRThreshold)
+    if (MBRerror < myContext->myParameters.MBRThreshold)
         {
         acceptStep(deltaT);
-		if ((approxNr < 2) && (Courant < 0.5) && (MBRerror < (myParameters.MBRThreshold * 0.5)))
+		if ((approxNr < 2) && (myContext->Courant < 0.5) && (MBRerror < (myContext->myParameters.MBRThreshold * 0.5)))
             {
             /*! system is stable: double time step */
             doubleTimeStep();
@@ -254,13 +248,13 @@ bool waterBalance(double deltaT, int approxNr)
         }
 
     /*! worst case: error high or last approximation */
-    if ((MBRerror > (bestMBRerror * 2.0))
-        ||(approxNr == (myParameters.maxApproximationsNumber-1)))
+    if ((MBRerror > (myContext->bestMBRerror * 2.0))
+        ||(approxNr == (myContext->myParameters.maxApproximationsNumber-1)))
         {
-        if (deltaT > myParameters.delta_t_min)
+        if (deltaT > myContext->myParameters.delta_t_min)
             {
             halveTimeStep();
-            isHalfTimeStepForced = true;
+            myContext->isHalfTimeStepForced = true;
             return (false);
             }
         else
@@ -280,33 +274,33 @@ bool waterBalance(double deltaT, int approxNr)
 void updateBalanceWaterWholePeriod()
 {
     /*! update the flows in the balance (balanceWholePeriod) */
-    balanceWholePeriod.sinkSourceWater  += balanceCurrentPeriod.sinkSourceWater;
+    myContext->balanceWholePeriod.sinkSourceWater  += myContext->balanceCurrentPeriod.sinkSourceWater;
 
-    double deltaStoragePeriod = balanceCurrentTimeStep.storageWater - balanceCurrentPeriod.storageWater;
+    double deltaStoragePeriod = myContext->balanceCurrentTimeStep.storageWater - myContext->balanceCurrentPeriod.storageWater;
 
-    double deltaStorageHistorical = balanceCurrentTimeStep.storageWater - balanceWholePeriod.storageWater;
+    double deltaStorageHistorical = myContext->balanceCurrentTimeStep.storageWater - myContext->balanceWholePeriod.storageWater;
 
     /*! compute waterMBE and waterMBR */
-    balanceCurrentPeriod.waterMBE = fabs(deltaStoragePeriod - balanceCurrentPeriod.sinkSourceWater);
-    if ((balanceWholePeriod.storageWater == 0.) && (balanceWholePeriod.sinkSourceWater == 0.)) balanceWholePeriod.waterMBR = 1.;
-    else if (balanceCurrentTimeStep.storageWater > fabs(balanceWholePeriod.sinkSourceWater))
-        balanceWholePeriod.waterMBR = balanceCurrentTimeStep.storageWater / (balanceWholePeriod.storageWater + balanceWholePeriod.sinkSourceWater);
+    myContext->balanceCurrentPeriod.waterMBE = fabs(deltaStoragePeriod - myContext->balanceCurrentPeriod.sinkSourceWater);
+    if ((myContext->balanceWholePeriod.storageWater == 0.) && (myContext->balanceWholePeriod.sinkSourceWater == 0.)) myContext->balanceWholePeriod.waterMBR = 1.;
+    else if (myContext->balanceCurrentTimeStep.storageWater > fabs(myContext->balanceWholePeriod.sinkSourceWater))
+        myContext->balanceWholePeriod.waterMBR = myContext->balanceCurrentTimeStep.storageWater / (myContext->balanceWholePeriod.storageWater + myContext->balanceWholePeriod.sinkSourceWater);
     else
-        balanceWholePeriod.waterMBR = deltaStorageHistorical / balanceWholePeriod.sinkSourceWater;
+        myContext->balanceWholePeriod.waterMBR = deltaStorageHistorical / myContext->balanceWholePeriod.sinkSourceWater;
 
     /*! update storageWater in balanceCurrentPeriod */
-    balanceCurrentPeriod.storageWater = balanceCurrentTimeStep.storageWater;
+    myContext->balanceCurrentPeriod.storageWater = myContext->balanceCurrentTimeStep.storageWater;
 }
 
 
 
 bool getForcedHalvedTime()
 {
-    return (isHalfTimeStepForced);
+    return (myContext->isHalfTimeStepForced);
 }
 
 void setForcedHalvedTime(bool isForced)
 {
-    isHalfTimeStepForced = isForced;
+    myContext->isHalfTimeStepForced = isForced;
 }
 
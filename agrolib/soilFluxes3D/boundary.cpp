@@ -48,7 +48,7 @@ void initializeBoundary(Tboundary *myBoundary, int myType, float slope, float bo
     (*myBoundary).sumBoundaryWaterFlow = 0;
 	(*myBoundary).prescribedTotalPotential = NODATA;
 
-    if (myStructure.computeHeat)
+    if (myContext->myStructure.computeHeat)
     {
         (*myBoundary).Heat = new(TboundaryHeat);
 
@@ -98,16 +98,16 @@ double computeSoilSurfaceResistanceCG(double theta, double thetaSat)
  */
 double computeAtmosphericSensibleFlux(long i)
 {
-    if (nodeListPtr[i].boundary->Heat == nullptr || ! nodeListPtr[nodeListPtr[i].up.index].isSurface)
+    if (myContext->nodeListPtr[i].boundary->Heat == nullptr || ! myContext->nodeListPtr[myContext->nodeListPtr[i].up.index].isSurface)
         return 0;
 
-    double myPressure = pressureFromAltitude(double(nodeListPtr[i].z));
+    double myPressure = pressureFromAltitude(double(myContext->nodeListPtr[i].z));
 
-    double myDeltaT = nodeListPtr[i].boundary->Heat->temperature - nodeListPtr[i].extra->Heat->T;
+    double myDeltaT = myContext->nodeListPtr[i].boundary->Heat->temperature - myContext->nodeListPtr[i].extra->Heat->T;
 
-    double myCvAir = airVolumetricSpecificHeat(myPressure, nodeListPtr[i].boundary->Heat->temperature);
+    double myCvAir = airVolumetricSpecificHeat(myPressure, myContext->nodeListPtr[i].boundary->Heat->temperature);
 
-    return (myCvAir * myDeltaT * nodeListPtr[i].boundary->Heat->aerodynamicConductance);
+    return (myCvAir * myDeltaT * myContext->nodeListPtr[i].boundary->Heat->aerodynamicConductance);
 }
 
 /*!
@@ -117,20 +117,20 @@ double computeAtmosphericSensibleFlux(long i)
  */
 double computeAtmosphericLatentFlux(long i)
 {
-    if (nodeListPtr[i].boundary->Heat == nullptr || ! nodeListPtr[nodeListPtr[i].up.index].isSurface)
+    if (myContext->nodeListPtr[i].boundary->Heat == nullptr || ! myContext->nodeListPtr[myContext->nodeListPtr[i].up.index].isSurface)
         return 0;
 
     double PressSat, ConcVapSat, BoundaryVapor;
 
-    PressSat = saturationVaporPressure(nodeListPtr[i].boundary->Heat->temperature - ZEROCELSIUS);
-    ConcVapSat = vaporConcentrationFromPressure(PressSat, nodeListPtr[i].boundary->Heat->temperature);
-    BoundaryVapor = ConcVapSat * (nodeListPtr[i].boundary->Heat->relativeHumidity / 100.);
+    PressSat = saturationVaporPressure(myContext->nodeListPtr[i].boundary->Heat->temperature - ZEROCELSIUS);
+    ConcVapSat = vaporConcentrationFromPressure(PressSat, myContext->nodeListPtr[i].boundary->Heat->temperature);
+    BoundaryVapor = ConcVapSat * (myContext->nodeListPtr[i].boundary->Heat->relativeHumidity / 100.);
 
     // kg m-3
     double myDeltaVapor = BoundaryVapor - soilFluxes3D::getNodeVapor(i);
 
     // m s-1
-    double myTotalConductance = 1./((1./nodeListPtr[i].boundary->Heat->aerodynamicConductance) + (1. / nodeListPtr[i].boundary->Heat->soilConductance));
+    double myTotalConductance = 1./((1./myContext->nodeListPtr[i].boundary->Heat->aerodynamicConductance) + (1. / myContext->nodeListPtr[i].boundary->Heat->soilConductance));
 
     // kg m-2 s-1
     double myVaporFlow = myDeltaVapor * myTotalConductance;
@@ -145,26 +145,26 @@ double computeAtmosphericLatentFlux(long i)
  */
 double computeAtmosphericLatentFluxSurfaceWater(long i)
 {
-    if (! nodeListPtr[i].isSurface) return 0.;
-    if (&(nodeListPtr[i].down) == nullptr) return 0.;
+    if (! myContext->nodeListPtr[i].isSurface) return 0.;
+    if (&(myContext->nodeListPtr[i].down) == nullptr) return 0.;
 
-    long downIndex = nodeListPtr[i].down.index;
+    long downIndex = myContext->nodeListPtr[i].down.index;
 
-    if (nodeListPtr[downIndex].boundary->Heat == nullptr || nodeListPtr[downIndex].boundary->type != BOUNDARY_HEAT_SURFACE) return 0.;
+    if (myContext->nodeListPtr[downIndex].boundary->Heat == nullptr || myContext->nodeListPtr[downIndex].boundary->type != BOUNDARY_HEAT_SURFACE) return 0.;
 
     double PressSat, ConcVapSat, BoundaryVapor;
 
     // atmospheric vapor content (kg m-3)
-    PressSat = saturationVaporPressure(nodeListPtr[downIndex].boundary->Heat->temperature - ZEROCELSIUS);
-    ConcVapSat = vaporConcentrationFromPressure(PressSat, nodeListPtr[downIndex].boundary->Heat->temperature);
-    BoundaryVapor = ConcVapSat * (nodeListPtr[downIndex].boundary->Heat->relativeHumidity / 100.);
+    PressSat = saturationVaporPressure(myContext->nodeListPtr[downIndex].boundary->Heat->temperature - ZEROCELSIUS);
+    ConcVapSat = vaporConcentrationFromPressure(PressSat, myContext->nodeListPtr[downIndex].boundary->Heat->temperature);
+    BoundaryVapor = ConcVapSat * (myContext->nodeListPtr[downIndex].boundary->Heat->relativeHumidity / 100.);
 
     // surface water vapor content (kg m-3) (assuming water temperature is the same of atmosphere)
     double myDeltaVapor = BoundaryVapor - ConcVapSat;
 
     // kg m-2 s-1
     // using aerodynamic conductance of index below (boundary for heat)
-    double myVaporFlow = myDeltaVapor * nodeListPtr[downIndex].boundary->Heat->aerodynamicConductance;
+    double myVaporFlow = myDeltaVapor * myContext->nodeListPtr[downIndex].boundary->Heat->aerodynamicConductance;
 
     return myVaporFlow;
 }
@@ -176,56 +176,56 @@ double computeAtmosphericLatentFluxSurfaceWater(long i)
  */
 double computeAtmosphericLatentHeatFlux(long i)
 {
-    if (nodeListPtr[i].boundary->Heat == nullptr || ! nodeListPtr[nodeListPtr[i].up.index].isSurface)
+    if (myContext->nodeListPtr[i].boundary->Heat == nullptr || ! myContext->nodeListPtr[myContext->nodeListPtr[i].up.index].isSurface)
         return 0;
 
     double latentHeatFlow = 0.;
 
     // J kg-1
-    double lambda = latentHeatVaporization(nodeListPtr[i].extra->Heat->T - ZEROCELSIUS);
+    double lambda = latentHeatVaporization(myContext->nodeListPtr[i].extra->Heat->T - ZEROCELSIUS);
     // waterFlow: vapor sink source (m3 s-1)
-    latentHeatFlow = nodeListPtr[i].boundary->waterFlow * WATER_DENSITY * lambda;
+    latentHeatFlow = myContext->nodeListPtr[i].boundary->waterFlow * WATER_DENSITY * lambda;
 
     return latentHeatFlow;
 }
 
 double getSurfaceWaterFraction(int i)
 {
-    if (! nodeListPtr[i].isSurface)
+    if (! myContext->nodeListPtr[i].isSurface)
         return 0.0;
     else
     {
-        double h = MAXVALUE(nodeListPtr[i].H - double(nodeListPtr[i].z), 0);
-        return 1.0 - MAXVALUE(0.0, nodeListPtr[i].Soil->Pond - h) / nodeListPtr[i].Soil->Pond;
+        double h = MAXVALUE(myContext->nodeListPtr[i].H - double(myContext->nodeListPtr[i].z), 0);
+        return 1.0 - MAXVALUE(0.0, myContext->nodeListPtr[i].Soil->Pond - h) / myContext->nodeListPtr[i].Soil->Pond;
     }
 }
 
 void updateConductance()
 {
-    if (myStructure.computeHeat)
+    if (myContext->myStructure.computeHeat)
     {
-        for (long i = 0; i < myStructure.nrNodes; i++)
+        for (long i = 0; i < myContext->myStructure.nrNodes; i++)
         {
-            if (nodeListPtr[i].boundary != nullptr)
+            if (myContext->nodeListPtr[i].boundary != nullptr)
             {
-                if (nodeListPtr[i].extra->Heat != nullptr)
+                if (myContext->nodeListPtr[i].extra->Heat != nullptr)
                 {
-                    if (nodeListPtr[i].boundary->type == BOUNDARY_HEAT_SURFACE)
+                    if (myContext->nodeListPtr[i].boundary->type == BOUNDARY_HEAT_SURFACE)
                     {
                         // update aerodynamic conductance
-                        nodeListPtr[i].boundary->Heat->aerodynamicConductance =
-                                aerodynamicConductance(nodeListPtr[i].boundary->Heat->heightTemperature,
-                                    nodeListPtr[i].boundary->Heat->heightWind,
-                                    nodeListPtr[i].extra->Heat->T,
-                                    nodeListPtr[i].boundary->Heat->roughnessHeight,
-                                    nodeListPtr[i].boundary->Heat->temperature,
-                                    nodeListPtr[i].boundary->Heat->windSpeed);
-
-                        if (myStructure.computeWater)
+                        myContext->nodeListPtr[i].boundary->Heat->aerodynamicConductance =
+                                aerodynamicConductance(myContext->nodeListPtr[i].boundary->Heat->heightTemperature,
+                                    myContext->nodeListPtr[i].boundary->Heat->heightWind,
+                                    myContext->nodeListPtr[i].extra->Heat->T,
+                                    myContext->nodeListPtr[i].boundary->Heat->roughnessHeight,
+                                    myContext->nodeListPtr[i].boundary->Heat->temperature,
+                                    myContext->nodeListPtr[i].boundary->Heat->windSpeed);
+
+                        if (myContext->myStructure.computeWater)
                         {
                             // update soil surface conductance
-                            double theta = theta_from_sign_Psi(nodeListPtr[i].H - nodeListPtr[i].z, i);
-                            nodeListPtr[i].boundary->Heat->soilConductance = 1./ computeSoilSurfaceResistance(theta);
+                            double theta = theta_from_sign_Psi(myContext->nodeListPtr[i].H - myContext->nodeListPtr[i].z, i);
+                            myContext->nodeListPtr[i].boundary->Heat->soilConductance = 1./ computeSoilSurfaceResistance(theta);
                         }
                     }
                 }
@@ -239,164 +239,164 @@ void updateBoundaryWater (double deltaT)
 {
     double const EPSILON_METER = 0.0001;          // [m] 0.1 mm
 
-    for (long i = 0; i < myStructure.nrNodes; i++)
+    for (long i = 0; i < myContext->myStructure.nrNodes; i++)
     {
         // water sink-source
-        nodeListPtr[i].Qw = nodeListPtr[i].waterSinkSource;
+        myContext->nodeListPtr[i].Qw = myContext->nodeListPtr[i].waterSinkSource;
 
-        if (nodeListPtr[i].boundary != nullptr)
+        if (myContext->nodeListPtr[i].boundary != nullptr)
         {
-            nodeListPtr[i].boundary->waterFlow = 0.;
+            myContext->nodeListPtr[i].boundary->waterFlow = 0.;
 
-            if (nodeListPtr[i].boundary->type == BOUNDARY_RUNOFF)
+            if (myContext->nodeListPtr[i].boundary->type == BOUNDARY_RUNOFF)
             {
-                double avgH = (nodeListPtr[i].H + nodeListPtr[i].oldH) * 0.5;        // [m]
+                double avgH = (myContext->nodeListPtr[i].H + myContext->nodeListPtr[i].oldH) * 0.5;        // [m]
                 // Surface water available for runoff [m]
-                double hs = MAXVALUE(avgH - (nodeListPtr[i].z + nodeListPtr[i].Soil->Pond), 0.0);
+                double hs = MAXVALUE(avgH - (myContext->nodeListPtr[i].z + myContext->nodeListPtr[i].Soil->Pond), 0.0);
                 if (hs > EPSILON_METER)
                 {
-                    double maxFlow = (hs * nodeListPtr[i].volume_area) / deltaT;         // [m3 s-1] maximum flow available during the time step
+                    double maxFlow = (hs * myContext->nodeListPtr[i].volume_area) / deltaT;         // [m3 s-1] maximum flow available during the time step
                     // Manning equation
-                    double v = (1. / nodeListPtr[i].Soil->Roughness) * pow(hs, 2./3.) * sqrt(nodeListPtr[i].boundary->slope);
+                    double v = (1. / myContext->nodeListPtr[i].Soil->Roughness) * pow(hs, 2./3.) * sqrt(myContext->nodeListPtr[i].boundary->slope);
                     // on the surface boundaryArea is a side [m]
-                    double flow = nodeListPtr[i].boundary->boundaryArea * hs * v;        // [m3 s-1]
-                    nodeListPtr[i].boundary->waterFlow = -MINVALUE(flow, maxFlow);
+                    double flow = myContext->nodeListPtr[i].boundary->boundaryArea * hs * v;        // [m3 s-1]
+                    myContext->nodeListPtr[i].boundary->waterFlow = -MINVALUE(flow, maxFlow);
                 }
             }
-            else if (nodeListPtr[i].boundary->type == BOUNDARY_FREEDRAINAGE)
+            else if (myContext->nodeListPtr[i].boundary->type == BOUNDARY_FREEDRAINAGE)
             {
                 // Darcy unit gradient
                 // dH=dz=L  -> dH/L=1
-                nodeListPtr[i].boundary->waterFlow = -nodeListPtr[i].k * nodeListPtr[i].up.area;
+                myContext->nodeListPtr[i].boundary->waterFlow = -myContext->nodeListPtr[i].k * myContext->nodeListPtr[i].up.area;
             }
 
-            else if (nodeListPtr[i].boundary->type == BOUNDARY_FREELATERALDRAINAGE)
+            else if (myContext->nodeListPtr[i].boundary->type == BOUNDARY_FREELATERALDRAINAGE)
             {
                 // Darcy gradient = slope
                 // dH=dz slope=dz/L -> dH/L=slope
-                nodeListPtr[i].boundary->waterFlow = -nodeListPtr[i].k * myParameters.k_lateral_vertical_ratio
-                                            * nodeListPtr[i].boundary->boundaryArea * nodeListPtr[i].boundary->slope;
+                myContext->nodeListPtr[i].boundary->waterFlow = -myContext->nodeListPtr[i].k * myContext->myParameters.k_lateral_vertical_ratio
+                                            * myContext->nodeListPtr[i].boundary->boundaryArea * myContext->nodeListPtr[i].boundary->slope;
             }
 
-            else if (nodeListPtr[i].boundary->type == BOUNDARY_PRESCRIBEDTOTALPOTENTIAL)
+            else if (myContext->nodeListPtr[i].boundary->type == BOUNDARY_PRESCRIBEDTOTALPOTENTIAL)
             {
                 // water table
                 double L = 1.0;                         // [m]
-                double boundaryZ = nodeListPtr[i].z - L;     // [m]
+                double boundaryZ = myContext->nodeListPtr[i].z - L;     // [m]
                 double boundaryK;                       // [m s-1]
 
-                if (nodeListPtr[i].boundary->prescribedTotalPotential >= boundaryZ)
+                if (myContext->nodeListPtr[i].boundary->prescribedTotalPotential >= boundaryZ)
                 {
                     // saturated
-                    boundaryK = nodeListPtr[i].Soil->K_sat;
+                    boundaryK = myContext->nodeListPtr[i].Soil->K_sat;
                 }
                 else
                 {
                     // unsaturated
-                    double boundaryPsi = fabs(nodeListPtr[i].boundary->prescribedTotalPotential - boundaryZ);
-                    double boundarySe = computeSefromPsi_unsat(boundaryPsi, nodeListPtr[i].Soil);
-                    boundaryK = computeWaterConductivity(boundarySe, nodeListPtr[i].Soil);
+                    double boundaryPsi = fabs(myContext->nodeListPtr[i].boundary->prescribedTotalPotential - boundaryZ);
+                    double boundarySe = computeSefromPsi_unsat(boundaryPsi, myContext->nodeListPtr[i].Soil);
+                    boundaryK = computeWaterConductivity(boundarySe, myContext->nodeListPtr[i].Soil);
                 }
 
-                double meanK = computeMean(nodeListPtr[i].k, boundaryK);
-                double dH = nodeListPtr[i].boundary->prescribedTotalPotential - nodeListPtr[i].H;
-                nodeListPtr[i].boundary->waterFlow = meanK * nodeListPtr[i].boundary->boundaryArea * (dH / L);
+                double meanK = computeMean(myContext->nodeListPtr[i].k, boundaryK);
+                double dH = myContext->nodeListPtr[i].boundary->prescribedTotalPotential - myContext->nodeListPtr[i].H;
+                myContext->nodeListPtr[i].boundary->waterFlow = meanK * myContext->nodeListPtr[i].boundary->boundaryArea * (dH / L);
             }
 
-            else if (nodeListPtr[i].boundary->type == BOUNDARY_HEAT_SURFACE)
+            else if (myContext->nodeListPtr[i].boundary->type == BOUNDARY_HEAT_SURFACE)
             {
-                if (myStructure.computeHeat && myStructure.computeHeatVapor)
+                if (myContext->myStructure.computeHeat && myContext->myStructure.computeHeatVapor)
                 {
                     long upIndex;
 
                     double surfaceWaterFraction = 0.;
-                    if (&(nodeListPtr[i].up) != nullptr)
+                    if (&(myContext->nodeListPtr[i].up) != nullptr)
                     {
-                        upIndex = nodeListPtr[i].up.index;
+                        upIndex = myContext->nodeListPtr[i].up.index;
                         surfaceWaterFraction = getSurfaceWaterFraction(upIndex);
                     }
 
-                    double evapFromSoil = computeAtmosphericLatentFlux(i) / WATER_DENSITY * nodeListPtr[i].up.area;
+                    double evapFromSoil = computeAtmosphericLatentFlux(i) / WATER_DENSITY * myContext->nodeListPtr[i].up.area;
 
                     // surface water
                     if (surfaceWaterFraction > 0.)
                     {
-                        double waterVolume = (nodeListPtr[upIndex].H - nodeListPtr[upIndex].z) * nodeListPtr[upIndex].volume_area;
-                        double evapFromSurface = computeAtmosphericLatentFluxSurfaceWater(upIndex) / WATER_DENSITY * nodeListPtr[i].up.area;
+                        double waterVolume = (myContext->nodeListPtr[upIndex].H - myContext->nodeListPtr[upIndex].z) * myContext->nodeListPtr[upIndex].volume_area;
+                        double evapFromSurface = computeAtmosphericLatentFluxSurfaceWater(upIndex) / WATER_DENSITY * myContext->nodeListPtr[i].up.area;
 
                         evapFromSoil *= (1. - surfaceWaterFraction);
                         evapFromSurface *= surfaceWaterFraction;
 
                         evapFromSurface = MAXVALUE(evapFromSurface, -waterVolume / deltaT);
 
-                        if (nodeListPtr[upIndex].boundary != nullptr)
-                            nodeListPtr[upIndex].boundary->waterFlow = evapFromSurface;
+                        if (myContext->nodeListPtr[upIndex].boundary != nullptr)
+                            myContext->nodeListPtr[upIndex].boundary->waterFlow = evapFromSurface;
                         else
-                            nodeListPtr[upIndex].Qw += evapFromSurface;
+                            myContext->nodeListPtr[upIndex].Qw += evapFromSurface;
 
                     }
 
                     if (evapFromSoil < 0.)
-                        evapFromSoil = MAXVALUE(evapFromSoil, -(theta_from_Se(i) - nodeListPtr[i].Soil->Theta_r) * nodeListPtr[i].volume_area / deltaT);
+                        evapFromSoil = MAXVALUE(evapFromSoil, -(theta_from_Se(i) - myContext->nodeListPtr[i].Soil->Theta_r) * myContext->nodeListPtr[i].volume_area / deltaT);
                     else
-                        evapFromSoil = MINVALUE(evapFromSoil, (nodeListPtr[i].Soil->Theta_s - nodeListPtr[i].Soil->Theta_r) * nodeListPtr[i].volume_area / deltaT);
+                        evapFromSoil = MINVALUE(evapFromSoil, (myContext->nodeListPtr[i].Soil->Theta_s - myContext->nodeListPtr[i].Soil->Theta_r) * myContext->nodeListPtr[i].volume_area / deltaT);
 
-                    nodeListPtr[i].boundary->waterFlow = evapFromSoil;
+                    myContext->nodeListPtr[i].boundary->waterFlow = evapFromSoil;
                 }
             }            
 
-            nodeListPtr[i].Qw += nodeListPtr[i].boundary->waterFlow;
+            myContext->nodeListPtr[i].Qw += myContext->nodeListPtr[i].boundary->waterFlow;
         }
     }
 
 	// Culvert
-	if (myCulvert.index != NOLINK)
+	if (myContext->myCulvert.index != NOLINK)
 	{
-		long i = myCulvert.index;
-		double waterLevel = 0.5 * (nodeListPtr[i].H + nodeListPtr[i].oldH) - nodeListPtr[i].z;		// [m]
+		long i = myContext->myCulvert.index;
+		double waterLevel = 0.5 * (myContext->nodeListPtr[i].H + myContext->nodeListPtr[i].oldH) - myContext->nodeListPtr[i].z;		// [m]
 
         double flow = 0.0;                                                          // [m3 s-1]
 
-		if (waterLevel >= myCulvert.height * 1.5)
+		if (waterLevel >= myContext->myCulvert.height * 1.5)
 		{
 			// pressure flow - Hazen-Williams equation
-			double equivalentDiameter = sqrt((4. * myCulvert.width * myCulvert.height) / PI);
+			double equivalentDiameter = sqrt((4. * myContext->myCulvert.width * myContext->myCulvert.height) / PI);
 			// roughness = 70 (rough concrete)
-            flow = (70.0 * pow(myCulvert.slope, 0.54) * pow(equivalentDiameter, 2.63)) / 3.591;
+            flow = (70.0 * pow(myContext->myCulvert.slope, 0.54) * pow(equivalentDiameter, 2.63)) / 3.591;
 
 		}
-		else if (waterLevel > myCulvert.height)
+		else if (waterLevel > myContext->myCulvert.height)
 		{
 			// mixed flow: open channel - pressure flow
-            double wettedPerimeter = myCulvert.width + 2.* myCulvert.height;                // [m]
-            double hydraulicRadius = nodeListPtr[i].boundary->boundaryArea / wettedPerimeter;	// [m]
+            double wettedPerimeter = myContext->myCulvert.width + 2.* myContext->myCulvert.height;                // [m]
+            double hydraulicRadius = myContext->nodeListPtr[i].boundary->boundaryArea / wettedPerimeter;	// [m]
 
             // maximum Manning flow [m3 s-1]
-            double ManningFlow = (nodeListPtr[i].boundary->boundaryArea / myCulvert.roughness)
-                                * sqrt(myCulvert.slope) * pow(hydraulicRadius, 2. / 3.);
+            double ManningFlow = (myContext->nodeListPtr[i].boundary->boundaryArea / myContext->myCulvert.roughness)
+                                * sqrt(myContext->myCulvert.slope) * pow(hydraulicRadius, 2. / 3.);
 
 			// pressure flow - Hazen-Williams equation - roughness = 70
-			double equivalentDiameter = sqrt((4. * myCulvert.width * myCulvert.height) / PI);
-            double pressureFlow = (70.0 * pow(myCulvert.slope, 0.54) * pow(equivalentDiameter, 2.63)) / 3.591;
+			double equivalentDiameter = sqrt((4. * myContext->myCulvert.width * myContext->myCulvert.height) / PI);
+            double pressureFlow = (70.0 * pow(myContext->myCulvert.slope, 0.54) * pow(equivalentDiameter, 2.63)) / 3.591;
 
-			double weight = (waterLevel - myCulvert.height) / (myCulvert.height * 0.5);
+			double weight = (waterLevel - myContext->myCulvert.height) / (myContext->myCulvert.height * 0.5);
 			flow = weight * pressureFlow + (1. - weight) * ManningFlow;
 
 		}
-		else if (waterLevel > nodeListPtr[i].Soil->Pond)
+		else if (waterLevel > myContext->nodeListPtr[i].Soil->Pond)
 		{
 			// open channel flow
-            double boundaryArea = myCulvert.width * waterLevel;					// [m^2]
-            double wettedPerimeter = myCulvert.width + 2.0 * waterLevel;        // [m]
+            double boundaryArea = myContext->myCulvert.width * waterLevel;					// [m^2]
+            double wettedPerimeter = myContext->myCulvert.width + 2.0 * waterLevel;        // [m]
             double hydraulicRadius = boundaryArea / wettedPerimeter;			// [m]
 
 			// Manning equation [m^3 s^-1] 
-            flow = (boundaryArea / myCulvert.roughness) * sqrt(myCulvert.slope) * pow(hydraulicRadius, 2./3.);
+            flow = (boundaryArea / myContext->myCulvert.roughness) * sqrt(myContext->myCulvert.slope) * pow(hydraulicRadius, 2./3.);
 		}
 
 		// set boundary
-		nodeListPtr[i].boundary->waterFlow = -flow;
-		nodeListPtr[i].Qw += nodeListPtr[i].boundary->waterFlow;
+		myContext->nodeListPtr[i].boundary->waterFlow = -flow;
+		myContext->nodeListPtr[i].Qw += myContext->nodeListPtr[i].boundary->waterFlow;
 	}
 }
 
@@ -405,79 +405,79 @@ void updateBoundaryHeat()
 {
     double myWaterFlux, advTemperature, heatFlux;
 
-    for (long i = 1; i < myStructure.nrNodes; i++)
+    for (long i = 1; i < myContext->myStructure.nrNodes; i++)
     {
         if (isHeatNode(i))
         {
-            nodeListPtr[i].extra->Heat->Qh = nodeListPtr[i].extra->Heat->sinkSource;
+            myContext->nodeListPtr[i].extra->Heat->Qh = myContext->nodeListPtr[i].extra->Heat->sinkSource;
 
-            if (nodeListPtr[i].boundary != nullptr)
+            if (myContext->nodeListPtr[i].boundary != nullptr)
             {
-                if (nodeListPtr[i].boundary->type == BOUNDARY_HEAT_SURFACE)
+                if (myContext->nodeListPtr[i].boundary->type == BOUNDARY_HEAT_SURFACE)
                 {
-                    nodeListPtr[i].boundary->Heat->advectiveHeatFlux = 0.;
-                    nodeListPtr[i].boundary->Heat->sensibleFlux = 0.;
-                    nodeListPtr[i].boundary->Heat->latentFlux = 0.;
-                    nodeListPtr[i].boundary->Heat->radiativeFlux = 0.;
+                    myContext->nodeListPtr[i].boundary->Heat->advectiveHeatFlux = 0.;
+                    myContext->nodeListPtr[i].boundary->Heat->sensibleFlux = 0.;
+                    myContext->nodeListPtr[i].boundary->Heat->latentFlux = 0.;
+                    myContext->nodeListPtr[i].boundary->Heat->radiativeFlux = 0.;
 
-                    if (nodeListPtr[i].boundary->Heat->netIrradiance != NODATA)
-                        nodeListPtr[i].boundary->Heat->radiativeFlux = nodeListPtr[i].boundary->Heat->netIrradiance;
+                    if (myContext->nodeListPtr[i].boundary->Heat->netIrradiance != NODATA)
+                        myContext->nodeListPtr[i].boundary->Heat->radiativeFlux = myContext->nodeListPtr[i].boundary->Heat->netIrradiance;
 
-                    nodeListPtr[i].boundary->Heat->sensibleFlux += computeAtmosphericSensibleFlux(i);
+                    myContext->nodeListPtr[i].boundary->Heat->sensibleFlux += computeAtmosphericSensibleFlux(i);
 
-                    if (myStructure.computeWater && myStructure.computeHeatVapor)
-                        nodeListPtr[i].boundary->Heat->latentFlux += computeAtmosphericLatentHeatFlux(i) / nodeListPtr[i].up.area;
+                    if (myContext->myStructure.computeWater && myContext->myStructure.computeHeatVapor)
+                        myContext->nodeListPtr[i].boundary->Heat->latentFlux += computeAtmosphericLatentHeatFlux(i) / myContext->nodeListPtr[i].up.area;
 
-                    if (myStructure.computeWater && myStructure.computeHeatAdvection)
+                    if (myContext->myStructure.computeWater && myContext->myStructure.computeHeatAdvection)
                     {
                         // advective heat from rain
-                        myWaterFlux = nodeListPtr[i].up.linkedExtra->heatFlux->waterFlux;
+                        myWaterFlux = myContext->nodeListPtr[i].up.linkedExtra->heatFlux->waterFlux;
                         if (myWaterFlux > 0.)
                         {
-                            advTemperature = nodeListPtr[i].boundary->Heat->temperature;
-                            heatFlux =  myWaterFlux * HEAT_CAPACITY_WATER * advTemperature / nodeListPtr[i].up.area;
-                            nodeListPtr[i].boundary->Heat->advectiveHeatFlux += heatFlux;
+                            advTemperature = myContext->nodeListPtr[i].boundary->Heat->temperature;
+                            heatFlux =  myWaterFlux * HEAT_CAPACITY_WATER * advTemperature / myContext->nodeListPtr[i].up.area;
+                            myContext->nodeListPtr[i].boundary->Heat->advectiveHeatFlux += heatFlux;
                         }
 
                         // advective heat from evaporation/condensation
-                        if (nodeListPtr[i].boundary->waterFlow < 0.)
-                            advTemperature = nodeListPtr[i].extra->Heat->T;
+                        if (myContext->nodeListPtr[i].boundary->waterFlow < 0.)
+                            advTemperature = myContext->nodeListPtr[i].extra->Heat->T;
                         else
-                            advTemperature = nodeListPtr[i].boundary->Heat->temperature;
+                            advTemperature = myContext->nodeListPtr[i].boundary->Heat->temperature;
 
-                        nodeListPtr[i].boundary->Heat->advectiveHeatFlux += nodeListPtr[i].boundary->waterFlow * WATER_DENSITY * HEAT_CAPACITY_WATER_VAPOR * advTemperature / nodeListPtr[i].up.area;
+                        myContext->nodeListPtr[i].boundary->Heat->advectiveHeatFlux += myContext->nodeListPtr[i].boundary->waterFlow * WATER_DENSITY * HEAT_CAPACITY_WATER_VAPOR * advTemperature / myContext->nodeListPtr[i].up.area;
 
                     }
 
-                    nodeListPtr[i].extra->Heat->Qh += nodeListPtr[i].up.area * (nodeListPtr[i].boundary->Heat->radiativeFlux +
-                                                                      nodeListPtr[i].boundary->Heat->sensibleFlux +
-                                                                      nodeListPtr[i].boundary->Heat->latentFlux +
-                                                                      nodeListPtr[i].boundary->Heat->advectiveHeatFlux);
+                    myContext->nodeListPtr[i].extra->Heat->Qh += myContext->nodeListPtr[i].up.area * (myContext->nodeListPtr[i].boundary->Heat->radiativeFlux +
+                                                                      myContext->nodeListPtr[i].boundary->Heat->sensibleFlux +
+                                                                      myContext->nodeListPtr[i].boundary->Heat->latentFlux +
+                                                                      myContext->nodeListPtr[i].boundary->Heat->advectiveHeatFlux);
                 }
-                else if (nodeListPtr[i].boundary->type == BOUNDARY_FREEDRAINAGE ||
-                         nodeListPtr[i].boundary->type == BOUNDARY_PRESCRIBEDTOTALPOTENTIAL)
+                else if (myContext->nodeListPtr[i].boundary->type == BOUNDARY_FREEDRAINAGE ||
+                         myContext->nodeListPtr[i].boundary->type == BOUNDARY_PRESCRIBEDTOTALPOTENTIAL)
                 {
-                    if (myStructure.computeWater && myStructure.computeHeatAdvection)
+                    if (myContext->myStructure.computeWater && myContext->myStructure.computeHeatAdvection)
                     {
-                        myWaterFlux = nodeListPtr[i].boundary->waterFlow;
+                        myWaterFlux = myContext->nodeListPtr[i].boundary->waterFlow;
 
                         if (myWaterFlux < 0)
-                            advTemperature = nodeListPtr[i].extra->Heat->T;
+                            advTemperature = myContext->nodeListPtr[i].extra->Heat->T;
                         else
-                            advTemperature = nodeListPtr[i].boundary->Heat->fixedTemperature;
+                            advTemperature = myContext->nodeListPtr[i].boundary->Heat->fixedTemperature;
 
-                        heatFlux =  myWaterFlux * HEAT_CAPACITY_WATER * advTemperature / nodeListPtr[i].up.area;
-                        nodeListPtr[i].boundary->Heat->advectiveHeatFlux = heatFlux;
+                        heatFlux =  myWaterFlux * HEAT_CAPACITY_WATER * advTemperature / myContext->nodeListPtr[i].up.area;
+                        myContext->nodeListPtr[i].boundary->Heat->advectiveHeatFlux = heatFlux;
 
-                        nodeListPtr[i].extra->Heat->Qh += nodeListPtr[i].up.area * nodeListPtr[i].boundary->Heat->advectiveHeatFlux;
+                        myContext->nodeListPtr[i].extra->Heat->Qh += myContext->nodeListPtr[i].up.area * myContext->nodeListPtr[i].boundary->Heat->advectiveHeatFlux;
                     }
 
-                    if (nodeListPtr[i].boundary->Heat->fixedTemperature != NODATA)
+                    if (myContext->nodeListPtr[i].boundary->Heat->fixedTemperature != NODATA)
                     {
                         double avgH = getHMean(i);
-                        double boundaryHeatConductivity = SoilHeatConductivity(i, nodeListPtr[i].extra->Heat->T, avgH - nodeListPtr[i].z);
-                        double deltaT = nodeListPtr[i].boundary->Heat->fixedTemperature - nodeListPtr[i].extra->Heat->T;
-                        nodeListPtr[i].extra->Heat->Qh += boundaryHeatConductivity * deltaT / nodeListPtr[i].boundary->Heat->fixedTemperatureDepth * nodeListPtr[i].up.area;
+                        double boundaryHeatConductivity = SoilHeatConductivity(i, myContext->nodeListPtr[i].extra->Heat->T, avgH - myContext->nodeListPtr[i].z);
+                        double deltaT = myContext->nodeListPtr[i].boundary->Heat->fixedTemperature - myContext->nodeListPtr[i].extra->Heat->T;
+                        myContext->nodeListPtr[i].extra->Heat->Qh += boundaryHeatConductivity * deltaT / myContext->nodeListPtr[i].boundary->Heat->fixedTemperatureDepth * myContext->nodeListPtr[i].up.area;
                     }
                 }
             }
@@ -60,11 +60,11 @@ void initializeNodeHeatFlux(TCrit3DLinkedNodeExtra* myLinkExtra, bool initHeat,
 {
     if (myLinkExtra == nullptr) return;
     if (myLinkExtra->heatFlux == nullptr) return;
-    if (! myStructure.computeHeat) return;
+    if (! myContext->myStructure.computeHeat) return;
 
-    if (myStructure.saveHeatFluxesType == SAVE_HEATFLUXES_TOTAL && initHeat)
+    if (myContext->myStructure.saveHeatFluxesType == SAVE_HEATFLUXES_TOTAL && initHeat)
         myLinkExtra->heatFlux->fluxes[HEATFLUX_TOTAL] = NODATA;
-    else if (myStructure.saveHeatFluxesType == SAVE_HEATFLUXES_ALL)
+    else if (myContext->myStructure.saveHeatFluxesType == SAVE_HEATFLUXES_ALL)
     {
         if (initHeat)
         {
@@ -95,9 +95,9 @@ void initializeLinkExtra(TCrit3DLinkedNodeExtra* myLinkedNodeExtra, bool compute
         (*myLinkedNodeExtra).heatFlux->waterFlux = 0.;
         (*myLinkedNodeExtra).heatFlux->vaporFlux = 0.;
 
-        if (myStructure.saveHeatFluxesType == SAVE_HEATFLUXES_ALL)
+        if (myContext->myStructure.saveHeatFluxesType == SAVE_HEATFLUXES_ALL)
             (*myLinkedNodeExtra).heatFlux->fluxes = new float[9];
-        else if (myStructure.saveHeatFluxesType == SAVE_HEATFLUXES_TOTAL)
+        else if (myContext->myStructure.saveHeatFluxesType == SAVE_HEATFLUXES_TOTAL)
             (*myLinkedNodeExtra).heatFlux->fluxes = new float[1];
         else
             (*myLinkedNodeExtra).heatFlux->fluxes = nullptr;
@@ -8,6 +8,7 @@
     struct TParameters
     {
         int numericalSolutionMethod;
+        int nrThreads;
         double MBRThreshold;
         double ResidualTolerance;
         double delta_t_min;
@@ -20,10 +21,13 @@
         int meanType;
         float k_lateral_vertical_ratio;
         double heatWeightingFactor;
+        bool useHydraulicTables;
+        double hydraulicTableError;
 
         void initialize()
         {
             numericalSolutionMethod = RELAXATION;
+            nrThreads = 1;
             delta_t_min = 1;
             delta_t_max = 600;
             current_delta_t = delta_t_max;
@@ -35,6 +39,8 @@
             meanType = MEAN_LOGARITHMIC;
             k_lateral_vertical_ratio = 10.;
             heatWeightingFactor = 0.5;
+            useHydraulicTables = false;
+            hydraulicTableError = 1E-4;
         }
     };
 
@@ -14,11 +14,19 @@
         #define __STDCALL
     #endif
 	
+    struct TCrit3DContext;
+
     namespace soilFluxes3D {
 
     // TEST
     __EXTERN int DLL_EXPORT __STDCALL test();
 
+    // CONTEXT (each thread works on its current context, the default one if not set)
+    __EXTERN TCrit3DContext* DLL_EXPORT __STDCALL createContext();
+    __EXTERN void DLL_EXPORT __STDCALL deleteContext(TCrit3DContext* context);
+    __EXTERN void DLL_EXPORT __STDCALL setContext(TCrit3DContext* context);
+    __EXTERN TCrit3DContext* DLL_EXPORT __STDCALL getContext();
+
     // INITIALIZATION
     __EXTERN void DLL_EXPORT __STDCALL cleanMemory();
     __EXTERN int DLL_EXPORT __STDCALL initialize(long nrNodes, int nrLayers, int nrLateralLinks, bool computeWater_, bool computeHeat_, bool computeSolutes_);
@@ -28,6 +36,8 @@
                               int maxIterationNumber, int maxApproximationsNumber,
                               int errorMagnitude, float MBRMagnitude);
 
+    __EXTERN int DLL_EXPORT __STDCALL setSolverMethod(int solutionMethod, int nrThreads);
+
     // TOPOLOGY
     __EXTERN int DLL_EXPORT __STDCALL setNode(long myIndex, float x, float y, double z, double volume_or_area,
                                         bool isSurface, bool isBoundary, int boundaryType, float slope, float boundaryArea);
@@ -43,6 +53,7 @@
                                         double organicMatter, double clay);
 
     __EXTERN int DLL_EXPORT __STDCALL setNodeSoil(long nodeIndex, int soilIndex, int horizonIndex);
+    __EXTERN int DLL_EXPORT __STDCALL setHydraulicTables(bool isActive, double maxError);
 
     // SURFACE
     __EXTERN int DLL_EXPORT __STDCALL setSurfaceProperties(int surfaceIndex, double Roughness, double minWaterLevelRunoff);
@@ -3,6 +3,10 @@
 
     struct Tsoil;
 
+    // range of the hydraulic tables: |psi| [m]
+    #define HYDRAULIC_TABLE_MIN_PSI 0.001
+    #define HYDRAULIC_TABLE_MAX_PSI 100000.
+
     double computeWaterConductivity(double Se, Tsoil *mySoil);
     double computeSefromPsi_unsat(double myPsi, Tsoil *mySoil);
     double theta_from_Se(unsigned long myIndex);
@@ -15,6 +19,8 @@
     double dThetav_dH(unsigned long myIndex, double temperature, double dTheta_dH);
     double computeK(unsigned long myIndex);
     double compute_K_Mualem(double Ksat, double Se, double VG_Sc, double VG_m, double Mualem_L);
+    bool computeHydraulicTables(Tsoil *mySoil, double maxError);
+    void clearHydraulicTables(Tsoil *mySoil);
     double getThetaMean(long i);
     double getTheta(long i, double H);
     double getHMean(long i);
@@ -1,6 +1,9 @@
 #ifndef SOLVER_H
 #define SOLVER_H
 
+    // minimum number of nodes for each thread of the multicolor relaxation
+    #define SOLVER_BLOCK_SIZE 4096
+
     inline double square(double x) {return ((x)*(x));}
 
     double distance(unsigned long index1, unsigned long index2);
@@ -11,6 +14,10 @@
 
     double arithmeticMean(double v1, double v2);
 
+    void buildMatrixCSR();
+
+    void buildColors();
+
     bool GaussSeidelRelaxation (int myApproximation, double myResidualTolerance, int myProcess);
 
 #endif  // SOLVER_H
@@ -7,6 +7,12 @@
     #ifndef TYPESEXTRA_H
         #include "extra.h"
     #endif
+    #ifndef _VECTOR_
+        #include <vector>
+    #endif
+    #ifndef MONOTONETABLE_H
+        #include "monotoneTable.h"
+    #endif
 
     struct Tboundary
     {
@@ -79,6 +85,11 @@
         //for heat
         double organicMatter;       /*!< [-] fraction of organic matter */
         double clay;                /*!< [-] fraction of clay */
+
+        // optional lookup tables, function of |psi| [m] (see setHydraulicTables)
+        Crit3DMonotoneTable tableSe;        /*!< [-] degree of saturation */
+        Crit3DMonotoneTable tableK;         /*!< [m/sec] water conductivity */
+        Crit3DMonotoneTable tableDSe;       /*!< [m^-1] dSe/dpsi */
     };
 
 
@@ -137,15 +148,51 @@
 		double slope;				/*!< [-] */
     };
 
-    extern TCrit3DStructure myStructure;
-    extern TParameters myParameters;
-    extern TCrit3Dnode *nodeListPtr;
-    extern TmatrixElement **A;
-    extern Tculvert myCulvert;
-    extern double *b, *C, *X;
-    extern double *invariantFlux;         // array accessorio per flussi avvettivi e latenti
-    extern double Courant;
+    /*!
+     * \brief solver context: all the state of a simulation (nodes, matrix, parameters, balance)
+     * independent simulations need distinct contexts, see soilFluxes3D::setContext
+     */
+    struct TCrit3DContext
+    {
+        TCrit3DStructure myStructure;
+        TParameters myParameters;
+        TCrit3Dnode *nodeListPtr = nullptr;
+        TmatrixElement **A = nullptr;
+        Tculvert myCulvert;
+        double *b = nullptr;
+        double *C = nullptr;
+        double *X = nullptr;
+        double *invariantFlux = nullptr;         // array accessorio per flussi avvettivi e latenti
+
+        std::vector< std::vector<Tsoil>> Soil_List;
+        std::vector<Tsoil> Surface_List;
+
+        Tbalance balanceCurrentTimeStep, balancePreviousTimeStep, balanceCurrentPeriod, balanceWholePeriod;
+        double Courant = 0.0;
+        double bestMBRerror = 0.0;
+        bool isHalfTimeStepForced = false;
+
+        double CourantHeat = 0.0;
+        double fluxCourant = 0.0;
+
+        // compressed sparse row copy of the off-diagonal elements of A (see buildMatrixCSR)
+        std::vector<long> rowStart;
+        std::vector<long> colIndex;
+        std::vector<double> colValue;
+
+        // multicolor ordering: nodes of the same color are not linked (MULTICOLOR_RELAXATION)
+        std::vector<long> colorStart;
+        std::vector<long> colorNodes;
+    };
+
+    // current context of the calling thread
+    // (__thread avoids the access wrapper that gcc and clang use for extern thread_local variables)
+    #if defined(__GNUC__)
+        #define CONTEXT_THREAD_LOCAL __thread
+    #else
+        #define CONTEXT_THREAD_LOCAL thread_local
+    #endif
 
-    extern Tbalance balanceCurrentTimeStep, balancePreviousTimeStep, balanceCurrentPeriod, balanceWholePeriod;
+    extern CONTEXT_THREAD_LOCAL TCrit3DContext* myContext;
 
 #endif // SOILFLUXES3DTYPES
@@ -39,20 +39,18 @@
 #include "header/soilFluxes3D.h"
 #include "header/boundary.h"
 
-static double CourantHeat, fluxCourant;
-
 bool isHeatNode(long i)
 {
-    return (myStructure.computeHeat &&
-            nodeListPtr != nullptr &&
-            nodeListPtr[i].extra != nullptr &&
-            nodeListPtr[i].extra->Heat != nullptr &&
-            ! nodeListPtr[i].isSurface);
+    return (myContext->myStructure.computeHeat &&
+            myContext->nodeListPtr != nullptr &&
+            myContext->nodeListPtr[i].extra != nullptr &&
+            myContext->nodeListPtr[i].extra->Heat != nullptr &&
+            ! myContext->nodeListPtr[i].isSurface);
 }
 
 bool isHeatLinkedNode(TlinkedNode* myLink)
 {
-    return (myStructure.computeHeat &&
+    return (myContext->myStructure.computeHeat &&
             myLink != nullptr &&
             myLink->linkedExtra != nullptr &&
             myLink->linkedExtra->heatFlux != nullptr);
@@ -60,21 +58,21 @@ bool isHeatLinkedNode(TlinkedNode* myLink)
 
 double getH_timeStep(long i, double timeStep, double timeStepWater)
 {
-    return (nodeListPtr[i].H - nodeListPtr[i].oldH) / timeStepWater * timeStep + nodeListPtr[i].oldH;
+    return (myContext->nodeListPtr[i].H - myContext->nodeListPtr[i].oldH) / timeStepWater * timeStep + myContext->nodeListPtr[i].oldH;
 }
 
 double computeHeatStorage(double timeStepHeat, double timeStepWater)
 { // [J]
     double myHeatStorage = 0.;
     double myH;
-    for (long i = 1; i < myStructure.nrNodes; i++)
+    for (long i = 1; i < myContext->myStructure.nrNodes; i++)
     {
         if (timeStepHeat != NODATA && timeStepWater != NODATA)
             myH = getH_timeStep(i, timeStepHeat, timeStepWater);
         else
-            myH = nodeListPtr[i].H;
+            myH = myContext->nodeListPtr[i].H;
 
-        myHeatStorage += soilFluxes3D::getHeat(i, myH - nodeListPtr[i].z);
+        myHeatStorage += soilFluxes3D::getHeat(i, myH - myContext->nodeListPtr[i].z);
     }
     return myHeatStorage;
 }
@@ -87,34 +85,34 @@ double computeHeatStorage(double timeStepHeat, double timeStepWater)
 double sumHeatFlow(double deltaT)
 {
     double sum = 0.0;
-    for (long n = 1; n < myStructure.nrNodes; n++)
+    for (long n = 1; n < myContext->myStructure.nrNodes; n++)
     {
-        if (nodeListPtr[n].extra->Heat->Qh != 0.)
-            sum += nodeListPtr[n].extra->Heat->Qh * deltaT;
+        if (myContext->nodeListPtr[n].extra->Heat->Qh != 0.)
+            sum += myContext->nodeListPtr[n].extra->Heat->Qh * deltaT;
     }
     return (sum);
 }
 
 void computeHeatBalance(double myTimeStep, double timeStepWater)
 {
-    balanceCurrentTimeStep.sinkSourceHeat = sumHeatFlow(myTimeStep);
+    myContext->balanceCurrentTimeStep.sinkSourceHeat = sumHeatFlow(myTimeStep);
 
-    balanceCurrentTimeStep.storageHeat = computeHeatStorage(myTimeStep, timeStepWater);
+    myContext->balanceCurrentTimeStep.storageHeat = computeHeatStorage(myTimeStep, timeStepWater);
 
-    double deltaHeatStorage = balanceCurrentTimeStep.storageHeat - balancePreviousTimeStep.storageHeat;
-    balanceCurrentTimeStep.heatMBE = deltaHeatStorage - balanceCurrentTimeStep.sinkSourceHeat;
+    double deltaHeatStorage = myContext->balanceCurrentTimeStep.storageHeat - myContext->balancePreviousTimeStep.storageHeat;
+    myContext->balanceCurrentTimeStep.heatMBE = deltaHeatStorage - myContext->balanceCurrentTimeStep.sinkSourceHeat;
 
-    double referenceHeat = MAXVALUE(fabs(balanceCurrentTimeStep.sinkSourceHeat), balanceCurrentTimeStep.storageHeat * 1e-6);
-    balanceCurrentTimeStep.heatMBR = 1. - balanceCurrentTimeStep.heatMBE / referenceHeat;
+    double referenceHeat = MAXVALUE(fabs(myContext->balanceCurrentTimeStep.sinkSourceHeat), myContext->balanceCurrentTimeStep.storageHeat * 1e-6);
+    myContext->balanceCurrentTimeStep.heatMBR = 1. - myContext->balanceCurrentTimeStep.heatMBE / referenceHeat;
 }
 
 float readHeatFlux(TlinkedNode* myLink, int fluxType)
 {
     if (! isHeatLinkedNode(myLink)) return NODATA;
 
-    if (myStructure.saveHeatFluxesType == SAVE_HEATFLUXES_TOTAL && fluxType == HEATFLUX_TOTAL)
+    if (myContext->myStructure.saveHeatFluxesType == SAVE_HEATFLUXES_TOTAL && fluxType == HEATFLUX_TOTAL)
         return myLink->linkedExtra->heatFlux->fluxes[HEATFLUX_TOTAL];
-    else if (myStructure.saveHeatFluxesType == SAVE_HEATFLUXES_ALL && (fluxType == HEATFLUX_TOTAL ||
+    else if (myContext->myStructure.saveHeatFluxesType == SAVE_HEATFLUXES_ALL && (fluxType == HEATFLUX_TOTAL ||
             fluxType == HEATFLUX_DIFFUSIVE ||
             fluxType == HEATFLUX_LATENT_ISOTHERMAL ||
             fluxType == HEATFLUX_LATENT_THERMAL ||
@@ -133,14 +131,14 @@ void saveHeatFlux(TlinkedNode* myLink, int fluxType, double myValue)
 {
     if (! isHeatLinkedNode(myLink)) return;
 
-    if (myStructure.saveHeatFluxesType == SAVE_HEATFLUXES_NONE) return;
+    if (myContext->myStructure.saveHeatFluxesType == SAVE_HEATFLUXES_NONE) return;
 
     if (myLink->linkedExtra->heatFlux->fluxes[HEATFLUX_TOTAL] == NODATA)
         myLink->linkedExtra->heatFlux->fluxes[HEATFLUX_TOTAL] = float(myValue);
     else
         myLink->linkedExtra->heatFlux->fluxes[HEATFLUX_TOTAL] += float(myValue);
 
-    if (myStructure.saveHeatFluxesType == SAVE_HEATFLUXES_ALL)
+    if (myContext->myStructure.saveHeatFluxesType == SAVE_HEATFLUXES_ALL)
         myLink->linkedExtra->heatFlux->fluxes[fluxType] = float(myValue);
 }
 
@@ -155,7 +153,7 @@ double VaporThetaV(double h, double T, long i)
 {
     double theta = theta_from_sign_Psi(h, i);
     double vaporConc = VaporFromPsiTemp(h, T);
-    return (vaporConc / WATER_DENSITY * (nodeListPtr[i].Soil->Theta_s - theta));
+    return (vaporConc / WATER_DENSITY * (myContext->nodeListPtr[i].Soil->Theta_s - theta));
 }
 
 /*!
@@ -206,7 +204,7 @@ double SoilRelativeHumidity(double h, double myT)
 double IsothermalVaporConductivity(long i, double h, double myT)
 {
     double theta = theta_from_sign_Psi(h, i);
-    double Dv = SoilVaporDiffusivity(nodeListPtr[i].Soil->Theta_s, theta, myT);
+    double Dv = SoilVaporDiffusivity(myContext->nodeListPtr[i].Soil->Theta_s, theta, myT);
     double vapor = VaporFromPsiTemp(h, myT);
     return (Dv * vapor * MH2O / (R_GAS * myT));
 }
@@ -227,7 +225,7 @@ double SoilHeatCapacity(long i, double h, double T)
     heatCapacity = bulkDensity / 2.65 * HEAT_CAPACITY_MINERAL +
             theta * HEAT_CAPACITY_WATER;
 
-    if (myStructure.computeHeatVapor)
+    if (myContext->myStructure.computeHeatVapor)
         heatCapacity += thetaV * HEAT_CAPACITY_AIR;
 
     return heatCapacity;
@@ -314,12 +312,12 @@ double ThermalVaporConductivity(long i, double temperature, double h)
 
     tempCelsius = temperature - ZEROCELSIUS;
 
-    myPressure = pressureFromAltitude(nodeListPtr[i].z);
+    myPressure = pressureFromAltitude(myContext->nodeListPtr[i].z);
 
     theta = theta_from_sign_Psi(h, i);
 
 	// vapor diffusivity
-    Dv = SoilVaporDiffusivity(nodeListPtr[i].Soil->Theta_s, theta, temperature);
+    Dv = SoilVaporDiffusivity(myContext->nodeListPtr[i].Soil->Theta_s, theta, temperature);
 
 	// slope of saturation vapor pressure
     svp = saturationVaporPressure(tempCelsius);
@@ -334,8 +332,8 @@ double ThermalVaporConductivity(long i, double temperature, double h)
 	hr = myVaporPressure / svp;
 
     // enhancement factor (Cass et al. 1984)
-    satDegree = theta / nodeListPtr[i].Soil->Theta_s;
-    eta = 9.5 + 3. * satDegree - 8.5 * exp(-pow((1. + 2.6/sqrt(nodeListPtr[i].Soil->clay))*satDegree, 4));
+    satDegree = theta / myContext->nodeListPtr[i].Soil->Theta_s;
+    eta = 9.5 + 3. * satDegree - 8.5 * exp(-pow((1. + 2.6/sqrt(myContext->nodeListPtr[i].Soil->clay))*satDegree, 4));
 
     return (eta * Dv * slopesvc * hr);
 
@@ -363,7 +361,7 @@ double AirHeatConductivity(long i, double T, double h)
 
     Ka = Kda;
 
-    if (myStructure.computeWater)
+    if (myContext->myStructure.computeWater)
     {
         myLambda = latentHeatVaporization(T - ZEROCELSIUS);
 
@@ -411,7 +409,7 @@ double SoilHeatConductivity(long i, double T, double h)
 
     xw = theta_from_sign_Psi(h, i);
 
-    fw = WaterReturnFlowFactor(xw, nodeListPtr[i].Soil->clay, myTCelsiusMean + ZEROCELSIUS);
+    fw = WaterReturnFlowFactor(xw, myContext->nodeListPtr[i].Soil->clay, myTCelsiusMean + ZEROCELSIUS);
 	Kf = Ka + fw * (Kw - Ka);
 
 	gc = 1. - 2. * ga;
@@ -420,8 +418,8 @@ double SoilHeatConductivity(long i, double T, double h)
 	ew = (2. / (1 + (Kw / Kf - 1) * ga) + 1 / (1 + (Kw / Kf - 1) * gc)) / 3.;
     es = (2. / (1 + (KH_mineral / Kf - 1) * ga) + 1 / (1 + (KH_mineral / Kf - 1) * gc)) / 3.;
 
-	xs = 1. - nodeListPtr[i].Soil->Theta_s;
-	xa = nodeListPtr[i].Soil->Theta_s - xw;
+	xs = 1. - myContext->nodeListPtr[i].Soil->Theta_s;
+	xa = myContext->nodeListPtr[i].Soil->Theta_s - xw;
 
     myConductivity = (xw * ew * Kw + xa * ea * Ka + xs * es * KH_mineral) / (ew * xw + ea * xa + es * xs);
     return myConductivity;
@@ -441,26 +439,26 @@ double ThermalLiquidFlux(long i, TlinkedNode *myLink, int myProcess, double time
 
     // temperatures (K) and water potential (m)
     double tavg, tavgLink, havg, havgLink;
-    if (myProcess == PROCESS_WATER && myStructure.computeWater)
+    if (myProcess == PROCESS_WATER && myContext->myStructure.computeWater)
     {
         tavg = getTMean(i);
         tavgLink = getTMean(j);
-        havg = nodeListPtr[i].H - nodeListPtr[i].z;
-        havgLink = nodeListPtr[j].H - nodeListPtr[j].z;
+        havg = myContext->nodeListPtr[i].H - myContext->nodeListPtr[i].z;
+        havgLink = myContext->nodeListPtr[j].H - myContext->nodeListPtr[j].z;
     }
-    else if (myProcess == PROCESS_HEAT && myStructure.computeHeat)
+    else if (myProcess == PROCESS_HEAT && myContext->myStructure.computeHeat)
     {
-        tavg = nodeListPtr[i].extra->Heat->T;
-        tavgLink = nodeListPtr[j].extra->Heat->T;
-        havg = arithmeticMean(getH_timeStep(i, timeStep, timeStepWater), nodeListPtr[i].oldH) - nodeListPtr[i].z;
-        havgLink = arithmeticMean(getH_timeStep(j, timeStep, timeStepWater), nodeListPtr[j].oldH) - nodeListPtr[j].z;
+        tavg = myContext->nodeListPtr[i].extra->Heat->T;
+        tavgLink = myContext->nodeListPtr[j].extra->Heat->T;
+        havg = arithmeticMean(getH_timeStep(i, timeStep, timeStepWater), myContext->nodeListPtr[i].oldH) - myContext->nodeListPtr[i].z;
+        havgLink = arithmeticMean(getH_timeStep(j, timeStep, timeStepWater), myContext->nodeListPtr[j].oldH) - myContext->nodeListPtr[j].z;
     }
     else
         return NODATA;
 
     // m2 K-1 s-1
-    double Klt = ThermalLiquidConductivity(tavg - ZEROCELSIUS, havg, nodeListPtr[i].k);
-    double KltLink = ThermalLiquidConductivity(tavgLink - ZEROCELSIUS, havgLink, nodeListPtr[j].k);
+    double Klt = ThermalLiquidConductivity(tavg - ZEROCELSIUS, havg, myContext->nodeListPtr[i].k);
+    double KltLink = ThermalLiquidConductivity(tavgLink - ZEROCELSIUS, havgLink, myContext->nodeListPtr[j].k);
     double meanKlt = computeMean(Klt, KltLink);
 
     // m s-1
@@ -486,21 +484,21 @@ double ThermalVaporFlux(long i, TlinkedNode *myLink, int myProcess, double timeS
 
     // temperatures (K) and water potential (m)
     double tavg, tavgLink, havg, havgLink;
-    if (myProcess == PROCESS_WATER && myStructure.computeWater)
+    if (myProcess == PROCESS_WATER && myContext->myStructure.computeWater)
     {
         tavg = getTMean(i);
         tavgLink = getTMean(j);
-        havg = nodeListPtr[i].H - nodeListPtr[i].z;
-        havgLink = nodeListPtr[j].H - nodeListPtr[j].z;
+        havg = myContext->nodeListPtr[i].H - myContext->nodeListPtr[i].z;
+        havgLink = myContext->nodeListPtr[j].H - myContext->nodeListPtr[j].z;
     }
     else
     {
-        if (myProcess == PROCESS_HEAT && myStructure.computeHeat)
+        if (myProcess == PROCESS_HEAT && myContext->myStructure.computeHeat)
         {
-            tavg = nodeListPtr[i].extra->Heat->T;
-            tavgLink = nodeListPtr[j].extra->Heat->T;
-            havg = arithmeticMean(getH_timeStep(i, timeStep, timeStepWater), nodeListPtr[i].oldH) - nodeListPtr[i].z;
-            havgLink = arithmeticMean(getH_timeStep(j, timeStep, timeStepWater), nodeListPtr[j].oldH) - nodeListPtr[j].z;
+            tavg = myContext->nodeListPtr[i].extra->Heat->T;
+            tavgLink = myContext->nodeListPtr[j].extra->Heat->T;
+            havg = arithmeticMean(getH_timeStep(i, timeStep, timeStepWater), myContext->nodeListPtr[i].oldH) - myContext->nodeListPtr[i].z;
+            havgLink = arithmeticMean(getH_timeStep(j, timeStep, timeStepWater), myContext->nodeListPtr[j].oldH) - myContext->nodeListPtr[j].z;
         }
         else
             return NODATA;
@@ -537,11 +535,11 @@ double IsothermalVaporFlux(long i, TlinkedNode *myLink, double timeStep, double
 
     long j = (*myLink).index;
 
-    havg = arithmeticMean(getH_timeStep(i, timeStep, timeStepWater), nodeListPtr[i].oldH) - nodeListPtr[i].z;
-    havglink = arithmeticMean(getH_timeStep(j, timeStep, timeStepWater), nodeListPtr[j].oldH) - nodeListPtr[j].z;
+    havg = arithmeticMean(getH_timeStep(i, timeStep, timeStepWater), myContext->nodeListPtr[i].oldH) - myContext->nodeListPtr[i].z;
+    havglink = arithmeticMean(getH_timeStep(j, timeStep, timeStepWater), myContext->nodeListPtr[j].oldH) - myContext->nodeListPtr[j].z;
 
-    Kvi = IsothermalVaporConductivity(i, havg, nodeListPtr[i].extra->Heat->T);
-    KviLink = IsothermalVaporConductivity(j, havglink, nodeListPtr[j].extra->Heat->T);
+    Kvi = IsothermalVaporConductivity(i, havg, myContext->nodeListPtr[i].extra->Heat->T);
+    KviLink = IsothermalVaporConductivity(j, havglink, myContext->nodeListPtr[j].extra->Heat->T);
     myKvi = computeMean(Kvi, KviLink);
 
     psi = havg * GRAVITY;
@@ -567,8 +565,8 @@ double IsothermalLatentHeatFlux(long i, TlinkedNode *myLink, double timeStep, do
 
     long j = (*myLink).index;
 
-    lambda = latentHeatVaporization(nodeListPtr[i].extra->Heat->T - ZEROCELSIUS);
-    lambdaLink = latentHeatVaporization(nodeListPtr[j].extra->Heat->T - ZEROCELSIUS);
+    lambda = latentHeatVaporization(myContext->nodeListPtr[i].extra->Heat->T - ZEROCELSIUS);
+    lambdaLink = latentHeatVaporization(myContext->nodeListPtr[j].extra->Heat->T - ZEROCELSIUS);
     avgLambda = arithmeticMean(lambda, lambdaLink);
 
     myLatentFlux = avgLambda * IsothermalVaporFlux(i, myLink, timeStep, timeStepWater);
@@ -591,22 +589,22 @@ double AdvectiveFlux(long i, TlinkedNode *myLink)
     liqWaterFlux = (*myLink).linkedExtra->heatFlux->waterFlux;
 
     if (liqWaterFlux < 0.)
-        TliqAdv = nodeListPtr[i].extra->Heat->T;
+        TliqAdv = myContext->nodeListPtr[i].extra->Heat->T;
     else
-        TliqAdv = nodeListPtr[myLink->index].extra->Heat->T;
+        TliqAdv = myContext->nodeListPtr[myLink->index].extra->Heat->T;
 
-    fluxCourant += HEAT_CAPACITY_WATER * liqWaterFlux;
-    advection = fluxCourant * TliqAdv;
+    myContext->fluxCourant += HEAT_CAPACITY_WATER * liqWaterFlux;
+    advection = myContext->fluxCourant * TliqAdv;
 
     vapWaterFlux = (*myLink).linkedExtra->heatFlux->vaporFlux;
 
     if (vapWaterFlux < 0.)
-        TvapAdv = nodeListPtr[i].extra->Heat->T;
+        TvapAdv = myContext->nodeListPtr[i].extra->Heat->T;
     else
-        TvapAdv = nodeListPtr[myLink->index].extra->Heat->T;
+        TvapAdv = myContext->nodeListPtr[myLink->index].extra->Heat->T;
 
     double fluxCourantVap = HEAT_CAPACITY_WATER_VAPOR * vapWaterFlux;
-    fluxCourant += fluxCourantVap;
+    myContext->fluxCourant += fluxCourantVap;
     advection += fluxCourantVap * TvapAdv;
 
     return (advection);
@@ -627,11 +625,11 @@ double Conduction(long i, TlinkedNode *myLink, double timeStep, double timeStepW
 
     myH = getH_timeStep(i, timeStep, timeStepWater);
     myHLink = getH_timeStep(j, timeStep, timeStepWater);
-    hAvg = arithmeticMean(myH, nodeListPtr[i].oldH) - nodeListPtr[i].z;
-    hLinkAvg = arithmeticMean(myHLink, nodeListPtr[j].oldH) - nodeListPtr[j].z;
+    hAvg = arithmeticMean(myH, myContext->nodeListPtr[i].oldH) - myContext->nodeListPtr[i].z;
+    hLinkAvg = arithmeticMean(myHLink, myContext->nodeListPtr[j].oldH) - myContext->nodeListPtr[j].z;
 
-    myConductivity = SoilHeatConductivity(i, nodeListPtr[i].extra->Heat->T, hAvg);
-    linkConductivity = SoilHeatConductivity(j, nodeListPtr[j].extra->Heat->T, hLinkAvg);
+    myConductivity = SoilHeatConductivity(i, myContext->nodeListPtr[i].extra->Heat->T, hAvg);
+    linkConductivity = SoilHeatConductivity(j, myContext->nodeListPtr[j].extra->Heat->T, hLinkAvg);
     meanKh = computeMean(myConductivity, linkConductivity);
 
     return (zeta * meanKh);
@@ -650,33 +648,33 @@ bool computeHeatFlux(long i, int myMatrixIndex, TlinkedNode *myLink, double time
 
     myAdvectiveFlux = 0.;
     myLatentFlux = 0.;
-    fluxCourant = 0.;
+    myContext->fluxCourant = 0.;
 
     myConduction = Conduction(i, myLink, timeStep, timeStepWater);
-    if (myStructure.computeWater)
+    if (myContext->myStructure.computeWater)
     {
-        if (myStructure.computeHeatVapor)
+        if (myContext->myStructure.computeHeatVapor)
         {
             myLatentFlux = IsothermalLatentHeatFlux(i, myLink, timeStep, timeStepWater);
             saveHeatFlux(myLink, HEATFLUX_LATENT_ISOTHERMAL, myLatentFlux);
         }
 
-        if (myStructure.computeHeatAdvection)
+        if (myContext->myStructure.computeHeatAdvection)
         {
             myAdvectiveFlux = AdvectiveFlux(i, myLink);
             saveHeatFlux(myLink, HEATFLUX_ADVECTIVE, myAdvectiveFlux);
         }
     }
 
-    A[i][myMatrixIndex].index = myLinkIndex;
-    A[i][myMatrixIndex].val = myConduction;
+    myContext->A[i][myMatrixIndex].index = myLinkIndex;
+    myContext->A[i][myMatrixIndex].val = myConduction;
 
-    invariantFlux[i] += myAdvectiveFlux + myLatentFlux;
+    myContext->invariantFlux[i] += myAdvectiveFlux + myLatentFlux;
 
-    if (fluxCourant != 0)
+    if (myContext->fluxCourant != 0)
     {
         nodeDistance = distance(i, myLinkIndex);
-        CourantHeat = MAXVALUE(CourantHeat, fabs(fluxCourant) * timeStep / (C[i] * nodeDistance));
+        myContext->CourantHeat = MAXVALUE(myContext->CourantHeat, fabs(myContext->fluxCourant) * timeStep / (myContext->C[i] * nodeDistance));
     }
 
     return (true);
@@ -702,7 +700,7 @@ void saveNodeWaterFlux(long i, TlinkedNode *link, double timeStepHeat, double ti
     if (matrixValue != INDEX_ERROR)
         isothLiqFlux = matrixValue * (avgH - avgHLink);
 
-    if (!nodeListPtr[i].isSurface && ! nodeListPtr[link->index].isSurface)
+    if (!myContext->nodeListPtr[i].isSurface && ! myContext->nodeListPtr[link->index].isSurface)
     {
         // compute isothermal vapor flux and subtract from total water flux
         // (because fluxLiquid is computed from A matrix which include isothermal vapor flux component)
@@ -721,7 +719,7 @@ void saveNodeWaterFlux(long i, TlinkedNode *link, double timeStepHeat, double ti
     link->linkedExtra->heatFlux->waterFlux = float(fluxLiquid);
     link->linkedExtra->heatFlux->vaporFlux = float(fluxVapor);
 
-    if (myStructure.saveHeatFluxesType == SAVE_HEATFLUXES_ALL)
+    if (myContext->myStructure.saveHeatFluxesType == SAVE_HEATFLUXES_ALL)
     {
         link->linkedExtra->heatFlux->fluxes[WATERFLUX_LIQUID_ISOTHERMAL] = float(isothLiqFlux);
         link->linkedExtra->heatFlux->fluxes[WATERFLUX_LIQUID_THERMAL] = float(thermLiqFlux);
@@ -734,20 +732,20 @@ void saveNodeWaterFlux(long i, TlinkedNode *link, double timeStepHeat, double ti
 
 void saveWaterFluxes(double dtHeat, double dtWater)
 {
-    for (long i = 0; i < myStructure.nrNodes; i++)
+    for (long i = 0; i < myContext->myStructure.nrNodes; i++)
         {
-            if (&nodeListPtr[i].up != nullptr)
-                if (nodeListPtr[i].up.linkedExtra != nullptr)
-                    saveNodeWaterFlux(i, &nodeListPtr[i].up, dtHeat, dtWater);
+            if (&myContext->nodeListPtr[i].up != nullptr)
+                if (myContext->nodeListPtr[i].up.linkedExtra != nullptr)
+                    saveNodeWaterFlux(i, &myContext->nodeListPtr[i].up, dtHeat, dtWater);
 
-            if (&nodeListPtr[i].down != nullptr)
-                if (nodeListPtr[i].down.linkedExtra != nullptr)
-                    saveNodeWaterFlux(i, &nodeListPtr[i].down, dtHeat, dtWater);
+            if (&myContext->nodeListPtr[i].down != nullptr)
+                if (myContext->nodeListPtr[i].down.linkedExtra != nullptr)
+                    saveNodeWaterFlux(i, &myContext->nodeListPtr[i].down, dtHeat, dtWater);
 
-            for (short j = 0; j < myStructure.nrLateralLinks; j++)
-                if (&nodeListPtr[i].lateral[j] != nullptr)
-                    if (nodeListPtr[i].lateral[j].linkedExtra != nullptr)
-                        saveNodeWaterFlux(i, &nodeListPtr[i].lateral[j], dtHeat, dtWater);
+            for (short j = 0; j < myContext->myStructure.nrLateralLinks; j++)
+                if (&myContext->nodeListPtr[i].lateral[j] != nullptr)
+                    if (myContext->nodeListPtr[i].lateral[j].linkedExtra != nullptr)
+                        saveNodeWaterFlux(i, &myContext->nodeListPtr[i].lateral[j], dtHeat, dtWater);
 
         }
 }
@@ -761,22 +759,22 @@ void saveNodeHeatFlux(long myIndex, TlinkedNode *myLink, double timeStep, double
     double myDiffHeat, myA;
 
     int j = 1;
-    while ((j < myStructure.maxNrColumns) && (A[myIndex][j].index != NOLINK) && (A[myIndex][j].index != myLinkIndex)) j++;
+    while ((j < myContext->myStructure.maxNrColumns) && (myContext->A[myIndex][j].index != NOLINK) && (myContext->A[myIndex][j].index != myLinkIndex)) j++;
 
-    if (A[myIndex][j].index == myLinkIndex)
+    if (myContext->A[myIndex][j].index == myLinkIndex)
     {
-        myA = (A[myIndex][j].val * A[myIndex][0].val);
-        myDiffHeat = myA * (nodeListPtr[myIndex].extra->Heat->T - nodeListPtr[myLinkIndex].extra->Heat->T) * myParameters.heatWeightingFactor;
-        myDiffHeat += myA * (nodeListPtr[myIndex].extra->Heat->oldT - nodeListPtr[myLinkIndex].extra->Heat->oldT) * (1. - myParameters.heatWeightingFactor);
+        myA = (myContext->A[myIndex][j].val * myContext->A[myIndex][0].val);
+        myDiffHeat = myA * (myContext->nodeListPtr[myIndex].extra->Heat->T - myContext->nodeListPtr[myLinkIndex].extra->Heat->T) * myContext->myParameters.heatWeightingFactor;
+        myDiffHeat += myA * (myContext->nodeListPtr[myIndex].extra->Heat->oldT - myContext->nodeListPtr[myLinkIndex].extra->Heat->oldT) * (1. - myContext->myParameters.heatWeightingFactor);
 
         // when saving separate fluxes, thermal latent heat has to be subtracted from diffusive,
         // where is incorporated (see AirHeatConductivity)
-        if (myStructure.saveHeatFluxesType == SAVE_HEATFLUXES_ALL)
+        if (myContext->myStructure.saveHeatFluxesType == SAVE_HEATFLUXES_ALL)
         {
-            if (myStructure.computeHeatVapor)
+            if (myContext->myStructure.computeHeatVapor)
             {
                 double thermalLatentFlux = ThermalVaporFlux(myIndex, myLink, PROCESS_HEAT, timeStep, timeStepWater);
-                thermalLatentFlux *= latentHeatVaporization(nodeListPtr[myIndex].extra->Heat->T - ZEROCELSIUS);
+                thermalLatentFlux *= latentHeatVaporization(myContext->nodeListPtr[myIndex].extra->Heat->T - ZEROCELSIUS);
                 saveHeatFlux(myLink, HEATFLUX_LATENT_THERMAL, thermalLatentFlux);
                 saveHeatFlux(myLink, HEATFLUX_DIFFUSIVE, myDiffHeat - thermalLatentFlux);
             }
@@ -793,102 +791,102 @@ void saveNodeHeatFlux(long myIndex, TlinkedNode *myLink, double timeStep, double
 
 void updateHeatFluxes(double timeStep, double timeStepWater)
 {
-    if (myStructure.saveHeatFluxesType == SAVE_HEATFLUXES_NONE) return;
+    if (myContext->myStructure.saveHeatFluxesType == SAVE_HEATFLUXES_NONE) return;
 
-    for (long i = 1; i < myStructure.nrNodes; i++)
+    for (long i = 1; i < myContext->myStructure.nrNodes; i++)
     {
-        if (nodeListPtr[i].up.index != NOLINK)
-            if (nodeListPtr[i].up.linkedExtra->heatFlux != nullptr)
-                saveNodeHeatFlux(i, &(nodeListPtr[i].up), timeStep, timeStepWater);
-
-        if (nodeListPtr[i].down.index != NOLINK)
-            if (nodeListPtr[i].down.linkedExtra->heatFlux != nullptr)
-                saveNodeHeatFlux(i, &(nodeListPtr[i].down), timeStep, timeStepWater);
-
-        for (short j = 0; j < myStructure.nrLateralLinks; j++)
-            if (nodeListPtr[i].lateral[j].index != NOLINK)
-                if (nodeListPtr[i].lateral[j].linkedExtra->heatFlux != nullptr)
-                    saveNodeHeatFlux(i, &(nodeListPtr[i].lateral[j]), timeStep, timeStepWater);
+        if (myContext->nodeListPtr[i].up.index != NOLINK)
+            if (myContext->nodeListPtr[i].up.linkedExtra->heatFlux != nullptr)
+                saveNodeHeatFlux(i, &(myContext->nodeListPtr[i].up), timeStep, timeStepWater);
+
+        if (myContext->nodeListPtr[i].down.index != NOLINK)
+            if (myContext->nodeListPtr[i].down.linkedExtra->heatFlux != nullptr)
+                saveNodeHeatFlux(i, &(myContext->nodeListPtr[i].down), timeStep, timeStepWater);
+
+        for (short j = 0; j < myContext->myStructure.nrLateralLinks; j++)
+            if (myContext->nodeListPtr[i].lateral[j].index != NOLINK)
+                if (myContext->nodeListPtr[i].lateral[j].linkedExtra->heatFlux != nullptr)
+                    saveNodeHeatFlux(i, &(myContext->nodeListPtr[i].lateral[j]), timeStep, timeStepWater);
     }
 }
 
 void updateBalanceHeat()
 {
-    balancePreviousTimeStep.storageHeat = balanceCurrentTimeStep.storageHeat;
-    balancePreviousTimeStep.sinkSourceHeat = balanceCurrentTimeStep.sinkSourceHeat;
-    balanceCurrentPeriod.sinkSourceHeat += balanceCurrentTimeStep.sinkSourceHeat;
+    myContext->balancePreviousTimeStep.storageHeat = myContext->balanceCurrentTimeStep.storageHeat;
+    myContext->balancePreviousTimeStep.sinkSourceHeat = myContext->balanceCurrentTimeStep.sinkSourceHeat;
+    myContext->balanceCurrentPeriod.sinkSourceHeat += myContext->balanceCurrentTimeStep.sinkSourceHeat;
 }
 
 bool heatBalance(double timeStep, double timeStepWater)
 {
     computeHeatBalance(timeStep, timeStepWater);
-    return ((fabs(1.-balanceCurrentTimeStep.heatMBR) < myParameters.MBRThreshold));
+    return ((fabs(1.-myContext->balanceCurrentTimeStep.heatMBR) < myContext->myParameters.MBRThreshold));
 }
 
 void initializeBalanceHeat()
 {
-     balanceCurrentTimeStep.sinkSourceHeat = 0.;
-     balancePreviousTimeStep.sinkSourceHeat = 0.;
-     balanceCurrentPeriod.sinkSourceHeat = 0.;
-     balanceWholePeriod.sinkSourceHeat = 0.;
+     myContext->balanceCurrentTimeStep.sinkSourceHeat = 0.;
+     myContext->balancePreviousTimeStep.sinkSourceHeat = 0.;
+     myContext->balanceCurrentPeriod.sinkSourceHeat = 0.;
+     myContext->balanceWholePeriod.sinkSourceHeat = 0.;
 
-     balanceCurrentTimeStep.heatMBE = 0.;
-     balanceCurrentPeriod.heatMBE = 0.;
-     balanceWholePeriod.waterMBE = 0.;
+     myContext->balanceCurrentTimeStep.heatMBE = 0.;
+     myContext->balanceCurrentPeriod.heatMBE = 0.;
+     myContext->balanceWholePeriod.waterMBE = 0.;
 
-     balanceCurrentTimeStep.heatMBR = 1.;
-     balanceCurrentPeriod.heatMBR = 1.;
-     balanceWholePeriod.heatMBR = 1.;
+     myContext->balanceCurrentTimeStep.heatMBR = 1.;
+     myContext->balanceCurrentPeriod.heatMBR = 1.;
+     myContext->balanceWholePeriod.heatMBR = 1.;
 
-     balanceWholePeriod.storageHeat = computeHeatStorage(NODATA, NODATA);
-     balanceCurrentTimeStep.storageHeat = balanceWholePeriod.storageHeat;
-     balancePreviousTimeStep.storageHeat = balanceWholePeriod.storageHeat;
-     balanceCurrentPeriod.storageHeat = balanceWholePeriod.storageHeat;
+     myContext->balanceWholePeriod.storageHeat = computeHeatStorage(NODATA, NODATA);
+     myContext->balanceCurrentTimeStep.storageHeat = myContext->balanceWholePeriod.storageHeat;
+     myContext->balancePreviousTimeStep.storageHeat = myContext->balanceWholePeriod.storageHeat;
+     myContext->balanceCurrentPeriod.storageHeat = myContext->balanceWholePeriod.storageHeat;
 }
 
 void updateBalanceHeatWholePeriod()
 {
     /*! update the flows in the balance (balanceWholePeriod) */
-    balanceWholePeriod.sinkSourceHeat  += balanceCurrentPeriod.sinkSourceHeat;
+    myContext->balanceWholePeriod.sinkSourceHeat  += myContext->balanceCurrentPeriod.sinkSourceHeat;
 
-    double deltaStoragePeriod = balanceCurrentTimeStep.storageHeat - balanceCurrentPeriod.storageHeat;
-    double deltaStorageHistorical = balanceCurrentTimeStep.storageHeat - balanceWholePeriod.storageHeat;
+    double deltaStoragePeriod = myContext->balanceCurrentTimeStep.storageHeat - myContext->balanceCurrentPeriod.storageHeat;
+    double deltaStorageHistorical = myContext->balanceCurrentTimeStep.storageHeat - myContext->balanceWholePeriod.storageHeat;
 
     /*! compute MBE and MBR */
-    balanceCurrentPeriod.heatMBE = deltaStoragePeriod - balanceCurrentPeriod.sinkSourceHeat;
-    balanceWholePeriod.heatMBE = deltaStorageHistorical - balanceWholePeriod.sinkSourceHeat;
-    if ((balanceWholePeriod.storageHeat == 0.) && (balanceWholePeriod.sinkSourceHeat == 0.)) balanceWholePeriod.heatMBR = 1.;
-    else if (balanceCurrentTimeStep.storageHeat > fabs(balanceWholePeriod.sinkSourceHeat))
-        balanceWholePeriod.heatMBR = balanceCurrentTimeStep.storageHeat / (balanceWholePeriod.storageHeat + balanceWholePeriod.sinkSourceHeat);
+    myContext->balanceCurrentPeriod.heatMBE = deltaStoragePeriod - myContext->balanceCurrentPeriod.sinkSourceHeat;
+    myContext->balanceWholePeriod.heatMBE = deltaStorageHistorical - myContext->balanceWholePeriod.sinkSourceHeat;
+    if ((myContext->balanceWholePeriod.storageHeat == 0.) && (myContext->balanceWholePeriod.sinkSourceHeat == 0.)) myContext->balanceWholePeriod.heatMBR = 1.;
+    else if (myContext->balanceCurrentTimeStep.storageHeat > fabs(myContext->balanceWholePeriod.sinkSourceHeat))
+        myContext->balanceWholePeriod.heatMBR = myContext->balanceCurrentTimeStep.storageHeat / (myContext->balanceWholePeriod.storageHeat + myContext->balanceWholePeriod.sinkSourceHeat);
     else
-        balanceWholePeriod.heatMBR = deltaStorageHistorical / balanceWholePeriod.sinkSourceHeat;
+        myContext->balanceWholePeriod.heatMBR = deltaStorageHistorical / myContext->balanceWholePeriod.sinkSourceHeat;
 
     /*! update storageWater in balanceCurrentPeriod */
-    balanceCurrentPeriod.storageHeat = balanceCurrentTimeStep.storageHeat;
+    myContext->balanceCurrentPeriod.storageHeat = myContext->balanceCurrentTimeStep.storageHeat;
 }
 
 void restoreHeat()
 {
-    for (long i = 1; i < myStructure.nrNodes; i++)
-        nodeListPtr[i].extra->Heat->T = nodeListPtr[i].extra->Heat->oldT;
+    for (long i = 1; i < myContext->myStructure.nrNodes; i++)
+        myContext->nodeListPtr[i].extra->Heat->T = myContext->nodeListPtr[i].extra->Heat->oldT;
 }
 
 void initializeHeatFluxes(bool initHeat, bool initWater)
 {
-    for (long n = 0; n < myStructure.nrNodes; n++)
+    for (long n = 0; n < myContext->myStructure.nrNodes; n++)
     {
-        initializeNodeHeatFlux(nodeListPtr[n].up.linkedExtra, initHeat, initWater);
-        initializeNodeHeatFlux(nodeListPtr[n].down.linkedExtra, initHeat, initWater);
-        for (short i = 1; i < myStructure.nrLateralLinks; i++)
-           initializeNodeHeatFlux(nodeListPtr[n].lateral[i].linkedExtra, initHeat, initWater);
+        initializeNodeHeatFlux(myContext->nodeListPtr[n].up.linkedExtra, initHeat, initWater);
+        initializeNodeHeatFlux(myContext->nodeListPtr[n].down.linkedExtra, initHeat, initWater);
+        for (short i = 1; i < myContext->myStructure.nrLateralLinks; i++)
+           initializeNodeHeatFlux(myContext->nodeListPtr[n].lateral[i].linkedExtra, initHeat, initWater);
     }
 }
 
 double computeMaximumDeltaT()
 {
     double maxDeltaT = 0.;
-    for (long i = 1; i < myStructure.nrNodes; i++)
-        maxDeltaT = MAXVALUE(maxDeltaT, fabs(nodeListPtr[i].extra->Heat->T - nodeListPtr[i].extra->Heat->oldT));
+    for (long i = 1; i < myContext->myStructure.nrNodes; i++)
+        maxDeltaT = MAXVALUE(maxDeltaT, fabs(myContext->nodeListPtr[i].extra->Heat->T - myContext->nodeListPtr[i].extra->Heat->oldT));
 
     return maxDeltaT;
 }
@@ -906,95 +904,95 @@ bool HeatComputation(double timeStep, double timeStepWater)
     double myH;
 
     initializeHeatFluxes(true, false);
-    CourantHeat = 0.;
+    myContext->CourantHeat = 0.;
 
-    for (i = 1; i < myStructure.nrNodes; i++)
+    for (i = 1; i < myContext->myStructure.nrNodes; i++)
     {
-        A[i][0].index = i;
-        X[i] = nodeListPtr[i].extra->Heat->T;
-        nodeListPtr[i].extra->Heat->oldT = nodeListPtr[i].extra->Heat->T;
+        myContext->A[i][0].index = i;
+        myContext->X[i] = myContext->nodeListPtr[i].extra->Heat->T;
+        myContext->nodeListPtr[i].extra->Heat->oldT = myContext->nodeListPtr[i].extra->Heat->T;
 
         myH = getH_timeStep(i, timeStep, timeStepWater);
-        avgh = arithmeticMean(nodeListPtr[i].oldH, myH) - nodeListPtr[i].z;
-        C[i] = SoilHeatCapacity(i, avgh, nodeListPtr[i].extra->Heat->T) * nodeListPtr[i].volume_area;
+        avgh = arithmeticMean(myContext->nodeListPtr[i].oldH, myH) - myContext->nodeListPtr[i].z;
+        myContext->C[i] = SoilHeatCapacity(i, avgh, myContext->nodeListPtr[i].extra->Heat->T) * myContext->nodeListPtr[i].volume_area;
     }
 
-    for (i = 1; i < myStructure.nrNodes; i++)
+    for (i = 1; i < myContext->myStructure.nrNodes; i++)
     {
-        invariantFlux[i] = 0.;
+        myContext->invariantFlux[i] = 0.;
 
         myH = getH_timeStep(i, timeStep, timeStepWater);
 
         // compute heat capacity temporal variation
         // due to changes in water and vapor
-        dtheta = theta_from_sign_Psi(myH - nodeListPtr[i].z, i) -
-                theta_from_sign_Psi(nodeListPtr[i].oldH - nodeListPtr[i].z, i);
+        dtheta = theta_from_sign_Psi(myH - myContext->nodeListPtr[i].z, i) -
+                theta_from_sign_Psi(myContext->nodeListPtr[i].oldH - myContext->nodeListPtr[i].z, i);
 
-        heatCapacityVar = dtheta * HEAT_CAPACITY_WATER * nodeListPtr[i].extra->Heat->T;
+        heatCapacityVar = dtheta * HEAT_CAPACITY_WATER * myContext->nodeListPtr[i].extra->Heat->T;
 
-        if (myStructure.computeHeatVapor)
+        if (myContext->myStructure.computeHeatVapor)
         {
-            dthetav = VaporThetaV(myH - nodeListPtr[i].z, nodeListPtr[i].extra->Heat->T, i) -
-                    VaporThetaV(nodeListPtr[i].oldH - nodeListPtr[i].z, nodeListPtr[i].extra->Heat->oldT, i);
-            heatCapacityVar += dthetav * HEAT_CAPACITY_AIR * nodeListPtr[i].extra->Heat->T;
-            heatCapacityVar += dthetav * latentHeatVaporization(nodeListPtr[i].extra->Heat->T - ZEROCELSIUS) * WATER_DENSITY;
+            dthetav = VaporThetaV(myH - myContext->nodeListPtr[i].z, myContext->nodeListPtr[i].extra->Heat->T, i) -
+                    VaporThetaV(myContext->nodeListPtr[i].oldH - myContext->nodeListPtr[i].z, myContext->nodeListPtr[i].extra->Heat->oldT, i);
+            heatCapacityVar += dthetav * HEAT_CAPACITY_AIR * myContext->nodeListPtr[i].extra->Heat->T;
+            heatCapacityVar += dthetav * latentHeatVaporization(myContext->nodeListPtr[i].extra->Heat->T - ZEROCELSIUS) * WATER_DENSITY;
         }
 
-        heatCapacityVar *= nodeListPtr[i].volume_area;
+        heatCapacityVar *= myContext->nodeListPtr[i].volume_area;
 
         j = 1;
-        if (computeHeatFlux(i, j, &(nodeListPtr[i].up), timeStep, timeStepWater)) j++;
-        for (short l = 0; l < myStructure.nrLateralLinks; l++)
-            if (computeHeatFlux(i, j, &(nodeListPtr[i].lateral[l]), timeStep, timeStepWater)) j++;
-        if (computeHeatFlux(i, j, &(nodeListPtr[i].down), timeStep, timeStepWater)) j++;
+        if (computeHeatFlux(i, j, &(myContext->nodeListPtr[i].up), timeStep, timeStepWater)) j++;
+        for (short l = 0; l < myContext->myStructure.nrLateralLinks; l++)
+            if (computeHeatFlux(i, j, &(myContext->nodeListPtr[i].lateral[l]), timeStep, timeStepWater)) j++;
+        if (computeHeatFlux(i, j, &(myContext->nodeListPtr[i].down), timeStep, timeStepWater)) j++;
 
         // closure
-        while (j < myStructure.maxNrColumns)
-            A[i][j++].index = NOLINK;
+        while (j < myContext->myStructure.maxNrColumns)
+            myContext->A[i][j++].index = NOLINK;
 
         j = 1;
         sum = 0.;
         sumFlow0 = 0;
         myDeltaTemp0 = 0;
 
-        while ((j < myStructure.maxNrColumns) && (A[i][j].index != NOLINK))
+        while ((j < myContext->myStructure.maxNrColumns) && (myContext->A[i][j].index != NOLINK))
         {
-            sum += A[i][j].val * myParameters.heatWeightingFactor;
-            myDeltaTemp0 = nodeListPtr[A[i][j].index].extra->Heat->oldT - nodeListPtr[i].extra->Heat->oldT;
-            sumFlow0 += A[i][j].val * (1. - myParameters.heatWeightingFactor) * myDeltaTemp0;
-            A[i][j++].val *= -(myParameters.heatWeightingFactor);
+            sum += myContext->A[i][j].val * myContext->myParameters.heatWeightingFactor;
+            myDeltaTemp0 = myContext->nodeListPtr[myContext->A[i][j].index].extra->Heat->oldT - myContext->nodeListPtr[i].extra->Heat->oldT;
+            sumFlow0 += myContext->A[i][j].val * (1. - myContext->myParameters.heatWeightingFactor) * myDeltaTemp0;
+            myContext->A[i][j++].val *= -(myContext->myParameters.heatWeightingFactor);
         }
 
         /*! sum of diagonal elements */
-        avgh = arithmeticMean(nodeListPtr[i].oldH, myH) - nodeListPtr[i].z;
-        A[i][0].val = SoilHeatCapacity(i, avgh, nodeListPtr[i].extra->Heat->T) * nodeListPtr[i].volume_area / timeStep + sum;
+        avgh = arithmeticMean(myContext->nodeListPtr[i].oldH, myH) - myContext->nodeListPtr[i].z;
+        myContext->A[i][0].val = SoilHeatCapacity(i, avgh, myContext->nodeListPtr[i].extra->Heat->T) * myContext->nodeListPtr[i].volume_area / timeStep + sum;
 
         /*! b vector (constant terms) */
-        b[i] = C[i] * nodeListPtr[i].extra->Heat->oldT / timeStep - heatCapacityVar / timeStep + nodeListPtr[i].extra->Heat->Qh + invariantFlux[i] + sumFlow0;
+        myContext->b[i] = myContext->C[i] * myContext->nodeListPtr[i].extra->Heat->oldT / timeStep - heatCapacityVar / timeStep + myContext->nodeListPtr[i].extra->Heat->Qh + myContext->invariantFlux[i] + sumFlow0;
 
         // preconditioning
-        if (A[i][0].val > 0)
+        if (myContext->A[i][0].val > 0)
         {
-            b[i] /= A[i][0].val;
+            myContext->b[i] /= myContext->A[i][0].val;
             j = 1;
-            while ((j < myStructure.maxNrColumns) && (A[i][j].index != NOLINK))
-                A[i][j++].val /= A[i][0].val;
+            while ((j < myContext->myStructure.maxNrColumns) && (myContext->A[i][j].index != NOLINK))
+                myContext->A[i][j++].val /= myContext->A[i][0].val;
         }
     }
 
     // avoiding oscillations (Courant number)
-    if (CourantHeat > 1.0)
-        if (timeStep > myParameters.delta_t_min)
+    if (myContext->CourantHeat > 1.0)
+        if (timeStep > myContext->myParameters.delta_t_min)
         {
             halveTimeStep();
             setForcedHalvedTime(true);
             return (false);
         }
 
-    GaussSeidelRelaxation(0, myParameters.ResidualTolerance, PROCESS_HEAT);
+    GaussSeidelRelaxation(0, myContext->myParameters.ResidualTolerance, PROCESS_HEAT);
 
-    for (i = 1; i < myStructure.nrNodes; i++)
-        nodeListPtr[i].extra->Heat->T = X[i];
+    for (i = 1; i < myContext->myStructure.nrNodes; i++)
+        myContext->nodeListPtr[i].extra->Heat->T = myContext->X[i];
 
     // avoiding oscillations (maximum temperature change allowed)
     /*double maxDeltaT = computeMaximumDeltaT();
@@ -1016,8 +1014,8 @@ bool HeatComputation(double timeStep, double timeStepWater)
     updateHeatFluxes(timeStep, timeStepWater);
 
 	// save old temperatures
-    for (long n = 1; n < myStructure.nrNodes; n++)
-        nodeListPtr[n].extra->Heat->oldT = nodeListPtr[n].extra->Heat->T;
+    for (long n = 1; n < myContext->myStructure.nrNodes; n++)
+        myContext->nodeListPtr[n].extra->Heat->oldT = myContext->nodeListPtr[n].extra->Heat->T;
 
     return (true);
 }
@@ -31,37 +31,40 @@
 
 void cleanArrays()
 {
-    /*! free matrix A */
-    if (A != nullptr)
+    /*! free matrix A (rows are views of a single buffer) */
+    if (myContext->A != nullptr)
     {
-            for (long i=0; i < myStructure.nrNodes; i++)
-            {
-                if (A[i] != nullptr)
-                    free(A[i]);
-            }
-            free(A);
-            A = nullptr;
+            if (myContext->myStructure.nrNodes > 0 && myContext->A[0] != nullptr)
+                free(myContext->A[0]);
+            free(myContext->A);
+            myContext->A = nullptr;
     }
 
+    myContext->rowStart.clear();
+    myContext->colIndex.clear();
+    myContext->colValue.clear();
+    myContext->colorStart.clear();
+    myContext->colorNodes.clear();
+
     /*! free arrays */
-    if (b != nullptr) { free(b); b = nullptr; }
-    if (C != nullptr) { free(C); C = nullptr; }
-    if (invariantFlux != nullptr) { free(invariantFlux); invariantFlux = nullptr; }
-    if (X != nullptr) { free(X); X = nullptr; }
+    if (myContext->b != nullptr) { free(myContext->b); myContext->b = nullptr; }
+    if (myContext->C != nullptr) { free(myContext->C); myContext->C = nullptr; }
+    if (myContext->invariantFlux != nullptr) { free(myContext->invariantFlux); myContext->invariantFlux = nullptr; }
+    if (myContext->X != nullptr) { free(myContext->X); myContext->X = nullptr; }
 }
 
 
 void cleanNodes()
 {
-    if (nodeListPtr != nullptr)
+    if (myContext->nodeListPtr != nullptr)
     {
-        for (long i = 0; i < myStructure.nrNodes; i++)
+        for (long i = 0; i < myContext->myStructure.nrNodes; i++)
         {
-            if (nodeListPtr[i].boundary != nullptr) free(nodeListPtr[i].boundary);
-            free(nodeListPtr[i].lateral);
+            if (myContext->nodeListPtr[i].boundary != nullptr) free(myContext->nodeListPtr[i].boundary);
+            free(myContext->nodeListPtr[i].lateral);
         }
-        free(nodeListPtr);
-        nodeListPtr = nullptr;
+        free(myContext->nodeListPtr);
+        myContext->nodeListPtr = nullptr;
     }
 }
 
@@ -78,34 +81,45 @@ int initializeArrays()
     cleanArrays();
 
     /*! matrix solver: rows */
-    A = (TmatrixElement **) calloc(myStructure.nrNodes, sizeof(TmatrixElement *));
+    myContext->A = (TmatrixElement **) calloc(myContext->myStructure.nrNodes, sizeof(TmatrixElement *));
+    if (myContext->A == nullptr)
+        return MEMORY_ERROR;
+
+    /*! matrix solver: columns (contiguous buffer) */
+    TmatrixElement* elements = (TmatrixElement *) calloc(myContext->myStructure.nrNodes * myContext->myStructure.maxNrColumns,
+                                                         sizeof(TmatrixElement));
+    if (elements == nullptr)
+    {
+        free(myContext->A);
+        myContext->A = nullptr;
+        return MEMORY_ERROR;
+    }
 
-    /*! matrix solver: columns */
-    for (i = 0; i < myStructure.nrNodes; i++)
-            A[i] = (TmatrixElement *) calloc(myStructure.maxNrColumns, sizeof(TmatrixElement));
+    for (i = 0; i < myContext->myStructure.nrNodes; i++)
+            myContext->A[i] = elements + i * myContext->myStructure.maxNrColumns;
 
     /*! initialize matrix solver */
-    for (i = 0; i < myStructure.nrNodes; i++)
-        for (j = 0; j < (myStructure.nrLateralLinks + 2); j++)
+    for (i = 0; i < myContext->myStructure.nrNodes; i++)
+        for (j = 0; j < (myContext->myStructure.nrLateralLinks + 2); j++)
         {
-            A[i][j].index   = NOLINK;
-            A[i][j].val     = 0.;
+            myContext->A[i][j].index   = NOLINK;
+            myContext->A[i][j].val     = 0.;
         }
 
-    b = (double *) calloc(myStructure.nrNodes, sizeof(double));
-    for (n = 0; n < myStructure.nrNodes; n++) b[n] = 0.;
+    myContext->b = (double *) calloc(myContext->myStructure.nrNodes, sizeof(double));
+    for (n = 0; n < myContext->myStructure.nrNodes; n++) myContext->b[n] = 0.;
 
-    X = (double *) calloc(myStructure.nrNodes, sizeof(double));
+    myContext->X = (double *) calloc(myContext->myStructure.nrNodes, sizeof(double));
 
     /*! mass diagonal matrix */
-    C = (double *) calloc(myStructure.nrNodes, sizeof(double));
-    for (n = 0; n < myStructure.nrNodes; n++) C[n] = 0.;
+    myContext->C = (double *) calloc(myContext->myStructure.nrNodes, sizeof(double));
+    for (n = 0; n < myContext->myStructure.nrNodes; n++) myContext->C[n] = 0.;
 
     /*! mass diagonal matrix */
-    invariantFlux = (double *) calloc(myStructure.nrNodes, sizeof(double));
-    for (n = 0; n < myStructure.nrNodes; n++) invariantFlux[n] = 0.;
+    myContext->invariantFlux = (double *) calloc(myContext->myStructure.nrNodes, sizeof(double));
+    for (n = 0; n < myContext->myStructure.nrNodes; n++) myContext->invariantFlux[n] = 0.;
 
-    if (A == nullptr)
+    if (myContext->A == nullptr)
         return MEMORY_ERROR;
     else
         return CRIT3D_OK;
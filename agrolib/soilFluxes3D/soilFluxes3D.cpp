@@ -30,6 +30,7 @@
 
 #include "commonConstants.h"
 #include "physics.h"
+#include "parallel.h"
 #include "header/types.h"
 #include "header/memory.h"
 #include "header/soilPhysics.h"
@@ -41,30 +42,61 @@
 #include "header/heat.h"
 #include "header/extra.h"
 
-/*! global variables */
+/*! solver state: the default context is used until a thread selects another one */
+static TCrit3DContext defaultContext;
+CONTEXT_THREAD_LOCAL TCrit3DContext* myContext = &defaultContext;
 
-TParameters myParameters;
-TCrit3DStructure myStructure;
 
-Tculvert myCulvert;
+namespace soilFluxes3D {
 
-TCrit3Dnode *nodeListPtr = nullptr;
-TmatrixElement **A = nullptr;
+int DLL_EXPORT __STDCALL test()
+{
+    return(CRIT3D_OK);
+}
 
-double *invariantFlux = nullptr;
-double *C = nullptr;
-double *X = nullptr;
-double *b = nullptr;
 
-std::vector< std::vector<Tsoil>> Soil_List;
-std::vector<Tsoil> Surface_List;
+/*!
+ * \brief createContext
+ * a new empty solver context, to be selected with setContext
+ */
+TCrit3DContext* DLL_EXPORT __STDCALL createContext()
+{
+    return new TCrit3DContext();
+}
 
 
-namespace soilFluxes3D {
+/*!
+ * \brief deleteContext
+ * clean the memory of the context and delete it (the default context is only cleaned)
+ */
+void DLL_EXPORT __STDCALL deleteContext(TCrit3DContext* context)
+{
+    if (context == nullptr) return;
 
-int DLL_EXPORT __STDCALL test()
+    TCrit3DContext* previousContext = myContext;
+    myContext = context;
+    cleanMemory();
+    myContext = (previousContext == context) ? &defaultContext : previousContext;
+
+    if (context != &defaultContext)
+        delete context;
+}
+
+
+/*!
+ * \brief setContext
+ * select the context used by the calling thread (nullptr: default context)
+ * the same context must not be used by two threads at the same time
+ */
+void DLL_EXPORT __STDCALL setContext(TCrit3DContext* context)
 {
-    return(CRIT3D_OK);
+    myContext = (context == nullptr) ? &defaultContext : context;
+}
+
+
+TCrit3DContext* DLL_EXPORT __STDCALL getContext()
+{
+    return myContext;
 }
 
 void DLL_EXPORT __STDCALL cleanMemory()
@@ -76,9 +108,9 @@ void DLL_EXPORT __STDCALL cleanMemory()
 
 void DLL_EXPORT __STDCALL initializeHeat(short myType, bool computeAdvectiveHeat, bool computeLatentHeat)
 {
-    myStructure.saveHeatFluxesType = myType;
-    myStructure.computeHeatAdvection = computeAdvectiveHeat;
-    myStructure.computeHeatVapor = computeLatentHeat;
+    myContext->myStructure.saveHeatFluxesType = myType;
+    myContext->myStructure.computeHeatAdvection = computeAdvectiveHeat;
+    myContext->myStructure.computeHeatVapor = computeLatentHeat;
 }
 
 
@@ -88,45 +120,45 @@ int DLL_EXPORT __STDCALL initialize(long nrNodes, int nrLayers, int nrLateralLin
     /*! clean the old data structures */
     cleanMemory();
 
-    myParameters.initialize();
-    myStructure.initialize();   
+    myContext->myParameters.initialize();
+    myContext->myStructure.initialize();   
 
-    myStructure.computeWater = computeWater_;
-    myStructure.computeHeat = computeHeat_;
+    myContext->myStructure.computeWater = computeWater_;
+    myContext->myStructure.computeHeat = computeHeat_;
     if (computeHeat_)
     {
-        myStructure.computeHeatVapor = true;
-        myStructure.computeHeatAdvection = true;
+        myContext->myStructure.computeHeatVapor = true;
+        myContext->myStructure.computeHeatAdvection = true;
     }
-    myStructure.computeSolutes = computeSolutes_;
+    myContext->myStructure.computeSolutes = computeSolutes_;
 
-    myStructure.nrNodes = nrNodes;
-    myStructure.nrLayers = nrLayers;
-    myStructure.nrLateralLinks = nrLateralLinks;
+    myContext->myStructure.nrNodes = nrNodes;
+    myContext->myStructure.nrLayers = nrLayers;
+    myContext->myStructure.nrLateralLinks = nrLateralLinks;
     /*! max nr columns = nr. of lateral links + 2 columns for up and down link + 1 column for diagonal */
-    myStructure.maxNrColumns = nrLateralLinks + 2 + 1;
+    myContext->myStructure.maxNrColumns = nrLateralLinks + 2 + 1;
 
     /*! build the nodes vector */
-    nodeListPtr = (TCrit3Dnode *) calloc(myStructure.nrNodes, sizeof(TCrit3Dnode));
-	for (long i = 0; i < myStructure.nrNodes; i++)
+    myContext->nodeListPtr = (TCrit3Dnode *) calloc(myContext->myStructure.nrNodes, sizeof(TCrit3Dnode));
+	for (long i = 0; i < myContext->myStructure.nrNodes; i++)
 	{
-        nodeListPtr[i].Soil = nullptr;
-        nodeListPtr[i].boundary = nullptr;
-        nodeListPtr[i].up.index = NOLINK;
-        nodeListPtr[i].down.index = NOLINK;
+        myContext->nodeListPtr[i].Soil = nullptr;
+        myContext->nodeListPtr[i].boundary = nullptr;
+        myContext->nodeListPtr[i].up.index = NOLINK;
+        myContext->nodeListPtr[i].down.index = NOLINK;
 
-        nodeListPtr[i].lateral = (TlinkedNode *) calloc(myStructure.nrLateralLinks, sizeof(TlinkedNode));
+        myContext->nodeListPtr[i].lateral = (TlinkedNode *) calloc(myContext->myStructure.nrLateralLinks, sizeof(TlinkedNode));
 
-        for (short l = 0; l < myStructure.nrLateralLinks; l++)
+        for (short l = 0; l < myContext->myStructure.nrLateralLinks; l++)
         {
-            nodeListPtr[i].lateral[l].index = NOLINK;
-            if (myStructure.computeHeat || myStructure.computeSolutes)
-                nodeListPtr[i].lateral[l].linkedExtra = new(TCrit3DLinkedNodeExtra);
+            myContext->nodeListPtr[i].lateral[l].index = NOLINK;
+            if (myContext->myStructure.computeHeat || myContext->myStructure.computeSolutes)
+                myContext->nodeListPtr[i].lateral[l].linkedExtra = new(TCrit3DLinkedNodeExtra);
         }
     }
 
     /*! build the matrix */
-    if (nodeListPtr == nullptr)
+    if (myContext->nodeListPtr == nullptr)
         return MEMORY_ERROR;
     else
         return initializeArrays();
@@ -142,33 +174,51 @@ int DLL_EXPORT __STDCALL setNumericalParameters(float minDeltaT, float maxDeltaT
 {
     if (minDeltaT < 0.1f) minDeltaT = 0.1f;
     if (minDeltaT > 3600) minDeltaT = 3600;
-    myParameters.delta_t_min = double(minDeltaT);
+    myContext->myParameters.delta_t_min = double(minDeltaT);
 
     if (maxDeltaT < 60) maxDeltaT = 60;
     if (maxDeltaT > 3600) maxDeltaT = 3600;
     if (maxDeltaT < minDeltaT) maxDeltaT = minDeltaT;
-    myParameters.delta_t_max = double(maxDeltaT);
+    myContext->myParameters.delta_t_max = double(maxDeltaT);
 
-    myParameters.current_delta_t = myParameters.delta_t_max;
+    myContext->myParameters.current_delta_t = myContext->myParameters.delta_t_max;
 
     if (maxIterationNumber < 10) maxIterationNumber = 10;
     if (maxIterationNumber > MAX_NUMBER_ITERATIONS) maxIterationNumber = MAX_NUMBER_ITERATIONS;
-    myParameters.iterazioni_max = maxIterationNumber;
+    myContext->myParameters.iterazioni_max = maxIterationNumber;
 
     if (maxApproximationsNumber < 1) maxApproximationsNumber = 1;
 
     if (maxApproximationsNumber > MAX_NUMBER_APPROXIMATIONS)
             maxApproximationsNumber = MAX_NUMBER_APPROXIMATIONS;
 
-    myParameters.maxApproximationsNumber = maxApproximationsNumber;
+    myContext->myParameters.maxApproximationsNumber = maxApproximationsNumber;
 
     if (ResidualTolerance < 4) ResidualTolerance = 4;
     if (ResidualTolerance > 16) ResidualTolerance = 16;
-    myParameters.ResidualTolerance = pow(double(10.), -ResidualTolerance);
+    myContext->myParameters.ResidualTolerance = pow(double(10.), -ResidualTolerance);
 
     if (MBRThreshold < 1) MBRThreshold = 1;
     if (MBRThreshold > 6) MBRThreshold = 6;
-    myParameters.MBRThreshold = pow(double(10.), double(-MBRThreshold));
+    myContext->myParameters.MBRThreshold = pow(double(10.), double(-MBRThreshold));
+
+    return CRIT3D_OK;
+}
+
+
+/*!
+ * \brief setSolverMethod
+ * RELAXATION (default): Gauss-Seidel with alternate direction sweeps
+ * MULTICOLOR_RELAXATION: Gauss-Seidel in multicolor order, parallel on nrThreads (<= 0: all cores)
+ * \return OK or PARAMETER_ERROR
+ */
+int DLL_EXPORT __STDCALL setSolverMethod(int solutionMethod, int nrThreads)
+{
+    if (solutionMethod != RELAXATION && solutionMethod != MULTICOLOR_RELAXATION)
+        return PARAMETER_ERROR;
+
+    myContext->myParameters.numericalSolutionMethod = solutionMethod;
+    myContext->myParameters.nrThreads = parallel::getNrThreads(nrThreads);
 
     return CRIT3D_OK;
 }
@@ -188,17 +238,20 @@ int DLL_EXPORT __STDCALL setNumericalParameters(float minDeltaT, float maxDeltaT
 int DLL_EXPORT __STDCALL setHydraulicProperties(int waterRetentionCurve,
                         int conductivityMeanType, float horizVertRatioConductivity)
 {
-    myParameters.waterRetentionCurve = waterRetentionCurve;
-    myParameters.meanType = conductivityMeanType;
+    myContext->myParameters.waterRetentionCurve = waterRetentionCurve;
+    myContext->myParameters.meanType = conductivityMeanType;
+
+    if (myContext->myParameters.useHydraulicTables)
+        setHydraulicTables(true, myContext->myParameters.hydraulicTableError);
 
     if  ((horizVertRatioConductivity >= 0.1) && (horizVertRatioConductivity <= 100))
     {
-        myParameters.k_lateral_vertical_ratio = horizVertRatioConductivity;
+        myContext->myParameters.k_lateral_vertical_ratio = horizVertRatioConductivity;
         return CRIT3D_OK;
     }
     else
     {
-        myParameters.k_lateral_vertical_ratio = 10.;
+        myContext->myParameters.k_lateral_vertical_ratio = 10.;
         return PARAMETER_ERROR;
     }
 }
@@ -219,29 +272,29 @@ int DLL_EXPORT __STDCALL setHydraulicProperties(int waterRetentionCurve,
  int DLL_EXPORT __STDCALL setNode(long myIndex, float x, float y, double z, double volume_or_area, bool isSurface,
                         bool isBoundary, int boundaryType, float slope, float boundaryArea)
  {
-    if (nodeListPtr == nullptr) return(MEMORY_ERROR);
-    if ((myIndex < 0) || (myIndex >= myStructure.nrNodes)) return(INDEX_ERROR);
+    if (myContext->nodeListPtr == nullptr) return(MEMORY_ERROR);
+    if ((myIndex < 0) || (myIndex >= myContext->myStructure.nrNodes)) return(INDEX_ERROR);
 
 	if (isBoundary)
 	{
-        nodeListPtr[myIndex].boundary = new(Tboundary);
-        initializeBoundary(nodeListPtr[myIndex].boundary, boundaryType, slope, boundaryArea);
+        myContext->nodeListPtr[myIndex].boundary = new(Tboundary);
+        initializeBoundary(myContext->nodeListPtr[myIndex].boundary, boundaryType, slope, boundaryArea);
 	}
 
-    if ((myStructure.computeHeat || myStructure.computeSolutes) && ! isSurface)
+    if ((myContext->myStructure.computeHeat || myContext->myStructure.computeSolutes) && ! isSurface)
     {
-        nodeListPtr[myIndex].extra = new(TCrit3DnodeExtra);
-        initializeExtra(nodeListPtr[myIndex].extra, myStructure.computeHeat, myStructure.computeSolutes);
+        myContext->nodeListPtr[myIndex].extra = new(TCrit3DnodeExtra);
+        initializeExtra(myContext->nodeListPtr[myIndex].extra, myContext->myStructure.computeHeat, myContext->myStructure.computeSolutes);
     }
 
-    nodeListPtr[myIndex].x = x;
-    nodeListPtr[myIndex].y = y;
-    nodeListPtr[myIndex].z = z;
-    nodeListPtr[myIndex].volume_area = volume_or_area;   /*!< area on surface elements, volume on sub-surface */
+    myContext->nodeListPtr[myIndex].x = x;
+    myContext->nodeListPtr[myIndex].y = y;
+    myContext->nodeListPtr[myIndex].z = z;
+    myContext->nodeListPtr[myIndex].volume_area = volume_or_area;   /*!< area on surface elements, volume on sub-surface */
 
-    nodeListPtr[myIndex].isSurface = isSurface;
+    myContext->nodeListPtr[myIndex].isSurface = isSurface;
 
-    nodeListPtr[myIndex].waterSinkSource = 0.;
+    myContext->nodeListPtr[myIndex].waterSinkSource = 0.;
 
     return CRIT3D_OK;
  }
@@ -250,50 +303,54 @@ int DLL_EXPORT __STDCALL setHydraulicProperties(int waterRetentionCurve,
  int DLL_EXPORT __STDCALL setNodeLink(long n, long linkIndex, short direction, float interfaceArea)
  {
     /*! error check */
-    if (nodeListPtr == nullptr) return MEMORY_ERROR;
+    if (myContext->nodeListPtr == nullptr) return MEMORY_ERROR;
 
-    if ((n < 0) || (n >= myStructure.nrNodes) || (linkIndex < 0) || (linkIndex >= myStructure.nrNodes))
+    if ((n < 0) || (n >= myContext->myStructure.nrNodes) || (linkIndex < 0) || (linkIndex >= myContext->myStructure.nrNodes))
         return INDEX_ERROR;
 
+    // the multicolor ordering depends on the links
+    myContext->colorStart.clear();
+    myContext->colorNodes.clear();
+
     short j;
     switch (direction)
     {
         case UP :
-                    nodeListPtr[n].up.index = linkIndex;
-                    nodeListPtr[n].up.area = interfaceArea;
-                    nodeListPtr[n].up.sumFlow = 0;
+                    myContext->nodeListPtr[n].up.index = linkIndex;
+                    myContext->nodeListPtr[n].up.area = interfaceArea;
+                    myContext->nodeListPtr[n].up.sumFlow = 0;
 
-                    if (myStructure.computeHeat || myStructure.computeSolutes)
+                    if (myContext->myStructure.computeHeat || myContext->myStructure.computeSolutes)
                     {
-                        nodeListPtr[n].up.linkedExtra = new(TCrit3DLinkedNodeExtra);
-                        initializeLinkExtra(nodeListPtr[n].up.linkedExtra, myStructure.computeHeat, myStructure.computeSolutes);
+                        myContext->nodeListPtr[n].up.linkedExtra = new(TCrit3DLinkedNodeExtra);
+                        initializeLinkExtra(myContext->nodeListPtr[n].up.linkedExtra, myContext->myStructure.computeHeat, myContext->myStructure.computeSolutes);
                     }
 
                     break;
         case DOWN :
-                    nodeListPtr[n].down.index = linkIndex;
-                    nodeListPtr[n].down.area = interfaceArea;
-                    nodeListPtr[n].down.sumFlow = 0;
+                    myContext->nodeListPtr[n].down.index = linkIndex;
+                    myContext->nodeListPtr[n].down.area = interfaceArea;
+                    myContext->nodeListPtr[n].down.sumFlow = 0;
 
-                    if (myStructure.computeHeat || myStructure.computeSolutes)
+                    if (myContext->myStructure.computeHeat || myContext->myStructure.computeSolutes)
                     {
-                        nodeListPtr[n].down.linkedExtra = new(TCrit3DLinkedNodeExtra);
-                        initializeLinkExtra(nodeListPtr[n].down.linkedExtra, myStructure.computeHeat, myStructure.computeSolutes);
+                        myContext->nodeListPtr[n].down.linkedExtra = new(TCrit3DLinkedNodeExtra);
+                        initializeLinkExtra(myContext->nodeListPtr[n].down.linkedExtra, myContext->myStructure.computeHeat, myContext->myStructure.computeSolutes);
                     }
 
                     break;
         case LATERAL :
                     j = 0;
-                    while ((j < myStructure.nrLateralLinks) && (nodeListPtr[n].lateral[j].index != NOLINK)) j++;
-                    if (j == myStructure.nrLateralLinks) return (TOPOGRAPHY_ERROR);
-                    nodeListPtr[n].lateral[j].index = linkIndex;
-                    nodeListPtr[n].lateral[j].area = interfaceArea;
-                    nodeListPtr[n].lateral[j].sumFlow = 0;
+                    while ((j < myContext->myStructure.nrLateralLinks) && (myContext->nodeListPtr[n].lateral[j].index != NOLINK)) j++;
+                    if (j == myContext->myStructure.nrLateralLinks) return (TOPOGRAPHY_ERROR);
+                    myContext->nodeListPtr[n].lateral[j].index = linkIndex;
+                    myContext->nodeListPtr[n].lateral[j].area = interfaceArea;
+                    myContext->nodeListPtr[n].lateral[j].sumFlow = 0;
 
-                    if (myStructure.computeHeat || myStructure.computeSolutes)
+                    if (myContext->myStructure.computeHeat || myContext->myStructure.computeSolutes)
                     {
-                        nodeListPtr[n].lateral[j].linkedExtra = new(TCrit3DLinkedNodeExtra);
-                        initializeLinkExtra(nodeListPtr[n].lateral[j].linkedExtra, myStructure.computeHeat, myStructure.computeSolutes);
+                        myContext->nodeListPtr[n].lateral[j].linkedExtra = new(TCrit3DLinkedNodeExtra);
+                        initializeLinkExtra(myContext->nodeListPtr[n].lateral[j].linkedExtra, myContext->myStructure.computeHeat, myContext->myStructure.computeSolutes);
                     }
 
                     break;
@@ -306,21 +363,21 @@ int DLL_EXPORT __STDCALL setHydraulicProperties(int waterRetentionCurve,
 
  int DLL_EXPORT __STDCALL setCulvert(long nodeIndex, double roughness, double slope, double width, double height)
  {
-     if ((nodeIndex < 0) || (!nodeListPtr[nodeIndex].isSurface))
+     if ((nodeIndex < 0) || (!myContext->nodeListPtr[nodeIndex].isSurface))
 	 {
-		 myCulvert.index = NOLINK;
+		 myContext->myCulvert.index = NOLINK;
 		 return(INDEX_ERROR);
 	 }
 
-	 myCulvert.index = nodeIndex;
-	 myCulvert.roughness = roughness;			// [s m^-1/3]
-	 myCulvert.slope = slope;					// [-]
-	 myCulvert.width = width;					// [m]
-	 myCulvert.height = height;					// [m]
+	 myContext->myCulvert.index = nodeIndex;
+	 myContext->myCulvert.roughness = roughness;			// [s m^-1/3]
+	 myContext->myCulvert.slope = slope;					// [-]
+	 myContext->myCulvert.width = width;					// [m]
+	 myContext->myCulvert.height = height;					// [m]
 
-    nodeListPtr[nodeIndex].boundary = new(Tboundary);
+    myContext->nodeListPtr[nodeIndex].boundary = new(Tboundary);
     double boundaryArea = width*height;
-    initializeBoundary(nodeListPtr[nodeIndex].boundary, BOUNDARY_CULVERT, float(slope), float(boundaryArea));
+    initializeBoundary(myContext->nodeListPtr[nodeIndex].boundary, BOUNDARY_CULVERT, float(slope), float(boundaryArea));
 
 	 return(CRIT3D_OK);
  }
@@ -334,14 +391,14 @@ int DLL_EXPORT __STDCALL setHydraulicProperties(int waterRetentionCurve,
  */
  int DLL_EXPORT __STDCALL setNodeSurface(long nodeIndex, int surfaceIndex)
  {
-    if (nodeListPtr == nullptr)
+    if (myContext->nodeListPtr == nullptr)
         return MEMORY_ERROR;
-    if (nodeIndex < 0 || (! nodeListPtr[nodeIndex].isSurface))
+    if (nodeIndex < 0 || (! myContext->nodeListPtr[nodeIndex].isSurface))
         return INDEX_ERROR;
-    if (surfaceIndex < 0 || surfaceIndex >= int(Surface_List.size()))
+    if (surfaceIndex < 0 || surfaceIndex >= int(myContext->Surface_List.size()))
         return PARAMETER_ERROR;
 
-    nodeListPtr[nodeIndex].Soil = &Surface_List[surfaceIndex];
+    myContext->nodeListPtr[nodeIndex].Soil = &myContext->Surface_List[surfaceIndex];
 
     return(CRIT3D_OK);
  }
@@ -356,16 +413,16 @@ int DLL_EXPORT __STDCALL setHydraulicProperties(int waterRetentionCurve,
  */
  int DLL_EXPORT __STDCALL setNodeSoil(long nodeIndex, int soilIndex, int horizonIndex)
  {
-    if (nodeListPtr == nullptr)
+    if (myContext->nodeListPtr == nullptr)
         return MEMORY_ERROR;
-    if (nodeIndex < 0 || nodeIndex >= myStructure.nrNodes)
+    if (nodeIndex < 0 || nodeIndex >= myContext->myStructure.nrNodes)
         return INDEX_ERROR;
-    if (soilIndex < 0 || soilIndex >= int(Soil_List.size()))
+    if (soilIndex < 0 || soilIndex >= int(myContext->Soil_List.size()))
         return PARAMETER_ERROR;
-    if (horizonIndex < 0 || horizonIndex >= int(Soil_List[soilIndex].size()))
+    if (horizonIndex < 0 || horizonIndex >= int(myContext->Soil_List[soilIndex].size()))
         return PARAMETER_ERROR;
 
-    nodeListPtr[nodeIndex].Soil = &Soil_List[soilIndex][horizonIndex];
+    myContext->nodeListPtr[nodeIndex].Soil = &myContext->Soil_List[soilIndex][horizonIndex];
 
     return CRIT3D_OK;
  }
@@ -392,25 +449,63 @@ int DLL_EXPORT __STDCALL setHydraulicProperties(int waterRetentionCurve,
     if (VG_alpha <= 0 || (ThetaR < 0) || ThetaR >= 1 || ThetaS <= 0 || ThetaS > 1 || ThetaR > ThetaS)
         return PARAMETER_ERROR;
 
-    if (nSoil >= int(Soil_List.size()))
-        Soil_List.resize(nSoil+1);
-    if (nHorizon >= int(Soil_List[nSoil].size()))
-        Soil_List[nSoil].resize(nHorizon+1);
+    if (nSoil >= int(myContext->Soil_List.size()))
+        myContext->Soil_List.resize(nSoil+1);
+    if (nHorizon >= int(myContext->Soil_List[nSoil].size()))
+        myContext->Soil_List[nSoil].resize(nHorizon+1);
 
-    Soil_List[nSoil][nHorizon].VG_alpha = VG_alpha;
-    Soil_List[nSoil][nHorizon].VG_n = VG_n;
-    Soil_List[nSoil][nHorizon].VG_m = VG_m;
+    myContext->Soil_List[nSoil][nHorizon].VG_alpha = VG_alpha;
+    myContext->Soil_List[nSoil][nHorizon].VG_n = VG_n;
+    myContext->Soil_List[nSoil][nHorizon].VG_m = VG_m;
 
-    Soil_List[nSoil][nHorizon].VG_he = VG_he;
-    Soil_List[nSoil][nHorizon].VG_Sc = pow(1. + pow(VG_alpha * VG_he, VG_n), -VG_m);
+    myContext->Soil_List[nSoil][nHorizon].VG_he = VG_he;
+    myContext->Soil_List[nSoil][nHorizon].VG_Sc = pow(1. + pow(VG_alpha * VG_he, VG_n), -VG_m);
 
-    Soil_List[nSoil][nHorizon].Theta_r = ThetaR;
-    Soil_List[nSoil][nHorizon].Theta_s = ThetaS;
-    Soil_List[nSoil][nHorizon].K_sat = Ksat;
-    Soil_List[nSoil][nHorizon].Mualem_L = L;
+    myContext->Soil_List[nSoil][nHorizon].Theta_r = ThetaR;
+    myContext->Soil_List[nSoil][nHorizon].Theta_s = ThetaS;
+    myContext->Soil_List[nSoil][nHorizon].K_sat = Ksat;
+    myContext->Soil_List[nSoil][nHorizon].Mualem_L = L;
 
-    Soil_List[nSoil][nHorizon].organicMatter = organicMatter;
-    Soil_List[nSoil][nHorizon].clay = clay;
+    myContext->Soil_List[nSoil][nHorizon].organicMatter = organicMatter;
+    myContext->Soil_List[nSoil][nHorizon].clay = clay;
+
+    if (myContext->myParameters.useHydraulicTables)
+        computeHydraulicTables(&(myContext->Soil_List[nSoil][nHorizon]), myContext->myParameters.hydraulicTableError);
+    else
+        clearHydraulicTables(&(myContext->Soil_List[nSoil][nHorizon]));
+
+    return CRIT3D_OK;
+ }
+
+
+/*!
+ * \brief setHydraulicTables
+ * Se, water conductivity and dSe/dpsi of the soils are interpolated on lookup tables
+ * (monotone cubic, log-spaced psi) instead of computing the Van Genuchten-Mualem formulas.
+ * The tables are recomputed when soil or hydraulic properties change
+ * \param isActive
+ * \param maxError  [-] error bound: absolute for Se, relative for conductivity (default 1E-4)
+ * \return OK or PARAMETER_ERROR
+ */
+ int DLL_EXPORT __STDCALL setHydraulicTables(bool isActive, double maxError)
+ {
+    if (isActive && (maxError <= 0 || maxError >= 0.1))
+        return PARAMETER_ERROR;
+
+    myContext->myParameters.useHydraulicTables = isActive;
+    if (isActive)
+        myContext->myParameters.hydraulicTableError = maxError;
+
+    for (unsigned int i = 0; i < myContext->Soil_List.size(); i++)
+    {
+        for (unsigned int j = 0; j < myContext->Soil_List[i].size(); j++)
+        {
+            if (isActive)
+                computeHydraulicTables(&(myContext->Soil_List[i][j]), maxError);
+            else
+                clearHydraulicTables(&(myContext->Soil_List[i][j]));
+        }
+    }
 
     return CRIT3D_OK;
  }
@@ -421,11 +516,11 @@ int DLL_EXPORT __STDCALL setHydraulicProperties(int waterRetentionCurve,
     if (roughness < 0 || surfacePond < 0)
         return PARAMETER_ERROR;
 
-    if (surfaceIndex > int(Surface_List.size()-1))
-        Surface_List.resize(surfaceIndex+1);
+    if (surfaceIndex > int(myContext->Surface_List.size()-1))
+        myContext->Surface_List.resize(surfaceIndex+1);
 
-    Surface_List[surfaceIndex].Roughness = roughness;
-    Surface_List[surfaceIndex].Pond = surfacePond;
+    myContext->Surface_List[surfaceIndex].Roughness = roughness;
+    myContext->Surface_List[surfaceIndex].Pond = surfacePond;
 
     return CRIT3D_OK;
  }
@@ -439,23 +534,23 @@ int DLL_EXPORT __STDCALL setHydraulicProperties(int waterRetentionCurve,
  */
  int DLL_EXPORT __STDCALL setMatricPotential(long nodeIndex, double potential)
  {
-     if (nodeListPtr == nullptr)
+     if (myContext->nodeListPtr == nullptr)
          return MEMORY_ERROR;
-     if ((nodeIndex < 0) || (nodeIndex >= myStructure.nrNodes))
+     if ((nodeIndex < 0) || (nodeIndex >= myContext->myStructure.nrNodes))
          return INDEX_ERROR;
 
-     nodeListPtr[nodeIndex].H = potential + nodeListPtr[nodeIndex].z;
-     nodeListPtr[nodeIndex].oldH = nodeListPtr[nodeIndex].H;
+     myContext->nodeListPtr[nodeIndex].H = potential + myContext->nodeListPtr[nodeIndex].z;
+     myContext->nodeListPtr[nodeIndex].oldH = myContext->nodeListPtr[nodeIndex].H;
 
-     if (nodeListPtr[nodeIndex].isSurface)
+     if (myContext->nodeListPtr[nodeIndex].isSurface)
      {
-         nodeListPtr[nodeIndex].Se = 1.;
-         nodeListPtr[nodeIndex].k = NODATA;
+         myContext->nodeListPtr[nodeIndex].Se = 1.;
+         myContext->nodeListPtr[nodeIndex].k = NODATA;
      }
      else
      {
-         nodeListPtr[nodeIndex].Se = computeSe(nodeIndex);
-         nodeListPtr[nodeIndex].k = computeK(nodeIndex);
+         myContext->nodeListPtr[nodeIndex].Se = computeSe(nodeIndex);
+         myContext->nodeListPtr[nodeIndex].k = computeK(nodeIndex);
      }
 
      return CRIT3D_OK;
@@ -471,24 +566,24 @@ int DLL_EXPORT __STDCALL setHydraulicProperties(int waterRetentionCurve,
 	int DLL_EXPORT __STDCALL setTotalPotential(long nodeIndex, double totalPotential)
  {
 
-     if (nodeListPtr == nullptr)
+     if (myContext->nodeListPtr == nullptr)
 		 return(MEMORY_ERROR);
 
-	 if ((nodeIndex < 0) || (nodeIndex >= myStructure.nrNodes))
+	 if ((nodeIndex < 0) || (nodeIndex >= myContext->myStructure.nrNodes))
 		 return(INDEX_ERROR);
 
-     nodeListPtr[nodeIndex].H = totalPotential;
-     nodeListPtr[nodeIndex].oldH = nodeListPtr[nodeIndex].H;
+     myContext->nodeListPtr[nodeIndex].H = totalPotential;
+     myContext->nodeListPtr[nodeIndex].oldH = myContext->nodeListPtr[nodeIndex].H;
 
-     if (nodeListPtr[nodeIndex].isSurface)
+     if (myContext->nodeListPtr[nodeIndex].isSurface)
 	 {
-         nodeListPtr[nodeIndex].Se = 1.;
-         nodeListPtr[nodeIndex].k = NODATA;
+         myContext->nodeListPtr[nodeIndex].Se = 1.;
+         myContext->nodeListPtr[nodeIndex].k = NODATA;
 	 }
 	 else
 	 {
-         nodeListPtr[nodeIndex].Se = computeSe(nodeIndex);
-         nodeListPtr[nodeIndex].k = computeK(nodeIndex);
+         myContext->nodeListPtr[nodeIndex].Se = computeSe(nodeIndex);
+         myContext->nodeListPtr[nodeIndex].k = computeK(nodeIndex);
 	 }
 
 	 return(CRIT3D_OK);
@@ -503,27 +598,27 @@ int DLL_EXPORT __STDCALL setHydraulicProperties(int waterRetentionCurve,
  */
  int DLL_EXPORT __STDCALL setWaterContent(long nodeIndex, double waterContent)
  {
-    if (nodeListPtr == nullptr) return MEMORY_ERROR;
+    if (myContext->nodeListPtr == nullptr) return MEMORY_ERROR;
 
-    if ((nodeIndex < 0) || (nodeIndex >= myStructure.nrNodes)) return INDEX_ERROR;
+    if ((nodeIndex < 0) || (nodeIndex >= myContext->myStructure.nrNodes)) return INDEX_ERROR;
 
     if (waterContent < 0.) return PARAMETER_ERROR;
 
-    if (nodeListPtr[nodeIndex].isSurface)
+    if (myContext->nodeListPtr[nodeIndex].isSurface)
             {
             /*! surface */
-            nodeListPtr[nodeIndex].H = nodeListPtr[nodeIndex].z + waterContent;
-            nodeListPtr[nodeIndex].oldH = nodeListPtr[nodeIndex].H;
-            nodeListPtr[nodeIndex].Se = 1.;
-            nodeListPtr[nodeIndex].k = 0.;
+            myContext->nodeListPtr[nodeIndex].H = myContext->nodeListPtr[nodeIndex].z + waterContent;
+            myContext->nodeListPtr[nodeIndex].oldH = myContext->nodeListPtr[nodeIndex].H;
+            myContext->nodeListPtr[nodeIndex].Se = 1.;
+            myContext->nodeListPtr[nodeIndex].k = 0.;
             }
     else
             {
             if (waterContent > 1.0) return PARAMETER_ERROR;
-            nodeListPtr[nodeIndex].Se = Se_from_theta(nodeIndex, waterContent);
-            nodeListPtr[nodeIndex].H = nodeListPtr[nodeIndex].z - psi_from_Se(nodeIndex);
-            nodeListPtr[nodeIndex].oldH = nodeListPtr[nodeIndex].H;
-            nodeListPtr[nodeIndex].k = computeK(nodeIndex);
+            myContext->nodeListPtr[nodeIndex].Se = Se_from_theta(nodeIndex, waterContent);
+            myContext->nodeListPtr[nodeIndex].H = myContext->nodeListPtr[nodeIndex].z - psi_from_Se(nodeIndex);
+            myContext->nodeListPtr[nodeIndex].oldH = myContext->nodeListPtr[nodeIndex].H;
+            myContext->nodeListPtr[nodeIndex].k = computeK(nodeIndex);
             }
 
     return CRIT3D_OK;
@@ -538,10 +633,10 @@ int DLL_EXPORT __STDCALL setHydraulicProperties(int waterRetentionCurve,
  */
  int DLL_EXPORT __STDCALL setWaterSinkSource(long nodeIndex, double waterSinkSource)
  {
-    if (nodeListPtr == nullptr) return MEMORY_ERROR;
-    if ((nodeIndex < 0) || (nodeIndex >= myStructure.nrNodes)) return INDEX_ERROR;
+    if (myContext->nodeListPtr == nullptr) return MEMORY_ERROR;
+    if ((nodeIndex < 0) || (nodeIndex >= myContext->myStructure.nrNodes)) return INDEX_ERROR;
 
-    nodeListPtr[nodeIndex].waterSinkSource = waterSinkSource;
+    myContext->nodeListPtr[nodeIndex].waterSinkSource = waterSinkSource;
 
     return CRIT3D_OK;
  }
@@ -555,12 +650,12 @@ int DLL_EXPORT __STDCALL setHydraulicProperties(int waterRetentionCurve,
  */
  int DLL_EXPORT __STDCALL setPrescribedTotalPotential(long nodeIndex, double prescribedTotalPotential)
  {
-    if (nodeListPtr == nullptr) return MEMORY_ERROR;
-    if ((nodeIndex < 0) || (nodeIndex >= myStructure.nrNodes)) return INDEX_ERROR;
-    if (nodeListPtr[nodeIndex].boundary == nullptr) return BOUNDARY_ERROR;
-    if (nodeListPtr[nodeIndex].boundary->type != BOUNDARY_PRESCRIBEDTOTALPOTENTIAL) return BOUNDARY_ERROR;
+    if (myContext->nodeListPtr == nullptr) return MEMORY_ERROR;
+    if ((nodeIndex < 0) || (nodeIndex >= myContext->myStructure.nrNodes)) return INDEX_ERROR;
+    if (myContext->nodeListPtr[nodeIndex].boundary == nullptr) return BOUNDARY_ERROR;
+    if (myContext->nodeListPtr[nodeIndex].boundary->type != BOUNDARY_PRESCRIBEDTOTALPOTENTIAL) return BOUNDARY_ERROR;
 
-    nodeListPtr[nodeIndex].boundary->prescribedTotalPotential = prescribedTotalPotential;
+    myContext->nodeListPtr[nodeIndex].boundary->prescribedTotalPotential = prescribedTotalPotential;
 
     return CRIT3D_OK;
  }
@@ -573,12 +668,12 @@ int DLL_EXPORT __STDCALL setHydraulicProperties(int waterRetentionCurve,
  */
  double DLL_EXPORT __STDCALL getWaterContent(long nodeIndex)
  {
-        if (nodeListPtr == nullptr) return(MEMORY_ERROR);
-        if ((nodeIndex < 0) || (nodeIndex >= myStructure.nrNodes)) return(INDEX_ERROR);
+        if (myContext->nodeListPtr == nullptr) return(MEMORY_ERROR);
+        if ((nodeIndex < 0) || (nodeIndex >= myContext->myStructure.nrNodes)) return(INDEX_ERROR);
 
-        if  (nodeListPtr[nodeIndex].isSurface)
+        if  (myContext->nodeListPtr[nodeIndex].isSurface)
             /*! surface */
-            return (nodeListPtr[nodeIndex].H - nodeListPtr[nodeIndex].z);
+            return (myContext->nodeListPtr[nodeIndex].H - myContext->nodeListPtr[nodeIndex].z);
         else
             /*! sub-surface */
             return (theta_from_Se(nodeIndex));
@@ -593,12 +688,12 @@ int DLL_EXPORT __STDCALL setHydraulicProperties(int waterRetentionCurve,
  */
  double DLL_EXPORT __STDCALL getAvailableWaterContent(long index)
  {
-        if (nodeListPtr == nullptr) return(MEMORY_ERROR);
-        if ((index < 0) || (index >= myStructure.nrNodes)) return(INDEX_ERROR);
+        if (myContext->nodeListPtr == nullptr) return(MEMORY_ERROR);
+        if ((index < 0) || (index >= myContext->myStructure.nrNodes)) return(INDEX_ERROR);
 
-        if  (nodeListPtr[index].isSurface)
+        if  (myContext->nodeListPtr[index].isSurface)
             /*! surface */
-            return (nodeListPtr[index].H - nodeListPtr[index].z);
+            return (myContext->nodeListPtr[index].H - myContext->nodeListPtr[index].z);
         else
             /*! sub-surface */
             return MAXVALUE(0.0, theta_from_Se(index) - theta_from_sign_Psi(-160, index));
@@ -613,10 +708,10 @@ int DLL_EXPORT __STDCALL setHydraulicProperties(int waterRetentionCurve,
  */
 	double DLL_EXPORT __STDCALL getWaterDeficit(long index, double fieldCapacity)
  {
-        if (nodeListPtr == nullptr) return(MEMORY_ERROR);
-        if ((index < 0) || (index >= myStructure.nrNodes)) return(INDEX_ERROR);
+        if (myContext->nodeListPtr == nullptr) return(MEMORY_ERROR);
+        if ((index < 0) || (index >= myContext->myStructure.nrNodes)) return(INDEX_ERROR);
 
-        if  (nodeListPtr[index].isSurface)
+        if  (myContext->nodeListPtr[index].isSurface)
             /*! surface */
             return (0.0);
         else
@@ -634,14 +729,14 @@ int DLL_EXPORT __STDCALL setHydraulicProperties(int waterRetentionCurve,
   */
  double DLL_EXPORT __STDCALL getDegreeOfSaturation(long nodeIndex)
  {
-    if (nodeListPtr == nullptr)
+    if (myContext->nodeListPtr == nullptr)
         return MEMORY_ERROR;
-    if ((nodeIndex < 0) || (nodeIndex >= myStructure.nrNodes))
+    if ((nodeIndex < 0) || (nodeIndex >= myContext->myStructure.nrNodes))
         return INDEX_ERROR;
 
-    if  (nodeListPtr[nodeIndex].isSurface)
+    if  (myContext->nodeListPtr[nodeIndex].isSurface)
     {
-        double h = nodeListPtr[nodeIndex].H - nodeListPtr[nodeIndex].z;
+        double h = myContext->nodeListPtr[nodeIndex].H - myContext->nodeListPtr[nodeIndex].z;
         double h_max = 0.001;       // [m]
 
         if (h <= 0 ) return 0.;
@@ -650,7 +745,7 @@ int DLL_EXPORT __STDCALL setHydraulicProperties(int waterRetentionCurve,
     }
     else
     {
-        return nodeListPtr[nodeIndex].Se;
+        return myContext->nodeListPtr[nodeIndex].Se;
     }
  }
 
@@ -673,10 +768,10 @@ int DLL_EXPORT __STDCALL setHydraulicProperties(int waterRetentionCurve,
  double DLL_EXPORT __STDCALL getWaterConductivity(long nodeIndex)
  {
     /*! error check */
-    if (nodeListPtr == nullptr) return(MEMORY_ERROR);
-    if ((nodeIndex < 0) || (nodeIndex >= myStructure.nrNodes)) return(INDEX_ERROR);
+    if (myContext->nodeListPtr == nullptr) return(MEMORY_ERROR);
+    if ((nodeIndex < 0) || (nodeIndex >= myContext->myStructure.nrNodes)) return(INDEX_ERROR);
 
-    return (nodeListPtr[nodeIndex].k);
+    return (myContext->nodeListPtr[nodeIndex].k);
  }
 
 
@@ -687,10 +782,10 @@ int DLL_EXPORT __STDCALL setHydraulicProperties(int waterRetentionCurve,
   */
  double DLL_EXPORT __STDCALL getMatricPotential(long nodeIndex)
  {
-    if (nodeListPtr == nullptr) return(MEMORY_ERROR);
-    if ((nodeIndex < 0) || (nodeIndex >= myStructure.nrNodes)) return(INDEX_ERROR);
+    if (myContext->nodeListPtr == nullptr) return(MEMORY_ERROR);
+    if ((nodeIndex < 0) || (nodeIndex >= myContext->myStructure.nrNodes)) return(INDEX_ERROR);
 
-    return (nodeListPtr[nodeIndex].H - nodeListPtr[nodeIndex].z);
+    return (myContext->nodeListPtr[nodeIndex].H - myContext->nodeListPtr[nodeIndex].z);
  }
 
 
@@ -701,10 +796,10 @@ int DLL_EXPORT __STDCALL setHydraulicProperties(int waterRetentionCurve,
   */
  double DLL_EXPORT __STDCALL getTotalPotential(long nodeIndex)
  {
-     if (nodeListPtr == nullptr) return(MEMORY_ERROR);
-	 if ((nodeIndex < 0) || (nodeIndex >= myStructure.nrNodes)) return(INDEX_ERROR);
+     if (myContext->nodeListPtr == nullptr) return(MEMORY_ERROR);
+	 if ((nodeIndex < 0) || (nodeIndex >= myContext->myStructure.nrNodes)) return(INDEX_ERROR);
 
-     return (nodeListPtr[nodeIndex].H);
+     return (myContext->nodeListPtr[nodeIndex].H);
  }
 
 
@@ -716,16 +811,16 @@ int DLL_EXPORT __STDCALL setHydraulicProperties(int waterRetentionCurve,
   */
  double DLL_EXPORT __STDCALL getWaterFlow(long n, short direction)
  {
-    if (nodeListPtr == nullptr) return MEMORY_ERROR;
-    if ((n < 0) || (n >= myStructure.nrNodes)) return INDEX_ERROR;
+    if (myContext->nodeListPtr == nullptr) return MEMORY_ERROR;
+    if ((n < 0) || (n >= myContext->myStructure.nrNodes)) return INDEX_ERROR;
 
 	double maxFlow = 0.0;
 
 	switch (direction) {
         case UP:
-            if (nodeListPtr[n].up.index != NOLINK)
+            if (myContext->nodeListPtr[n].up.index != NOLINK)
             {
-                return nodeListPtr[n].up.sumFlow;
+                return myContext->nodeListPtr[n].up.sumFlow;
             }
             else
             {
@@ -733,9 +828,9 @@ int DLL_EXPORT __STDCALL setHydraulicProperties(int waterRetentionCurve,
             }
 
 		case DOWN:
-            if (nodeListPtr[n].down.index != NOLINK)
+            if (myContext->nodeListPtr[n].down.index != NOLINK)
             {
-                return nodeListPtr[n].down.sumFlow;
+                return myContext->nodeListPtr[n].down.sumFlow;
             }
             else
             {
@@ -744,11 +839,11 @@ int DLL_EXPORT __STDCALL setHydraulicProperties(int waterRetentionCurve,
 
 		case LATERAL:
 			// return maximum lateral flow
-            for (short i = 0; i < myStructure.nrLateralLinks; i++)
-                if (nodeListPtr[n].lateral[i].index != NOLINK)
-                    if (fabs(nodeListPtr[n].lateral[i].sumFlow) > maxFlow)
+            for (short i = 0; i < myContext->myStructure.nrLateralLinks; i++)
+                if (myContext->nodeListPtr[n].lateral[i].index != NOLINK)
+                    if (fabs(myContext->nodeListPtr[n].lateral[i].sumFlow) > maxFlow)
                     {
-                        maxFlow = nodeListPtr[n].lateral[i].sumFlow;
+                        maxFlow = myContext->nodeListPtr[n].lateral[i].sumFlow;
                     }
 
             return maxFlow;
@@ -766,14 +861,14 @@ int DLL_EXPORT __STDCALL setHydraulicProperties(int waterRetentionCurve,
   */
  double DLL_EXPORT __STDCALL getSumLateralWaterFlow(long n)
  {
-    if (nodeListPtr == nullptr) return MEMORY_ERROR;
-    if ((n < 0) || (n >= myStructure.nrNodes)) return INDEX_ERROR;
+    if (myContext->nodeListPtr == nullptr) return MEMORY_ERROR;
+    if ((n < 0) || (n >= myContext->myStructure.nrNodes)) return INDEX_ERROR;
 
     double sumLateralFlow = 0.0;
-    for (short i = 0; i < myStructure.nrLateralLinks; i++)
+    for (short i = 0; i < myContext->myStructure.nrLateralLinks; i++)
     {
-        if (nodeListPtr[n].lateral[i].index != NOLINK)
-            sumLateralFlow += nodeListPtr[n].lateral[i].sumFlow;
+        if (myContext->nodeListPtr[n].lateral[i].index != NOLINK)
+            sumLateralFlow += myContext->nodeListPtr[n].lateral[i].sumFlow;
     }
 	return sumLateralFlow;
  }
@@ -786,14 +881,14 @@ int DLL_EXPORT __STDCALL setHydraulicProperties(int waterRetentionCurve,
   */
  double DLL_EXPORT __STDCALL getSumLateralWaterFlowIn(long n)
  {
-    if (nodeListPtr == nullptr) return MEMORY_ERROR;
-    if ((n < 0) || (n >= myStructure.nrNodes)) return INDEX_ERROR;
+    if (myContext->nodeListPtr == nullptr) return MEMORY_ERROR;
+    if ((n < 0) || (n >= myContext->myStructure.nrNodes)) return INDEX_ERROR;
 
     double sumLateralFlow = 0.0;
-    for (short i = 0; i < myStructure.nrLateralLinks; i++)
-        if (nodeListPtr[n].lateral[i].index != NOLINK)
-            if (nodeListPtr[n].lateral[i].sumFlow > 0)
-                sumLateralFlow += nodeListPtr[n].lateral[i].sumFlow;
+    for (short i = 0; i < myContext->myStructure.nrLateralLinks; i++)
+        if (myContext->nodeListPtr[n].lateral[i].index != NOLINK)
+            if (myContext->nodeListPtr[n].lateral[i].sumFlow > 0)
+                sumLateralFlow += myContext->nodeListPtr[n].lateral[i].sumFlow;
 
     return sumLateralFlow;
  }
@@ -806,14 +901,14 @@ int DLL_EXPORT __STDCALL setHydraulicProperties(int waterRetentionCurve,
   */
  double DLL_EXPORT __STDCALL getSumLateralWaterFlowOut(long n)
  {
-    if (nodeListPtr == nullptr) return MEMORY_ERROR;
-    if ((n < 0) || (n >= myStructure.nrNodes)) return INDEX_ERROR;
+    if (myContext->nodeListPtr == nullptr) return MEMORY_ERROR;
+    if ((n < 0) || (n >= myContext->myStructure.nrNodes)) return INDEX_ERROR;
 
     double sumLateralFlow = 0.0;
-    for (short i = 0; i < myStructure.nrLateralLinks; i++)
-        if (nodeListPtr[n].lateral[i].index != NOLINK)
-            if (nodeListPtr[n].lateral[i].sumFlow < 0)
-                sumLateralFlow += nodeListPtr[n].lateral[i].sumFlow;
+    for (short i = 0; i < myContext->myStructure.nrLateralLinks; i++)
+        if (myContext->nodeListPtr[n].lateral[i].index != NOLINK)
+            if (myContext->nodeListPtr[n].lateral[i].sumFlow < 0)
+                sumLateralFlow += myContext->nodeListPtr[n].lateral[i].sumFlow;
 
     return sumLateralFlow;
  }
@@ -822,31 +917,31 @@ int DLL_EXPORT __STDCALL setHydraulicProperties(int waterRetentionCurve,
  void DLL_EXPORT __STDCALL initializeBalance()
 {
     InitializeBalanceWater();
-    if (myStructure.computeHeat)
+    if (myContext->myStructure.computeHeat)
         initializeBalanceHeat();
     else
-        balanceWholePeriod.heatMBR = 1.;
+        myContext->balanceWholePeriod.heatMBR = 1.;
 }
 
 
  double DLL_EXPORT __STDCALL getWaterMBR()
  {
-    return (balanceWholePeriod.waterMBR);
+    return (myContext->balanceWholePeriod.waterMBR);
  }
 
  double DLL_EXPORT __STDCALL getHeatMBR()
   {
-     return (balanceWholePeriod.heatMBR);
+     return (myContext->balanceWholePeriod.heatMBR);
   }
 
  double DLL_EXPORT __STDCALL getHeatMBE()
   {
-     return (balanceWholePeriod.heatMBE);
+     return (myContext->balanceWholePeriod.heatMBE);
   }
 
   double DLL_EXPORT __STDCALL getWaterStorage()
   {
-     return (balanceCurrentTimeStep.storageWater);
+     return (myContext->balanceCurrentTimeStep.storageWater);
   }
 
 
@@ -857,14 +952,14 @@ int DLL_EXPORT __STDCALL setHydraulicProperties(int waterRetentionCurve,
   */
  double DLL_EXPORT __STDCALL getBoundaryWaterFlow(long nodeIndex)
  {
-    if (nodeListPtr == nullptr)
+    if (myContext->nodeListPtr == nullptr)
         return MEMORY_ERROR;
-    if (nodeIndex < 0 || nodeIndex >= myStructure.nrNodes)
+    if (nodeIndex < 0 || nodeIndex >= myContext->myStructure.nrNodes)
         return INDEX_ERROR;
-    if (nodeListPtr[nodeIndex].boundary == nullptr)
+    if (myContext->nodeListPtr[nodeIndex].boundary == nullptr)
         return BOUNDARY_ERROR;
 
-    return nodeListPtr[nodeIndex].boundary->sumBoundaryWaterFlow;
+    return myContext->nodeListPtr[nodeIndex].boundary->sumBoundaryWaterFlow;
  }
 
 
@@ -877,10 +972,10 @@ int DLL_EXPORT __STDCALL setHydraulicProperties(int waterRetentionCurve,
  {
     double sumBoundaryFlow = 0.0;
 
-    for (long n = 0; n < myStructure.nrNodes; n++)
-        if (nodeListPtr[n].boundary != nullptr)
-            if (nodeListPtr[n].boundary->type == boundaryType)
-                sumBoundaryFlow += nodeListPtr[n].boundary->sumBoundaryWaterFlow;
+    for (long n = 0; n < myContext->myStructure.nrNodes; n++)
+        if (myContext->nodeListPtr[n].boundary != nullptr)
+            if (myContext->nodeListPtr[n].boundary->type == boundaryType)
+                sumBoundaryFlow += myContext->nodeListPtr[n].boundary->sumBoundaryWaterFlow;
 
     return sumBoundaryFlow;
  }
@@ -895,8 +990,8 @@ int DLL_EXPORT __STDCALL setHydraulicProperties(int waterRetentionCurve,
     {
         double sumTime = 0.0;
 
-        balanceCurrentPeriod.sinkSourceWater = 0.;
-        balanceCurrentPeriod.sinkSourceHeat = 0.;
+        myContext->balanceCurrentPeriod.sinkSourceWater = 0.;
+        myContext->balanceCurrentPeriod.sinkSourceHeat = 0.;
 
         while (sumTime < myPeriod)
         {
@@ -904,8 +999,8 @@ int DLL_EXPORT __STDCALL setHydraulicProperties(int waterRetentionCurve,
             sumTime += computeStep(ResidualTime);
         }
 
-        if (myStructure.computeWater) updateBalanceWaterWholePeriod();
-        if (myStructure.computeHeat) updateBalanceHeatWholePeriod();
+        if (myContext->myStructure.computeWater) updateBalanceWaterWholePeriod();
+        if (myContext->myStructure.computeHeat) updateBalanceHeatWholePeriod();
     }
 
 
@@ -918,20 +1013,20 @@ double DLL_EXPORT __STDCALL computeStep(double maxTime)
 {
     double dtWater, dtHeat;
 
-    if (myStructure.computeHeat)
+    if (myContext->myStructure.computeHeat)
     {
         initializeHeatFluxes(false, true);
         updateConductance();
     }
 
-    if (myStructure.computeWater)
+    if (myContext->myStructure.computeWater)
         computeWater(maxTime, &dtWater);
     else
-        dtWater = MINVALUE(maxTime, myParameters.delta_t_max);
+        dtWater = MINVALUE(maxTime, myContext->myParameters.delta_t_max);
 
     dtHeat = dtWater;
 
-    if (myStructure.computeHeat)
+    if (myContext->myStructure.computeHeat)
     {
         double dtHeatCurrent = dtHeat;
 
@@ -951,7 +1046,7 @@ double DLL_EXPORT __STDCALL computeStep(double maxTime)
             else
             {
                 restoreHeat();
-                dtHeat = myParameters.current_delta_t;
+                dtHeat = myContext->myParameters.current_delta_t;
             }
         }
     }
@@ -973,16 +1068,16 @@ int DLL_EXPORT __STDCALL setTemperature(long nodeIndex, double myT)
    // myT              [K] temperature
    //----------------------------------------------------------------------------------------------
 
-   if (nodeListPtr == nullptr) return(MEMORY_ERROR);
+   if (myContext->nodeListPtr == nullptr) return(MEMORY_ERROR);
 
-   if ((nodeIndex < 0) || (nodeIndex >= myStructure.nrNodes)) return(INDEX_ERROR);
+   if ((nodeIndex < 0) || (nodeIndex >= myContext->myStructure.nrNodes)) return(INDEX_ERROR);
 
    if ((myT < 200) || (myT > 500)) return(PARAMETER_ERROR);
 
    if (! isHeatNode(nodeIndex)) return(MEMORY_ERROR);
 
-   nodeListPtr[nodeIndex].extra->Heat->T = myT;
-   nodeListPtr[nodeIndex].extra->Heat->oldT = myT;
+   myContext->nodeListPtr[nodeIndex].extra->Heat->T = myT;
+   myContext->nodeListPtr[nodeIndex].extra->Heat->oldT = myT;
 
    return(CRIT3D_OK);
 }
@@ -995,15 +1090,15 @@ int DLL_EXPORT __STDCALL setTemperature(long nodeIndex, double myT)
  */
 int DLL_EXPORT __STDCALL setFixedTemperature(long nodeIndex, double myT, double myDepth)
 {
-   if (nodeListPtr == nullptr) return(MEMORY_ERROR);
-   if ((nodeIndex < 0) || (nodeIndex >= myStructure.nrNodes)) return(INDEX_ERROR);
-   if (nodeListPtr[nodeIndex].boundary == nullptr) return(BOUNDARY_ERROR);
-   if (nodeListPtr[nodeIndex].boundary->Heat == nullptr) return(BOUNDARY_ERROR);
-   if (nodeListPtr[nodeIndex].boundary->type != BOUNDARY_PRESCRIBEDTOTALPOTENTIAL &&
-           nodeListPtr[nodeIndex].boundary->type != BOUNDARY_FREEDRAINAGE) return(BOUNDARY_ERROR);
+   if (myContext->nodeListPtr == nullptr) return(MEMORY_ERROR);
+   if ((nodeIndex < 0) || (nodeIndex >= myContext->myStructure.nrNodes)) return(INDEX_ERROR);
+   if (myContext->nodeListPtr[nodeIndex].boundary == nullptr) return(BOUNDARY_ERROR);
+   if (myContext->nodeListPtr[nodeIndex].boundary->Heat == nullptr) return(BOUNDARY_ERROR);
+   if (myContext->nodeListPtr[nodeIndex].boundary->type != BOUNDARY_PRESCRIBEDTOTALPOTENTIAL &&
+           myContext->nodeListPtr[nodeIndex].boundary->type != BOUNDARY_FREEDRAINAGE) return(BOUNDARY_ERROR);
 
-   nodeListPtr[nodeIndex].boundary->Heat->fixedTemperatureDepth = myDepth;
-   nodeListPtr[nodeIndex].boundary->Heat->fixedTemperature = myT;
+   myContext->nodeListPtr[nodeIndex].boundary->Heat->fixedTemperatureDepth = myDepth;
+   myContext->nodeListPtr[nodeIndex].boundary->Heat->fixedTemperature = myT;
 
    return(CRIT3D_OK);
 }
@@ -1016,14 +1111,14 @@ int DLL_EXPORT __STDCALL setFixedTemperature(long nodeIndex, double myT, double
  */
 int DLL_EXPORT __STDCALL setHeatBoundaryWindSpeed(long nodeIndex, double myWindSpeed)
 {
-   if (nodeListPtr == nullptr) return(MEMORY_ERROR);
-   if ((nodeIndex < 0) || (nodeIndex >= myStructure.nrNodes)) return(INDEX_ERROR);
+   if (myContext->nodeListPtr == nullptr) return(MEMORY_ERROR);
+   if ((nodeIndex < 0) || (nodeIndex >= myContext->myStructure.nrNodes)) return(INDEX_ERROR);
    if ((myWindSpeed < 0) || (myWindSpeed > 1000)) return(PARAMETER_ERROR);
 
-   if (nodeListPtr[nodeIndex].boundary == nullptr || nodeListPtr[nodeIndex].boundary->Heat == nullptr)
+   if (myContext->nodeListPtr[nodeIndex].boundary == nullptr || myContext->nodeListPtr[nodeIndex].boundary->Heat == nullptr)
        return (BOUNDARY_ERROR);
 
-   nodeListPtr[nodeIndex].boundary->Heat->windSpeed = myWindSpeed;
+   myContext->nodeListPtr[nodeIndex].boundary->Heat->windSpeed = myWindSpeed;
 
    return(CRIT3D_OK);
 }
@@ -1036,14 +1131,14 @@ int DLL_EXPORT __STDCALL setHeatBoundaryWindSpeed(long nodeIndex, double myWindS
  */
 int DLL_EXPORT __STDCALL setHeatBoundaryRoughness(long nodeIndex, double myRoughness)
 {
-   if (nodeListPtr == nullptr) return(MEMORY_ERROR);
-   if ((nodeIndex < 0) || (nodeIndex >= myStructure.nrNodes)) return(INDEX_ERROR);
+   if (myContext->nodeListPtr == nullptr) return(MEMORY_ERROR);
+   if ((nodeIndex < 0) || (nodeIndex >= myContext->myStructure.nrNodes)) return(INDEX_ERROR);
    if (myRoughness < 0) return(PARAMETER_ERROR);
 
-   if (nodeListPtr[nodeIndex].boundary == nullptr || nodeListPtr[nodeIndex].boundary->Heat == nullptr)
+   if (myContext->nodeListPtr[nodeIndex].boundary == nullptr || myContext->nodeListPtr[nodeIndex].boundary->Heat == nullptr)
        return (BOUNDARY_ERROR);
 
-   nodeListPtr[nodeIndex].boundary->Heat->roughnessHeight = myRoughness;
+   myContext->nodeListPtr[nodeIndex].boundary->Heat->roughnessHeight = myRoughness;
 
    return(CRIT3D_OK);
 }
@@ -1056,13 +1151,13 @@ int DLL_EXPORT __STDCALL setHeatBoundaryRoughness(long nodeIndex, double myRough
  */
 int DLL_EXPORT __STDCALL setHeatSinkSource(long nodeIndex, double myHeatFlow)
 {
-   if (nodeListPtr == nullptr)
+   if (myContext->nodeListPtr == nullptr)
        return(MEMORY_ERROR);
 
-   if ((nodeIndex < 0) || (nodeIndex >= myStructure.nrNodes))
+   if ((nodeIndex < 0) || (nodeIndex >= myContext->myStructure.nrNodes))
        return(INDEX_ERROR);
 
-   nodeListPtr[nodeIndex].extra->Heat->sinkSource = myHeatFlow;
+   myContext->nodeListPtr[nodeIndex].extra->Heat->sinkSource = myHeatFlow;
 
    return(CRIT3D_OK);
 }
@@ -1075,16 +1170,16 @@ int DLL_EXPORT __STDCALL setHeatSinkSource(long nodeIndex, double myHeatFlow)
  */
 int DLL_EXPORT __STDCALL setHeatBoundaryTemperature(long nodeIndex, double myTemperature)
 {
-   if (nodeListPtr == nullptr)
+   if (myContext->nodeListPtr == nullptr)
        return(MEMORY_ERROR);
 
-   if ((nodeIndex < 0) || (nodeIndex >= myStructure.nrNodes))
+   if ((nodeIndex < 0) || (nodeIndex >= myContext->myStructure.nrNodes))
        return(INDEX_ERROR);
 
-   if (nodeListPtr[nodeIndex].boundary == nullptr || nodeListPtr[nodeIndex].boundary->Heat == nullptr)
+   if (myContext->nodeListPtr[nodeIndex].boundary == nullptr || myContext->nodeListPtr[nodeIndex].boundary->Heat == nullptr)
        return (BOUNDARY_ERROR);
 
-   nodeListPtr[nodeIndex].boundary->Heat->temperature = myTemperature;
+   myContext->nodeListPtr[nodeIndex].boundary->Heat->temperature = myTemperature;
 
    return(CRIT3D_OK);
 }
@@ -1097,16 +1192,16 @@ int DLL_EXPORT __STDCALL setHeatBoundaryTemperature(long nodeIndex, double myTem
  */
 int DLL_EXPORT __STDCALL setHeatBoundaryNetIrradiance(long nodeIndex, double myNetIrradiance)
 {
-   if (nodeListPtr == nullptr)
+   if (myContext->nodeListPtr == nullptr)
        return(MEMORY_ERROR);
 
-   if ((nodeIndex < 0) || (nodeIndex >= myStructure.nrNodes))
+   if ((nodeIndex < 0) || (nodeIndex >= myContext->myStructure.nrNodes))
        return(INDEX_ERROR);
 
-   if (nodeListPtr[nodeIndex].boundary == nullptr || nodeListPtr[nodeIndex].boundary->Heat == nullptr)
+   if (myContext->nodeListPtr[nodeIndex].boundary == nullptr || myContext->nodeListPtr[nodeIndex].boundary->Heat == nullptr)
        return (BOUNDARY_ERROR);
 
-   nodeListPtr[nodeIndex].boundary->Heat->netIrradiance = myNetIrradiance;
+   myContext->nodeListPtr[nodeIndex].boundary->Heat->netIrradiance = myNetIrradiance;
 
    return(CRIT3D_OK);
 }
@@ -1119,16 +1214,16 @@ int DLL_EXPORT __STDCALL setHeatBoundaryNetIrradiance(long nodeIndex, double myN
  */
 int DLL_EXPORT __STDCALL setHeatBoundaryRelativeHumidity(long nodeIndex, double myRelativeHumidity)
 {
-   if (nodeListPtr == nullptr)
+   if (myContext->nodeListPtr == nullptr)
        return(MEMORY_ERROR);
 
-   if ((nodeIndex < 0) || (nodeIndex >= myStructure.nrNodes))
+   if ((nodeIndex < 0) || (nodeIndex >= myContext->myStructure.nrNodes))
        return(INDEX_ERROR);
 
-   if (nodeListPtr[nodeIndex].boundary == nullptr || nodeListPtr[nodeIndex].boundary->Heat == nullptr)
+   if (myContext->nodeListPtr[nodeIndex].boundary == nullptr || myContext->nodeListPtr[nodeIndex].boundary->Heat == nullptr)
        return (BOUNDARY_ERROR);
 
-   nodeListPtr[nodeIndex].boundary->Heat->relativeHumidity = myRelativeHumidity;
+   myContext->nodeListPtr[nodeIndex].boundary->Heat->relativeHumidity = myRelativeHumidity;
 
    return(CRIT3D_OK);
 }
@@ -1141,13 +1236,13 @@ int DLL_EXPORT __STDCALL setHeatBoundaryRelativeHumidity(long nodeIndex, double
  */
 int DLL_EXPORT __STDCALL setHeatBoundaryHeightWind(long nodeIndex, double myHeight)
 {
-   if (nodeListPtr == nullptr) return(MEMORY_ERROR);
-   if ((nodeIndex < 0) || (nodeIndex >= myStructure.nrNodes)) return(INDEX_ERROR);
+   if (myContext->nodeListPtr == nullptr) return(MEMORY_ERROR);
+   if ((nodeIndex < 0) || (nodeIndex >= myContext->myStructure.nrNodes)) return(INDEX_ERROR);
 
-   if (nodeListPtr[nodeIndex].boundary == nullptr || nodeListPtr[nodeIndex].boundary->Heat == nullptr)
+   if (myContext->nodeListPtr[nodeIndex].boundary == nullptr || myContext->nodeListPtr[nodeIndex].boundary->Heat == nullptr)
        return (BOUNDARY_ERROR);
 
-   nodeListPtr[nodeIndex].boundary->Heat->heightWind = myHeight;
+   myContext->nodeListPtr[nodeIndex].boundary->Heat->heightWind = myHeight;
 
    return(CRIT3D_OK);
 }
@@ -1161,13 +1256,13 @@ int DLL_EXPORT __STDCALL setHeatBoundaryHeightWind(long nodeIndex, double myHeig
  */
 int DLL_EXPORT __STDCALL setHeatBoundaryHeightTemperature(long nodeIndex, double myHeight)
 {
-   if (nodeListPtr == nullptr) return(MEMORY_ERROR);
-   if ((nodeIndex < 0) || (nodeIndex >= myStructure.nrNodes)) return(INDEX_ERROR);
+   if (myContext->nodeListPtr == nullptr) return(MEMORY_ERROR);
+   if ((nodeIndex < 0) || (nodeIndex >= myContext->myStructure.nrNodes)) return(INDEX_ERROR);
 
-   if (nodeListPtr[nodeIndex].boundary == nullptr || nodeListPtr[nodeIndex].boundary->Heat == nullptr)
+   if (myContext->nodeListPtr[nodeIndex].boundary == nullptr || myContext->nodeListPtr[nodeIndex].boundary->Heat == nullptr)
        return (BOUNDARY_ERROR);
 
-   nodeListPtr[nodeIndex].boundary->Heat->heightTemperature = myHeight;
+   myContext->nodeListPtr[nodeIndex].boundary->Heat->heightTemperature = myHeight;
 
    return(CRIT3D_OK);
 }
@@ -1179,11 +1274,11 @@ int DLL_EXPORT __STDCALL setHeatBoundaryHeightTemperature(long nodeIndex, double
 */
 double DLL_EXPORT __STDCALL getTemperature(long nodeIndex)
 {
-    if (nodeListPtr == nullptr) return(TOPOGRAPHY_ERROR);
-    if ((nodeIndex >= myStructure.nrNodes)) return(INDEX_ERROR);
+    if (myContext->nodeListPtr == nullptr) return(TOPOGRAPHY_ERROR);
+    if ((nodeIndex >= myContext->myStructure.nrNodes)) return(INDEX_ERROR);
     if (! isHeatNode(nodeIndex)) return (MEMORY_ERROR);
 
-    return (nodeListPtr[nodeIndex].extra->Heat->T);
+    return (myContext->nodeListPtr[nodeIndex].extra->Heat->T);
 }
 
 /*!
@@ -1193,11 +1288,11 @@ double DLL_EXPORT __STDCALL getTemperature(long nodeIndex)
  */
 double DLL_EXPORT __STDCALL getHeatConductivity(long nodeIndex)
 {
-    if (nodeListPtr == nullptr) return(TOPOGRAPHY_ERROR);
-    if ((nodeIndex >= myStructure.nrNodes)) return(INDEX_ERROR);
+    if (myContext->nodeListPtr == nullptr) return(TOPOGRAPHY_ERROR);
+    if ((nodeIndex >= myContext->myStructure.nrNodes)) return(INDEX_ERROR);
     if (! isHeatNode(nodeIndex)) return (MEMORY_ERROR);
 
-   return SoilHeatConductivity(nodeIndex, nodeListPtr[nodeIndex].extra->Heat->T, nodeListPtr[nodeIndex].H - nodeListPtr[nodeIndex].z);
+   return SoilHeatConductivity(nodeIndex, myContext->nodeListPtr[nodeIndex].extra->Heat->T, myContext->nodeListPtr[nodeIndex].H - myContext->nodeListPtr[nodeIndex].z);
 }
 
 /*!
@@ -1208,8 +1303,8 @@ double DLL_EXPORT __STDCALL getHeatConductivity(long nodeIndex)
 */
 float DLL_EXPORT __STDCALL getHeatFlux(long nodeIndex, short myDirection, int fluxType)
 {
-    if (nodeListPtr == nullptr) return(TOPOGRAPHY_ERROR);
-    if ((nodeIndex >= myStructure.nrNodes)) return(INDEX_ERROR);
+    if (myContext->nodeListPtr == nullptr) return(TOPOGRAPHY_ERROR);
+    if ((nodeIndex >= myContext->myStructure.nrNodes)) return(INDEX_ERROR);
     if (! isHeatNode(nodeIndex)) return (MEMORY_ERROR);
 
     float myMaxFlux = 0.;
@@ -1217,15 +1312,15 @@ float DLL_EXPORT __STDCALL getHeatFlux(long nodeIndex, short myDirection, int fl
     switch (myDirection)
     {
     case UP:
-        return readHeatFlux(&(nodeListPtr[nodeIndex].up), fluxType);
+        return readHeatFlux(&(myContext->nodeListPtr[nodeIndex].up), fluxType);
 
     case DOWN:
-        return readHeatFlux(&(nodeListPtr[nodeIndex].down), fluxType);
+        return readHeatFlux(&(myContext->nodeListPtr[nodeIndex].down), fluxType);
 
     case LATERAL:
-        for (short i = 0; i < myStructure.nrLateralLinks; i++)
+        for (short i = 0; i < myContext->myStructure.nrLateralLinks; i++)
         {
-            float myFlux = readHeatFlux(&(nodeListPtr[nodeIndex].lateral[i]), fluxType);
+            float myFlux = readHeatFlux(&(myContext->nodeListPtr[nodeIndex].lateral[i]), fluxType);
             if (myFlux != NODATA && myFlux > fabs(myMaxFlux))
                 myMaxFlux = myFlux;
         }
@@ -1242,14 +1337,14 @@ float DLL_EXPORT __STDCALL getHeatFlux(long nodeIndex, short myDirection, int fl
 */
 double DLL_EXPORT __STDCALL getBoundarySensibleFlux(long nodeIndex)
 {
-    if (nodeListPtr == nullptr) return (TOPOGRAPHY_ERROR);
-    if (nodeIndex >= myStructure.nrNodes) return (INDEX_ERROR);
-    if (! myStructure.computeHeat) return (MISSING_DATA_ERROR);
-    if (nodeListPtr[nodeIndex].boundary == nullptr) return (INDEX_ERROR);
-    if (nodeListPtr[nodeIndex].boundary->type != BOUNDARY_HEAT_SURFACE) return (INDEX_ERROR);
+    if (myContext->nodeListPtr == nullptr) return (TOPOGRAPHY_ERROR);
+    if (nodeIndex >= myContext->myStructure.nrNodes) return (INDEX_ERROR);
+    if (! myContext->myStructure.computeHeat) return (MISSING_DATA_ERROR);
+    if (myContext->nodeListPtr[nodeIndex].boundary == nullptr) return (INDEX_ERROR);
+    if (myContext->nodeListPtr[nodeIndex].boundary->type != BOUNDARY_HEAT_SURFACE) return (INDEX_ERROR);
 
     // boundary sensible heat flow density
-    return (nodeListPtr[nodeIndex].boundary->Heat->sensibleFlux);
+    return (myContext->nodeListPtr[nodeIndex].boundary->Heat->sensibleFlux);
 }
 
 
@@ -1260,14 +1355,14 @@ double DLL_EXPORT __STDCALL getBoundarySensibleFlux(long nodeIndex)
 */
 double DLL_EXPORT __STDCALL getBoundaryLatentFlux(long nodeIndex)
 {
-    if (nodeListPtr == nullptr) return (TOPOGRAPHY_ERROR);
-    if (nodeIndex >= myStructure.nrNodes) return (INDEX_ERROR);
-    if (! myStructure.computeHeat || ! myStructure.computeWater || ! myStructure.computeHeatVapor) return (MISSING_DATA_ERROR);
-    if (nodeListPtr[nodeIndex].boundary == nullptr) return (INDEX_ERROR);
-    if (nodeListPtr[nodeIndex].boundary->type != BOUNDARY_HEAT_SURFACE) return (INDEX_ERROR);
+    if (myContext->nodeListPtr == nullptr) return (TOPOGRAPHY_ERROR);
+    if (nodeIndex >= myContext->myStructure.nrNodes) return (INDEX_ERROR);
+    if (! myContext->myStructure.computeHeat || ! myContext->myStructure.computeWater || ! myContext->myStructure.computeHeatVapor) return (MISSING_DATA_ERROR);
+    if (myContext->nodeListPtr[nodeIndex].boundary == nullptr) return (INDEX_ERROR);
+    if (myContext->nodeListPtr[nodeIndex].boundary->type != BOUNDARY_HEAT_SURFACE) return (INDEX_ERROR);
 
     // boundary latent heat flow density
-    return (nodeListPtr[nodeIndex].boundary->Heat->latentFlux);
+    return (myContext->nodeListPtr[nodeIndex].boundary->Heat->latentFlux);
 }
 
 /*!
@@ -1277,15 +1372,15 @@ double DLL_EXPORT __STDCALL getBoundaryLatentFlux(long nodeIndex)
 */
 double DLL_EXPORT __STDCALL getBoundaryAdvectiveFlux(long nodeIndex)
 {
-    if (nodeListPtr == nullptr) return (TOPOGRAPHY_ERROR);
-    if (nodeIndex >= myStructure.nrNodes) return (INDEX_ERROR);
-    if (! myStructure.computeHeat || ! myStructure.computeWater || ! myStructure.computeHeatAdvection) return (MISSING_DATA_ERROR);
-    if (nodeListPtr[nodeIndex].boundary == nullptr) return (BOUNDARY_ERROR);
-    if (nodeListPtr[nodeIndex].boundary->Heat == nullptr) return (BOUNDARY_ERROR);
-    if (nodeListPtr[nodeIndex].boundary->type != BOUNDARY_HEAT_SURFACE) return (BOUNDARY_ERROR);
+    if (myContext->nodeListPtr == nullptr) return (TOPOGRAPHY_ERROR);
+    if (nodeIndex >= myContext->myStructure.nrNodes) return (INDEX_ERROR);
+    if (! myContext->myStructure.computeHeat || ! myContext->myStructure.computeWater || ! myContext->myStructure.computeHeatAdvection) return (MISSING_DATA_ERROR);
+    if (myContext->nodeListPtr[nodeIndex].boundary == nullptr) return (BOUNDARY_ERROR);
+    if (myContext->nodeListPtr[nodeIndex].boundary->Heat == nullptr) return (BOUNDARY_ERROR);
+    if (myContext->nodeListPtr[nodeIndex].boundary->type != BOUNDARY_HEAT_SURFACE) return (BOUNDARY_ERROR);
 
     // boundary advective heat flow density
-    return (nodeListPtr[nodeIndex].boundary->Heat->advectiveHeatFlux);
+    return (myContext->nodeListPtr[nodeIndex].boundary->Heat->advectiveHeatFlux);
 }
 
 /*!
@@ -1295,14 +1390,14 @@ double DLL_EXPORT __STDCALL getBoundaryAdvectiveFlux(long nodeIndex)
 */
 double DLL_EXPORT __STDCALL getBoundaryRadiativeFlux(long nodeIndex)
 {
-    if (nodeListPtr == nullptr) return (TOPOGRAPHY_ERROR);
-    if (nodeIndex >= myStructure.nrNodes) return (INDEX_ERROR);
-    if (! myStructure.computeHeat) return (MISSING_DATA_ERROR);
-    if (nodeListPtr[nodeIndex].boundary == nullptr) return (INDEX_ERROR);
-    if (nodeListPtr[nodeIndex].boundary->type != BOUNDARY_HEAT_SURFACE) return (INDEX_ERROR);
+    if (myContext->nodeListPtr == nullptr) return (TOPOGRAPHY_ERROR);
+    if (nodeIndex >= myContext->myStructure.nrNodes) return (INDEX_ERROR);
+    if (! myContext->myStructure.computeHeat) return (MISSING_DATA_ERROR);
+    if (myContext->nodeListPtr[nodeIndex].boundary == nullptr) return (INDEX_ERROR);
+    if (myContext->nodeListPtr[nodeIndex].boundary->type != BOUNDARY_HEAT_SURFACE) return (INDEX_ERROR);
 
     // boundary net radiative heat flow density
-    return (nodeListPtr[nodeIndex].boundary->Heat->radiativeFlux);
+    return (myContext->nodeListPtr[nodeIndex].boundary->Heat->radiativeFlux);
 }
 
 /*!
@@ -1312,14 +1407,14 @@ double DLL_EXPORT __STDCALL getBoundaryRadiativeFlux(long nodeIndex)
 */
 double DLL_EXPORT __STDCALL getBoundaryAerodynamicConductance(long nodeIndex)
 {
-    if (nodeListPtr == nullptr) return (TOPOGRAPHY_ERROR);
-    if (nodeIndex >= myStructure.nrNodes) return (INDEX_ERROR);
-    if (! myStructure.computeHeat) return (MISSING_DATA_ERROR);
-    if (nodeListPtr[nodeIndex].boundary == nullptr) return (INDEX_ERROR);
-    if (nodeListPtr[nodeIndex].boundary->type != BOUNDARY_HEAT_SURFACE) return (INDEX_ERROR);
+    if (myContext->nodeListPtr == nullptr) return (TOPOGRAPHY_ERROR);
+    if (nodeIndex >= myContext->myStructure.nrNodes) return (INDEX_ERROR);
+    if (! myContext->myStructure.computeHeat) return (MISSING_DATA_ERROR);
+    if (myContext->nodeListPtr[nodeIndex].boundary == nullptr) return (INDEX_ERROR);
+    if (myContext->nodeListPtr[nodeIndex].boundary->type != BOUNDARY_HEAT_SURFACE) return (INDEX_ERROR);
 
     // boundary aerodynamic resistance
-    return (nodeListPtr[nodeIndex].boundary->Heat->aerodynamicConductance);
+    return (myContext->nodeListPtr[nodeIndex].boundary->Heat->aerodynamicConductance);
 }
 
 
@@ -1350,14 +1445,14 @@ double DLL_EXPORT getBoundaryAerodynamicConductanceOpenWater(long nodeIndex)
 */
 double DLL_EXPORT __STDCALL getBoundarySoilConductance(long nodeIndex)
 {
-    if (nodeListPtr == nullptr) return (TOPOGRAPHY_ERROR);
-    if (nodeIndex >= myStructure.nrNodes) return (INDEX_ERROR);
-    if (! myStructure.computeHeat) return (MISSING_DATA_ERROR);
-    if (nodeListPtr[nodeIndex].boundary == nullptr) return (INDEX_ERROR);
-    if (nodeListPtr[nodeIndex].boundary->type != BOUNDARY_HEAT_SURFACE) return (INDEX_ERROR);
+    if (myContext->nodeListPtr == nullptr) return (TOPOGRAPHY_ERROR);
+    if (nodeIndex >= myContext->myStructure.nrNodes) return (INDEX_ERROR);
+    if (! myContext->myStructure.computeHeat) return (MISSING_DATA_ERROR);
+    if (myContext->nodeListPtr[nodeIndex].boundary == nullptr) return (INDEX_ERROR);
+    if (myContext->nodeListPtr[nodeIndex].boundary->type != BOUNDARY_HEAT_SURFACE) return (INDEX_ERROR);
 
     // boundary soil conductance
-    return (nodeListPtr[nodeIndex].boundary->Heat->soilConductance);
+    return (myContext->nodeListPtr[nodeIndex].boundary->Heat->soilConductance);
 }
 
 /*!
@@ -1367,12 +1462,12 @@ double DLL_EXPORT __STDCALL getBoundarySoilConductance(long nodeIndex)
 */
 double DLL_EXPORT __STDCALL getNodeVapor(long i)
 {
-    if (nodeListPtr == nullptr) return(TOPOGRAPHY_ERROR);
-    if (i >= myStructure.nrNodes) return(INDEX_ERROR);
-    if (! myStructure.computeHeat || ! myStructure.computeWater || ! myStructure.computeHeatVapor) return (MISSING_DATA_ERROR);
+    if (myContext->nodeListPtr == nullptr) return(TOPOGRAPHY_ERROR);
+    if (i >= myContext->myStructure.nrNodes) return(INDEX_ERROR);
+    if (! myContext->myStructure.computeHeat || ! myContext->myStructure.computeWater || ! myContext->myStructure.computeHeatVapor) return (MISSING_DATA_ERROR);
 
-    double h = nodeListPtr[i].H - nodeListPtr[i].z;
-    double T = nodeListPtr[i].extra->Heat->T;
+    double h = myContext->nodeListPtr[i].H - myContext->nodeListPtr[i].z;
+    double T = myContext->nodeListPtr[i].extra->Heat->T;
 
     return VaporFromPsiTemp(h, T);
 }
@@ -1384,18 +1479,18 @@ double DLL_EXPORT __STDCALL getNodeVapor(long i)
 */
 double DLL_EXPORT __STDCALL getHeat(long i, double h)
 {
-    if (nodeListPtr == nullptr) return(TOPOGRAPHY_ERROR);
-    if (i >= myStructure.nrNodes) return(INDEX_ERROR);
-    if (! myStructure.computeHeat) return (MISSING_DATA_ERROR);
-    if (nodeListPtr[i].extra->Heat == nullptr) return MISSING_DATA_ERROR;
-    if (nodeListPtr[i].extra->Heat->T == NODATA) return MISSING_DATA_ERROR;
+    if (myContext->nodeListPtr == nullptr) return(TOPOGRAPHY_ERROR);
+    if (i >= myContext->myStructure.nrNodes) return(INDEX_ERROR);
+    if (! myContext->myStructure.computeHeat) return (MISSING_DATA_ERROR);
+    if (myContext->nodeListPtr[i].extra->Heat == nullptr) return MISSING_DATA_ERROR;
+    if (myContext->nodeListPtr[i].extra->Heat->T == NODATA) return MISSING_DATA_ERROR;
 
-    double myHeat = SoilHeatCapacity(i, h, nodeListPtr[i].extra->Heat->T) * nodeListPtr[i].volume_area  * nodeListPtr[i].extra->Heat->T;
+    double myHeat = SoilHeatCapacity(i, h, myContext->nodeListPtr[i].extra->Heat->T) * myContext->nodeListPtr[i].volume_area  * myContext->nodeListPtr[i].extra->Heat->T;
 
-    if (myStructure.computeWater && myStructure.computeHeatVapor)
+    if (myContext->myStructure.computeWater && myContext->myStructure.computeHeatVapor)
     {
-        double thetaV = VaporThetaV(h, nodeListPtr[i].extra->Heat->T, i);
-        myHeat += thetaV * latentHeatVaporization(nodeListPtr[i].extra->Heat->T - ZEROCELSIUS) * WATER_DENSITY * nodeListPtr[i].volume_area;
+        double thetaV = VaporThetaV(h, myContext->nodeListPtr[i].extra->Heat->T, i);
+        myHeat += thetaV * latentHeatVaporization(myContext->nodeListPtr[i].extra->Heat->T - ZEROCELSIUS) * WATER_DENSITY * myContext->nodeListPtr[i].volume_area;
     }
 
     return (myHeat);
@@ -42,7 +42,7 @@
      */
 	double theta_from_Se (unsigned long myIndex)
 	{
-        return ((nodeListPtr[myIndex].Se * (nodeListPtr[myIndex].Soil->Theta_s - nodeListPtr[myIndex].Soil->Theta_r)) + nodeListPtr[myIndex].Soil->Theta_r);
+        return ((myContext->nodeListPtr[myIndex].Se * (myContext->nodeListPtr[myIndex].Soil->Theta_s - myContext->nodeListPtr[myIndex].Soil->Theta_r)) + myContext->nodeListPtr[myIndex].Soil->Theta_r);
 	}
 
     /*!
@@ -53,7 +53,7 @@
      */
 	double theta_from_Se (double Se, unsigned long myIndex)
 	{
-        return ((Se * (nodeListPtr[myIndex].Soil->Theta_s - nodeListPtr[myIndex].Soil->Theta_r)) + nodeListPtr[myIndex].Soil->Theta_r);
+        return ((Se * (myContext->nodeListPtr[myIndex].Soil->Theta_s - myContext->nodeListPtr[myIndex].Soil->Theta_r)) + myContext->nodeListPtr[myIndex].Soil->Theta_r);
 	}
 
     /*!
@@ -64,16 +64,16 @@
      */
     double theta_from_sign_Psi (double signPsi, unsigned long index)
 	{
-        if (nodeListPtr[index].isSurface) return 1.;
+        if (myContext->nodeListPtr[index].isSurface) return 1.;
 
         if (signPsi >= 0.0)
         {
             // saturated
-            return nodeListPtr[index].Soil->Theta_s;
+            return myContext->nodeListPtr[index].Soil->Theta_s;
         }
 		else
         {
-            double Se = computeSefromPsi_unsat(fabs(signPsi),nodeListPtr[index].Soil);
+            double Se = computeSefromPsi_unsat(fabs(signPsi),myContext->nodeListPtr[index].Soil);
             return theta_from_Se(Se, index);
         }
 	}
@@ -88,9 +88,9 @@
 	double Se_from_theta (unsigned long myIndex, double theta)
 	{
         /*! check range */
-        if (theta >= nodeListPtr[myIndex].Soil->Theta_s) return(1.);
-        else if (theta <= nodeListPtr[myIndex].Soil->Theta_r) return(0.);
-        else return ((theta - nodeListPtr[myIndex].Soil->Theta_r) / (nodeListPtr[myIndex].Soil->Theta_s - nodeListPtr[myIndex].Soil->Theta_r));
+        if (theta >= myContext->nodeListPtr[myIndex].Soil->Theta_s) return(1.);
+        else if (theta <= myContext->nodeListPtr[myIndex].Soil->Theta_r) return(0.);
+        else return ((theta - myContext->nodeListPtr[myIndex].Soil->Theta_r) / (myContext->nodeListPtr[myIndex].Soil->Theta_s - myContext->nodeListPtr[myIndex].Soil->Theta_r));
 	}
 
     /*!
@@ -102,9 +102,12 @@
      */
     double computeSefromPsi_unsat(double myPsi, Tsoil *mySoil)
 	{
+        if (mySoil->tableSe.isInitialized() && mySoil->tableSe.isInside(myPsi))
+            return mySoil->tableSe.getValue(myPsi);
+
 		double Se = NODATA;
 
-        if (myParameters.waterRetentionCurve == MODIFIEDVANGENUCHTEN)
+        if (myContext->myParameters.waterRetentionCurve == MODIFIEDVANGENUCHTEN)
         {
             if (myPsi <=  mySoil->VG_he)
             {
@@ -116,7 +119,7 @@
                 Se *= (1. / mySoil->VG_Sc);
             }
         }
-        else if (myParameters.waterRetentionCurve == VANGENUCHTEN)
+        else if (myContext->myParameters.waterRetentionCurve == VANGENUCHTEN)
         {
             Se = pow(1. + pow(mySoil->VG_alpha * myPsi, mySoil->VG_n), - mySoil->VG_m);
         }
@@ -131,7 +134,7 @@
      */
     double computeSe(unsigned long myIndex)
     {
-        if (nodeListPtr[myIndex].H >= nodeListPtr[myIndex].z)
+        if (myContext->nodeListPtr[myIndex].H >= myContext->nodeListPtr[myIndex].z)
         {
             // saturated
             return 1.;
@@ -139,8 +142,8 @@
         else
         {
             // unsaturated
-            double psi = fabs(nodeListPtr[myIndex].H - nodeListPtr[myIndex].z);   /*!< [m] */
-            return computeSefromPsi_unsat(psi, nodeListPtr[myIndex].Soil);
+            double psi = fabs(myContext->nodeListPtr[myIndex].H - myContext->nodeListPtr[myIndex].z);   /*!< [m] */
+            return computeSefromPsi_unsat(psi, myContext->nodeListPtr[myIndex].Soil);
         }
     }
 
@@ -158,12 +161,12 @@
 		if (Se >= 1.) return(mySoil->K_sat );
 
 		double myTmp = NODATA;
-        if (myParameters.waterRetentionCurve == MODIFIEDVANGENUCHTEN)
+        if (myContext->myParameters.waterRetentionCurve == MODIFIEDVANGENUCHTEN)
 		{
 			double myNumerator = 1. - pow(1. - pow(Se*mySoil->VG_Sc, 1./mySoil->VG_m), mySoil->VG_m);
 			myTmp = myNumerator / (1. - pow(1. - pow(mySoil->VG_Sc, 1./mySoil->VG_m), mySoil->VG_m));
 		}
-        else if (myParameters.waterRetentionCurve == VANGENUCHTEN)
+        else if (myContext->myParameters.waterRetentionCurve == VANGENUCHTEN)
 			myTmp = 1. - pow(1. - pow(Se, 1./mySoil->VG_m), mySoil->VG_m);
 
 		return (mySoil->K_sat * pow(Se, mySoil->Mualem_L) * pow(myTmp , 2.));
@@ -187,12 +190,12 @@
 		if (Se >= 1.) return(Ksat);
 		double temp= NODATA;
 
-        if (myParameters.waterRetentionCurve == MODIFIEDVANGENUCHTEN)
+        if (myContext->myParameters.waterRetentionCurve == MODIFIEDVANGENUCHTEN)
         {
             double num = 1. - pow(1. - pow(Se*VG_Sc, 1./VG_m), VG_m);
             temp = num / (1. - pow(1. - pow(VG_Sc, 1./VG_m), VG_m));
         }
-        else if (myParameters.waterRetentionCurve == VANGENUCHTEN)
+        else if (myContext->myParameters.waterRetentionCurve == VANGENUCHTEN)
         {
 			temp = 1. - pow(1. - pow(Se, 1./VG_m), VG_m);
         }
@@ -208,15 +211,25 @@
      */
     double computeK(unsigned long myIndex)
     {
-        double k = compute_K_Mualem(nodeListPtr[myIndex].Soil->K_sat, nodeListPtr[myIndex].Se,
-                                nodeListPtr[myIndex].Soil->VG_Sc, nodeListPtr[myIndex].Soil->VG_m,
-                                nodeListPtr[myIndex].Soil->Mualem_L);
+        double k;
+        Tsoil *mySoil = myContext->nodeListPtr[myIndex].Soil;
+        double psi = myContext->nodeListPtr[myIndex].z - myContext->nodeListPtr[myIndex].H;     /*!< [m] */
+
+        if (psi > 0 && mySoil->tableK.isInitialized() && mySoil->tableK.isInside(psi))
+        {
+            k = mySoil->tableK.getValue(psi);
+        }
+        else
+        {
+            k = compute_K_Mualem(mySoil->K_sat, myContext->nodeListPtr[myIndex].Se,
+                                 mySoil->VG_Sc, mySoil->VG_m, mySoil->Mualem_L);
+        }
 
         // vapor isothermal flow
-        if (myStructure.computeHeat && myStructure.computeHeatVapor)
+        if (myContext->myStructure.computeHeat && myContext->myStructure.computeHeatVapor)
         {
             double avgT = getTMean(myIndex);
-            double kv = IsothermalVaporConductivity(myIndex, nodeListPtr[myIndex].H - nodeListPtr[myIndex].z, avgT);
+            double kv = IsothermalVaporConductivity(myIndex, myContext->nodeListPtr[myIndex].H - myContext->nodeListPtr[myIndex].z, avgT);
             // from kg s m-3 to m s-1
             kv *= (GRAVITY / WATER_DENSITY);
 
@@ -227,6 +240,59 @@
     }
 
 
+    void clearHydraulicTables(Tsoil *mySoil)
+    {
+        mySoil->tableSe.clear();
+        mySoil->tableK.clear();
+        mySoil->tableDSe.clear();
+    }
+
+
+    /*!
+     * \brief Computes the lookup tables of Se, K and dSe/dpsi of a soil horizon
+     * as functions of |psi| from the air-entry potential (1 mm for VG) to HYDRAULIC_TABLE_MAX_PSI;
+     * outside this range and if a table cannot be computed the formulas are used
+     * \param mySoil
+     * \param maxError: error bound (absolute for Se, relative for K and dSe/dpsi)
+     * \return false if a table is not computed
+     */
+    bool computeHydraulicTables(Tsoil *mySoil, double maxError)
+    {
+        clearHydraulicTables(mySoil);
+
+        double psiMin = HYDRAULIC_TABLE_MIN_PSI;
+        if (myContext->myParameters.waterRetentionCurve == MODIFIEDVANGENUCHTEN)
+            psiMin = MAXVALUE(mySoil->VG_he, psiMin);
+
+        double alpha = mySoil->VG_alpha;
+        double n = mySoil->VG_n;
+        double m = mySoil->VG_m;
+        double Sc = (myContext->myParameters.waterRetentionCurve == MODIFIEDVANGENUCHTEN) ? mySoil->VG_Sc : 1.;
+
+        // Mualem: 1-(1-x)^m is computed as -expm1(m*log1p(-x)), without cancellation in dry soil
+        double kDenominator = -expm1(m * log1p(-pow(Sc, 1./m)));
+        auto conductivity = [=](double psi)
+        {
+            double Se = computeSefromPsi_unsat(psi, mySoil);
+            double kRelative = -expm1(m * log1p(-pow(Se * Sc, 1./m))) / kDenominator;
+            return mySoil->K_sat * pow(Se, mySoil->Mualem_L) * kRelative * kRelative;
+        };
+
+        auto dSe_dpsi = [=](double psi)
+        {
+            return alpha * n * m * pow(1. + pow(alpha * psi, n), -(m + 1.)) * pow(alpha * psi, n - 1.) / Sc;
+        };
+
+        // the Se table is the last one: the other tables use the formula of Se
+        bool isOk = mySoil->tableK.initialize(conductivity, psiMin, HYDRAULIC_TABLE_MAX_PSI, maxError, true);
+        isOk &= mySoil->tableDSe.initialize(dSe_dpsi, psiMin, HYDRAULIC_TABLE_MAX_PSI, maxError, true);
+        isOk &= mySoil->tableSe.initialize([=](double psi) { return computeSefromPsi_unsat(psi, mySoil); },
+                                           psiMin, HYDRAULIC_TABLE_MAX_PSI, maxError, false);
+
+        return isOk;
+    }
+
+
     /*!
      * \brief Computes Water Potential from degree of saturation
      * \param myIndex
@@ -234,15 +300,15 @@
      */
     double psi_from_Se(unsigned long myIndex)
 	{
-        double m = nodeListPtr[myIndex].Soil->VG_m;
+        double m = myContext->nodeListPtr[myIndex].Soil->VG_m;
 		double temp = NODATA;
 
-        if (myParameters.waterRetentionCurve == MODIFIEDVANGENUCHTEN)
-                temp = pow(1./ (nodeListPtr[myIndex].Se * nodeListPtr[myIndex].Soil->VG_Sc) , 1./ m ) - 1.;
-        else if (myParameters.waterRetentionCurve == VANGENUCHTEN)
-                temp = pow(1./ nodeListPtr[myIndex].Se, 1./ m ) - 1.;
+        if (myContext->myParameters.waterRetentionCurve == MODIFIEDVANGENUCHTEN)
+                temp = pow(1./ (myContext->nodeListPtr[myIndex].Se * myContext->nodeListPtr[myIndex].Soil->VG_Sc) , 1./ m ) - 1.;
+        else if (myContext->myParameters.waterRetentionCurve == VANGENUCHTEN)
+                temp = pow(1./ myContext->nodeListPtr[myIndex].Se, 1./ m ) - 1.;
 
-        return((1./ nodeListPtr[myIndex].Soil->VG_alpha) * pow(temp, 1./ nodeListPtr[myIndex].Soil->VG_n));
+        return((1./ myContext->nodeListPtr[myIndex].Soil->VG_alpha) * pow(temp, 1./ myContext->nodeListPtr[myIndex].Soil->VG_n));
 	}
 
     /*!
@@ -252,13 +318,13 @@
      */
     double dThetav_dH(unsigned long i, double temperature, double dTheta_dH)
     {
-        double h = nodeListPtr[i].H - nodeListPtr[i].z;
+        double h = myContext->nodeListPtr[i].H - myContext->nodeListPtr[i].z;
         double hr = SoilRelativeHumidity(h, temperature);
         double satVapPressure = saturationVaporPressure(temperature - ZEROCELSIUS);
         double satVapConc = vaporConcentrationFromPressure(satVapPressure, temperature);
         double theta = theta_from_sign_Psi(h, i);
         double dThetav_dPsi = (satVapConc * hr / WATER_DENSITY) *
-                ((nodeListPtr[i].Soil->Theta_s - theta) * MH2O / (R_GAS * temperature) - dTheta_dH / GRAVITY);
+                ((myContext->nodeListPtr[i].Soil->Theta_s - theta) * MH2O / (R_GAS * temperature) - dTheta_dH / GRAVITY);
         return dThetav_dPsi * GRAVITY;
     }
 
@@ -272,20 +338,20 @@
      */
 	double dTheta_dH(unsigned long myIndex)
     {
-        double alfa = nodeListPtr[myIndex].Soil->VG_alpha;
-        double n    = nodeListPtr[myIndex].Soil->VG_n;
-        double m    = nodeListPtr[myIndex].Soil->VG_m;
+        double alfa = myContext->nodeListPtr[myIndex].Soil->VG_alpha;
+        double n    = myContext->nodeListPtr[myIndex].Soil->VG_n;
+        double m    = myContext->nodeListPtr[myIndex].Soil->VG_m;
 
-        double psi_abs = fabs(MINVALUE(nodeListPtr[myIndex].H - nodeListPtr[myIndex].z, 0.));
-        double psiPrevious_abs = fabs(MINVALUE(nodeListPtr[myIndex].oldH - nodeListPtr[myIndex].z, 0.));
+        double psi_abs = fabs(MINVALUE(myContext->nodeListPtr[myIndex].H - myContext->nodeListPtr[myIndex].z, 0.));
+        double psiPrevious_abs = fabs(MINVALUE(myContext->nodeListPtr[myIndex].oldH - myContext->nodeListPtr[myIndex].z, 0.));
 
-        if (myParameters.waterRetentionCurve == MODIFIEDVANGENUCHTEN)
+        if (myContext->myParameters.waterRetentionCurve == MODIFIEDVANGENUCHTEN)
         {
             // saturated
-            if ((psi_abs <= nodeListPtr[myIndex].Soil->VG_he) && (psiPrevious_abs <= nodeListPtr[myIndex].Soil->VG_he)) return 0.;
+            if ((psi_abs <= myContext->nodeListPtr[myIndex].Soil->VG_he) && (psiPrevious_abs <= myContext->nodeListPtr[myIndex].Soil->VG_he)) return 0.;
         }
 
-        if (myParameters.waterRetentionCurve == VANGENUCHTEN)
+        if (myContext->myParameters.waterRetentionCurve == VANGENUCHTEN)
         {
             if ((psi_abs == 0.) && (psiPrevious_abs == 0.)) return 0.;
         }
@@ -294,21 +360,25 @@
 
         if (psi_abs == psiPrevious_abs)
         {
+            Tsoil *mySoil = myContext->nodeListPtr[myIndex].Soil;
+            if (mySoil->tableDSe.isInitialized() && mySoil->tableDSe.isInside(psi_abs))
+                return mySoil->tableDSe.getValue(psi_abs) * (mySoil->Theta_s - mySoil->Theta_r);
+
             dSe_dH = alfa * n * m * pow(1. + pow(alfa * psi_abs, n), -(m + 1.)) * pow(alfa * psi_abs, n - 1.);
-            if (myParameters.waterRetentionCurve == MODIFIEDVANGENUCHTEN)
+            if (myContext->myParameters.waterRetentionCurve == MODIFIEDVANGENUCHTEN)
             {
-                dSe_dH *= (1. / nodeListPtr[myIndex].Soil->VG_Sc);
+                dSe_dH *= (1. / myContext->nodeListPtr[myIndex].Soil->VG_Sc);
             }
         }
         else
         {
-            double theta = computeSefromPsi_unsat(psi_abs, nodeListPtr[myIndex].Soil);
-            double thetaPrevious = computeSefromPsi_unsat(psiPrevious_abs, nodeListPtr[myIndex].Soil);
-            double delta_H = nodeListPtr[myIndex].H - nodeListPtr[myIndex].oldH;
+            double theta = computeSefromPsi_unsat(psi_abs, myContext->nodeListPtr[myIndex].Soil);
+            double thetaPrevious = computeSefromPsi_unsat(psiPrevious_abs, myContext->nodeListPtr[myIndex].Soil);
+            double delta_H = myContext->nodeListPtr[myIndex].H - myContext->nodeListPtr[myIndex].oldH;
             dSe_dH = fabs((theta - thetaPrevious) / delta_H);
         }
 
-        return dSe_dH * (nodeListPtr[myIndex].Soil->Theta_s - nodeListPtr[myIndex].Soil->Theta_r);
+        return dSe_dH * (myContext->nodeListPtr[myIndex].Soil->Theta_s - myContext->nodeListPtr[myIndex].Soil->Theta_r);
     }
 
 
@@ -316,9 +386,9 @@
 	{
         double myHMean = getHMean(i);
 
-        if (nodeListPtr[i].isSurface)
+        if (myContext->nodeListPtr[i].isSurface)
 		{
-            double mySurfaceWater = MAXVALUE(myHMean - nodeListPtr[i].z, 0.);		//[m]
+            double mySurfaceWater = MAXVALUE(myHMean - myContext->nodeListPtr[i].z, 0.);		//[m]
             return (MINVALUE(mySurfaceWater / 0.01, 1.));
 		}
 		else
@@ -330,14 +400,14 @@
 
     double getTheta(long i, double H)
     {
-        double psi = H - nodeListPtr[i].z;
+        double psi = H - myContext->nodeListPtr[i].z;
         return (theta_from_sign_Psi(psi, i));
     }
 
     double getTMean(long i)
     {
-        if (myStructure.computeHeat && nodeListPtr[i].extra->Heat != nullptr)
-            return arithmeticMean(nodeListPtr[i].extra->Heat->oldT, nodeListPtr[i].extra->Heat->T);
+        if (myContext->myStructure.computeHeat && myContext->nodeListPtr[i].extra->Heat != nullptr)
+            return arithmeticMean(myContext->nodeListPtr[i].extra->Heat->oldT, myContext->nodeListPtr[i].extra->Heat->T);
         else
             return NODATA;
     }
@@ -345,14 +415,14 @@
     double getHMean(long i)
     {
         // is there any efficient way to compute a geometric mean of H?
-        return arithmeticMean(nodeListPtr[i].oldH, nodeListPtr[i].H);
+        return arithmeticMean(myContext->nodeListPtr[i].oldH, myContext->nodeListPtr[i].H);
     }
 
     double getPsiMean(long i)
 	{
         double Psi;
         double meanH = getHMean(i);
-        Psi = MINVALUE(0., (meanH - nodeListPtr[i].z));
+        Psi = MINVALUE(0., (meanH - myContext->nodeListPtr[i].z));
         return Psi;
 	}
 
@@ -380,9 +450,9 @@
         double particleDensity;
         double totalPorosity;
 
-        particleDensity = ParticleDensity(nodeListPtr[i].Soil->organicMatter);
+        particleDensity = ParticleDensity(myContext->nodeListPtr[i].Soil->organicMatter);
 
-        totalPorosity = nodeListPtr[i].Soil->Theta_s;
+        totalPorosity = myContext->nodeListPtr[i].Soil->Theta_s;
 
         return (1. - totalPorosity) * particleDensity;
     }
@@ -28,23 +28,25 @@
 #include <math.h>
 #include <stdlib.h>
 
+#include <vector>
 #include "basicMath.h"
+#include "parallel.h"
 #include "header/types.h"
 #include "header/solver.h"
 
 
 double distance(unsigned long i, unsigned long j)
 {
-    return sqrt(square(fabs(double(nodeListPtr[i].x - nodeListPtr[j].x)))
-                + square(fabs(double(nodeListPtr[i].y - nodeListPtr[j].y)))
-                + square(fabs(double(nodeListPtr[i].z - nodeListPtr[j].z))));
+    return sqrt(square(fabs(double(myContext->nodeListPtr[i].x - myContext->nodeListPtr[j].x)))
+                + square(fabs(double(myContext->nodeListPtr[i].y - myContext->nodeListPtr[j].y)))
+                + square(fabs(double(myContext->nodeListPtr[i].z - myContext->nodeListPtr[j].z))));
 }
 
 
 double distance2D(unsigned long i, unsigned long j)
 {
-    return sqrt(square(fabs(double(nodeListPtr[i].x - nodeListPtr[j].x)))
-                + square(fabs(double(nodeListPtr[i].y - nodeListPtr[j].y))));
+    return sqrt(square(fabs(double(myContext->nodeListPtr[i].x - myContext->nodeListPtr[j].x)))
+                + square(fabs(double(myContext->nodeListPtr[i].y - myContext->nodeListPtr[j].y))));
 }
 
 double arithmeticMean(double v1, double v2)
@@ -72,9 +74,9 @@ double geometricMean(double v1, double v2)
 
 double computeMean(double v1, double v2)
 {
-    if (myParameters.meanType == MEAN_LOGARITHMIC)
+    if (myContext->myParameters.meanType == MEAN_LOGARITHMIC)
         return logarithmicMean(v1, v2);
-    else if (myParameters.meanType == MEAN_GEOMETRIC)
+    else if (myContext->myParameters.meanType == MEAN_GEOMETRIC)
         return geometricMean(v1, v2);
     else
         // default: logarithmic
@@ -84,16 +86,16 @@ double computeMean(double v1, double v2)
 
 TlinkedNode* getLink(long i, long j)
 {
-    if (nodeListPtr[i].up.index == j)
-        return &(nodeListPtr[i].up);
+    if (myContext->nodeListPtr[i].up.index == j)
+        return &(myContext->nodeListPtr[i].up);
 
-    if (nodeListPtr[i].down.index == j)
-        return &(nodeListPtr[i].down);
+    if (myContext->nodeListPtr[i].down.index == j)
+        return &(myContext->nodeListPtr[i].down);
 
-    for (short l = 0; l < myStructure.nrLateralLinks; l++)
+    for (short l = 0; l < myContext->myStructure.nrLateralLinks; l++)
     {
-         if (nodeListPtr[i].lateral[l].index == j)
-             return &(nodeListPtr[i].lateral[l]);
+         if (myContext->nodeListPtr[i].lateral[l].index == j)
+             return &(myContext->nodeListPtr[i].lateral[l]);
     }
 
     return nullptr;
@@ -102,12 +104,186 @@ TlinkedNode* getLink(long i, long j)
 
 int calcola_iterazioni_max(int num_approssimazione)
 {
-    float max_iterazioni = float(myParameters.iterazioni_max)
-                            / float(myParameters.maxApproximationsNumber) * float(num_approssimazione + 1);
+    float max_iterazioni = float(myContext->myParameters.iterazioni_max)
+                            / float(myContext->myParameters.maxApproximationsNumber) * float(num_approssimazione + 1);
     return MAXVALUE(20, int(max_iterazioni));
 }
 
 
+/*!
+ * \brief buildMatrixCSR
+ * copy the off-diagonal elements of A (rows closed by NOLINK) in compressed sparse row format
+ */
+void buildMatrixCSR()
+{
+    long nrNodes = myContext->myStructure.nrNodes;
+    std::vector<long> &rowStart = myContext->rowStart;
+    std::vector<long> &colIndex = myContext->colIndex;
+    std::vector<double> &colValue = myContext->colValue;
+
+    rowStart.resize(unsigned(nrNodes + 1));
+    colIndex.clear();
+    colValue.clear();
+
+    for (long i = 0; i < nrNodes; i++)
+    {
+        rowStart[unsigned(i)] = long(colIndex.size());
+        short j = 1;
+        while ((j < myContext->myStructure.maxNrColumns) && (myContext->A[i][j].index != NOLINK))
+        {
+            colIndex.push_back(myContext->A[i][j].index);
+            colValue.push_back(myContext->A[i][j].val);
+            j++;
+        }
+    }
+    rowStart[unsigned(nrNodes)] = long(colIndex.size());
+}
+
+
+/*!
+ * \brief buildColors
+ * greedy coloring of the graph of the node links: linked nodes have different colors,
+ * so the nodes of a color can be updated in parallel. The matrix elements are a subset
+ * of the links, so the coloring depends only on the structure: it is computed once
+ * and cleared when the links change (setNodeLink, cleanMemory)
+ */
+void buildColors()
+{
+    long nrNodes = myContext->myStructure.nrNodes;
+
+    // pattern of the links
+    std::vector<long> rowStart(unsigned(nrNodes + 1));
+    std::vector<long> colIndex;
+    for (long i = 0; i < nrNodes; i++)
+    {
+        rowStart[unsigned(i)] = long(colIndex.size());
+        if (myContext->nodeListPtr[i].up.index != NOLINK)
+            colIndex.push_back(myContext->nodeListPtr[i].up.index);
+        if (myContext->nodeListPtr[i].down.index != NOLINK)
+            colIndex.push_back(myContext->nodeListPtr[i].down.index);
+        for (int l = 0; l < myContext->myStructure.nrLateralLinks; l++)
+            if (myContext->nodeListPtr[i].lateral[l].index != NOLINK)
+                colIndex.push_back(myContext->nodeListPtr[i].lateral[l].index);
+    }
+    rowStart[unsigned(nrNodes)] = long(colIndex.size());
+
+    // transpose pattern (the matrix could be not symmetric)
+    std::vector<long> transposeStart(unsigned(nrNodes + 1), 0);
+    for (unsigned k = 0; k < colIndex.size(); k++)
+        transposeStart[unsigned(colIndex[k] + 1)]++;
+    for (long i = 0; i < nrNodes; i++)
+        transposeStart[unsigned(i + 1)] += transposeStart[unsigned(i)];
+
+    std::vector<long> transposeIndex(colIndex.size());
+    std::vector<long> position(transposeStart.begin(), transposeStart.end() - 1);
+    for (long i = 0; i < nrNodes; i++)
+        for (long k = rowStart[unsigned(i)]; k < rowStart[unsigned(i + 1)]; k++)
+            transposeIndex[unsigned(position[unsigned(colIndex[unsigned(k)])]++)] = i;
+
+    std::vector<int> color(unsigned(nrNodes), NODATA);
+    std::vector<long> lastUse;
+    int nrColors = 0;
+
+    for (long i = 0; i < nrNodes; i++)
+    {
+        for (long k = rowStart[unsigned(i)]; k < rowStart[unsigned(i + 1)]; k++)
+        {
+            int c = color[unsigned(colIndex[unsigned(k)])];
+            if (c != NODATA) lastUse[unsigned(c)] = i;
+        }
+        for (long k = transposeStart[unsigned(i)]; k < transposeStart[unsigned(i + 1)]; k++)
+        {
+            int c = color[unsigned(transposeIndex[unsigned(k)])];
+            if (c != NODATA) lastUse[unsigned(c)] = i;
+        }
+
+        int c = 0;
+        while (c < nrColors && lastUse[unsigned(c)] == i) c++;
+        if (c == nrColors)
+        {
+            lastUse.push_back(NODATA);
+            nrColors++;
+        }
+        color[unsigned(i)] = c;
+    }
+
+    // nodes sorted by color
+    myContext->colorStart.assign(unsigned(nrColors + 1), 0);
+    for (long i = 0; i < nrNodes; i++)
+        myContext->colorStart[unsigned(color[unsigned(i)] + 1)]++;
+    for (int c = 0; c < nrColors; c++)
+        myContext->colorStart[unsigned(c + 1)] += myContext->colorStart[unsigned(c)];
+
+    myContext->colorNodes.resize(unsigned(nrNodes));
+    std::vector<long> colorPosition(myContext->colorStart.begin(), myContext->colorStart.end() - 1);
+    for (long i = 0; i < nrNodes; i++)
+        myContext->colorNodes[unsigned(colorPosition[unsigned(color[unsigned(i)])]++)] = i;
+}
+
+
+/*!
+ * \brief updateNodeWater
+ * Gauss-Seidel update of node i, returns the (normalized) norm of the change
+ */
+inline double updateNodeWater(long i)
+{
+    const long* colIndex = myContext->colIndex.data();
+    const double* colValue = myContext->colValue.data();
+    double* X = myContext->X;
+
+    double newX = myContext->b[i];
+    for (long k = myContext->rowStart[unsigned(i)]; k < myContext->rowStart[unsigned(i + 1)]; k++)
+    {
+        newX -= colValue[k] * X[colIndex[k]];
+    }
+
+    /*! surface check */
+    if (myContext->nodeListPtr[i].isSurface)
+        if (newX < double(myContext->nodeListPtr[i].z))
+            newX = double(myContext->nodeListPtr[i].z);
+
+    /*! water potential [m] */
+    double psi = fabs(newX - double(myContext->nodeListPtr[i].z));
+
+    /*! infinity norm (normalized if psi > 1m) */
+    double currentNorm;
+    if (psi > 1)
+        currentNorm = (fabs(newX - X[i])) / psi;
+    else
+        currentNorm = fabs(newX - X[i]);
+
+    X[i] = newX;
+
+    return currentNorm;
+}
+
+
+/*!
+ * \brief updateNodeHeat
+ * Gauss-Seidel update of node i (only active soil nodes), returns the norm of the change
+ */
+inline double updateNodeHeat(long i)
+{
+    if (i == 0 || myContext->nodeListPtr[i].isSurface || myContext->A[i][0].val == 0.)
+        return 0.;
+
+    const long* colIndex = myContext->colIndex.data();
+    const double* colValue = myContext->colValue.data();
+    double* X = myContext->X;
+
+    double new_x = myContext->b[i];
+    for (long k = myContext->rowStart[unsigned(i)]; k < myContext->rowStart[unsigned(i + 1)]; k++)
+    {
+        new_x -= colValue[k] * X[colIndex[k]];
+    }
+
+    double delta = fabs(new_x - X[i]);
+    X[i] = new_x;
+
+    return delta;
+}
+
+
 double GaussSeidelIterationWater(short direction)
 {
     long firstIndex, lastIndex;
@@ -115,11 +291,11 @@ double GaussSeidelIterationWater(short direction)
     if (direction == UP)
     {
         firstIndex = 0;
-        lastIndex = myStructure.nrNodes;
+        lastIndex = myContext->myStructure.nrNodes;
     }
     else
     {
-        firstIndex = myStructure.nrNodes -1;
+        firstIndex = myContext->myStructure.nrNodes -1;
         lastIndex = -1;
     }
 
@@ -129,32 +305,9 @@ double GaussSeidelIterationWater(short direction)
 
     while (i != lastIndex)
     {
-        double newX = b[i];
-        short j = 1;
-        while ((A[i][j].index != NOLINK) && (j < myStructure.maxNrColumns))
-        {
-            newX -= A[i][j].val * X[A[i][j].index];
-            j++;
-        }
-
-        /*! surface check */
-        if (nodeListPtr[i].isSurface)
-            if (newX < double(nodeListPtr[i].z))
-                newX = double(nodeListPtr[i].z);
-
-        /*! water potential [m] */
-        double psi = fabs(newX - double(nodeListPtr[i].z));
-
-        /*! infinity norm (normalized if psi > 1m) */
-        if (psi > 1)
-            currentNorm = (fabs(newX - X[i])) / psi;
-        else
-            currentNorm = fabs(newX - X[i]);
-
+        currentNorm = updateNodeWater(i);
         if (currentNorm > infinityNorm) infinityNorm = currentNorm;
 
-        X[i] = newX;
-
         (direction == UP)? i++ : i--;
     }
 
@@ -164,30 +317,96 @@ double GaussSeidelIterationWater(short direction)
 
 double GaussSeidelIterationHeat()
 {
-    double delta, new_x, norma_inf = 0.;
-    short j;
+    double delta, norma_inf = 0.;
+
+    for (long i = 1; i < myContext->myStructure.nrNodes; i++)
+    {
+        delta = updateNodeHeat(i);
+        if (delta > norma_inf) norma_inf = delta;
+    }
+
+    return norma_inf;
+ }
+
+
+/*!
+ * \brief multicolorRelaxation
+ * Gauss-Seidel iterations in multicolor order: the nodes of each color are independent
+ * and each thread updates a fixed share of them (results do not depend on nrThreads).
+ * The threads are started once for all the iterations and synchronized with a barrier
+ * after each color; thread 0 checks the convergence after each iteration
+ */
+bool multicolorRelaxation(int maxIterationsNr, double residualTolerance, int process)
+{
+    TCrit3DContext* context = myContext;
+    long nrNodes = context->myStructure.nrNodes;
+    unsigned nrColors = unsigned(context->colorStart.size()) - 1;
+
+    // small systems are not worth the synchronization
+    int nrThreads = int(MINVALUE(long(context->myParameters.nrThreads), nrNodes / SOLVER_BLOCK_SIZE));
+    nrThreads = MAXVALUE(nrThreads, 1);
+
+    const double MAX_NORM = 1.0;
+    double bestNorm = MAX_NORM;
+    bool isConverging = true;
+    bool isRunning = true;
+    int iteration = 0;
 
-    for (long i = 1; i < myStructure.nrNodes; i++)
-        if (!nodeListPtr[i].isSurface)
+    std::vector<double> threadNorm(unsigned(nrThreads), 0.);
+    parallel::Barrier barrier(nrThreads);
+
+    parallel::runThreads(nrThreads, [&](int threadIndex)
+    {
+        // worker threads have their own current context
+        myContext = context;
+
+        while (isRunning)
         {
-            if (A[i][0].val != 0.)
+            double norm = 0.;
+            for (unsigned c = 0; c < nrColors; c++)
+            {
+                long firstNode = context->colorStart[c];
+                long nrColorNodes = context->colorStart[c + 1] - firstNode;
+                long first = firstNode + nrColorNodes * threadIndex / nrThreads;
+                long last = firstNode + nrColorNodes * (threadIndex + 1) / nrThreads;
+
+                for (long k = first; k < last; k++)
+                {
+                    long i = context->colorNodes[unsigned(k)];
+                    double currentNorm = (process == PROCESS_HEAT) ? updateNodeHeat(i) : updateNodeWater(i);
+                    if (currentNorm > norm) norm = currentNorm;
+                }
+
+                if (c == nrColors - 1)
+                    threadNorm[unsigned(threadIndex)] = norm;
+
+                barrier.wait();
+            }
+
+            if (threadIndex == 0)
             {
-                j = 1;
-                new_x = b[i];
-                while ((A[i][j].index != NOLINK) && (j < myStructure.maxNrColumns))
+                double currentNorm = 0.;
+                for (unsigned t = 0; t < threadNorm.size(); t++)
+                    currentNorm = MAXVALUE(currentNorm, threadNorm[t]);
+
+                iteration++;
+                if (process == PROCESS_WATER)
                 {
-                    new_x -= A[i][j].val * X[A[i][j].index];
-                    j++;
+                    if (currentNorm > (bestNorm * 10.0))
+                        isConverging = false;           // not converging
+                    else if (currentNorm < bestNorm)
+                        bestNorm = currentNorm;
                 }
 
-                delta = fabs(new_x - X[i]);
-                if (delta > norma_inf) norma_inf = delta;
-                X[i] = new_x;
+                isRunning = isConverging && (currentNorm > residualTolerance) && (iteration < maxIterationsNr);
             }
+
+            barrier.wait();
         }
+    });
 
-    return norma_inf;
- }
+    return isConverging;
+}
 
 
 bool GaussSeidelRelaxation (int approximation, double residualTolerance, int process)
@@ -199,11 +418,22 @@ bool GaussSeidelRelaxation (int approximation, double residualTolerance, int pro
 
     int maxIterationsNr = calcola_iterazioni_max(approximation);
 
+    buildMatrixCSR();
+
+    if (myContext->myParameters.numericalSolutionMethod == MULTICOLOR_RELAXATION && myContext->myStructure.nrNodes > 0)
+    {
+        if (myContext->colorStart.empty())
+            buildColors();
+
+        return multicolorRelaxation(maxIterationsNr, residualTolerance, process);
+    }
+
     while ((currentNorm > residualTolerance) && (iteration < maxIterationsNr))
 	{
         if (process == PROCESS_HEAT)
+        {
             currentNorm = GaussSeidelIterationHeat();
-
+        }
         else if (process == PROCESS_WATER)
         {
             if (iteration%2 == 0)
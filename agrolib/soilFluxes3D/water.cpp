@@ -52,7 +52,7 @@ double getWaterExchange(long i, TlinkedNode *link, double deltaT)
     if (link != nullptr)
         {
 		double matrixValue = getMatrixValue(i, link);
-		double flow = matrixValue * (nodeListPtr[i].H - nodeListPtr[link->index].H) * deltaT;
+		double flow = matrixValue * (myContext->nodeListPtr[i].H - myContext->nodeListPtr[link->index].H) * deltaT;
         return (flow);
         }
 	else
@@ -78,16 +78,16 @@ double runoff(long i, long j, TlinkedNode *link, double deltaT, unsigned long ap
 
     if (approximationNr == 0)
     {
-        double flux_i = (nodeListPtr[i].Qw * deltaT) / nodeListPtr[i].volume_area;
-        double flux_j = (nodeListPtr[j].Qw * deltaT) / nodeListPtr[j].volume_area;
-        Hi = nodeListPtr[i].oldH + flux_i;
-        Hj = nodeListPtr[j].oldH + flux_j;
+        double flux_i = (myContext->nodeListPtr[i].Qw * deltaT) / myContext->nodeListPtr[i].volume_area;
+        double flux_j = (myContext->nodeListPtr[j].Qw * deltaT) / myContext->nodeListPtr[j].volume_area;
+        Hi = myContext->nodeListPtr[i].oldH + flux_i;
+        Hj = myContext->nodeListPtr[j].oldH + flux_j;
     }
     else
     {
 		
-		Hi = nodeListPtr[i].H;
-		Hj = nodeListPtr[j].H;
+		Hi = myContext->nodeListPtr[i].H;
+		Hj = myContext->nodeListPtr[j].H;
 		/*
 		Hi = (nodeListPtr[i].H + nodeListPtr[i].oldH) / 2.0;
         Hj = (nodeListPtr[j].H + nodeListPtr[j].oldH) / 2.0;
@@ -96,7 +96,7 @@ double runoff(long i, long j, TlinkedNode *link, double deltaT, unsigned long ap
 
 
     double H = MAXVALUE(Hi, Hj);
-    double z = MAXVALUE(nodeListPtr[i].z + nodeListPtr[i].Soil->Pond, nodeListPtr[j].z + nodeListPtr[j].Soil->Pond);
+    double z = MAXVALUE(myContext->nodeListPtr[i].z + myContext->nodeListPtr[i].Soil->Pond, myContext->nodeListPtr[j].z + myContext->nodeListPtr[j].Soil->Pond);
     double Hs = H - z;
     if (Hs <= 0.) return(0.);
 
@@ -104,13 +104,13 @@ double runoff(long i, long j, TlinkedNode *link, double deltaT, unsigned long ap
     double cellDistance = distance2D(i,j);
     if ((dH/cellDistance) < EPSILON_mm) return(0.);
 
-    double roughness = (nodeListPtr[i].Soil->Roughness + nodeListPtr[j].Soil->Roughness) / 2.;
+    double roughness = (myContext->nodeListPtr[i].Soil->Roughness + myContext->nodeListPtr[j].Soil->Roughness) / 2.;
 
     //Manning
     double v = pow(Hs, 2./3.) * sqrt(dH/cellDistance) / roughness;
     double flowArea = link->area * Hs;
 
-    Courant = MAXVALUE(Courant, v * deltaT / cellDistance);
+    myContext->Courant = MAXVALUE(myContext->Courant, v * deltaT / cellDistance);
     return (v * flowArea) / dH;
 }
 
@@ -118,23 +118,23 @@ double runoff(long i, long j, TlinkedNode *link, double deltaT, unsigned long ap
 
 double infiltration(long sup, long inf, TlinkedNode *link, double deltaT)
 {
- double cellDistance = (nodeListPtr[sup].z - nodeListPtr[inf].z) * 2.0;
+ double cellDistance = (myContext->nodeListPtr[sup].z - myContext->nodeListPtr[inf].z) * 2.0;
 
  /*! unsaturated */
- if (nodeListPtr[inf].H < nodeListPtr[sup].z)
+ if (myContext->nodeListPtr[inf].H < myContext->nodeListPtr[sup].z)
         {
         /*! surface water content [m] */
         // double surfaceH = (nodeListPtr[sup].H + nodeListPtr[sup].oldH) * 0.5;
-		double surfaceH = nodeListPtr[sup].H;
+		double surfaceH = myContext->nodeListPtr[sup].H;
 
         /*! maximum water infiltration rate [m/s] */
-        double maxInfiltrationRate = (surfaceH - nodeListPtr[sup].z) / deltaT;
+        double maxInfiltrationRate = (surfaceH - myContext->nodeListPtr[sup].z) / deltaT;
         if (maxInfiltrationRate <= 0.0) return(0.0);
 
         /*! first soil layer: mean between current k and k_sat */
-        double meanK = computeMean(nodeListPtr[inf].k, nodeListPtr[inf].Soil->K_sat);
+        double meanK = computeMean(myContext->nodeListPtr[inf].k, myContext->nodeListPtr[inf].Soil->K_sat);
 
-        double dH = nodeListPtr[sup].H - nodeListPtr[inf].H;
+        double dH = myContext->nodeListPtr[sup].H - myContext->nodeListPtr[inf].H;
         double maxK = maxInfiltrationRate * (cellDistance / dH);
 
         double k = MINVALUE(meanK , maxK);
@@ -145,7 +145,7 @@ double infiltration(long sup, long inf, TlinkedNode *link, double deltaT)
  /*! saturated */
  else
     {
-        return(nodeListPtr[inf].Soil->K_sat * link->area) / cellDistance;
+        return(myContext->nodeListPtr[inf].Soil->K_sat * link->area) / cellDistance;
     }
 
 }
@@ -154,19 +154,19 @@ double infiltration(long sup, long inf, TlinkedNode *link, double deltaT)
 double redistribution(long i, TlinkedNode *link, int linkType)
 {
     double cellDistance;
-    double k1 = nodeListPtr[i].k;
-    double k2 = nodeListPtr[(*link).index].k;
+    double k1 = myContext->nodeListPtr[i].k;
+    double k2 = myContext->nodeListPtr[(*link).index].k;
 
     /*! horizontal */
     if (linkType == LATERAL)
     {
         cellDistance = distance(i, (*link).index);
-        k1 *= myParameters.k_lateral_vertical_ratio;
-        k2 *= myParameters.k_lateral_vertical_ratio;
+        k1 *= myContext->myParameters.k_lateral_vertical_ratio;
+        k2 *= myContext->myParameters.k_lateral_vertical_ratio;
     }
     else
     {
-        cellDistance = fabs(nodeListPtr[i].z - nodeListPtr[(*link).index].z);
+        cellDistance = fabs(myContext->nodeListPtr[i].z - myContext->nodeListPtr[(*link).index].z);
     }
     double k = computeMean(k1, k2);
 
@@ -182,37 +182,37 @@ bool computeFlux(long i, int matrixIndex, TlinkedNode *link, double deltaT, unsi
     double val;
     long j = (*link).index;
 
-    if (nodeListPtr[i].isSurface)
+    if (myContext->nodeListPtr[i].isSurface)
     {
-		if (nodeListPtr[j].isSurface)
+		if (myContext->nodeListPtr[j].isSurface)
 			val = runoff(i, j, link, deltaT, myApprox);
         else
             val = infiltration(i, j, link, deltaT);
     }
     else
     {
-        if (nodeListPtr[j].isSurface)
+        if (myContext->nodeListPtr[j].isSurface)
             val = infiltration(j, i, link, deltaT);
         else
             val = redistribution(i, link, linkType);
     }
 
-    A[i][matrixIndex].index = j;
-    A[i][matrixIndex].val = val;
+    myContext->A[i][matrixIndex].index = j;
+    myContext->A[i][matrixIndex].val = val;
 
-    if (myStructure.computeHeat &&
-        ! nodeListPtr[i].isSurface && ! nodeListPtr[j].isSurface)
+    if (myContext->myStructure.computeHeat &&
+        ! myContext->nodeListPtr[i].isSurface && ! myContext->nodeListPtr[j].isSurface)
     {
-        if (myStructure.computeHeatVapor)
+        if (myContext->myStructure.computeHeatVapor)
         {
             double vaporThermal;
             vaporThermal = ThermalVaporFlux(i, link, PROCESS_WATER, NODATA, NODATA) / WATER_DENSITY;
-            invariantFlux[i] += vaporThermal;
+            myContext->invariantFlux[i] += vaporThermal;
         }
 
         double liquidThermal;
         liquidThermal = ThermalLiquidFlux(i, link, PROCESS_WATER, NODATA, NODATA);
-        invariantFlux[i] += liquidThermal;
+        myContext->invariantFlux[i] += liquidThermal;
     }
 
     return true;
@@ -229,31 +229,31 @@ bool waterFlowComputation(double deltaT)
      int approximationNr = 0;
      do
      {
-        Courant = 0.0;
+        myContext->Courant = 0.0;
         if (approximationNr == 0)
         {
-            for (i = 0; i < myStructure.nrNodes; i++)
+            for (i = 0; i < myContext->myStructure.nrNodes; i++)
             {
-                A[i][0].index = i;
+                myContext->A[i][0].index = i;
             }
         }
 
         /*! hydraulic conductivity and theta derivative */
-        for (i = 0; i < myStructure.nrNodes; i++)
+        for (i = 0; i < myContext->myStructure.nrNodes; i++)
         {
-            invariantFlux[i] = 0.;
-            if (!nodeListPtr[i].isSurface)
+            myContext->invariantFlux[i] = 0.;
+            if (!myContext->nodeListPtr[i].isSurface)
             {
-                nodeListPtr[i].k = computeK(unsigned(i));
+                myContext->nodeListPtr[i].k = computeK(unsigned(i));
                 dThetadH = dTheta_dH(unsigned(i));
-                 C[i] = nodeListPtr[i].volume_area  * dThetadH;
+                 myContext->C[i] = myContext->nodeListPtr[i].volume_area  * dThetadH;
 
                  // vapor capacity term
-                 if (myStructure.computeHeat && myStructure.computeHeatVapor)
+                 if (myContext->myStructure.computeHeat && myContext->myStructure.computeHeatVapor)
                  {
                      avgTemperature = getTMean(i);
                      dthetavdh = dThetav_dH(unsigned(i), avgTemperature, dThetadH);
-                     C[i] += nodeListPtr[i].volume_area  * dthetavdh;
+                     myContext->C[i] += myContext->nodeListPtr[i].volume_area  * dthetavdh;
                  }
             }
         }
@@ -262,49 +262,49 @@ bool waterFlowComputation(double deltaT)
         // updateBoundaryWater(deltaT);
 
         /*! computes the matrix elements */
-        for (i = 0; i < myStructure.nrNodes; i++)
+        for (i = 0; i < myContext->myStructure.nrNodes; i++)
         {
             short j = 1;
-            if (computeFlux(i, j, &(nodeListPtr[i].up), deltaT, approximationNr, UP)) j++;
-            for (short l = 0; l < myStructure.nrLateralLinks; l++)
-                    if (computeFlux(i, j, &(nodeListPtr[i].lateral[l]), deltaT, approximationNr, LATERAL)) j++;
-            if (computeFlux(i, j, &(nodeListPtr[i].down), deltaT, approximationNr, DOWN)) j++;
+            if (computeFlux(i, j, &(myContext->nodeListPtr[i].up), deltaT, approximationNr, UP)) j++;
+            for (short l = 0; l < myContext->myStructure.nrLateralLinks; l++)
+                    if (computeFlux(i, j, &(myContext->nodeListPtr[i].lateral[l]), deltaT, approximationNr, LATERAL)) j++;
+            if (computeFlux(i, j, &(myContext->nodeListPtr[i].down), deltaT, approximationNr, DOWN)) j++;
 
             /*! closure */
-            while (j < myStructure.maxNrColumns) A[i][j++].index = NOLINK;
+            while (j < myContext->myStructure.maxNrColumns) myContext->A[i][j++].index = NOLINK;
 
             j = 1;
             double sum = 0.;
-            while ((j < myStructure.maxNrColumns) && (A[i][j].index != NOLINK))
+            while ((j < myContext->myStructure.maxNrColumns) && (myContext->A[i][j].index != NOLINK))
             {
-                sum += A[i][j].val;
-                A[i][j].val *= -1.0;
+                sum += myContext->A[i][j].val;
+                myContext->A[i][j].val *= -1.0;
                 j++;
             }
 
             /*! sum of the diagonal elements */
-            A[i][0].val = C[i]/deltaT + sum;
+            myContext->A[i][0].val = myContext->C[i]/deltaT + sum;
 
             /*! b vector(vector of constant terms) */
-            b[i] = ((C[i] / deltaT) * nodeListPtr[i].oldH) + nodeListPtr[i].Qw + invariantFlux[i];
+            myContext->b[i] = ((myContext->C[i] / deltaT) * myContext->nodeListPtr[i].oldH) + myContext->nodeListPtr[i].Qw + myContext->invariantFlux[i];
 
             /*! preconditioning */
             j = 1;
-            while ((j < myStructure.maxNrColumns) && (A[i][j].index != NOLINK))
-                    A[i][j++].val /= A[i][0].val;
-            b[i] /= A[i][0].val;
+            while ((j < myContext->myStructure.maxNrColumns) && (myContext->A[i][j].index != NOLINK))
+                    myContext->A[i][j++].val /= myContext->A[i][0].val;
+            myContext->b[i] /= myContext->A[i][0].val;
         }
 
-        if (Courant > 1.0)
-            if (deltaT > myParameters.delta_t_min)
+        if (myContext->Courant > 1.0)
+            if (deltaT > myContext->myParameters.delta_t_min)
             {
                 halveTimeStep();
                 setForcedHalvedTime(true);
                 return false;
             }
 
-        if (! GaussSeidelRelaxation(approximationNr, myParameters.ResidualTolerance, PROCESS_WATER))
-            if (deltaT > myParameters.delta_t_min)
+        if (! GaussSeidelRelaxation(approximationNr, myContext->myParameters.ResidualTolerance, PROCESS_WATER))
+            if (deltaT > myContext->myParameters.delta_t_min)
             {
                 halveTimeStep();
                 setForcedHalvedTime(true);
@@ -312,18 +312,18 @@ bool waterFlowComputation(double deltaT)
             }
 
         /*! set new potential - compute new degree of saturation */
-        for (i = 0; i < myStructure.nrNodes; i++)
+        for (i = 0; i < myContext->myStructure.nrNodes; i++)
         {
-            nodeListPtr[i].H = X[i];
-            if (!nodeListPtr[i].isSurface)
-                nodeListPtr[i].Se = computeSe(unsigned(i));
+            myContext->nodeListPtr[i].H = myContext->X[i];
+            if (!myContext->nodeListPtr[i].isSurface)
+                myContext->nodeListPtr[i].Se = computeSe(unsigned(i));
         }
 
         /*! water balance */
         isValidStep = waterBalance(deltaT, approximationNr);
         if (getForcedHalvedTime()) return (false);
         }
-    while ((!isValidStep) && (++approximationNr < myParameters.maxApproximationsNumber));
+    while ((!isValidStep) && (++approximationNr < myContext->myParameters.maxApproximationsNumber));
 
     return isValidStep;
  }
@@ -343,23 +343,23 @@ bool computeWater(double maxTime, double *acceptedTime)
 
      while (!isStepOK)
      {
-        *acceptedTime = MINVALUE(myParameters.current_delta_t, maxTime);
+        *acceptedTime = MINVALUE(myContext->myParameters.current_delta_t, maxTime);
 
         /*! save the instantaneous H values - Prepare the solutions vector (X = H) */
-        for (long n = 0; n < myStructure.nrNodes; n++)
+        for (long n = 0; n < myContext->myStructure.nrNodes; n++)
         {
-            nodeListPtr[n].oldH = nodeListPtr[n].H;
-            X[n] = nodeListPtr[n].H;
+            myContext->nodeListPtr[n].oldH = myContext->nodeListPtr[n].H;
+            myContext->X[n] = myContext->nodeListPtr[n].H;
         }
 
         /*! assign Theta_e
             for the surface nodes C = area */
-        for (long n = 0; n < myStructure.nrNodes; n++)
+        for (long n = 0; n < myContext->myStructure.nrNodes; n++)
         {
-            if (nodeListPtr[n].isSurface)
-                C[n] = nodeListPtr[n].volume_area;
+            if (myContext->nodeListPtr[n].isSurface)
+                myContext->C[n] = myContext->nodeListPtr[n].volume_area;
             else
-                nodeListPtr[n].Se = computeSe(unsigned(n));
+                myContext->nodeListPtr[n].Se = computeSe(unsigned(n));
         }
 
         /*! update boundary conditions */
@@ -376,6 +376,6 @@ bool computeWater(double maxTime, double *acceptedTime)
 
 void restoreWater()
 {
-    for (long n = 0; n < myStructure.nrNodes; n++)
-         nodeListPtr[n].H = nodeListPtr[n].oldH;
+    for (long n = 0; n < myContext->myStructure.nrNodes; n++)
+         myContext->nodeListPtr[n].H = myContext->nodeListPtr[n].oldH;
 }
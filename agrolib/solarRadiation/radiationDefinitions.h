@@ -30,6 +30,11 @@
     #define CLEAR_SKY_TRANSMISSIVITY_DEFAULT     0.75f
     #define SHADOW_FACTOR 1
 
+    /*! fast mode: number of azimuth sectors of the horizon maps */
+    #define RADIATION_HORIZON_SECTORS 32
+    /*! fast mode: side of the tiles sharing the same sun position [m] */
+    #define RADIATION_TILE_SIZE 2000
+
     enum TradiationAlgorithm{RADIATION_ALGORITHM_RSUN = 0};
     enum TradiationRealSkyAlgorithm{RADIATION_REALSKY_TOTALTRANSMISSIVITY, RADIATION_REALSKY_LINKE};
     enum TparameterMode {PARAM_MODE_FIXED = 0, PARAM_MODE_MAP = 1, PARAM_MODE_MONTHLY = 2} ;
@@ -43,6 +43,8 @@ void Crit3DRadiationSettings::initialize()
     gisSettings = new gis::Crit3DGisSettings();
     realSky = true;
     shadowing = true;
+    fastMode = false;
+    nrThreads = 1;
     linkeMode = PARAM_MODE_FIXED;
     linke = 4.f;
     albedoMode = PARAM_MODE_FIXED;
@@ -110,6 +112,27 @@ void Crit3DRadiationSettings::setShadowing(bool value)
     shadowing = value;
 }
 
+bool Crit3DRadiationSettings::getFastMode() const
+{
+    return fastMode;
+}
+
+void Crit3DRadiationSettings::setFastMode(bool value)
+{
+    fastMode = value;
+}
+
+int Crit3DRadiationSettings::getNrThreads() const
+{
+    return nrThreads;
+}
+
+// threads of computeRadiationDEM: <= 0 means all cores
+void Crit3DRadiationSettings::setNrThreads(int value)
+{
+    nrThreads = value;
+}
+
 float Crit3DRadiationSettings::getLinke() const
 {
     return linke;
@@ -19,6 +19,8 @@
 
         bool realSky;
         bool shadowing;
+        bool fastMode;
+        int nrThreads;
         float linke;
         float albedo;
         float tilt;
@@ -50,6 +52,10 @@
         void setRealSky(bool value);
         bool getShadowing() const;
         void setShadowing(bool value);
+        bool getFastMode() const;
+        void setFastMode(bool value);
+        int getNrThreads() const;
+        void setNrThreads(int value);
         float getLinke() const;
         float getLinke(int row, int col) const;
         float getLinke(const gis::Crit3DPoint &myPoint) const;
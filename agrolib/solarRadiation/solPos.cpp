@@ -109,17 +109,17 @@ struct trigdata
 };
 
 
-//! Temporary global variables used only in this file:
+//! Constants used only in this file (S_solpos keeps its state in posdata, so it is reentrant):
 /*!
  * cumulative number of days prior to beginning of month
 */
-  static int  month_days[2][13] = { { 0,   0,  31,  59,  90, 120, 151,
+  static const int month_days[2][13] = { { 0,   0,  31,  59,  90, 120, 151,
                                        181, 212, 243, 273, 304, 334 },
                                     { 0,   0,  31,  60,  91, 121, 152,
                                        182, 213, 244, 274, 305, 335 } };
 
-  static double degrad = 57.295779513; /*!< converts from radians to degrees */
-  static double raddeg = 0.0174532925; /*!< converts from degrees to radians */
+  static const double degrad = 57.295779513; /*!< converts from radians to degrees */
+  static const double raddeg = 0.0174532925; /*!< converts from degrees to radians */
 
 
 /*!
@@ -28,6 +28,8 @@
 #include "basicMath.h"
 #include "gis.h"
 #include "meteoPoint.h"
+#include "parallel.h"
+#include "solPos.h"
 #include "sunPosition.h"
 #include "solarRadiation.h"
 #include <math.h>
@@ -54,8 +56,8 @@ Crit3DRadiationMaps::Crit3DRadiationMaps()
     sunShadowMap = new gis::Crit3DRasterGrid;
     */
 
+    horizonNrCols = 0;
     isComputed = false;
-
 }
 
 Crit3DRadiationMaps::Crit3DRadiationMaps(const gis::Crit3DRasterGrid& dem, const gis::Crit3DGisSettings& gisSettings)
@@ -100,6 +102,7 @@ Crit3DRadiationMaps::Crit3DRadiationMaps(const gis::Crit3DRasterGrid& dem, const
     sunShadowMap->initializeGrid(dem);
     */
 
+    horizonNrCols = 0;
     isComputed = false;
 }
 
@@ -149,6 +152,8 @@ void Crit3DRadiationMaps::clear()
     delete sunShadowMap;
     */
 
+    horizonMaps.clear();
+    horizonNrCols = 0;
     isComputed = false;
 }
 
@@ -176,6 +181,127 @@ void Crit3DRadiationMaps::setComputed(bool value)
     isComputed = value;
 }
 
+
+/*!
+ * \brief computeHorizonMaps
+ * horizon elevation of each cell for each azimuth sector (fast mode shadowing), computed once per DEM.
+ * The DEM is scanned along parallel lines in the sector direction; the horizon of a cell is the tangent
+ * to the upper convex hull of the cells ahead on its line (Dozier et al., 1981), so each cell is visited
+ * once per sector. As in computeShadow, the sun is hidden when the DEM is more than 0.5 m above the sun ray.
+ * Sectors are computed in parallel
+ */
+void Crit3DRadiationMaps::computeHorizonMaps(const gis::Crit3DRasterGrid& dem, int nrThreads)
+{
+    int nrRows = dem.header->nrRows;
+    int nrCols = dem.header->nrCols;
+
+    horizonNrCols = nrCols;
+    horizonMaps.resize(RADIATION_HORIZON_SECTORS);
+
+    auto computeSector = [&](long sector, long, int) -> bool
+    {
+        std::vector<double> hullDistance, hullZ;
+
+        double azimuth = sector * 360. / RADIATION_HORIZON_SECTORS;
+        double dx = sin(azimuth * DEG_TO_RAD);
+        double dy = cos(azimuth * DEG_TO_RAD);
+
+        // lines are walked one column (or one row) at a time, along the main direction
+        bool isColumnMain = (fabs(dx) >= fabs(dy));
+        int nrSteps = isColumnMain ? nrCols : nrRows;
+        int nrLines = isColumnMain ? nrRows : nrCols;
+        double mainStep = isColumnMain ? dx : -dy;
+        double crossRatio = isColumnMain ? (-dy / fabs(dx)) : (dx / fabs(dy));
+        double stepDistance = dem.header->cellSize / fabs(mainStep);
+
+        int lastOffset = int(round((nrSteps - 1) * crossRatio));
+        int firstLine = -MAXVALUE(0, lastOffset);
+        int lastLine = nrLines - 1 - MINVALUE(0, lastOffset);
+
+        std::vector<unsigned short>& horizon = horizonMaps[unsigned(sector)];
+        horizon.assign(size_t(nrRows) * size_t(nrCols), 0);
+
+        for (int line = firstLine; line <= lastLine; line++)
+        {
+            hullDistance.clear();
+            hullZ.clear();
+
+            // from the last cell in the sector direction backwards
+            for (int step = nrSteps - 1; step >= 0; step--)
+            {
+                int crossIndex = line + int(round(step * crossRatio));
+                if (crossIndex < 0 || crossIndex >= nrLines)
+                    continue;
+
+                int mainIndex = (mainStep > 0) ? step : nrSteps - 1 - step;
+                int row = isColumnMain ? crossIndex : mainIndex;
+                int col = isColumnMain ? mainIndex : crossIndex;
+
+                float z = dem.value[row][col];
+                if (z == dem.header->flag)
+                    continue;
+
+                double distance = step * stepDistance;
+
+                // the hull cells below the line to the next one are hidden from here on
+                size_t nrHull = hullZ.size();
+                while (nrHull >= 2 && (hullZ[nrHull-1] - z) * (hullDistance[nrHull-2] - distance)
+                                       <= (hullZ[nrHull-2] - z) * (hullDistance[nrHull-1] - distance))
+                {
+                    hullDistance.pop_back();
+                    hullZ.pop_back();
+                    nrHull--;
+                }
+
+                if (nrHull > 0)
+                {
+                    double deltaZ = hullZ[nrHull-1] - double(z) - 0.5;
+                    if (deltaZ > 0)
+                    {
+                        double elevation = atan(deltaZ / (hullDistance[nrHull-1] - distance)) * RAD_TO_DEG;
+                        horizon[size_t(row) * size_t(nrCols) + size_t(col)] = (unsigned short)(elevation * 100 + 0.5);
+                    }
+                }
+
+                hullDistance.push_back(distance);
+                hullZ.push_back(double(z));
+            }
+        }
+
+        return true;
+    };
+
+    nrThreads = parallel::getNrThreads(nrThreads);
+    parallel::forEachBlock(RADIATION_HORIZON_SECTORS, 1, nrThreads, computeSector);
+}
+
+
+bool Crit3DRadiationMaps::isHorizonComputed() const
+{
+    return ! horizonMaps.empty();
+}
+
+
+/*!
+ * \brief getHorizonElevation
+ * \return horizon elevation [degrees] at the azimuth [degrees, N=0, E=90],
+ * linearly interpolated between the two nearest sectors
+ */
+float Crit3DRadiationMaps::getHorizonElevation(int row, int col, float azimuth) const
+{
+    double position = azimuth * RADIATION_HORIZON_SECTORS / 360.;
+    int sector = int(floor(position));
+    double weight = position - sector;
+
+    sector = ((sector % RADIATION_HORIZON_SECTORS) + RADIATION_HORIZON_SECTORS) % RADIATION_HORIZON_SECTORS;
+    int nextSector = (sector + 1) % RADIATION_HORIZON_SECTORS;
+
+    size_t index = size_t(row) * size_t(horizonNrCols) + size_t(col);
+    double horizon = (1 - weight) * horizonMaps[unsigned(sector)][index] + weight * horizonMaps[unsigned(nextSector)][index];
+
+    return float(horizon * 0.01);
+}
+
 namespace radiation
 {
 /*
@@ -590,12 +716,24 @@ namespace radiation
     }
 
 
-bool computeRadiationRsun(Crit3DRadiationSettings* radSettings, float temperature, float myPressure, Crit3DTime myTime,
-                               float linke,float albedo, float clearSkyTransmissivity, float transmissivity,
-                               TsunPosition* sunPosition, TradPoint* radPoint, const gis::Crit3DRasterGrid& dem)
+    Crit3DTime getLocalTime(Crit3DRadiationSettings* radSettings, const Crit3DTime& myTime)
+    {
+        if (radSettings->gisSettings->isUTC)
+            return myTime.addSeconds(radSettings->gisSettings->timeZone * 3600);
+
+        return myTime;
+    }
+
+
+    /*!
+     * \brief computeIrradiance
+     * beam, diffuse, reflected and global irradiance of radPoint [W m-2],
+     * once the sun position (incidence and shadow included) is known
+     */
+    bool computeIrradiance(Crit3DRadiationSettings* radSettings, float linke, float albedo,
+                           float clearSkyTransmissivity, float transmissivity, bool isPointIlluminated,
+                           TsunPosition* sunPosition, TradPoint* radPoint)
     {
-        int myYear, myMonth, myDay;
-        int myHour, myMinute, mySecond;
         float Bhc, Bh;
         float Dhc, dH;
         float Ghc, Gh;
@@ -603,51 +741,7 @@ bool computeRadiationRsun(Crit3DRadiationSettings* radSettings, float temperatur
         float globalTransmittance;  /*!<   real sky global irradiation coefficient (global transmittance) */
         float diffuseTransmittance; /*!<   real sky radPoint.diffuse irradiation coefficient (radPoint.diffuse transmittance) */
         float dhsOverGhs;           /*!<  ratio horizontal radPoint.diffuse over horizontal global */
-        bool isPointIlluminated;
-
-        Crit3DTime localTime;
-        localTime = myTime;
-        if (radSettings->gisSettings->isUTC)
-        {
-            localTime = myTime.addSeconds(radSettings->gisSettings->timeZone * 3600);
-        }
-
-        myYear = localTime.date.year;
-        myMonth =  localTime.date.month;
-        myDay =  localTime.date.day;
-        myHour = localTime.getHour();
-        myMinute = localTime.getMinutes();
-        mySecond = int(localTime.getSeconds());
-
-        /*! Surface pressure at sea level (millibars) (used for refraction correction and optical air mass) */
-        myPressure = PRESSURE_SEALEVEL * float(exp(-radPoint->height / RAYLEIGH_Z0));
 
-        /*! Ambient default dry-bulb temperature (degrees C) (used for refraction correction) */
-        //should be passed
-        if (temperature == NODATA) temperature = TEMPERATURE_DEFAULT;
-
-        /*! Sun position */
-        if (! computeSunPosition(float(radPoint->lon), float(radPoint->lat), radSettings->gisSettings->timeZone,
-            myYear, myMonth, myDay, myHour, myMinute, mySecond,
-            temperature, myPressure, float(radPoint->aspect), float(radPoint->slope), sunPosition))
-            return false;
-
-        /*! Shadowing */
-        isPointIlluminated = isIlluminated(float(localTime.time), (*sunPosition).rise, (*sunPosition).set, (*sunPosition).elevationRefr);
-        if (radSettings->getShadowing())
-        {
-            if (gis::isOutOfGridXY(radPoint->x, radPoint->y, dem.header))
-                (*sunPosition).shadow = ! isPointIlluminated;
-            else
-            {
-                if (isPointIlluminated)
-                    (*sunPosition).shadow = computeShadow(radPoint, sunPosition, dem);
-                else
-                    (*sunPosition).shadow = true;
-            }
-        }
-
-        /*! Radiation */
         if (! isPointIlluminated)
         {
             radPoint->beam = 0;
@@ -723,6 +817,57 @@ bool computeRadiationRsun(Crit3DRadiationSettings* radSettings, float temperatur
     }
 
 
+    bool computeRadiationRsun(Crit3DRadiationSettings* radSettings, float temperature, float myPressure, Crit3DTime myTime,
+                              float linke,float albedo, float clearSkyTransmissivity, float transmissivity,
+                              TsunPosition* sunPosition, TradPoint* radPoint, const gis::Crit3DRasterGrid& dem)
+    {
+        int myYear, myMonth, myDay;
+        int myHour, myMinute, mySecond;
+        bool isPointIlluminated;
+
+        Crit3DTime localTime = getLocalTime(radSettings, myTime);
+
+        myYear = localTime.date.year;
+        myMonth =  localTime.date.month;
+        myDay =  localTime.date.day;
+        myHour = localTime.getHour();
+        myMinute = localTime.getMinutes();
+        mySecond = int(localTime.getSeconds());
+
+        /*! Surface pressure at sea level (millibars) (used for refraction correction and optical air mass) */
+        myPressure = PRESSURE_SEALEVEL * float(exp(-radPoint->height / RAYLEIGH_Z0));
+
+        /*! Ambient default dry-bulb temperature (degrees C) (used for refraction correction) */
+        //should be passed
+        if (temperature == NODATA) temperature = TEMPERATURE_DEFAULT;
+
+        /*! Sun position */
+        if (! computeSunPosition(float(radPoint->lon), float(radPoint->lat), radSettings->gisSettings->timeZone,
+            myYear, myMonth, myDay, myHour, myMinute, mySecond,
+            temperature, myPressure, float(radPoint->aspect), float(radPoint->slope), sunPosition))
+            return false;
+
+        /*! Shadowing */
+        isPointIlluminated = isIlluminated(float(localTime.time), (*sunPosition).rise, (*sunPosition).set, (*sunPosition).elevationRefr);
+        if (radSettings->getShadowing())
+        {
+            if (gis::isOutOfGridXY(radPoint->x, radPoint->y, dem.header))
+                (*sunPosition).shadow = ! isPointIlluminated;
+            else
+            {
+                if (isPointIlluminated)
+                    (*sunPosition).shadow = computeShadow(radPoint, sunPosition, dem);
+                else
+                    (*sunPosition).shadow = true;
+            }
+        }
+
+        /*! Radiation */
+        return computeIrradiance(radSettings, linke, albedo, clearSkyTransmissivity, transmissivity,
+                                 isPointIlluminated, sunPosition, radPoint);
+    }
+
+
     int estimateTransmissivityWindow(Crit3DRadiationSettings* radSettings, const gis::Crit3DRasterGrid& dem,
                                      const gis::Crit3DPoint& point, Crit3DTime myTime, int timeStepSecond)
     {
@@ -912,23 +1057,156 @@ bool computeRadiationRsun(Crit3DRadiationSettings* radSettings, float temperatur
         if (radSettings->getAlgorithm() != RADIATION_ALGORITHM_RSUN)
             return false;
 
-        int row, col;
-        TradPoint radPoint;
+        if (radSettings->getFastMode())
+            return computeRadiationDEMFast(radSettings, myDem, radiationMaps, myTime);
 
-        for (row = 0; row < myDem.header->nrRows; row++ )
+        // each cell is independent: rows are computed in parallel, with the same result of a serial loop
+        auto computeRows = [&](long firstRow, long lastRow, int) -> bool
         {
-            for (col = 0; col < myDem.header->nrCols; col++)
+            TradPoint radPoint;
+
+            for (int row = int(firstRow); row < int(lastRow); row++)
             {
-                if(isGridPointComputable(radSettings, row, col, myDem, radiationMaps))
+                for (int col = 0; col < myDem.header->nrCols; col++)
                 {
-                    myDem.getXY(row, col, radPoint.x, radPoint.y);
-                    radPoint.height = myDem.value[row][col];
+                    if(isGridPointComputable(radSettings, row, col, myDem, radiationMaps))
+                    {
+                        myDem.getXY(row, col, radPoint.x, radPoint.y);
+                        radPoint.height = myDem.value[row][col];
+
+                        if (! computeRadiationDemPoint(radSettings, myDem, radiationMaps, radPoint, row, col, myTime))
+                            return false;
+                    }
+                }
+            }
+
+            return true;
+        };
 
-                    if (! computeRadiationDemPoint(radSettings, myDem, radiationMaps, radPoint, row, col, myTime))
+        int nrThreads = parallel::getNrThreads(radSettings->getNrThreads());
+        if (! parallel::forEachBlock(myDem.header->nrRows, 1, nrThreads, computeRows))
+            return false;
+
+        updateRadiationMaps(radiationMaps, myTime);
+
+        return true;
+    }
+
+
+    /*!
+     * \brief computeRadiationDEMFast
+     * fast mode of computeRadiationDEM: the sun position is computed once for each tile of
+     * RADIATION_TILE_SIZE meters (at the tile center, sea level, horizontal surface);
+     * refraction and air mass are corrected for the cell pressure, the incidence is computed
+     * from the cell slope and aspect, the shadow from the horizon maps (computed at the first call).
+     * Rows are computed in parallel, as in computeRadiationDEM
+     */
+    bool computeRadiationDEMFast(Crit3DRadiationSettings* radSettings, const gis::Crit3DRasterGrid& myDem,
+                                 Crit3DRadiationMaps* radiationMaps, const Crit3DTime& myTime)
+    {
+        int nrThreads = parallel::getNrThreads(radSettings->getNrThreads());
+
+        if (radSettings->getShadowing() && ! radiationMaps->isHorizonComputed())
+            radiationMaps->computeHorizonMaps(myDem, nrThreads);
+
+        Crit3DTime localTime = getLocalTime(radSettings, myTime);
+        float clearSkyTransmissivity = radSettings->getClearSky();
+
+        int nrRows = myDem.header->nrRows;
+        int nrCols = myDem.header->nrCols;
+        int tileSize = MAXVALUE(1, int(RADIATION_TILE_SIZE / myDem.header->cellSize));
+        int nrTileRows = (nrRows + tileSize - 1) / tileSize;
+        int nrTileCols = (nrCols + tileSize - 1) / tileSize;
+
+        std::vector<TsunPosition> tileSunPosition(size_t(nrTileRows) * size_t(nrTileCols));
+        for (int tileRow = 0; tileRow < nrTileRows; tileRow++)
+        {
+            for (int tileCol = 0; tileCol < nrTileCols; tileCol++)
+            {
+                int centerRow = MINVALUE(tileRow * tileSize + tileSize / 2, nrRows - 1);
+                int centerCol = MINVALUE(tileCol * tileSize + tileSize / 2, nrCols - 1);
+
+                double x, y, lat, lon;
+                myDem.getXY(centerRow, centerCol, x, y);
+                gis::getLatLonFromUtm(*(radSettings->gisSettings), x, y, &lat, &lon);
+
+                TsunPosition* sunPosition = &(tileSunPosition[size_t(tileRow) * size_t(nrTileCols) + size_t(tileCol)]);
+                if (! computeSunPosition(float(lon), float(lat), radSettings->gisSettings->timeZone,
+                                         localTime.date.year, localTime.date.month, localTime.date.day,
+                                         localTime.getHour(), localTime.getMinutes(), int(localTime.getSeconds()),
+                                         TEMPERATURE_DEFAULT, PRESSURE_SEALEVEL, 0, 0, sunPosition))
+                    return false;
+            }
+        }
+
+        auto computeRows = [&](long firstRow, long lastRow, int) -> bool
+        {
+            TradPoint radPoint;
+            TsunPosition sunPosition;
+
+            for (int row = int(firstRow); row < int(lastRow); row++)
+            {
+                for (int col = 0; col < nrCols; col++)
+                {
+                    if (! isGridPointComputable(radSettings, row, col, myDem, radiationMaps))
+                        continue;
+
+                    radPoint.height = myDem.value[row][col];
+                    radPoint.lat = radiationMaps->latMap->value[row][col];
+                    radPoint.lon = radiationMaps->lonMap->value[row][col];
+                    radPoint.slope = readSlope(radSettings, radiationMaps->slopeMap, row, col);
+                    radPoint.aspect = readAspect(radSettings, radiationMaps->aspectMap, row, col);
+
+                    const TsunPosition& tilePosition = tileSunPosition[size_t(row / tileSize) * size_t(nrTileCols) + size_t(col / tileSize)];
+                    sunPosition = tilePosition;
+
+                    // refraction and pressure-corrected air mass scale with the cell pressure
+                    float pressureRatio = float(exp(-radPoint.height / RAYLEIGH_Z0));
+                    if (tilePosition.elevationRefr > -9)
+                        sunPosition.elevationRefr = tilePosition.elevation + (tilePosition.elevationRefr - tilePosition.elevation) * pressureRatio;
+                    sunPosition.relOptAirMassCorr = tilePosition.relOptAirMass * pressureRatio;
+
+                    double zenithRefr = (90. - double(sunPosition.elevationRefr)) * DEG_TO_RAD;
+                    double cosZenith = cos(zenithRefr);
+                    sunPosition.extraIrradianceHorizontal = (cosZenith > 0) ? float(tilePosition.extraIrradianceNormal * cosZenith) : 0;
+
+                    // cosine of the incidence angle on the tilted cell (as solpos)
+                    double cosIncidence = cosZenith * cos(radPoint.slope * DEG_TO_RAD) + sin(zenithRefr) * sin(radPoint.slope * DEG_TO_RAD)
+                                          * cos((double(sunPosition.azimuth) - radPoint.aspect) * DEG_TO_RAD);
+                    cosIncidence = MINVALUE(1, MAXVALUE(-1, cosIncidence));
+                    sunPosition.incidence = float(MAXVALUE(0, RAD_TO_DEG * ((PI / 2.0) - acos(float(cosIncidence)))));
+
+                    bool isPointIlluminated = isIlluminated(float(localTime.time), sunPosition.rise, sunPosition.set, sunPosition.elevationRefr);
+                    sunPosition.shadow = false;
+                    if (radSettings->getShadowing())
+                    {
+                        if (isPointIlluminated)
+                            sunPosition.shadow = (sunPosition.elevation < radiationMaps->getHorizonElevation(row, col, sunPosition.azimuth));
+                        else
+                            sunPosition.shadow = true;
+                    }
+
+                    float linke = readLinke(radSettings, row, col);
+                    float albedo = readAlbedo(radSettings, row, col);
+                    float transmissivity = radiationMaps->transmissivityMap->value[row][col];
+
+                    if (! computeIrradiance(radSettings, linke, albedo, clearSkyTransmissivity, transmissivity,
+                                           isPointIlluminated, &sunPosition, &radPoint))
                         return false;
+
+                    radiationMaps->sunElevationMap->value[row][col] = sunPosition.elevation;
+                    radiationMaps->globalRadiationMap->value[row][col] = float(radPoint.global);
+                    radiationMaps->beamRadiationMap->value[row][col] = float(radPoint.beam);
+                    radiationMaps->diffuseRadiationMap->value[row][col] = float(radPoint.diffuse);
+                    radiationMaps->reflectedRadiationMap->value[row][col] = float(radPoint.reflected);
                 }
             }
-        }
+
+            return true;
+        };
+
+        if (! parallel::forEachBlock(nrRows, 1, nrThreads, computeRows))
+            return false;
 
         updateRadiationMaps(radiationMaps, myTime);
 
@@ -972,14 +1250,16 @@ bool computeRadiationRsun(Crit3DRadiationSettings* radSettings, float temperatur
         float sunRiseMinutes;       /*!<  sunrise time [minutes from midnight] */
         float sunSetMinutes;        /*!<  sunset time [minutes from midnight] */
 
-        chk = RSUN_compute_solar_position(lon, lat, timeZone, myYear, myMonth, myDay, myHour, myMinute, mySecond, temp, pressure, aspect, slope, float(SBWID), float(SBRAD), float(SBSKY));
+        struct posdata solarData;
+
+        chk = RSUN_compute_solar_position(&solarData, lon, lat, timeZone, myYear, myMonth, myDay, myHour, myMinute, mySecond, temp, pressure, aspect, slope, float(SBWID), float(SBRAD), float(SBSKY));
         if (chk > 0)
         {
            //setErrorMsg
             return false;
         }
 
-        RSUN_get_results(&((*sunPosition).relOptAirMass), &((*sunPosition).relOptAirMassCorr), &((*sunPosition).azimuth), &sunCosIncidenceCompl, &cosZen, &((*sunPosition).elevation), &((*sunPosition).elevationRefr), &((*sunPosition).extraIrradianceHorizontal), &((*sunPosition).extraIrradianceNormal), &etrTilt, &prime, &sbcf, &sunRiseMinutes, &sunSetMinutes, &unPrime, &zenRef);
+        RSUN_get_results(&solarData, &((*sunPosition).relOptAirMass), &((*sunPosition).relOptAirMassCorr), &((*sunPosition).azimuth), &sunCosIncidenceCompl, &cosZen, &((*sunPosition).elevation), &((*sunPosition).elevationRefr), &((*sunPosition).extraIrradianceHorizontal), &((*sunPosition).extraIrradianceNormal), &etrTilt, &prime, &sbcf, &sunRiseMinutes, &sunSetMinutes, &unPrime, &zenRef);
 
         (*sunPosition).incidence = float(MAXVALUE(0, RAD_TO_DEG * ((PI / 2.0) - acos(sunCosIncidenceCompl))));
         (*sunPosition).rise = sunRiseMinutes * 60.f;
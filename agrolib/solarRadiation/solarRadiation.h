@@ -9,11 +9,17 @@
         #include "meteoPoint.h"
     #endif
 
+    #include <vector>
+
     class Crit3DRadiationMaps
     {
     private:
         bool isComputed;
 
+        // fast mode: horizon elevation of each cell [hundredths of degree],
+        // for each of the RADIATION_HORIZON_SECTORS azimuth sectors (64 bytes per cell)
+        std::vector<std::vector<unsigned short>> horizonMaps;
+        int horizonNrCols;
 
     public:
         gis::Crit3DRasterGrid* latMap;
@@ -45,6 +51,10 @@
         void initialize();
         bool getComputed();
         void setComputed(bool value);
+
+        void computeHorizonMaps(const gis::Crit3DRasterGrid& dem, int nrThreads = 1);
+        bool isHorizonComputed() const;
+        float getHorizonElevation(int row, int col, float azimuth) const;
     };
 
 
@@ -69,6 +79,9 @@
         bool computeRadiationDEM(Crit3DRadiationSettings *radSettings, const gis::Crit3DRasterGrid& myDem,
                                  Crit3DRadiationMaps* radiationMaps, const Crit3DTime& myTime);
 
+        bool computeRadiationDEMFast(Crit3DRadiationSettings *radSettings, const gis::Crit3DRasterGrid& myDem,
+                                     Crit3DRadiationMaps* radiationMaps, const Crit3DTime& myTime);
+
         bool computeRadiationDemPoint(Crit3DRadiationSettings* mySettings, const gis::Crit3DRasterGrid& myDem,
                                   Crit3DRadiationMaps* radiationMaps, TradPoint radPoint,
                                   int row, int col, const Crit3DTime& myTime);
@@ -30,10 +30,12 @@
 #include "solPos.h"
 #include "sunPosition.h"
 
-struct posdata pd, *pdat; /*!< declare solpos data struct and a pointer for it */
 
-
-long RSUN_compute_solar_position (float longitude, float latitude, int myTimezone,
+/*!
+ * \brief RSUN_compute_solar_position
+ * the solpos state is passed by the caller (pdat), so that positions can be computed concurrently
+ */
+long RSUN_compute_solar_position (struct posdata *pdat, float longitude, float latitude, int myTimezone,
                 int year, int month, int day, int hour, int minute, int second,
                 float temp, float press, float aspect, float tilt,
                 float sbwid, float sbrad, float sbsky)
@@ -51,8 +53,6 @@ long RSUN_compute_solar_position (float longitude, float latitude, int myTimezon
 
     long retval;             /*!< to capture S_solpos return codes */
 
-    pdat = &pd;   /*!< point to the structure for convenience */
-
     /*! Initialize structure to default values. (Optional only if ALL input
        parameters are initialized in the calling code, which they are not
        in this example.) */
@@ -97,7 +97,7 @@ long RSUN_compute_solar_position (float longitude, float latitude, int myTimezon
 }
 
 
-void RSUN_get_results (float *amass, float *ampress,
+void RSUN_get_results (const struct posdata *pdat, float *amass, float *ampress,
                    float *azim, float *cosinc, float *coszen,
                    float *elevetr, float *elevref,
                    float *etr, float *etrn, float *etrtilt,
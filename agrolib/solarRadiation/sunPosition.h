@@ -1,8 +1,11 @@
 #ifndef SUNPOSITION_H
 #define SUNPOSITION_H
 
+struct posdata;
+
 /*!
  * \brief RSUN_compute_solar_position
+ * \param pdat solpos data, owned by the caller
  * \param longitude
  * \param latitude
  * \param timezone
@@ -22,13 +25,14 @@
  * \return
  */
 long RSUN_compute_solar_position (
-                    float longitude, float latitude, int timezone,
+                    struct posdata *pdat, float longitude, float latitude, int timezone,
                     int year, int month, int day, int hour, int minute, int second,
                     float temp, float press, float aspect, float tilt,
                     float sbwid, float sbrad, float sbsky);
 
 /*!
  * \brief RSUN_get_results
+ * \param pdat solpos data computed by RSUN_compute_solar_position
  * \param amass Relative optical airmass
  * \param ampress Pressure-corrected airmass
  * \param azim Solar azimuth angle:  N=0, E=90, S=180, W=270
@@ -47,7 +51,7 @@ long RSUN_compute_solar_position (
  * \param zenref Solar zenith angle, deg. from zenith, refracted
  */
 void RSUN_get_results (
-                    float *amass, float *ampress, float *azim,
+                    const struct posdata *pdat, float *amass, float *ampress, float *azim,
                     float *cosinc, float *coszen, float *elevetr, float *elevref,
                     float *etr, float *etrn, float *etrtilt, float *prime, float *sbcf,
                     float *sunrise, float *sunset, float *unprime, float *zenref);
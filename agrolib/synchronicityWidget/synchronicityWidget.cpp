@@ -304,11 +304,12 @@ void Crit3DSynchronicityWidget::addInterpolationGraph()
             QMessageBox::critical(nullptr, "Error", "Error in function preInterpolation: " + QString::fromStdString(errorStdStr));
             return;
         }
+        // single point: the spatial index is not used (checking it costs as the search)
         float interpolatedValue = interpolate(interpolationPoints, &interpolationSettings, meteoSettings, myVar,
                                               float(mp.point.utm.x),
                                               float(mp.point.utm.y),
                                               float(mp.point.z),
-                                              mp.getProxyValues(), false);
+                                              mp.getProxyValues(), false, false);
 
         if (myValue1 != NODATA && interpolatedValue != NODATA)
         {
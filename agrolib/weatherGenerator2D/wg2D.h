@@ -10,6 +10,8 @@
         #include "meteoPoint.h"
     #endif
 
+    #include <vector>
+
     #define TOLERANCE_MULGETS 0.001
     #define MAX_ITERATION_MULGETS 180
     #define ONELESSEPSILON 0.999999
@@ -192,12 +194,35 @@
     };
 
 
+    /*!
+     * \brief scratch arrays of spatialIterationOccurrence and spatialIterationAmounts:
+     * one for each thread, contiguous and reused by all months and seasons
+     */
+    struct TspatialIterationWorkspace
+    {
+        std::vector<double> eigenvalues;
+        std::vector<double> eigenvectors;
+        std::vector<double> correlationArray;
+        std::vector<double> weightedEigenvectors;   // eigenvectors * eigenvalues, transposed
+
+        std::vector<double> squareBuffer;
+        std::vector<double> seriesBuffer;
+        std::vector<double*> dummyMatrix;           // [nrStations][nrStations]
+        std::vector<double*> initialMatrix;         // [nrStations][nrStations]
+        std::vector<double*> dummyMatrix3;          // [nrStations][lengthSeries]
+        std::vector<double*> normRandom;            // [nrStations][lengthSeries]
+
+        void initialize(int nrStations, int lengthSeries);
+    };
+
+
     //void randomSet(double *arrayNormal,int dimArray);
     class weatherGenerator2D
     {
     private:
 
         bool isPrecWG2D,isTempWG2D;
+        int nrThreads;
         int nrData;
         int nrDataWithout29February;
         int nrStations;
@@ -298,14 +323,15 @@
         int recursiveAccountWetDays(int idStation, int i, int iMonth,int step, std::vector<std::vector<int> > &consecutiveDays,int nrFollowingSteps);
         void precipitationCorrelationMatrices();
         void precipitationMultisiteOccurrenceGeneration();
-        void spatialIterationOccurrence(double ** M, double **K, double **occurrences, double** matrixOccurrence, double** normalizedMatrixRandom, double **transitionNormal, double ***transitionNormalAugmentedMemory, int lengthSeries);
+        void spatialIterationOccurrence(double ** M, double **K, double **occurrences, double** matrixOccurrence, double** normalizedMatrixRandom, double **transitionNormal, double ***transitionNormalAugmentedMemory, int lengthSeries, TspatialIterationWorkspace &workspace);
         void precipitationMultiDistributionParameterization();
         void precipitationMultisiteAmountsGeneration();
         void initializeBaseWeatherVariables();
         void initializeOccurrenceIndex();
         void initializePrecipitationOutputs(int lengthSeason[]);
         void initializePrecipitationInternalArrays();
-        void spatialIterationAmounts(double** correlationMatrixSimulatedData,double ** amountsCorrelationMatrix , double** randomMatrix, int length, double** occurrences, double** phatAlpha, double** phatBeta,double** simulatedPrecipitationAmounts);
+        void spatialIterationAmounts(double** correlationMatrixSimulatedData,double ** amountsCorrelationMatrix , double** randomMatrix, int length, double** occurrences, double** phatAlpha, double** phatBeta,double** simulatedPrecipitationAmounts, TspatialIterationWorkspace &workspace);
+        void reconstructCorrelationMatrix(double** correlationMatrix, TspatialIterationWorkspace &workspace);
         void temperatureCompute();
         void computeMonthlyVariables();
         void computeTemperatureParameters();
@@ -337,12 +363,13 @@
         // variables
         ToutputWeatherData *outputWeatherData;
         //functions
-        weatherGenerator2D() {}
+        weatherGenerator2D() : nrThreads(0) {}
         bool initializeData(int lengthDataSeries, int nrStations);
         void initializeParameters(float thresholdPrecipitation, int simulatedYears, int distributionType, bool computePrecWG2D, bool computeTempWG2D, bool computeStatistics, TaverageTempMethod tempMethod);
         void setObservedData(TObsDataD** observations);
         void computeWeatherGenerator2D();
         void pressEnterToContinue();
+        void setNrThreads(int value) { nrThreads = value; }
         void initializeRandomNumbers(double* vector);
         ToutputWeatherData* getWeatherGeneratorOutput(int startingYear);
     };
@@ -3,6 +3,7 @@
 #include <stdlib.h>
 #include <time.h>
 #include <iostream>
+#include <algorithm>
 
 #include "wg2D.h"
 #include "commonConstants.h"
@@ -10,6 +11,7 @@
 #include "statistics.h"
 #include "eispack.h"
 #include "gammaFunction.h"
+#include "parallel.h"
 
 
 void weatherGenerator2D::initializePrecipitationInternalArrays()
@@ -771,6 +773,15 @@ void weatherGenerator2D::precipitationMultisiteAmountsGeneration()
    srand (time(nullptr));
    //int firstRandomNumber = rand();
 
+   // the arrays of each season are prepared in sequence (same random numbers of the serial cycle),
+   // then the spatial iterations of the four seasons are computed in parallel
+   double** occurrenceSeasonList[4];
+   double** moranRandomList[4];
+   double** phatAlphaList[4];
+   double** phatBetaList[4];
+   double** randomMatrixList[4];
+   double** simulatedAmountsList[4];
+
    for (int iSeason=0;iSeason<4;iSeason++)
    {
       double** occurrenceSeason = (double **)calloc(nrStations, sizeof(double*));
@@ -971,7 +982,40 @@ void weatherGenerator2D::precipitationMultisiteAmountsGeneration()
           }
       }
 
-      weatherGenerator2D::spatialIterationAmounts(simulatedPrecipitationAmounts[iSeason].matrixK , simulatedPrecipitationAmounts[iSeason].matrixM,randomMatrixNormalDistribution,lengthSeason[iSeason]*parametersModel.yearOfSimulation,occurrenceSeason,phatAlpha,phatBeta,simulatedPrecipitationAmountsSeasonal);
+      occurrenceSeasonList[iSeason] = occurrenceSeason;
+      moranRandomList[iSeason] = moranRandom;
+      phatAlphaList[iSeason] = phatAlpha;
+      phatBetaList[iSeason] = phatBeta;
+      randomMatrixList[iSeason] = randomMatrixNormalDistribution;
+      simulatedAmountsList[iSeason] = simulatedPrecipitationAmountsSeasonal;
+   }
+
+   int nrWorkers = std::min(parallel::getNrThreads(nrThreads), 4);
+   std::vector<TspatialIterationWorkspace> workspace;
+   workspace.resize(unsigned(nrWorkers));
+
+   parallel::forEachBlock(4, 1, nrWorkers, [&](long firstSeason, long lastSeason, int threadIndex)
+   {
+       for (long season = firstSeason; season < lastSeason; season++)
+       {
+           int iSeason = int(season);
+           weatherGenerator2D::spatialIterationAmounts(simulatedPrecipitationAmounts[iSeason].matrixK , simulatedPrecipitationAmounts[iSeason].matrixM,
+                                                       randomMatrixList[iSeason],lengthSeason[iSeason]*parametersModel.yearOfSimulation,
+                                                       occurrenceSeasonList[iSeason],phatAlphaList[iSeason],phatBetaList[iSeason],
+                                                       simulatedAmountsList[iSeason], workspace[unsigned(threadIndex)]);
+       }
+       return true;
+   });
+
+   for (int iSeason=0;iSeason<4;iSeason++)
+   {
+      double** occurrenceSeason = occurrenceSeasonList[iSeason];
+      double** moranRandom = moranRandomList[iSeason];
+      double** phatAlpha = phatAlphaList[iSeason];
+      double** phatBeta = phatBetaList[iSeason];
+      double** randomMatrixNormalDistribution = randomMatrixList[iSeason];
+      double** simulatedPrecipitationAmountsSeasonal = simulatedAmountsList[iSeason];
+
       time_t rawtime;
       struct tm * timeinfo;
       time ( &rawtime );
@@ -1202,52 +1246,21 @@ void weatherGenerator2D::precipitationAmountsOccurences(int idStation, double* p
    }
 }
 
-void weatherGenerator2D::spatialIterationAmounts(double** correlationMatrixSimulatedData,double ** amountsCorrelationMatrix , double** randomMatrix, int lengthSeries, double** occurrences, double** phatAlpha, double** phatBeta, double** simulatedPrecipitationAmountsSeasonal)
+void weatherGenerator2D::spatialIterationAmounts(double** correlationMatrixSimulatedData,double ** amountsCorrelationMatrix , double** randomMatrix, int lengthSeries, double** occurrences, double** phatAlpha, double** phatBeta, double** simulatedPrecipitationAmountsSeasonal, TspatialIterationWorkspace &workspace)
 {
    double val=5;
    int ii=0;
    double kiter=0.1;
-   double** dummyMatrix = (double**)calloc(nrStations, sizeof(double*));
-   double** dummyMatrix2 = (double**)calloc(nrStations, sizeof(double*));
-   double* correlationArray =(double*)calloc(nrStations*nrStations, sizeof(double));
-   double* eigenvalues =(double*)calloc(nrStations, sizeof(double));
-   double* eigenvectors =(double*)calloc(nrStations*nrStations, sizeof(double));
-   double** dummyMatrix3 = (double**)calloc(nrStations, sizeof(double*));
-
 
+   workspace.initialize(nrStations, lengthSeries);
+   double* eigenvalues = workspace.eigenvalues.data();
+   double* eigenvectors = workspace.eigenvectors.data();
+   double* correlationArray = workspace.correlationArray.data();
+   double** dummyMatrix = workspace.dummyMatrix.data();
+   double** dummyMatrix3 = workspace.dummyMatrix3.data();
+   double** initialAmountsCorrelationMatrix = workspace.initialMatrix.data();
 
    double uniformRandomVar;
-   double** initialAmountsCorrelationMatrix = (double**)calloc(nrStations, sizeof(double*));
-
-
-   // initialization internal arrays
-   for (int i=0;i<nrStations;i++)
-   {
-       dummyMatrix[i]= (double*)calloc(nrStations, sizeof(double));
-       dummyMatrix2[i]= (double*)calloc(nrStations, sizeof(double));
-       initialAmountsCorrelationMatrix[i]= (double*)calloc(nrStations, sizeof(double));
-       for (int j=0;j<nrStations;j++)
-       {
-           dummyMatrix[i][j]= NODATA;
-           dummyMatrix2[i][j]= NODATA;
-           initialAmountsCorrelationMatrix[i][j]= NODATA;
-       }
-   }
-
-   for (int i=0;i<nrStations;i++)
-   {
-       eigenvalues[i]=NODATA;
-       for (int j=0;j<nrStations;j++) eigenvectors[i*nrStations+j] = NODATA;
-   }
-   for (int i=0;i<nrStations;i++)
-   {
-       dummyMatrix3[i]= (double*)calloc(lengthSeries, sizeof(double));
-       for (int j=0;j<lengthSeries;j++)
-       {
-           dummyMatrix3[i][j]= NODATA;
-       }
-
-   }
 
    for (int i=0;i<nrStations;i++)
    {
@@ -1291,30 +1304,7 @@ void weatherGenerator2D::spatialIterationAmounts(double** correlationMatrixSimul
        }
        if (nrEigenvaluesLessThan0 > 0)
        {
-           counter=0;
-           for (int i=0;i<nrStations;i++)
-           {
-               for (int j=0;j<nrStations;j++)
-               {
-                   dummyMatrix[j][i]= eigenvectors[counter];
-                   dummyMatrix2[i][j]= eigenvectors[counter]*eigenvalues[i];
-                   ++counter;
-               }
-           }
-           int cMatrix, dMatrix, kMatrix;
-           double sumMatrix = 0;
-           for ( cMatrix = 0 ; cMatrix < nrStations ; cMatrix++ )
-           {
-               for ( dMatrix = cMatrix ; dMatrix < nrStations ; dMatrix++ )
-               {
-                   for ( kMatrix = 0 ; kMatrix < nrStations ; kMatrix++ )
-                   {
-                       sumMatrix += dummyMatrix[cMatrix][kMatrix] * dummyMatrix2[kMatrix][dMatrix];
-                   }
-                   amountsCorrelationMatrix[dMatrix][cMatrix] = amountsCorrelationMatrix[cMatrix][dMatrix] = sumMatrix;
-                   sumMatrix = 0.;
-               }
-           }
+           reconstructCorrelationMatrix(amountsCorrelationMatrix, workspace);
            //matricial::matrixProductSquareMatricesNoCheck(dummyMatrix,dummyMatrix2,nrStations,amountsCorrelationMatrix);
            /*for (int i=0;i<nrStations;i++)
            {
@@ -1406,23 +1396,6 @@ void weatherGenerator2D::spatialIterationAmounts(double** correlationMatrixSimul
        {
            if (val <= fabs(minimalValueToExitFromCycle) + TOLERANCE_MULGETS)
            {
-               for (int i=0;i<nrStations;i++)
-               {
-                   free(dummyMatrix[i]);
-                   free(dummyMatrix2[i]);
-                   free(dummyMatrix3[i]);
-                   free(initialAmountsCorrelationMatrix[i]);
-               }
-
-
-                free(dummyMatrix);
-                free(dummyMatrix2);
-                free(dummyMatrix3);
-                free(correlationArray);
-                free(eigenvalues);
-                free(eigenvectors);
-                free(initialAmountsCorrelationMatrix);
-
                return;
            }
        }
@@ -1447,24 +1420,6 @@ void weatherGenerator2D::spatialIterationAmounts(double** correlationMatrixSimul
        }
        //printf("iter %d value %f \n",ii,val);
    }
-   // free memory
-   for (int i=0;i<nrStations;i++)
-   {
-       free(dummyMatrix[i]);
-       free(dummyMatrix2[i]);
-       free(dummyMatrix3[i]);
-       free(initialAmountsCorrelationMatrix[i]);
-   }
-
-
-       free(dummyMatrix);
-       free(dummyMatrix2);
-       free(dummyMatrix3);
-       free(correlationArray);
-       free(eigenvalues);
-       free(eigenvectors);
-       free(initialAmountsCorrelationMatrix);
-
 }
 
 /*
@@ -125,6 +125,7 @@ contributors:
 #include <stdlib.h>
 #include <time.h>
 #include <iostream>
+#include <algorithm>
 
 #include "wg2D.h"
 #include "commonConstants.h"
@@ -132,6 +133,7 @@ contributors:
 #include "statistics.h"
 #include "eispack.h"
 #include "gammaFunction.h"
+#include "parallel.h"
 
 #include "weatherGenerator.h"
 #include "wgClimate.h"
@@ -1059,51 +1061,93 @@ void weatherGenerator2D::precipitationCorrelationMatrices()
 
 
 
-void weatherGenerator2D::precipitationMultisiteOccurrenceGeneration()
+void TspatialIterationWorkspace::initialize(int nrStations, int lengthSeries)
 {
-    int nrDaysIterativeProcessMonthly[12];
-    int gasDevIset = 0;
-    double gasDevGset = 0;
-    srand(time(NULL));
-    rand();
+    unsigned n = unsigned(nrStations);
+    unsigned length = unsigned(lengthSeries);
+
+    eigenvalues.resize(n);
+    eigenvectors.resize(n*n);
+    correlationArray.resize(n*n);
+    weightedEigenvectors.resize(n*n);
+
+    squareBuffer.resize(2*n*n);
+    dummyMatrix.resize(n);
+    initialMatrix.resize(n);
+    for (unsigned i=0; i<n; i++)
+    {
+        dummyMatrix[i] = &squareBuffer[i*n];
+        initialMatrix[i] = &squareBuffer[(n+i)*n];
+    }
 
-    for (int i=0;i<12;i++)
+    // the buffer only grows: the longest series is kept for the following months
+    if (seriesBuffer.size() < 2*n*length)
+        seriesBuffer.resize(2*n*length);
+    dummyMatrix3.resize(n);
+    normRandom.resize(n);
+    for (unsigned i=0; i<n; i++)
     {
-        nrDaysIterativeProcessMonthly[i] = lengthMonth[i]*parametersModel.yearOfSimulation;
+        dummyMatrix3[i] = &seriesBuffer[i*length];
+        normRandom[i] = &seriesBuffer[(n+i)*length];
     }
-    double** matrixOccurrence;
-    matrixOccurrence = (double **)calloc(nrStations, sizeof(double*));
-    double** normalizedTransitionProbability;
-    normalizedTransitionProbability = (double **)calloc(nrStations, sizeof(double*));
+}
 
+
+/*!
+ * \brief reconstructCorrelationMatrix
+ * correlationMatrix = V * diag(eigenvalues) * V', with the eigenvectors V stored by rows in the workspace.
+ * On exit workspace.dummyMatrix contains V
+ */
+void weatherGenerator2D::reconstructCorrelationMatrix(double** correlationMatrix, TspatialIterationWorkspace &workspace)
+{
+    double** dummyMatrix = workspace.dummyMatrix.data();
+    double* eigenvectors = workspace.eigenvectors.data();
+    double* eigenvalues = workspace.eigenvalues.data();
+    double* weightedEigenvectors = workspace.weightedEigenvectors.data();
+
+    int counter=0;
     for (int i=0;i<nrStations;i++)
     {
-        matrixOccurrence[i] = (double *)calloc(nrStations, sizeof(double));
-        normalizedTransitionProbability[i]= (double *)calloc(2, sizeof(double));
         for (int j=0;j<nrStations;j++)
         {
-           matrixOccurrence[i][j]= NODATA;
+            dummyMatrix[j][i]= eigenvectors[counter];
+            weightedEigenvectors[j*nrStations + i]= eigenvectors[counter]*eigenvalues[i];
+            counter++;
         }
-        normalizedTransitionProbability[i][0]= NODATA;
-        normalizedTransitionProbability[i][1]= NODATA;
     }
 
-    double*** normalizedTransitionProbabilityAugmentedMemory;
-    normalizedTransitionProbabilityAugmentedMemory = (double ***)calloc(nrStations, sizeof(double**));
-
-    for (int i=0;i<nrStations;i++)
+    // both factors are read by rows
+    double sumMatrix;
+    for (int cMatrix = 0 ; cMatrix < nrStations ; cMatrix++ )
     {
-        normalizedTransitionProbabilityAugmentedMemory[i]= (double **)calloc(2, sizeof(double*));
-        for (int j=0;j<2;j++)
+        double* rowFirst = dummyMatrix[cMatrix];
+        for (int dMatrix = cMatrix ; dMatrix < nrStations ; dMatrix++ )
         {
-            normalizedTransitionProbabilityAugmentedMemory[i][j]= (double *)calloc(60, sizeof(double));
-            //for (int k=0;k<60;k++)
-            //{
-                //normalizedTransitionProbabilityAugmentedMemory[i][0][k]= NODATA;
-                //normalizedTransitionProbabilityAugmentedMemory[i][1][k]= NODATA;
-            //}
+            double* rowSecond = &weightedEigenvectors[dMatrix*nrStations];
+            sumMatrix = 0.;
+            for (int kMatrix = 0 ; kMatrix < nrStations ; kMatrix++ )
+            {
+                sumMatrix += rowFirst[kMatrix] * rowSecond[kMatrix];
+            }
+            correlationMatrix[dMatrix][cMatrix] = correlationMatrix[cMatrix][dMatrix] = sumMatrix;
         }
     }
+}
+
+
+void weatherGenerator2D::precipitationMultisiteOccurrenceGeneration()
+{
+    int nrDaysIterativeProcessMonthly[12];
+    int gasDevIset = 0;
+    double gasDevGset = 0;
+    srand(time(NULL));
+    rand();
+
+    for (int i=0;i<12;i++)
+    {
+        nrDaysIterativeProcessMonthly[i] = lengthMonth[i]*parametersModel.yearOfSimulation;
+    }
+
     // random Occurrence structure. Used from step 3 on
 
         randomMatrix = (TrandomMatrix*)calloc(12,sizeof(TrandomMatrix));
@@ -1121,59 +1165,88 @@ void weatherGenerator2D::precipitationMultisiteOccurrenceGeneration()
             }
         }
 
-    // arrays initialization
+    // the random numbers of all months are drawn in advance, in the same sequence
+    // of the monthly cycle: the months can then be computed in parallel
+    std::vector<std::vector<double>> randomBuffer(12);
+    std::vector<std::vector<double*>> normalizedRandomMatrix(12);
     for (int iMonth=0; iMonth<12; iMonth++)
     {
-        double syntheticP10,syntheticP01;
-        double wetDays,dryDays;
-        syntheticP01 = syntheticP10 = 0.0;
-        wetDays = dryDays = 0.0;
-        // initialization and definition of the random matrix
-        double** normalizedRandomMatrix;
-        normalizedRandomMatrix = (double **)calloc(nrStations, sizeof(double*));
+        unsigned length = unsigned(nrDaysIterativeProcessMonthly[iMonth]);
+        randomBuffer[iMonth].resize(unsigned(nrStations)*length);
+        normalizedRandomMatrix[iMonth].resize(unsigned(nrStations));
         for (int i=0;i<nrStations;i++)
         {
-            normalizedRandomMatrix[i] = (double *)calloc(nrDaysIterativeProcessMonthly[iMonth], sizeof(double));
-            for (int j=0;j<nrDaysIterativeProcessMonthly[iMonth];j++)
+            normalizedRandomMatrix[iMonth][i] = &randomBuffer[iMonth][unsigned(i)*length];
+            for (int jCount=0;jCount<nrDaysIterativeProcessMonthly[iMonth];jCount++)
             {
-               normalizedRandomMatrix[i][j]= NODATA;
+               normalizedRandomMatrix[iMonth][i][jCount]= myrandom::normalRandom(&gasDevIset,&gasDevGset);
             }
         }
+    }
 
-        for (int i=0;i<nrStations;i++)
+    int nrWorkers = std::min(parallel::getNrThreads(nrThreads), 12);
+    std::vector<TspatialIterationWorkspace> workspace;
+    workspace.resize(unsigned(nrWorkers));
+
+    parallel::forEachBlock(12, 1, nrWorkers, [&](long firstMonth, long lastMonth, int threadIndex)
+    {
+        unsigned n = unsigned(nrStations);
+        std::vector<double> occurrenceBuffer(n*n);
+        std::vector<double*> matrixOccurrence(n);
+        std::vector<double> transitionBuffer(n*2);
+        std::vector<double*> normalizedTransitionProbability(n);
+        std::vector<double> augmentedMemoryBuffer(n*2*60);
+        std::vector<double*> augmentedMemoryRows(n*2);
+        std::vector<double**> normalizedTransitionProbabilityAugmentedMemory(n);
+        for (unsigned i=0; i<n; i++)
         {
-            for (int j=0;j<nrStations;j++)
-            {
-                matrixOccurrence[i][j]= correlationMatrix[iMonth].occurrence[i][j]; //checked
-            }
+            matrixOccurrence[i] = &occurrenceBuffer[i*n];
+            normalizedTransitionProbability[i] = &transitionBuffer[i*2];
+            augmentedMemoryRows[i*2] = &augmentedMemoryBuffer[i*120];
+            augmentedMemoryRows[i*2+1] = &augmentedMemoryBuffer[i*120 + 60];
+            normalizedTransitionProbabilityAugmentedMemory[i] = &augmentedMemoryRows[i*2];
+        }
 
-            /* since random numbers generated have a normal distribution, each p00 and
-               p10 have to be recalculated according to a normal number*/
-            normalizedTransitionProbability[i][0]= - (SQRT_2*(statistics::inverseTabulatedERFC(2*precOccurence[i][iMonth].p00)));
-            normalizedTransitionProbability[i][1]= - (SQRT_2*(statistics::inverseTabulatedERFC(2*precOccurence[i][iMonth].p10)));
-            // the indices must be read as follows:
-            // [i][0][0] dryDay after two dry days,
-            // [i][0][1] dryDay after a day without rain and previously wet,
-            // [i][1][0] dryDay after a day with rain and previously dry,
-            // [i][1][1] dryDay after a day with rain and previously wet,
-            //double normProbDry[4];
-            for (int k=0;k<60;k++)
-            {
-                normalizedTransitionProbabilityAugmentedMemory[i][0][k]= - (SQRT_2*(statistics::inverseTabulatedERFC(2*precOccurence[i][iMonth].pDry[k])));
-                normalizedTransitionProbabilityAugmentedMemory[i][1][k]= - (SQRT_2*(statistics::inverseTabulatedERFC(2*precOccurence[i][iMonth].pWet[k])));
-                //normalizedTransitionProbabilityAugmentedMemory[i][0][k]= - (SQRT_2*(statistics::inverseTabulatedERFC(2*precOccurence[i][iMonth].p00)));
-                //normalizedTransitionProbabilityAugmentedMemory[i][1][k]= - (SQRT_2*(statistics::inverseTabulatedERFC(2*precOccurence[i][iMonth].p10)));
-                //printf("%d,%f,%f\n",k,normalizedTransitionProbabilityAugmentedMemory[i][0][k],normalizedTransitionProbabilityAugmentedMemory[i][1][k]);
-            }
-            //getchar();
-            for (int jCount=0;jCount<nrDaysIterativeProcessMonthly[iMonth];jCount++)
+        for (long month = firstMonth; month < lastMonth; month++)
+        {
+            int iMonth = int(month);
+            for (int i=0;i<nrStations;i++)
             {
-               normalizedRandomMatrix[i][jCount]= myrandom::normalRandom(&gasDevIset,&gasDevGset);
+                for (int j=0;j<nrStations;j++)
+                {
+                    matrixOccurrence[i][j]= correlationMatrix[iMonth].occurrence[i][j]; //checked
+                }
+
+                /* since random numbers generated have a normal distribution, each p00 and
+                   p10 have to be recalculated according to a normal number*/
+                normalizedTransitionProbability[i][0]= - (SQRT_2*(statistics::inverseTabulatedERFC(2*precOccurence[i][iMonth].p00)));
+                normalizedTransitionProbability[i][1]= - (SQRT_2*(statistics::inverseTabulatedERFC(2*precOccurence[i][iMonth].p10)));
+                // the indices must be read as follows:
+                // [i][0][0] dryDay after two dry days,
+                // [i][0][1] dryDay after a day without rain and previously wet,
+                // [i][1][0] dryDay after a day with rain and previously dry,
+                // [i][1][1] dryDay after a day with rain and previously wet,
+                for (int k=0;k<60;k++)
+                {
+                    normalizedTransitionProbabilityAugmentedMemory[i][0][k]= - (SQRT_2*(statistics::inverseTabulatedERFC(2*precOccurence[i][iMonth].pDry[k])));
+                    normalizedTransitionProbabilityAugmentedMemory[i][1][k]= - (SQRT_2*(statistics::inverseTabulatedERFC(2*precOccurence[i][iMonth].pWet[k])));
+                }
             }
 
+            weatherGenerator2D::spatialIterationOccurrence(randomMatrix[iMonth].matrixM,randomMatrix[iMonth].matrixK,randomMatrix[iMonth].matrixOccurrences,
+                                                           matrixOccurrence.data(),normalizedRandomMatrix[iMonth].data(),normalizedTransitionProbability.data(),
+                                                           normalizedTransitionProbabilityAugmentedMemory.data(),nrDaysIterativeProcessMonthly[iMonth],
+                                                           workspace[unsigned(threadIndex)]);
         }
-        //getchar();
-        weatherGenerator2D::spatialIterationOccurrence(randomMatrix[iMonth].matrixM,randomMatrix[iMonth].matrixK,randomMatrix[iMonth].matrixOccurrences,matrixOccurrence,normalizedRandomMatrix,normalizedTransitionProbability,normalizedTransitionProbabilityAugmentedMemory,nrDaysIterativeProcessMonthly[iMonth]);
+        return true;
+    });
+
+    for (int iMonth=0; iMonth<12; iMonth++)
+    {
+        double syntheticP10,syntheticP01;
+        double wetDays,dryDays;
+        syntheticP01 = syntheticP10 = 0.0;
+        wetDays = dryDays = 0.0;
         for (int iStations=0;iStations<1;iStations++)
         {
             for (int iLength=0;iLength<nrDaysIterativeProcessMonthly[iMonth]-1;iLength++)
@@ -1204,14 +1277,8 @@ void weatherGenerator2D::precipitationMultisiteOccurrenceGeneration()
         //printf("giorni di pioggia prima %d %f\n",iMonth,wetDays/(wetDays+dryDays));
         //printf("P01 %d %f %f\n",iMonth,1 - precOccurrenceGlobal[iMonth].p00,syntheticP01);
 
-
         randomMatrix[iMonth].month = iMonth + 1;
-        // free memory
-        for (int i=0;i<nrStations;i++)
-        {
-            free(normalizedRandomMatrix[i]);
-        }
-        free(normalizedRandomMatrix);
+
         time_t rawtime;
         struct tm * timeinfo;
 
@@ -1220,52 +1287,25 @@ void weatherGenerator2D::precipitationMultisiteOccurrenceGeneration()
         printf ( "Current local time and date: %s", asctime (timeinfo) );
         printf("step 3/9 substep %d/12\n",iMonth+1);
     }
-
-
-    // free memory
-    for (int i=0;i<nrStations;i++)
-    {
-        free(matrixOccurrence[i]);
-        free(normalizedTransitionProbability[i]);        
-        free(normalizedTransitionProbabilityAugmentedMemory[i][0]);
-        free(normalizedTransitionProbabilityAugmentedMemory[i][1]);
-        free(normalizedTransitionProbabilityAugmentedMemory[i]);
-    }
-    free(matrixOccurrence);
-    free(normalizedTransitionProbability);
-    free(normalizedTransitionProbabilityAugmentedMemory);
-    //getchar();
 }
 
 
 
-void weatherGenerator2D::spatialIterationOccurrence(double ** M, double** K,double** occurrences, double** matrixOccurrence, double** normalizedMatrixRandom,double ** transitionNormal,double *** transitionNormalAugmentedMemory,int lengthSeries)
+void weatherGenerator2D::spatialIterationOccurrence(double ** M, double** K,double** occurrences, double** matrixOccurrence, double** normalizedMatrixRandom,double ** transitionNormal,double *** transitionNormalAugmentedMemory,int lengthSeries, TspatialIterationWorkspace &workspace)
 {
 
     // M and K matrices are also used as ancillary dummy matrices
     double val = 5;
     int ii = 0;
     double kiter = 0.1;   // iteration parameter in calculation of new estimate of matrix 'mat'
-    double* eigenvalues = (double*)calloc(nrStations, sizeof(double));
-    double* eigenvectors = (double*)calloc(nrStations*nrStations, sizeof(double));
-    double* correlationArray = (double*)calloc(nrStations*nrStations, sizeof(double));
-    double** dummyMatrix = (double**)calloc(nrStations, sizeof(double*));
-    double** dummyMatrix2 = (double**)calloc(nrStations, sizeof(double*));
-    double** dummyMatrix3 = (double**)calloc(nrStations, sizeof(double*));
-    double** normRandom = (double**)calloc(nrStations, sizeof(double*));
-
-    // initialization internal arrays
-    for (int i=0;i<nrStations;i++)
-    {
-        dummyMatrix[i]= (double*)calloc(nrStations, sizeof(double));
-        dummyMatrix2[i]= (double*)calloc(nrStations, sizeof(double));
 
-    }
-    for (int i=0;i<nrStations;i++)
-    {
-        dummyMatrix3[i]= (double*)calloc(lengthSeries, sizeof(double));
-        normRandom[i]= (double*)calloc(lengthSeries, sizeof(double));
-    }
+    workspace.initialize(nrStations, lengthSeries);
+    double* eigenvalues = workspace.eigenvalues.data();
+    double* eigenvectors = workspace.eigenvectors.data();
+    double* correlationArray = workspace.correlationArray.data();
+    double** dummyMatrix = workspace.dummyMatrix.data();
+    double** dummyMatrix3 = workspace.dummyMatrix3.data();
+    double** normRandom = workspace.normRandom.data();
 
     // initialization output M
     for (int i=0;i<nrStations;i++)
@@ -1321,30 +1361,7 @@ void weatherGenerator2D::spatialIterationOccurrence(double ** M, double** K,doub
         }
         if (nrEigenvaluesLessThan0 > 0)
         {
-            counter=0;
-            for (int i=0;i<nrStations;i++)
-            {
-                for (int j=0;j<nrStations;j++)
-                {
-                    dummyMatrix[j][i]= eigenvectors[counter];
-                    dummyMatrix2[i][j]= eigenvectors[counter]*eigenvalues[i];
-                    counter++;
-                }
-            }
-            int cMatrix, dMatrix, kMatrix;
-            double sumMatrix = 0;
-            for ( cMatrix = 0 ; cMatrix < nrStations ; cMatrix++ )
-            {
-                for ( dMatrix = cMatrix ; dMatrix < nrStations ; dMatrix++ )
-                {
-                    for ( kMatrix = 0 ; kMatrix < nrStations ; kMatrix++ )
-                    {
-                        sumMatrix += dummyMatrix[cMatrix][kMatrix] * dummyMatrix2[kMatrix][dMatrix];
-                    }
-                    M[dMatrix][cMatrix] = M[cMatrix][dMatrix] = sumMatrix;
-                    sumMatrix = 0.;
-                }
-            }
+            reconstructCorrelationMatrix(M, workspace);
             for (int i=0;i<nrStations;i++)
             {
                 dummyMatrix[i][i] = 1.;
@@ -1468,24 +1485,6 @@ void weatherGenerator2D::spatialIterationOccurrence(double ** M, double** K,doub
         {
             if (val <= fabs(minimalValueToExitFromCycle) + TOLERANCE_MULGETS)
             {
-                for (int i=0;i<nrStations;i++)
-                {
-                    free(dummyMatrix[i]);
-                    free(dummyMatrix2[i]);
-                    free(dummyMatrix3[i]);
-                    free(normRandom[i]);
-
-                }
-
-
-                 free(dummyMatrix);
-                 free(dummyMatrix2);
-                 free(dummyMatrix3);
-                 free(correlationArray);
-                 free(eigenvalues);
-                 free(eigenvectors);
-                 free(normRandom);
-
                 return;
             }
         }
@@ -1509,25 +1508,6 @@ void weatherGenerator2D::spatialIterationOccurrence(double ** M, double** K,doub
         //printf("iter %d value %f \n",ii,val);
 
     }  // end of the while cycle
-
-
-    // free memory
-
-    for (int i=0;i<nrStations;i++)
-    {
-        free(dummyMatrix[i]);
-        free(dummyMatrix2[i]);
-        free(dummyMatrix3[i]);
-        free(normRandom[i]);
-    }
-    free(normRandom);
-    free(dummyMatrix);
-    free(dummyMatrix2);
-    free(dummyMatrix3);
-    free(eigenvalues);
-    free(eigenvectors);
-    free(correlationArray);
-
 }
 
 int weatherGenerator2D::dateFromDoy(int doy,int year, int* day, int* month)